@@ -0,0 +1,47 @@
+.PHONY: bench-build
+
+bench_SOURCES := $(wildcard $(addsuffix /*.cpp,$(bench_srcdirs)))
+#bench_OBJS := $(patsubst $(bench_srcdirs)/%,$(bench_buildtmpdir)/%,$(patsubst %.cpp,%.$(obj_ext),$(bench_SOURCES)))
+bench_OBJS := $(patsubst $(bench_srcdir)/%,$(bench_buildtmpdir)/%,$(patsubst %.cpp,%.$(obj_ext),$(bench_SOURCES)))
+bench_TARGETS := $(addprefix $(bench_bindir)/,$(patsubst %.cpp,%,$(patsubst $(bench_srcdir)/%,%,$(bench_SOURCES))))
+
+
+bench-build: override CC=$(CXX)
+bench-build: $(bench_OBJS) $(bench_TARGETS)
+
+#$(info BENCH BUILDTMPDIR ==> $(bench_buildtmpdir))
+#$(info BENCH BINDIR ==> $(bench_bindir))
+
+$(bench_bindir)/%: $(bench_buildtmpdir)/%.$(obj_ext)
+	mkdir -p $(dir $@)
+	$(CXX) -o $@ $< $(LDFLAGS)
+
+
+## Source to Object rules
+
+$(bench_buildtmpdir)/%.$(obj_ext): $(bench_srcdir)/%.cpp
+	@echo "=== (Bench) Compiling: $@ ==="
+	mkdir -p $(dir $@)
+	$(CXX) $(CXXFLAGS) -o $@ -c $<
+
+
+## Header to Precompiled header rules
+
+ifeq ($(use_pch),true)
+$(bench_buildtmpdir)/%.$(pch_ext): %.hpp
+	@echo "=== (Bench) Pre-compiling header: $@ ==="
+	mkdir -p $(dir $@)
+	$(CXX) $(CXXFLAGS) -c $< -o $@
+else
+$(bench_buildtmpdir)/%.$(pch_ext): ;
+endif
+
+
+## Source to Dependency rules
+
+$(bench_buildtmpdir)/%.d: %.cpp
+	@echo "=== (Bench) Creating dependencies file: $@ ==="
+	@set -e; rm -f $@; \
+		$(CXX) $(CPPFLAGS) $< > $@.$$$$; \
+		sed ’s,\($*\)\.$(obj_ext)[ :]*,\1.$(obj_ext) $@ : ,g’ < $@.$$$$ > $@; \
+		rm -f $@.$$$$
@@ -0,0 +1,150 @@
+/**
+ * \file bench/src/dcs/benchmark/algorithm/order.cpp
+ *
+ * \brief Benchmark of the ordering permutation algorithms against index sorting.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+
+#include <algorithm>
+#include <boost/chrono.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/algorithm/order.hpp>
+#include <dcs/algorithm/parallel_order.hpp>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+namespace alg = ::dcs::algorithm;
+
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+/// The ordering algorithm before specialized paths were added.
+template <typename T>
+void naive_order(std::vector<T> const& v, std::vector<std::size_t>& idx)
+{
+	for (std::size_t i = 0; i < v.size(); ++i)
+	{
+		idx[i] = i;
+	}
+	std::sort(idx.begin(), idx.end(), alg::detail::index_less_than<typename std::vector<T>::const_iterator>(v.begin()));
+}
+
+double nanos_per_element(std::size_t n, std::size_t reps, clock_type::duration elapsed)
+{
+	return ::boost::chrono::duration<double>(elapsed).count()*1.0e9/static_cast<double>(n*reps);
+}
+
+template <typename T>
+void run(char const* name, std::vector<T> const& v, std::size_t num_threads)
+{
+	const std::size_t n(v.size());
+	const std::size_t reps(std::max(std::size_t(1), (std::size_t(1) << 22)/n));
+
+	std::vector<std::size_t> idx(n);
+
+	clock_type::time_point start(clock_type::now());
+	for (std::size_t r = 0; r < reps; ++r)
+	{
+		naive_order(v, idx);
+	}
+	const double naive(nanos_per_element(n, reps, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (std::size_t r = 0; r < reps; ++r)
+	{
+		alg::key_index_order(v.begin(), v.end(), idx.begin());
+	}
+	const double pairs(nanos_per_element(n, reps, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (std::size_t r = 0; r < reps; ++r)
+	{
+		alg::order(v.begin(), v.end(), idx.begin());
+	}
+	const double order(nanos_per_element(n, reps, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (std::size_t r = 0; r < reps; ++r)
+	{
+		alg::parallel_order(v.begin(), v.end(), idx.begin(), num_threads);
+	}
+	const double parallel(nanos_per_element(n, reps, clock_type::now()-start));
+
+	std::cout << std::setw(8) << name
+			  << std::setw(10) << n
+			  << std::setw(10) << std::fixed << std::setprecision(1) << naive
+			  << std::setw(10) << pairs
+			  << std::setw(10) << order
+			  << std::setw(10) << parallel
+			  << std::setw(10) << std::setprecision(2) << naive/order
+			  << std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: order [max-size [num-threads]]
+int main(int argc, char* argv[])
+{
+	const std::size_t max_n(argc > 1 ? std::strtoul(argv[1], 0, 10) : (1 << 24));
+	const std::size_t num_threads(argc > 2 ? std::strtoul(argv[2], 0, 10) : 0);
+
+	std::cout << "Time per element (ns)" << std::endl;
+	std::cout << std::setw(8) << "key"
+			  << std::setw(10) << "n"
+			  << std::setw(10) << "naive"
+			  << std::setw(10) << "pairs"
+			  << std::setw(10) << "order"
+			  << std::setw(10) << "parallel"
+			  << std::setw(10) << "speedup"
+			  << std::endl;
+
+	for (std::size_t n = 256; n <= max_n; n *= 8)
+	{
+		std::vector<int> vi(n);
+		std::vector<double> vd(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			vi[i] = std::rand();
+			vd[i] = static_cast<double>(std::rand())/RAND_MAX - 0.5;
+		}
+
+		run("int", vi, num_threads);
+		run("double", vd, num_threads);
+	}
+}
@@ -0,0 +1,194 @@
+/**
+ * \file bench/src/dcs/benchmark/base64.cpp
+ *
+ * \brief Benchmark of the Base64 encoder and decoder.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/text/base64.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+static const ::std::string legacy_chars("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+/// The encoder before the table-driven and vectorized codecs were added.
+::std::string legacy_encode(::boost::uint8_t const* in, ::std::size_t n)
+{
+	::std::string ret;
+	::std::size_t i(0);
+	::boost::uint8_t a3[3];
+
+	while (n--)
+	{
+		a3[i++] = *(in++);
+		if (i == 3)
+		{
+			ret += legacy_chars[(a3[0] & 0xfc) >> 2];
+			ret += legacy_chars[((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4)];
+			ret += legacy_chars[((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6)];
+			ret += legacy_chars[a3[2] & 0x3f];
+			i = 0;
+		}
+	}
+	if (i)
+	{
+		for (::std::size_t j = i; j < 3; ++j)
+		{
+			a3[j] = 0;
+		}
+		ret += legacy_chars[(a3[0] & 0xfc) >> 2];
+		ret += legacy_chars[((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4)];
+		if (i > 1)
+		{
+			ret += legacy_chars[(a3[1] & 0x0f) << 2];
+		}
+		ret.append(4-(i+1), '=');
+	}
+
+	return ret;
+}
+
+/// The decoder before the table-driven and vectorized codecs were added.
+::std::string legacy_decode(::std::string const& s)
+{
+	::std::string ret;
+	::std::size_t i(0);
+	::boost::uint8_t a4[4];
+
+	for (::std::size_t k = 0; k < s.size() && s[k] != '=' && legacy_chars.find(s[k]) != ::std::string::npos; ++k)
+	{
+		a4[i++] = static_cast< ::boost::uint8_t >(legacy_chars.find(s[k]));
+		if (i == 4)
+		{
+			ret += static_cast<char>((a4[0] << 2) + ((a4[1] & 0x30) >> 4));
+			ret += static_cast<char>(((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2));
+			ret += static_cast<char>(((a4[2] & 0x3) << 6) + a4[3]);
+			i = 0;
+		}
+	}
+
+	return ret;
+}
+
+double mb_per_sec(::std::size_t n, ::std::size_t reps, clock_type::duration elapsed)
+{
+	return static_cast<double>(n)*static_cast<double>(reps)/(::boost::chrono::duration<double>(elapsed).count()*1.0e6);
+}
+
+template <typename KernelT>
+void run_kernel(char const* name, ::std::vector< ::boost::uint8_t > const& bytes, ::std::string const& chars, ::std::size_t reps, KernelT kernel)
+{
+	::std::vector<char> enc(chars.size());
+	::std::vector< ::boost::uint8_t > dec(bytes.size());
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		::dcs::text::detail::base64_encode_bulk(&bytes[0], bytes.size(), &enc[0], ::dcs::text::standard_base64_alphabet, kernel);
+	}
+	const double enc_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		::dcs::text::detail::base64_decode_bulk(chars.data(), chars.size(), &dec[0], ::dcs::text::standard_base64_alphabet, kernel);
+	}
+	const double dec_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	::std::cout << ::std::setw(10) << name
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(1) << enc_rate
+				<< ::std::setw(12) << dec_rate
+				<< ::std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: base64 [size-in-bytes]
+int main(int argc, char* argv[])
+{
+	// A multiple of 3, so that bulk functions encode all the data
+	const ::std::size_t n((argc > 1 ? ::std::strtoul(argv[1], 0, 10) : (1 << 24))/3*3);
+	const ::std::size_t reps(::std::max(static_cast< ::std::size_t >(1), (::std::size_t(1) << 28)/n));
+
+	::std::vector< ::boost::uint8_t > bytes(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		bytes[i] = static_cast< ::boost::uint8_t >(::std::rand());
+	}
+	const ::std::string chars(::dcs::text::base64_encode(&bytes[0], n));
+
+	::std::cout << "Throughput on " << n << " bytes (MB/s of decoded data)" << ::std::endl;
+	::std::cout << ::std::setw(10) << "codec"
+				<< ::std::setw(12) << "encode"
+				<< ::std::setw(12) << "decode"
+				<< ::std::endl;
+
+	const ::std::size_t legacy_reps(::std::max(static_cast< ::std::size_t >(1), reps/16));
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t r = 0; r < legacy_reps; ++r)
+	{
+		legacy_encode(&bytes[0], n);
+	}
+	const double enc_rate(mb_per_sec(n, legacy_reps, clock_type::now()-start));
+	start = clock_type::now();
+	for (::std::size_t r = 0; r < legacy_reps; ++r)
+	{
+		legacy_decode(chars);
+	}
+	const double dec_rate(mb_per_sec(n, legacy_reps, clock_type::now()-start));
+	::std::cout << ::std::setw(10) << "legacy"
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(1) << enc_rate
+				<< ::std::setw(12) << dec_rate
+				<< ::std::endl;
+
+	run_kernel("scalar", bytes, chars, reps, ::dcs::text::detail::scalar_base64_kernel);
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+	if (::dcs::text::detail::base64_x86_has_ssse3())
+	{
+		run_kernel("ssse3", bytes, chars, reps, ::dcs::text::detail::ssse3_base64_kernel);
+	}
+	if (::dcs::text::detail::base64_x86_has_avx2())
+	{
+		run_kernel("avx2", bytes, chars, reps, ::dcs::text::detail::avx2_base64_kernel);
+	}
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+}
@@ -0,0 +1,113 @@
+/**
+ * \file bench/src/dcs/benchmark/concurrent/disjoint_sets.cpp
+ *
+ * \brief Scaling benchmark of the lock-free disjoint-sets data structure.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/concurrent/disjoint_sets.hpp>
+#include <dcs/disjoint_sets.hpp>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+typedef ::std::vector< ::std::pair< ::std::size_t, ::std::size_t > > pair_container;
+typedef ::dcs::concurrent::disjoint_sets< ::boost::uint32_t > concurrent_sets_type;
+
+
+namespace /*<unnamed>*/ {
+
+void unite_chunk(concurrent_sets_type* p_sets, pair_container const* p_pairs, ::std::size_t first, ::std::size_t last)
+{
+	p_sets->union_all(p_pairs->begin()+first, p_pairs->begin()+last);
+}
+
+double nanos_per_pair(::std::size_t m, clock_type::duration elapsed)
+{
+	return ::boost::chrono::duration<double>(elapsed).count()*1.0e9/static_cast<double>(m);
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: disjoint_sets [num-elements [max-threads]]
+int main(int argc, char* argv[])
+{
+	const ::std::size_t n(argc > 1 ? ::std::strtoul(argv[1], 0, 10) : (1 << 22));
+	const ::std::size_t max_threads(argc > 2 ? ::std::strtoul(argv[2], 0, 10) : ::std::max(2u, ::boost::thread::hardware_concurrency()));
+
+	pair_container pairs(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pairs[i].first = static_cast< ::std::size_t >(::std::rand()) % n;
+		pairs[i].second = static_cast< ::std::size_t >(::std::rand()) % n;
+	}
+
+	clock_type::time_point start(clock_type::now());
+	::dcs::dense_disjoint_sets< ::boost::uint32_t > serial_sets(n);
+	serial_sets.union_all(pairs.begin(), pairs.end());
+	const double serial_time(nanos_per_pair(n, clock_type::now()-start));
+
+	::std::cout << "Time per union (ns) over " << n << " elements" << ::std::endl;
+	::std::cout << ::std::setw(10) << "threads"
+				<< ::std::setw(10) << "time"
+				<< ::std::setw(10) << "speedup"
+				<< ::std::endl;
+	::std::cout << ::std::setw(10) << "serial"
+				<< ::std::setw(10) << ::std::fixed << ::std::setprecision(1) << serial_time
+				<< ::std::endl;
+
+	for (::std::size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+	{
+		concurrent_sets_type sets(n);
+
+		start = clock_type::now();
+		::boost::thread_group workers;
+		for (::std::size_t t = 0; t < num_threads; ++t)
+		{
+			workers.create_thread(::boost::bind(&unite_chunk, &sets, &pairs, t*n/num_threads, (t+1)*n/num_threads));
+		}
+		workers.join_all();
+		const double time(nanos_per_pair(n, clock_type::now()-start));
+
+		::std::cout << ::std::setw(10) << num_threads
+					<< ::std::setw(10) << ::std::fixed << ::std::setprecision(1) << time
+					<< ::std::setw(10) << ::std::setprecision(2) << serial_time/time
+					<< ::std::endl;
+	}
+}
@@ -0,0 +1,208 @@
+/**
+ * \file bench/src/dcs/benchmark/digest.cpp
+ *
+ * \brief Benchmark of the message digest algorithms.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/digest/md5.hpp>
+#include <dcs/digest/sha256.hpp>
+#include <dcs/digest/tree_hash.hpp>
+#include <dcs/digest/xxhash.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+double mb_per_sec(::std::size_t n, ::std::size_t reps, clock_type::duration elapsed)
+{
+	return static_cast<double>(n)*static_cast<double>(reps)/(::boost::chrono::duration<double>(elapsed).count()*1.0e6);
+}
+
+void print_rate(char const* name, double large_rate, double small_rate)
+{
+	::std::cout << ::std::setw(14) << name
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(1) << large_rate
+				<< ::std::setw(12) << small_rate
+				<< ::std::endl;
+}
+
+/// Hashes a large buffer and then many small records, one at a time.
+template <typename DigestT>
+void run_digest(char const* name, ::std::vector< ::dcs::digest::byte_type > const& bytes, ::std::size_t reps, ::std::size_t rec_len)
+{
+	DigestT dig;
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		dig.digest(&bytes[0], bytes.size());
+	}
+	const double large_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	const ::std::size_t nrec(bytes.size()/rec_len);
+	start = clock_type::now();
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		for (::std::size_t i = 0; i < nrec; ++i)
+		{
+			dig.reset();
+			dig.update(&bytes[i*rec_len], rec_len);
+			dig.finish();
+		}
+	}
+	const double small_rate(mb_per_sec(nrec*rec_len, reps, clock_type::now()-start));
+
+	print_rate(name, large_rate, small_rate);
+}
+
+/// Hashes a large buffer and then many small records, all at once.
+void run_sha256(char const* name, ::std::vector< ::dcs::digest::byte_type > const& bytes, ::std::size_t reps, ::std::size_t rec_len, ::dcs::digest::detail::sha256_kernel_category kernel)
+{
+	::std::vector< ::dcs::digest::byte_type > out(32*(bytes.size()/rec_len));
+	::dcs::digest::byte_type const* data(&bytes[0]);
+	::std::size_t len(bytes.size());
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		::dcs::digest::sha256_digest_many(&data, &len, 1, &out[0], kernel);
+	}
+	const double large_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	const ::std::size_t nrec(bytes.size()/rec_len);
+	::std::vector< ::dcs::digest::byte_type const* > recs(nrec);
+	::std::vector< ::std::size_t > lens(nrec, rec_len);
+	for (::std::size_t i = 0; i < nrec; ++i)
+	{
+		recs[i] = &bytes[i*rec_len];
+	}
+	start = clock_type::now();
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		::dcs::digest::sha256_digest_many(&recs[0], &lens[0], nrec, &out[0], kernel);
+	}
+	const double small_rate(mb_per_sec(nrec*rec_len, reps, clock_type::now()-start));
+
+	print_rate(name, large_rate, small_rate);
+}
+
+/// Hashes a large buffer with a tree hash, and then hashes it again after modifying a chunk.
+template <typename HashT>
+void run_tree(char const* name, ::std::vector< ::dcs::digest::byte_type > const& bytes, ::std::size_t reps, ::std::size_t num_threads)
+{
+	const ::std::size_t chunk_size(1 << 16);
+	::dcs::digest::tree_hash<HashT> th(chunk_size, num_threads);
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		th.hash(&bytes[0], bytes.size());
+	}
+	const double full_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (::std::size_t r = 0; r < reps; ++r)
+	{
+		th.invalidate((r*chunk_size) % bytes.size(), 1);
+		th.rehash(&bytes[0], bytes.size());
+	}
+	const double inc_rate(mb_per_sec(bytes.size(), reps, clock_type::now()-start));
+
+	::std::cout << ::std::setw(14) << name
+				<< ::std::setw(10) << num_threads
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(1) << full_rate
+				<< ::std::setw(12) << inc_rate
+				<< ::std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: digest [size-in-bytes [record-size-in-bytes]]
+int main(int argc, char* argv[])
+{
+	const ::std::size_t n(argc > 1 ? ::std::strtoul(argv[1], 0, 10) : (1 << 22));
+	const ::std::size_t rec_len(argc > 2 ? ::std::strtoul(argv[2], 0, 10) : 64);
+	const ::std::size_t reps(::std::max(static_cast< ::std::size_t >(1), (::std::size_t(1) << 26)/n));
+
+	::std::vector< ::dcs::digest::byte_type > bytes(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		bytes[i] = static_cast< ::dcs::digest::byte_type >(::std::rand());
+	}
+
+	::std::cout << "Throughput on " << n << " bytes and on " << rec_len << "-byte records (MB/s)" << ::std::endl;
+	::std::cout << ::std::setw(14) << "digest"
+				<< ::std::setw(12) << "large"
+				<< ::std::setw(12) << "records"
+				<< ::std::endl;
+
+	run_digest< ::dcs::digest::md5_algorithm >("md5", bytes, reps, rec_len);
+	run_digest< ::dcs::digest::xxh64_algorithm >("xxh64", bytes, reps, rec_len);
+	run_digest< ::dcs::digest::xxh3_algorithm >("xxh3", bytes, reps, rec_len);
+	run_digest< ::dcs::digest::sha256_algorithm >("sha256", bytes, reps, rec_len);
+
+	run_sha256("sha256-scalar", bytes, reps, rec_len, ::dcs::digest::detail::scalar_sha256_kernel);
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+	if (::dcs::digest::detail::sha256_x86_has_sha())
+	{
+		run_sha256("sha256-shani", bytes, reps, rec_len, ::dcs::digest::detail::shani_sha256_kernel);
+	}
+	run_sha256("sha256-sse2x4", bytes, reps, rec_len, ::dcs::digest::detail::sse2_x4_sha256_kernel);
+	if (::dcs::digest::detail::sha256_x86_has_avx2())
+	{
+		run_sha256("sha256-avx2x8", bytes, reps, rec_len, ::dcs::digest::detail::avx2_x8_sha256_kernel);
+	}
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+
+	::std::cout << ::std::endl << "Tree hash with 64KiB chunks on " << n << " bytes (MB/s)" << ::std::endl;
+	::std::cout << ::std::setw(14) << "digest"
+				<< ::std::setw(10) << "threads"
+				<< ::std::setw(12) << "full"
+				<< ::std::setw(12) << "one-chunk"
+				<< ::std::endl;
+	const ::std::size_t max_threads(::std::max(1u, ::boost::thread::hardware_concurrency()));
+	for (::std::size_t nt = 1; nt <= max_threads; nt *= 2)
+	{
+		run_tree< ::dcs::digest::md5_algorithm >("md5-tree", bytes, reps, nt);
+		run_tree< ::dcs::digest::sha256_algorithm >("sha256-tree", bytes, reps, nt);
+	}
+}
@@ -0,0 +1,174 @@
+/**
+ * \file bench/src/dcs/benchmark/disjoint_sets.cpp
+ *
+ * \brief Benchmark of the disjoint-sets data structures.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/chrono.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/disjoint_sets.hpp>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+typedef ::std::vector< ::std::pair< ::boost::uint64_t, ::boost::uint64_t> > pair_container;
+
+
+namespace /*<unnamed>*/ {
+
+/// The disjoint sets before the dense and hashed variants were added.
+class map_disjoint_sets
+{
+	public: void make_set(::boost::uint64_t e)
+	{
+		if (ids_.count(e) == 0)
+		{
+			const ::std::size_t sid(ids_.size());
+			ids_[e] = sid;
+			ranks_.push_back(0);
+			parents_.push_back(sid);
+		}
+	}
+
+	public: ::std::size_t find_set(::boost::uint64_t e)
+	{
+		return ::dcs::find_with_full_path_compression()(parents_.begin(), ids_.find(e)->second);
+	}
+
+	public: void union_sets(::boost::uint64_t e1, ::boost::uint64_t e2)
+	{
+		this->make_set(e1);
+		this->make_set(e2);
+		const ::std::size_t s1(this->find_set(e1));
+		const ::std::size_t s2(this->find_set(e2));
+		if (s1 == s2)
+		{
+			return;
+		}
+		if (ranks_[s1] > ranks_[s2])
+		{
+			parents_[s2] = s1;
+		}
+		else
+		{
+			parents_[s1] = s2;
+			if (ranks_[s1] == ranks_[s2])
+			{
+				ranks_[s2] += 1;
+			}
+		}
+	}
+
+
+	private: ::std::vector< ::std::size_t > ranks_;
+	private: ::std::vector< ::std::size_t > parents_;
+	private: ::std::map< ::boost::uint64_t, ::std::size_t > ids_;
+}; // map_disjoint_sets
+
+double nanos_per_pair(::std::size_t m, clock_type::duration elapsed)
+{
+	return ::boost::chrono::duration<double>(elapsed).count()*1.0e9/static_cast<double>(m);
+}
+
+void run(::std::size_t n)
+{
+	// Sparse keys for the hashed variants, dense ones for the others
+	pair_container sparse(n);
+	pair_container dense(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		dense[i].first = static_cast< ::std::size_t >(::std::rand()) % n;
+		dense[i].second = static_cast< ::std::size_t >(::std::rand()) % n;
+		sparse[i].first = dense[i].first*2654435761u;
+		sparse[i].second = dense[i].second*2654435761u;
+	}
+
+	clock_type::time_point start(clock_type::now());
+	map_disjoint_sets map_sets;
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		map_sets.union_sets(sparse[i].first, sparse[i].second);
+	}
+	const double map_time(nanos_per_pair(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	::dcs::disjoint_sets< ::boost::uint64_t > hashed_sets;
+	hashed_sets.union_all(sparse.begin(), sparse.end());
+	const double hashed_time(nanos_per_pair(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	::dcs::dense_disjoint_sets<> dense_sets(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		dense_sets.union_sets(dense[i].first, dense[i].second);
+	}
+	const double dense_time(nanos_per_pair(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	::dcs::dense_disjoint_sets< ::boost::uint32_t > dense32_sets(n);
+	dense32_sets.union_all(dense.begin(), dense.end());
+	const double dense32_time(nanos_per_pair(n, clock_type::now()-start));
+
+	::std::cout << ::std::setw(10) << n
+				<< ::std::setw(10) << ::std::fixed << ::std::setprecision(1) << map_time
+				<< ::std::setw(10) << hashed_time
+				<< ::std::setw(10) << dense_time
+				<< ::std::setw(10) << dense32_time
+				<< ::std::setw(10) << ::std::setprecision(2) << map_time/hashed_time
+				<< ::std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: disjoint_sets [max-size]
+int main(int argc, char* argv[])
+{
+	const ::std::size_t max_n(argc > 1 ? ::std::strtoul(argv[1], 0, 10) : (1 << 22));
+
+	::std::cout << "Time per union (ns)" << ::std::endl;
+	::std::cout << ::std::setw(10) << "n"
+				<< ::std::setw(10) << "map"
+				<< ::std::setw(10) << "hashed"
+				<< ::std::setw(10) << "dense"
+				<< ::std::setw(10) << "dense32"
+				<< ::std::setw(10) << "speedup"
+				<< ::std::endl;
+
+	for (::std::size_t n = 1024; n <= max_n; n *= 8)
+	{
+		run(n);
+	}
+}
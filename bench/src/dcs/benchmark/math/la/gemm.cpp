@@ -0,0 +1,146 @@
+/**
+ * \file bench/src/dcs/benchmark/math/la/gemm.cpp
+ *
+ * \brief Benchmark of the dense matrix product against naive loops.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <boost/chrono.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/math/la/gemm.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <iomanip>
+#include <iostream>
+
+
+namespace math = ::dcs::math;
+
+typedef math::matrix< double, math::matrix_properties<math::row_major_storage_layout> > matrix_type;
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+void naive_gemm(matrix_type const& A, matrix_type const& B, matrix_type& C)
+{
+	const std::size_t m(A.num_rows());
+	const std::size_t n(B.num_columns());
+	const std::size_t k(A.num_columns());
+
+	for (std::size_t i = 0; i < m; ++i)
+	{
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			double s(0);
+			for (std::size_t p = 0; p < k; ++p)
+			{
+				s += A(i,p)*B(p,j);
+			}
+			C(i,j) = s;
+		}
+	}
+}
+
+double gflops(std::size_t n, clock_type::duration elapsed)
+{
+	const double secs(::boost::chrono::duration<double>(elapsed).count());
+	const double nn(static_cast<double>(n));
+
+	return 2.0*nn*nn*nn/secs*1.0e-9;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: gemm [max-size [max-naive-size [num-threads]]]
+int main(int argc, char* argv[])
+{
+	const std::size_t max_n(argc > 1 ? std::strtoul(argv[1], 0, 10) : 4096);
+	const std::size_t max_naive_n(argc > 2 ? std::strtoul(argv[2], 0, 10) : 1024);
+	const std::size_t num_threads(argc > 3 ? std::strtoul(argv[3], 0, 10) : 0);
+
+	std::cout << std::setw(6) << "n"
+			  << std::setw(14) << "naive GFLOPS"
+			  << std::setw(14) << "gemm GFLOPS"
+			  << std::setw(10) << "speedup"
+			  << std::endl;
+
+	for (std::size_t n = 64; n <= max_n; n *= 2)
+	{
+		matrix_type A(n, n);
+		matrix_type B(n, n);
+		matrix_type C(n, n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			for (std::size_t j = 0; j < n; ++j)
+			{
+				A(i,j) = static_cast<double>((i+j) % 17)/17.0;
+				B(i,j) = static_cast<double>((i*j) % 13)/13.0;
+			}
+		}
+
+		// Repeat small products to get measurable times
+		const std::size_t reps(n < 512 ? (512/n)*(512/n) : 1);
+
+		double naive(0);
+		if (n <= max_naive_n)
+		{
+			const clock_type::time_point start(clock_type::now());
+			for (std::size_t r = 0; r < reps; ++r)
+			{
+				naive_gemm(A, B, C);
+			}
+			naive = gflops(n, (clock_type::now()-start)/reps);
+		}
+
+		const clock_type::time_point start(clock_type::now());
+		for (std::size_t r = 0; r < reps; ++r)
+		{
+			math::la::gemm(1.0, A, B, 0.0, C, num_threads);
+		}
+		const double blocked(gflops(n, (clock_type::now()-start)/reps));
+
+		std::cout << std::setw(6) << n
+				  << std::setw(14) << std::fixed << std::setprecision(2) << naive
+				  << std::setw(14) << blocked
+				  << std::setw(10);
+		if (naive > 0)
+		{
+			std::cout << blocked/naive;
+		}
+		else
+		{
+			std::cout << "-";
+		}
+		std::cout << std::endl;
+	}
+}
@@ -0,0 +1,101 @@
+/**
+ * \file bench/src/dcs/benchmark/neos_client.cpp
+ *
+ * \brief Benchmark of the NEOS client against the in-process mock server.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/chrono.hpp>
+#include <boost/thread/future.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/math/optim/neos/client.hpp>
+#include <dcs/math/optim/neos/mock_server.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+double micros_per_call(::std::size_t m, clock_type::duration elapsed)
+{
+	return ::boost::chrono::duration<double>(elapsed).count()*1.0e6/static_cast<double>(m);
+}
+
+/// Measures the time to poll the status of n jobs, one call at a time and pipelined.
+void run(::std::size_t n)
+{
+	::dcs::math::optim::neos_mock_server server(n);
+	const ::dcs::math::optim::neos_client neos(server.transport());
+
+	::std::vector< ::dcs::math::optim::neos_job_credentials > creds;
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		creds.push_back(neos.submit_job("<document/>"));
+	}
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		neos.job_status(creds[i]);
+	}
+	const double blocking_time(micros_per_call(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	neos.job_statuses(creds);
+	const double pipelined_time(micros_per_call(n, clock_type::now()-start));
+
+	::std::cout << ::std::setw(10) << n
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(2) << blocking_time
+				<< ::std::setw(12) << pipelined_time
+				<< ::std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: neos_client [max-jobs]
+int main(int argc, char* argv[])
+{
+	const ::std::size_t max_n(argc > 1 ? ::std::strtoul(argv[1], 0, 10) : 4096);
+
+	::std::cout << "Time per status poll (us)" << ::std::endl;
+	::std::cout << ::std::setw(10) << "jobs"
+				<< ::std::setw(12) << "blocking"
+				<< ::std::setw(12) << "pipelined"
+				<< ::std::endl;
+
+	for (::std::size_t n = 16; n <= max_n; n *= 4)
+	{
+		run(n);
+	}
+}
@@ -0,0 +1,235 @@
+/**
+ * \file bench/src/dcs/benchmark/uri.cpp
+ *
+ * \brief Benchmark of percent-encoding and query parameter lookup on log URIs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/chrono.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/uri.hpp>
+#include <dcs/uri_query.hpp>
+#include <dcs/uri_view.hpp>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+typedef ::boost::chrono::steady_clock clock_type;
+
+
+namespace /*<unnamed>*/ {
+
+/// The decoder before the table-driven and vectorized codec was added.
+::std::string legacy_decode(::std::string const& str)
+{
+	::std::ostringstream oss;
+	::std::string::const_iterator it(str.begin());
+	::std::string::const_iterator end_it(str.end());
+	while (it != end_it)
+	{
+		char c = *it++;
+		if (c == '%' && (end_it-it) >= 2)
+		{
+			char hi = *it++;
+			char lo = *it++;
+			c = static_cast<char>(16*(hi <= '9' ? hi-'0' : (hi | 0x20)-'a'+10) + (lo <= '9' ? lo-'0' : (lo | 0x20)-'a'+10));
+		}
+		oss << c;
+	}
+
+	return oss.str();
+}
+
+/// Looks up a parameter the way it was done before uri_query_view was added:
+/// decoding the whole query and then splitting it.
+bool legacy_get(::dcs::uri const& u, ::std::string const& key, ::std::string& value)
+{
+	const ::std::string q(u.query());
+	::std::string::size_type pos(0);
+	while (pos <= q.size())
+	{
+		::std::string::size_type end(q.find('&', pos));
+		if (end == ::std::string::npos)
+		{
+			end = q.size();
+		}
+		const ::std::string::size_type eq(q.find('=', pos));
+		if (eq != ::std::string::npos && eq < end && q.compare(pos, eq-pos, key) == 0)
+		{
+			value = q.substr(eq+1, end-eq-1);
+			return true;
+		}
+		pos = end+1;
+	}
+
+	return false;
+}
+
+/// Generates URIs resembling those in the access log of a web application.
+void make_log_uris(::std::size_t n, ::std::vector< ::std::string >& uris)
+{
+	static char const* paths[] = { "/search", "/api/v2/items", "/static/js/app.min.js", "/user/profile", "/cart/add" };
+	static char const* terms[] = { "caf%C3%A9+latte", "red%20shoes", "ACME+%26+Sons", "%E6%9D%B1%E4%BA%AC", "laptop", "50%25+off" };
+	static char const* langs[] = { "en-US", "it", "de-DE%2Cde%3Bq%3D0.8" };
+
+	uris.resize(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::std::ostringstream oss;
+		oss << "https://www.example.com" << paths[::std::rand() % 5]
+			<< "?q=" << terms[::std::rand() % 6]
+			<< "&page=" << (::std::rand() % 20)
+			<< "&lang=" << langs[::std::rand() % 3]
+			<< "&utm_source=newsletter&utm_medium=email&utm_campaign=spring%2D2014";
+		if (::std::rand() % 2)
+		{
+			oss << "&ref=" << "https%3A%2F%2Fwww.google.com%2Fsearch%3Fq%3D" << terms[::std::rand() % 6];
+		}
+		oss << "&sid=" << ::std::hex << ::std::rand() << ::std::rand();
+		uris[i] = oss.str();
+	}
+}
+
+double mb_per_sec(::std::size_t n, clock_type::duration elapsed)
+{
+	return static_cast<double>(n)/(::boost::chrono::duration<double>(elapsed).count()*1.0e6);
+}
+
+double ns_per_item(::std::size_t n, clock_type::duration elapsed)
+{
+	return ::boost::chrono::duration<double, ::boost::nano>(elapsed).count()/static_cast<double>(n);
+}
+
+void print_row(char const* name, double value)
+{
+	::std::cout << ::std::setw(24) << name
+				<< ::std::setw(12) << ::std::fixed << ::std::setprecision(1) << value
+				<< ::std::endl;
+}
+
+} // Namespace <unnamed>
+
+
+/// Usage: uri [number-of-uris]
+int main(int argc, char* argv[])
+{
+	const ::std::size_t n(argc > 1 ? ::std::strtoul(argv[1], 0, 10) : 100000);
+
+	::std::vector< ::std::string > uris;
+	make_log_uris(n, uris);
+	::std::vector< ::dcs::uri_view > views;
+	::dcs::parse_uri_views(uris.begin(), uris.end(), views);
+	::std::size_t bytes(0);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		bytes += views[i].query().size();
+	}
+
+	// Keep the compiler from discarding the results
+	::std::size_t check(0);
+
+	::std::cout << "Decoding " << n << " queries (MB/s)" << ::std::endl;
+
+	clock_type::time_point start(clock_type::now());
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		check += legacy_decode(views[i].query().to_string()).size();
+	}
+	print_row("legacy", mb_per_sec(bytes, clock_type::now()-start));
+
+	::std::vector< ::std::string > queries(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		queries[i] = views[i].query().to_string();
+	}
+	start = clock_type::now();
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		check += ::dcs::uri::decode(queries[i]).size();
+	}
+	print_row("uri::decode", mb_per_sec(bytes, clock_type::now()-start));
+
+	::std::string buf;
+	start = clock_type::now();
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::boost::string_ref q(views[i].query());
+		buf.resize(q.size());
+		check += ::dcs::detail::uri_percent_decode(q.data(), q.data()+q.size(), &buf[0], true, true)-&buf[0];
+	}
+	print_row("reused buffer", mb_per_sec(bytes, clock_type::now()-start));
+
+	::std::cout << "Looking up one parameter in " << n << " URIs (ns/URI)" << ::std::endl;
+
+	::std::vector< ::dcs::uri > legacy_uris;
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		legacy_uris.push_back(::dcs::uri(uris[i]));
+	}
+	::std::string value;
+	start = clock_type::now();
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		check += legacy_get(legacy_uris[i], "lang", value) ? value.size() : 0;
+	}
+	print_row("decode and split", ns_per_item(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::dcs::uri_query_view::string_ref_type v;
+		check += legacy_uris[i].query_params().get("lang", v, buf) ? v.size() : 0;
+	}
+	print_row("uri::query_params", ns_per_item(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::dcs::uri_query_view::string_ref_type v;
+		check += views[i].query_params().get("sid", v, buf) ? v.size() : 0;
+	}
+	print_row("uri_view (last param)", ns_per_item(n, clock_type::now()-start));
+
+	start = clock_type::now();
+	::std::string kbuf;
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		const ::dcs::uri_query_view qv(views[i].query_params());
+		for (::dcs::uri_query_view::const_iterator it = qv.begin(); it != qv.end(); ++it)
+		{
+			check += it->key(kbuf).size()+it->value(buf).size();
+		}
+	}
+	print_row("uri_view (all decoded)", ns_per_item(n, clock_type::now()-start));
+
+	return check == 0;
+}
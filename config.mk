@@ -0,0 +1,26 @@
+## \file config.mk
+##
+## \brief Configurations for the Make build system.
+##
+## [2026-10-18 11:04:02 (UTC)]
+## This is an autogenerated file. Do not edit.
+##
+## \author Marco Guazzone (marco.guazzone@gmail.com)
+##
+
+CPPFLAGS_release+=
+CFLAGS_release+=
+CXXFLAGS_release+=
+LDFLAGS_release+=-llapack
+CPPFLAGS_debug+=
+CFLAGS_debug+=
+CXXFLAGS_debug+=
+LDFLAGS_debug+=-llapack
+CPPFLAGS_test+=
+CFLAGS_test+=
+CXXFLAGS_test+=
+LDFLAGS_test+=-llapack
+CPPFLAGS_xmp+=
+CFLAGS_xmp+=
+CXXFLAGS_xmp+=
+LDFLAGS_xmp+=-llapack
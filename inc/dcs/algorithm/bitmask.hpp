@@ -0,0 +1,555 @@
+/**
+ * \file dcs/algorithm/bitmask.hpp
+ *
+ * \brief Bit sets stored in raw machine words.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_BITMASK_HPP
+#define DCS_ALGORITHM_BITMASK_HPP
+
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <iterator>
+
+
+namespace dcs { namespace algorithm {
+
+/// The type of the machine words storing a bitmask.
+typedef ::boost::uint64_t bitmask_word_type;
+
+namespace detail {
+
+/// Number of bits in a bitmask word.
+static const ::std::size_t bitmask_word_bits = 64;
+
+/// Number of words needed to store \a n bits.
+inline
+::std::size_t bitmask_num_words(::std::size_t n)
+{
+	return (n+bitmask_word_bits-1)/bitmask_word_bits;
+}
+
+/// Position of the lowest set bit of a nonzero word.
+inline
+::std::size_t bitmask_ctz(bitmask_word_type w)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(w);
+#else
+	::std::size_t n(0);
+	while (!(w & 1))
+	{
+		w >>= 1;
+		++n;
+	}
+	return n;
+#endif // __GNUC__
+}
+
+/// Position of the highest set bit of a nonzero word.
+inline
+::std::size_t bitmask_msb(bitmask_word_type w)
+{
+#if defined(__GNUC__)
+	return bitmask_word_bits-1-__builtin_clzll(w);
+#else
+	::std::size_t n(0);
+	while (w >>= 1)
+	{
+		++n;
+	}
+	return n;
+#endif // __GNUC__
+}
+
+/// Number of set bits of a word.
+inline
+::std::size_t bitmask_popcount(bitmask_word_type w)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(w);
+#else
+	::std::size_t n(0);
+	for (; w; w &= w-1)
+	{
+		++n;
+	}
+	return n;
+#endif // __GNUC__
+}
+
+/// Word with the bits in [first,last) set, for 0 <= first <= last <= 64.
+inline
+bitmask_word_type bitmask_range_word(::std::size_t first, ::std::size_t last)
+{
+	const bitmask_word_type hi(last < bitmask_word_bits ? ((bitmask_word_type(1) << last)-1) : ~bitmask_word_type(0));
+	const bitmask_word_type lo((bitmask_word_type(1) << first)-1);
+
+	return hi & ~lo;
+}
+
+/// Sets (if \a value is \c true) or clears the bits in [first,last).
+inline
+void bitmask_assign_range(bitmask_word_type* words, ::std::size_t first, ::std::size_t last, bool value)
+{
+	while (first < last)
+	{
+		const ::std::size_t w(first/bitmask_word_bits);
+		const ::std::size_t b(first%bitmask_word_bits);
+		const ::std::size_t e(((last-first) < (bitmask_word_bits-b)) ? (b+last-first) : bitmask_word_bits);
+		const bitmask_word_type m(bitmask_range_word(b, e));
+
+		if (value)
+		{
+			words[w] |= m;
+		}
+		else
+		{
+			words[w] &= ~m;
+		}
+		first += e-b;
+	}
+}
+
+/// Number of set bits in the first \a nw words.
+inline
+::std::size_t bitmask_count(bitmask_word_type const* words, ::std::size_t nw)
+{
+	::std::size_t c(0);
+	for (::std::size_t i = 0; i < nw; ++i)
+	{
+		c += bitmask_popcount(words[i]);
+	}
+	return c;
+}
+
+/**
+ * \brief Position of the first bit, at or after \a pos, equal to \a value, or
+ *  \a n if there is none.
+ *
+ * Bits beyond \a n are assumed to be zero.
+ */
+inline
+::std::size_t bitmask_find_from(bitmask_word_type const* words, ::std::size_t n, ::std::size_t pos, bool value)
+{
+	if (pos >= n)
+	{
+		return n;
+	}
+
+	const ::std::size_t nw(bitmask_num_words(n));
+	::std::size_t w(pos/bitmask_word_bits);
+	bitmask_word_type x((value ? words[w] : ~words[w]) & ~bitmask_range_word(0, pos%bitmask_word_bits));
+	while (!x)
+	{
+		if (++w == nw)
+		{
+			return n;
+		}
+		x = value ? words[w] : ~words[w];
+	}
+
+	const ::std::size_t p(w*bitmask_word_bits+bitmask_ctz(x));
+
+	return p < n ? p : n;
+}
+
+/// Position of the last set bit before \a pos, or \a n if there is none.
+inline
+::std::size_t bitmask_find_before(bitmask_word_type const* words, ::std::size_t n, ::std::size_t pos)
+{
+	if (pos > n)
+	{
+		pos = n;
+	}
+	if (pos == 0)
+	{
+		return n;
+	}
+
+	::std::size_t w((pos-1)/bitmask_word_bits);
+	bitmask_word_type x(words[w] & bitmask_range_word(0, pos-w*bitmask_word_bits));
+	while (!x)
+	{
+		if (w == 0)
+		{
+			return n;
+		}
+		x = words[--w];
+	}
+
+	return w*bitmask_word_bits+bitmask_msb(x);
+}
+
+/**
+ * \brief Adds one to the multiword number in the first \a nw words.
+ *
+ * \return The number of bits cleared by the carry.
+ */
+inline
+::std::size_t bitmask_increment(bitmask_word_type* words, ::std::size_t nw)
+{
+	::std::size_t cleared(0);
+	for (::std::size_t i = 0; i < nw; ++i)
+	{
+		if (words[i] != ~bitmask_word_type(0))
+		{
+			cleared += bitmask_ctz(~words[i]);
+			++words[i];
+			break;
+		}
+		words[i] = 0;
+		cleared += bitmask_word_bits;
+	}
+	return cleared;
+}
+
+/**
+ * \brief Subtracts one from the multiword number in the first \a nw words.
+ *
+ * \return The number of bits set by the borrow.
+ */
+inline
+::std::size_t bitmask_decrement(bitmask_word_type* words, ::std::size_t nw)
+{
+	::std::size_t set(0);
+	for (::std::size_t i = 0; i < nw; ++i)
+	{
+		if (words[i] != 0)
+		{
+			set += bitmask_ctz(words[i]);
+			--words[i];
+			break;
+		}
+		words[i] = ~bitmask_word_type(0);
+		set += bitmask_word_bits;
+	}
+	return set;
+}
+
+/**
+ * \brief Moves to the next set of the same size in colexicographic order
+ *  (Gosper's hack, extended to multiple words).
+ *
+ * The lowest run of ones is cleared, the bit just above it is set and the
+ * remaining ones of the run are moved to the lowest positions.
+ *
+ * \return \c false (leaving the bits unchanged) if the set is the last one.
+ */
+inline
+bool bitmask_next_colex(bitmask_word_type* words, ::std::size_t n)
+{
+	const ::std::size_t lo(bitmask_find_from(words, n, 0, true));
+	if (lo == n)
+	{
+		return false;
+	}
+	const ::std::size_t z(bitmask_find_from(words, n, lo, false));
+	if (z == n)
+	{
+		return false;
+	}
+
+	if (z <= bitmask_word_bits)
+	{
+		// Single-word fast path: the whole run is in the first word
+		const bitmask_word_type w(words[0]);
+		const bitmask_word_type t(w | (w-1));
+		const bitmask_word_type run(bitmask_range_word(lo, z));
+
+		words[0] = (w & ~run) | bitmask_range_word(0, z-lo-1);
+		if (z < bitmask_word_bits)
+		{
+			words[0] |= (t+1) & ~t;
+		}
+		else
+		{
+			words[1] |= 1;
+		}
+	}
+	else
+	{
+		bitmask_assign_range(words, lo, z, false);
+		words[z/bitmask_word_bits] |= bitmask_word_type(1) << (z%bitmask_word_bits);
+		bitmask_assign_range(words, 0, z-lo-1, true);
+	}
+
+	return true;
+}
+
+/**
+ * \brief Moves to the previous set of the same size in colexicographic
+ *  order.
+ *
+ * The lowest set bit above the initial run of ones is cleared and the
+ * initial run, plus one bit, is moved just below it.
+ *
+ * \return \c false (leaving the bits unchanged) if the set is the first one.
+ */
+inline
+bool bitmask_prev_colex(bitmask_word_type* words, ::std::size_t n)
+{
+	const ::std::size_t j(bitmask_find_from(words, n, 0, false));
+	const ::std::size_t p(bitmask_find_from(words, n, j, true));
+	if (p == n)
+	{
+		return false;
+	}
+
+	words[p/bitmask_word_bits] &= ~(bitmask_word_type(1) << (p%bitmask_word_bits));
+	bitmask_assign_range(words, 0, j, false);
+	bitmask_assign_range(words, p-1-j, p, true);
+
+	return true;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Read-only view of a set of small integers stored as a bitmask.
+ *
+ * The view refers to the first \a n bits of an array of machine words (the
+ * bit at position \f$i\f$ is bit \f$i \bmod 64\f$ of word
+ * \f$\lfloor i/64 \rfloor\f$); bits beyond \a n must be zero.
+ * It neither owns nor copies the words, so that it is as cheap as a pointer
+ * and stays up to date with the underlying storage.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class bitmask_view
+{
+	public: typedef bitmask_word_type word_type;
+	public: typedef ::std::size_t size_type;
+	public: class const_iterator;
+	public: typedef const_iterator iterator;
+
+
+	public: bitmask_view(word_type const* words, size_type n)
+	: words_(words),
+	  n_(n)
+	{
+	}
+
+	/// Returns the number of bits.
+	public: size_type num_bits() const
+	{
+		return n_;
+	}
+
+	/// Returns the number of words.
+	public: size_type num_words() const
+	{
+		return detail::bitmask_num_words(n_);
+	}
+
+	/// Returns the underlying words.
+	public: word_type const* data() const
+	{
+		return words_;
+	}
+
+	/// Returns the number of set bits.
+	public: size_type count() const
+	{
+		return detail::bitmask_count(words_, this->num_words());
+	}
+
+	public: bool test(size_type pos) const
+	{
+		return (words_[pos/detail::bitmask_word_bits] >> (pos%detail::bitmask_word_bits)) & 1;
+	}
+
+	public: bool any() const
+	{
+		return this->find_first() != n_;
+	}
+
+	public: bool none() const
+	{
+		return !this->any();
+	}
+
+	/// Returns the position of the first set bit, or num_bits() if none.
+	public: size_type find_first() const
+	{
+		return detail::bitmask_find_from(words_, n_, 0, true);
+	}
+
+	/// Returns the position of the first set bit after \a pos, or num_bits()
+	/// if none.
+	public: size_type find_next(size_type pos) const
+	{
+		return detail::bitmask_find_from(words_, n_, pos+1, true);
+	}
+
+	/// Returns the position of the last set bit before \a pos, or num_bits()
+	/// if none.
+	public: size_type find_prev(size_type pos) const
+	{
+		return detail::bitmask_find_before(words_, n_, pos);
+	}
+
+	/// Returns an iterator to the position of the first set bit.
+	public: const_iterator begin() const
+	{
+		return const_iterator(words_, n_, this->find_first());
+	}
+
+	public: const_iterator end() const
+	{
+		return const_iterator(words_, n_, n_);
+	}
+
+
+	/// Bidirectional iterator over the positions of the set bits.
+	public: class const_iterator
+	{
+		public: typedef ::std::bidirectional_iterator_tag iterator_category;
+		public: typedef size_type value_type;
+		public: typedef ::std::ptrdiff_t difference_type;
+		public: typedef size_type const* pointer;
+		public: typedef size_type const& reference;
+
+
+		public: const_iterator()
+		: words_(0),
+		  n_(0),
+		  pos_(0)
+		{
+		}
+
+		public: const_iterator(word_type const* words, size_type n, size_type pos)
+		: words_(words),
+		  n_(n),
+		  pos_(pos)
+		{
+		}
+
+		public: reference operator*() const
+		{
+			return pos_;
+		}
+
+		public: pointer operator->() const
+		{
+			return &(operator*());
+		}
+
+		public: const_iterator& operator++()
+		{
+			pos_ = detail::bitmask_find_from(words_, n_, pos_+1, true);
+
+			return *this;
+		}
+
+		public: const_iterator operator++(int)
+		{
+			const_iterator tmp = *this;
+
+			operator++();
+
+			return tmp;
+		}
+
+		public: const_iterator& operator--()
+		{
+			pos_ = detail::bitmask_find_before(words_, n_, pos_);
+
+			return *this;
+		}
+
+		public: const_iterator operator--(int)
+		{
+			const_iterator tmp = *this;
+
+			operator--();
+
+			return tmp;
+		}
+
+		public: const_iterator operator+(difference_type n) const
+		{
+			const_iterator it = *this;
+
+			it += n;
+
+			return it;
+		}
+
+		public: const_iterator operator-(difference_type n) const
+		{
+			return operator+(-n);
+		}
+
+		public: const_iterator& operator+=(difference_type n)
+		{
+			if (n > 0)
+			{
+				while (n--)
+				{
+					operator++();
+				}
+			}
+			else
+			{
+				while (n++)
+				{
+					operator--();
+				}
+			}
+
+			return *this;
+		}
+
+		public: const_iterator& operator-=(difference_type n)
+		{
+			return operator+=(-n);
+		}
+
+		friend
+		bool operator==(const_iterator const& lhs, const_iterator const& rhs)
+		{
+			return lhs.words_ == rhs.words_ && lhs.pos_ == rhs.pos_;
+		}
+
+		friend
+		bool operator!=(const_iterator const& lhs, const_iterator const& rhs)
+		{
+			return !(lhs == rhs);
+		}
+
+
+		private: word_type const* words_;
+		private: size_type n_;
+		private: size_type pos_;
+	}; // const_iterator
+
+
+	private: word_type const* words_;
+	private: size_type n_;
+}; // bitmask_view
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_BITMASK_HPP
@@ -63,7 +63,10 @@
 #include <algorithm>
 #include <cstddef>
 #include <dcs/algorithm/detail/combperm.hpp>
+#include <dcs/algorithm/prefix_visit.hpp>
+#include <dcs/assert.hpp>
 #include <dcs/detail/macro_cx11.hpp>
+#include <dcs/exception.hpp>
 #include <iterator>
 #include <limits>
 #include <stdexcept>
@@ -133,6 +136,189 @@ inline
 												   ::std::distance(mid, last));
 }
 
+namespace detail {
+
+/**
+ * \brief Visits the extensions of the prefix [\a first, \a pos) by \a k more
+ *  elements taken in order from the \a nc candidates in [\a cand, \a last).
+ *
+ * The candidate put at position \a pos is swapped in and, once its subtree
+ * has been visited, swapped back, so that the range is restored on return.
+ * Positions in between \a pos and \a cand hold elements that are neither
+ * in the prefix nor candidates.
+ *
+ * \return \c true if the visitor has stopped the enumeration.
+ */
+template <typename BidirIter, typename Function>
+bool combine_prefix(BidirIter first,
+					BidirIter pos,
+					BidirIter cand,
+					BidirIter last,
+					typename ::std::iterator_traits<BidirIter>::difference_type nc,
+					typename ::std::iterator_traits<BidirIter>::difference_type k,
+					Function& f)
+{
+	BidirIter next_pos(pos);
+	++next_pos;
+
+	for (; nc >= k; ++cand, --nc)
+	{
+		::std::iter_swap(pos, cand);
+
+		const prefix_visit_action action(f(first, next_pos));
+		bool stop(action == stop_prefix_visit_action);
+		if (!stop && action == descend_prefix_visit_action && k > 1)
+		{
+			BidirIter next_cand(cand);
+			++next_cand;
+			stop = combine_prefix(first, next_pos, next_cand, last, nc-1, k-1, f);
+		}
+
+		::std::iter_swap(pos, cand);
+
+		if (stop)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // Namespace detail
+
+/**
+ * \brief Visits the prefixes of the combinations of [\a first, \a last) of
+ *  size \c distance(first,mid), with pruning.
+ *
+ * Combinations are built in the lexicographic order of their positions (the
+ * order of \c for_each_combination), one element at a time.
+ * For each prefix of size \f$1,\ldots,r\f$, the visitor is called as
+ * \c f(first,pos), where the prefix is in [\a first, \a pos), and returns a
+ * \c prefix_visit_action, so that the combinations starting with a prefix
+ * that cannot lead to an acceptable solution are skipped as a whole.
+ * The prefix is complete when \c pos is equal to \a mid; if the visitor never
+ * skips, exactly \c count_each_combination(first,mid,last) complete prefixes
+ * are visited.
+ * If \f$r=0\f$, the visitor is called once with an empty prefix.
+ *
+ * On return, the range is in its original order.
+ */
+template <typename BidirIter, typename Function>
+Function for_each_combination_prefix(BidirIter first,
+									 BidirIter mid,
+									 BidirIter last,
+									 Function f)
+{
+	if (first == mid)
+	{
+		f(first, mid);
+	}
+	else
+	{
+		detail::combine_prefix(first,
+							   first,
+							   first,
+							   last,
+							   ::std::distance(first, last),
+							   ::std::distance(first, mid),
+							   f);
+	}
+
+	return DCS_DETAIL_MACRO_CX11_STD_MOVE_(f);
+}
+
+namespace detail {
+
+/// Binomial coefficient \f$\binom{n}{k}\f$, which is zero when \f$k>n\f$.
+inline
+::std::size_t checked_binomial(::std::size_t n, ::std::size_t k)
+{
+	return k > n ? 0 : count_each_combination< ::std::size_t >(k, n-k);
+}
+
+} // Namespace detail
+
+/**
+ * \brief Rank of a combination in the lexicographic order of its positions.
+ *
+ * The combination is given by the sorted positions in [\a first, \a last)
+ * among the \a n positions of the total range; this is the order in which
+ * \c for_each_combination visits combinations, so that, for instance,
+ * the positions <tt>(0 1)</tt>, <tt>(0 2)</tt>, <tt>(1 2)</tt> of 3 elements
+ * have rank 0, 1 and 2, respectively.
+ *
+ * Counting the combinations that follow the given one,
+ * \f$\mathrm{rank}=\binom{n}{r}-1-\sum_{i=0}^{r-1}\binom{n-1-c_i}{r-i}\f$,
+ * where \f$c_i\f$ is the \f$i\f$-th position.
+ */
+template <typename InIterT>
+::std::size_t rank_combination(InIterT first, InIterT last, ::std::size_t n)
+{
+	const ::std::size_t r(::std::distance(first, last));
+
+	// pre: r <= n
+	DCS_ASSERT(r <= n,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Size of combination is out of range"));
+
+	::std::size_t rank(detail::checked_binomial(n, r)-1);
+	for (::std::size_t i = 0; first != last; ++first, ++i)
+	{
+		// pre: positions are sorted and in range
+		DCS_ASSERT(static_cast< ::std::size_t >(*first) < n,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Position is out of range"));
+
+		rank -= detail::checked_binomial(n-1-*first, r-i);
+	}
+
+	return rank;
+}
+
+/**
+ * \brief Combination (as sorted positions) of the given lexicographic rank.
+ *
+ * Writes to \a out the \a r sorted positions, among \a n, of the combination
+ * whose rank (see \c rank_combination) is \a rank.
+ */
+template <typename OutIterT>
+OutIterT unrank_combination(::std::size_t rank, ::std::size_t n, ::std::size_t r, OutIterT out)
+{
+	// pre: r <= n
+	DCS_ASSERT(r <= n,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Size of combination is out of range"));
+
+	const ::std::size_t count(detail::checked_binomial(n, r));
+
+	// pre: rank < count
+	DCS_ASSERT(rank < count,
+			   DCS_EXCEPTION_THROW(::std::out_of_range,
+								   "Rank is out of range"));
+
+	// Greedily decompose the rank of the complementary combination in the
+	// combinatorial number system
+	::std::size_t m(count-1-rank);
+	::std::size_t a(n);
+	for (::std::size_t i = 0; i < r; ++i)
+	{
+		::std::size_t c(0);
+		do
+		{
+			--a;
+			c = detail::checked_binomial(a, r-i);
+		}
+		while (c > m);
+
+		m -= c;
+		*out = n-1-a;
+		++out;
+	}
+
+	return out;
+}
+
 /**
  * \brief Takes a sequence defined by the range [\a first,\a last) such that
  *  [\a first,\a middle) stores a combination, i.e., some sorted subsequence of
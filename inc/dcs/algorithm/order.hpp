@@ -28,7 +28,22 @@
 
 
 #include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/is_scalar.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/type_traits/remove_cv.hpp>
 #include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
 
 
 namespace dcs { namespace algorithm {
@@ -75,6 +90,483 @@ struct index_less_than_cmp
 	ComparatorT comp_;
 };
 
+
+/// Below this size, data is likely to fit in cache and sorting indices is
+/// faster than sorting key-index pairs or radix sorting.
+static const ::std::size_t order_index_threshold = 1024;
+
+
+/**
+ * \brief Maps keys to unsigned integers with the same ordering, to be radix
+ *  sorted.
+ *
+ * Signed integers get their sign bit flipped.
+ * Floating-point numbers (in IEEE 754 format) get their sign bit flipped if
+ * positive and all their bits flipped if negative, so that more negative
+ * numbers get smaller keys; thus, \f$-0\f$ comes before \f$+0\f$ and NaNs
+ * come after \f$+\infty\f$ (or before \f$-\infty\f$, if their sign bit is
+ * set).
+ */
+template <typename T,
+		  bool IsIntegral = ::boost::is_integral<T>::value && !::boost::is_same<T,bool>::value>
+struct radix_key_traits_impl
+{
+	static const bool is_radix = false;
+};
+
+template <typename T>
+struct radix_key_traits_impl<T,true>
+{
+	typedef typename ::boost::make_unsigned<T>::type key_type;
+
+	static const bool is_radix = true;
+
+	static key_type encode(T x)
+	{
+		key_type k(static_cast<key_type>(x));
+		if (::boost::is_signed<T>::value)
+		{
+			k ^= key_type(1) << (::std::numeric_limits<key_type>::digits-1);
+		}
+		return k;
+	}
+};
+
+/// Maps IEEE 754 floating-point numbers to radix keys (see
+/// radix_key_traits_impl).
+template <typename T, typename UIntT>
+struct float_radix_key_traits
+{
+	typedef UIntT key_type;
+
+	static const bool is_radix = ::std::numeric_limits<T>::is_iec559 && sizeof(T) == sizeof(UIntT);
+
+	static key_type encode(T x)
+	{
+		key_type k;
+		::std::memcpy(&k, &x, sizeof(k));
+
+		const key_type sign(key_type(1) << (::std::numeric_limits<key_type>::digits-1));
+		return (k & sign) ? ~k : (k | sign);
+	}
+};
+
+template <>
+struct radix_key_traits_impl<float,false>: public float_radix_key_traits<float, ::boost::uint32_t>
+{
+};
+
+template <>
+struct radix_key_traits_impl<double,false>: public float_radix_key_traits<double, ::boost::uint64_t>
+{
+};
+
+template <typename T>
+struct radix_key_traits: public radix_key_traits_impl<typename ::boost::remove_cv<T>::type>
+{
+};
+
+
+/**
+ * \brief Stable LSD radix sort of (key,index) pairs by unsigned key, one byte
+ *  per pass.
+ *
+ * The histograms of all the bytes are computed in a single pass; bytes that
+ * are equal for all the keys (e.g., the high bytes of small integers) are
+ * skipped.
+ */
+template <typename KeyT, typename IndexT>
+void radix_sort_pairs(::std::pair<KeyT,IndexT>* first, ::std::pair<KeyT,IndexT>* last)
+{
+	typedef ::std::pair<KeyT,IndexT> item_type;
+
+	const ::std::size_t n(last-first);
+	const ::std::size_t nb(sizeof(KeyT));
+	const ::std::size_t radix(256);
+
+	if (n < 2)
+	{
+		return;
+	}
+
+	::std::vector< ::std::size_t > counts(nb*radix, 0);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		const KeyT k(first[i].first);
+		for (::std::size_t b = 0; b < nb; ++b)
+		{
+			++counts[b*radix+((k >> (8*b)) & 0xFF)];
+		}
+	}
+
+	::std::vector<item_type> buf(n);
+	item_type* src(first);
+	item_type* dst(&buf[0]);
+	for (::std::size_t b = 0; b < nb; ++b)
+	{
+		::std::size_t* cnt(&counts[b*radix]);
+
+		if (cnt[(src[0].first >> (8*b)) & 0xFF] == n)
+		{
+			continue;
+		}
+
+		::std::size_t sum(0);
+		for (::std::size_t d = 0; d < radix; ++d)
+		{
+			const ::std::size_t c(cnt[d]);
+			cnt[d] = sum;
+			sum += c;
+		}
+
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			dst[cnt[(src[i].first >> (8*b)) & 0xFF]++] = src[i];
+		}
+
+		::std::swap(src, dst);
+	}
+
+	if (src != first)
+	{
+		::std::copy(src, src+n, first);
+	}
+}
+
+
+/// Compares (key,index) pairs by key.
+template <typename ItemT, typename ComparatorT>
+struct key_index_less
+{
+	explicit key_index_less(ComparatorT comp)
+	: comp_(comp)
+	{
+	}
+
+	bool operator()(ItemT const& a, ItemT const& b) const
+	{
+		return comp_(a.first, b.first);
+	}
+
+	mutable ComparatorT comp_; ///< The comparator, which might be stateful
+};
+
+/// Compares indices by the element they refer to (like index_less_than_cmp,
+/// for any type of index).
+template <typename RandomAccessIteratorT, typename IndexT, typename ComparatorT>
+struct index_less
+{
+	index_less(RandomAccessIteratorT first, ComparatorT comp)
+	: first_(first),
+	  comp_(comp)
+	{
+	}
+
+	bool operator()(IndexT a, IndexT b) const
+	{
+		return comp_(first_[a], first_[b]);
+	}
+
+	RandomAccessIteratorT first_;
+	mutable ComparatorT comp_; ///< The comparator, which might be stateful
+};
+
+
+/*
+ * Ordering policies.
+ *
+ * A policy turns the index of an element into an item to sort, tells how
+ * items compare and how to sort a contiguous block of items.
+ */
+
+/// Radix sort of (encoded key,index) pairs.
+template <typename RandomAccessIteratorT, typename IndexT>
+struct radix_order_policy
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+	typedef radix_key_traits<value_type> traits_type;
+	typedef IndexT index_type;
+	typedef typename traits_type::key_type key_type;
+	typedef ::std::pair<key_type, index_type> item_type;
+	typedef key_index_less< item_type, ::std::less<key_type> > item_less;
+
+	explicit radix_order_policy(RandomAccessIteratorT first)
+	: first_(first)
+	{
+	}
+
+	item_type item(index_type i) const
+	{
+		return item_type(traits_type::encode(first_[i]), i);
+	}
+
+	static index_type index(item_type const& x)
+	{
+		return x.second;
+	}
+
+	item_less less() const
+	{
+		return item_less(::std::less<key_type>());
+	}
+
+	void sort(item_type* first, item_type* last) const
+	{
+		radix_sort_pairs(first, last);
+	}
+
+	RandomAccessIteratorT first_;
+};
+
+/// Comparison sort of (key,index) pairs, which keeps keys contiguous.
+template <typename RandomAccessIteratorT, typename IndexT, typename ComparatorT>
+struct key_index_order_policy
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+	typedef IndexT index_type;
+	typedef ::std::pair<value_type, index_type> item_type;
+	typedef key_index_less<item_type,ComparatorT> item_less;
+
+	key_index_order_policy(RandomAccessIteratorT first, ComparatorT comp)
+	: first_(first),
+	  comp_(comp)
+	{
+	}
+
+	item_type item(index_type i) const
+	{
+		return item_type(first_[i], i);
+	}
+
+	static index_type index(item_type const& x)
+	{
+		return x.second;
+	}
+
+	item_less less() const
+	{
+		return item_less(comp_);
+	}
+
+	void sort(item_type* first, item_type* last) const
+	{
+		::std::sort(first, last, this->less());
+	}
+
+	RandomAccessIteratorT first_;
+	ComparatorT comp_;
+};
+
+/// Comparison sort of indices, for keys that are expensive to copy.
+template <typename RandomAccessIteratorT, typename IndexT, typename ComparatorT>
+struct index_order_policy
+{
+	typedef IndexT index_type;
+	typedef index_type item_type;
+	typedef index_less<RandomAccessIteratorT,index_type,ComparatorT> item_less;
+
+	index_order_policy(RandomAccessIteratorT first, ComparatorT comp)
+	: first_(first),
+	  comp_(comp)
+	{
+	}
+
+	item_type item(index_type i) const
+	{
+		return i;
+	}
+
+	static index_type index(item_type x)
+	{
+		return x;
+	}
+
+	item_less less() const
+	{
+		return item_less(first_, comp_);
+	}
+
+	void sort(item_type* first, item_type* last) const
+	{
+		::std::sort(first, last, this->less());
+	}
+
+	RandomAccessIteratorT first_;
+	ComparatorT comp_;
+};
+
+
+/// Sorts the items of \a n elements with the given policy in the calling
+/// thread.
+struct serial_order_driver
+{
+	template <typename PolicyT, typename ForwardIteratorT>
+	void operator()(PolicyT const& policy, ::std::size_t n, ForwardIteratorT result) const
+	{
+		typedef typename PolicyT::index_type index_type;
+		typedef typename PolicyT::item_type item_type;
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		::std::vector<item_type> items;
+		items.reserve(n);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			items.push_back(policy.item(static_cast<index_type>(i)));
+		}
+
+		policy.sort(&items[0], &items[0]+n);
+
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			*result = policy.index(items[i]);
+			++result;
+		}
+	}
+};
+
+
+/*
+ * Policy selection.
+ *
+ * Indices are 32-bit wide whenever possible, to halve the memory traffic of
+ * the items.
+ */
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename DriverT>
+void radix_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, DriverT const& driver)
+{
+	if (n <= ::std::numeric_limits< ::boost::uint32_t >::max())
+	{
+		driver(radix_order_policy<RandomAccessIteratorT, ::boost::uint32_t>(first), n, result);
+	}
+	else
+	{
+		driver(radix_order_policy<RandomAccessIteratorT, ::std::size_t>(first), n, result);
+	}
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void key_index_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver)
+{
+	if (n <= ::std::numeric_limits< ::boost::uint32_t >::max())
+	{
+		driver(key_index_order_policy<RandomAccessIteratorT, ::boost::uint32_t, ComparatorT>(first, comp), n, result);
+	}
+	else
+	{
+		driver(key_index_order_policy<RandomAccessIteratorT, ::std::size_t, ComparatorT>(first, comp), n, result);
+	}
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void index_order_items(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver)
+{
+	if (n <= ::std::numeric_limits< ::boost::uint32_t >::max())
+	{
+		driver(index_order_policy<RandomAccessIteratorT, ::boost::uint32_t, ComparatorT>(first, comp), n, result);
+	}
+	else
+	{
+		driver(index_order_policy<RandomAccessIteratorT, ::std::size_t, ComparatorT>(first, comp), n, result);
+	}
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void index_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver)
+{
+	index_order_items(first, n, result, comp, driver);
+}
+
+/// Sorts the indices directly in the output range, when possible.
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
+void index_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, serial_order_driver const& driver, ::std::forward_iterator_tag)
+{
+	index_order_items(first, n, result, comp, driver);
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
+void index_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, serial_order_driver const&, ::std::random_access_iterator_tag)
+{
+	typedef typename ::std::iterator_traits<ForwardIteratorT>::value_type index_type;
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		result[i] = static_cast<index_type>(i);
+	}
+	::std::sort(result, result+n, index_less<RandomAccessIteratorT,index_type,ComparatorT>(first, comp));
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
+void index_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, serial_order_driver const& driver)
+{
+	index_order(first, n, result, comp, driver, typename ::std::iterator_traits<ForwardIteratorT>::iterator_category());
+}
+
+/// Copies scalar keys of large ranges next to their index; sorts indices
+/// otherwise.
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver, ::boost::true_type /*scalar key*/)
+{
+	if (n >= order_index_threshold)
+	{
+		key_index_order(first, n, result, comp, driver);
+	}
+	else
+	{
+		index_order(first, n, result, comp, driver);
+	}
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver, ::boost::false_type /*scalar key*/)
+{
+	index_order(first, n, result, comp, driver);
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, ComparatorT comp, DriverT const& driver)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	dispatch_order(first, n, result, comp, driver, ::boost::integral_constant<bool, ::boost::is_scalar<value_type>::value>());
+}
+
+/// Radix sorts large ranges of integer and floating-point keys.
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, DriverT const& driver, ::boost::true_type /*radix key*/)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	if (n >= order_index_threshold)
+	{
+		radix_order(first, n, result, driver);
+	}
+	else
+	{
+		index_order(first, n, result, ::std::less<value_type>(), driver);
+	}
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, DriverT const& driver, ::boost::false_type /*radix key*/)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	dispatch_order(first, n, result, ::std::less<value_type>(), driver);
+}
+
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename DriverT>
+void dispatch_order(RandomAccessIteratorT first, ::std::size_t n, ForwardIteratorT result, DriverT const& driver)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	dispatch_order(first, n, result, driver, ::boost::integral_constant<bool, radix_key_traits<value_type>::is_radix>());
+}
+
 } // Namespace detail
 
 
@@ -90,25 +582,22 @@ struct index_less_than_cmp
  *  indices.
  *
  * The input sequence is ordered according to the standard operator \c &lt;.
+ *
+ * Short sequences are ordered by sorting indices, which access elements
+ * through the input iterator.
+ * Longer ones are ordered according to the type of the elements:
+ * - integer and floating-point elements are radix sorted (see
+ *   \c radix_order);
+ * - other scalar elements (e.g., pointers) are sorted together with their
+ *   index (see \c key_index_order);
+ * - other elements are ordered by sorting indices.
+ * .
+ * The relative order of the indices of equivalent elements is unspecified.
  */
 template <typename RandomAccessIteratorT, typename ForwardIteratorT>
 void order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result)
 {
-	ForwardIteratorT result_begin = result;
-	for (
-		RandomAccessIteratorT it = first;
-		it != last;
-		++it
-	) {
-		*result = it-first;
-		++result;
-	}
-	
-	::std::sort(
-		result_begin,
-		result,
-		detail::index_less_than<RandomAccessIteratorT&>(first)
-	);
+	detail::dispatch_order(first, last-first, result, detail::serial_order_driver());
 }
 
 
@@ -127,25 +616,70 @@ void order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardItera
  *  sequence.
  *
  * The input sequence is ordered according to the given comparator functor.
+ *
+ * Long sequences of scalar elements are sorted together with their index (see
+ * \c key_index_order); otherwise, indices are sorted.
+ * The relative order of the indices of equivalent elements is unspecified.
  */
 template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
 void order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result, ComparatorT comp)
 {
-	ForwardIteratorT result_begin = result;
-	for (
-		RandomAccessIteratorT it = first;
-		it != last;
-		++it
-	) {
-		*result = it-first;
-		++result;
-	}
-	
-	::std::sort(
-		result_begin,
-		result,
-		detail::index_less_than_cmp<RandomAccessIteratorT&, ComparatorT&>(first, comp)
-	);
+	detail::dispatch_order(first, last-first, result, comp, detail::serial_order_driver());
+}
+
+
+/**
+ * \brief Computes the permutation of indices which makes the given range of
+ *  integer or floating-point numbers ordered, by radix sort.
+ *
+ * Each element is mapped to an unsigned integer key of the same size, which
+ * is sorted together with the index of the element by a least significant
+ * digit radix sort, one byte at a time.
+ * Thus, the time is linear in the size of the range.
+ * Floating-point numbers are ordered by their sign and magnitude, so that
+ * \f$-0\f$ precedes \f$+0\f$, and NaNs follow \f$+\infty\f$ (or precede
+ * \f$-\infty\f$ if their sign bit is set).
+ * The ordering is stable.
+ */
+template <typename RandomAccessIteratorT, typename ForwardIteratorT>
+void radix_order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	BOOST_STATIC_ASSERT( detail::radix_key_traits<value_type>::is_radix );
+
+	detail::radix_order(first, last-first, result, detail::serial_order_driver());
+}
+
+
+/**
+ * \brief Computes the permutation of indices which makes the given range
+ *  ordered, by sorting copies of the elements together with their index.
+ *
+ * Since keys are contiguous in memory, comparisons do not go through the
+ * input iterator; this pays off for long sequences of elements that are
+ * cheap to copy.
+ * The relative order of the indices of equivalent elements is unspecified.
+ */
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
+void key_index_order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result, ComparatorT comp)
+{
+	detail::key_index_order(first, last-first, result, comp, detail::serial_order_driver());
+}
+
+
+/**
+ * \brief Computes the permutation of indices which makes the given range
+ *  ordered, by sorting copies of the elements together with their index.
+ *
+ * The input sequence is ordered according to the standard operator \c &lt;.
+ */
+template <typename RandomAccessIteratorT, typename ForwardIteratorT>
+void key_index_order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result)
+{
+	typedef typename ::std::iterator_traits<RandomAccessIteratorT>::value_type value_type;
+
+	key_index_order(first, last, result, ::std::less<value_type>());
 }
 
 }} // Namespace dcs::algorithm
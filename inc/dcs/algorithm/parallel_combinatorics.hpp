@@ -0,0 +1,442 @@
+/**
+ * \file dcs/algorithm/parallel_combinatorics.hpp
+ *
+ * \brief Parallel enumeration of combinatorial objects.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_PARALLEL_COMBINATORICS_HPP
+#define DCS_ALGORITHM_PARALLEL_COMBINATORICS_HPP
+
+
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread.hpp>
+#include <cstddef>
+#include <dcs/algorithm/combination.hpp>
+#include <dcs/algorithm/partition.hpp>
+#include <dcs/algorithm/permutation.hpp>
+#include <dcs/algorithm/subset.hpp>
+#include <iterator>
+#include <vector>
+
+
+namespace dcs { namespace algorithm {
+
+namespace detail {
+
+/// The range [first,last) of ranks visited by a worker thread.
+struct rank_range
+{
+	rank_range()
+	: first(0),
+	  last(0),
+	  p_stop(0),
+	  p_exc(0)
+	{
+	}
+
+	::std::size_t first;
+	::std::size_t last;
+	::boost::atomic<bool>* p_stop; ///< Shared flag to stop all workers
+	::boost::exception_ptr* p_exc; ///< Where to store the exception thrown by the worker, if any
+}; // rank_range
+
+/// Visits the objects of a ranked generator (see lexicographic_subset and
+/// friends) in a range of ranks.
+template <typename GeneratorT, typename FuncT>
+struct generator_range_task: public rank_range
+{
+	generator_range_task(GeneratorT const& gen, FuncT const& f)
+	: gen(gen),
+	  f(f)
+	{
+	}
+
+	void operator()()
+	{
+		if (first == last)
+		{
+			return;
+		}
+
+		try
+		{
+			gen.unrank(first);
+
+			::std::size_t r(first);
+			while (!f(const_cast<GeneratorT const&>(gen)))
+			{
+				if (++r == last || p_stop->load(::boost::memory_order_relaxed))
+				{
+					return;
+				}
+				++gen;
+			}
+			p_stop->store(true);
+		}
+		catch (...)
+		{
+			*p_exc = ::boost::current_exception();
+			p_stop->store(true);
+		}
+	}
+
+	GeneratorT gen; ///< The per-thread generator
+	FuncT f;
+}; // generator_range_task
+
+/// Visits the combinations of the elements in \c *p_elems in a range of
+/// lexicographic ranks.
+template <typename ValueT, typename FuncT>
+struct combination_range_task: public rank_range
+{
+	combination_range_task(::std::vector<ValueT> const& elems, ::std::size_t k, FuncT const& f)
+	: p_elems(&elems),
+	  k(k),
+	  f(f)
+	{
+	}
+
+	void operator()()
+	{
+		if (first == last)
+		{
+			return;
+		}
+
+		try
+		{
+			const ::std::size_t n(p_elems->size());
+
+			::std::vector< ::std::size_t > idx(k);
+			unrank_combination(first, n, k, idx.begin());
+
+			::std::vector<ValueT> buf(*p_elems);
+			::std::size_t r(first);
+			while (true)
+			{
+				// Selected elements go first, the others follow them, both
+				// in their original order
+				::std::size_t q(0);
+				for (::std::size_t p = 0; p < n; ++p)
+				{
+					if (q < k && idx[q] == p)
+					{
+						buf[q++] = (*p_elems)[p];
+					}
+					else
+					{
+						buf[k+p-q] = (*p_elems)[p];
+					}
+				}
+
+				if (f(buf.begin(), buf.begin()+k))
+				{
+					p_stop->store(true);
+					return;
+				}
+				if (++r == last || p_stop->load(::boost::memory_order_relaxed))
+				{
+					return;
+				}
+
+				// Move to the next combination of positions
+				::std::size_t i(k);
+				while (idx[i-1] == (n-k+i-1))
+				{
+					--i;
+				}
+				++idx[i-1];
+				for (; i < k; ++i)
+				{
+					idx[i] = idx[i-1]+1;
+				}
+			}
+		}
+		catch (...)
+		{
+			*p_exc = ::boost::current_exception();
+			p_stop->store(true);
+		}
+	}
+
+	::std::vector<ValueT> const* p_elems;
+	::std::size_t k;
+	FuncT f;
+}; // combination_range_task
+
+/// Visits the permutations of the elements in \c *p_elems in a range of
+/// lexicographic ranks.
+template <typename ValueT, typename FuncT>
+struct permutation_range_task: public rank_range
+{
+	permutation_range_task(::std::vector<ValueT> const& elems, ::std::size_t k, FuncT const& f)
+	: p_elems(&elems),
+	  k(k),
+	  f(f)
+	{
+	}
+
+	void operator()()
+	{
+		if (first == last)
+		{
+			return;
+		}
+
+		try
+		{
+			const ::std::size_t n(p_elems->size());
+
+			// The first k positions are the permutation, the other ones
+			// follow in increasing order
+			::std::vector< ::std::size_t > idx(n);
+			unrank_permutation(first, n, k, idx.begin());
+			::std::vector<bool> used(n, false);
+			for (::std::size_t i = 0; i < k; ++i)
+			{
+				used[idx[i]] = true;
+			}
+			for (::std::size_t p = 0, i = k; p < n; ++p)
+			{
+				if (!used[p])
+				{
+					idx[i++] = p;
+				}
+			}
+
+			::std::vector<ValueT> buf(*p_elems);
+			::std::size_t r(first);
+			while (true)
+			{
+				for (::std::size_t i = 0; i < n; ++i)
+				{
+					buf[i] = (*p_elems)[idx[i]];
+				}
+
+				if (f(buf.begin(), buf.begin()+k))
+				{
+					p_stop->store(true);
+					return;
+				}
+				if (++r == last || p_stop->load(::boost::memory_order_relaxed))
+				{
+					return;
+				}
+
+				// Reversing the tail makes next_permutation skip all the
+				// orderings of the positions not in the permutation
+				::std::reverse(idx.begin()+k, idx.end());
+				::std::next_permutation(idx.begin(), idx.end());
+			}
+		}
+		catch (...)
+		{
+			*p_exc = ::boost::current_exception();
+			p_stop->store(true);
+		}
+	}
+
+	::std::vector<ValueT> const* p_elems;
+	::std::size_t k;
+	FuncT f;
+}; // permutation_range_task
+
+/**
+ * \brief Splits the ranks [0,count) into contiguous ranges and runs a copy of
+ *  \a task on each of them in a separate thread.
+ *
+ * The last range is run by the calling thread.
+ * The first exception thrown by a task, if any, is rethrown.
+ *
+ * \return \c true if a task has been stopped by its function.
+ */
+template <typename TaskT>
+bool run_rank_ranges(TaskT const& task, ::std::size_t count, ::std::size_t num_threads)
+{
+	if (num_threads == 0)
+	{
+		num_threads = ::boost::thread::hardware_concurrency();
+	}
+	num_threads = ::std::max(::std::size_t(1), ::std::min(num_threads, count));
+
+	::boost::atomic<bool> stop(false);
+	::std::vector< ::boost::exception_ptr > excs(num_threads);
+
+	::boost::thread_group workers;
+	const ::std::size_t chunk(count/num_threads);
+	const ::std::size_t extra(count%num_threads);
+	::std::size_t first(0);
+	for (::std::size_t t = 0; t < num_threads; ++t)
+	{
+		TaskT sub(task);
+		sub.first = first;
+		sub.last = first+chunk+(t < extra ? 1 : 0);
+		sub.p_stop = &stop;
+		sub.p_exc = &excs[t];
+		first = sub.last;
+
+		if ((t+1) < num_threads)
+		{
+			workers.create_thread(sub);
+		}
+		else
+		{
+			sub();
+		}
+	}
+	workers.join_all();
+
+	for (::std::size_t t = 0; t < num_threads; ++t)
+	{
+		if (excs[t])
+		{
+			::boost::rethrow_exception(excs[t]);
+		}
+	}
+
+	return stop.load();
+}
+
+} // Namespace detail
+
+/**
+ * \brief Calls \a f on every subset of a set of \a n elements, using up to
+ *  \a num_threads threads.
+ *
+ * The subsets (see lexicographic_subset) are cut into as many contiguous
+ * ranges of ranks as threads, each visited by its own generator and its own
+ * copy of \a f, through <tt>f(lexicographic_subset const&)</tt>.
+ * Thus, \a f must be safe to call concurrently on any shared state; the
+ * visit order is the generation order only within each range.
+ * When \a f returns \c true, all threads stop as soon as possible.
+ * When \a num_threads is zero, the hardware concurrency is used.
+ *
+ * \return \c true if the enumeration has been stopped by \a f.
+ */
+template <typename FuncT>
+bool parallel_for_each_subset(::std::size_t n, bool empty_set, FuncT f, ::std::size_t num_threads = 0)
+{
+	const lexicographic_subset gen(n, empty_set);
+
+	return detail::run_rank_ranges(detail::generator_range_task<lexicographic_subset,FuncT>(gen, f), gen.count(), num_threads);
+}
+
+/**
+ * \brief Calls \a f on every subset of size \a k of a set of \a n elements,
+ *  using up to \a num_threads threads.
+ *
+ * \sa parallel_for_each_subset
+ */
+template <typename FuncT>
+bool parallel_for_each_k_subset(::std::size_t n, ::std::size_t k, FuncT f, ::std::size_t num_threads = 0)
+{
+	const lexicographic_k_subset gen(n, k);
+
+	return detail::run_rank_ranges(detail::generator_range_task<lexicographic_k_subset,FuncT>(gen, f), detail::checked_binomial(n, k), num_threads);
+}
+
+/**
+ * \brief Calls \a f on every partition of a set of \a n elements, using up to
+ *  \a num_threads threads.
+ *
+ * \sa parallel_for_each_subset
+ */
+template <typename FuncT>
+bool parallel_for_each_partition(::std::size_t n, FuncT f, ::std::size_t num_threads = 0)
+{
+	const lexicographic_partition gen(n);
+
+	return detail::run_rank_ranges(detail::generator_range_task<lexicographic_partition,FuncT>(gen, f), gen.count(), num_threads);
+}
+
+/**
+ * \brief Calls \a f on every partition in \a k subsets of a set of \a n
+ *  elements, using up to \a num_threads threads.
+ *
+ * \sa parallel_for_each_subset
+ */
+template <typename FuncT>
+bool parallel_for_each_k_partition(::std::size_t n, ::std::size_t k, FuncT f, ::std::size_t num_threads = 0)
+{
+	const lexicographic_k_partition gen(n, k);
+
+	return detail::run_rank_ranges(detail::generator_range_task<lexicographic_k_partition,FuncT>(gen, f), gen.count(), num_threads);
+}
+
+/**
+ * \brief Parallel version of \c for_each_combination.
+ *
+ * Each thread works on its own copy of the elements in [\a first, \a last)
+ * and calls its own copy of \a f as <tt>f(b, m)</tt>, where [\c b, \c m) is
+ * the current combination of <tt>distance(first, mid)</tt> elements.
+ * Like for \c for_each_combination, combinations are visited in
+ * lexicographic order (see \c rank_combination), but only within each of
+ * the contiguous ranges of ranks assigned to threads.
+ * The elements in [\c m, \c e) are the ones not in the combination, in their
+ * original order.
+ * The input range is not modified.
+ *
+ * \return \c true if the enumeration has been stopped by \a f.
+ *
+ * \sa parallel_for_each_subset
+ */
+template <typename BidirIter, typename FuncT>
+bool parallel_for_each_combination(BidirIter first, BidirIter mid, BidirIter last, FuncT f, ::std::size_t num_threads = 0)
+{
+	typedef typename ::std::iterator_traits<BidirIter>::value_type value_type;
+
+	const ::std::vector<value_type> elems(first, last);
+	const ::std::size_t k(::std::distance(first, mid));
+
+	return detail::run_rank_ranges(detail::combination_range_task<value_type,FuncT>(elems, k, f), count_each_combination(first, mid, last), num_threads);
+}
+
+/**
+ * \brief Parallel version of \c for_each_permutation.
+ *
+ * Like parallel_for_each_combination, but for the permutations of
+ * <tt>distance(first, mid)</tt> elements.
+ * Unlike \c for_each_permutation, permutations are visited in lexicographic
+ * order (see \c rank_permutation) within each range of ranks.
+ * The elements in [\c m, \c e) are the ones not in the permutation, in their
+ * original order.
+ *
+ * \return \c true if the enumeration has been stopped by \a f.
+ *
+ * \sa parallel_for_each_subset
+ */
+template <typename BidirIter, typename FuncT>
+bool parallel_for_each_permutation(BidirIter first, BidirIter mid, BidirIter last, FuncT f, ::std::size_t num_threads = 0)
+{
+	typedef typename ::std::iterator_traits<BidirIter>::value_type value_type;
+
+	const ::std::vector<value_type> elems(first, last);
+	const ::std::size_t k(::std::distance(first, mid));
+
+	return detail::run_rank_ranges(detail::permutation_range_task<value_type,FuncT>(elems, k, f), count_each_permutation(first, mid, last), num_threads);
+}
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_PARALLEL_COMBINATORICS_HPP
@@ -0,0 +1,374 @@
+/**
+ * \file dcs/algorithm/parallel_order.hpp
+ *
+ * \brief Computes the ordering permutation of a range with several threads.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_PARALLEL_ORDER_HPP
+#define DCS_ALGORITHM_PARALLEL_ORDER_HPP
+
+
+#include <algorithm>
+#include <boost/exception_ptr.hpp>
+#include <boost/thread.hpp>
+#include <cstddef>
+#include <dcs/algorithm/order.hpp>
+#include <iterator>
+#include <vector>
+
+
+namespace dcs { namespace algorithm {
+
+namespace detail {
+
+/// Below this size, ordering is done by the calling thread only.
+static const ::std::size_t parallel_order_threshold = 1 << 16;
+
+/// Minimum number of elements sorted by each thread.
+static const ::std::size_t parallel_order_min_chunk = 1 << 14;
+
+/**
+ * \brief Number of elements taken from \a a in the first \a k elements of the
+ *  stable merge of the sorted ranges \a a and \a b.
+ *
+ * This is the position where the merge can be split, so that the parts of
+ * the output are merged independently (the so-called "merge path").
+ */
+template <typename ItemT, typename LessT>
+::std::size_t merge_split(ItemT const* a, ::std::size_t na, ItemT const* b, ::std::size_t nb, ::std::size_t k, LessT less)
+{
+	::std::size_t lo(k > nb ? k-nb : 0);
+	::std::size_t hi(::std::min(k, na));
+
+	// Find the smallest i such that a[i] does not go before b[k-i-1]; on
+	// ties, elements of a go first
+	while (lo < hi)
+	{
+		const ::std::size_t i(lo+(hi-lo)/2);
+		if (!less(b[k-i-1], a[i]))
+		{
+			lo = i+1;
+		}
+		else
+		{
+			hi = i;
+		}
+	}
+
+	return lo;
+}
+
+/// Fills and sorts the items of a chunk of elements.
+template <typename PolicyT>
+struct order_chunk_task
+{
+	typedef typename PolicyT::item_type item_type;
+	typedef typename PolicyT::index_type index_type;
+
+	void operator()()
+	{
+		try
+		{
+			for (::std::size_t i = first; i < last; ++i)
+			{
+				items[i] = p_policy->item(static_cast<index_type>(i));
+			}
+			p_policy->sort(items+first, items+last);
+		}
+		catch (...)
+		{
+			*p_exc = ::boost::current_exception();
+		}
+	}
+
+	PolicyT const* p_policy;
+	item_type* items;
+	::std::size_t first;
+	::std::size_t last;
+	::boost::exception_ptr* p_exc;
+}; // order_chunk_task
+
+/**
+ * \brief Writes the part [\a first, \a last) of the output of a round of
+ *  pairwise merges of sorted runs.
+ *
+ * Run \f$r\f$ is [\c bounds[r], \c bounds[r+1]); runs \f$2j\f$ and
+ * \f$2j+1\f$ are merged in place in \c dst, and a last unpaired run is
+ * copied.
+ */
+template <typename ItemT, typename LessT>
+struct order_merge_task
+{
+	order_merge_task(ItemT const* src,
+					 ItemT* dst,
+					 ::std::size_t const* bounds,
+					 ::std::size_t num_runs,
+					 LessT less,
+					 ::std::size_t first,
+					 ::std::size_t last)
+	: src(src),
+	  dst(dst),
+	  bounds(bounds),
+	  num_runs(num_runs),
+	  less(less),
+	  first(first),
+	  last(last),
+	  p_exc(0)
+	{
+	}
+
+	void operator()()
+	{
+		try
+		{
+			for (::std::size_t r = 0; r < num_runs; r += 2)
+			{
+				const ::std::size_t b0(bounds[r]);
+				const ::std::size_t b1(bounds[::std::min(r+1, num_runs)]);
+				const ::std::size_t b2(bounds[::std::min(r+2, num_runs)]);
+				const ::std::size_t lo(::std::max(first, b0));
+				const ::std::size_t hi(::std::min(last, b2));
+
+				if (lo >= hi)
+				{
+					continue;
+				}
+
+				ItemT const* a(src+b0);
+				ItemT const* b(src+b1);
+				const ::std::size_t na(b1-b0);
+				const ::std::size_t nb(b2-b1);
+				const ::std::size_t i0(merge_split(a, na, b, nb, lo-b0, less));
+				const ::std::size_t i1(merge_split(a, na, b, nb, hi-b0, less));
+
+				::std::merge(a+i0, a+i1, b+(lo-b0-i0), b+(hi-b0-i1), dst+lo, less);
+			}
+		}
+		catch (...)
+		{
+			*p_exc = ::boost::current_exception();
+		}
+	}
+
+	ItemT const* src;
+	ItemT* dst;
+	::std::size_t const* bounds;
+	::std::size_t num_runs;
+	LessT less;
+	::std::size_t first;
+	::std::size_t last;
+	::boost::exception_ptr* p_exc;
+}; // order_merge_task
+
+/**
+ * \brief Runs each task in a separate thread, but the last one that is run
+ *  by the calling thread, and rethrows the first exception, if any.
+ */
+template <typename TaskT>
+void run_order_tasks(::std::vector<TaskT>& tasks, ::std::vector< ::boost::exception_ptr >& excs)
+{
+	const ::std::size_t nt(tasks.size());
+
+	::boost::thread_group workers;
+	for (::std::size_t t = 0; t < nt; ++t)
+	{
+		tasks[t].p_exc = &excs[t];
+		if ((t+1) < nt)
+		{
+			workers.create_thread(tasks[t]);
+		}
+		else
+		{
+			tasks[t]();
+		}
+	}
+	workers.join_all();
+
+	for (::std::size_t t = 0; t < nt; ++t)
+	{
+		if (excs[t])
+		{
+			::boost::rethrow_exception(excs[t]);
+		}
+	}
+}
+
+/**
+ * \brief Sorts the items of \a n elements with the given policy by a
+ *  parallel merge sort.
+ *
+ * Each thread sorts a chunk of items; then, sorted runs are merged pairwise
+ * until one is left.
+ * In each round of merges, the output is split evenly among threads by
+ * \c merge_split, so that all threads are busy until the last merge.
+ */
+struct parallel_order_driver
+{
+	explicit parallel_order_driver(::std::size_t num_threads)
+	: num_threads_(num_threads)
+	{
+	}
+
+	template <typename PolicyT, typename ForwardIteratorT>
+	void operator()(PolicyT const& policy, ::std::size_t n, ForwardIteratorT result) const
+	{
+		typedef typename PolicyT::item_type item_type;
+		typedef typename PolicyT::item_less item_less;
+
+		const ::std::size_t nt(::std::max(::std::size_t(1), ::std::min(num_threads_, n/parallel_order_min_chunk)));
+
+		if (nt == 1)
+		{
+			serial_order_driver()(policy, n, result);
+			return;
+		}
+
+		::std::vector<item_type> items(n);
+		::std::vector<item_type> buf(n);
+		::std::vector< ::boost::exception_ptr > excs(nt);
+
+		::std::vector< ::std::size_t > bounds(nt+1);
+		for (::std::size_t t = 0; t <= nt; ++t)
+		{
+			bounds[t] = n/nt*t + ::std::min(t, n%nt);
+		}
+
+		::std::vector< order_chunk_task<PolicyT> > sorts(nt);
+		for (::std::size_t t = 0; t < nt; ++t)
+		{
+			sorts[t].p_policy = &policy;
+			sorts[t].items = &items[0];
+			sorts[t].first = bounds[t];
+			sorts[t].last = bounds[t+1];
+		}
+		run_order_tasks(sorts, excs);
+
+		item_type* src(&items[0]);
+		item_type* dst(&buf[0]);
+		::std::size_t num_runs(nt);
+		::std::vector< order_merge_task<item_type,item_less> > merges;
+		merges.reserve(nt);
+		while (num_runs > 1)
+		{
+			merges.clear();
+			for (::std::size_t t = 0; t < nt; ++t)
+			{
+				merges.push_back(order_merge_task<item_type,item_less>(src,
+																		dst,
+																		&bounds[0],
+																		num_runs,
+																		policy.less(),
+																		n/nt*t + ::std::min(t, n%nt),
+																		n/nt*(t+1) + ::std::min(t+1, n%nt)));
+			}
+			run_order_tasks(merges, excs);
+
+			// Merged runs start at every other bound
+			::std::size_t r(0);
+			for (::std::size_t i = 0; i < num_runs; i += 2)
+			{
+				bounds[r++] = bounds[i];
+			}
+			bounds[r] = n;
+			num_runs = r;
+
+			::std::swap(src, dst);
+		}
+
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			*result = policy.index(src[i]);
+			++result;
+		}
+	}
+
+	::std::size_t num_threads_;
+};
+
+/// The given number of threads or, if zero, the number of hardware threads.
+inline
+::std::size_t parallel_order_num_threads(::std::size_t num_threads)
+{
+	if (num_threads == 0)
+	{
+		num_threads = ::boost::thread::hardware_concurrency();
+	}
+	return ::std::max(::std::size_t(1), num_threads);
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Computes the permutation of indices which makes the given range
+ *  ordered, using up to \a num_threads threads.
+ *
+ * The elements are split into one chunk per thread, each one ordered by the
+ * same algorithm as \c order would choose for the whole range, and chunks are
+ * then merged in parallel.
+ * As for \c order, the relative order of the indices of equivalent elements
+ * is unspecified, unless elements are radix sorted.
+ * Ranges shorter than a few tens of thousands of elements are ordered by the
+ * calling thread only.
+ *
+ * If \a num_threads is zero, the number of hardware threads is used.
+ */
+template <typename RandomAccessIteratorT, typename ForwardIteratorT>
+void parallel_order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result, ::std::size_t num_threads = 0)
+{
+	const ::std::size_t n(last-first);
+
+	if (n < detail::parallel_order_threshold)
+	{
+		order(first, last, result);
+	}
+	else
+	{
+		detail::dispatch_order(first, n, result, detail::parallel_order_driver(detail::parallel_order_num_threads(num_threads)));
+	}
+}
+
+/**
+ * \brief Computes the permutation of indices which makes the given range
+ *  ordered according to the given comparator, using up to \a num_threads
+ *  threads.
+ *
+ * See the other overload.
+ */
+template <typename RandomAccessIteratorT, typename ForwardIteratorT, typename ComparatorT>
+void parallel_order(RandomAccessIteratorT first, RandomAccessIteratorT last, ForwardIteratorT result, ComparatorT comp, ::std::size_t num_threads)
+{
+	const ::std::size_t n(last-first);
+
+	if (n < detail::parallel_order_threshold)
+	{
+		order(first, last, result, comp);
+	}
+	else
+	{
+		detail::dispatch_order(first, n, result, comp, detail::parallel_order_driver(detail::parallel_order_num_threads(num_threads)));
+	}
+}
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_PARALLEL_ORDER_HPP
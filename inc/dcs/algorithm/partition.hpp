@@ -41,11 +41,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <dcs/algorithm/prefix_visit.hpp>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/detail/macro_cx11.hpp>
 #include <dcs/exception.hpp>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -64,6 +67,104 @@ struct partition_traits
 	typedef typename subset_container::const_iterator subset_const_iterator;
 };
 
+namespace detail {
+
+/**
+ * \brief Counts the completions of restricted growth strings (RGS).
+ *
+ * The entry at position \f$j(n+1)+m\f$ of the returned table is the number of
+ * ways to fill the last \f$j\f$ entries of an RGS of size \a n whose prefix
+ * has maximum \f$m\f$; if \a k is positive, only the RGSs with exactly \a k
+ * blocks are counted.
+ * Only the entries reachable from a valid prefix (i.e., \f$m<n-j\f$) are
+ * computed, so that none of them exceeds the total number of RGSs, which is
+ * the entry for \f$j=n-1\f$ and \f$m=0\f$.
+ */
+inline
+::std::vector< ::std::size_t > rgs_completion_counts(::std::size_t n, ::std::size_t k)
+{
+	const ::std::size_t w(n+1);
+	const ::std::size_t maxval(::std::numeric_limits< ::std::size_t >::max());
+
+	::std::vector< ::std::size_t > d(n*w, 0);
+
+	for (::std::size_t m = 0; m < n; ++m)
+	{
+		d[m] = (k == 0 || m == (k-1)) ? 1 : 0;
+	}
+	for (::std::size_t j = 1; j < n; ++j)
+	{
+		for (::std::size_t m = 0; m < (n-j); ++m)
+		{
+			// Either reuse one of the m+1 blocks or open a new block
+			const ::std::size_t reuse(d[(j-1)*w+m]);
+			const ::std::size_t open((k == 0 || (m+1) < k) ? d[(j-1)*w+m+1] : 0);
+
+			if (reuse > 0 && (m+1) > (maxval-open)/reuse)
+			{
+				DCS_EXCEPTION_THROW(::std::overflow_error,
+									"Number of partitions is too large");
+			}
+
+			d[j*w+m] = (m+1)*reuse+open;
+		}
+	}
+
+	return d;
+}
+
+/**
+ * \brief Rank of a restricted growth string (RGS) in lexicographic order.
+ *
+ * \a kappa is the RGS, \a M its prefix maxima and \a d the table returned by
+ * \c rgs_completion_counts.
+ * Since every value smaller than \f$\kappa_i\f$ at position \f$i\f$ leaves
+ * the prefix maximum \f$M_{i-1}\f$ unchanged, the rank is
+ * \f$\sum_{i=1}^{n-1} \kappa_i d(n-1-i,M_{i-1})\f$.
+ */
+inline
+::std::size_t rgs_rank(::std::vector< ::std::size_t > const& kappa,
+					   ::std::vector< ::std::size_t > const& M,
+					   ::std::vector< ::std::size_t > const& d)
+{
+	const ::std::size_t n(kappa.size());
+	const ::std::size_t w(n+1);
+
+	::std::size_t r(0);
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		r += kappa[i]*d[(n-1-i)*w+M[i-1]];
+	}
+
+	return r;
+}
+
+/// Restricted growth string (and its prefix maxima) of the given rank.
+inline
+void rgs_unrank(::std::size_t r,
+				::std::vector< ::std::size_t > const& d,
+				::std::vector< ::std::size_t >& kappa,
+				::std::vector< ::std::size_t >& M)
+{
+	const ::std::size_t n(kappa.size());
+	const ::std::size_t w(n+1);
+
+	kappa[0] = M[0] = 0;
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		const ::std::size_t m(M[i-1]);
+		const ::std::size_t c(d[(n-1-i)*w+m]);
+		const ::std::size_t v(c > 0 ? ::std::min(r/c, m+1) : (m+1));
+
+		r -= v*c;
+		kappa[i] = v;
+		M[i] = ::std::max(m, v);
+	}
+}
+
+} // Namespace detail
+
+
 class lexicographic_partition
 {
 	protected: typedef ::std::vector< ::std::size_t > restricted_growth_string_type;
@@ -133,6 +234,37 @@ class lexicographic_partition
 		return M_[n_-1]+1;
 	}
 
+	/// Returns the number of partitions (i.e., the Bell number).
+	public: ::std::size_t count() const
+	{
+		return detail::rgs_completion_counts(n_, 0)[(n_-1)*(n_+1)];
+	}
+
+	/// Returns the position of the current partition in lexicographic order.
+	public: ::std::size_t rank() const
+	{
+		return detail::rgs_rank(kappa_, M_, detail::rgs_completion_counts(n_, 0));
+	}
+
+	/// Moves to the partition at the given position in lexicographic order.
+	public: self_type& unrank(::std::size_t r)
+	{
+		const ::std::vector< ::std::size_t > d(detail::rgs_completion_counts(n_, 0));
+
+		// pre: r < count()
+		DCS_ASSERT(r < d[(n_-1)*(n_+1)],
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Rank is out of range"));
+
+		detail::rgs_unrank(r, d, kappa_, M_);
+		has_prev_ = r > 0;
+		has_next_ = true;
+
+		DCS_DEBUG_DO( this->integrity_check() );
+
+		return *this;
+	}
+
 	public: self_type& operator++()
 	{
 		DCS_ASSERT(has_next_,
@@ -731,6 +863,37 @@ class lexicographic_k_partition
 		return k_;
 	}
 
+	/// Returns the number of partitions (i.e., the Stirling number of the second kind).
+	public: ::std::size_t count() const
+	{
+		return detail::rgs_completion_counts(n_, k_)[(n_-1)*(n_+1)];
+	}
+
+	/// Returns the position of the current partition in lexicographic order.
+	public: ::std::size_t rank() const
+	{
+		return detail::rgs_rank(kappa_, M_, detail::rgs_completion_counts(n_, k_));
+	}
+
+	/// Moves to the partition at the given position in lexicographic order.
+	public: self_type& unrank(::std::size_t r)
+	{
+		const ::std::vector< ::std::size_t > d(detail::rgs_completion_counts(n_, k_));
+
+		// pre: r < count()
+		DCS_ASSERT(r < d[(n_-1)*(n_+1)],
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Rank is out of range"));
+
+		detail::rgs_unrank(r, d, kappa_, M_);
+		has_prev_ = r > 0;
+		has_next_ = true;
+
+		DCS_DEBUG_DO( this->integrity_check() );
+
+		return *this;
+	}
+
 	public: self_type& operator++()
 	{
 		DCS_ASSERT(has_next_,
@@ -948,6 +1111,229 @@ template <typename CharT, typename CharTraitsT>
 	return os;
 }
 
+/**
+ * \brief Class to generate all partitions of a set by moving one element at
+ *  a time
+ *
+ * Partitions are represented by restricted growth strings (RGS) as in
+ * lexicographic_partition, but are generated in a reflected (Gray code)
+ * order: each step moves one element (see moved_element()) to the subset
+ * following or preceding its current one (see from_subset() and
+ * to_subset()), so that a function of the partition can be updated
+ * incrementally rather than recomputed.
+ * For instance, for a set of 3 elements, the generated sequence is:
+ * <pre>
+ *  (0 0 0),
+ *  (0 0 1),
+ *  (0 1 2),
+ *  (0 1 1),
+ *  (0 1 0)
+ * </pre>
+ *
+ * Subsets are numbered by their smallest element, as in any RGS.
+ * Thus, when the moved element opens or closes a subset, the elements after it
+ * that are alone in their subset (and only those) get their subset number
+ * shifted by one, while they stay where they are (as in the step from
+ * <tt>(0 0 1)</tt> to <tt>(0 1 2)</tt> above).
+ *
+ * Generation only goes forward.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class gray_code_partition
+{
+	protected: typedef ::std::vector< ::std::size_t > restricted_growth_string_type;
+	public: typedef gray_code_partition self_type;
+	public: typedef restricted_growth_string_type::const_iterator const_iterator;
+
+
+	public: explicit gray_code_partition(::std::size_t n)
+	: n_(n),
+	  kappa_(n, 0),
+	  M_(n, 0),
+	  dir_(n, 1),
+	  moved_(0),
+	  from_(0),
+	  to_(0),
+	  has_next_(true)
+	{
+		DCS_ASSERT(n_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of elements must be positive"));
+	}
+
+	/// Moves to the first partition, i.e., the one with a single subset.
+	public: void reset()
+	{
+		::std::fill(kappa_.begin(), kappa_.end(), 0);
+		::std::fill(M_.begin(), M_.end(), 0);
+		::std::fill(dir_.begin(), dir_.end(), 1);
+		has_next_ = true;
+	}
+
+	public: ::std::size_t num_elements() const
+	{
+		return n_;
+	}
+
+	public: ::std::size_t num_subsets() const
+	{
+		return M_[n_-1]+1;
+	}
+
+	/// Returns the number of partitions (i.e., the Bell number).
+	public: ::std::size_t count() const
+	{
+		return detail::rgs_completion_counts(n_, 0)[(n_-1)*(n_+1)];
+	}
+
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following partitions"));
+
+		has_next_ = false;
+
+		// Move the last element that can still go in its direction; the
+		// following ones, which are all at one end of their range, reverse
+		// their direction.
+		for (::std::size_t i = n_-1; i > 0; --i)
+		{
+			const bool up = dir_[i] > 0;
+
+			if (up ? (kappa_[i] <= M_[i-1]) : (kappa_[i] > 0))
+			{
+				from_ = kappa_[i];
+				kappa_[i] = up ? (from_+1) : (from_-1);
+				to_ = kappa_[i];
+				moved_ = i;
+				M_[i] = ::std::max(M_[i-1], kappa_[i]);
+
+				for (::std::size_t j = i+1; j < n_; ++j)
+				{
+					dir_[j] = -dir_[j];
+					if (kappa_[j] != 0)
+					{
+						// Still alone in its subset
+						kappa_[j] = M_[j-1]+1;
+					}
+					M_[j] = ::std::max(M_[j-1], kappa_[j]);
+				}
+
+				DCS_DEBUG_DO( this->integrity_check() );
+
+				has_next_ = true;
+				break;
+			}
+		}
+
+		return *this;
+	}
+
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
+
+	/**
+	 * \brief Returns the element moved by the last step.
+	 *
+	 * \pre At least one step has been taken.
+	 */
+	public: ::std::size_t moved_element() const
+	{
+		return moved_;
+	}
+
+	/// Returns the subset which moved_element() was in before the last step.
+	public: ::std::size_t from_subset() const
+	{
+		return from_;
+	}
+
+	/// Returns the subset which moved_element() is in after the last step.
+	public: ::std::size_t to_subset() const
+	{
+		return to_;
+	}
+
+	public: template <typename ElemT>
+			typename partition_traits<ElemT>::subset_container operator()(::std::vector<ElemT> const& v) const
+	{
+		DCS_ASSERT(v.size() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size does not match"));
+
+		typename partition_traits<ElemT>::subset_container subs(this->num_subsets());
+
+		for (::std::size_t i = 0; i < n_; ++i)
+		{
+			subs[kappa_[i]].push_back(v[i]);
+		}
+
+		return subs;
+	}
+
+	public: const_iterator begin() const
+	{
+		return kappa_.begin();
+	}
+
+	public: const_iterator end() const
+	{
+		return kappa_.end();
+	}
+
+	protected: void integrity_check() const
+	{
+		::std::size_t max = kappa_[0];
+
+		for (::std::size_t i = 0; i < n_; ++i)
+		{
+			if (kappa_[i] > (max+1))
+			{
+				DCS_EXCEPTION_THROW(::std::domain_error, "Integrity check#1 failed");
+			}
+
+			max = ::std::max(max,kappa_[i]);
+
+			if (max != M_[i])
+			{
+				DCS_EXCEPTION_THROW(::std::domain_error, "Integrity check#2 failed");
+			}
+		}
+	}
+
+
+	private: ::std::size_t n_;
+	private: restricted_growth_string_type kappa_;
+	private: restricted_growth_string_type M_;
+	private: ::std::vector<int> dir_; ///< The direction (+1 or -1) where each element moves
+	private: ::std::size_t moved_; ///< The element moved by the last step
+	private: ::std::size_t from_; ///< The subset of the moved element before the last step
+	private: ::std::size_t to_; ///< The subset of the moved element after the last step
+	private: bool has_next_;
+}; // gray_code_partition
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os,
+													gray_code_partition const& part)
+{
+	os << '(';
+
+	if (part.num_elements() > 1)
+	{
+		::std::copy(part.begin(),
+					part.end()-1,
+					::std::ostream_iterator< ::std::size_t >(os, " "));
+	}
+
+	os << *(part.end()-1) << ')';
+
+	return os;
+}
+
 template <typename BidiIterT, typename PartitionT>
 inline
 typename partition_traits< typename ::std::iterator_traits<BidiIterT>::value_type >::subset_container
@@ -988,6 +1374,143 @@ prev_partition(BidiIterT first,
 	return subs;
 }
 
+/// Number of partitions of a set of size \a n (i.e., the Bell number).
+inline
+::std::size_t count_each_partition(::std::size_t n)
+{
+	return n > 0 ? detail::rgs_completion_counts(n, 0)[(n-1)*(n+1)] : 1;
+}
+
+/**
+ * \brief Number of partitions of a set of size \a n into exactly \a k
+ *  subsets (i.e., the Stirling number of the second kind).
+ */
+inline
+::std::size_t count_each_k_partition(::std::size_t n, ::std::size_t k)
+{
+	if (k == 0 || k > n)
+	{
+		return (n == 0 && k == 0) ? 1 : 0;
+	}
+
+	return detail::rgs_completion_counts(n, k)[(n-1)*(n+1)];
+}
+
+namespace detail {
+
+/**
+ * \brief Visits the extensions of the first \a m entries of the restricted
+ *  growth string \a kappa, which use \a nb subsets.
+ *
+ * If \a k is positive, only the prefixes that can still be completed to
+ * exactly \a k subsets are generated.
+ *
+ * \return \c true if the visitor has stopped the enumeration.
+ */
+template <typename Function>
+bool partition_prefix(::std::vector< ::std::size_t >& kappa,
+					  ::std::size_t m,
+					  ::std::size_t nb,
+					  ::std::size_t k,
+					  Function& f)
+{
+	typedef ::std::vector< ::std::size_t >::const_iterator iterator;
+
+	const ::std::size_t n(kappa.size());
+
+	// The element at position m either joins one of the nb subsets or opens
+	// a new one, unless all the k subsets are already open or each of the
+	// remaining elements must open a new subset
+	const ::std::size_t lo((k > 0 && (nb+n-m) == k) ? nb : 0);
+	const ::std::size_t hi((k > 0 && nb == k) ? (nb-1) : nb);
+
+	for (::std::size_t v = lo; v <= hi; ++v)
+	{
+		const ::std::size_t next_nb(v < nb ? nb : (nb+1));
+
+		kappa[m] = v;
+
+		iterator first(kappa.begin());
+		const prefix_visit_action action(f(first, first+m+1, next_nb));
+		if (action == stop_prefix_visit_action)
+		{
+			return true;
+		}
+		if (action == descend_prefix_visit_action
+			&& (m+1) < n
+			&& partition_prefix(kappa, m+1, next_nb, k, f))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // Namespace detail
+
+/**
+ * \brief Visits the prefixes of the partitions of a set of size \a n, with
+ *  pruning.
+ *
+ * Partitions are represented as restricted growth strings (see
+ * \c lexicographic_partition) and are built in lexicographic order, one
+ * element at a time.
+ * For each prefix of size \f$1,\ldots,n\f$, the visitor is called as
+ * \c f(first,last,num_subsets), where [\a first, \a last) holds the subset
+ * of each of the first elements and \c num_subsets is the number of subsets
+ * they use, and returns a \c prefix_visit_action, so that the partitions
+ * starting with a prefix that cannot lead to an acceptable solution are
+ * skipped as a whole.
+ * The prefix is complete when its size is \a n; if the visitor never skips,
+ * exactly \c count_each_partition(n) complete prefixes are visited.
+ * If \a n is zero, the visitor is called once with an empty prefix.
+ */
+template <typename Function>
+Function for_each_partition_prefix(::std::size_t n, Function f)
+{
+	::std::vector< ::std::size_t > kappa(n, 0);
+
+	if (n == 0)
+	{
+		const ::std::vector< ::std::size_t >::const_iterator first(kappa.begin());
+		f(first, first, ::std::size_t(0));
+	}
+	else
+	{
+		detail::partition_prefix(kappa, 0, 0, 0, f);
+	}
+
+	return DCS_DETAIL_MACRO_CX11_STD_MOVE_(f);
+}
+
+/**
+ * \brief Visits the prefixes of the partitions of a set of size \a n into
+ *  exactly \a k subsets, with pruning.
+ *
+ * Like \c for_each_partition_prefix, but only the prefixes that can be
+ * completed to a partition with \a k subsets are visited; if the visitor
+ * never skips, exactly \c count_each_k_partition(n,k) complete prefixes are
+ * visited.
+ */
+template <typename Function>
+Function for_each_k_partition_prefix(::std::size_t n, ::std::size_t k, Function f)
+{
+	::std::vector< ::std::size_t > kappa(n, 0);
+
+	if (n == 0 && k == 0)
+	{
+		const ::std::vector< ::std::size_t >::const_iterator first(kappa.begin());
+		f(first, first, ::std::size_t(0));
+	}
+	else if (k > 0 && k <= n)
+	{
+		detail::partition_prefix(kappa, 0, 0, k, f);
+	}
+
+	return DCS_DETAIL_MACRO_CX11_STD_MOVE_(f);
+}
+
 }} // Namespace dcs::algorithm
 
 #endif // DCS_COMMONS_ALGORITHM_PARTITION_HPP
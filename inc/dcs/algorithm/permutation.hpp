@@ -53,10 +53,15 @@
 #include <algorithm>
 #include <cstddef>
 #include <dcs/algorithm/detail/combperm.hpp>
+#include <dcs/algorithm/prefix_visit.hpp>
+#include <dcs/assert.hpp>
 #include <dcs/detail/macro_cx11.hpp>
+#include <dcs/exception.hpp>
 #include <stdexcept>
 #include <iterator>
 #include <limits>
+#include <utility>
+#include <vector>
 
 
 namespace dcs { namespace algorithm {
@@ -120,6 +125,182 @@ inline
 												   ::std::distance(mid, last));
 }
 
+namespace detail {
+
+/**
+ * \brief Visits the extensions of the prefix [\a first, \a pos) by \a k more
+ *  elements taken from [\a pos, \a last), in lexicographic order.
+ *
+ * The elements in [\a pos, \a last) are kept in their original order: after
+ * the \f$j\f$-th candidate has been visited, it is at \a pos and the
+ * \f$j\f$ smaller ones follow it, so that swapping \a pos with the next
+ * position brings the \f$(j+1)\f$-th candidate in front of the others still
+ * in order.
+ * A final rotation restores the range on return.
+ *
+ * \return \c true if the visitor has stopped the enumeration.
+ */
+template <typename BidirIter, typename Function>
+bool permute_prefix(BidirIter first,
+					BidirIter pos,
+					BidirIter last,
+					typename ::std::iterator_traits<BidirIter>::difference_type k,
+					Function& f)
+{
+	BidirIter next_pos(pos);
+	++next_pos;
+
+	bool stop(false);
+	BidirIter it(pos);
+	for (; it != last && !stop; ++it)
+	{
+		if (it != pos)
+		{
+			::std::iter_swap(pos, it);
+		}
+
+		const prefix_visit_action action(f(first, next_pos));
+		stop = action == stop_prefix_visit_action;
+		if (!stop && action == descend_prefix_visit_action && k > 1)
+		{
+			stop = permute_prefix(first, next_pos, last, k-1, f);
+		}
+	}
+
+	// Here, 'it' is past the last visited candidate
+	::std::rotate(pos, next_pos, it);
+
+	return stop;
+}
+
+} // Namespace detail
+
+/**
+ * \brief Visits the prefixes of the permutations of [\a first, \a last) of
+ *  size \c distance(first,mid), with pruning.
+ *
+ * Permutations are built in the lexicographic order of their positions (the
+ * order of \c rank_permutation), one element at a time.
+ * For each prefix of size \f$1,\ldots,r\f$, the visitor is called as
+ * \c f(first,pos), where the prefix is in [\a first, \a pos), and returns a
+ * \c prefix_visit_action, so that the permutations starting with a prefix
+ * that cannot lead to an acceptable solution are skipped as a whole.
+ * The prefix is complete when \c pos is equal to \a mid; if the visitor never
+ * skips, exactly \c count_each_permutation(first,mid,last) complete prefixes
+ * are visited.
+ * If \f$r=0\f$, the visitor is called once with an empty prefix.
+ *
+ * On return, the range is in its original order.
+ */
+template <typename BidirIter, typename Function>
+Function for_each_permutation_prefix(BidirIter first,
+									 BidirIter mid,
+									 BidirIter last,
+									 Function f)
+{
+	if (first == mid)
+	{
+		f(first, mid);
+	}
+	else
+	{
+		detail::permute_prefix(first, first, last, ::std::distance(first, mid), f);
+	}
+
+	return DCS_DETAIL_MACRO_CX11_STD_MOVE_(f);
+}
+
+/**
+ * \brief Rank of a permutation in the lexicographic order of its positions.
+ *
+ * The permutation is given by the (distinct) positions in
+ * [\a first, \a last) among the \a n positions of the total range.
+ * Permutations are ranked as numbers in a mixed-radix system, whose
+ * \f$i\f$-th digit is the number of unused positions smaller than the
+ * \f$i\f$-th one, so that, for instance, the positions <tt>(0 1)</tt>,
+ * <tt>(0 2)</tt>, <tt>(1 0)</tt>, <tt>(1 2)</tt>, <tt>(2 0)</tt>,
+ * <tt>(2 1)</tt> of 3 elements have rank 0 to 5.
+ *
+ * Note that this is \e not the order in which \c for_each_permutation visits
+ * permutations.
+ */
+template <typename InIterT>
+::std::size_t rank_permutation(InIterT first, InIterT last, ::std::size_t n)
+{
+	const ::std::size_t r(::std::distance(first, last));
+
+	// pre: r <= n
+	DCS_ASSERT(r <= n,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Size of permutation is out of range"));
+
+	::std::vector<bool> used(n, false);
+	::std::size_t rank(0);
+	for (::std::size_t i = 0; first != last; ++first, ++i)
+	{
+		const ::std::size_t p(*first);
+
+		// pre: positions are distinct and in range
+		DCS_ASSERT(p < n && !used[p],
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Position is out of range or repeated"));
+
+		::std::size_t d(0);
+		for (::std::size_t j = 0; j < p; ++j)
+		{
+			if (!used[j])
+			{
+				++d;
+			}
+		}
+		used[p] = true;
+
+		// The radix of the i-th digit is (n-i), thus its weight is the
+		// number of permutations of size r-i-1 out of n-i-1
+		rank += d*count_each_permutation< ::std::size_t >(r-i-1, n-r);
+	}
+
+	return rank;
+}
+
+/**
+ * \brief Permutation (as positions) of the given lexicographic rank.
+ *
+ * Writes to \a out the \a r positions, among \a n, of the permutation whose
+ * rank (see \c rank_permutation) is \a rank.
+ */
+template <typename OutIterT>
+OutIterT unrank_permutation(::std::size_t rank, ::std::size_t n, ::std::size_t r, OutIterT out)
+{
+	// pre: r <= n
+	DCS_ASSERT(r <= n,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Size of permutation is out of range"));
+	// pre: rank < count
+	DCS_ASSERT(rank < count_each_permutation< ::std::size_t >(r, n-r),
+			   DCS_EXCEPTION_THROW(::std::out_of_range,
+								   "Rank is out of range"));
+
+	::std::vector< ::std::size_t > unused(n);
+	for (::std::size_t j = 0; j < n; ++j)
+	{
+		unused[j] = j;
+	}
+
+	for (::std::size_t i = 0; i < r; ++i)
+	{
+		const ::std::size_t w(count_each_permutation< ::std::size_t >(r-i-1, n-r));
+		const ::std::size_t d(rank/w);
+
+		rank -= d*w;
+		*out = unused[d];
+		++out;
+		unused.erase(unused.begin()+d);
+	}
+
+	return out;
+}
+
 template <typename BidirIter, typename Function>
 inline
 Function for_each_circular_permutation(BidirIter first,
@@ -341,6 +522,287 @@ bool prev_partial_permutation(BidiIteratorT first,
 	return result;
 }
 
+namespace detail {
+
+/// Common part of the permutation generators where consecutive permutations
+/// differ by a swap.
+template <typename DerivedT>
+class swap_permutation_generator
+{
+	public: typedef ::std::vector< ::std::size_t >::const_iterator const_iterator;
+
+
+	protected: explicit swap_permutation_generator(::std::size_t n)
+	: perm_(n),
+	  swapped_(0, 0),
+	  has_next_(true)
+	{
+		DCS_ASSERT(n > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of elements must be positive"));
+
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			perm_[i] = i;
+		}
+	}
+
+	public: ::std::size_t num_elements() const
+	{
+		return perm_.size();
+	}
+
+	/// Returns the number of permutations, i.e., \f$n!\f$.
+	public: ::std::size_t count() const
+	{
+		return count_each_permutation< ::std::size_t >(perm_.size(), 0);
+	}
+
+	public: DerivedT& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following permutations"));
+
+		DerivedT& self = static_cast<DerivedT&>(*this);
+
+		has_next_ = self.step();
+
+		if (has_next_)
+		{
+			::std::swap(perm_[swapped_.first], perm_[swapped_.second]);
+		}
+
+		return self;
+	}
+
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
+
+	/**
+	 * \brief Returns the (increasing) positions swapped by the last step.
+	 *
+	 * Applying the same swap to a user array keeps it in sync with the
+	 * generator, and lets a function of the permutation be updated
+	 * incrementally rather than recomputed.
+	 *
+	 * \pre At least one step has been taken.
+	 */
+	public: ::std::pair< ::std::size_t, ::std::size_t > swapped() const
+	{
+		return swapped_;
+	}
+
+	/// Returns an iterator to the first element of the current permutation
+	/// of {0,1,...,n-1}.
+	public: const_iterator begin() const
+	{
+		return perm_.begin();
+	}
+
+	public: const_iterator end() const
+	{
+		return perm_.end();
+	}
+
+	/// Returns the elements of \a v in the order of the current permutation.
+	public: template <typename ElemT>
+			::std::vector<ElemT> operator()(::std::vector<ElemT> const& v) const
+	{
+		DCS_ASSERT(v.size() == perm_.size(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size does not match"));
+
+		::std::vector<ElemT> res;
+
+		res.reserve(perm_.size());
+		for (::std::size_t i = 0; i < perm_.size(); ++i)
+		{
+			res.push_back(v[perm_[i]]);
+		}
+
+		return res;
+	}
+
+	/// Records the swap of positions \a i and \a j for the current step.
+	protected: void swap_positions(::std::size_t i, ::std::size_t j)
+	{
+		swapped_.first = ::std::min(i, j);
+		swapped_.second = ::std::max(i, j);
+	}
+
+	protected: void restart()
+	{
+		for (::std::size_t i = 0; i < perm_.size(); ++i)
+		{
+			perm_[i] = i;
+		}
+		has_next_ = true;
+	}
+
+
+	private: ::std::vector< ::std::size_t > perm_; ///< The current permutation
+	private: ::std::pair< ::std::size_t, ::std::size_t > swapped_; ///< The positions swapped by the last step
+	private: bool has_next_;
+}; // swap_permutation_generator
+
+} // Namespace detail
+
+/**
+ * \brief Class to generate all permutations by adjacent transpositions
+ *  (Steinhaus-Johnson-Trotter order, also known as plain changes)
+ *
+ * Each permutation of {0,1,...,n-1} is obtained from the previous one by
+ * swapping two adjacent positions (see swapped()).
+ * For instance, for 3 elements, the generated sequence is:
+ * <pre>
+ *  (0 1 2),
+ *  (0 2 1),
+ *  (2 0 1),
+ *  (2 1 0),
+ *  (1 2 0),
+ *  (1 0 2)
+ * </pre>
+ *
+ * Permutations are generated with Algorithm P in:
+ *   D. Knuth.
+ *   "The Art of Computer Programming, Volume 4A: Combinatorial Algorithms, Part 1,"
+ *   Addison-Wesley, 2011 (Section 7.2.1.2).
+ * .
+ * which takes amortized constant time per step.
+ * Generation only goes forward.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class plain_change_permutation: public detail::swap_permutation_generator<plain_change_permutation>
+{
+	friend class detail::swap_permutation_generator<plain_change_permutation>;
+
+	private: typedef detail::swap_permutation_generator<plain_change_permutation> base_type;
+
+
+	public: explicit plain_change_permutation(::std::size_t n)
+	: base_type(n),
+	  c_(n+1, 0),
+	  o_(n+1, 1)
+	{
+	}
+
+	/// Moves to the first permutation, i.e., the identity.
+	public: void reset()
+	{
+		::std::fill(c_.begin(), c_.end(), 0);
+		::std::fill(o_.begin(), o_.end(), 1);
+		this->restart();
+	}
+
+	/// Steps P3-P7 of Algorithm P (with 1-based indices).
+	private: bool step()
+	{
+		::std::ptrdiff_t j = this->num_elements();
+		::std::ptrdiff_t s = 0;
+
+		while (true)
+		{
+			const ::std::ptrdiff_t q = c_[j]+o_[j];
+
+			if (q == j)
+			{
+				if (j == 1)
+				{
+					return false;
+				}
+				++s;
+			}
+			if (q < 0 || q == j)
+			{
+				o_[j] = -o_[j];
+				--j;
+				continue;
+			}
+
+			this->swap_positions(j-c_[j]+s-1, j-q+s-1);
+			c_[j] = q;
+
+			return true;
+		}
+	}
+
+
+	private: ::std::vector< ::std::ptrdiff_t > c_; ///< The inversion counts
+	private: ::std::vector< ::std::ptrdiff_t > o_; ///< The directions
+}; // plain_change_permutation
+
+/**
+ * \brief Class to generate all permutations in the order of Heap's algorithm
+ *
+ * Each permutation of {0,1,...,n-1} is obtained from the previous one by a
+ * single (not necessarily adjacent) swap (see swapped()); unlike
+ * plain_change_permutation, most steps only touch the first few positions.
+ * For instance, for 3 elements, the generated sequence is:
+ * <pre>
+ *  (0 1 2),
+ *  (1 0 2),
+ *  (2 0 1),
+ *  (0 2 1),
+ *  (1 2 0),
+ *  (2 1 0)
+ * </pre>
+ *
+ * Generation only goes forward and takes amortized constant time per step.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class heap_permutation: public detail::swap_permutation_generator<heap_permutation>
+{
+	friend class detail::swap_permutation_generator<heap_permutation>;
+
+	private: typedef detail::swap_permutation_generator<heap_permutation> base_type;
+
+
+	public: explicit heap_permutation(::std::size_t n)
+	: base_type(n),
+	  c_(n, 0),
+	  i_(1)
+	{
+	}
+
+	/// Moves to the first permutation, i.e., the identity.
+	public: void reset()
+	{
+		::std::fill(c_.begin(), c_.end(), 0);
+		i_ = 1;
+		this->restart();
+	}
+
+	private: bool step()
+	{
+		const ::std::size_t n = this->num_elements();
+
+		while (i_ < n)
+		{
+			if (c_[i_] < i_)
+			{
+				this->swap_positions((i_ & 1) ? c_[i_] : 0, i_);
+				++c_[i_];
+				i_ = 1;
+				return true;
+			}
+			c_[i_] = 0;
+			++i_;
+		}
+
+		return false;
+	}
+
+
+	private: ::std::vector< ::std::size_t > c_; ///< The loop counters of the recursive formulation
+	private: ::std::size_t i_; ///< The current level
+}; // heap_permutation
+
+
 }} // Namespace dcs::algorithm
 
 
@@ -0,0 +1,53 @@
+/**
+ * \file dcs/algorithm/prefix_visit.hpp
+ *
+ * \brief Actions returned by visitors of partial combinatorial objects.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_PREFIX_VISIT_HPP
+#define DCS_ALGORITHM_PREFIX_VISIT_HPP
+
+
+namespace dcs { namespace algorithm {
+
+/**
+ * \brief What to do after a visitor has seen a prefix of a combinatorial
+ *  object.
+ *
+ * Prefix-aware enumerations (e.g., \c for_each_combination_prefix) visit the
+ * objects in lexicographic order as a search tree, where the children of a
+ * prefix are the prefixes extending it by one element.
+ * By returning \c skip_prefix_visit_action, the visitor prunes the whole
+ * subtree rooted at the current prefix (e.g., because a bound shows that no
+ * completion can beat the incumbent solution).
+ * For complete objects, skipping and descending are the same.
+ */
+enum prefix_visit_action
+{
+	descend_prefix_visit_action, ///< Visit the extensions of the current prefix
+	skip_prefix_visit_action, ///< Do not visit the extensions of the current prefix
+	stop_prefix_visit_action ///< Stop the enumeration
+};
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_PREFIX_VISIT_HPP
@@ -22,53 +22,497 @@
  * limitations under the License.
  */
 
+
 #ifndef DCS_ALGORITHM_REORDER_HPP
 #define DCS_ALGORITHM_REORDER_HPP
 
 
 #include <algorithm>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/detail/macro_cx11.hpp>
+#include <dcs/exception.hpp>
 #include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 
 namespace dcs { namespace algorithm {
 
-/**
- * \brief Applies the permutation of indices to the given sequence.
- */
+namespace detail {
+
+/// The number of indices a gather looks ahead to prefetch the source element.
+static const ::std::size_t reorder_prefetch_distance = 16;
+
+template <typename T>
+inline
+void reorder_prefetch(T const& x)
+{
+#if defined(__GNUC__)
+	__builtin_prefetch(&x);
+#else
+	(void) x;
+#endif // __GNUC__
+}
+
+template <typename IdxFwdIterT, typename InRAIterT, typename OutFwdIterT>
+void reorder_copy(IdxFwdIterT idx_first, IdxFwdIterT idx_last, InRAIterT in_first, OutFwdIterT out_first, ::std::random_access_iterator_tag)
+{
+	// The look-ahead iterator runs reorder_prefetch_distance indices ahead
+	// of idx_first, so that the source element is (hopefully) already in
+	// cache when it is copied.
+	IdxFwdIterT ahead(idx_first);
+	for (::std::size_t k = 0; k < reorder_prefetch_distance && ahead != idx_last; ++k)
+	{
+		++ahead;
+	}
+	while (ahead != idx_last)
+	{
+		reorder_prefetch(in_first[*ahead]);
+		*out_first = in_first[*idx_first];
+		++ahead;
+		++idx_first;
+		++out_first;
+	}
+	while (idx_first != idx_last)
+	{
+		*out_first = in_first[*idx_first];
+		++idx_first;
+		++out_first;
+	}
+}
+
 template <typename IdxFwdIterT, typename InFwdIterT, typename OutFwdIterT>
-void reorder_copy(IdxFwdIterT idx_first, IdxFwdIterT idx_last, InFwdIterT in_first, OutFwdIterT out_first)
+void reorder_copy(IdxFwdIterT idx_first, IdxFwdIterT idx_last, InFwdIterT in_first, OutFwdIterT out_first, ::std::forward_iterator_tag)
 {
+	// Iterators to the input elements are collected on demand, so that the
+	// input sequence is traversed only once.
+	::std::vector<InFwdIterT> its(1, in_first);
 	while (idx_first != idx_last)
 	{
-		InFwdIterT in_it(in_first);
-		::std::advance(in_it, *idx_first);
-		*out_first = *in_it;
+		const ::std::size_t k(*idx_first);
+		while (its.size() <= k)
+		{
+			its.push_back(DCS_DETAIL_MACRO_CX11_STD_NEXT_(its.back()));
+		}
+		*out_first = *its[k];
 		++idx_first;
 		++out_first;
 	}
 }
 
-template <typename IdxFwdIterT, typename InFwdIterT>
-void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, InFwdIterT in_first)
+/// Keeps track of visited positions by means of a bit vector.
+template <typename IdxRAIterT>
+class reorder_bit_marker
+{
+	public: reorder_bit_marker(IdxRAIterT idx, ::std::size_t n)
+	: idx_(idx),
+	  marks_(n, false)
+	{
+	}
+
+	public: bool visited(::std::size_t i) const
+	{
+		return marks_[i];
+	}
+
+	public: ::std::size_t index(::std::size_t i) const
+	{
+		return idx_[i];
+	}
+
+	public: ::std::size_t next(::std::size_t i)
+	{
+		marks_[i] = true;
+		return idx_[i];
+	}
+
+	public: void finish()
+	{
+	}
+
+
+	private: IdxRAIterT idx_;
+	private: ::std::vector<bool> marks_;
+}; // reorder_bit_marker
+
+/**
+ * Keeps track of visited positions by complementing the bits of their
+ * indices, which are restored by finish().
+ */
+template <typename IdxRAIterT>
+class reorder_index_marker
 {
-	typedef typename ::std::iterator_traits<InFwdIterT>::value_type value_type;
+	private: typedef typename ::std::iterator_traits<IdxRAIterT>::value_type index_type;
 
-	InFwdIterT in_last(in_first);
-	::std::advance(in_last, ::std::distance(idx_first, idx_last));
-	::std::vector<value_type> tmp(in_first, in_last);
-	::std::size_t i(0);
-	while (idx_first != idx_last)
+	BOOST_STATIC_ASSERT( ::std::numeric_limits<index_type>::is_integer );
+
+
+	public: reorder_index_marker(IdxRAIterT idx, ::std::size_t n)
+	: idx_(idx),
+	  n_(n)
+	{
+		// The complement of an index must not be a valid index
+		DCS_ASSERT(::std::numeric_limits<index_type>::is_signed
+				   || n <= static_cast< ::std::size_t >(::std::numeric_limits<index_type>::max()/2)+1,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Index type is too narrow to mark the sequence"));
+	}
+
+	public: bool visited(::std::size_t i) const
+	{
+		return static_cast< ::std::size_t >(idx_[i]) >= n_;
+	}
+
+	public: ::std::size_t index(::std::size_t i) const
+	{
+		return idx_[i];
+	}
+
+	public: ::std::size_t next(::std::size_t i)
+	{
+		const index_type k(idx_[i]);
+		idx_[i] = static_cast<index_type>(~k);
+		return k;
+	}
+
+	public: void finish()
+	{
+		for (::std::size_t i = 0; i < n_; ++i)
+		{
+			if (this->visited(i))
+			{
+				idx_[i] = static_cast<index_type>(~idx_[i]);
+			}
+		}
+	}
+
+
+	private: IdxRAIterT idx_;
+	private: ::std::size_t n_;
+}; // reorder_index_marker
+
+/// The element moved out of a sequence at the start of a cycle.
+template <typename RAIterT>
+class reorder_hole
+{
+	private: typedef typename ::std::iterator_traits<RAIterT>::value_type value_type;
+
+
+	public: reorder_hole(RAIterT first, ::std::size_t i)
+	: first_(first),
+	  tmp_(DCS_DETAIL_MACRO_CX11_STD_MOVE_(first[i]))
+	{
+	}
+
+	public: void move(::std::size_t to, ::std::size_t from)
+	{
+		first_[to] = DCS_DETAIL_MACRO_CX11_STD_MOVE_(first_[from]);
+	}
+
+	public: void fill(::std::size_t to)
 	{
-		*in_first = tmp[*idx_first];
+		first_[to] = DCS_DETAIL_MACRO_CX11_STD_MOVE_(tmp_);
+	}
+
+
+	private: RAIterT first_;
+	private: value_type tmp_;
+}; // reorder_hole
+
+/// Moves elements of two sequences (or of two groups of sequences) together.
+template <typename HoleT1, typename HoleT2>
+class reorder_hole_pair
+{
+	public: reorder_hole_pair(HoleT1& h1, HoleT2& h2)
+	: h1_(h1),
+	  h2_(h2)
+	{
+	}
+
+	public: void move(::std::size_t to, ::std::size_t from)
+	{
+		h1_.move(to, from);
+		h2_.move(to, from);
+	}
+
+	public: void fill(::std::size_t to)
+	{
+		h1_.fill(to);
+		h2_.fill(to);
+	}
+
+
+	private: HoleT1& h1_;
+	private: HoleT2& h2_;
+}; // reorder_hole_pair
+
+/// Rotates the cycle starting at \a i, that is moves element idx[j] to position j for each j in the cycle.
+template <typename MarkerT, typename HoleT>
+void reorder_rotate(::std::size_t i, MarkerT& marker, HoleT& hole)
+{
+	::std::size_t j(i);
+	for (::std::size_t k = marker.next(j); k != i; k = marker.next(j))
+	{
+		hole.move(j, k);
+		j = k;
+	}
+	hole.fill(j);
+}
+
+template <typename RAIterT1>
+struct reorder_rotator1
+{
+	reorder_rotator1(RAIterT1 first1)
+	: first1_(first1)
+	{
+	}
 
+	template <typename MarkerT>
+	void operator()(::std::size_t i, MarkerT& marker) const
+	{
+		reorder_hole<RAIterT1> h1(first1_, i);
+		reorder_rotate(i, marker, h1);
+	}
+
+	RAIterT1 first1_;
+}; // reorder_rotator1
+
+template <typename RAIterT1, typename RAIterT2>
+struct reorder_rotator2
+{
+	reorder_rotator2(RAIterT1 first1, RAIterT2 first2)
+	: first1_(first1),
+	  first2_(first2)
+	{
+	}
+
+	template <typename MarkerT>
+	void operator()(::std::size_t i, MarkerT& marker) const
+	{
+		reorder_hole<RAIterT1> h1(first1_, i);
+		reorder_hole<RAIterT2> h2(first2_, i);
+		reorder_hole_pair< reorder_hole<RAIterT1>, reorder_hole<RAIterT2> > h(h1, h2);
+		reorder_rotate(i, marker, h);
+	}
+
+	RAIterT1 first1_;
+	RAIterT2 first2_;
+}; // reorder_rotator2
+
+template <typename RAIterT1, typename RAIterT2, typename RAIterT3>
+struct reorder_rotator3
+{
+	reorder_rotator3(RAIterT1 first1, RAIterT2 first2, RAIterT3 first3)
+	: first1_(first1),
+	  first2_(first2),
+	  first3_(first3)
+	{
+	}
+
+	template <typename MarkerT>
+	void operator()(::std::size_t i, MarkerT& marker) const
+	{
+		typedef reorder_hole<RAIterT2> hole2_type;
+		typedef reorder_hole<RAIterT3> hole3_type;
+		typedef reorder_hole_pair<hole2_type,hole3_type> hole23_type;
+
+		reorder_hole<RAIterT1> h1(first1_, i);
+		hole2_type h2(first2_, i);
+		hole3_type h3(first3_, i);
+		hole23_type h23(h2, h3);
+		reorder_hole_pair<reorder_hole<RAIterT1>,hole23_type> h(h1, h23);
+		reorder_rotate(i, marker, h);
+	}
+
+	RAIterT1 first1_;
+	RAIterT2 first2_;
+	RAIterT3 first3_;
+}; // reorder_rotator3
+
+template <typename MarkerT, typename RotatorT>
+void reorder_cycles(::std::size_t n, MarkerT& marker, RotatorT const& rotate)
+{
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		// Fixed points are never reached by other cycles and need no mark
+		if (!marker.visited(i) && marker.index(i) != i)
+		{
+			rotate(i, marker);
+		}
+	}
+	marker.finish();
+}
+
+template <typename IdxRAIterT, typename RotatorT>
+void reorder_by_cycles(IdxRAIterT idx_first, IdxRAIterT idx_last, RotatorT const& rotate, ::std::random_access_iterator_tag)
+{
+	const ::std::size_t n(idx_last-idx_first);
+	reorder_bit_marker<IdxRAIterT> marker(idx_first, n);
+	reorder_cycles(n, marker, rotate);
+}
+
+template <typename IdxFwdIterT, typename RotatorT>
+void reorder_by_cycles(IdxFwdIterT idx_first, IdxFwdIterT idx_last, RotatorT const& rotate, ::std::forward_iterator_tag)
+{
+	const ::std::vector< ::std::size_t > idx(idx_first, idx_last);
+	reorder_by_cycles(idx.begin(), idx.end(), rotate, ::std::random_access_iterator_tag());
+}
+
+template <typename IdxFwdIterT, typename RAIterT>
+void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, RAIterT first, ::std::random_access_iterator_tag)
+{
+	typedef typename ::std::iterator_traits<IdxFwdIterT>::iterator_category idx_category;
+
+	reorder_by_cycles(idx_first, idx_last, reorder_rotator1<RAIterT>(first), idx_category());
+}
+
+template <typename IdxFwdIterT, typename FwdIterT>
+void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, FwdIterT first, ::std::forward_iterator_tag)
+{
+	typedef typename ::std::iterator_traits<FwdIterT>::value_type value_type;
+
+	// Elements cannot be moved around cheaply, so the input is copied once
+	// and the output is written sequentially.
+	FwdIterT last(first);
+	::std::advance(last, ::std::distance(idx_first, idx_last));
+	const ::std::vector<value_type> tmp(first, last);
+	while (idx_first != idx_last)
+	{
+		*first = tmp[*idx_first];
 		++idx_first;
-		++in_first;
-		++i;
+		++first;
 	}
 }
 
+} // Namespace detail
+
+
+/**
+ * \brief Applies the permutation of indices to the given sequence, writing
+ *  the result to another sequence.
+ *
+ * For each position \c i, \c out_first[i] is set to \c in_first[idx_first[i]],
+ * that is the input is gathered through the indices.
+ * The input sequence is traversed only once even when it is not
+ * random-access.
+ * With random-access input, the source element of a later index is
+ * prefetched while copying the current one, which hides part of the cache
+ * misses of scattered reads on large sequences.
+ */
+template <typename IdxFwdIterT, typename InFwdIterT, typename OutFwdIterT>
+void reorder_copy(IdxFwdIterT idx_first, IdxFwdIterT idx_last, InFwdIterT in_first, OutFwdIterT out_first)
+{
+	typedef typename ::std::iterator_traits<InFwdIterT>::iterator_category in_category;
+
+	detail::reorder_copy(idx_first, idx_last, in_first, out_first, in_category());
+}
+
+/**
+ * \brief Applies the permutation of indices to the given sequence, in place.
+ *
+ * After the call, the element at position \c i is the one that was at
+ * position \c idx_first[i] (the same result of reorder_copy()).
+ *
+ * With random-access sequences, elements are moved along the cycles of the
+ * permutation, so that each element is moved exactly once (plus one move per
+ * cycle) and the only extra memory is a bit per element to keep track of
+ * visited positions (plus a copy of the indices if they are not
+ * random-access).
+ * Otherwise, the sequence is copied once.
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxFwdIterT, typename FwdIterT>
+void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, FwdIterT first)
+{
+	typedef typename ::std::iterator_traits<FwdIterT>::iterator_category category;
+
+	detail::reorder(idx_first, idx_last, first, category());
+}
+
+/**
+ * \brief Applies the same permutation of indices to two sequences, in place.
+ *
+ * Both sequences are moved along the cycles of the permutation in a single
+ * pass (see reorder()).
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxFwdIterT, typename RAIterT1, typename RAIterT2>
+void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, RAIterT1 first1, RAIterT2 first2)
+{
+	typedef typename ::std::iterator_traits<IdxFwdIterT>::iterator_category idx_category;
+
+	detail::reorder_by_cycles(idx_first, idx_last, detail::reorder_rotator2<RAIterT1,RAIterT2>(first1, first2), idx_category());
+}
+
+/**
+ * \brief Applies the same permutation of indices to three sequences, in place.
+ *
+ * All the sequences are moved along the cycles of the permutation in a
+ * single pass (see reorder()).
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxFwdIterT, typename RAIterT1, typename RAIterT2, typename RAIterT3>
+void reorder(IdxFwdIterT idx_first, IdxFwdIterT idx_last, RAIterT1 first1, RAIterT2 first2, RAIterT3 first3)
+{
+	typedef typename ::std::iterator_traits<IdxFwdIterT>::iterator_category idx_category;
+
+	detail::reorder_by_cycles(idx_first, idx_last, detail::reorder_rotator3<RAIterT1,RAIterT2,RAIterT3>(first1, first2, first3), idx_category());
+}
+
+/**
+ * \brief Applies the permutation of indices to the given sequence, in place
+ *  and with constant extra memory.
+ *
+ * Like reorder(), but visited positions are marked by complementing their
+ * indices, which are restored before returning.
+ * Thus the indices must be stored in a mutable random-access sequence of
+ * integers and, when unsigned, their type must be able to represent 2n-1.
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxRAIterT, typename RAIterT>
+void reorder_marking(IdxRAIterT idx_first, IdxRAIterT idx_last, RAIterT first)
+{
+	const ::std::size_t n(idx_last-idx_first);
+	detail::reorder_index_marker<IdxRAIterT> marker(idx_first, n);
+	detail::reorder_cycles(n, marker, detail::reorder_rotator1<RAIterT>(first));
+}
+
+/**
+ * \brief Applies the same permutation of indices to two sequences, in place
+ *  and with constant extra memory (see reorder_marking()).
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxRAIterT, typename RAIterT1, typename RAIterT2>
+void reorder_marking(IdxRAIterT idx_first, IdxRAIterT idx_last, RAIterT1 first1, RAIterT2 first2)
+{
+	const ::std::size_t n(idx_last-idx_first);
+	detail::reorder_index_marker<IdxRAIterT> marker(idx_first, n);
+	detail::reorder_cycles(n, marker, detail::reorder_rotator2<RAIterT1,RAIterT2>(first1, first2));
+}
+
+/**
+ * \brief Applies the same permutation of indices to three sequences, in
+ *  place and with constant extra memory (see reorder_marking()).
+ *
+ * pre: [idx_first,idx_last) is a permutation of 0,...,n-1.
+ */
+template <typename IdxRAIterT, typename RAIterT1, typename RAIterT2, typename RAIterT3>
+void reorder_marking(IdxRAIterT idx_first, IdxRAIterT idx_last, RAIterT1 first1, RAIterT2 first2, RAIterT3 first3)
+{
+	const ::std::size_t n(idx_last-idx_first);
+	detail::reorder_index_marker<IdxRAIterT> marker(idx_first, n);
+	detail::reorder_cycles(n, marker, detail::reorder_rotator3<RAIterT1,RAIterT2,RAIterT3>(first1, first2, first3));
+}
+
 }} // Namespace dcs::algorithm
 
 
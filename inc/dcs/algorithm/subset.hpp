@@ -26,14 +26,15 @@
 #define DCS_COMMONS_ALGORITHM_SUBSET_HPP
 
 #include <algorithm>
-#include <boost/dynamic_bitset.hpp>
-#include <boost/math/special_functions/binomial.hpp>
 #include <cstddef>
+#include <dcs/algorithm/bitmask.hpp>
+#include <dcs/algorithm/combination.hpp>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -88,32 +89,38 @@ struct subset_traits
  *  {0,1,2,3}
  * </pre>
  *
+ * The subset is stored as a binary number in machine words, so that the
+ * number of elements is not limited by the size of a word, and each step is
+ * an in-place increment that takes amortized constant time.
+ * The current subset is available, without copies, through mask().
+ *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 class lexicographic_subset
 {
-	public: class const_iterator;
-
-
-	friend class const_iterator;
-
-
 	private: typedef lexicographic_subset self_type;
-	private: typedef ::boost::dynamic_bitset<> impl_type;
-	private: typedef typename impl_type::size_type size_type;
-	private: typedef unsigned long word_type;
+	private: typedef bitmask_word_type word_type;
+	private: typedef ::std::size_t size_type;
+	public: typedef bitmask_view::const_iterator const_iterator;
 
 
 	public: explicit lexicographic_subset(::std::size_t n, bool empty_set=true)
 	: n_(n),
 	  empty_set_(empty_set),
-	  bits_(n, empty_set ? 0 : 1),
+	  words_(detail::bitmask_num_words(n), 0),
+	  size_(0),
 	  has_prev_(false),
 	  has_next_(n_ > 0 ? true : false)
 	{
 		DCS_ASSERT(n_ > 0,
 				   DCS_EXCEPTION_THROW(::std::invalid_argument,
 									   "Number of elements must be positive"));
+
+		if (!empty_set_)
+		{
+			words_[0] = 1;
+			size_ = 1;
+		}
 	}
 
 	public: ::std::size_t max_size() const
@@ -123,30 +130,75 @@ class lexicographic_subset
 
 	public: ::std::size_t size() const
 	{
-		return bits_.count();
+		return size_;
 	}
 
 	public: ::std::size_t count() const
 	{
-		const ::std::size_t c = 1 << n_; // 2^n
+		// pre: 2^n fits in std::size_t
+		DCS_ASSERT(n_ < static_cast< ::std::size_t >(::std::numeric_limits< ::std::size_t >::digits),
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "Number of subsets is too large"));
+
+		const ::std::size_t c = ::std::size_t(1) << n_; // 2^n
 
 		return empty_set_ ? c : (c-1);
 	}
 
+	/// Returns the position of the current subset in the generation order.
+	public: ::std::size_t rank() const
+	{
+		// pre: the rank fits in std::size_t
+		DCS_ASSERT(::std::count(words_.begin()+1, words_.end(), word_type(0)) == static_cast< ::std::ptrdiff_t >(words_.size()-1),
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "Rank is too large"));
+
+		const ::std::size_t v = words_[0];
+
+		return empty_set_ ? v : (v-1);
+	}
+
+	/**
+	 * \brief Moves to the subset at the given position in the generation
+	 *  order.
+	 *
+	 * Since subsets are generated in binary counting order, the subset of
+	 * rank \a r is the binary representation of \a r (or of \a r+1, if the
+	 * empty set is excluded).
+	 */
+	public: self_type& unrank(::std::size_t r)
+	{
+		// pre: r < count()
+		DCS_ASSERT(r < this->count(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Rank is out of range"));
+
+		::std::fill(words_.begin(), words_.end(), 0);
+		words_[0] = empty_set_ ? r : (r+1);
+		size_ = detail::bitmask_popcount(words_[0]);
+		has_prev_ = r > 0;
+		has_next_ = true;
+
+		return *this;
+	}
+
 	public: self_type& operator++()
 	{
 		DCS_ASSERT(has_next_,
 				   DCS_EXCEPTION_THROW(::std::overflow_error,
 									   "No following subsets"));
 
-		has_next_ = bits_.count() < n_;
+		has_next_ = size_ < n_;
 
 		if (has_next_)
 		{
-			bits_ = impl_type(n_, bits_.to_ulong()+1);
+			// Adding one clears the lowest run of ones and sets the bit
+			// above it
+			size_ -= detail::bitmask_increment(&words_[0], words_.size());
+			++size_;
 		}
 
-		has_prev_ = bits_.to_ulong() > (empty_set_ ? 0 : 1);
+		has_prev_ = !this->is_first();
 
 		return *this;
 	}
@@ -162,14 +214,15 @@ class lexicographic_subset
 				   DCS_EXCEPTION_THROW(::std::underflow_error,
 									   "No preceding subsets"));
 
-		has_prev_ = bits_.to_ulong() > (empty_set_ ? 0 : 1);
+		has_prev_ = !this->is_first();
 
 		if (has_prev_)
 		{
-			bits_ = impl_type(n_, bits_.to_ulong()-1);
+			size_ += detail::bitmask_decrement(&words_[0], words_.size());
+			--size_;
 		}
 
-		has_next_ = bits_.to_ulong() < n_;
+		has_next_ = true;
 
 		return *this;
 	}
@@ -179,18 +232,15 @@ class lexicographic_subset
 		return has_prev_;
 	}
 
-	public: typename ::std::vector<size_type> operator()() const
+	/// Returns a view of the current subset, as a bitmask.
+	public: bitmask_view mask() const
 	{
-		::std::vector<size_type> subset;
-
-		for (size_type pos = bits_.find_first();
-			 pos != impl_type::npos;
-			 pos = bits_.find_next(pos))
-		{
-			subset.push_back(pos);
-		}
+		return bitmask_view(&words_[0], n_);
+	}
 
-		return subset;
+	public: ::std::vector<size_type> operator()() const
+	{
+		return ::std::vector<size_type>(this->begin(), this->end());
 	}
 
 	//public: template <typename ElemT, typename IterT>
@@ -203,11 +253,10 @@ class lexicographic_subset
 
 		typename subset_traits<ElemT>::element_container subset;
 
-		for (size_type pos = bits_.find_first();
-			 pos != impl_type::npos;
-			 pos = bits_.find_next(pos))
+		subset.reserve(size_);
+		for (const_iterator it = this->begin(), end_it = this->end(); it != end_it; ++it)
 		{
-			subset.push_back(v[pos]);
+			subset.push_back(v[*it]);
 		}
 
 		return subset;
@@ -221,253 +270,374 @@ class lexicographic_subset
 
 	public: const_iterator begin() const
 	{
-		return const_iterator(this, bits_.any() ? bits_.find_first() : impl_type::npos);
+		return this->mask().begin();
 	}
 
 	public: const_iterator end() const
 	{
-		return const_iterator(this, impl_type::npos);
+		return this->mask().end();
 	}
 
-
-	public: class const_iterator: public ::std::iterator< ::std::bidirectional_iterator_tag,
-														 typename lexicographic_subset::impl_type::size_type const>
+	private: bool is_first() const
 	{
-		private: typedef ::std::iterator< ::std::bidirectional_iterator_tag,
-										  typename lexicographic_subset::impl_type::size_type const> base_type;
-		private: typedef lexicographic_subset container_type;
-		private: typedef typename container_type::impl_type bitset_type;
-		private: typedef typename container_type::size_type size_type;
-		public: typedef typename base_type::value_type value_type;
-		public: typedef typename base_type::difference_type difference_type;
-		public: typedef typename base_type::pointer pointer;
-		public: typedef typename base_type::reference reference;
-		public: typedef typename base_type::iterator_category iterator_category;
-
-
-		public: const_iterator(container_type const* p_subset, size_type pos)
-		: p_sub_(p_subset),
-		  pos_(pos)
+		if (words_[0] > (empty_set_ ? 0 : 1))
 		{
+			return false;
 		}
-
-		public: reference operator*() const
+		for (::std::size_t i = 1; i < words_.size(); ++i)
 		{
-			return pos_;
-		}
-
-		public: pointer operator->() const
-		{
-			return &(operator*());
+			if (words_[i])
+			{
+				return false;
+			}
 		}
+		return true;
+	}
 
-		public: const_iterator& operator++()
-		{
-			pos_ = p_sub_->bits_.find_next(pos_);
 
-			return *this;
-		}
+	private: ::std::size_t n_; ///< The max number of elements
+	private: bool empty_set_; ///< Flag to enable or disable the inclusion of the empty set
+	private: ::std::vector<word_type> words_; ///< The subset, as a multiword binary number
+	private: ::std::size_t size_; ///< The number of elements in the subset
+	private: bool has_prev_;
+	private: bool has_next_;
+}; // lexicographic_subset
 
-		public: const_iterator operator++(int)
-		{
-			const_iterator tmp = *this;
+/**
+ * \brief Class to generate in lexicographic order all subsets of a specific size
+ *
+ * Given a set N={0,1,...,n-1} of n elements, this class iteratively generates
+ * all subset S of N of size 0<=k<=n, in lexicographic order.
+ * For instance, for a set of 4 elements, the generation of subset of size 2 in
+ * lexicographic order produces the following sequence:
+ * <pre>
+ *  \emptyset,
+ *  {0,1},
+ *  {0,2},
+ *  {1,2},
+ *  {0,3},
+ *  {1,3},
+ *  {2,3}
+ * </pre>
+ *
+ * The subset is stored as a bitmask in machine words, and each step applies
+ * Gosper's hack (carried over to the following words when needed), so that
+ * the number of elements is not limited by the size of a word.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class lexicographic_k_subset
+{
+	private: typedef lexicographic_k_subset self_type;
+	private: typedef bitmask_word_type word_type;
+	private: typedef ::std::size_t size_type;
+	public: typedef bitmask_view::const_iterator const_iterator;
 
-			operator++();
 
-			return tmp;
-		}
+	public: explicit lexicographic_k_subset(::std::size_t n, ::std::size_t k)
+	: n_(n),
+	  k_(k),
+	  words_(detail::bitmask_num_words(n), 0),
+	  has_prev_(false),
+	  has_next_(n_ > 0 && k_ > 0 ? true : false)
+	{
+		DCS_ASSERT(n_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of elements must be positive"));
+		DCS_ASSERT(n_ >= k,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size of subset must be non negative"));
 
-		public: const_iterator& operator--()
-		{
-			size_type pos = bitset_type::npos;
-			for (size_type pos2 = p_sub_->bits_.find_first();
-				 pos2 != pos_;
-				 pos2 = p_sub_->bits_.find_next(pos2))
-			{
-				pos = pos2;
-			}
+		detail::bitmask_assign_range(&words_[0], 0, k_, true);
+	}
 
-			pos_ = pos;
+	public: ::std::size_t max_size() const
+	{
+		return k_;
+	}
 
-			return *this;
-		}
+	public: ::std::size_t size() const
+	{
+		return k_;
+	}
 
-		public: const_iterator operator--(int)
-		{
-			const_iterator tmp = *this;
+	public: ::std::size_t count() const
+	{
+		return detail::checked_binomial(n_, k_);
+	}
 
-			operator--();
+	/**
+	 * \brief Returns the position of the current subset in the generation
+	 *  order.
+	 *
+	 * Subsets are generated in colexicographic order, thus the rank of the
+	 * subset \f$\{c_0<c_1<\ldots<c_{k-1}\}\f$ is
+	 * \f$\sum_{i=0}^{k-1}\binom{c_i}{i+1}\f$ (i.e., the combinatorial number
+	 * system).
+	 */
+	public: ::std::size_t rank() const
+	{
+		::std::size_t r = 0;
+		::std::size_t i = 0;
 
-			return tmp;
+		for (const_iterator it = this->begin(), end_it = this->end(); it != end_it; ++it)
+		{
+			++i;
+			r += detail::checked_binomial(*it, i);
 		}
 
-		public: const_iterator operator+(difference_type n) const
-		{
-			const_iterator it = *this;
+		return r;
+	}
 
-			if (n > 0)
-			{
-				while (n--)
-				{
-					++it;
-				}
-			}
-			else
+	/// Moves to the subset at the given position in the generation order.
+	public: self_type& unrank(::std::size_t r)
+	{
+		// pre: r < count()
+		DCS_ASSERT(r < this->count(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Rank is out of range"));
+
+		::std::fill(words_.begin(), words_.end(), 0);
+		has_prev_ = r > 0;
+		has_next_ = k_ > 0;
+
+		// Greedily pick the largest element first
+		::std::size_t pos = n_;
+		for (::std::size_t i = k_; i > 0; --i)
+		{
+			::std::size_t c = 0;
+			do
 			{
-				while (n++)
-				{
-					--it;
-				}
+				--pos;
+				c = detail::checked_binomial(pos, i);
 			}
+			while (c > r);
 
-			return it;
+			r -= c;
+			words_[pos/detail::bitmask_word_bits] |= word_type(1) << (pos%detail::bitmask_word_bits);
 		}
 
-		public: const_iterator operator-(difference_type n) const
+		return *this;
+	}
+
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following subsets"));
+
+		if (k_ > 0)
 		{
-			return operator+(-n);
+			has_next_ = detail::bitmask_next_colex(&words_[0], n_);
+			has_prev_ = !this->is_first();
 		}
 
-		public: const_iterator& operator+=(difference_type n)
-		{
-			if (n > 0)
-			{
-				while (n--)
-				{
-					operator++();
-				}
-			}
-			else
-			{
-				while (n++)
-				{
-					operator--();
-				}
-			}
+		return *this;
+	}
 
-			return *this;
-		}
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
 
-		public: const_iterator& operator-=(difference_type n)
-		{
-			return operator+=(-n);
-		}
+	public: self_type& operator--()
+	{
+		DCS_ASSERT(has_prev_,
+				   DCS_EXCEPTION_THROW(::std::underflow_error,
+									   "No preceding subsets"));
 
-		friend
-		bool operator==(const_iterator const& lhs, const_iterator const& rhs)
+		if (k_ > 0)
 		{
-			return lhs.p_sub_ == rhs.p_sub_ && lhs.pos_ == rhs.pos_;
+			has_prev_ = detail::bitmask_prev_colex(&words_[0], n_);
+			has_next_ = true;
 		}
 
-		friend
-		bool operator!=(const_iterator const& lhs, const_iterator const& rhs)
+		return *this;
+	}
+
+	public: bool has_prev() const
+	{
+		return has_prev_;
+	}
+
+	/// Returns a view of the current subset, as a bitmask.
+	public: bitmask_view mask() const
+	{
+		return bitmask_view(&words_[0], n_);
+	}
+
+	//public: template <typename ElemT, typename IterT>
+	public: template <typename ElemT>
+			typename subset_traits<ElemT>::element_container operator()(::std::vector<ElemT> const& v) const
+	{
+		DCS_ASSERT(v.size() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size does not match"));
+
+		typename subset_traits<ElemT>::element_container subset;
+
+		subset.reserve(k_);
+		for (const_iterator it = this->begin(), end_it = this->end(); it != end_it; ++it)
 		{
-			return !(lhs == rhs);
+			subset.push_back(v[*it]);
 		}
 
+		return subset;
+	}
 
-		private: container_type const* p_sub_;
-		private: size_type pos_;
-	}; // const_iterator
+	public: template <typename IterT>
+			typename subset_traits< typename ::std::iterator_traits<IterT>::value_type >::element_container operator()(IterT first, IterT last) const
+	{
+			return this->operator()(::std::vector<typename ::std::iterator_traits<IterT>::value_type>(first, last));
+	}
 
+	public: const_iterator begin() const
+	{
+		return this->mask().begin();
+	}
 
-	private: ::std::size_t n_; ///< The max number of elements
-	private: bool empty_set_; ///< Flag to enable or disable the inclusion of the empty set
-	private: impl_type bits_; ///< The subset implementation
+	public: const_iterator end() const
+	{
+		return this->mask().end();
+	}
+
+	/// The first subset is {0,1,...,k-1}, i.e., the first zero is at k.
+	private: bool is_first() const
+	{
+		return detail::bitmask_find_from(&words_[0], n_, 0, false) >= k_;
+	}
+
+
+	private: ::std::size_t n_; ///< The number of elements of the set
+	private: ::std::size_t k_; ///< The max number of elements of the subset
+	private: ::std::vector<word_type> words_; ///< The subset, as a bitmask
 	private: bool has_prev_;
 	private: bool has_next_;
-}; // lexicographic_subset
-
+}; // lexicographic_k_subset
 
 /**
- * \brief Class to generate in lexicographic order all subsets of a specific size
+ * \brief Class to generate all subsets in reflected Gray code order
  *
  * Given a set N={0,1,...,n-1} of n elements, this class iteratively generates
- * all subset S of N of size 0<=k<=n, in lexicographic order.
- * For instance, for a set of 4 elements, the generation of subset of size 2 in
- * lexicographic order produces the following sequence:
+ * all subset S of N, included the empty set, so that two consecutive subsets
+ * differ by exactly one element: the i-th step adds or removes the element
+ * whose position is the number of trailing zeros of i.
+ * For instance, for a set of 3 elements, the subset generation in Gray code
+ * order produces the following sequence:
  * <pre>
  *  \emptyset,
+ *  {0},
  *  {0,1},
- *  {0,2},
+ *  {1},
  *  {1,2},
- *  {0,3},
- *  {1,3},
- *  {2,3}
+ *  {0,1,2},
+ *  {0,2},
+ *  {2}
  * </pre>
  *
+ * The subset and the step counter are stored in machine words, so that the
+ * number of elements is not limited by the size of a word and each step
+ * takes amortized constant time.
+ * The element changed by the last step is given by changed_element().
+ *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
-class lexicographic_k_subset
+class gray_code_subset
 {
-	public: class const_iterator;
-
+	private: typedef gray_code_subset self_type;
+	private: typedef bitmask_word_type word_type;
+	private: typedef ::std::size_t size_type;
+	public: typedef bitmask_view::const_iterator const_iterator;
 
-	friend class const_iterator;
 
-
-	private: typedef lexicographic_k_subset self_type;
-	private: typedef ::boost::dynamic_bitset<> impl_type;
-	private: typedef typename impl_type::size_type size_type;
-	private: typedef unsigned long word_type;
-
-
-	public: explicit lexicographic_k_subset(::std::size_t n, ::std::size_t k)
+	public: explicit gray_code_subset(::std::size_t n)
 	: n_(n),
-	  k_(k),
-	  bits_(n, (1 << k_)-1),
+	  words_(detail::bitmask_num_words(n), 0),
+	  counter_(detail::bitmask_num_words(n), 0),
+	  size_(0),
+	  changed_(0),
+	  added_(false),
 	  has_prev_(false),
-	  has_next_(n_ > 0 && k_ > 0 ? true : false)
+	  has_next_(n_ > 0 ? true : false)
 	{
 		DCS_ASSERT(n_ > 0,
 				   DCS_EXCEPTION_THROW(::std::invalid_argument,
 									   "Number of elements must be positive"));
-		DCS_ASSERT(n_ >= k,
-				   DCS_EXCEPTION_THROW(::std::invalid_argument,
-									   "Size of subset must be non negative"));
 	}
 
 	public: ::std::size_t max_size() const
 	{
-		return k_;
+		return n_;
 	}
 
 	public: ::std::size_t size() const
 	{
-		return bits_.count();
+		return size_;
 	}
 
 	public: ::std::size_t count() const
 	{
-		return static_cast<std::size_t>(boost::math::binomial_coefficient<double>(n_, k_));
+		// pre: 2^n fits in std::size_t
+		DCS_ASSERT(n_ < static_cast< ::std::size_t >(::std::numeric_limits< ::std::size_t >::digits),
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "Number of subsets is too large"));
+
+		return ::std::size_t(1) << n_; // 2^n
 	}
 
-	public: self_type& operator++()
+	/// Returns the position of the current subset in the generation order.
+	public: ::std::size_t rank() const
 	{
-		DCS_ASSERT(has_next_,
+		// pre: the rank fits in std::size_t
+		DCS_ASSERT(::std::count(counter_.begin()+1, counter_.end(), word_type(0)) == static_cast< ::std::ptrdiff_t >(counter_.size()-1),
 				   DCS_EXCEPTION_THROW(::std::overflow_error,
-									   "No following subsets"));
+									   "Rank is too large"));
 
-		if (k_ > 0)
-		{
-			unsigned long v = bits_.to_ulong();
+		return counter_[0];
+	}
 
-			const unsigned long lo = v & ~(v - 1);       // lowest one bit
-			const unsigned long lz = (v + lo) & ~v;      // lowest zero bit above lo
-			v |= lz;                     // add lz to the set
-			v &= ~(lz - 1);              // reset bits below lz
-			v |= (lz / lo / 2) - 1;      // put back right number of bits at end
+	/**
+	 * \brief Moves to the subset at the given position in the generation
+	 *  order.
+	 *
+	 * The subset of rank \a r is the binary representation of
+	 * \f$r \oplus \lfloor r/2 \rfloor\f$.
+	 */
+	public: self_type& unrank(::std::size_t r)
+	{
+		// pre: r < count()
+		DCS_ASSERT(r < this->count(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Rank is out of range"));
+
+		::std::fill(counter_.begin(), counter_.end(), 0);
+		::std::fill(words_.begin(), words_.end(), 0);
+		counter_[0] = r;
+		words_[0] = r ^ (r >> 1);
+		size_ = detail::bitmask_popcount(words_[0]);
+		has_prev_ = r > 0;
+		has_next_ = true;
+
+		return *this;
+	}
 
-			has_next_ = !(v & 1 << n_);
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following subsets"));
 
-			if (has_next_)
-			{
-				bits_ = impl_type(n_, v);
-			}
+		// The last subset is {n-1}
+		has_next_ = size_ != 1 || !this->mask().test(n_-1);
 
-			has_prev_ = (bits_.to_ulong() != static_cast<unsigned long>((1 << k_)-1));
+		if (has_next_)
+		{
+			detail::bitmask_increment(&counter_[0], counter_.size());
+			this->flip(detail::bitmask_find_from(&counter_[0], n_, 0, true));
 		}
 
+		has_prev_ = size_ > 0;
+
 		return *this;
 	}
 
@@ -482,34 +652,17 @@ class lexicographic_k_subset
 				   DCS_EXCEPTION_THROW(::std::underflow_error,
 									   "No preceding subsets"));
 
-		if (k_ > 0)
-		{
-			const unsigned long w = bits_.to_ulong();
-			const unsigned long min = (1 << k_)-1;
-			unsigned long v = min;
-			unsigned long p = v;
-
-			while (v != w)
-			{
-				p = v;
-
-				const unsigned long lo = v & ~(v - 1);       // lowest one bit
-				const unsigned long lz = (v + lo) & ~v;      // lowest zero bit above lo
-				v |= lz;                     // add lz to the set
-				v &= ~(lz - 1);              // reset bits below lz
-				v |= (lz / lo / 2) - 1;      // put back right number of bits at end
-			}
+		// The first subset is the empty set
+		has_prev_ = size_ > 0;
 
-			has_prev_ = (p != min) || (w != min);
-
-//			if (has_prev_)
-//			{
-				bits_ = impl_type(n_, p);
-//			}
-
-			has_next_ = !(p & 1 << n_);
+		if (has_prev_)
+		{
+			this->flip(detail::bitmask_find_from(&counter_[0], n_, 0, true));
+			detail::bitmask_decrement(&counter_[0], counter_.size());
 		}
 
+		has_next_ = true;
+
 		return *this;
 	}
 
@@ -518,7 +671,17 @@ class lexicographic_k_subset
 		return has_prev_;
 	}
 
-	//public: template <typename ElemT, typename IterT>
+	/// Returns a view of the current subset, as a bitmask.
+	public: bitmask_view mask() const
+	{
+		return bitmask_view(&words_[0], n_);
+	}
+
+	public: ::std::vector<size_type> operator()() const
+	{
+		return ::std::vector<size_type>(this->begin(), this->end());
+	}
+
 	public: template <typename ElemT>
 			typename subset_traits<ElemT>::element_container operator()(::std::vector<ElemT> const& v) const
 	{
@@ -528,11 +691,10 @@ class lexicographic_k_subset
 
 		typename subset_traits<ElemT>::element_container subset;
 
-		for (size_type pos = bits_.find_first();
-			 pos != impl_type::npos;
-			 pos = bits_.find_next(pos))
+		subset.reserve(size_);
+		for (const_iterator it = this->begin(), end_it = this->end(); it != end_it; ++it)
 		{
-			subset.push_back(v[pos]);
+			subset.push_back(v[*it]);
 		}
 
 		return subset;
@@ -546,162 +708,290 @@ class lexicographic_k_subset
 
 	public: const_iterator begin() const
 	{
-		return const_iterator(this, bits_.any() ? bits_.find_first() : impl_type::npos);
+		return this->mask().begin();
 	}
 
 	public: const_iterator end() const
 	{
-		return const_iterator(this, impl_type::npos);
+		return this->mask().end();
 	}
 
+	/**
+	 * \brief Returns the element added or removed by the last step.
+	 *
+	 * Together with added(), this lets a function of the subset be updated
+	 * incrementally rather than recomputed.
+	 *
+	 * \pre At least one step has been taken.
+	 */
+	public: ::std::size_t changed_element() const
+	{
+		return changed_;
+	}
 
-	public: class const_iterator: public ::std::iterator< ::std::bidirectional_iterator_tag,
-														 typename lexicographic_k_subset::impl_type::size_type const>
+	/// Tells if the last step added (rather than removed) changed_element().
+	public: bool added() const
 	{
-		private: typedef ::std::iterator< ::std::bidirectional_iterator_tag,
-										  typename lexicographic_k_subset::impl_type::size_type const> base_type;
-		private: typedef lexicographic_k_subset container_type;
-		private: typedef typename container_type::impl_type bitset_type;
-		private: typedef typename container_type::size_type size_type;
-		public: typedef typename base_type::value_type value_type;
-		public: typedef typename base_type::difference_type difference_type;
-		public: typedef typename base_type::pointer pointer;
-		public: typedef typename base_type::reference reference;
-		public: typedef typename base_type::iterator_category iterator_category;
+		return added_;
+	}
 
+	private: void flip(::std::size_t pos)
+	{
+		const word_type bit = word_type(1) << (pos%detail::bitmask_word_bits);
+		word_type& w = words_[pos/detail::bitmask_word_bits];
 
-		public: const_iterator(container_type const* p_subset, size_type pos)
-		: p_sub_(p_subset),
-		  pos_(pos)
+		w ^= bit;
+		added_ = (w & bit) != 0;
+		changed_ = pos;
+		if (added_)
 		{
+			++size_;
 		}
-
-		public: reference operator*() const
+		else
 		{
-			return pos_;
+			--size_;
 		}
+	}
+
+
+	private: ::std::size_t n_; ///< The max number of elements
+	private: ::std::vector<word_type> words_; ///< The subset, as a bitmask
+	private: ::std::vector<word_type> counter_; ///< The number of steps from the first subset
+	private: ::std::size_t size_; ///< The number of elements in the subset
+	private: ::std::size_t changed_; ///< The element changed by the last step
+	private: bool added_; ///< Tells if the last step added the changed element
+	private: bool has_prev_;
+	private: bool has_next_;
+}; // gray_code_subset
+
+/**
+ * \brief Class to generate all subsets of a specific size in revolving-door
+ *  order
+ *
+ * Given a set N={0,1,...,n-1} of n elements, this class iteratively generates
+ * all subset S of N of size 0<=k<=n, so that each subset is obtained from the
+ * previous one by removing one element and adding another one (see
+ * removed_element() and added_element()).
+ * For instance, for a set of 4 elements, the generation of subset of size 2 in
+ * revolving-door order produces the following sequence:
+ * <pre>
+ *  {0,1},
+ *  {1,2},
+ *  {0,2},
+ *  {2,3},
+ *  {1,3},
+ *  {0,3}
+ * </pre>
+ *
+ * Subsets are generated with Algorithm R in:
+ *   D. Knuth.
+ *   "The Art of Computer Programming, Volume 4A: Combinatorial Algorithms, Part 1,"
+ *   Addison-Wesley, 2011 (Section 7.2.1.3).
+ * .
+ * Generation only goes forward.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class revolving_door_k_subset
+{
+	private: typedef revolving_door_k_subset self_type;
+	private: typedef bitmask_word_type word_type;
+	public: typedef ::std::vector< ::std::size_t >::const_iterator const_iterator;
+
+
+	public: revolving_door_k_subset(::std::size_t n, ::std::size_t k)
+	: n_(n),
+	  k_(k),
+	  c_(k+2),
+	  words_(detail::bitmask_num_words(n), 0),
+	  added_(0),
+	  removed_(0),
+	  has_next_(true)
+	{
+		DCS_ASSERT(n_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of elements must be positive"));
+		DCS_ASSERT(n_ >= k_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size of subset must be non negative"));
+
+		this->reset();
+	}
 
-		public: pointer operator->() const
+	/// Moves to the first subset, i.e., {0,1,...,k-1}.
+	public: void reset()
+	{
+		// Elements are stored in c_[1..k], followed by the sentinel n
+		for (::std::size_t j = 1; j <= k_; ++j)
 		{
-			return &(operator*());
+			c_[j] = j-1;
 		}
+		c_[k_+1] = n_;
+		::std::fill(words_.begin(), words_.end(), 0);
+		detail::bitmask_assign_range(&words_[0], 0, k_, true);
+		has_next_ = true;
+	}
 
-		public: const_iterator& operator++()
-		{
-			pos_ = p_sub_->bits_.find_next(pos_);
+	public: ::std::size_t max_size() const
+	{
+		return k_;
+	}
 
-			return *this;
-		}
+	public: ::std::size_t size() const
+	{
+		return k_;
+	}
 
-		public: const_iterator operator++(int)
-		{
-			const_iterator tmp = *this;
+	public: ::std::size_t count() const
+	{
+		return detail::checked_binomial(n_, k_);
+	}
 
-			operator++();
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following subsets"));
 
-			return tmp;
-		}
+		has_next_ = k_ > 0 && k_ < n_ && this->step();
 
-		public: const_iterator& operator--()
+		if (has_next_)
 		{
-			size_type pos = bitset_type::npos;
-			for (size_type pos2 = p_sub_->bits_.find_first();
-				 pos2 != pos_;
-				 pos2 = p_sub_->bits_.find_next(pos2))
-			{
-				pos = pos2;
-			}
+			this->flip(removed_);
+			this->flip(added_);
+		}
 
-			pos_ = pos;
+		return *this;
+	}
 
-			return *this;
-		}
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
 
-		public: const_iterator operator--(int)
-		{
-			const_iterator tmp = *this;
+	/**
+	 * \brief Returns the element added by the last step.
+	 *
+	 * Together with removed_element(), this lets a function of the subset be
+	 * updated incrementally rather than recomputed.
+	 *
+	 * \pre At least one step has been taken.
+	 */
+	public: ::std::size_t added_element() const
+	{
+		return added_;
+	}
 
-			operator--();
+	/// Returns the element removed by the last step.
+	public: ::std::size_t removed_element() const
+	{
+		return removed_;
+	}
 
-			return tmp;
-		}
+	/// Returns a view of the current subset, as a bitmask.
+	public: bitmask_view mask() const
+	{
+		return bitmask_view(&words_[0], n_);
+	}
+
+	public: template <typename ElemT>
+			typename subset_traits<ElemT>::element_container operator()(::std::vector<ElemT> const& v) const
+	{
+		DCS_ASSERT(v.size() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size does not match"));
 
-		public: const_iterator operator+(difference_type n) const
+		typename subset_traits<ElemT>::element_container subset;
+
+		subset.reserve(k_);
+		for (const_iterator it = this->begin(), end_it = this->end(); it != end_it; ++it)
 		{
-			const_iterator it = *this;
+			subset.push_back(v[*it]);
+		}
 
-			if (n > 0)
-			{
-				while (n--)
-				{
-					++it;
-				}
-			}
-			else
+		return subset;
+	}
+
+	/// Returns an iterator to the smallest element of the subset.
+	public: const_iterator begin() const
+	{
+		return c_.begin()+1;
+	}
+
+	public: const_iterator end() const
+	{
+		return c_.begin()+1+k_;
+	}
+
+	/// Steps R3-R5 of Algorithm R (with 1-based indices).
+	private: bool step()
+	{
+		// Easy case: move the smallest element
+		if (k_ & 1)
+		{
+			if ((c_[1]+1) < c_[2])
 			{
-				while (n++)
-				{
-					--it;
-				}
+				removed_ = c_[1];
+				added_ = ++c_[1];
+				return true;
 			}
-
-			return it;
 		}
-
-		public: const_iterator operator-(difference_type n) const
+		else if (c_[1] > 0)
 		{
-			return operator+(-n);
+			removed_ = c_[1];
+			added_ = --c_[1];
+			return true;
 		}
 
-		public: const_iterator& operator+=(difference_type n)
+		// Alternately try to decrease and to increase c_j, starting with
+		// decreasing when k is odd
+		bool decrease = (k_ & 1) != 0;
+		for (::std::size_t j = 2; j <= k_; ++j, decrease = !decrease)
 		{
-			if (n > 0)
+			if (decrease)
 			{
-				while (n--)
+				// Here c_j = c_{j-1}+1
+				if (c_[j] >= j)
 				{
-					operator++();
+					removed_ = c_[j];
+					added_ = j-2;
+					c_[j] = c_[j-1];
+					c_[j-1] = j-2;
+					return true;
 				}
 			}
 			else
 			{
-				while (n++)
+				// Here c_{j-1} = j-2
+				if ((c_[j]+1) < c_[j+1])
 				{
-					operator--();
+					removed_ = j-2;
+					added_ = c_[j]+1;
+					c_[j-1] = c_[j];
+					++c_[j];
+					return true;
 				}
 			}
-
-			return *this;
-		}
-
-		public: const_iterator& operator-=(difference_type n)
-		{
-			return operator+=(-n);
-		}
-
-		friend
-		bool operator==(const_iterator const& lhs, const_iterator const& rhs)
-		{
-			return lhs.p_sub_ == rhs.p_sub_ && lhs.pos_ == rhs.pos_;
-		}
-
-		friend
-		bool operator!=(const_iterator const& lhs, const_iterator const& rhs)
-		{
-			return !(lhs == rhs);
 		}
 
+		return false;
+	}
 
-		private: container_type const* p_sub_;
-		private: size_type pos_;
-	}; // const_iterator
+	private: void flip(::std::size_t pos)
+	{
+		words_[pos/detail::bitmask_word_bits] ^= word_type(1) << (pos%detail::bitmask_word_bits);
+	}
 
 
 	private: ::std::size_t n_; ///< The number of elements of the set
-	private: ::std::size_t k_; ///< The max number of elements of the subset
-	private: impl_type bits_; ///< The subset implementation
-	private: bool has_prev_;
+	private: ::std::size_t k_; ///< The number of elements of the subset
+	private: ::std::vector< ::std::size_t > c_; ///< The sorted elements of the subset (1-based), plus a sentinel
+	private: ::std::vector<word_type> words_; ///< The subset, as a bitmask
+	private: ::std::size_t added_; ///< The element added by the last step
+	private: ::std::size_t removed_; ///< The element removed by the last step
 	private: bool has_next_;
-}; // lexicographic_k_subset
+}; // revolving_door_k_subset
+
 
 
 template <typename CharT, typename CharTraitsT>
@@ -750,6 +1040,29 @@ template <typename CharT, typename CharTraitsT>
 	return os;
 }
 
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os,
+													gray_code_subset const& subset)
+{
+	os << '(';
+
+	if (subset.size() > 0)
+	{
+		if (subset.size() > 1)
+		{
+			::std::copy(subset.begin(),
+						subset.end()-1,
+						::std::ostream_iterator< ::std::size_t >(os, " "));
+		}
+
+		os << *(subset.end()-1);
+	}
+
+	os << ')';
+
+	return os;
+}
+
 template <typename BidiIterT, typename SubsetT>
 inline
 typename subset_traits< typename ::std::iterator_traits<BidiIterT>::value_type >::element_container
@@ -0,0 +1,226 @@
+/**
+ * \file dcs/concurrent/disjoint_sets.hpp
+ *
+ * \brief Lock-free disjoint-sets (union-find) data structure.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_CONCURRENT_DISJOINT_SETS_HPP
+#define DCS_CONCURRENT_DISJOINT_SETS_HPP
+
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <limits>
+#include <stdexcept>
+
+
+namespace dcs { namespace concurrent {
+
+/**
+ * \brief Lock-free disjoint sets over the dense integer identifiers
+ *  0,...,n-1.
+ *
+ * Any number of threads can concurrently call find_set(), same_set() and
+ * union_sets() without locks, following the randomized linking of Jayanti
+ * and Tarjan:
+ * - the parent of each element is an atomic word, and a root is linked
+ *   below another one by a single compare-and-swap, which fails (and the
+ *   union is retried) if the root has been linked meanwhile;
+ * - roots are linked by a fixed random-like total order (a multiplicative
+ *   hash of identifiers, which is a bijection), so that the expected depth
+ *   of trees stays logarithmic without keeping ranks or sizes;
+ * - finds compress paths by splitting, where each step tries a single
+ *   compare-and-swap of the parent with the grandparent and goes on
+ *   regardless of its outcome.
+ *
+ * Each operation is linearizable.
+ * However, the representative returned by find_set() may be out of date
+ * as soon as it is returned if other threads are merging sets; use
+ * same_set() to test whether two elements belong to the same set.
+ *
+ * \tparam IndexT The unsigned integral type of identifiers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename IndexT = ::std::size_t>
+class disjoint_sets: ::boost::noncopyable
+{
+	BOOST_STATIC_ASSERT( ::std::numeric_limits<IndexT>::is_integer && !::std::numeric_limits<IndexT>::is_signed );
+
+	public: typedef IndexT index_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef ::boost::atomic<index_type> atomic_index_type;
+
+
+	/// Creates \a n singleton sets.
+	public: explicit disjoint_sets(size_type n)
+	: parents_(new atomic_index_type[n]),
+	  n_(n)
+	{
+		DCS_ASSERT(n == 0 || n-1 <= static_cast<size_type>(::std::numeric_limits<index_type>::max()),
+				   DCS_EXCEPTION_THROW(::std::length_error,
+									   "Too many elements for the index type"));
+
+		for (size_type i = 0; i < n; ++i)
+		{
+			parents_[i].store(static_cast<index_type>(i), ::boost::memory_order_relaxed);
+		}
+		::boost::atomic_thread_fence(::boost::memory_order_release);
+	}
+
+	/// Returns the number of elements.
+	public: size_type size() const
+	{
+		return n_;
+	}
+
+	/**
+	 * Returns the number of disjoint sets.
+	 *
+	 * The result is exact only if no union runs concurrently.
+	 */
+	public: size_type num_sets() const
+	{
+		size_type count(0);
+		for (size_type i = 0; i < n_; ++i)
+		{
+			if (parents_[i].load(::boost::memory_order_acquire) == i)
+			{
+				++count;
+			}
+		}
+		return count;
+	}
+
+	/// Returns the representative of the set containing \a i.
+	public: index_type find_set(index_type i) const
+	{
+		// pre: i < size()
+		DCS_ASSERT(static_cast<size_type>(i) < n_,
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Unknown element"));
+
+		index_type u(i);
+		for (;;)
+		{
+			index_type v(parents_[u].load(::boost::memory_order_acquire));
+			const index_type w(parents_[v].load(::boost::memory_order_acquire));
+			if (v == w)
+			{
+				return v;
+			}
+			// Path splitting: a failure means another thread changed the
+			// parent of u, which is fine as well.
+			parents_[u].compare_exchange_weak(v, w, ::boost::memory_order_release, ::boost::memory_order_relaxed);
+			u = v;
+		}
+	}
+
+	/// Tells if \a i and \a j belong to the same set.
+	public: bool same_set(index_type i, index_type j) const
+	{
+		for (;;)
+		{
+			i = this->find_set(i);
+			j = this->find_set(j);
+			if (i == j)
+			{
+				return true;
+			}
+			// If i is still a root, the two sets were distinct when j was
+			// found to be a root
+			if (parents_[i].load(::boost::memory_order_acquire) == i)
+			{
+				return false;
+			}
+		}
+	}
+
+	/**
+	 * Merges the sets containing \a i and \a j and returns \c true if they
+	 * were distinct (i.e., if this call merged them).
+	 */
+	public: bool union_sets(index_type i, index_type j)
+	{
+		for (;;)
+		{
+			i = this->find_set(i);
+			j = this->find_set(j);
+			if (i == j)
+			{
+				return false;
+			}
+			if (priority(i) > priority(j))
+			{
+				const index_type t(i);
+				i = j;
+				j = t;
+			}
+			// Link the root with lower priority, if it is still a root
+			index_type expect(i);
+			if (parents_[i].compare_exchange_strong(expect, j, ::boost::memory_order_acq_rel, ::boost::memory_order_acquire))
+			{
+				return true;
+			}
+		}
+	}
+
+	/**
+	 * Merges the sets containing the elements of each pair in the range
+	 * [first,last) and returns the number of merges performed by this call.
+	 */
+	public: template <typename PairFwdIterT>
+			size_type union_all(PairFwdIterT first, PairFwdIterT last)
+	{
+		size_type count(0);
+		for (; first != last; ++first)
+		{
+			if (this->union_sets(first->first, first->second))
+			{
+				++count;
+			}
+		}
+		return count;
+	}
+
+	/// The order used to link roots, which is a bijection of identifiers.
+	private: static index_type priority(index_type i)
+	{
+		// 2^64 divided by the golden ratio, which is odd
+		const ::boost::uint64_t golden((static_cast< ::boost::uint64_t >(0x9E3779B9) << 32) | 0x7F4A7C15);
+		return static_cast<index_type>(static_cast< ::boost::uint64_t >(i)*golden);
+	}
+
+
+	private: ::boost::scoped_array<atomic_index_type> parents_;
+	private: size_type n_;
+}; // disjoint_sets
+
+}} // Namespace dcs::concurrent
+
+
+#endif // DCS_CONCURRENT_DISJOINT_SETS_HPP
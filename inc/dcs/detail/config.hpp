@@ -0,0 +1,18 @@
+/** \file dcs/detail/config.hpp
+ *
+ * \brief Configuration for this library.
+ *
+ * [2026-10-18 11:04:02 (UTC)]
+ * This is an autogenerated file. Do not edit.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DETAIL_CONFIG_HPP
+#define DCS_DETAIL_CONFIG_HPP
+
+
+#include <dcs/detail/config/boost.hpp>
+
+
+#endif // DCS_DETAIL_CONFIG_HPP
@@ -0,0 +1,335 @@
+/**
+ * \file dcs/detail/uri.hpp
+ *
+ * \brief Character classes and scheme properties shared by the URI classes.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DETAIL_URI_HPP
+#define DCS_DETAIL_URI_HPP
+
+
+#include <cstddef>
+#include <cstring>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif // __SSE2__
+
+
+namespace dcs { namespace detail {
+
+/// The classes of URI characters (see RFC 3986), as bit masks.
+enum uri_char_class
+{
+	uri_scheme_char = 0x01, ///< ALPHA / DIGIT / "+" / "-" / "."
+	uri_unreserved_char = 0x02, ///< ALPHA / DIGIT / "-" / "." / "_" / "~"
+	uri_hex_digit_char = 0x04, ///< HEXDIG
+	uri_percent_char = 0x08, ///< "%"
+	uri_authority_end_char = 0x10, ///< The characters ending the authority: "/" / "?" / "#"
+	uri_path_end_char = 0x20, ///< The characters ending the path: "?" / "#"
+	uri_query_end_char = 0x40 ///< The characters ending the query: "#"
+};
+
+/**
+ * The sets of characters that can be left as they are when percent-encoding
+ * a URI part, as bit masks.
+ *
+ * Non-ASCII characters, controls, space and the characters in "%<>{}|\\^`"
+ * and the double quote are never left as they are.
+ */
+enum uri_encode_set
+{
+	uri_path_safe = 0x01, ///< All but "?" / "#"
+	uri_query_safe = 0x02, ///< All but "#"
+	uri_fragment_safe = 0x04, ///< All
+	uri_query_component_safe = 0x08, ///< All but "#" / "&" / "=" / "+", for query keys and values
+	uri_unreserved_safe = 0x10 ///< Only the unreserved characters
+};
+
+/// The table of character classes and hex digit values, indexed by character.
+struct uri_char_table
+{
+	uri_char_table()
+	{
+		::std::memset(classes, 0, sizeof(classes));
+		::std::memset(hex_values, 0xff, sizeof(hex_values));
+
+		for (int c = 'a'; c <= 'z'; ++c)
+		{
+			classes[c] |= uri_scheme_char | uri_unreserved_char;
+			classes[c-'a'+'A'] |= uri_scheme_char | uri_unreserved_char;
+		}
+		for (int c = '0'; c <= '9'; ++c)
+		{
+			classes[c] |= uri_scheme_char | uri_unreserved_char | uri_hex_digit_char;
+			hex_values[c] = static_cast<unsigned char>(c-'0');
+		}
+		for (int c = 0; c < 6; ++c)
+		{
+			classes['a'+c] |= uri_hex_digit_char;
+			classes['A'+c] |= uri_hex_digit_char;
+			hex_values['a'+c] = hex_values['A'+c] = static_cast<unsigned char>(10+c);
+		}
+		classes[static_cast<unsigned char>('+')] |= uri_scheme_char;
+		classes[static_cast<unsigned char>('-')] |= uri_scheme_char | uri_unreserved_char;
+		classes[static_cast<unsigned char>('.')] |= uri_scheme_char | uri_unreserved_char;
+		classes[static_cast<unsigned char>('_')] |= uri_unreserved_char;
+		classes[static_cast<unsigned char>('~')] |= uri_unreserved_char;
+		classes[static_cast<unsigned char>('%')] |= uri_percent_char;
+		classes[static_cast<unsigned char>('/')] |= uri_authority_end_char;
+		classes[static_cast<unsigned char>('?')] |= uri_authority_end_char | uri_path_end_char;
+		classes[static_cast<unsigned char>('#')] |= uri_authority_end_char | uri_path_end_char | uri_query_end_char;
+
+		::std::memset(encode_sets, 0, sizeof(encode_sets));
+		for (int c = 0x21; c < 0x7f; ++c)
+		{
+			encode_sets[c] = uri_path_safe | uri_query_safe | uri_fragment_safe | uri_query_component_safe;
+		}
+		for (char const* c = "%<>{}|\\\"^`"; *c; ++c)
+		{
+			encode_sets[static_cast<unsigned char>(*c)] = 0;
+		}
+		encode_sets[static_cast<unsigned char>('?')] &= ~uri_path_safe;
+		for (char const* c = "#&=+"; *c; ++c)
+		{
+			encode_sets[static_cast<unsigned char>(*c)] &= ~uri_query_component_safe;
+		}
+		encode_sets[static_cast<unsigned char>('#')] &= ~(uri_path_safe | uri_query_safe);
+		for (int c = 0; c < 256; ++c)
+		{
+			if (classes[c] & uri_unreserved_char)
+			{
+				encode_sets[c] |= uri_unreserved_safe;
+			}
+		}
+	}
+
+	unsigned char classes[256];
+	unsigned char hex_values[256]; ///< The value of hex digits, 0xff for other characters
+	unsigned char encode_sets[256]; ///< The encode sets (see uri_encode_set) each character belongs to
+}; // uri_char_table
+
+inline uri_char_table const& uri_chars()
+{
+	static const uri_char_table table;
+
+	return table;
+}
+
+/**
+ * Percent-encodes the characters in [first,last) into \a out, leaving as
+ * they are the characters \c c for which <code>safe[c] & mask</code> is
+ * not zero.
+ *
+ * The output needs room for up to three times the input length. Returns the
+ * end of the output.
+ */
+inline char* uri_percent_encode(char const* first, char const* last, char* out, unsigned char const* safe, unsigned char mask)
+{
+	static const char hex_digits[] = "0123456789ABCDEF";
+
+	while (first != last)
+	{
+		// Copy the run of safe characters at once
+		char const* run(first);
+		while (run != last && (safe[static_cast<unsigned char>(*run)] & mask))
+		{
+			++run;
+		}
+		::std::memcpy(out, first, run-first);
+		out += run-first;
+		first = run;
+
+		for (; first != last && !(safe[static_cast<unsigned char>(*first)] & mask); ++first)
+		{
+			const unsigned char c(static_cast<unsigned char>(*first));
+			out[0] = '%';
+			out[1] = hex_digits[c >> 4];
+			out[2] = hex_digits[c & 0x0f];
+			out += 3;
+		}
+	}
+
+	return out;
+}
+
+/**
+ * Percent-decodes the characters in [first,last) into \a out, optionally
+ * decoding "+" as a space (as in HTML form data).
+ *
+ * The output needs room for the input length, and may be the input itself.
+ * A percent sign not followed by two hex digits is copied as it is if
+ * \a lenient is \c true; otherwise, a null pointer is returned.
+ * Returns the end of the output.
+ *
+ * With SSE2, the runs without escapes are scanned and copied 16 characters
+ * at a time.
+ */
+inline char* uri_percent_decode(char const* first, char const* last, char* out, bool plus_as_space, bool lenient)
+{
+	uri_char_table const& chars(uri_chars());
+	const char plus(plus_as_space ? '+' : '%');
+#ifdef __SSE2__
+	const __m128i pct16(_mm_set1_epi8('%'));
+	const __m128i plus16(_mm_set1_epi8(plus));
+#endif // __SSE2__
+
+	while (first != last)
+	{
+		// Copy the run of characters without escapes
+#ifdef __SSE2__
+		while ((last-first) >= 16)
+		{
+			const __m128i x(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first)));
+			const int m(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, pct16), _mm_cmpeq_epi8(x, plus16))));
+			if (m)
+			{
+				const int n(__builtin_ctz(m));
+				::std::memmove(out, first, n);
+				out += n;
+				first += n;
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), x);
+			out += 16;
+			first += 16;
+		}
+#endif // __SSE2__
+		while (first != last && *first != '%' && *first != plus)
+		{
+			*out++ = *first++;
+		}
+		if (first == last)
+		{
+			break;
+		}
+
+		if (*first != '%')
+		{
+			*out++ = ' ';
+			++first;
+		}
+		else if ((last-first) >= 3
+				 && chars.hex_values[static_cast<unsigned char>(first[1])] != 0xff
+				 && chars.hex_values[static_cast<unsigned char>(first[2])] != 0xff)
+		{
+			*out++ = static_cast<char>((chars.hex_values[static_cast<unsigned char>(first[1])] << 4)
+									   | chars.hex_values[static_cast<unsigned char>(first[2])]);
+			first += 3;
+		}
+		else if (lenient)
+		{
+			*out++ = *first++;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	return out;
+}
+
+/**
+ * Tells if the characters in [first,last), once percent-decoded (leniently,
+ * see uri_percent_decode()), equal the \a n characters at \a s.
+ *
+ * Characters are decoded one at a time and the comparison stops at the
+ * first difference, so that nothing is written.
+ */
+inline bool uri_percent_equal(char const* first, char const* last, char const* s, ::std::size_t n, bool plus_as_space)
+{
+	// A character takes one to three encoded characters
+	const ::std::size_t len(last-first);
+	if (n > len || n < (len+2)/3)
+	{
+		return false;
+	}
+
+	uri_char_table const& chars(uri_chars());
+	char const* s_last(s+n);
+	for (; first != last && s != s_last; ++s)
+	{
+		char c(*first++);
+		if (c == '%'
+			&& (last-first) >= 2
+			&& chars.hex_values[static_cast<unsigned char>(first[0])] != 0xff
+			&& chars.hex_values[static_cast<unsigned char>(first[1])] != 0xff)
+		{
+			c = static_cast<char>((chars.hex_values[static_cast<unsigned char>(first[0])] << 4)
+								  | chars.hex_values[static_cast<unsigned char>(first[1])]);
+			first += 2;
+		}
+		else if (c == '+' && plus_as_space)
+		{
+			c = ' ';
+		}
+		if (c != *s)
+		{
+			return false;
+		}
+	}
+
+	return first == last && s == s_last;
+}
+
+/// Returns the well-known port number of the given (lower-case) scheme, or
+/// 0 if the port number is not known.
+inline unsigned short uri_well_known_port(char const* scheme, ::std::size_t len)
+{
+	//TODO: incomplete
+	// See:
+	// - https://en.wikipedia.org/wiki/List_of_TCP_and_UDP_port_numbers
+	// - https://www.iana.org/assignments/uri-schemes.html
+	// - http://www.iana.org/assignments/port-numbers
+
+	static const struct
+	{
+		char const* scheme;
+		unsigned short port;
+	} ports[] = {
+		{"ftp", 21},
+		{"ssh", 22},
+		{"telnet", 23},
+		{"http", 80},
+		{"nntp", 119},
+		{"ldap", 389},
+		{"https", 443},
+		{"rtsp", 554},
+		{"sip", 5060},
+		{"sips", 5061},
+		{"xmpp", 5222}
+	};
+
+	for (::std::size_t i = 0; i < sizeof(ports)/sizeof(ports[0]); ++i)
+	{
+		if (::std::strlen(ports[i].scheme) == len && ::std::memcmp(ports[i].scheme, scheme, len) == 0)
+		{
+			return ports[i].port;
+		}
+	}
+
+	return 0;
+}
+
+}} // Namespace dcs::detail
+
+
+#endif // DCS_DETAIL_URI_HPP
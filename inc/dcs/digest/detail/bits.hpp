@@ -0,0 +1,133 @@
+/**
+ * \file dcs/digest/detail/bits.hpp
+ *
+ * \brief Bit manipulation helpers shared by the digest algorithms.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DIGEST_DETAIL_BITS_HPP
+#define DCS_DIGEST_DETAIL_BITS_HPP
+
+
+#include <boost/cstdint.hpp>
+#include <dcs/digest/commons.hpp>
+
+
+/// Builds a 64-bit constant from its 32-bit halves (C++98 has no 64-bit literals).
+#define DCS_DIGEST_DETAIL_UINT64_(hi,lo) ((static_cast< ::boost::uint64_t >(hi) << 32) | static_cast< ::boost::uint64_t >(lo))
+
+
+namespace dcs { namespace digest { namespace detail {
+
+inline ::boost::uint32_t rotl32(::boost::uint32_t x, int n)
+{
+	return (x << n) | (x >> (32-n));
+}
+
+inline ::boost::uint32_t rotr32(::boost::uint32_t x, int n)
+{
+	return (x >> n) | (x << (32-n));
+}
+
+inline ::boost::uint64_t rotl64(::boost::uint64_t x, int n)
+{
+	return (x << n) | (x >> (64-n));
+}
+
+inline ::boost::uint32_t byte_swap32(::boost::uint32_t x)
+{
+	return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+}
+
+inline ::boost::uint64_t byte_swap64(::boost::uint64_t x)
+{
+	return (static_cast< ::boost::uint64_t >(byte_swap32(static_cast< ::boost::uint32_t >(x))) << 32)
+		   | byte_swap32(static_cast< ::boost::uint32_t >(x >> 32));
+}
+
+inline ::boost::uint32_t load_le32(byte_type const* p)
+{
+	return static_cast< ::boost::uint32_t >(p[0])
+		   | (static_cast< ::boost::uint32_t >(p[1]) << 8)
+		   | (static_cast< ::boost::uint32_t >(p[2]) << 16)
+		   | (static_cast< ::boost::uint32_t >(p[3]) << 24);
+}
+
+inline ::boost::uint64_t load_le64(byte_type const* p)
+{
+	return static_cast< ::boost::uint64_t >(load_le32(p))
+		   | (static_cast< ::boost::uint64_t >(load_le32(p+4)) << 32);
+}
+
+inline ::boost::uint32_t load_be32(byte_type const* p)
+{
+	return (static_cast< ::boost::uint32_t >(p[0]) << 24)
+		   | (static_cast< ::boost::uint32_t >(p[1]) << 16)
+		   | (static_cast< ::boost::uint32_t >(p[2]) << 8)
+		   | static_cast< ::boost::uint32_t >(p[3]);
+}
+
+inline void store_le64(byte_type* p, ::boost::uint64_t x)
+{
+	for (int i = 0; i < 8; ++i)
+	{
+		p[i] = static_cast<byte_type>(x >> (8*i));
+	}
+}
+
+inline void store_be32(byte_type* p, ::boost::uint32_t x)
+{
+	p[0] = static_cast<byte_type>(x >> 24);
+	p[1] = static_cast<byte_type>(x >> 16);
+	p[2] = static_cast<byte_type>(x >> 8);
+	p[3] = static_cast<byte_type>(x);
+}
+
+inline void store_be64(byte_type* p, ::boost::uint64_t x)
+{
+	store_be32(p, static_cast< ::boost::uint32_t >(x >> 32));
+	store_be32(p+4, static_cast< ::boost::uint32_t >(x));
+}
+
+/// Returns the XOR of the low and high halves of the 128-bit product of \a a and \a b.
+inline ::boost::uint64_t mul128_fold64(::boost::uint64_t a, ::boost::uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 uint128_type;
+
+	const uint128_type r(static_cast<uint128_type>(a)*b);
+
+	return static_cast< ::boost::uint64_t >(r) ^ static_cast< ::boost::uint64_t >(r >> 64);
+#else // __SIZEOF_INT128__
+	const ::boost::uint64_t mask(0xffffffff);
+	const ::boost::uint64_t lo_lo((a & mask)*(b & mask));
+	const ::boost::uint64_t hi_lo((a >> 32)*(b & mask));
+	const ::boost::uint64_t lo_hi((a & mask)*(b >> 32));
+	const ::boost::uint64_t hi_hi((a >> 32)*(b >> 32));
+	const ::boost::uint64_t cross((lo_lo >> 32)+(hi_lo & mask)+lo_hi);
+
+	return ((cross << 32) | (lo_lo & mask)) ^ (hi_hi+(hi_lo >> 32)+(cross >> 32));
+#endif // __SIZEOF_INT128__
+}
+
+}}} // Namespace dcs::digest::detail
+
+
+#endif // DCS_DIGEST_DETAIL_BITS_HPP
@@ -0,0 +1,418 @@
+/**
+ * \file dcs/digest/detail/sha256_x86.hpp
+ *
+ * \brief SHA-NI, SSE2 and AVX2 kernels of SHA-256.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DIGEST_DETAIL_SHA256_X86_HPP
+#define DCS_DIGEST_DETAIL_SHA256_X86_HPP
+
+
+// The kernels are compiled for their own instruction set through the target
+// attribute, whatever the flags of the including translation unit, and are
+// only called after checking the CPU at run time.
+#if (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) \
+	&& (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+# define DCS_DIGEST_DETAIL_SHA256_X86 1
+#endif // (__x86_64__ || __i386__) && ...
+
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+
+#include <boost/cstdint.hpp>
+#include <cpuid.h>
+#include <cstddef>
+#include <dcs/digest/commons.hpp>
+#include <dcs/digest/detail/bits.hpp>
+#include <immintrin.h>
+
+
+#define DCS_DIGEST_DETAIL_SHA256_X86_TARGET_(x) __attribute__((__target__(x)))
+
+
+namespace dcs { namespace digest { namespace detail {
+
+/// Returns \c true if the CPU supports the SHA extensions (and SSE4.1, which the kernel needs too).
+inline bool sha256_x86_has_sha()
+{
+	unsigned int eax(0);
+	unsigned int ebx(0);
+	unsigned int ecx(0);
+	unsigned int edx(0);
+
+	if (__get_cpuid_max(0, 0) < 7)
+	{
+		return false;
+	}
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+	__builtin_cpu_init();
+	return ((ebx >> 29) & 1) && __builtin_cpu_supports("sse4.1");
+}
+
+/// Returns \c true if the CPU supports AVX2.
+inline bool sha256_x86_has_avx2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+/**
+ * Applies the compression function to \a n consecutive blocks with the SHA
+ * extensions.
+ *
+ * The SHA instructions keep the state as the (A,B,E,F) and (C,D,G,H) word
+ * pairs, and each \c sha256rnds2 performs two rounds.
+ */
+DCS_DIGEST_DETAIL_SHA256_X86_TARGET_("sha,sse4.1")
+inline void sha256_compress_shani(::boost::uint32_t* state, byte_type const* p, ::std::size_t n, ::boost::uint32_t const* k)
+{
+	const __m128i bswap(_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+
+	__m128i tmp(_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0xb1)); // CDAB
+	__m128i state1(_mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state+4)), 0x1b)); // EFGH
+	__m128i state0(_mm_alignr_epi8(tmp, state1, 8)); // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xf0); // CDGH
+
+// Four rounds with the message words in cur, plus the part of the schedule
+// that is done meanwhile
+#define DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(g, cur) \
+	w = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<__m128i const*>(k+4*(g)))); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, w); \
+	w = _mm_shuffle_epi32(w, 0x0e); \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, w)
+#define DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(cur, next, prev) \
+	next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)); \
+	next = _mm_sha256msg2_epu32(next, cur)
+#define DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(cur, prev) \
+	prev = _mm_sha256msg1_epu32(prev, cur)
+
+	for (; n > 0; --n, p += 64)
+	{
+		const __m128i abef_save(state0);
+		const __m128i cdgh_save(state1);
+		__m128i w;
+		__m128i m0(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)), bswap));
+		__m128i m1(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+16)), bswap));
+		__m128i m2(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+32)), bswap));
+		__m128i m3(_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p+48)), bswap));
+
+		// Group g uses the message words of m[g%4]; the schedule of the
+		// words for group g+1 is completed during group g, and started
+		// during group g-3
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(0, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(1, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m1, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(2, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m2, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(3, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m3, m0, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m3, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(4, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m0, m1, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m0, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(5, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m1, m2, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m1, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(6, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m2, m3, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m2, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(7, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m3, m0, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m3, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(8, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m0, m1, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m0, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(9, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m1, m2, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m1, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(10, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m2, m3, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m2, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(11, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m3, m0, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m3, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(12, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m0, m1, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_(m0, m3);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(13, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m1, m2, m0);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(14, m2);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_(m2, m3, m1);
+		DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_(15, m3);
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+	}
+
+#undef DCS_DIGEST_DETAIL_SHA256_SHANI_MSG1_
+#undef DCS_DIGEST_DETAIL_SHA256_SHANI_MSG2_
+#undef DCS_DIGEST_DETAIL_SHA256_SHANI_ROUNDS_
+
+	tmp = _mm_shuffle_epi32(state0, 0x1b); // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xb1); // DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xf0); // DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8); // HGFE
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state+4), state1);
+}
+
+
+// Multi-buffer kernels: lane l of each vector belongs to message l, so that
+// one pass of the compression function processes a block of each message.
+// The state is stored word-major (i.e., word w of lane l is at w*width+l).
+
+inline __m128i sha256_x4_rotr(__m128i x, int n)
+{
+	return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32-n));
+}
+
+/// Reverses the bytes of each 32-bit word, without SSSE3.
+inline __m128i sha256_x4_byte_swap(__m128i x)
+{
+	x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+	return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+inline void sha256_x4_round(__m128i a, __m128i b, __m128i c, __m128i& d, __m128i e, __m128i f, __m128i g, __m128i& h, __m128i w, ::boost::uint32_t k)
+{
+	const __m128i sigma1(_mm_xor_si128(_mm_xor_si128(sha256_x4_rotr(e, 6), sha256_x4_rotr(e, 11)), sha256_x4_rotr(e, 25)));
+	const __m128i ch(_mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g)));
+	const __m128i t1(_mm_add_epi32(_mm_add_epi32(_mm_add_epi32(h, sigma1), _mm_add_epi32(ch, w)), _mm_set1_epi32(static_cast<int>(k))));
+	const __m128i sigma0(_mm_xor_si128(_mm_xor_si128(sha256_x4_rotr(a, 2), sha256_x4_rotr(a, 13)), sha256_x4_rotr(a, 22)));
+	const __m128i maj(_mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b))));
+	d = _mm_add_epi32(d, t1);
+	h = _mm_add_epi32(t1, _mm_add_epi32(sigma0, maj));
+}
+
+inline __m128i sha256_x4_schedule(__m128i* w, int i)
+{
+	const __m128i w2(w[(i+14) & 15]);
+	const __m128i w15(w[(i+1) & 15]);
+	const __m128i s0(_mm_xor_si128(_mm_xor_si128(sha256_x4_rotr(w15, 7), sha256_x4_rotr(w15, 18)), _mm_srli_epi32(w15, 3)));
+	const __m128i s1(_mm_xor_si128(_mm_xor_si128(sha256_x4_rotr(w2, 17), sha256_x4_rotr(w2, 19)), _mm_srli_epi32(w2, 10)));
+	w[i] = _mm_add_epi32(_mm_add_epi32(w[i], s0), _mm_add_epi32(w[(i+9) & 15], s1));
+	return w[i];
+}
+
+/// Applies the compression function to a block of each of 4 messages, with SSE2.
+inline void sha256_compress_x4_sse2(::boost::uint32_t* state, byte_type const* const* blocks, ::boost::uint32_t const* k)
+{
+	__m128i s[8];
+	for (int i = 0; i < 8; ++i)
+	{
+		s[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state+4*i));
+	}
+
+	// Each group of 4 words is loaded from each message and transposed
+	__m128i w[16];
+	for (int i = 0; i < 16; i += 4)
+	{
+		const __m128i r0(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks[0]+4*i)));
+		const __m128i r1(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks[1]+4*i)));
+		const __m128i r2(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks[2]+4*i)));
+		const __m128i r3(_mm_loadu_si128(reinterpret_cast<__m128i const*>(blocks[3]+4*i)));
+		const __m128i t0(_mm_unpacklo_epi32(r0, r1));
+		const __m128i t1(_mm_unpacklo_epi32(r2, r3));
+		const __m128i t2(_mm_unpackhi_epi32(r0, r1));
+		const __m128i t3(_mm_unpackhi_epi32(r2, r3));
+		w[i] = sha256_x4_byte_swap(_mm_unpacklo_epi64(t0, t1));
+		w[i+1] = sha256_x4_byte_swap(_mm_unpackhi_epi64(t0, t1));
+		w[i+2] = sha256_x4_byte_swap(_mm_unpacklo_epi64(t2, t3));
+		w[i+3] = sha256_x4_byte_swap(_mm_unpackhi_epi64(t2, t3));
+	}
+
+	// Sixteen rounds, renaming the working variables instead of moving them
+#define DCS_DIGEST_DETAIL_SHA256_X4_ROUNDS16_(W) \
+	sha256_x4_round(a, b, c, d, e, f, g, h, W(0), k[t+0]); \
+	sha256_x4_round(h, a, b, c, d, e, f, g, W(1), k[t+1]); \
+	sha256_x4_round(g, h, a, b, c, d, e, f, W(2), k[t+2]); \
+	sha256_x4_round(f, g, h, a, b, c, d, e, W(3), k[t+3]); \
+	sha256_x4_round(e, f, g, h, a, b, c, d, W(4), k[t+4]); \
+	sha256_x4_round(d, e, f, g, h, a, b, c, W(5), k[t+5]); \
+	sha256_x4_round(c, d, e, f, g, h, a, b, W(6), k[t+6]); \
+	sha256_x4_round(b, c, d, e, f, g, h, a, W(7), k[t+7]); \
+	sha256_x4_round(a, b, c, d, e, f, g, h, W(8), k[t+8]); \
+	sha256_x4_round(h, a, b, c, d, e, f, g, W(9), k[t+9]); \
+	sha256_x4_round(g, h, a, b, c, d, e, f, W(10), k[t+10]); \
+	sha256_x4_round(f, g, h, a, b, c, d, e, W(11), k[t+11]); \
+	sha256_x4_round(e, f, g, h, a, b, c, d, W(12), k[t+12]); \
+	sha256_x4_round(d, e, f, g, h, a, b, c, W(13), k[t+13]); \
+	sha256_x4_round(c, d, e, f, g, h, a, b, W(14), k[t+14]); \
+	sha256_x4_round(b, c, d, e, f, g, h, a, W(15), k[t+15])
+#define DCS_DIGEST_DETAIL_SHA256_X4_LOAD_(i) w[i]
+#define DCS_DIGEST_DETAIL_SHA256_X4_SCHEDULE_(i) sha256_x4_schedule(w, i)
+
+	__m128i a(s[0]), b(s[1]), c(s[2]), d(s[3]), e(s[4]), f(s[5]), g(s[6]), h(s[7]);
+	int t(0);
+	DCS_DIGEST_DETAIL_SHA256_X4_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_X4_LOAD_);
+	for (t = 16; t < 64; t += 16)
+	{
+		DCS_DIGEST_DETAIL_SHA256_X4_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_X4_SCHEDULE_);
+	}
+
+#undef DCS_DIGEST_DETAIL_SHA256_X4_SCHEDULE_
+#undef DCS_DIGEST_DETAIL_SHA256_X4_LOAD_
+#undef DCS_DIGEST_DETAIL_SHA256_X4_ROUNDS16_
+
+	s[0] = _mm_add_epi32(s[0], a);
+	s[1] = _mm_add_epi32(s[1], b);
+	s[2] = _mm_add_epi32(s[2], c);
+	s[3] = _mm_add_epi32(s[3], d);
+	s[4] = _mm_add_epi32(s[4], e);
+	s[5] = _mm_add_epi32(s[5], f);
+	s[6] = _mm_add_epi32(s[6], g);
+	s[7] = _mm_add_epi32(s[7], h);
+	for (int i = 0; i < 8; ++i)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state+4*i), s[i]);
+	}
+}
+
+DCS_DIGEST_DETAIL_SHA256_X86_TARGET_("avx2")
+inline __m256i sha256_x8_rotr(__m256i x, int n)
+{
+	return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32-n));
+}
+
+DCS_DIGEST_DETAIL_SHA256_X86_TARGET_("avx2")
+inline void sha256_x8_round(__m256i a, __m256i b, __m256i c, __m256i& d, __m256i e, __m256i f, __m256i g, __m256i& h, __m256i w, ::boost::uint32_t k)
+{
+	const __m256i sigma1(_mm256_xor_si256(_mm256_xor_si256(sha256_x8_rotr(e, 6), sha256_x8_rotr(e, 11)), sha256_x8_rotr(e, 25)));
+	const __m256i ch(_mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+	const __m256i t1(_mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(ch, w)), _mm256_set1_epi32(static_cast<int>(k))));
+	const __m256i sigma0(_mm256_xor_si256(_mm256_xor_si256(sha256_x8_rotr(a, 2), sha256_x8_rotr(a, 13)), sha256_x8_rotr(a, 22)));
+	const __m256i maj(_mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))));
+	d = _mm256_add_epi32(d, t1);
+	h = _mm256_add_epi32(t1, _mm256_add_epi32(sigma0, maj));
+}
+
+DCS_DIGEST_DETAIL_SHA256_X86_TARGET_("avx2")
+inline __m256i sha256_x8_schedule(__m256i* w, int i)
+{
+	const __m256i w2(w[(i+14) & 15]);
+	const __m256i w15(w[(i+1) & 15]);
+	const __m256i s0(_mm256_xor_si256(_mm256_xor_si256(sha256_x8_rotr(w15, 7), sha256_x8_rotr(w15, 18)), _mm256_srli_epi32(w15, 3)));
+	const __m256i s1(_mm256_xor_si256(_mm256_xor_si256(sha256_x8_rotr(w2, 17), sha256_x8_rotr(w2, 19)), _mm256_srli_epi32(w2, 10)));
+	w[i] = _mm256_add_epi32(_mm256_add_epi32(w[i], s0), _mm256_add_epi32(w[(i+9) & 15], s1));
+	return w[i];
+}
+
+/// Applies the compression function to a block of each of 8 messages, with AVX2.
+DCS_DIGEST_DETAIL_SHA256_X86_TARGET_("avx2")
+inline void sha256_compress_x8_avx2(::boost::uint32_t* state, byte_type const* const* blocks, ::boost::uint32_t const* k)
+{
+	__m256i s[8];
+	for (int i = 0; i < 8; ++i)
+	{
+		s[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(state+8*i));
+	}
+
+	// Each group of 8 words is loaded from each message and transposed
+	const __m256i bswap(_mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+										 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+	__m256i w[16];
+	for (int i = 0; i < 16; i += 8)
+	{
+		__m256i r[8];
+		for (int l = 0; l < 8; ++l)
+		{
+			r[l] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(blocks[l]+4*i));
+		}
+		const __m256i t0(_mm256_unpacklo_epi32(r[0], r[1]));
+		const __m256i t1(_mm256_unpackhi_epi32(r[0], r[1]));
+		const __m256i t2(_mm256_unpacklo_epi32(r[2], r[3]));
+		const __m256i t3(_mm256_unpackhi_epi32(r[2], r[3]));
+		const __m256i t4(_mm256_unpacklo_epi32(r[4], r[5]));
+		const __m256i t5(_mm256_unpackhi_epi32(r[4], r[5]));
+		const __m256i t6(_mm256_unpacklo_epi32(r[6], r[7]));
+		const __m256i t7(_mm256_unpackhi_epi32(r[6], r[7]));
+		const __m256i u0(_mm256_unpacklo_epi64(t0, t2));
+		const __m256i u1(_mm256_unpackhi_epi64(t0, t2));
+		const __m256i u2(_mm256_unpacklo_epi64(t1, t3));
+		const __m256i u3(_mm256_unpackhi_epi64(t1, t3));
+		const __m256i u4(_mm256_unpacklo_epi64(t4, t6));
+		const __m256i u5(_mm256_unpackhi_epi64(t4, t6));
+		const __m256i u6(_mm256_unpacklo_epi64(t5, t7));
+		const __m256i u7(_mm256_unpackhi_epi64(t5, t7));
+		w[i] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x20), bswap);
+		w[i+1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x20), bswap);
+		w[i+2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x20), bswap);
+		w[i+3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x20), bswap);
+		w[i+4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u0, u4, 0x31), bswap);
+		w[i+5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u1, u5, 0x31), bswap);
+		w[i+6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u2, u6, 0x31), bswap);
+		w[i+7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(u3, u7, 0x31), bswap);
+	}
+
+	// Sixteen rounds, renaming the working variables instead of moving them
+#define DCS_DIGEST_DETAIL_SHA256_X8_ROUNDS16_(W) \
+	sha256_x8_round(a, b, c, d, e, f, g, h, W(0), k[t+0]); \
+	sha256_x8_round(h, a, b, c, d, e, f, g, W(1), k[t+1]); \
+	sha256_x8_round(g, h, a, b, c, d, e, f, W(2), k[t+2]); \
+	sha256_x8_round(f, g, h, a, b, c, d, e, W(3), k[t+3]); \
+	sha256_x8_round(e, f, g, h, a, b, c, d, W(4), k[t+4]); \
+	sha256_x8_round(d, e, f, g, h, a, b, c, W(5), k[t+5]); \
+	sha256_x8_round(c, d, e, f, g, h, a, b, W(6), k[t+6]); \
+	sha256_x8_round(b, c, d, e, f, g, h, a, W(7), k[t+7]); \
+	sha256_x8_round(a, b, c, d, e, f, g, h, W(8), k[t+8]); \
+	sha256_x8_round(h, a, b, c, d, e, f, g, W(9), k[t+9]); \
+	sha256_x8_round(g, h, a, b, c, d, e, f, W(10), k[t+10]); \
+	sha256_x8_round(f, g, h, a, b, c, d, e, W(11), k[t+11]); \
+	sha256_x8_round(e, f, g, h, a, b, c, d, W(12), k[t+12]); \
+	sha256_x8_round(d, e, f, g, h, a, b, c, W(13), k[t+13]); \
+	sha256_x8_round(c, d, e, f, g, h, a, b, W(14), k[t+14]); \
+	sha256_x8_round(b, c, d, e, f, g, h, a, W(15), k[t+15])
+#define DCS_DIGEST_DETAIL_SHA256_X8_LOAD_(i) w[i]
+#define DCS_DIGEST_DETAIL_SHA256_X8_SCHEDULE_(i) sha256_x8_schedule(w, i)
+
+	__m256i a(s[0]), b(s[1]), c(s[2]), d(s[3]), e(s[4]), f(s[5]), g(s[6]), h(s[7]);
+	int t(0);
+	DCS_DIGEST_DETAIL_SHA256_X8_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_X8_LOAD_);
+	for (t = 16; t < 64; t += 16)
+	{
+		DCS_DIGEST_DETAIL_SHA256_X8_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_X8_SCHEDULE_);
+	}
+
+#undef DCS_DIGEST_DETAIL_SHA256_X8_SCHEDULE_
+#undef DCS_DIGEST_DETAIL_SHA256_X8_LOAD_
+#undef DCS_DIGEST_DETAIL_SHA256_X8_ROUNDS16_
+
+	s[0] = _mm256_add_epi32(s[0], a);
+	s[1] = _mm256_add_epi32(s[1], b);
+	s[2] = _mm256_add_epi32(s[2], c);
+	s[3] = _mm256_add_epi32(s[3], d);
+	s[4] = _mm256_add_epi32(s[4], e);
+	s[5] = _mm256_add_epi32(s[5], f);
+	s[6] = _mm256_add_epi32(s[6], g);
+	s[7] = _mm256_add_epi32(s[7], h);
+	for (int i = 0; i < 8; ++i)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(state+8*i), s[i]);
+	}
+}
+
+}}} // Namespace dcs::digest::detail
+
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+
+
+#endif // DCS_DIGEST_DETAIL_SHA256_X86_HPP
@@ -50,6 +50,7 @@
 
 
 #include <algorithm>
+#include <boost/array.hpp>
 #include <boost/cstdint.hpp>
 #include <cstring>
 #include <cstddef>
@@ -242,6 +243,14 @@ class md5_algorithm
 		return digest();
 	}
 
+	/// Returns the digest in a fixed-size array, without allocating memory.
+	public: ::boost::array<byte_type,digest_size> digest_array() const
+	{
+		::boost::array<byte_type,digest_size> dig;
+		::std::memcpy(dig.data(), this->raw_digest(), digest_size);
+		return dig;
+	}
+
 	public: ::std::size_t digest_length() const
 	{
 		return digest_size;
@@ -0,0 +1,531 @@
+/**
+ * \file dcs/digest/sha256.hpp
+ *
+ * \brief The SHA-256 message digest algorithm.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DIGEST_SHA256_HPP
+#define DCS_DIGEST_SHA256_HPP
+
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/digest/commons.hpp>
+#include <dcs/digest/detail/bits.hpp>
+#include <dcs/digest/detail/sha256_x86.hpp>
+#include <dcs/digest/utility.hpp>
+#include <dcs/exception.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace digest {
+
+namespace detail {
+
+/// The implementations of the SHA-256 compression function.
+enum sha256_kernel_category
+{
+	scalar_sha256_kernel, ///< Portable code, one message at a time
+	shani_sha256_kernel, ///< SHA extensions, one message at a time
+	sse2_x4_sha256_kernel, ///< SSE2, 4 messages at a time
+	avx2_x8_sha256_kernel ///< AVX2, 8 messages at a time
+};
+
+inline ::boost::uint32_t const* sha256_round_constants()
+{
+	static const ::boost::uint32_t k[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	return k;
+}
+
+inline void sha256_init_state(::boost::uint32_t* state)
+{
+	state[0] = 0x6a09e667;
+	state[1] = 0xbb67ae85;
+	state[2] = 0x3c6ef372;
+	state[3] = 0xa54ff53a;
+	state[4] = 0x510e527f;
+	state[5] = 0x9b05688c;
+	state[6] = 0x1f83d9ab;
+	state[7] = 0x5be0cd19;
+}
+
+inline void sha256_round(::boost::uint32_t a, ::boost::uint32_t b, ::boost::uint32_t c, ::boost::uint32_t& d, ::boost::uint32_t e, ::boost::uint32_t f, ::boost::uint32_t g, ::boost::uint32_t& h, ::boost::uint32_t w, ::boost::uint32_t k)
+{
+	const ::boost::uint32_t t1(h+(rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25))+((e & f) ^ (~e & g))+k+w);
+	d += t1;
+	h = t1+(rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22))+((a & b) | (c & (a | b)));
+}
+
+/// Computes the message word for round 16+i of the current block, from the 16 previous words.
+inline ::boost::uint32_t sha256_schedule(::boost::uint32_t* w, int i)
+{
+	const ::boost::uint32_t w2(w[(i+14) & 15]);
+	const ::boost::uint32_t w15(w[(i+1) & 15]);
+	w[i] += (rotr32(w15, 7) ^ rotr32(w15, 18) ^ (w15 >> 3))
+			+ w[(i+9) & 15]
+			+ (rotr32(w2, 17) ^ rotr32(w2, 19) ^ (w2 >> 10));
+	return w[i];
+}
+
+/// Applies the compression function to \a n consecutive blocks.
+inline void sha256_compress_scalar(::boost::uint32_t* state, byte_type const* p, ::std::size_t n)
+{
+	::boost::uint32_t const* k(sha256_round_constants());
+
+	// Sixteen rounds, renaming the working variables instead of moving them
+#define DCS_DIGEST_DETAIL_SHA256_ROUNDS16_(W) \
+	sha256_round(a, b, c, d, e, f, g, h, W(0), k[t+0]); \
+	sha256_round(h, a, b, c, d, e, f, g, W(1), k[t+1]); \
+	sha256_round(g, h, a, b, c, d, e, f, W(2), k[t+2]); \
+	sha256_round(f, g, h, a, b, c, d, e, W(3), k[t+3]); \
+	sha256_round(e, f, g, h, a, b, c, d, W(4), k[t+4]); \
+	sha256_round(d, e, f, g, h, a, b, c, W(5), k[t+5]); \
+	sha256_round(c, d, e, f, g, h, a, b, W(6), k[t+6]); \
+	sha256_round(b, c, d, e, f, g, h, a, W(7), k[t+7]); \
+	sha256_round(a, b, c, d, e, f, g, h, W(8), k[t+8]); \
+	sha256_round(h, a, b, c, d, e, f, g, W(9), k[t+9]); \
+	sha256_round(g, h, a, b, c, d, e, f, W(10), k[t+10]); \
+	sha256_round(f, g, h, a, b, c, d, e, W(11), k[t+11]); \
+	sha256_round(e, f, g, h, a, b, c, d, W(12), k[t+12]); \
+	sha256_round(d, e, f, g, h, a, b, c, W(13), k[t+13]); \
+	sha256_round(c, d, e, f, g, h, a, b, W(14), k[t+14]); \
+	sha256_round(b, c, d, e, f, g, h, a, W(15), k[t+15])
+#define DCS_DIGEST_DETAIL_SHA256_LOAD_(i) w[i]
+#define DCS_DIGEST_DETAIL_SHA256_SCHEDULE_(i) sha256_schedule(w, i)
+
+	for (; n > 0; --n, p += 64)
+	{
+		::boost::uint32_t w[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			w[i] = load_be32(p+4*i);
+		}
+
+		::boost::uint32_t a(state[0]), b(state[1]), c(state[2]), d(state[3]);
+		::boost::uint32_t e(state[4]), f(state[5]), g(state[6]), h(state[7]);
+		int t(0);
+		DCS_DIGEST_DETAIL_SHA256_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_LOAD_);
+		for (t = 16; t < 64; t += 16)
+		{
+			DCS_DIGEST_DETAIL_SHA256_ROUNDS16_(DCS_DIGEST_DETAIL_SHA256_SCHEDULE_);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+
+#undef DCS_DIGEST_DETAIL_SHA256_SCHEDULE_
+#undef DCS_DIGEST_DETAIL_SHA256_LOAD_
+#undef DCS_DIGEST_DETAIL_SHA256_ROUNDS16_
+}
+
+/// Applies the compression function to \a n consecutive blocks of a message.
+inline void sha256_compress(::boost::uint32_t* state, byte_type const* p, ::std::size_t n, sha256_kernel_category kernel)
+{
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+	if (kernel == shani_sha256_kernel)
+	{
+		sha256_compress_shani(state, p, n, sha256_round_constants());
+		return;
+	}
+#else // DCS_DIGEST_DETAIL_SHA256_X86
+	(void) kernel;
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+	sha256_compress_scalar(state, p, n);
+}
+
+/// Returns the fastest kernel for a single message supported by the CPU.
+inline sha256_kernel_category sha256_detect_kernel()
+{
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+	if (sha256_x86_has_sha())
+	{
+		return shani_sha256_kernel;
+	}
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+	return scalar_sha256_kernel;
+}
+
+/**
+ * Returns the fastest kernel for many messages supported by the CPU.
+ *
+ * The SHA extensions are preferred to multi-buffer kernels, since they are
+ * at least as fast as 8 AVX2 lanes, even on short messages.
+ */
+inline sha256_kernel_category sha256_detect_many_kernel()
+{
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+	if (sha256_x86_has_sha())
+	{
+		return shani_sha256_kernel;
+	}
+	if (sha256_x86_has_avx2())
+	{
+		return avx2_x8_sha256_kernel;
+	}
+	return sse2_x4_sha256_kernel;
+#else // DCS_DIGEST_DETAIL_SHA256_X86
+	return scalar_sha256_kernel;
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+}
+
+/// Returns the kernel used by default for a single message, which is detected only once.
+inline sha256_kernel_category sha256_default_kernel()
+{
+	static const sha256_kernel_category kernel(sha256_detect_kernel());
+
+	return kernel;
+}
+
+/// Returns the kernel used by default for many messages, which is detected only once.
+inline sha256_kernel_category sha256_default_many_kernel()
+{
+	static const sha256_kernel_category kernel(sha256_detect_many_kernel());
+
+	return kernel;
+}
+
+/**
+ * Builds the padded last block(s) of a message of \a len bytes, whose
+ * incomplete block starts at \a p.
+ * Returns the number of blocks (1 or 2) stored in \a tail.
+ */
+inline ::std::size_t sha256_make_tail(byte_type const* p, ::boost::uint64_t len, byte_type* tail)
+{
+	const ::std::size_t rem(static_cast< ::std::size_t >(len % 64));
+	const ::std::size_t n(rem < 56 ? 1 : 2);
+
+	if (rem > 0)
+	{
+		::std::memcpy(tail, p, rem);
+	}
+	tail[rem] = 0x80;
+	::std::memset(tail+rem+1, 0, n*64-rem-1-8);
+	store_be64(tail+n*64-8, len*8);
+
+	return n;
+}
+
+inline void sha256_store_digest(::boost::uint32_t const* state, ::std::size_t stride, byte_type* out)
+{
+	for (::std::size_t i = 0; i < 8; ++i)
+	{
+		store_be32(out+4*i, state[i*stride]);
+	}
+}
+
+/**
+ * Hashes \a n messages with a multi-buffer kernel of \a W lanes.
+ *
+ * Each lane hashes a message block by block; when a message ends, the lane
+ * is given the next one.
+ * Idle lanes, once all the messages are assigned, hash a dummy block.
+ */
+template < ::std::size_t W, typename CompressT>
+void sha256_digest_lanes(byte_type const* const* data, ::std::size_t const* lens, ::std::size_t n, byte_type* out, CompressT compress)
+{
+	::boost::uint32_t state[8*W];
+	byte_type const* blocks[W];
+	byte_type tails[W][128];
+	static const byte_type dummy[64] = {0};
+
+	::std::size_t msg[W]; // The message hashed by each lane (n if idle)
+	::std::size_t nfull[W]; // The number of complete blocks of the message
+	::std::size_t ntotal[W]; // The total number of blocks, including padding
+	::std::size_t cur[W]; // The next block to hash
+
+	::std::size_t next(0);
+	::std::size_t nactive(0);
+	for (::std::size_t l = 0; l < W; ++l)
+	{
+		msg[l] = n;
+	}
+
+	while (true)
+	{
+		for (::std::size_t l = 0; l < W; ++l)
+		{
+			if (msg[l] == n && next < n)
+			{
+				::boost::uint32_t init[8];
+				sha256_init_state(init);
+				for (::std::size_t i = 0; i < 8; ++i)
+				{
+					state[i*W+l] = init[i];
+				}
+				msg[l] = next;
+				nfull[l] = lens[next]/64;
+				ntotal[l] = nfull[l]+sha256_make_tail(data[next]+nfull[l]*64, lens[next], tails[l]);
+				cur[l] = 0;
+				++next;
+				++nactive;
+			}
+		}
+		if (nactive == 0)
+		{
+			break;
+		}
+
+		for (::std::size_t l = 0; l < W; ++l)
+		{
+			if (msg[l] == n)
+			{
+				blocks[l] = dummy;
+			}
+			else if (cur[l] < nfull[l])
+			{
+				blocks[l] = data[msg[l]]+cur[l]*64;
+			}
+			else
+			{
+				blocks[l] = tails[l]+(cur[l]-nfull[l])*64;
+			}
+		}
+
+		compress(state, blocks, sha256_round_constants());
+
+		for (::std::size_t l = 0; l < W; ++l)
+		{
+			if (msg[l] != n && ++cur[l] == ntotal[l])
+			{
+				sha256_store_digest(state+l, W, out+32*msg[l]);
+				msg[l] = n;
+				--nactive;
+			}
+		}
+	}
+}
+
+} // Namespace detail
+
+
+/**
+ * The SHA-256 message digest algorithm.
+ *
+ * See FIPS 180-4 (http://csrc.nist.gov/publications/fips/fips180-4/fips-180-4.pdf)
+ *
+ * The compression function uses the SHA extensions of x86 CPUs, when
+ * available.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class sha256_algorithm
+{
+	private: typedef ::boost::uint32_t uint32_type;
+	private: typedef ::boost::uint64_t uint64_type;
+
+
+	public: static const ::std::size_t digest_size = 32; ///< The size of digest buffer (in bytes)
+	private: static const ::std::size_t block_size = 64;
+
+
+	public: sha256_algorithm()
+	: kernel_(detail::sha256_default_kernel())
+	{
+		this->reset();
+	}
+
+	public: void reset()
+	{
+		detail::sha256_init_state(state_);
+		total_len_ = 0;
+		buffer_len_ = 0;
+		finalized_ = false;
+	}
+
+	public: void update(byte_type const* input, ::std::size_t len)
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot update an already finalized digest"));
+
+		if (len == 0)
+		{
+			// Nothing to do (and input may be null)
+			return;
+		}
+
+		total_len_ += len;
+
+		if (buffer_len_ > 0)
+		{
+			const ::std::size_t n(len < (block_size-buffer_len_) ? len : (block_size-buffer_len_));
+			::std::memcpy(buffer_+buffer_len_, input, n);
+			buffer_len_ += n;
+			input += n;
+			len -= n;
+			if (buffer_len_ < block_size)
+			{
+				return;
+			}
+			detail::sha256_compress(state_, buffer_, 1, kernel_);
+			buffer_len_ = 0;
+		}
+
+		const ::std::size_t nblocks(len/block_size);
+		detail::sha256_compress(state_, input, nblocks, kernel_);
+
+		buffer_len_ = len-nblocks*block_size;
+		::std::memcpy(buffer_, input+nblocks*block_size, buffer_len_);
+	}
+
+	public: void update(char const* input, ::std::size_t len)
+	{
+		update(reinterpret_cast<byte_type const*>(input), len);
+	}
+
+	public: void finish()
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot finalize an already finalized digest"));
+
+		byte_type tail[2*block_size];
+		const ::std::size_t n(detail::sha256_make_tail(buffer_, total_len_, tail));
+		detail::sha256_compress(state_, tail, n, kernel_);
+		detail::sha256_store_digest(state_, 1, digest_);
+
+		finalized_ = true;
+	}
+
+	public: ::std::vector<byte_type> digest() const
+	{
+		return ::std::vector<byte_type>(this->raw_digest(), this->raw_digest()+digest_size);
+	}
+
+	public: ::std::vector<byte_type> digest(byte_type const* data, ::std::size_t len)
+	{
+		reset();
+		update(data, len);
+		finish();
+
+		return digest();
+	}
+
+	public: ::std::vector<byte_type> digest(::std::string const& s)
+	{
+		return digest(reinterpret_cast<byte_type const*>(s.data()), s.length());
+	}
+
+	/// Returns the digest in a fixed-size array.
+	public: ::boost::array<byte_type,digest_size> digest_array() const
+	{
+		::boost::array<byte_type,digest_size> dig;
+		::std::memcpy(dig.data(), this->raw_digest(), digest_size);
+		return dig;
+	}
+
+	public: ::std::size_t digest_length() const
+	{
+		return digest_size;
+	}
+
+	public: byte_type const* raw_digest() const
+	{
+		// pre: digest already finalized
+		DCS_ASSERT(finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Digest computation has not been finalized"));
+
+		return digest_;
+	}
+
+
+	private: detail::sha256_kernel_category kernel_;
+	private: uint32_type state_[8];
+	private: uint64_type total_len_;
+	private: byte_type buffer_[block_size];
+	private: ::std::size_t buffer_len_;
+	private: byte_type digest_[digest_size];
+	private: bool finalized_;
+}; // sha256_algorithm
+
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, sha256_algorithm const& sha)
+{
+	os << hex_string(sha.digest());
+
+	return os;
+}
+
+/**
+ * Computes the SHA-256 digests of \a n independent messages.
+ *
+ * The i-th message starts at \a data[i] and has \a lens[i] bytes; its digest
+ * is stored at \a out+32*i.
+ * Without SHA extensions, messages are hashed 4 or 8 at a time, in the lanes
+ * of SSE2 or AVX2 registers.
+ */
+inline void sha256_digest_many(byte_type const* const* data, ::std::size_t const* lens, ::std::size_t n, byte_type* out, detail::sha256_kernel_category kernel = detail::sha256_default_many_kernel())
+{
+	switch (kernel)
+	{
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+		case detail::avx2_x8_sha256_kernel:
+			detail::sha256_digest_lanes<8>(data, lens, n, out, detail::sha256_compress_x8_avx2);
+			break;
+		case detail::sse2_x4_sha256_kernel:
+			detail::sha256_digest_lanes<4>(data, lens, n, out, detail::sha256_compress_x4_sse2);
+			break;
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+		default:
+			for (::std::size_t i = 0; i < n; ++i)
+			{
+				::boost::uint32_t state[8];
+				byte_type tail[128];
+				const ::std::size_t nfull(lens[i]/64);
+				detail::sha256_init_state(state);
+				detail::sha256_compress(state, data[i], nfull, kernel);
+				detail::sha256_compress(state, tail, detail::sha256_make_tail(data[i]+nfull*64, lens[i], tail), kernel);
+				detail::sha256_store_digest(state, 1, out+32*i);
+			}
+			break;
+	}
+}
+
+}} // Namespace dcs::digest
+
+#endif // DCS_DIGEST_SHA256_HPP
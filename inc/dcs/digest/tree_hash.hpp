@@ -0,0 +1,537 @@
+/**
+ * \file dcs/digest/tree_hash.hpp
+ *
+ * \brief Parallel and incremental Merkle tree hashing of large data.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DIGEST_TREE_HASH_HPP
+#define DCS_DIGEST_TREE_HASH_HPP
+
+
+#include <algorithm>
+#include <boost/array.hpp>
+#include <boost/atomic.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/digest/commons.hpp>
+#include <dcs/digest/utility.hpp>
+#include <dcs/exception.hpp>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace dcs { namespace digest {
+
+namespace detail {
+
+/// A read-only memory mapping of a whole file.
+class mapped_file: private ::boost::noncopyable
+{
+	public: explicit mapped_file(::std::string const& path)
+	: data_(0),
+	  size_(0)
+	{
+		const int fd(::open(path.c_str(), O_RDONLY));
+		if (fd == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to open(2) failed for file '" << path << "': " << ::strerror(errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		struct ::stat st;
+		if (::fstat(fd, &st) == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to fstat(2) failed for file '" << path << "': " << ::strerror(errno);
+			::close(fd);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		size_ = static_cast< ::std::size_t >(st.st_size);
+		if (size_ > 0)
+		{
+			void* p(::mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0));
+			if (p == MAP_FAILED)
+			{
+				::std::ostringstream oss;
+				oss << "Call to mmap(2) failed for file '" << path << "': " << ::strerror(errno);
+				::close(fd);
+
+				DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+			}
+			data_ = static_cast<byte_type const*>(p);
+
+			// Chunks are read by several threads at once: ask the kernel to
+			// start reading the whole file rather than relying on sequential
+			// read-ahead (the advice is only a hint, so errors are ignored)
+			::madvise(p, size_, MADV_WILLNEED);
+		}
+		::close(fd);
+	}
+
+	public: ~mapped_file()
+	{
+		if (data_)
+		{
+			::munmap(const_cast<byte_type*>(data_), size_);
+		}
+	}
+
+	public: byte_type const* data() const
+	{
+		return data_;
+	}
+
+	public: ::std::size_t size() const
+	{
+		return size_;
+	}
+
+
+	private: byte_type const* data_;
+	private: ::std::size_t size_;
+}; // mapped_file
+
+} // Namespace detail
+
+
+/**
+ * Merkle tree hashing of large data over a base message digest algorithm.
+ *
+ * Data are split into chunks of fixed size (but the last one), which are the
+ * leaves of a binary tree.
+ * The digest of a leaf is the digest of the byte 0x00 followed by the chunk,
+ * while the digest of an inner node is the digest of the byte 0x01 followed
+ * by the digests of its two children.
+ * Nodes are paired level by level, from left to right, and the last node of
+ * a level with an odd number of nodes is promoted unchanged to the next
+ * level; the resulting tree is the one of RFC 6962 (Certificate
+ * Transparency).
+ * Empty data have a single, empty chunk.
+ *
+ * Chunks, and the nodes of large levels, are hashed by several threads.
+ * Files are read through a memory mapping rather than through streams.
+ *
+ * All the digests of the tree are kept, so that, after some chunks are
+ * modified, only those chunks and their ancestors are hashed again (see
+ * invalidate() and rehash()).
+ *
+ * \tparam HashT The base message digest algorithm (e.g., md5_algorithm or
+ *  sha256_algorithm).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename HashT>
+class tree_hash
+{
+	public: typedef HashT hash_type;
+
+
+	public: static const ::std::size_t digest_size = hash_type::digest_size; ///< The size of digest buffer (in bytes)
+	public: static const ::std::size_t default_chunk_size = 1 << 20;
+	private: static const ::std::size_t node_grain = 512; ///< The minimum number of inner nodes per thread
+
+
+	/**
+	 * Creates a tree hash with the given chunk size, which uses up to
+	 * \a num_threads threads (the hardware concurrency, if zero).
+	 */
+	public: explicit tree_hash(::std::size_t chunk_size = default_chunk_size, ::std::size_t num_threads = 0)
+	: chunk_size_(chunk_size),
+	  num_threads_(num_threads),
+	  len_(0),
+	  hashed_(false),
+	  num_rehashed_(0)
+	{
+		// pre: chunk_size > 0
+		DCS_ASSERT(chunk_size_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Chunk size must be positive"));
+
+		if (num_threads_ == 0)
+		{
+			num_threads_ = ::std::max(1u, ::boost::thread::hardware_concurrency());
+		}
+	}
+
+	public: ::std::size_t chunk_size() const
+	{
+		return chunk_size_;
+	}
+
+	public: ::std::size_t num_threads() const
+	{
+		return num_threads_;
+	}
+
+	/// Hashes all the chunks of the given data.
+	public: void hash(byte_type const* data, ::std::size_t len)
+	{
+		hashed_ = false;
+
+		this->rehash(data, len);
+	}
+
+	/// Hashes all the chunks of the given file.
+	public: void hash_file(::std::string const& path)
+	{
+		const detail::mapped_file file(path);
+
+		this->hash(file.data(), file.size());
+	}
+
+	/**
+	 * Marks as modified the chunks overlapping the \a len bytes starting at
+	 * \a offset, so that the next rehash() hashes them again.
+	 *
+	 * Chunks past the end of the data hashed so far are ignored, since
+	 * rehash() handles changes in data length by itself.
+	 */
+	public: void invalidate(::std::size_t offset, ::std::size_t len)
+	{
+		if (len == 0)
+		{
+			return;
+		}
+
+		const ::std::size_t first(offset/chunk_size_);
+		const ::std::size_t last(::std::min((offset+len-1)/chunk_size_+1, dirty_.size()));
+		for (::std::size_t i = first; i < last; ++i)
+		{
+			dirty_[i] = true;
+		}
+	}
+
+	/**
+	 * Hashes again the chunks marked as modified by invalidate() and the ones
+	 * affected by a change in data length, and updates their ancestors.
+	 *
+	 * If nothing has been hashed yet, all the chunks are hashed.
+	 */
+	public: void rehash(byte_type const* data, ::std::size_t len)
+	{
+		static const byte_type empty = 0;
+		if (len == 0)
+		{
+			data = &empty;
+		}
+
+		const ::std::size_t n(len > 0 ? (len-1)/chunk_size_+1 : 1);
+
+		// If hashing fails midway, everything is hashed again next time
+		const bool full(!hashed_);
+		hashed_ = false;
+
+		if (full)
+		{
+			dirty_.assign(n, true);
+			levels_.clear();
+			sizes_.clear();
+		}
+		else if (len != len_)
+		{
+			// The chunk where the shortest data end may have changed, as well
+			// as all the chunks that follow
+			dirty_.resize(n, true);
+			for (::std::size_t i = ::std::min(len, len_)/chunk_size_; i < n; ++i)
+			{
+				dirty_[i] = true;
+			}
+		}
+
+		// Resize levels, remembering the old sizes
+		::std::vector< ::std::size_t > old_sizes(sizes_);
+		sizes_.assign(1, n);
+		while (sizes_.back() > 1)
+		{
+			sizes_.push_back((sizes_.back()+1)/2);
+		}
+		levels_.resize(sizes_.size());
+		old_sizes.resize(sizes_.size(), 0);
+		for (::std::size_t l = 0; l < levels_.size(); ++l)
+		{
+			levels_[l].resize(sizes_[l]*digest_size);
+		}
+
+		len_ = len;
+
+		// Hash the modified chunks
+		::std::vector< ::std::size_t > work;
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			if (dirty_[i])
+			{
+				work.push_back(i);
+				dirty_[i] = false;
+			}
+		}
+		num_rehashed_ = work.size();
+		this->run(0, work, data, 1);
+
+		// Hash their ancestors, level by level, and the last node of the
+		// levels whose children changed in number (whose last node may have
+		// lost or gained a sibling)
+		for (::std::size_t l = 1; l < sizes_.size(); ++l)
+		{
+			::std::vector< ::std::size_t > parents;
+			parents.reserve(work.size()+1);
+			for (::std::size_t i = 0; i < work.size(); ++i)
+			{
+				if (parents.empty() || parents.back() != work[i]/2)
+				{
+					parents.push_back(work[i]/2);
+				}
+			}
+			if (old_sizes[l-1] != sizes_[l-1] && (parents.empty() || parents.back() != sizes_[l]-1))
+			{
+				parents.push_back(sizes_[l]-1);
+			}
+			work.swap(parents);
+
+			this->run(l, work, data, node_grain);
+		}
+
+		hashed_ = true;
+	}
+
+	/// Hashes again the modified chunks of the given file (see rehash()).
+	public: void rehash_file(::std::string const& path)
+	{
+		const detail::mapped_file file(path);
+
+		this->rehash(file.data(), file.size());
+	}
+
+	/// Returns the number of chunks of the data hashed so far.
+	public: ::std::size_t num_chunks() const
+	{
+		return sizes_.empty() ? 0 : sizes_[0];
+	}
+
+	/// Returns the number of chunks hashed by the last call to hash() or rehash().
+	public: ::std::size_t num_rehashed_chunks() const
+	{
+		return num_rehashed_;
+	}
+
+	/// Returns the digest of the given chunk (i.e., of a leaf of the tree).
+	public: byte_type const* chunk_digest(::std::size_t i) const
+	{
+		// pre: i < num_chunks()
+		DCS_ASSERT(i < this->num_chunks(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Chunk index out of range"));
+
+		return &levels_[0][i*digest_size];
+	}
+
+	public: ::std::vector<byte_type> digest() const
+	{
+		return ::std::vector<byte_type>(this->raw_digest(), this->raw_digest()+digest_size);
+	}
+
+	/// Returns the digest in a fixed-size array.
+	public: ::boost::array<byte_type,digest_size> digest_array() const
+	{
+		::boost::array<byte_type,digest_size> dig;
+		::std::memcpy(dig.data(), this->raw_digest(), digest_size);
+		return dig;
+	}
+
+	public: ::std::size_t digest_length() const
+	{
+		return digest_size;
+	}
+
+	/// Returns the digest of the root of the tree.
+	public: byte_type const* raw_digest() const
+	{
+		// pre: something has been hashed
+		DCS_ASSERT(hashed_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Nothing has been hashed yet"));
+
+		return &levels_.back()[0];
+	}
+
+	/// Computes the digest of node \a i of level \a l.
+	private: void hash_node(::std::size_t l, ::std::size_t i, byte_type const* data, hash_type& h)
+	{
+		byte_type* out(&levels_[l][i*digest_size]);
+
+		if (l == 0)
+		{
+			const byte_type prefix(0x00);
+			const ::std::size_t off(i*chunk_size_);
+
+			h.reset();
+			h.update(&prefix, 1);
+			h.update(data+off, ::std::min(chunk_size_, len_-::std::min(off, len_)));
+			h.finish();
+			::std::memcpy(out, h.raw_digest(), digest_size);
+		}
+		else if ((2*i+1) < sizes_[l-1])
+		{
+			const byte_type prefix(0x01);
+
+			h.reset();
+			h.update(&prefix, 1);
+			h.update(&levels_[l-1][2*i*digest_size], 2*digest_size);
+			h.finish();
+			::std::memcpy(out, h.raw_digest(), digest_size);
+		}
+		else
+		{
+			::std::memcpy(out, &levels_[l-1][2*i*digest_size], digest_size);
+		}
+	}
+
+	/// Hashes the nodes of level \a l listed in \a work, with at most one
+	/// thread every \a grain nodes.
+	private: void run(::std::size_t l, ::std::vector< ::std::size_t > const& work, byte_type const* data, ::std::size_t grain)
+	{
+		const ::std::size_t nt(::std::min(num_threads_, (work.size()+grain-1)/grain));
+
+		if (nt <= 1)
+		{
+			hash_type h;
+			for (::std::size_t i = 0; i < work.size(); ++i)
+			{
+				this->hash_node(l, work[i], data, h);
+			}
+			return;
+		}
+
+		// Nodes are handed out one at a time, to balance the load among
+		// threads when some chunks are not in memory yet
+		::boost::atomic< ::std::size_t > next(0);
+		::std::vector< ::boost::exception_ptr > excs(nt);
+		::boost::thread_group workers;
+		for (::std::size_t t = 0; t < nt; ++t)
+		{
+			worker w(this, l, &work, data, &next, &excs[t]);
+
+			if ((t+1) < nt)
+			{
+				workers.create_thread(w);
+			}
+			else
+			{
+				w();
+			}
+		}
+		workers.join_all();
+
+		for (::std::size_t t = 0; t < nt; ++t)
+		{
+			if (excs[t])
+			{
+				::boost::rethrow_exception(excs[t]);
+			}
+		}
+	}
+
+
+	/// Hashes the nodes of a level, until there are no more.
+	private: struct worker
+	{
+		worker(tree_hash* p_tree, ::std::size_t level, ::std::vector< ::std::size_t > const* p_work, byte_type const* data, ::boost::atomic< ::std::size_t >* p_next, ::boost::exception_ptr* p_exc)
+		: p_tree(p_tree),
+		  level(level),
+		  p_work(p_work),
+		  data(data),
+		  p_next(p_next),
+		  p_exc(p_exc)
+		{
+		}
+
+		void operator()()
+		{
+			try
+			{
+				hash_type h;
+				::std::size_t i;
+				while ((i = p_next->fetch_add(1, ::boost::memory_order_relaxed)) < p_work->size())
+				{
+					p_tree->hash_node(level, (*p_work)[i], data, h);
+				}
+			}
+			catch (...)
+			{
+				*p_exc = ::boost::current_exception();
+			}
+		}
+
+		tree_hash* p_tree;
+		::std::size_t level;
+		::std::vector< ::std::size_t > const* p_work;
+		byte_type const* data;
+		::boost::atomic< ::std::size_t >* p_next;
+		::boost::exception_ptr* p_exc; ///< Where to store the exception thrown by the worker, if any
+	}; // worker
+
+	private: friend struct worker;
+
+
+	private: ::std::size_t chunk_size_;
+	private: ::std::size_t num_threads_;
+	private: ::std::size_t len_; ///< The length of the data hashed so far
+	private: bool hashed_;
+	private: ::std::size_t num_rehashed_;
+	private: ::std::vector<bool> dirty_; ///< Whether each chunk must be hashed again
+	private: ::std::vector< ::std::size_t > sizes_; ///< The number of nodes of each level (leaves first)
+	private: ::std::vector< ::std::vector<byte_type> > levels_; ///< The digests of the nodes of each level
+}; // tree_hash
+
+template <typename HashT>
+const ::std::size_t tree_hash<HashT>::digest_size;
+
+template <typename HashT>
+const ::std::size_t tree_hash<HashT>::default_chunk_size;
+
+
+template <typename CharT, typename CharTraitsT, typename HashT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, tree_hash<HashT> const& th)
+{
+	os << hex_string(th.digest());
+
+	return os;
+}
+
+}} // Namespace dcs::digest
+
+#endif // DCS_DIGEST_TREE_HASH_HPP
@@ -0,0 +1,805 @@
+/**
+ * \file dcs/digest/xxhash.hpp
+ *
+ * \brief The XXH64 and XXH3 (64-bit) non-cryptographic hash functions.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_DIGEST_XXHASH_HPP
+#define DCS_DIGEST_XXHASH_HPP
+
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/digest/commons.hpp>
+#include <dcs/digest/detail/bits.hpp>
+#include <dcs/digest/utility.hpp>
+#include <dcs/exception.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif // __SSE2__
+
+
+namespace dcs { namespace digest {
+
+namespace detail {
+
+#define DCS_DIGEST_DETAIL_XXH_PRIME32_1_ 0x9E3779B1U
+#define DCS_DIGEST_DETAIL_XXH_PRIME32_2_ 0x85EBCA77U
+#define DCS_DIGEST_DETAIL_XXH_PRIME32_3_ 0xC2B2AE3DU
+#define DCS_DIGEST_DETAIL_XXH_PRIME64_1_ DCS_DIGEST_DETAIL_UINT64_(0x9E3779B1U, 0x85EBCA87U)
+#define DCS_DIGEST_DETAIL_XXH_PRIME64_2_ DCS_DIGEST_DETAIL_UINT64_(0xC2B2AE3DU, 0x27D4EB4FU)
+#define DCS_DIGEST_DETAIL_XXH_PRIME64_3_ DCS_DIGEST_DETAIL_UINT64_(0x165667B1U, 0x9E3779F9U)
+#define DCS_DIGEST_DETAIL_XXH_PRIME64_4_ DCS_DIGEST_DETAIL_UINT64_(0x85EBCA77U, 0xC2B2AE63U)
+#define DCS_DIGEST_DETAIL_XXH_PRIME64_5_ DCS_DIGEST_DETAIL_UINT64_(0x27D4EB2FU, 0x165667C5U)
+
+inline ::boost::uint64_t xxh64_round(::boost::uint64_t acc, ::boost::uint64_t input)
+{
+	acc += input*DCS_DIGEST_DETAIL_XXH_PRIME64_2_;
+	acc = rotl64(acc, 31);
+	return acc*DCS_DIGEST_DETAIL_XXH_PRIME64_1_;
+}
+
+inline ::boost::uint64_t xxh64_merge_round(::boost::uint64_t acc, ::boost::uint64_t val)
+{
+	acc ^= xxh64_round(0, val);
+	return acc*DCS_DIGEST_DETAIL_XXH_PRIME64_1_+DCS_DIGEST_DETAIL_XXH_PRIME64_4_;
+}
+
+inline ::boost::uint64_t xxh64_avalanche(::boost::uint64_t h)
+{
+	h ^= h >> 33;
+	h *= DCS_DIGEST_DETAIL_XXH_PRIME64_2_;
+	h ^= h >> 29;
+	h *= DCS_DIGEST_DETAIL_XXH_PRIME64_3_;
+	h ^= h >> 32;
+	return h;
+}
+
+/// Mixes the last \a len (< 32) bytes of the input into \a h.
+inline ::boost::uint64_t xxh64_finalize(::boost::uint64_t h, byte_type const* p, ::std::size_t len)
+{
+	for (; len >= 8; len -= 8, p += 8)
+	{
+		h ^= xxh64_round(0, load_le64(p));
+		h = rotl64(h, 27)*DCS_DIGEST_DETAIL_XXH_PRIME64_1_+DCS_DIGEST_DETAIL_XXH_PRIME64_4_;
+	}
+	if (len >= 4)
+	{
+		h ^= static_cast< ::boost::uint64_t >(load_le32(p))*DCS_DIGEST_DETAIL_XXH_PRIME64_1_;
+		h = rotl64(h, 23)*DCS_DIGEST_DETAIL_XXH_PRIME64_2_+DCS_DIGEST_DETAIL_XXH_PRIME64_3_;
+		len -= 4;
+		p += 4;
+	}
+	for (; len > 0; --len, ++p)
+	{
+		h ^= (*p)*DCS_DIGEST_DETAIL_XXH_PRIME64_5_;
+		h = rotl64(h, 11)*DCS_DIGEST_DETAIL_XXH_PRIME64_1_;
+	}
+	return xxh64_avalanche(h);
+}
+
+
+static const ::std::size_t xxh3_secret_size = 192;
+static const ::std::size_t xxh3_stripe_len = 64;
+static const ::std::size_t xxh3_secret_consume_rate = 8;
+static const ::std::size_t xxh3_acc_size = 8;
+static const ::std::size_t xxh3_midsize_max = 240;
+static const ::std::size_t xxh3_secret_lastacc_start = 7;
+static const ::std::size_t xxh3_secret_mergeaccs_start = 11;
+static const ::std::size_t xxh3_stripes_per_block = (xxh3_secret_size-xxh3_stripe_len)/xxh3_secret_consume_rate;
+
+/// The default secret of XXH3.
+inline byte_type const* xxh3_default_secret()
+{
+	static const byte_type secret[xxh3_secret_size] = {
+		0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+		0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+		0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+		0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+		0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+		0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+		0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+		0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+		0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+		0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+		0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+		0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+	};
+
+	return secret;
+}
+
+/// Derives the secret used for long inputs from a non-zero seed.
+inline void xxh3_init_custom_secret(byte_type* secret, ::boost::uint64_t seed)
+{
+	byte_type const* k(xxh3_default_secret());
+
+	for (::std::size_t i = 0; i < xxh3_secret_size; i += 16)
+	{
+		store_le64(secret+i, load_le64(k+i)+seed);
+		store_le64(secret+i+8, load_le64(k+i+8)-seed);
+	}
+}
+
+inline void xxh3_init_acc(::boost::uint64_t* acc)
+{
+	acc[0] = DCS_DIGEST_DETAIL_XXH_PRIME32_3_;
+	acc[1] = DCS_DIGEST_DETAIL_XXH_PRIME64_1_;
+	acc[2] = DCS_DIGEST_DETAIL_XXH_PRIME64_2_;
+	acc[3] = DCS_DIGEST_DETAIL_XXH_PRIME64_3_;
+	acc[4] = DCS_DIGEST_DETAIL_XXH_PRIME64_4_;
+	acc[5] = DCS_DIGEST_DETAIL_XXH_PRIME32_2_;
+	acc[6] = DCS_DIGEST_DETAIL_XXH_PRIME64_5_;
+	acc[7] = DCS_DIGEST_DETAIL_XXH_PRIME32_1_;
+}
+
+inline ::boost::uint64_t xxh3_avalanche(::boost::uint64_t h)
+{
+	h ^= h >> 37;
+	h *= DCS_DIGEST_DETAIL_UINT64_(0x16566791U, 0x9E3779F9U);
+	h ^= h >> 32;
+	return h;
+}
+
+inline ::boost::uint64_t xxh3_rrmxmx(::boost::uint64_t h, ::boost::uint64_t len)
+{
+	const ::boost::uint64_t prime(DCS_DIGEST_DETAIL_UINT64_(0x9FB21C65U, 0x1E98DF25U));
+
+	h ^= rotl64(h, 49) ^ rotl64(h, 24);
+	h *= prime;
+	h ^= (h >> 35)+len;
+	h *= prime;
+	return h ^ (h >> 28);
+}
+
+inline ::boost::uint64_t xxh3_mix16(byte_type const* p, byte_type const* secret, ::boost::uint64_t seed)
+{
+	return mul128_fold64(load_le64(p) ^ (load_le64(secret)+seed),
+						 load_le64(p+8) ^ (load_le64(secret+8)-seed));
+}
+
+/// Hashes inputs of at most 240 bytes.
+inline ::boost::uint64_t xxh3_hash_short(byte_type const* p, ::std::size_t len, byte_type const* secret, ::boost::uint64_t seed)
+{
+	if (len > 128)
+	{
+		::boost::uint64_t acc(len*DCS_DIGEST_DETAIL_XXH_PRIME64_1_);
+		for (::std::size_t i = 0; i < 8; ++i)
+		{
+			acc += xxh3_mix16(p+16*i, secret+16*i, seed);
+		}
+		acc = xxh3_avalanche(acc);
+
+		// The secret has at least 136 bytes
+		::boost::uint64_t acc_end(xxh3_mix16(p+len-16, secret+136-17, seed));
+		const ::std::size_t nrounds(len/16);
+		for (::std::size_t i = 8; i < nrounds; ++i)
+		{
+			acc_end += xxh3_mix16(p+16*i, secret+16*(i-8)+3, seed);
+		}
+		return xxh3_avalanche(acc+acc_end);
+	}
+	if (len > 16)
+	{
+		::boost::uint64_t acc(len*DCS_DIGEST_DETAIL_XXH_PRIME64_1_);
+		if (len > 32)
+		{
+			if (len > 64)
+			{
+				if (len > 96)
+				{
+					acc += xxh3_mix16(p+48, secret+96, seed);
+					acc += xxh3_mix16(p+len-64, secret+112, seed);
+				}
+				acc += xxh3_mix16(p+32, secret+64, seed);
+				acc += xxh3_mix16(p+len-48, secret+80, seed);
+			}
+			acc += xxh3_mix16(p+16, secret+32, seed);
+			acc += xxh3_mix16(p+len-32, secret+48, seed);
+		}
+		acc += xxh3_mix16(p, secret, seed);
+		acc += xxh3_mix16(p+len-16, secret+16, seed);
+		return xxh3_avalanche(acc);
+	}
+	if (len > 8)
+	{
+		const ::boost::uint64_t lo(load_le64(p) ^ ((load_le64(secret+24) ^ load_le64(secret+32))+seed));
+		const ::boost::uint64_t hi(load_le64(p+len-8) ^ ((load_le64(secret+40) ^ load_le64(secret+48))-seed));
+		return xxh3_avalanche(len+byte_swap64(lo)+hi+mul128_fold64(lo, hi));
+	}
+	if (len >= 4)
+	{
+		seed ^= static_cast< ::boost::uint64_t >(byte_swap32(static_cast< ::boost::uint32_t >(seed))) << 32;
+		const ::boost::uint64_t input((static_cast< ::boost::uint64_t >(load_le32(p)) << 32)+load_le32(p+len-4));
+		const ::boost::uint64_t bitflip((load_le64(secret+8) ^ load_le64(secret+16))-seed);
+		return xxh3_rrmxmx(input ^ bitflip, len);
+	}
+	if (len > 0)
+	{
+		const ::boost::uint32_t combined((static_cast< ::boost::uint32_t >(p[0]) << 16)
+										 | (static_cast< ::boost::uint32_t >(p[len >> 1]) << 24)
+										 | static_cast< ::boost::uint32_t >(p[len-1])
+										 | (static_cast< ::boost::uint32_t >(len) << 8));
+		const ::boost::uint64_t bitflip((load_le32(secret) ^ load_le32(secret+4))+seed);
+		return xxh64_avalanche(combined ^ bitflip);
+	}
+	return xxh64_avalanche(seed ^ (load_le64(secret+56) ^ load_le64(secret+64)));
+}
+
+/// Accumulates a 64-byte stripe.
+inline void xxh3_accumulate_stripe(::boost::uint64_t* acc, byte_type const* p, byte_type const* secret)
+{
+#ifdef __SSE2__
+	// Two accumulators per vector, as in the reference implementation
+	for (::std::size_t i = 0; i < xxh3_acc_size/2; ++i)
+	{
+		__m128i* pacc(reinterpret_cast<__m128i*>(acc)+i);
+		const __m128i val(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)+i));
+		const __m128i key(_mm_xor_si128(val, _mm_loadu_si128(reinterpret_cast<__m128i const*>(secret)+i)));
+		const __m128i prod(_mm_mul_epu32(key, _mm_shuffle_epi32(key, 0x31)));
+		_mm_storeu_si128(pacc, _mm_add_epi64(_mm_add_epi64(_mm_loadu_si128(pacc), _mm_shuffle_epi32(val, 0x4e)), prod));
+	}
+#else // __SSE2__
+	for (::std::size_t i = 0; i < xxh3_acc_size; ++i)
+	{
+		const ::boost::uint64_t val(load_le64(p+8*i));
+		const ::boost::uint64_t key(val ^ load_le64(secret+8*i));
+		acc[i ^ 1] += val;
+		acc[i] += (key & 0xffffffff)*(key >> 32);
+	}
+#endif // __SSE2__
+}
+
+inline void xxh3_scramble(::boost::uint64_t* acc, byte_type const* secret)
+{
+#ifdef __SSE2__
+	const __m128i prime(_mm_set1_epi32(static_cast<int>(DCS_DIGEST_DETAIL_XXH_PRIME32_1_)));
+	for (::std::size_t i = 0; i < xxh3_acc_size/2; ++i)
+	{
+		__m128i* pacc(reinterpret_cast<__m128i*>(acc)+i);
+		__m128i a(_mm_loadu_si128(pacc));
+		a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+		a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<__m128i const*>(secret)+i));
+		// 64x32-bit product from the products of the low and high halves
+		const __m128i lo(_mm_mul_epu32(a, prime));
+		const __m128i hi(_mm_mul_epu32(_mm_shuffle_epi32(a, 0x31), prime));
+		_mm_storeu_si128(pacc, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+	}
+#else // __SSE2__
+	for (::std::size_t i = 0; i < xxh3_acc_size; ++i)
+	{
+		::boost::uint64_t a(acc[i]);
+		a ^= a >> 47;
+		a ^= load_le64(secret+8*i);
+		acc[i] = a*DCS_DIGEST_DETAIL_XXH_PRIME32_1_;
+	}
+#endif // __SSE2__
+}
+
+/**
+ * Accumulates \a n stripes, scrambling the accumulators at the end of each
+ * block; \a nstripes_so_far is the number of stripes of the current block
+ * already accumulated.
+ */
+inline void xxh3_consume_stripes(::boost::uint64_t* acc, ::std::size_t& nstripes_so_far, byte_type const* p, ::std::size_t n, byte_type const* secret)
+{
+	while (n > 0)
+	{
+		const ::std::size_t m(n < (xxh3_stripes_per_block-nstripes_so_far) ? n : (xxh3_stripes_per_block-nstripes_so_far));
+		for (::std::size_t s = 0; s < m; ++s)
+		{
+			xxh3_accumulate_stripe(acc, p+s*xxh3_stripe_len, secret+(nstripes_so_far+s)*xxh3_secret_consume_rate);
+		}
+		p += m*xxh3_stripe_len;
+		n -= m;
+		nstripes_so_far += m;
+		if (nstripes_so_far == xxh3_stripes_per_block)
+		{
+			xxh3_scramble(acc, secret+xxh3_secret_size-xxh3_stripe_len);
+			nstripes_so_far = 0;
+		}
+	}
+}
+
+inline ::boost::uint64_t xxh3_merge_accs(::boost::uint64_t const* acc, byte_type const* secret, ::boost::uint64_t len)
+{
+	::boost::uint64_t h(len*DCS_DIGEST_DETAIL_XXH_PRIME64_1_);
+
+	secret += xxh3_secret_mergeaccs_start;
+	for (::std::size_t i = 0; i < 4; ++i)
+	{
+		h += mul128_fold64(acc[2*i] ^ load_le64(secret+16*i), acc[2*i+1] ^ load_le64(secret+16*i+8));
+	}
+	return xxh3_avalanche(h);
+}
+
+/// Hashes inputs longer than 240 bytes.
+inline ::boost::uint64_t xxh3_hash_long(byte_type const* p, ::std::size_t len, byte_type const* secret)
+{
+	::boost::uint64_t acc[xxh3_acc_size];
+	::std::size_t nstripes_so_far(0);
+
+	xxh3_init_acc(acc);
+	// The last stripe is always processed apart, even if complete
+	xxh3_consume_stripes(acc, nstripes_so_far, p, (len-1)/xxh3_stripe_len, secret);
+	xxh3_accumulate_stripe(acc, p+len-xxh3_stripe_len, secret+xxh3_secret_size-xxh3_stripe_len-xxh3_secret_lastacc_start);
+
+	return xxh3_merge_accs(acc, secret, len);
+}
+
+} // Namespace detail
+
+
+/**
+ * The XXH64 hash function (see https://github.com/Cyan4973/xxHash).
+ *
+ * A fast non-cryptographic hash function with a 64-bit hash value, suitable
+ * for checksums and hash tables.
+ * The digest is the big-endian representation of the hash value, as printed
+ * by the reference implementation.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class xxh64_algorithm
+{
+	private: typedef ::boost::uint64_t uint64_type;
+
+
+	public: static const ::std::size_t digest_size = 8; ///< The size of digest buffer (in bytes)
+	private: static const ::std::size_t stripe_len = 32;
+
+
+	public: explicit xxh64_algorithm(uint64_type seed = 0)
+	: seed_(seed)
+	{
+		this->reset();
+	}
+
+	/// Computes the hash value of the given data at once.
+	public: static uint64_type hash(byte_type const* data, ::std::size_t len, uint64_type seed = 0)
+	{
+		uint64_type v[4];
+		init(v, seed);
+
+		const ::std::size_t n(len-len%stripe_len);
+		for (::std::size_t i = 0; i < n; i += stripe_len)
+		{
+			consume(v, data+i);
+		}
+
+		return detail::xxh64_finalize(merge(v, seed, len), data+n, len-n);
+	}
+
+	public: void reset()
+	{
+		init(v_, seed_);
+		total_len_ = 0;
+		buffer_len_ = 0;
+		finalized_ = false;
+	}
+
+	public: void update(byte_type const* input, ::std::size_t len)
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot update an already finalized digest"));
+
+		if (len == 0)
+		{
+			// Nothing to do (and input may be null)
+			return;
+		}
+
+		total_len_ += len;
+
+		if (buffer_len_ > 0)
+		{
+			const ::std::size_t n(len < (stripe_len-buffer_len_) ? len : (stripe_len-buffer_len_));
+			::std::memcpy(buffer_+buffer_len_, input, n);
+			buffer_len_ += n;
+			input += n;
+			len -= n;
+			if (buffer_len_ < stripe_len)
+			{
+				return;
+			}
+			consume(v_, buffer_);
+			buffer_len_ = 0;
+		}
+
+		for (; len >= stripe_len; len -= stripe_len, input += stripe_len)
+		{
+			consume(v_, input);
+		}
+
+		::std::memcpy(buffer_, input, len);
+		buffer_len_ = len;
+	}
+
+	public: void update(char const* input, ::std::size_t len)
+	{
+		update(reinterpret_cast<byte_type const*>(input), len);
+	}
+
+	public: void finish()
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot finalize an already finalized digest"));
+
+		value_ = detail::xxh64_finalize(merge(v_, seed_, total_len_), buffer_, buffer_len_);
+		detail::store_be64(digest_, value_);
+
+		finalized_ = true;
+	}
+
+	/// Returns the hash value.
+	public: uint64_type value() const
+	{
+		// pre: digest already finalized
+		DCS_ASSERT(finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Digest computation has not been finalized"));
+
+		return value_;
+	}
+
+	public: ::std::vector<byte_type> digest() const
+	{
+		return ::std::vector<byte_type>(this->raw_digest(), this->raw_digest()+digest_size);
+	}
+
+	public: ::std::vector<byte_type> digest(byte_type const* data, ::std::size_t len)
+	{
+		reset();
+		update(data, len);
+		finish();
+
+		return digest();
+	}
+
+	public: ::std::vector<byte_type> digest(::std::string const& s)
+	{
+		return digest(reinterpret_cast<byte_type const*>(s.data()), s.length());
+	}
+
+	/// Returns the digest in a fixed-size array.
+	public: ::boost::array<byte_type,digest_size> digest_array() const
+	{
+		::boost::array<byte_type,digest_size> dig;
+		::std::memcpy(dig.data(), this->raw_digest(), digest_size);
+		return dig;
+	}
+
+	public: ::std::size_t digest_length() const
+	{
+		return digest_size;
+	}
+
+	public: byte_type const* raw_digest() const
+	{
+		// pre: digest already finalized
+		DCS_ASSERT(finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Digest computation has not been finalized"));
+
+		return digest_;
+	}
+
+	private: static void init(uint64_type* v, uint64_type seed)
+	{
+		v[0] = seed+DCS_DIGEST_DETAIL_XXH_PRIME64_1_+DCS_DIGEST_DETAIL_XXH_PRIME64_2_;
+		v[1] = seed+DCS_DIGEST_DETAIL_XXH_PRIME64_2_;
+		v[2] = seed;
+		v[3] = seed-DCS_DIGEST_DETAIL_XXH_PRIME64_1_;
+	}
+
+	private: static void consume(uint64_type* v, byte_type const* p)
+	{
+		v[0] = detail::xxh64_round(v[0], detail::load_le64(p));
+		v[1] = detail::xxh64_round(v[1], detail::load_le64(p+8));
+		v[2] = detail::xxh64_round(v[2], detail::load_le64(p+16));
+		v[3] = detail::xxh64_round(v[3], detail::load_le64(p+24));
+	}
+
+	private: static uint64_type merge(uint64_type const* v, uint64_type seed, uint64_type len)
+	{
+		uint64_type h;
+
+		if (len >= stripe_len)
+		{
+			h = detail::rotl64(v[0], 1)+detail::rotl64(v[1], 7)+detail::rotl64(v[2], 12)+detail::rotl64(v[3], 18);
+			for (int i = 0; i < 4; ++i)
+			{
+				h = detail::xxh64_merge_round(h, v[i]);
+			}
+		}
+		else
+		{
+			h = seed+DCS_DIGEST_DETAIL_XXH_PRIME64_5_;
+		}
+
+		return h+len;
+	}
+
+
+	private: uint64_type seed_;
+	private: uint64_type v_[4];
+	private: uint64_type total_len_;
+	private: byte_type buffer_[stripe_len];
+	private: ::std::size_t buffer_len_;
+	private: uint64_type value_;
+	private: byte_type digest_[digest_size];
+	private: bool finalized_;
+}; // xxh64_algorithm
+
+
+/**
+ * The XXH3 hash function, with a 64-bit hash value (see
+ * https://github.com/Cyan4973/xxHash).
+ *
+ * Faster than XXH64, especially on small inputs, for which it uses
+ * specialized code paths.
+ * For many small records, prefer the static hash() function, which does not
+ * initialize the 256-byte streaming buffer.
+ * The digest is the big-endian representation of the hash value, as printed
+ * by the reference implementation.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class xxh3_algorithm
+{
+	private: typedef ::boost::uint64_t uint64_type;
+
+
+	public: static const ::std::size_t digest_size = 8; ///< The size of digest buffer (in bytes)
+	private: static const ::std::size_t buffer_size = 256;
+
+
+	public: explicit xxh3_algorithm(uint64_type seed = 0)
+	: seed_(seed)
+	{
+		if (seed_ != 0)
+		{
+			detail::xxh3_init_custom_secret(custom_secret_, seed_);
+		}
+		this->reset();
+	}
+
+	/// Computes the hash value of the given data at once.
+	public: static uint64_type hash(byte_type const* data, ::std::size_t len, uint64_type seed = 0)
+	{
+		if (len <= detail::xxh3_midsize_max)
+		{
+			return detail::xxh3_hash_short(data, len, detail::xxh3_default_secret(), seed);
+		}
+		if (seed == 0)
+		{
+			return detail::xxh3_hash_long(data, len, detail::xxh3_default_secret());
+		}
+
+		byte_type secret[detail::xxh3_secret_size];
+		detail::xxh3_init_custom_secret(secret, seed);
+
+		return detail::xxh3_hash_long(data, len, secret);
+	}
+
+	public: void reset()
+	{
+		detail::xxh3_init_acc(acc_);
+		total_len_ = 0;
+		buffer_len_ = 0;
+		nstripes_so_far_ = 0;
+		finalized_ = false;
+	}
+
+	public: void update(byte_type const* input, ::std::size_t len)
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot update an already finalized digest"));
+
+		if (len == 0)
+		{
+			// Nothing to do (and input may be null)
+			return;
+		}
+
+		total_len_ += len;
+
+		if (len <= (buffer_size-buffer_len_))
+		{
+			::std::memcpy(buffer_+buffer_len_, input, len);
+			buffer_len_ += len;
+			return;
+		}
+
+		// Data are only consumed when more data follow, since the last
+		// stripe is processed apart by finish()
+		byte_type const* end(input+len);
+		if (buffer_len_ > 0)
+		{
+			const ::std::size_t n(buffer_size-buffer_len_);
+			::std::memcpy(buffer_+buffer_len_, input, n);
+			input += n;
+			detail::xxh3_consume_stripes(acc_, nstripes_so_far_, buffer_, buffer_size/detail::xxh3_stripe_len, this->secret());
+			buffer_len_ = 0;
+		}
+		if (static_cast< ::std::size_t >(end-input) > buffer_size)
+		{
+			const ::std::size_t nstripes((end-input-1)/detail::xxh3_stripe_len);
+			detail::xxh3_consume_stripes(acc_, nstripes_so_far_, input, nstripes, this->secret());
+			input += nstripes*detail::xxh3_stripe_len;
+			// Keep the last consumed stripe, which finish() may need
+			::std::memcpy(buffer_+buffer_size-detail::xxh3_stripe_len, input-detail::xxh3_stripe_len, detail::xxh3_stripe_len);
+		}
+		::std::memcpy(buffer_, input, end-input);
+		buffer_len_ = end-input;
+	}
+
+	public: void update(char const* input, ::std::size_t len)
+	{
+		update(reinterpret_cast<byte_type const*>(input), len);
+	}
+
+	public: void finish()
+	{
+		// pre: digest not finalized
+		DCS_ASSERT(!finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot finalize an already finalized digest"));
+
+		if (total_len_ <= detail::xxh3_midsize_max)
+		{
+			value_ = detail::xxh3_hash_short(buffer_, buffer_len_, detail::xxh3_default_secret(), seed_);
+		}
+		else
+		{
+			byte_type const* secret(this->secret());
+			uint64_type acc[detail::xxh3_acc_size];
+			::std::memcpy(acc, acc_, sizeof(acc));
+
+			byte_type last_stripe[detail::xxh3_stripe_len];
+			byte_type const* p_last;
+			if (buffer_len_ >= detail::xxh3_stripe_len)
+			{
+				::std::size_t nstripes_so_far(nstripes_so_far_);
+				detail::xxh3_consume_stripes(acc, nstripes_so_far, buffer_, (buffer_len_-1)/detail::xxh3_stripe_len, secret);
+				p_last = buffer_+buffer_len_-detail::xxh3_stripe_len;
+			}
+			else
+			{
+				// The last stripe straddles the previously consumed data
+				const ::std::size_t n(detail::xxh3_stripe_len-buffer_len_);
+				::std::memcpy(last_stripe, buffer_+buffer_size-n, n);
+				::std::memcpy(last_stripe+n, buffer_, buffer_len_);
+				p_last = last_stripe;
+			}
+			detail::xxh3_accumulate_stripe(acc, p_last, secret+detail::xxh3_secret_size-detail::xxh3_stripe_len-detail::xxh3_secret_lastacc_start);
+
+			value_ = detail::xxh3_merge_accs(acc, secret, total_len_);
+		}
+		detail::store_be64(digest_, value_);
+
+		finalized_ = true;
+	}
+
+	/// Returns the hash value.
+	public: uint64_type value() const
+	{
+		// pre: digest already finalized
+		DCS_ASSERT(finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Digest computation has not been finalized"));
+
+		return value_;
+	}
+
+	public: ::std::vector<byte_type> digest() const
+	{
+		return ::std::vector<byte_type>(this->raw_digest(), this->raw_digest()+digest_size);
+	}
+
+	public: ::std::vector<byte_type> digest(byte_type const* data, ::std::size_t len)
+	{
+		reset();
+		update(data, len);
+		finish();
+
+		return digest();
+	}
+
+	public: ::std::vector<byte_type> digest(::std::string const& s)
+	{
+		return digest(reinterpret_cast<byte_type const*>(s.data()), s.length());
+	}
+
+	/// Returns the digest in a fixed-size array.
+	public: ::boost::array<byte_type,digest_size> digest_array() const
+	{
+		::boost::array<byte_type,digest_size> dig;
+		::std::memcpy(dig.data(), this->raw_digest(), digest_size);
+		return dig;
+	}
+
+	public: ::std::size_t digest_length() const
+	{
+		return digest_size;
+	}
+
+	public: byte_type const* raw_digest() const
+	{
+		// pre: digest already finalized
+		DCS_ASSERT(finalized_,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Digest computation has not been finalized"));
+
+		return digest_;
+	}
+
+	private: byte_type const* secret() const
+	{
+		return seed_ != 0 ? custom_secret_ : detail::xxh3_default_secret();
+	}
+
+
+	private: uint64_type seed_;
+	private: byte_type custom_secret_[detail::xxh3_secret_size];
+	private: uint64_type acc_[detail::xxh3_acc_size];
+	private: uint64_type total_len_;
+	private: byte_type buffer_[buffer_size];
+	private: ::std::size_t buffer_len_;
+	private: ::std::size_t nstripes_so_far_;
+	private: uint64_type value_;
+	private: byte_type digest_[digest_size];
+	private: bool finalized_;
+}; // xxh3_algorithm
+
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, xxh64_algorithm const& xxh)
+{
+	os << hex_string(xxh.digest());
+
+	return os;
+}
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, xxh3_algorithm const& xxh)
+{
+	os << hex_string(xxh.digest());
+
+	return os;
+}
+
+}} // Namespace dcs::digest
+
+#endif // DCS_DIGEST_XXHASH_HPP
@@ -26,9 +26,15 @@
 #define DCS_DISJOINT_SETS_HPP
 
 
-#include <boost/function.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
 #include <cstddef>
-#include <map>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 
@@ -36,11 +42,19 @@ namespace dcs {
 
 namespace detail { namespace /*<unnamed>*/ {
 
-template <typename T,typename ValueT>
-struct identity_hasher
+/// The number of pairs a bulk union looks ahead to prefetch parents.
+static const ::std::size_t disjoint_sets_prefetch_distance = 8;
+
+template <typename T>
+inline
+void disjoint_sets_prefetch(T const* p)
 {
-	ValueT operator()(T const& t) { return t; }
-}; // identity
+#if defined(__GNUC__)
+	__builtin_prefetch(p);
+#else
+	(void) p;
+#endif // __GNUC__
+}
 
 
 template <class ParentPA, class Vertex>
@@ -58,6 +72,20 @@ Vertex find_representative_with_path_halving(ParentPA p, Vertex v)
 }
 
 
+template <class ParentPA, class Vertex>
+Vertex find_representative_with_path_splitting(ParentPA p, Vertex v)
+{
+  Vertex parent = p[v];
+  while (parent != v) {
+    Vertex grandparent = p[parent];
+    p[v] = grandparent;
+    v = parent;
+    parent = grandparent;
+  }
+  return v;
+}
+
+
 template <class ParentPA, class Vertex>
 Vertex find_representative_with_full_compression(ParentPA parent, Vertex v)
 {
@@ -76,6 +104,142 @@ Vertex find_representative_with_full_compression(ParentPA parent, Vertex v)
   return ancestor;
 }
 
+
+/**
+ * Open-addressing (linear probing) table mapping elements to dense
+ * identifiers, assigned in insertion order.
+ *
+ * Hash values are scrambled by a multiplicative (Fibonacci) hashing step,
+ * so that identity-like hash functions (e.g., the one for integers) do not
+ * cluster sequential keys.
+ */
+template <typename ElementT, typename HashT, typename EqualT>
+class disjoint_sets_id_table
+{
+	public: typedef ::std::size_t size_type;
+	public: static const size_type npos = static_cast<size_type>(-1);
+	private: typedef ::std::pair<ElementT,size_type> slot_type;
+
+
+	public: disjoint_sets_id_table()
+	: slots_(min_capacity, slot_type(ElementT(), npos)),
+	  shift_(64-min_capacity_bits),
+	  size_(0)
+	{
+	}
+
+	public: size_type size() const
+	{
+		return size_;
+	}
+
+	public: void reserve(size_type n)
+	{
+		size_type cap(slots_.size());
+		while (n*max_load_den > cap*max_load_num)
+		{
+			cap *= 2;
+		}
+		if (cap != slots_.size())
+		{
+			this->rehash(cap);
+		}
+	}
+
+	/// Returns the identifier of the given element or npos.
+	public: size_type find(ElementT const& e) const
+	{
+		const size_type mask(slots_.size()-1);
+		for (size_type k = this->home(e); ; k = (k+1) & mask)
+		{
+			slot_type const& slot(slots_[k]);
+			if (slot.second == npos)
+			{
+				return npos;
+			}
+			if (equal_(slot.first, e))
+			{
+				return slot.second;
+			}
+		}
+	}
+
+	/**
+	 * Returns the identifier of the given element, inserting the element
+	 * with identifier size() if it is not in the table.
+	 */
+	public: size_type insert(ElementT const& e)
+	{
+		if ((size_+1)*max_load_den > slots_.size()*max_load_num)
+		{
+			this->rehash(slots_.size()*2);
+		}
+
+		const size_type mask(slots_.size()-1);
+		for (size_type k = this->home(e); ; k = (k+1) & mask)
+		{
+			slot_type& slot(slots_[k]);
+			if (slot.second == npos)
+			{
+				slot.first = e;
+				slot.second = size_;
+				return size_++;
+			}
+			if (equal_(slot.first, e))
+			{
+				return slot.second;
+			}
+		}
+	}
+
+	private: size_type home(ElementT const& e) const
+	{
+		// 2^64 divided by the golden ratio
+		const ::boost::uint64_t golden((static_cast< ::boost::uint64_t >(0x9E3779B9) << 32) | 0x7F4A7C15);
+		const ::boost::uint64_t h(static_cast< ::boost::uint64_t >(hash_(e))*golden);
+		return static_cast<size_type>(h >> shift_);
+	}
+
+	private: void rehash(size_type cap)
+	{
+		::std::vector<slot_type> old(cap, slot_type(ElementT(), npos));
+		old.swap(slots_);
+		shift_ = 64;
+		for (size_type c = cap; c > 1; c >>= 1)
+		{
+			--shift_;
+		}
+
+		const size_type mask(cap-1);
+		for (size_type i = 0; i < old.size(); ++i)
+		{
+			if (old[i].second != npos)
+			{
+				size_type k(this->home(old[i].first));
+				while (slots_[k].second != npos)
+				{
+					k = (k+1) & mask;
+				}
+				slots_[k] = old[i];
+			}
+		}
+	}
+
+
+	private: static const unsigned int min_capacity_bits = 4;
+	private: static const size_type min_capacity = size_type(1) << min_capacity_bits;
+	private: static const size_type max_load_num = 7; ///< Numerator of the maximum load factor
+	private: static const size_type max_load_den = 10; ///< Denominator of the maximum load factor
+	private: ::std::vector<slot_type> slots_;
+	private: unsigned int shift_; ///< 64 minus the base-2 logarithm of the capacity
+	private: size_type size_;
+	private: HashT hash_;
+	private: EqualT equal_;
+}; // disjoint_sets_id_table
+
+template <typename ElementT, typename HashT, typename EqualT>
+const typename disjoint_sets_id_table<ElementT,HashT,EqualT>::size_type disjoint_sets_id_table<ElementT,HashT,EqualT>::npos;
+
 }} // Namespace detail::<unnamed>
 
 
@@ -88,6 +252,15 @@ struct find_with_path_halving
 	}
 };
 
+struct find_with_path_splitting
+{
+	template <class ParentPA, class Vertex>
+	Vertex operator()(ParentPA p, Vertex v) const
+	{
+		return detail::find_representative_with_path_splitting(p, v);
+	}
+};
+
 struct find_with_full_path_compression
 {
 	template <class ParentPA, class Vertex>
@@ -98,71 +271,354 @@ struct find_with_full_path_compression
 };
 
 
-template <typename ElementT, typename FinderT = find_with_full_path_compression>
-class disjoint_sets
+/**
+ * \brief Disjoint sets over the dense integer identifiers 0,...,n-1.
+ *
+ * Parents and set sizes are stored in two contiguous arrays of \a IndexT
+ * (so that a 32-bit index type halves the memory footprint with respect to
+ * \c std::size_t), and sets are merged by size (the smaller set is linked
+ * below the representative of the larger one).
+ * Together with path splitting (the default finder), the amortized cost of
+ * each operation is almost constant.
+ *
+ * The representative of a set (as returned by find_set()) changes only when
+ * the set is merged with another one.
+ *
+ * \tparam IndexT The (unsigned) integral type of identifiers.
+ * \tparam FinderT The strategy used to find representatives and compress
+ *  paths.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename IndexT = ::std::size_t, typename FinderT = find_with_path_splitting>
+class dense_disjoint_sets
 {
-	public: typedef ElementT element_type;
+	public: typedef IndexT index_type;
 	public: typedef ::std::size_t size_type;
-	public: typedef size_type (*hash_function_type)(element_type const&);
 	public: typedef FinderT finder_type;
 
 
-	public: disjoint_sets()
-	: hash_(detail::identity_hasher<element_type,size_type>())
+	public: dense_disjoint_sets()
+	: num_sets_(0)
 	{
 	}
 
-	public: void make_set(element_type const& e)
+	/// Creates \a n singleton sets.
+	public: explicit dense_disjoint_sets(size_type n)
+	: num_sets_(0)
+	{
+		this->make_sets(n);
+	}
+
+	/// Appends a new singleton set and returns its identifier.
+	public: index_type make_set()
 	{
-		size_type sid(id_map_.size());
-		id_map_[hash_(e)] = sid;
-		inv_id_map_[sid] = e;
-		ranks_.push_back(0);
-		parents_.push_back(sid);
+		DCS_ASSERT(parents_.size() <= static_cast<size_type>(::std::numeric_limits<index_type>::max()),
+				   DCS_EXCEPTION_THROW(::std::length_error,
+									   "Too many elements for the index type"));
 
+		const index_type i(static_cast<index_type>(parents_.size()));
+		parents_.push_back(i);
+		sizes_.push_back(1);
+		++num_sets_;
+		return i;
 	}
 
-	public: size_type find_set(element_type const& e) const
+	/// Appends \a n new singleton sets.
+	public: void make_sets(size_type n)
 	{
-		return finder_(parents_, id_map_.at(hash_(e)));
+		const size_type old_n(parents_.size());
+
+		DCS_ASSERT(n == 0 || n-1 <= static_cast<size_type>(::std::numeric_limits<index_type>::max())-old_n,
+				   DCS_EXCEPTION_THROW(::std::length_error,
+									   "Too many elements for the index type"));
+
+		parents_.resize(old_n+n);
+		sizes_.resize(old_n+n, 1);
+		for (size_type i = old_n; i < parents_.size(); ++i)
+		{
+			parents_[i] = static_cast<index_type>(i);
+		}
+		num_sets_ += n;
 	}
 
-	public: void link_sets(element_type const& e1, element_type const& e2)
+	public: void reserve(size_type n)
 	{
-		size_type sid1 = find_set(e1);
-		size_type sid2 = find_set(e2);
-		if (sid1 == sid2)
+		parents_.reserve(n);
+		sizes_.reserve(n);
+	}
+
+	/// Returns the number of elements.
+	public: size_type size() const
+	{
+		return parents_.size();
+	}
+
+	/// Returns the number of disjoint sets.
+	public: size_type num_sets() const
+	{
+		return num_sets_;
+	}
+
+	/**
+	 * Returns the representative of the set containing \a i.
+	 *
+	 * Even if const, the path from \a i to the representative is compressed.
+	 */
+	public: index_type find_set(index_type i) const
+	{
+		// pre: i < size()
+		DCS_ASSERT(static_cast<size_type>(i) < parents_.size(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Unknown element"));
+
+		return finder_(&parents_[0], i);
+	}
+
+	public: bool same_set(index_type i, index_type j) const
+	{
+		return this->find_set(i) == this->find_set(j);
+	}
+
+	/// Returns the number of elements in the set containing \a i.
+	public: size_type set_size(index_type i) const
+	{
+		return sizes_[this->find_set(i)];
+	}
+
+	/**
+	 * Merges the sets whose representatives are \a r1 and \a r2 and returns
+	 * the representative of the merged set.
+	 */
+	public: index_type link_sets(index_type r1, index_type r2)
+	{
+		// pre: r1 and r2 are distinct representatives
+		DCS_ASSERT(r1 != r2 && parents_[r1] == r1 && parents_[r2] == r2,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Not distinct representatives"));
+
+		if (sizes_[r1] < sizes_[r2])
 		{
-			return;
+			::std::swap(r1, r2);
 		}
+		parents_[r2] = r1;
+		sizes_[r1] += sizes_[r2];
+		--num_sets_;
+		return r1;
+	}
+
+	/**
+	 * Merges the sets containing \a i and \a j and returns \c true if they
+	 * were distinct.
+	 */
+	public: bool union_sets(index_type i, index_type j)
+	{
+		const index_type r1(this->find_set(i));
+		const index_type r2(this->find_set(j));
+		if (r1 == r2)
+		{
+			return false;
+		}
+		this->link_sets(r1, r2);
+		return true;
+	}
 
-		// e1 and e1 are not already in same set. Merge them.
-		if (ranks_[sid1] > ranks_[sid2])
+	/**
+	 * Merges the sets containing the elements of each pair in the range
+	 * [first,last) and returns the number of merges.
+	 *
+	 * The parents of the elements of later pairs are prefetched, which hides
+	 * part of the cache misses when the arrays are large.
+	 */
+	public: template <typename PairFwdIterT>
+			size_type union_all(PairFwdIterT first, PairFwdIterT last)
+	{
+		size_type count(0);
+		PairFwdIterT ahead(first);
+		for (::std::size_t k = 0; k < detail::disjoint_sets_prefetch_distance && ahead != last; ++k)
 		{
-			parents_[sid2] = sid1;
+			++ahead;
 		}
-		else
+		while (first != last)
 		{
-			parents_[sid1] = sid2;
-			if (ranks_[sid1] == ranks_[sid2])
+			if (ahead != last)
+			{
+				detail::disjoint_sets_prefetch(&parents_[0]+ahead->first);
+				detail::disjoint_sets_prefetch(&parents_[0]+ahead->second);
+				++ahead;
+			}
+			if (this->union_sets(first->first, first->second))
 			{
-				ranks_[sid2] += 1;
+				++count;
 			}
+			++first;
 		}
+		return count;
 	}
 
-	public: void union_sets(element_type const& e1, element_type const& e2)
+
+	private: mutable ::std::vector<index_type> parents_;
+	private: ::std::vector<index_type> sizes_;
+	private: size_type num_sets_;
+	private: finder_type finder_;
+}; // dense_disjoint_sets
+
+
+/**
+ * \brief Disjoint sets over arbitrary (hashable) elements.
+ *
+ * Elements are mapped to dense identifiers by means of an open-addressing
+ * hash table, and the sets are kept by a dense_disjoint_sets over those
+ * identifiers.
+ * The identifier of a representative (as returned by find_set()) can be
+ * mapped back to its element by element().
+ *
+ * \tparam ElementT The type of elements; it must be default constructible.
+ * \tparam FinderT The strategy used to find representatives and compress
+ *  paths.
+ * \tparam HashT The hash function for elements.
+ * \tparam EqualT The equality predicate for elements.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename ElementT,
+		  typename FinderT = find_with_path_splitting,
+		  typename HashT = ::boost::hash<ElementT>,
+		  typename EqualT = ::std::equal_to<ElementT> >
+class disjoint_sets
+{
+	public: typedef ElementT element_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef HashT hash_function_type;
+	public: typedef FinderT finder_type;
+	private: typedef detail::disjoint_sets_id_table<element_type,hash_function_type,EqualT> id_table_type;
+
+
+	public: disjoint_sets()
 	{
-		link_sets(find_set(e1), find_set(e2));
 	}
 
+	/// Reserves room for \a n elements.
+	public: void reserve(size_type n)
+	{
+		ids_.reserve(n);
+		elements_.reserve(n);
+		sets_.reserve(n);
+	}
 
-	private: ::std::vector<size_type> ranks_;
-	private: ::std::vector<size_type> parents_;
-	private: ::std::map<size_type,size_type> id_map_;
-	private: ::std::map<size_type,element_type> inv_id_map_;
-	private: ::boost::function<size_type(element_type const&)> hash_;
-	private: finder_type finder_;
+	/// Adds the singleton set of \a e, if \a e is not already present.
+	public: void make_set(element_type const& e)
+	{
+		this->id(e);
+	}
+
+	public: bool contains(element_type const& e) const
+	{
+		return ids_.find(e) != id_table_type::npos;
+	}
+
+	/// Returns the number of elements.
+	public: size_type size() const
+	{
+		return elements_.size();
+	}
+
+	/// Returns the number of disjoint sets.
+	public: size_type num_sets() const
+	{
+		return sets_.num_sets();
+	}
+
+	/**
+	 * Returns the identifier of the representative of the set containing
+	 * \a e.
+	 *
+	 * Throws \c std::out_of_range if \a e is unknown.
+	 */
+	public: size_type find_set(element_type const& e) const
+	{
+		const size_type i(ids_.find(e));
+
+		if (i == id_table_type::npos)
+		{
+			DCS_EXCEPTION_THROW(::std::out_of_range,
+								"Unknown element");
+		}
+
+		return sets_.find_set(i);
+	}
+
+	/// Returns the element with the given identifier.
+	public: element_type const& element(size_type id) const
+	{
+		return elements_[id];
+	}
+
+	public: bool same_set(element_type const& e1, element_type const& e2) const
+	{
+		return this->find_set(e1) == this->find_set(e2);
+	}
+
+	/// Returns the number of elements in the set containing \a e.
+	public: size_type set_size(element_type const& e) const
+	{
+		return sets_.set_size(this->find_set(e));
+	}
+
+	public: void link_sets(element_type const& e1, element_type const& e2)
+	{
+		this->union_sets(e1, e2);
+	}
+
+	/**
+	 * Merges the sets containing \a e1 and \a e2 and returns \c true if they
+	 * were distinct.
+	 *
+	 * Elements not yet present are added as singleton sets first.
+	 */
+	public: bool union_sets(element_type const& e1, element_type const& e2)
+	{
+		const size_type i1(this->id(e1));
+		const size_type i2(this->id(e2));
+		return sets_.union_sets(i1, i2);
+	}
+
+	/**
+	 * Merges the sets containing the elements of each pair in the range
+	 * [first,last) and returns the number of merges.
+	 *
+	 * Elements not yet present are added as singleton sets first.
+	 */
+	public: template <typename PairFwdIterT>
+			size_type union_all(PairFwdIterT first, PairFwdIterT last)
+	{
+		// Map elements to identifiers first, so that the unions run on the
+		// dense arrays only.
+		::std::vector< ::std::pair<size_type,size_type> > pairs;
+		for (; first != last; ++first)
+		{
+			const size_type i1(this->id(first->first));
+			const size_type i2(this->id(first->second));
+			pairs.push_back(::std::make_pair(i1, i2));
+		}
+		return sets_.union_all(pairs.begin(), pairs.end());
+	}
+
+	private: size_type id(element_type const& e)
+	{
+		const size_type i(ids_.insert(e));
+		if (i == elements_.size())
+		{
+			elements_.push_back(e);
+			sets_.make_set();
+		}
+		return i;
+	}
+
+
+	private: id_table_type ids_;
+	private: ::std::vector<element_type> elements_;
+	private: dense_disjoint_sets<size_type,finder_type> sets_;
 }; // disjoint_sets
 
 } // Namespace dcs
@@ -0,0 +1,363 @@
+/**
+ * \file dcs/iterator/any_chunked_range.hpp
+ *
+ * \brief Generic (type-erased) range handing out contiguous chunks of elements.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ITERATOR_ANY_CHUNKED_RANGE_HPP
+#define DCS_ITERATOR_ANY_CHUNKED_RANGE_HPP
+
+
+#include <algorithm>
+#include <boost/mpl/bool.hpp>
+#include <boost/smart_ptr.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_const.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace iterator {
+
+namespace detail {
+
+/// Tells if the elements referred by an iterator are stored contiguously.
+template <typename IterT>
+struct is_contiguous_iterator
+: ::boost::mpl::bool_<
+	::boost::is_same<IterT, typename ::std::vector<typename ::std::iterator_traits<IterT>::value_type>::iterator>::value
+	|| ::boost::is_same<IterT, typename ::std::vector<typename ::std::iterator_traits<IterT>::value_type>::const_iterator>::value
+  >
+{
+};
+
+template <typename T>
+struct is_contiguous_iterator<T*>: ::boost::mpl::true_
+{
+};
+
+template <typename T>
+struct is_contiguous_iterator<T const*>: ::boost::mpl::true_
+{
+};
+
+// Elements of std::vector<bool> are packed
+template <>
+struct is_contiguous_iterator< ::std::vector<bool>::iterator >: ::boost::mpl::false_
+{
+};
+
+template <>
+struct is_contiguous_iterator< ::std::vector<bool>::const_iterator >: ::boost::mpl::false_
+{
+};
+
+
+template <typename T>
+class any_chunked_range_base
+{
+	public: typedef ::std::size_t size_type;
+
+
+	public: virtual ~any_chunked_range_base()
+	{
+	}
+
+	public: virtual size_type size() const = 0;
+
+	/// Tells if chunk() never uses the given buffer.
+	public: virtual bool contiguous() const = 0;
+
+	public: virtual size_type chunk(size_type pos, T const*& data, T* buffer, size_type buffer_size) const = 0;
+}; // any_chunked_range_base
+
+
+/// Elements stored contiguously are handed out in a single chunk.
+template <typename T>
+class contiguous_chunked_range: public any_chunked_range_base<T>
+{
+	private: typedef any_chunked_range_base<T> base_type;
+	public: typedef typename base_type::size_type size_type;
+
+
+	public: contiguous_chunked_range(T const* data, size_type n)
+	: data_(data),
+	  n_(n)
+	{
+	}
+
+	public: size_type size() const
+	{
+		return n_;
+	}
+
+	public: bool contiguous() const
+	{
+		return true;
+	}
+
+	public: size_type chunk(size_type pos, T const*& data, T* /*buffer*/, size_type /*buffer_size*/) const
+	{
+		data = data_+pos;
+		return n_-pos;
+	}
+
+
+	private: T const* data_;
+	private: size_type n_;
+}; // contiguous_chunked_range
+
+
+/// Other elements are copied, a chunk at a time, to the given buffer.
+template <typename T, typename RAIterT>
+class copying_chunked_range: public any_chunked_range_base<T>
+{
+	private: typedef any_chunked_range_base<T> base_type;
+	public: typedef typename base_type::size_type size_type;
+
+
+	public: copying_chunked_range(RAIterT first, RAIterT last)
+	: first_(first),
+	  n_(last-first)
+	{
+	}
+
+	public: size_type size() const
+	{
+		return n_;
+	}
+
+	public: bool contiguous() const
+	{
+		return false;
+	}
+
+	public: size_type chunk(size_type pos, T const*& data, T* buffer, size_type buffer_size) const
+	{
+		const size_type k(::std::min(buffer_size, n_-pos));
+		::std::copy(first_+pos, first_+(pos+k), buffer);
+		data = buffer;
+		return k;
+	}
+
+
+	private: RAIterT first_;
+	private: size_type n_;
+}; // copying_chunked_range
+
+} // Namespace detail
+
+
+/**
+ * \brief Generic (type-erased) read-only range handing out contiguous
+ *  chunks of elements.
+ *
+ * Unlike any_iterator, which costs a virtual call per element, the elements
+ * are obtained by chunk() as contiguous arrays, with a virtual call per
+ * chunk, so that consumers can process each chunk in a tight (and
+ * vectorizable) loop.
+ * Elements stored contiguously (i.e., in arrays and in vectors) are handed
+ * out in a single chunk without any copy.
+ * Elements of other random access sequences are copied to a buffer given by
+ * the consumer, a chunk at a time.
+ *
+ * The range refers to the elements of the wrapped sequence, which must
+ * outlive the range (and its copies).
+ * Copying a range does not copy its elements.
+ *
+ * Typical use:
+ * <pre>
+ * for_each_chunk(range, f);  // calls f(data, n) for each chunk
+ * </pre>
+ * or, by hand:
+ * <pre>
+ * std::vector<T> buf(range.contiguous() ? 0 : 256);
+ * for (std::size_t pos = 0; pos < range.size(); )
+ * {
+ *     T const* data;
+ *     const std::size_t n = range.chunk(pos, data, buf.data(), buf.size());
+ *     ... // use data[0], ..., data[n-1]
+ *     pos += n;
+ * }
+ * </pre>
+ *
+ * \tparam T The type of elements.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T>
+class any_chunked_range
+{
+	public: typedef typename ::boost::remove_const<T>::type value_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef detail::any_chunked_range_base<value_type> impl_type;
+
+
+	/// The buffer size used by for_each_chunk() and copy().
+	public: static const size_type default_chunk_size = 256;
+
+
+	/// Creates an empty range.
+	public: any_chunked_range()
+	{
+	}
+
+	public: template <typename RAIterT>
+			any_chunked_range(RAIterT first, RAIterT last)
+	{
+		this->init(first, last, detail::is_contiguous_iterator<RAIterT>());
+	}
+
+	public: size_type size() const
+	{
+		return p_impl_ ? p_impl_->size() : 0;
+	}
+
+	public: bool empty() const
+	{
+		return this->size() == 0;
+	}
+
+	/**
+	 * Tells if the chunks are handed out without copy (i.e., if chunk()
+	 * never uses the given buffer, which may be null).
+	 */
+	public: bool contiguous() const
+	{
+		return p_impl_ ? p_impl_->contiguous() : true;
+	}
+
+	/**
+	 * Sets \a data to the elements starting at position \a pos and returns
+	 * their number, that is the size of the chunk.
+	 *
+	 * Elements not stored contiguously are copied to \a buffer, which can
+	 * hold \a buffer_size elements.
+	 *
+	 * pre: pos < size()
+	 * pre: buffer_size > 0 or contiguous()
+	 */
+	public: size_type chunk(size_type pos, value_type const*& data, value_type* buffer, size_type buffer_size) const
+	{
+		DCS_ASSERT(pos < this->size(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Position past the end of the range"));
+		DCS_ASSERT(buffer_size > 0 || this->contiguous(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Buffer needed for non-contiguous ranges"));
+
+		return p_impl_->chunk(pos, data, buffer, buffer_size);
+	}
+
+
+	private: template <typename RAIterT>
+			 void init(RAIterT first, RAIterT last, ::boost::mpl::true_)
+	{
+		if (first != last)
+		{
+			p_impl_ = ::boost::shared_ptr<impl_type const>(new detail::contiguous_chunked_range<value_type>(&*first, last-first));
+		}
+	}
+
+	private: template <typename RAIterT>
+			 void init(RAIterT first, RAIterT last, ::boost::mpl::false_)
+	{
+		p_impl_ = ::boost::shared_ptr<impl_type const>(new detail::copying_chunked_range<value_type,RAIterT>(first, last));
+	}
+
+
+	private: ::boost::shared_ptr<impl_type const> p_impl_;
+}; // any_chunked_range
+
+template <typename T>
+const typename any_chunked_range<T>::size_type any_chunked_range<T>::default_chunk_size;
+
+
+/// Calls \c f(data,n) for each chunk of the given range and returns \a f.
+template <typename T, typename FuncT>
+FuncT for_each_chunk(any_chunked_range<T> const& range, FuncT f)
+{
+	typedef typename any_chunked_range<T>::value_type value_type;
+	typedef typename any_chunked_range<T>::size_type size_type;
+
+	const size_type n(range.size());
+	::std::vector<value_type> buffer(range.contiguous() ? 0 : ::std::min(n, any_chunked_range<T>::default_chunk_size));
+	value_type* p_buffer(buffer.empty() ? 0 : &buffer[0]);
+	for (size_type pos = 0; pos < n; )
+	{
+		value_type const* data(0);
+		const size_type k(range.chunk(pos, data, p_buffer, buffer.size()));
+		f(data, k);
+		pos += k;
+	}
+	return f;
+}
+
+namespace detail {
+
+template <typename OutIterT>
+struct chunk_copier
+{
+	explicit chunk_copier(OutIterT out)
+	: out(out)
+	{
+	}
+
+	template <typename T>
+	void operator()(T const* data, ::std::size_t n)
+	{
+		out = ::std::copy(data, data+n, out);
+	}
+
+	OutIterT out;
+}; // chunk_copier
+
+} // Namespace detail
+
+/// Copies the elements of the given range to \a out.
+template <typename T, typename OutIterT>
+OutIterT copy(any_chunked_range<T> const& range, OutIterT out)
+{
+	return for_each_chunk(range, detail::chunk_copier<OutIterT>(out)).out;
+}
+
+/// Makes a chunked range over the elements of [first,last).
+template <typename RAIterT>
+any_chunked_range<typename ::std::iterator_traits<RAIterT>::value_type> make_any_chunked_range(RAIterT first, RAIterT last)
+{
+	return any_chunked_range<typename ::std::iterator_traits<RAIterT>::value_type>(first, last);
+}
+
+/// Makes a chunked range over the elements of a vector.
+template <typename T, typename AllocT>
+any_chunked_range<T> make_any_chunked_range(::std::vector<T,AllocT> const& v)
+{
+	return any_chunked_range<T>(v.begin(), v.end());
+}
+
+}} // Namespace dcs::iterator
+
+
+#endif // DCS_ITERATOR_ANY_CHUNKED_RANGE_HPP
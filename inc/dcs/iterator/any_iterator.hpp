@@ -128,7 +128,7 @@ namespace dcs { namespace iterator {
     {
       if( rhs.m_pointer_to_impl )
       {
-        m_pointer_to_impl = rhs.m_pointer_to_impl->clone();
+        m_pointer_to_impl = rhs.m_pointer_to_impl->clone(&m_buffer);
       }
       else
       {
@@ -140,8 +140,13 @@ namespace dcs { namespace iterator {
     {
       if(this != &rhs)
       {
-        any_iterator tmp(rhs);
-        swap(tmp);
+        // The new wrapper may be created in the buffer of this iterator, so
+        // the old one is destroyed first.
+        destroy();
+        if( rhs.m_pointer_to_impl )
+        {
+          m_pointer_to_impl = rhs.m_pointer_to_impl->clone(&m_buffer);
+        }
       }
 
       return *this;
@@ -190,7 +195,7 @@ namespace dcs { namespace iterator {
         Difference
       > wrapper_type;
 
-      m_pointer_to_impl = wrapper_type::create(wrapped_iterator);
+      m_pointer_to_impl = wrapper_type::create(wrapped_iterator, &m_buffer);
     }
 
     // Assignment from wrapped iterator. The enable_if condition defines
@@ -210,8 +215,17 @@ namespace dcs { namespace iterator {
     >::type &
     operator=(WrappedIterator const & wrapped_iterator)
     {
-      any_iterator tmp(wrapped_iterator);
-      swap(tmp);
+      typedef
+        detail::any_iterator_wrapper<
+        WrappedIterator,
+        Value,
+        traversal_type,
+        Reference,
+        Difference
+      > wrapper_type;
+
+      destroy();
+      m_pointer_to_impl = wrapper_type::create(wrapped_iterator, &m_buffer);
       return *this;
     }
 
@@ -222,7 +236,7 @@ namespace dcs { namespace iterator {
       const_type_with_const_value_type conversion_result;
       if( m_pointer_to_impl )
       {
-        conversion_result.m_pointer_to_impl = m_pointer_to_impl->make_const_clone_with_const_value_type();
+        conversion_result.m_pointer_to_impl = m_pointer_to_impl->make_const_clone_with_const_value_type(&conversion_result.m_buffer);
       }
       return conversion_result;
     }
@@ -234,7 +248,7 @@ namespace dcs { namespace iterator {
       const_type_with_non_const_value_type conversion_result;
       if( m_pointer_to_impl )
       {
-        conversion_result.m_pointer_to_impl = m_pointer_to_impl->make_const_clone_with_non_const_value_type();
+        conversion_result.m_pointer_to_impl = m_pointer_to_impl->make_const_clone_with_non_const_value_type(&conversion_result.m_buffer);
       }
       return conversion_result;
     }
@@ -273,18 +287,51 @@ namespace dcs { namespace iterator {
       if( m_pointer_to_impl )
       {
         typename boost::iterator_category_to_traversal<TargetTraversal>::type* funcSelector = NULL;
-        conversion_result.m_pointer_to_impl = make_traversal_converted_version(funcSelector);
+        conversion_result.m_pointer_to_impl = make_traversal_converted_version(funcSelector, &conversion_result.m_buffer);
       }
       return conversion_result;
       }
     
     ~any_iterator()
     {
-      delete m_pointer_to_impl;
+      destroy();
+    }
+
+    // Advances the iterator by n positions with a single virtual call
+    // (instead of one call per position).
+    void advance_n(Difference n)
+    {
+      m_pointer_to_impl->advance_n(n);
+    }
+
+    // Copies the next n elements to out and advances the iterator past
+    // them, with a single virtual call.
+    // For random access iterators, the block is copied by std::copy on the
+    // wrapped iterator, so that generic code can consume erased ranges in
+    // blocks at about the speed of the wrapped iterator.
+    Difference copy_n_to(typename boost::remove_const<Value>::type* out, Difference n)
+    {
+      return m_pointer_to_impl->copy_n_to(out, n, NULL);
+    }
+
+    // Like the above, but stops at last. Returns the number of copied
+    // elements.
+    Difference copy_n_to(typename boost::remove_const<Value>::type* out, Difference n, any_iterator const & last)
+    {
+      return m_pointer_to_impl->copy_n_to(out, n, last.m_pointer_to_impl);
     }
 
   private:
 
+    void destroy()
+    {
+      if( m_pointer_to_impl )
+      {
+        detail::any_iterator_destroy(m_pointer_to_impl, m_buffer);
+        m_pointer_to_impl = NULL;
+      }
+    }
+
     friend class boost::iterator_core_access;
     
     Reference dereference() const
@@ -354,22 +401,14 @@ namespace dcs { namespace iterator {
       return m_pointer_to_impl->distance_to(*(other.m_pointer_to_impl));
     }
 
-    any_iterator& swap(any_iterator& other)
-    {
-      // NOTE: iterator_facade doesn't have a swap method, so no call
-      // to base class here.
-      std::swap(m_pointer_to_impl, other.m_pointer_to_impl);
-      return *this;
-    }
-
     detail::any_iterator_abstract_base<
       Value,
       boost::incrementable_traversal_tag,
       Reference,
       Difference
-    >* make_traversal_converted_version(boost::incrementable_traversal_tag* funcSelector) const
+    >* make_traversal_converted_version(boost::incrementable_traversal_tag* /*funcSelector*/, void* buffer) const
     {
-      return m_pointer_to_impl->make_incrementable_version();
+      return m_pointer_to_impl->make_incrementable_version(buffer);
     }
 
     detail::any_iterator_abstract_base<
@@ -377,9 +416,9 @@ namespace dcs { namespace iterator {
       boost::single_pass_traversal_tag,
       Reference,
       Difference
-    >* make_traversal_converted_version(boost::single_pass_traversal_tag* funcSelector) const
+    >* make_traversal_converted_version(boost::single_pass_traversal_tag* /*funcSelector*/, void* buffer) const
     {
-      return m_pointer_to_impl->make_single_pass_version();
+      return m_pointer_to_impl->make_single_pass_version(buffer);
     }
 
     detail::any_iterator_abstract_base<
@@ -387,9 +426,9 @@ namespace dcs { namespace iterator {
       boost::forward_traversal_tag,
       Reference,
       Difference
-    >* make_traversal_converted_version(boost::forward_traversal_tag* funcSelector) const
+    >* make_traversal_converted_version(boost::forward_traversal_tag* /*funcSelector*/, void* buffer) const
     {
-      return m_pointer_to_impl->make_forward_version();
+      return m_pointer_to_impl->make_forward_version(buffer);
     }
 
     detail::any_iterator_abstract_base<
@@ -397,13 +436,16 @@ namespace dcs { namespace iterator {
       boost::bidirectional_traversal_tag,
       Reference,
       Difference
-    >* make_traversal_converted_version(boost::bidirectional_traversal_tag* funcSelector) const
+    >* make_traversal_converted_version(boost::bidirectional_traversal_tag* /*funcSelector*/, void* buffer) const
     {
-      return m_pointer_to_impl->make_bidirectional_version();
+      return m_pointer_to_impl->make_bidirectional_version(buffer);
     }
 
     abstract_base_type* m_pointer_to_impl;
 
+    // Storage for m_pointer_to_impl, if the wrapper is small enough.
+    detail::any_iterator_buffer m_buffer;
+
   };
 
   // Metafunction that takes an iterator and returns an any_iterator with the same
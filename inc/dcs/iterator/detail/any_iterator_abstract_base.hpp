@@ -28,12 +28,66 @@
 // ========
 
 #include <dcs/iterator/detail/any_iterator_metafunctions.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/type_traits/add_const.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 #include <boost/type_traits/remove_const.hpp>
+#include <cstddef>
+#include <functional>
+#include <new>
+
+// The size (in bytes) of the buffer embedded in every any_iterator.
+// Wrappers of iterators that fit in it are stored there instead of on the
+// heap, so that copying such an any_iterator does not allocate.
+#ifndef DCS_ITERATOR_ANY_ITERATOR_BUFFER_SIZE
+# define DCS_ITERATOR_ANY_ITERATOR_BUFFER_SIZE (6*sizeof(void*))
+#endif // DCS_ITERATOR_ANY_ITERATOR_BUFFER_SIZE
 
 namespace dcs { namespace iterator { namespace detail {
 
+    ///////////////////////////////////////////////////////////////////////
+    // 
+    // Storage for small wrappers, aligned for any fundamental type.
+    //
+    union any_iterator_buffer
+    {
+      char bytes[DCS_ITERATOR_ANY_ITERATOR_BUFFER_SIZE];
+      void* align_pointer;
+      long double align_long_double;
+      boost::intmax_t align_int;
+    };
+
+    // Creates a T from arg, inside buffer if not NULL and large enough or
+    // on the heap otherwise.
+    template<class T, class Arg>
+    T* any_iterator_create(Arg const & arg, void* buffer)
+    {
+      if( buffer != NULL
+          && sizeof(T) <= sizeof(any_iterator_buffer)
+          && boost::alignment_of<T>::value <= boost::alignment_of<any_iterator_buffer>::value )
+      {
+        return new (buffer) T(arg);
+      }
+      return new T(arg);
+    }
+
+    // Destroys an object created by any_iterator_create.
+    template<class T>
+    void any_iterator_destroy(T* p, any_iterator_buffer const & buffer)
+    {
+      char const* addr = reinterpret_cast<char const*>(p);
+      if( !std::less<char const*>()(addr, buffer.bytes)
+          && std::less<char const*>()(addr, buffer.bytes+sizeof(buffer)) )
+      {
+        p->~T();
+      }
+      else
+      {
+        delete p;
+      }
+    }
+
     ///////////////////////////////////////////////////////////////////////
     // 
     // The partial specializations of any_iterator_abstract_base (which is
@@ -101,11 +155,13 @@ namespace dcs { namespace iterator { namespace detail {
     public:
 
       // Plain clone function for copy construction and assignment.
-      virtual clone_result_type * clone() const=0;
+      // Like all the functions creating wrappers, the result is stored in
+      // buffer (see any_iterator_create).
+      virtual clone_result_type * clone(void* buffer) const=0;
   
       // Clone functions for conversion to a const iterator
-      virtual const_clone_with_const_value_type_result_type * make_const_clone_with_const_value_type() const=0;
-      virtual const_clone_with_non_const_value_type_result_type * make_const_clone_with_non_const_value_type() const=0;
+      virtual const_clone_with_const_value_type_result_type * make_const_clone_with_const_value_type(void* buffer) const=0;
+      virtual const_clone_with_non_const_value_type_result_type * make_const_clone_with_non_const_value_type(void* buffer) const=0;
 
       // gcc 3.4.2 does not like pure virtual declaration with inline definition,
       // so I make the destructor non-pure just to spite them.
@@ -115,6 +171,9 @@ namespace dcs { namespace iterator { namespace detail {
       virtual Reference dereference() const=0;
       virtual void increment() = 0;
 
+      // Advances by n positions with a single virtual call.
+      virtual void advance_n(Difference n) = 0;
+
     };
 
     ///////////////////////////////////////////////////////////////////////
@@ -145,12 +204,16 @@ namespace dcs { namespace iterator { namespace detail {
       // gcc 3.4.2 insists on qualification of most_derived_type.
       virtual bool equal(typename any_iterator_abstract_base::most_derived_type const &) const = 0;
 
+      // Copies at most n elements to out, advancing accordingly, and stops
+      // at last (if not NULL). Returns the number of copied elements.
+      virtual Difference copy_n_to(typename boost::remove_const<Value>::type* out, Difference n, typename any_iterator_abstract_base::most_derived_type const * last) = 0;
+
       virtual any_iterator_abstract_base<
         Value,
         boost::incrementable_traversal_tag,
         Reference,
         Difference
-      >* make_incrementable_version() const=0;
+      >* make_incrementable_version(void* buffer) const=0;
     };
 
     ///////////////////////////////////////////////////////////////////////
@@ -181,7 +244,7 @@ namespace dcs { namespace iterator { namespace detail {
         boost::single_pass_traversal_tag,
         Reference,
         Difference
-      >* make_single_pass_version() const=0;
+      >* make_single_pass_version(void* buffer) const=0;
     };
 
     ///////////////////////////////////////////////////////////////////////
@@ -216,7 +279,7 @@ namespace dcs { namespace iterator { namespace detail {
         boost::forward_traversal_tag,
         Reference,
         Difference
-      >* make_forward_version() const=0;
+      >* make_forward_version(void* buffer) const=0;
     };
 
     ///////////////////////////////////////////////////////////////////////
@@ -254,7 +317,7 @@ namespace dcs { namespace iterator { namespace detail {
         boost::bidirectional_traversal_tag,
         Reference,
         Difference
-      >* make_bidirectional_version() const=0;
+      >* make_bidirectional_version(void* buffer) const=0;
     };
 
 }}} // Namespace dcs::iterator::detail
@@ -32,6 +32,7 @@
 #include <boost/type_traits/add_const.hpp>
 #include <boost/type_traits/remove_const.hpp>
 #include <boost/cast.hpp>
+#include <algorithm>
 
 namespace dcs { namespace iterator { namespace detail {
   
@@ -124,26 +125,26 @@ namespace dcs { namespace iterator { namespace detail {
         m_wrapped_iterator(wrapped_iterator)
       {}
 
-      static abstract_base_type* create(WrappedIterator wrapped_iterator)
+      static abstract_base_type* create(WrappedIterator wrapped_iterator, void* buffer = NULL)
       {
-        return new clone_type(wrapped_iterator);
+        return any_iterator_create<clone_type>(wrapped_iterator, buffer);
       }
 
       // Plain clone function for copy construction and assignment.
-      virtual clone_result_type * clone() const
+      virtual clone_result_type * clone(void* buffer) const
       {
-        return new clone_type(m_wrapped_iterator);
+        return any_iterator_create<clone_type>(m_wrapped_iterator, buffer);
       }
   
       // Clone functions for conversion to a const iterator
-      virtual const_clone_with_const_value_type_result_type* make_const_clone_with_const_value_type() const
+      virtual const_clone_with_const_value_type_result_type* make_const_clone_with_const_value_type(void* buffer) const
       {
-        return new const_clone_type_with_const_value_type(m_wrapped_iterator);
+        return any_iterator_create<const_clone_type_with_const_value_type>(m_wrapped_iterator, buffer);
       }
       //
-      virtual const_clone_with_non_const_value_type_result_type* make_const_clone_with_non_const_value_type() const
+      virtual const_clone_with_non_const_value_type_result_type* make_const_clone_with_non_const_value_type(void* buffer) const
       {
-        return new const_clone_type_with_non_const_value_type(m_wrapped_iterator);
+        return any_iterator_create<const_clone_type_with_non_const_value_type>(m_wrapped_iterator, buffer);
       }
       
       virtual Reference dereference() const
@@ -158,6 +159,14 @@ namespace dcs { namespace iterator { namespace detail {
         ++m_wrapped_iterator;
       }
 
+      virtual void advance_n(Difference n)
+      {
+        for( ; n > 0; --n )
+        {
+          ++m_wrapped_iterator;
+        }
+      }
+
     protected:
 
       WrappedIterator& get_wrapped_iterator()
@@ -226,20 +235,44 @@ namespace dcs { namespace iterator { namespace detail {
         return this->get_wrapped_iterator() == boost::polymorphic_downcast<any_iterator_wrapper const *>(&rhs)->get_wrapped_iterator();
       }
 
+      virtual Difference copy_n_to(typename boost::remove_const<Value>::type* out, Difference n, typename any_iterator_wrapper::abstract_base_type const * last)
+      {
+        WrappedIterator& it = this->get_wrapped_iterator();
+        Difference k = 0;
+        if( last == NULL )
+        {
+          for( ; k < n; ++k, ++it, ++out )
+          {
+            *out = *it;
+          }
+        }
+        else
+        {
+          WrappedIterator const & last_it = boost::polymorphic_downcast<any_iterator_wrapper const *>(last)->get_wrapped_iterator();
+          for( ; k < n && !(it == last_it); ++k, ++it, ++out )
+          {
+            *out = *it;
+          }
+        }
+        return k;
+      }
+
       any_iterator_abstract_base<
         Value,
         boost::incrementable_traversal_tag,
         Reference,
         Difference
-      >* make_incrementable_version() const
+      >* make_incrementable_version(void* buffer) const
       {
-        return new any_iterator_wrapper<
-          WrappedIterator,
-          Value,
-          boost::incrementable_traversal_tag,
-          Reference,
-          Difference
-        >(this->get_wrapped_iterator());
+        return any_iterator_create<
+          any_iterator_wrapper<
+            WrappedIterator,
+            Value,
+            boost::incrementable_traversal_tag,
+            Reference,
+            Difference
+          >
+        >(this->get_wrapped_iterator(), buffer);
       }
     };
 
@@ -292,15 +325,17 @@ namespace dcs { namespace iterator { namespace detail {
         boost::single_pass_traversal_tag,
         Reference,
         Difference
-      >* make_single_pass_version() const
+      >* make_single_pass_version(void* buffer) const
       {
-        return new any_iterator_wrapper<
-          WrappedIterator,
-          Value,
-          boost::single_pass_traversal_tag,
-          Reference,
-          Difference
-        >(this->get_wrapped_iterator());
+        return any_iterator_create<
+          any_iterator_wrapper<
+            WrappedIterator,
+            Value,
+            boost::single_pass_traversal_tag,
+            Reference,
+            Difference
+          >
+        >(this->get_wrapped_iterator(), buffer);
       }
     };
 
@@ -353,20 +388,34 @@ namespace dcs { namespace iterator { namespace detail {
         --(this->get_wrapped_iterator());
       }
 
+      virtual void advance_n(Difference n)
+      {
+        for( ; n > 0; --n )
+        {
+          ++(this->get_wrapped_iterator());
+        }
+        for( ; n < 0; ++n )
+        {
+          --(this->get_wrapped_iterator());
+        }
+      }
+
       any_iterator_abstract_base<
         Value,
         boost::forward_traversal_tag,
         Reference,
         Difference
-      >* make_forward_version() const
+      >* make_forward_version(void* buffer) const
       {
-        return new any_iterator_wrapper<
-          WrappedIterator,
-          Value,
-          boost::forward_traversal_tag,
-          Reference,
-          Difference
-        >(this->get_wrapped_iterator());
+        return any_iterator_create<
+          any_iterator_wrapper<
+            WrappedIterator,
+            Value,
+            boost::forward_traversal_tag,
+            Reference,
+            Difference
+          >
+        >(this->get_wrapped_iterator(), buffer);
       }
     };
 
@@ -419,6 +468,30 @@ namespace dcs { namespace iterator { namespace detail {
         this->get_wrapped_iterator() += n;
       }
 
+      virtual void advance_n(Difference n)
+      {
+        this->get_wrapped_iterator() += n;
+      }
+
+      // The whole block is copied by std::copy, which is specialized for
+      // the wrapped iterator (e.g., it becomes a memmove for pointers to
+      // trivially copyable types).
+      virtual Difference copy_n_to(typename boost::remove_const<Value>::type* out, Difference n, typename any_iterator_wrapper::abstract_base_type const * last)
+      {
+        WrappedIterator& it = this->get_wrapped_iterator();
+        if( last != NULL )
+        {
+          n = std::min(n, Difference(boost::polymorphic_downcast<any_iterator_wrapper const *>(last)->get_wrapped_iterator() - it));
+        }
+        if( n <= 0 )
+        {
+          return 0;
+        }
+        std::copy(it, it+n, out);
+        it += n;
+        return n;
+      }
+
       // gcc 3.4.2 insists on qualification of abstract_base_type.
       virtual Difference distance_to(typename any_iterator_wrapper::abstract_base_type const & other) const
       {
@@ -430,15 +503,17 @@ namespace dcs { namespace iterator { namespace detail {
         boost::bidirectional_traversal_tag,
         Reference,
         Difference
-      >* make_bidirectional_version() const
+      >* make_bidirectional_version(void* buffer) const
       {
-        return new any_iterator_wrapper<
-          WrappedIterator,
-          Value,
-          boost::bidirectional_traversal_tag,
-          Reference,
-          Difference
-        >(this->get_wrapped_iterator());
+        return any_iterator_create<
+          any_iterator_wrapper<
+            WrappedIterator,
+            Value,
+            boost::bidirectional_traversal_tag,
+            Reference,
+            Difference
+          >
+        >(this->get_wrapped_iterator(), buffer);
       }
     };
 
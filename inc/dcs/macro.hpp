@@ -64,6 +64,13 @@ inline void suppress_unused_variable_warning(T const&) {}
 # undef DCS_MACRO_CXX14
 #endif // DCS_MACRO_CXX114
 
+/// Declares a function or a variable as constexpr, when supported by the compiler
+#ifdef DCS_MACRO_CXX11
+# define DCS_MACRO_CONSTEXPR constexpr
+#else
+# define DCS_MACRO_CONSTEXPR /*empty*/
+#endif // DCS_MACRO_CXX11
+
 /// Suppresses the "unused variable" warning issued during compilation.
 // TODO: see also boost/core/ignore_used.hpp
 #define DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(x) \
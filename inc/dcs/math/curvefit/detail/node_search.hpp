@@ -0,0 +1,146 @@
+/**
+ * \file dcs/math/curvefit/detail/node_search.hpp
+ *
+ * \brief Search of the interpolation interval where a point falls.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_CURVEFIT_DETAIL_NODE_SEARCH_HPP
+#define DCS_MATH_CURVEFIT_DETAIL_NODE_SEARCH_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/math/traits/float.hpp>
+
+
+namespace dcs { namespace math { namespace curvefit { namespace detail {
+
+/**
+ * \brief Locate a given value using a sequential search.
+ *
+ * Given a set of \a n nodes \f$\{x_0,\ldots,x_{n-1}\}\f$ (with \f$n \ge 2\f$)
+ * stored in \a xx and a point \f$x\f$, finds the position \f$0 \le k < n-1\f$
+ * of the interval \f$[x_0,x_{n-1}]\f$ where \f$x\f$ falls such that:
+ * \f{equation}
+ * \begin{cases}
+ * 0, & x \le x_0,\\
+ * k, & x_k \le x < x_{k+1},\\
+ * n-2, & x \ge x_{n-1},\\
+ * \end{cases}
+ * \f}
+ */
+template <typename RealT>
+::std::size_t sequential_find(RealT const* xx, ::std::size_t n, RealT x)
+{
+	if (::dcs::math::float_traits<RealT>::approximately_less_equal(x, xx[0]))
+	{
+		return 0;
+	}
+
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		if (::dcs::math::float_traits<RealT>::definitely_less(x, xx[i]))
+		{
+			return i-1;
+		}
+	}
+
+	return n-2;
+}
+
+/**
+ * \brief Locate a given value by binary search.
+ *
+ * \see sequential_find for the meaning of the returned position.
+ */
+template <typename RealT>
+::std::size_t bsearch_find(RealT const* xx, ::std::size_t n, RealT x)
+{
+	// Handle out-of-domain points
+	if (::dcs::math::float_traits<RealT>::approximately_less_equal(x, xx[0]))
+	{
+		return 0;
+	}
+	if (::dcs::math::float_traits<RealT>::approximately_greater_equal(x, xx[n-1]))
+	{
+		return n-2;
+	}
+
+	::std::size_t lo(0);
+	::std::size_t hi(n-1);
+
+	while (lo < (hi-1))
+	{
+		const ::std::size_t mid((hi+lo) >> 1);
+		if (::dcs::math::float_traits<RealT>::definitely_less(x, xx[mid]))
+		{
+			hi = mid;
+		}
+		else
+		{
+			lo = mid;
+		}
+	}
+
+	//post: the returned index is >= 0 and < (n-1)
+	DCS_DEBUG_ASSERT( lo < (n-1) );
+
+	return lo;
+}
+
+/**
+ * \brief Locate a given value starting from a previously found interval.
+ *
+ * Meant for coherent streams of points, where consecutive points usually
+ * fall in the same interval or in an adjacent one.
+ * The interval \a hint (typically, the result of a previous search) and its
+ * two neighbors are checked first; only if \f$x\f$ falls elsewhere, a binary
+ * search is performed.
+ *
+ * \see sequential_find for the meaning of the returned position.
+ */
+template <typename RealT>
+::std::size_t hinted_find(RealT const* xx, ::std::size_t n, RealT x, ::std::size_t hint)
+{
+	// Only inner intervals are checked here, since the outermost ones must
+	// also handle out-of-domain points (which is left to the binary search)
+	if (n > 3)
+	{
+		const ::std::size_t lo(hint > 1 ? hint-1 : 1);
+		const ::std::size_t hi(hint < (n-4) ? hint+1 : n-3);
+
+		for (::std::size_t k = lo; k <= hi; ++k)
+		{
+			if (!::dcs::math::float_traits<RealT>::definitely_less(x, xx[k])
+				&& ::dcs::math::float_traits<RealT>::definitely_less(x, xx[k+1]))
+			{
+				return k;
+			}
+		}
+	}
+
+	return bsearch_find(xx, n, x);
+}
+
+}}}} // Namespace dcs::math::curvefit::detail
+
+
+#endif // DCS_MATH_CURVEFIT_DETAIL_NODE_SEARCH_HPP
@@ -27,10 +27,13 @@
 
 
 #include <dcs/math/curvefit/interpolation/base1d.hpp>
+#include <dcs/math/curvefit/interpolation/basend.hpp>
 #include <dcs/math/curvefit/interpolation/constant.hpp>
 #include <dcs/math/curvefit/interpolation/cubic_spline.hpp>
 #include <dcs/math/curvefit/interpolation/linear.hpp>
+#include <dcs/math/curvefit/interpolation/multilinear.hpp>
 #include <dcs/math/curvefit/interpolation/nearest.hpp>
+#include <dcs/math/curvefit/interpolation/tensor_cubic_spline.hpp>
 
 
 #endif // DCS_MATH_CURVEFIT_INTERPOLATION_HPP
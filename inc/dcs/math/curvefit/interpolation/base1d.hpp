@@ -32,7 +32,8 @@
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
-#include <dcs/math/traits/float.hpp>
+#include <dcs/iterator/any_chunked_range.hpp>
+#include <dcs/math/curvefit/detail/node_search.hpp>
 #include <stdexcept>
 #include <vector>
 
@@ -85,7 +86,19 @@ class base_1d_interpolator
 
 	public: ::std::vector<real_type> values() const
 	{
-		return yy_();
+		return yy_;
+	}
+
+	/// Returns the nodes without copying them; the range must not outlive this interpolator.
+	public: ::dcs::iterator::any_chunked_range<real_type> node_range() const
+	{
+		return ::dcs::iterator::make_any_chunked_range(xx_);
+	}
+
+	/// Returns the values without copying them; the range must not outlive this interpolator.
+	public: ::dcs::iterator::any_chunked_range<real_type> value_range() const
+	{
+		return ::dcs::iterator::make_any_chunked_range(yy_);
 	}
 
 	public: real_type node(::std::size_t i) const
@@ -121,55 +134,13 @@ class base_1d_interpolator
 	/// Locate a given value using a sequential search
 	protected: ::std::size_t sequential_find(real_type x) const
 	{
-		if (::dcs::math::float_traits<real_type>::approximately_less_equal(x, xx_[0]))
-		{
-			return 0;
-		}
-
-		for (::std::size_t i = 1; i < n_; ++i)
-		{
-			if (::dcs::math::float_traits<real_type>::definitely_less(x, xx_[i]))
-			{
-				return i-1;
-			}
-		}
-
-		return n_-2;
+		return detail::sequential_find(&xx_[0], n_, x);
 	}
 
 	/// Locate a given value by binary search
 	protected: ::std::size_t bsearch_find(real_type x) const
 	{
-		// Handle out-of-domain points
-		if (::dcs::math::float_traits<real_type>::approximately_less_equal(x, xx_[0]))
-		{
-			return 0;
-		}
-		if (::dcs::math::float_traits<real_type>::approximately_greater_equal(x, xx_[n_-1]))
-		{
-			return n_-2;
-		}
-
-		::std::size_t lo(0);
-		::std::size_t hi(n_-1);
-
-		while (lo < (hi-1))
-		{
-			const ::std::size_t mid((hi+lo) >> 1);
-			if (::dcs::math::float_traits<real_type>::definitely_less(x, xx_[mid]))
-			{
-				hi = mid;
-			}
-			else
-			{
-				lo = mid;
-			}
-		}
-
-		//post: the returned index is >= 0 and < (n-1)
-		DCS_DEBUG_ASSERT( lo >= 0 && lo < (n_-1) );
-
-		return lo;
+		return detail::bsearch_find(&xx_[0], n_, x);
 	}
 
 	private: virtual real_type do_interpolate(real_type x) const = 0;
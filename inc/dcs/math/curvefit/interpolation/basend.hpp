@@ -0,0 +1,403 @@
+/**
+ * \file dcs/math/curvefit/interpolation/basend.hpp
+ *
+ * \brief Base class for multi-dimensional interpolation over regular grids.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_CURVEFIT_INTERPOLATION_BASEND_HPP
+#define DCS_MATH_CURVEFIT_INTERPOLATION_BASEND_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/iterator/any_chunked_range.hpp>
+#include <dcs/math/curvefit/detail/node_search.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace math { namespace curvefit {
+
+/**
+ * \brief Base class for interpolation of gridded data in N dimensions.
+ *
+ * The grid is defined by the cartesian product of \f$N\f$ strictly
+ * increasing sequences of nodes \f$x^{(i)}_0<\cdots<x^{(i)}_{n_i-1}\f$, for
+ * \f$i=0,\ldots,N-1\f$, and by the values at each grid point.
+ * Values are stored contiguously in row-major order, that is the value at
+ * grid point \f$(k_0,\ldots,k_{N-1})\f$ is at position
+ * \f$(\cdots((k_0 n_1+k_1)n_2+k_2)\cdots)n_{N-1}+k_{N-1}\f$ (the last axis
+ * is the fastest varying one).
+ *
+ * Points can be interpolated one at a time or in batch.
+ * In batch mode, the grid cell found for a point is used as the starting
+ * point for locating the next one, so that coherent streams of points (e.g.,
+ * points along a curve) avoid a full binary search on each axis.
+ *
+ * As in the one-dimensional case, points outside the grid are extrapolated
+ * from the outermost cells.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class base_nd_interpolator
+{
+	public: typedef RealT real_type;
+	private: static const ::std::size_t max_stack_dimensions = 8;
+	private: static const ::std::size_t max_stack_workspace = 64;
+
+
+	public: base_nd_interpolator()
+	: xx_(),
+	  yy_(),
+	  ns_(),
+	  offs_(),
+	  strides_()
+	{
+	}
+
+	/**
+	 * \brief Builds an N-dimensional grid.
+	 *
+	 * \param first_axis Iterator to the first axis; each axis is a container
+	 *  of nodes exposing \c begin() and \c end().
+	 * \param last_axis Iterator past the last axis.
+	 * \param first_v Iterator to the first grid value (in row-major order).
+	 * \param last_v Iterator past the last grid value.
+	 */
+	public: template <typename AxisIterT, typename ValueIterT>
+			base_nd_interpolator(AxisIterT first_axis, AxisIterT last_axis, ValueIterT first_v, ValueIterT last_v)
+	: xx_(),
+	  yy_(first_v, last_v),
+	  ns_(),
+	  offs_(),
+	  strides_()
+	{
+		for (; first_axis != last_axis; ++first_axis)
+		{
+			offs_.push_back(xx_.size());
+			xx_.insert(xx_.end(), (*first_axis).begin(), (*first_axis).end());
+			ns_.push_back(xx_.size()-offs_.back());
+		}
+
+		this->init();
+	}
+
+	/**
+	 * \brief Builds a two-dimensional grid.
+	 *
+	 * The value at node \f$(x_i,y_j)\f$ is at position \f$i n_y+j\f$ of the
+	 * sequence of values, where \f$n_y\f$ is the number of nodes along the
+	 * second axis.
+	 */
+	public: template <typename XIterT, typename YIterT, typename ZIterT>
+			base_nd_interpolator(XIterT first_x, XIterT last_x, YIterT first_y, YIterT last_y, ZIterT first_z, ZIterT last_z)
+	: xx_(first_x, last_x),
+	  yy_(first_z, last_z),
+	  ns_(),
+	  offs_(),
+	  strides_()
+	{
+		offs_.push_back(0);
+		ns_.push_back(xx_.size());
+		offs_.push_back(xx_.size());
+		xx_.insert(xx_.end(), first_y, last_y);
+		ns_.push_back(xx_.size()-offs_.back());
+
+		this->init();
+	}
+
+	public: virtual ~base_nd_interpolator()
+	{
+	}
+
+	/// Interpolates a two-dimensional grid at point \f$(x,y)\f$.
+	public: real_type operator()(real_type x, real_type y) const
+	{
+		DCS_ASSERT(ns_.size() == 2,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Grid is not two-dimensional"));
+
+		const real_type xy[2] = {x, y};
+
+		return this->interpolate_point(xy);
+	}
+
+	/// Interpolates a three-dimensional grid at point \f$(x,y,z)\f$.
+	public: real_type operator()(real_type x, real_type y, real_type z) const
+	{
+		DCS_ASSERT(ns_.size() == 3,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Grid is not three-dimensional"));
+
+		const real_type xyz[3] = {x, y, z};
+
+		return this->interpolate_point(xyz);
+	}
+
+	/// Interpolates the grid at the point whose coordinates start at \a first_coord.
+	public: template <typename IterT>
+			real_type interpolate(IterT first_coord) const
+	{
+		const ::std::vector<real_type> x(first_coord, first_coord+ns_.size());
+
+		return this->interpolate_point(&x[0]);
+	}
+
+	/**
+	 * \brief Interpolates the grid at a batch of points.
+	 *
+	 * The coordinates of points are stored one point after the other in the
+	 * range [\a first_coord, \a last_coord), whose length must be a multiple
+	 * of the number of dimensions.
+	 * Interpolated values are written starting from \a out.
+	 *
+	 * \return The output iterator past the last written value.
+	 */
+	public: template <typename InIterT, typename OutIterT>
+			OutIterT interpolate(InIterT first_coord, InIterT last_coord, OutIterT out) const
+	{
+		const ::std::size_t nd(ns_.size());
+
+		::std::vector<real_type> x(nd);
+		::std::vector< ::std::size_t > cell(nd, 0);
+		::std::vector<real_type> work(this->do_workspace_size());
+
+		while (first_coord != last_coord)
+		{
+			for (::std::size_t i = 0; i < nd; ++i)
+			{
+				DCS_ASSERT(first_coord != last_coord,
+						   DCS_EXCEPTION_THROW(::std::invalid_argument,
+											   "Number of coordinates is not a multiple of the number of dimensions"));
+
+				x[i] = *first_coord;
+				++first_coord;
+			}
+
+			this->locate(&x[0], &cell[0], true);
+
+			*out = this->do_interpolate(&x[0], &cell[0], &work[0]);
+			++out;
+		}
+
+		return out;
+	}
+
+	public: ::std::size_t dimensions() const
+	{
+		return ns_.size();
+	}
+
+	public: ::std::size_t num_nodes(::std::size_t axis) const
+	{
+		return ns_[axis];
+	}
+
+	public: ::std::vector<real_type> nodes(::std::size_t axis) const
+	{
+		return ::std::vector<real_type>(xx_.begin()+offs_[axis], xx_.begin()+offs_[axis]+ns_[axis]);
+	}
+
+	/// Returns the nodes of the given axis without copying them; the range must not outlive this interpolator.
+	public: ::dcs::iterator::any_chunked_range<real_type> node_range(::std::size_t axis) const
+	{
+		return ::dcs::iterator::make_any_chunked_range(xx_.begin()+offs_[axis], xx_.begin()+offs_[axis]+ns_[axis]);
+	}
+
+	/// Returns the grid values (in row-major order) without copying them; the range must not outlive this interpolator.
+	public: ::dcs::iterator::any_chunked_range<real_type> value_range() const
+	{
+		return ::dcs::iterator::make_any_chunked_range(yy_);
+	}
+
+	public: real_type node(::std::size_t axis, ::std::size_t i) const
+	{
+		return xx_[offs_[axis]+i];
+	}
+
+	public: ::std::size_t num_values() const
+	{
+		return yy_.size();
+	}
+
+	/// Returns the value at the given position of the row-major value storage.
+	public: real_type value(::std::size_t i) const
+	{
+		return yy_[i];
+	}
+
+	/// Returns the distance between two consecutive grid points along the given axis, in the value storage.
+	public: ::std::size_t stride(::std::size_t axis) const
+	{
+		return strides_[axis];
+	}
+
+	/**
+	 * Locates the grid cell where a given point falls.
+	 *
+	 * For each axis \f$i\f$, the position \f$0 \le k_i < n_i-1\f$ of the
+	 * interval where the \f$i\f$-th coordinate falls is stored in
+	 * \a cell (see base_1d_interpolator::find).
+	 * If \a use_hint is \c true, \a cell must hold a previously found cell
+	 * which is used as the starting point of the search.
+	 */
+	protected: void locate(real_type const* x, ::std::size_t* cell, bool use_hint) const
+	{
+		const ::std::size_t nd(ns_.size());
+
+		for (::std::size_t i = 0; i < nd; ++i)
+		{
+			cell[i] = use_hint
+					  ? detail::hinted_find(&xx_[offs_[i]], ns_[i], x[i], cell[i])
+					  : detail::bsearch_find(&xx_[offs_[i]], ns_[i], x[i]);
+		}
+	}
+
+	/// Returns the nodes of the given axis as a contiguous array.
+	protected: real_type const* axis_data(::std::size_t axis) const
+	{
+		return &xx_[offs_[axis]];
+	}
+
+	/// Returns the grid values as a contiguous row-major array.
+	protected: real_type const* value_data() const
+	{
+		return &yy_[0];
+	}
+
+	/// Returns the position in the value storage of the lower corner of a grid cell.
+	protected: ::std::size_t cell_offset(::std::size_t const* cell) const
+	{
+		const ::std::size_t nd(ns_.size());
+
+		::std::size_t off(0);
+		for (::std::size_t i = 0; i < nd; ++i)
+		{
+			off += cell[i]*strides_[i];
+		}
+
+		return off;
+	}
+
+	/**
+	 * Returns the position in the value storage of a corner of a grid cell.
+	 *
+	 * The corner is identified by a bit mask where bit \f$i\f$ tells whether
+	 * the corner is at the lower (0) or at the upper (1) node along axis
+	 * \f$i\f$.
+	 */
+	protected: ::std::size_t corner_offset(::std::size_t cell_off, ::std::size_t corner) const
+	{
+		for (::std::size_t i = 0; corner != 0; ++i, corner >>= 1)
+		{
+			if (corner & 1)
+			{
+				cell_off += strides_[i];
+			}
+		}
+
+		return cell_off;
+	}
+
+	private: void init()
+	{
+		const ::std::size_t nd(ns_.size());
+
+		DCS_ASSERT(nd >= 1,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Invalid number of dimensions"));
+
+		strides_.resize(nd);
+
+		::std::size_t nv(1);
+		for (::std::size_t i = nd; i > 0; --i)
+		{
+			const ::std::size_t k(i-1);
+
+			DCS_ASSERT(ns_[k] >= 2,
+					   DCS_EXCEPTION_THROW(::std::invalid_argument,
+										   "Insufficient number of nodes. Required at least 2 nodes per axis"));
+
+			for (::std::size_t j = 1; j < ns_[k]; ++j)
+			{
+				if (::dcs::math::float_traits<real_type>::approximately_less_equal(xx_[offs_[k]+j], xx_[offs_[k]+j-1]))
+				{
+					DCS_EXCEPTION_THROW(::std::invalid_argument,
+										"Node sequence is not a strictly increasing sequence");
+				}
+			}
+
+			strides_[k] = nv;
+			nv *= ns_[k];
+		}
+
+		DCS_ASSERT(nv == yy_.size(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of values does not match the size of the grid"));
+	}
+
+	private: real_type interpolate_point(real_type const* x) const
+	{
+		const ::std::size_t nd(ns_.size());
+		const ::std::size_t nw(this->do_workspace_size());
+
+		// Avoid heap allocations for small grids
+		if (nd <= max_stack_dimensions && nw <= max_stack_workspace)
+		{
+			::std::size_t cell[max_stack_dimensions];
+			real_type work[max_stack_workspace];
+
+			this->locate(x, cell, false);
+
+			return this->do_interpolate(x, cell, work);
+		}
+
+		::std::vector< ::std::size_t > cell(nd);
+		::std::vector<real_type> work(nw);
+
+		this->locate(x, &cell[0], false);
+
+		return this->do_interpolate(x, &cell[0], &work[0]);
+	}
+
+	/// Returns the number of scratch elements needed by \c do_interpolate.
+	private: virtual ::std::size_t do_workspace_size() const = 0;
+
+	/**
+	 * Interpolates the point \a x falling in grid cell \a cell, using the
+	 * given scratch array \a work of \c do_workspace_size() elements.
+	 */
+	private: virtual real_type do_interpolate(real_type const* x, ::std::size_t const* cell, real_type* work) const = 0;
+
+
+	private: ::std::vector<real_type> xx_; ///< Nodes of all axes, one axis after the other
+	private: ::std::vector<real_type> yy_; ///< Grid values in row-major order
+	private: ::std::vector< ::std::size_t > ns_; ///< Number of nodes per axis
+	private: ::std::vector< ::std::size_t > offs_; ///< Position of the first node of each axis in xx_
+	private: ::std::vector< ::std::size_t > strides_; ///< Strides of each axis in yy_
+}; // base_nd_interpolator
+
+}}} // Namespace dcs::math::curvefit
+
+#endif // DCS_MATH_CURVEFIT_INTERPOLATION_BASEND_HPP
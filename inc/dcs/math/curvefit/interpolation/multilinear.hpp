@@ -0,0 +1,106 @@
+/**
+ * \file dcs/math/curvefit/interpolation/multilinear.hpp
+ *
+ * \brief Multilinear (bilinear, trilinear, ...) interpolation of gridded data.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_CURVEFIT_INTERPOLATION_MULTILINEAR_HPP
+#define DCS_MATH_CURVEFIT_INTERPOLATION_MULTILINEAR_HPP
+
+
+#include <cstddef>
+#include <dcs/math/curvefit/interpolation/basend.hpp>
+
+
+namespace dcs { namespace math { namespace curvefit {
+
+/**
+ * \brief Multilinear interpolation over a regular grid.
+ *
+ * The interpolated value is obtained by successive linear interpolations
+ * along each axis, using the \f$2^N\f$ corners of the grid cell where the
+ * point falls (i.e., bilinear interpolation for \f$N=2\f$ and trilinear
+ * interpolation for \f$N=3\f$).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class multilinear_interpolator: public base_nd_interpolator<RealT>
+{
+	public: typedef RealT real_type;
+	private: typedef base_nd_interpolator<real_type> base_type;
+
+
+	public: template <typename AxisIterT, typename ValueIterT>
+			multilinear_interpolator(AxisIterT first_axis, AxisIterT last_axis, ValueIterT first_v, ValueIterT last_v)
+	: base_type(first_axis, last_axis, first_v, last_v)
+	{
+	}
+
+	public: template <typename XIterT, typename YIterT, typename ZIterT>
+			multilinear_interpolator(XIterT first_x, XIterT last_x, YIterT first_y, YIterT last_y, ZIterT first_z, ZIterT last_z)
+	: base_type(first_x, last_x, first_y, last_y, first_z, last_z)
+	{
+	}
+
+	private: ::std::size_t do_workspace_size() const
+	{
+		return ::std::size_t(1) << this->dimensions();
+	}
+
+	private: real_type do_interpolate(real_type const* x, ::std::size_t const* cell, real_type* work) const
+	{
+		const ::std::size_t nd(this->dimensions());
+		const ::std::size_t nc(::std::size_t(1) << nd);
+		const ::std::size_t off(this->cell_offset(cell));
+		real_type const* yy(this->value_data());
+
+		// Gather the values at the corners of the cell
+		for (::std::size_t c = 0; c < nc; ++c)
+		{
+			work[c] = yy[this->corner_offset(off, c)];
+		}
+
+		// Collapse one axis at a time, starting from the last one.
+		// At each step, corners differing only in the bit of the collapsed
+		// axis are merged and the result is stored in place.
+		for (::std::size_t a = nd; a > 0; --a)
+		{
+			const ::std::size_t i(a-1);
+			const ::std::size_t half(::std::size_t(1) << i);
+			real_type const* xx(this->axis_data(i));
+			const ::std::size_t k(cell[i]);
+			const real_type t((x[i]-xx[k])/(xx[k+1]-xx[k]));
+
+			for (::std::size_t c = 0; c < half; ++c)
+			{
+				work[c] += t*(work[c+half]-work[c]);
+			}
+		}
+
+		return work[0];
+	}
+}; // multilinear_interpolator
+
+}}} // Namespace dcs::math::curvefit
+
+
+#endif // DCS_MATH_CURVEFIT_INTERPOLATION_MULTILINEAR_HPP
@@ -0,0 +1,230 @@
+/**
+ * \file dcs/math/curvefit/interpolation/tensor_cubic_spline.hpp
+ *
+ * \brief Tensor-product cubic spline interpolation of gridded data.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_CURVEFIT_INTERPOLATION_TENSOR_CUBIC_SPLINE_HPP
+#define DCS_MATH_CURVEFIT_INTERPOLATION_TENSOR_CUBIC_SPLINE_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/curvefit/interpolation/basend.hpp>
+#include <dcs/math/curvefit/interpolation/cubic_spline.hpp>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace math { namespace curvefit {
+
+/**
+ * \brief Tensor-product cubic spline interpolation over a regular grid.
+ *
+ * The interpolating function is the tensor product of the one-dimensional
+ * cubic splines (see cubic_spline_interpolator) along each axis.
+ * For instance, in two dimensions, \f$S(x,y)\f$ is the cubic spline in
+ * \f$y\f$ through the values at \f$x\f$ of the cubic splines in \f$x\f$ of
+ * each grid row.
+ *
+ * Since spline coefficients depend linearly on data values, one-dimensional
+ * splines along different axes commute.
+ * Thus, at construction time, for every subset \f$A\f$ of the axes, the
+ * spline coefficients \f$s\f$ (see cubic_spline_interpolator) along all the
+ * axes in \f$A\f$ are computed for each grid point.
+ * Interpolating a point then only requires the \f$2^N\f$ corners of the cell
+ * where the point falls, each with its \f$2^N\f$ coefficients, which are
+ * collapsed one axis at a time.
+ * Coefficients of the same grid point are stored contiguously.
+ *
+ * Only the boundary conditions that depend linearly on data values are
+ * supported, that is: natural, not-a-knot and periodic.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class tensor_cubic_spline_interpolator: public base_nd_interpolator<RealT>
+{
+	public: typedef RealT real_type;
+	private: typedef base_nd_interpolator<real_type> base_type;
+
+
+	public: template <typename AxisIterT, typename ValueIterT>
+			tensor_cubic_spline_interpolator(AxisIterT first_axis,
+											 AxisIterT last_axis,
+											 ValueIterT first_v,
+											 ValueIterT last_v,
+											 spline_boundary_condition_category boundary_condition)
+	: base_type(first_axis, last_axis, first_v, last_v),
+	  bound_cond_(boundary_condition)
+	{
+		this->init();
+	}
+
+	public: template <typename XIterT, typename YIterT, typename ZIterT>
+			tensor_cubic_spline_interpolator(XIterT first_x,
+											 XIterT last_x,
+											 YIterT first_y,
+											 YIterT last_y,
+											 ZIterT first_z,
+											 ZIterT last_z,
+											 spline_boundary_condition_category boundary_condition)
+	: base_type(first_x, last_x, first_y, last_y, first_z, last_z),
+	  bound_cond_(boundary_condition)
+	{
+		this->init();
+	}
+
+	public: spline_boundary_condition_category boundary_condition() const
+	{
+		return bound_cond_;
+	}
+
+	private: void init()
+	{
+		DCS_ASSERT(bound_cond_ == natural_spline_boundary_condition
+				   || bound_cond_ == not_a_knot_spline_boundary_condition
+				   || bound_cond_ == periodic_spline_boundary_condition,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Unsupported boundary condition for tensor-product splines"));
+
+		const ::std::size_t nd(this->dimensions());
+		const ::std::size_t nm(::std::size_t(1) << nd);
+		const ::std::size_t nv(this->num_values());
+
+		ss_.resize(nv*nm);
+
+		for (::std::size_t v = 0; v < nv; ++v)
+		{
+			ss_[v*nm] = this->value(v);
+		}
+
+		// The coefficients for the axis subset m are obtained by applying
+		// the 1D spline along the highest axis in m to the coefficients for
+		// the subset m without that axis (which have already been computed).
+		::std::size_t a(0);
+		for (::std::size_t m = 1; m < nm; ++m)
+		{
+			if (m == (::std::size_t(2) << a))
+			{
+				++a;
+			}
+
+			const ::std::size_t src(m & ~(::std::size_t(1) << a));
+			const ::std::size_t n(this->num_nodes(a));
+			const ::std::size_t stride(this->stride(a));
+			real_type const* xx(this->axis_data(a));
+
+			::std::vector<real_type> line(n);
+			for (::std::size_t v = 0; v < nv; ++v)
+			{
+				// Only visit the first grid point of each line along axis a
+				if (((v/stride) % n) != 0)
+				{
+					continue;
+				}
+
+				for (::std::size_t k = 0; k < n; ++k)
+				{
+					line[k] = ss_[(v+k*stride)*nm+src];
+				}
+
+				const cubic_spline_interpolator<real_type> spline(xx, xx+n, line.begin(), line.end(), bound_cond_);
+
+				for (::std::size_t k = 0; k < (n-1); ++k)
+				{
+					ss_[(v+k*stride)*nm+m] = spline.coefficients(k)[2];
+				}
+				const ::std::vector<real_type> coeffs(spline.coefficients(n-2));
+				ss_[(v+(n-1)*stride)*nm+m] = coeffs[2]+3.0*(xx[n-1]-xx[n-2])*coeffs[3];
+			}
+		}
+	}
+
+	private: ::std::size_t do_workspace_size() const
+	{
+		return ::std::size_t(1) << (2*this->dimensions());
+	}
+
+	private: real_type do_interpolate(real_type const* x, ::std::size_t const* cell, real_type* work) const
+	{
+		const ::std::size_t nd(this->dimensions());
+		const ::std::size_t nm(::std::size_t(1) << nd);
+		const ::std::size_t off(this->cell_offset(cell));
+
+		// Gather the coefficients at the corners of the cell.
+		// The element at position c*nm+m is the coefficient for axis subset
+		// m at corner c.
+		for (::std::size_t c = 0; c < nm; ++c)
+		{
+			const ::std::size_t v(this->corner_offset(off, c));
+
+			for (::std::size_t m = 0; m < nm; ++m)
+			{
+				work[c*nm+m] = ss_[v*nm+m];
+			}
+		}
+
+		// Collapse one axis at a time, starting from the last one.
+		// Along axis i, the cubic piece between the lower and the upper
+		// corner is defined by the values and by the spline coefficients
+		// along i (i.e., the entries whose subset includes i).
+		// Results are stored in place.
+		for (::std::size_t a = nd; a > 0; --a)
+		{
+			const ::std::size_t i(a-1);
+			const ::std::size_t half(::std::size_t(1) << i);
+			const ::std::size_t old(half << 1);
+			real_type const* xx(this->axis_data(i));
+			const ::std::size_t k(cell[i]);
+			const real_type h(xx[k+1]-xx[k]);
+			const real_type w(x[i]-xx[k]);
+
+			for (::std::size_t c = 0; c < half; ++c)
+			{
+				for (::std::size_t m = 0; m < half; ++m)
+				{
+					const real_type yl(work[c*old+m]);
+					const real_type yr(work[(c+half)*old+m]);
+					const real_type sl(work[c*old+m+half]);
+					const real_type sr(work[(c+half)*old+m+half]);
+
+					const real_type c1((yr-yl)/h - h*(sr+2.0*sl)/3.0);
+					const real_type c3((sr-sl)/(3.0*h));
+
+					work[c*half+m] = yl + w*(c1 + w*(sl + w*c3));
+				}
+			}
+		}
+
+		return work[0];
+	}
+
+
+	private: spline_boundary_condition_category bound_cond_; ///< The boundary condition category
+	private: ::std::vector<real_type> ss_; ///< Spline coefficients for each grid point and axis subset
+}; // tensor_cubic_spline_interpolator
+
+}}} // Namespace dcs::math::curvefit
+
+
+#endif // DCS_MATH_CURVEFIT_INTERPOLATION_TENSOR_CUBIC_SPLINE_HPP
@@ -0,0 +1,42 @@
+/**
+ * \file dcs/math/la.hpp
+ *
+ * \brief Dense linear algebra kernels for matrix and vector.
+ *
+ * On x86 CPUs, the dot product, AXPY, GEMV and GEMM kernels use AVX2/FMA or
+ * AVX-512 instructions when the CPU supports them.
+ * The instruction set is detected at run time, so no \c -m compiler flag is
+ * needed.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_HPP
+#define DCS_MATH_LA_HPP
+
+
+#include <dcs/math/la/axpy.hpp>
+#include <dcs/math/la/dot.hpp>
+#include <dcs/math/la/fixed.hpp>
+#include <dcs/math/la/gemm.hpp>
+#include <dcs/math/la/gemv.hpp>
+#include <dcs/math/la/transpose.hpp>
+
+
+#endif // DCS_MATH_LA_HPP
@@ -0,0 +1,53 @@
+/**
+ * \file dcs/math/la/axpy.hpp
+ *
+ * \brief Scaled vector accumulation (AXPY).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_AXPY_HPP
+#define DCS_MATH_LA_AXPY_HPP
+
+
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/la/detail/level1.hpp>
+#include <dcs/math/type/vector.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math { namespace la {
+
+/// Computes \f$y \gets \alpha x + y\f$.
+template <typename T, typename PX, typename AX, typename PY, typename AY>
+void axpy(T alpha, vector<T,PX,AX> const& x, vector<T,PY,AY>& y)
+{
+	// pre: size(x) == size(y)
+	DCS_ASSERT(x.length() == y.length(),
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Vectors of different size"));
+
+	detail::level1_kernel<T>::axpy(x.length(), alpha, x.begin_data(), y.begin_data());
+}
+
+}}} // Namespace dcs::math::la
+
+
+#endif // DCS_MATH_LA_AXPY_HPP
@@ -0,0 +1,503 @@
+/**
+ * \file dcs/math/la/detail/gemm.hpp
+ *
+ * \brief Cache-blocked kernel for general matrix-matrix products.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_DETAIL_GEMM_HPP
+#define DCS_MATH_LA_DETAIL_GEMM_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/math/la/detail/level1.hpp>
+#include <dcs/math/la/detail/simd.hpp>
+#include <dcs/memory/aligned_allocator.hpp>
+#include <vector>
+
+
+namespace dcs { namespace math { namespace la { namespace detail {
+
+/**
+ * \brief Portable micro-kernel computing a MRxNR block of a matrix product.
+ *
+ * Given a sliver \a a of MR rows and a sliver \a b of NR columns, both packed
+ * along the common dimension \a k (see pack_a and pack_b), stores
+ * \f$a b\f$ into the row-major MRxNR block \a ab.
+ */
+template <typename T, ::std::size_t MR, ::std::size_t NR>
+struct scalar_gemm_micro_kernel
+{
+	static const ::std::size_t mr = MR;
+	static const ::std::size_t nr = NR;
+
+	static void apply(::std::size_t k, T const* a, T const* b, T* ab)
+	{
+		T c[MR*NR];
+		::std::fill(c, c+MR*NR, T(0));
+
+		for (::std::size_t p = 0; p < k; ++p, a += MR, b += NR)
+		{
+			for (::std::size_t i = 0; i < MR; ++i)
+			{
+				const T ai(a[i]);
+				for (::std::size_t j = 0; j < NR; ++j)
+				{
+					c[i*NR+j] += ai*b[j];
+				}
+			}
+		}
+
+		::std::copy(c, c+MR*NR, ab);
+	}
+}; // scalar_gemm_micro_kernel
+
+template <typename T, ::std::size_t MR, ::std::size_t NR>
+const ::std::size_t scalar_gemm_micro_kernel<T,MR,NR>::mr;
+
+template <typename T, ::std::size_t MR, ::std::size_t NR>
+const ::std::size_t scalar_gemm_micro_kernel<T,MR,NR>::nr;
+
+/**
+ * \brief Vectorized micro-kernel computing a MRxNR block of a matrix product.
+ *
+ * Each of the MR rows of the block is accumulated into \a NV vector
+ * registers of instruction set \a Isa (hence, NR is NV times the register
+ * width).
+ * At each step along the common dimension, the NV registers of the packed
+ * row of \a b are loaded once and multiplied by each of the MR values of the
+ * packed column of \a a.
+ * The constant trip counts let the compiler keep all the MR*NV
+ * accumulators in registers.
+ *
+ * The body is inlined into the \c apply function of the derived kernels,
+ * which are compiled for \a Isa.
+ */
+template <typename T, ::std::size_t MR, ::std::size_t NV, simd_isa_category Isa>
+struct simd_gemm_micro_kernel
+{
+	typedef simd_traits<T,Isa> simd_type;
+	typedef typename simd_type::register_type register_type;
+
+	static const ::std::size_t mr = MR;
+	static const ::std::size_t nr = NV*simd_type::width;
+
+	DCS_MATH_LA_DETAIL_SIMD_INLINE_ static void apply(::std::size_t k, T const* a, T const* b, T* ab)
+	{
+		register_type c[MR][NV];
+		for (::std::size_t i = 0; i < MR; ++i)
+		{
+			for (::std::size_t v = 0; v < NV; ++v)
+			{
+				simd_type::zero(c[i][v]);
+			}
+		}
+
+		for (::std::size_t p = 0; p < k; ++p, a += MR, b += nr)
+		{
+			register_type bb[NV];
+			for (::std::size_t v = 0; v < NV; ++v)
+			{
+				simd_type::load(bb[v], b+v*simd_type::width);
+			}
+			for (::std::size_t i = 0; i < MR; ++i)
+			{
+				register_type ai;
+				simd_type::broadcast(ai, a[i]);
+				for (::std::size_t v = 0; v < NV; ++v)
+				{
+					simd_type::fmadd(c[i][v], ai, bb[v]);
+				}
+			}
+		}
+
+		for (::std::size_t i = 0; i < MR; ++i)
+		{
+			for (::std::size_t v = 0; v < NV; ++v)
+			{
+				simd_type::store(ab+i*nr+v*simd_type::width, c[i][v]);
+			}
+		}
+	}
+}; // simd_gemm_micro_kernel
+
+template <typename T, ::std::size_t MR, ::std::size_t NV, simd_isa_category Isa>
+const ::std::size_t simd_gemm_micro_kernel<T,MR,NV,Isa>::mr;
+
+template <typename T, ::std::size_t MR, ::std::size_t NV, simd_isa_category Isa>
+const ::std::size_t simd_gemm_micro_kernel<T,MR,NV,Isa>::nr;
+
+#ifdef DCS_MATH_LA_DETAIL_SIMD_X86
+
+/// Vectorized micro-kernel compiled for AVX2 and FMA.
+template <typename T, ::std::size_t MR, ::std::size_t NV>
+struct avx2_gemm_micro_kernel: public simd_gemm_micro_kernel<T,MR,NV,avx2_simd_isa>
+{
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void apply(::std::size_t k, T const* a, T const* b, T* ab)
+	{
+		simd_gemm_micro_kernel<T,MR,NV,avx2_simd_isa>::apply(k, a, b, ab);
+	}
+}; // avx2_gemm_micro_kernel
+
+/// Vectorized micro-kernel compiled for AVX-512.
+template <typename T, ::std::size_t MR, ::std::size_t NV>
+struct avx512_gemm_micro_kernel: public simd_gemm_micro_kernel<T,MR,NV,avx512_simd_isa>
+{
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void apply(::std::size_t k, T const* a, T const* b, T* ab)
+	{
+		simd_gemm_micro_kernel<T,MR,NV,avx512_simd_isa>::apply(k, a, b, ab);
+	}
+}; // avx512_gemm_micro_kernel
+
+#endif // DCS_MATH_LA_DETAIL_SIMD_X86
+
+/**
+ * \brief Selects the micro-kernel and the cache blocking for type \a T and
+ *  instruction set \a Isa.
+ *
+ * The register blocking (MR,NR) uses most of the vector registers for the
+ * accumulators (16 of the 32 AVX-512 registers, 12 of the 16 AVX2
+ * registers).
+ * The cache blocking is chosen such that a KCxNR sliver of the packed
+ * \f$B\f$ panel fits in L1, a MCxKC packed block of \f$A\f$ fits in L2,
+ * and a KCxNC packed panel of \f$B\f$ fits in L3.
+ */
+template <typename T, simd_isa_category Isa>
+struct gemm_kernel_traits
+{
+	typedef scalar_gemm_micro_kernel<T,4,4> micro_kernel_type;
+	static const ::std::size_t kc = 256;
+	static const ::std::size_t mc = 96;
+	static const ::std::size_t nc = 2048;
+};
+
+#ifdef DCS_MATH_LA_DETAIL_SIMD_X86
+
+template <>
+struct gemm_kernel_traits<double,avx512_simd_isa>
+{
+	typedef avx512_gemm_micro_kernel<double,8,2> micro_kernel_type; // 8x16
+	static const ::std::size_t kc = 256;
+	static const ::std::size_t mc = 96;
+	static const ::std::size_t nc = 2048;
+};
+
+template <>
+struct gemm_kernel_traits<double,avx2_simd_isa>
+{
+	typedef avx2_gemm_micro_kernel<double,6,2> micro_kernel_type; // 6x8
+	static const ::std::size_t kc = 256;
+	static const ::std::size_t mc = 72;
+	static const ::std::size_t nc = 2048;
+};
+
+template <>
+struct gemm_kernel_traits<float,avx512_simd_isa>
+{
+	typedef avx512_gemm_micro_kernel<float,8,2> micro_kernel_type; // 8x32
+	static const ::std::size_t kc = 256;
+	static const ::std::size_t mc = 192;
+	static const ::std::size_t nc = 4096;
+};
+
+template <>
+struct gemm_kernel_traits<float,avx2_simd_isa>
+{
+	typedef avx2_gemm_micro_kernel<float,6,2> micro_kernel_type; // 6x16
+	static const ::std::size_t kc = 256;
+	static const ::std::size_t mc = 144;
+	static const ::std::size_t nc = 4096;
+};
+
+#endif // DCS_MATH_LA_DETAIL_SIMD_X86
+
+/// Returns the instruction set of the GEMM kernels dispatched for \a isa.
+template <typename T>
+simd_isa_category gemm_kernel_isa(simd_isa_category isa)
+{
+	if (isa >= avx512_simd_isa && simd_traits<T,avx512_simd_isa>::enabled)
+	{
+		return avx512_simd_isa;
+	}
+	if (isa >= avx2_simd_isa && simd_traits<T,avx2_simd_isa>::enabled)
+	{
+		return avx2_simd_isa;
+	}
+
+	return no_simd_isa;
+}
+
+/// Returns the MC blocking of the GEMM kernels dispatched for \a isa.
+template <typename T>
+::std::size_t gemm_kernel_mc(simd_isa_category isa = simd_default_isa())
+{
+	switch (gemm_kernel_isa<T>(isa))
+	{
+		case avx512_simd_isa:
+			return gemm_kernel_traits<T,avx512_simd_isa>::mc;
+		case avx2_simd_isa:
+			return gemm_kernel_traits<T,avx2_simd_isa>::mc;
+		default:
+			break;
+	}
+
+	return gemm_kernel_traits<T,no_simd_isa>::mc;
+}
+
+/**
+ * \brief Packs a \a m x \a k block of \f$A\f$ into slivers of MR rows.
+ *
+ * Within a sliver, the MR values of each column are contiguous, so that the
+ * micro-kernel reads \a ap sequentially.
+ * The last sliver is padded with zeros.
+ */
+template < ::std::size_t MR, typename T>
+void pack_a(::std::size_t m, ::std::size_t k, T const* a, ::std::size_t rsa, ::std::size_t csa, T* ap)
+{
+	for (::std::size_t i0 = 0; i0 < m; i0 += MR)
+	{
+		const ::std::size_t mr(::std::min(MR, m-i0));
+		T const* as(a+i0*rsa);
+
+		for (::std::size_t p = 0; p < k; ++p)
+		{
+			::std::size_t i(0);
+			for (; i < mr; ++i)
+			{
+				ap[i] = as[i*rsa+p*csa];
+			}
+			for (; i < MR; ++i)
+			{
+				ap[i] = T(0);
+			}
+			ap += MR;
+		}
+	}
+}
+
+/**
+ * \brief Packs a \a k x \a n block of \f$B\f$ into slivers of NR columns.
+ *
+ * Within a sliver, the NR values of each row are contiguous.
+ * The last sliver is padded with zeros.
+ */
+template < ::std::size_t NR, typename T>
+void pack_b(::std::size_t k, ::std::size_t n, T const* b, ::std::size_t rsb, ::std::size_t csb, T* bp)
+{
+	for (::std::size_t j0 = 0; j0 < n; j0 += NR)
+	{
+		const ::std::size_t nr(::std::min(NR, n-j0));
+		T const* bs(b+j0*csb);
+
+		for (::std::size_t p = 0; p < k; ++p)
+		{
+			::std::size_t j(0);
+			if (csb == 1)
+			{
+				::std::copy(bs+p*rsb, bs+p*rsb+nr, bp);
+				j = nr;
+			}
+			for (; j < nr; ++j)
+			{
+				bp[j] = bs[p*rsb+j*csb];
+			}
+			for (; j < NR; ++j)
+			{
+				bp[j] = T(0);
+			}
+			bp += NR;
+		}
+	}
+}
+
+/// Computes the product with the kernels and the blocking of \a TraitsT (see gemm).
+template <typename TraitsT, typename T>
+void gemm_blocked(::std::size_t m, ::std::size_t n, ::std::size_t k,
+				  T alpha,
+				  T const* a, ::std::size_t rsa, ::std::size_t csa,
+				  T const* b, ::std::size_t rsb, ::std::size_t csb,
+				  T beta,
+				  T* c, ::std::size_t rsc, ::std::size_t csc)
+{
+	typedef TraitsT traits_type;
+	typedef typename traits_type::micro_kernel_type kernel_type;
+	typedef ::std::vector< T, ::dcs::memory::aligned_allocator<T> > buffer_type;
+
+	const ::std::size_t MR(kernel_type::mr);
+	const ::std::size_t NR(kernel_type::nr);
+
+	if (m == 0 || n == 0)
+	{
+		return;
+	}
+
+	// Scale C by beta, one contiguous line at a time
+	if (beta != T(1))
+	{
+		if (csc <= rsc)
+		{
+			for (::std::size_t i = 0; i < m; ++i)
+			{
+				scal(n, beta, c+i*rsc, csc);
+			}
+		}
+		else
+		{
+			for (::std::size_t j = 0; j < n; ++j)
+			{
+				scal(m, beta, c+j*csc, rsc);
+			}
+		}
+	}
+
+	if (k == 0 || alpha == T(0))
+	{
+		return;
+	}
+
+	const ::std::size_t kc_max(::std::min(k, ::std::size_t(traits_type::kc)));
+	const ::std::size_t mc_max(::std::min(((m+MR-1)/MR)*MR, ::std::size_t(traits_type::mc)));
+	const ::std::size_t nc_max(::std::min(((n+NR-1)/NR)*NR, ::std::size_t(traits_type::nc)));
+
+	buffer_type ap(mc_max*kc_max);
+	buffer_type bp(kc_max*nc_max);
+	T ab[kernel_type::mr*kernel_type::nr];
+
+	for (::std::size_t jc = 0; jc < n; jc += nc_max)
+	{
+		const ::std::size_t nc(::std::min(nc_max, n-jc));
+
+		for (::std::size_t pc = 0; pc < k; pc += kc_max)
+		{
+			const ::std::size_t kc(::std::min(kc_max, k-pc));
+
+			pack_b<kernel_type::nr>(kc, nc, b+pc*rsb+jc*csb, rsb, csb, &bp[0]);
+
+			for (::std::size_t ic = 0; ic < m; ic += mc_max)
+			{
+				const ::std::size_t mc(::std::min(mc_max, m-ic));
+
+				pack_a<kernel_type::mr>(mc, kc, a+ic*rsa+pc*csa, rsa, csa, &ap[0]);
+
+				for (::std::size_t jr = 0; jr < nc; jr += NR)
+				{
+					const ::std::size_t nr(::std::min(NR, nc-jr));
+
+					for (::std::size_t ir = 0; ir < mc; ir += MR)
+					{
+						const ::std::size_t mr(::std::min(MR, mc-ir));
+
+						kernel_type::apply(kc, &ap[ir*kc], &bp[jr*kc], ab);
+
+						// Accumulate the valid part of the block into C
+						T* cc(c+(ic+ir)*rsc+(jc+jr)*csc);
+						for (::std::size_t i = 0; i < mr; ++i)
+						{
+							for (::std::size_t j = 0; j < nr; ++j)
+							{
+								cc[i*rsc+j*csc] += alpha*ab[i*NR+j];
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \brief Computes \f$C \gets \alpha A B + \beta C\f$ on the calling thread.
+ *
+ * \f$A\f$ is \a m x \a k, \f$B\f$ is \a k x \a n and \f$C\f$ is \a m x \a n.
+ * Each matrix is given by the address of its first element, its row stride
+ * (the distance between elements \f$(i,j)\f$ and \f$(i+1,j)\f$) and its
+ * column stride (the distance between elements \f$(i,j)\f$ and
+ * \f$(i,j+1)\f$), so that any storage layout is handled.
+ *
+ * The product follows the classical five-loop blocking scheme (Goto and
+ * van de Geijn, "Anatomy of high-performance matrix multiplication", ACM
+ * TOMS 34(3), 2008): panels of \f$B\f$ and blocks of \f$A\f$ are packed into
+ * contiguous aligned buffers sized for the cache hierarchy and the inner
+ * loops call a register-blocked micro-kernel.
+ *
+ * The micro-kernel is the one of the most capable instruction set among
+ * \a isa and those below it (\a isa must be supported by the CPU).
+ */
+template <typename T>
+void gemm(::std::size_t m, ::std::size_t n, ::std::size_t k,
+		  T alpha,
+		  T const* a, ::std::size_t rsa, ::std::size_t csa,
+		  T const* b, ::std::size_t rsb, ::std::size_t csb,
+		  T beta,
+		  T* c, ::std::size_t rsc, ::std::size_t csc,
+		  simd_isa_category isa = simd_default_isa())
+{
+	switch (gemm_kernel_isa<T>(isa))
+	{
+		case avx512_simd_isa:
+			gemm_blocked< gemm_kernel_traits<T,avx512_simd_isa> >(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+			break;
+		case avx2_simd_isa:
+			gemm_blocked< gemm_kernel_traits<T,avx2_simd_isa> >(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+			break;
+		default:
+			gemm_blocked< gemm_kernel_traits<T,no_simd_isa> >(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+			break;
+	}
+}
+
+/**
+ * \brief Copies the transpose of the \a m x \a n matrix \a a into \a b.
+ *
+ * Both matrices are described by their row and column strides (see gemm).
+ * The copy proceeds by square tiles, so that both the reads and the writes
+ * stay within a few cache lines whatever the layouts.
+ */
+template <typename T>
+void transpose(::std::size_t m, ::std::size_t n,
+			   T const* a, ::std::size_t rsa, ::std::size_t csa,
+			   T* b, ::std::size_t rsb, ::std::size_t csb)
+{
+	const ::std::size_t tile(32);
+
+	for (::std::size_t i0 = 0; i0 < m; i0 += tile)
+	{
+		const ::std::size_t i1(::std::min(m, i0+tile));
+
+		for (::std::size_t j0 = 0; j0 < n; j0 += tile)
+		{
+			const ::std::size_t j1(::std::min(n, j0+tile));
+
+			for (::std::size_t i = i0; i < i1; ++i)
+			{
+				for (::std::size_t j = j0; j < j1; ++j)
+				{
+					b[j*rsb+i*csb] = a[i*rsa+j*csa];
+				}
+			}
+		}
+	}
+}
+
+}}}} // Namespace dcs::math::la::detail
+
+
+#endif // DCS_MATH_LA_DETAIL_GEMM_HPP
@@ -0,0 +1,294 @@
+/**
+ * \file dcs/math/la/detail/level1.hpp
+ *
+ * \brief Raw kernels for vector-vector operations.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_DETAIL_LEVEL1_HPP
+#define DCS_MATH_LA_DETAIL_LEVEL1_HPP
+
+
+#include <cstddef>
+#include <dcs/math/la/detail/simd.hpp>
+
+
+namespace dcs { namespace math { namespace la { namespace detail {
+
+/// Level-1 kernels written for instruction set \a Isa (scalar code by default).
+template <typename T, simd_isa_category Isa, bool Simd = simd_traits<T,Isa>::enabled>
+struct level1_isa_kernel
+{
+	/// Returns \f$\sum_{i=0}^{n-1} x_i y_i\f$, for contiguous \a x and \a y.
+	static T dot(::std::size_t n, T const* x, T const* y)
+	{
+		// Independent partial sums break the dependency chain of additions
+		T s0(0);
+		T s1(0);
+		T s2(0);
+		T s3(0);
+
+		::std::size_t i(0);
+		for (; (i+4) <= n; i += 4)
+		{
+			s0 += x[i]*y[i];
+			s1 += x[i+1]*y[i+1];
+			s2 += x[i+2]*y[i+2];
+			s3 += x[i+3]*y[i+3];
+		}
+		for (; i < n; ++i)
+		{
+			s0 += x[i]*y[i];
+		}
+
+		return (s0+s1)+(s2+s3);
+	}
+
+	/// Computes \f$y \gets \alpha x + y\f$, for contiguous \a x and \a y.
+	static void axpy(::std::size_t n, T alpha, T const* x, T* y)
+	{
+		::std::size_t i(0);
+		for (; (i+4) <= n; i += 4)
+		{
+			y[i] += alpha*x[i];
+			y[i+1] += alpha*x[i+1];
+			y[i+2] += alpha*x[i+2];
+			y[i+3] += alpha*x[i+3];
+		}
+		for (; i < n; ++i)
+		{
+			y[i] += alpha*x[i];
+		}
+	}
+}; // level1_isa_kernel
+
+template <typename T, simd_isa_category Isa>
+struct level1_isa_kernel<T,Isa,true>
+{
+	typedef simd_traits<T,Isa> simd_type;
+	typedef typename simd_type::register_type register_type;
+
+	DCS_MATH_LA_DETAIL_SIMD_INLINE_ static T dot(::std::size_t n, T const* x, T const* y)
+	{
+		const ::std::size_t w(simd_type::width);
+
+		register_type s0;
+		register_type s1;
+		register_type s2;
+		register_type s3;
+		register_type u;
+		register_type v;
+
+		simd_type::zero(s0);
+		simd_type::zero(s1);
+		simd_type::zero(s2);
+		simd_type::zero(s3);
+
+		::std::size_t i(0);
+		for (; (i+4*w) <= n; i += 4*w)
+		{
+			simd_type::load(u, x+i); simd_type::load(v, y+i); simd_type::fmadd(s0, u, v);
+			simd_type::load(u, x+i+w); simd_type::load(v, y+i+w); simd_type::fmadd(s1, u, v);
+			simd_type::load(u, x+i+2*w); simd_type::load(v, y+i+2*w); simd_type::fmadd(s2, u, v);
+			simd_type::load(u, x+i+3*w); simd_type::load(v, y+i+3*w); simd_type::fmadd(s3, u, v);
+		}
+		for (; (i+w) <= n; i += w)
+		{
+			simd_type::load(u, x+i); simd_type::load(v, y+i); simd_type::fmadd(s0, u, v);
+		}
+
+		simd_type::add(s0, s1);
+		simd_type::add(s2, s3);
+		simd_type::add(s0, s2);
+		T s(simd_type::reduce(s0));
+		for (; i < n; ++i)
+		{
+			s += x[i]*y[i];
+		}
+
+		return s;
+	}
+
+	DCS_MATH_LA_DETAIL_SIMD_INLINE_ static void axpy(::std::size_t n, T alpha, T const* x, T* y)
+	{
+		const ::std::size_t w(simd_type::width);
+
+		register_type a;
+		register_type u;
+		register_type v;
+
+		simd_type::broadcast(a, alpha);
+
+		::std::size_t i(0);
+		for (; (i+2*w) <= n; i += 2*w)
+		{
+			simd_type::load(u, x+i); simd_type::load(v, y+i); simd_type::fmadd(v, a, u); simd_type::store(y+i, v);
+			simd_type::load(u, x+i+w); simd_type::load(v, y+i+w); simd_type::fmadd(v, a, u); simd_type::store(y+i+w, v);
+		}
+		for (; (i+w) <= n; i += w)
+		{
+			simd_type::load(u, x+i); simd_type::load(v, y+i); simd_type::fmadd(v, a, u); simd_type::store(y+i, v);
+		}
+		for (; i < n; ++i)
+		{
+			y[i] += alpha*x[i];
+		}
+	}
+}; // level1_isa_kernel
+
+/// Entry points compiled for instruction set \a Isa.
+template <typename T, simd_isa_category Isa>
+struct level1_isa_entry
+{
+	static T dot(::std::size_t n, T const* x, T const* y)
+	{
+		return level1_isa_kernel<T,Isa>::dot(n, x, y);
+	}
+
+	static void axpy(::std::size_t n, T alpha, T const* x, T* y)
+	{
+		level1_isa_kernel<T,Isa>::axpy(n, alpha, x, y);
+	}
+}; // level1_isa_entry
+
+template <typename T>
+struct level1_isa_entry<T,avx2_simd_isa>
+{
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static T dot(::std::size_t n, T const* x, T const* y)
+	{
+		return level1_isa_kernel<T,avx2_simd_isa>::dot(n, x, y);
+	}
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void axpy(::std::size_t n, T alpha, T const* x, T* y)
+	{
+		level1_isa_kernel<T,avx2_simd_isa>::axpy(n, alpha, x, y);
+	}
+}; // level1_isa_entry
+
+template <typename T>
+struct level1_isa_entry<T,avx512_simd_isa>
+{
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static T dot(::std::size_t n, T const* x, T const* y)
+	{
+		return level1_isa_kernel<T,avx512_simd_isa>::dot(n, x, y);
+	}
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void axpy(::std::size_t n, T alpha, T const* x, T* y)
+	{
+		level1_isa_kernel<T,avx512_simd_isa>::axpy(n, alpha, x, y);
+	}
+}; // level1_isa_entry
+
+/**
+ * Level-1 kernels on contiguous vectors, dispatched to the most capable
+ * instruction set among \a isa and those below it (\a isa must be supported
+ * by the CPU).
+ */
+template <typename T>
+struct level1_kernel
+{
+	/// Returns \f$\sum_{i=0}^{n-1} x_i y_i\f$, for contiguous \a x and \a y.
+	static T dot(::std::size_t n, T const* x, T const* y, simd_isa_category isa = simd_default_isa())
+	{
+		if (isa >= avx512_simd_isa && simd_traits<T,avx512_simd_isa>::enabled)
+		{
+			return level1_isa_entry<T,avx512_simd_isa>::dot(n, x, y);
+		}
+		if (isa >= avx2_simd_isa && simd_traits<T,avx2_simd_isa>::enabled)
+		{
+			return level1_isa_entry<T,avx2_simd_isa>::dot(n, x, y);
+		}
+
+		return level1_isa_entry<T,no_simd_isa>::dot(n, x, y);
+	}
+
+	/// Computes \f$y \gets \alpha x + y\f$, for contiguous \a x and \a y.
+	static void axpy(::std::size_t n, T alpha, T const* x, T* y, simd_isa_category isa = simd_default_isa())
+	{
+		if (isa >= avx512_simd_isa && simd_traits<T,avx512_simd_isa>::enabled)
+		{
+			level1_isa_entry<T,avx512_simd_isa>::axpy(n, alpha, x, y);
+		}
+		else if (isa >= avx2_simd_isa && simd_traits<T,avx2_simd_isa>::enabled)
+		{
+			level1_isa_entry<T,avx2_simd_isa>::axpy(n, alpha, x, y);
+		}
+		else
+		{
+			level1_isa_entry<T,no_simd_isa>::axpy(n, alpha, x, y);
+		}
+	}
+}; // level1_kernel
+
+/// Dot product of two strided vectors.
+template <typename T>
+T dot(::std::size_t n, T const* x, ::std::size_t incx, T const* y, ::std::size_t incy, simd_isa_category isa = simd_default_isa())
+{
+	if (incx == 1 && incy == 1)
+	{
+		return level1_kernel<T>::dot(n, x, y, isa);
+	}
+
+	T s(0);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		s += x[i*incx]*y[i*incy];
+	}
+
+	return s;
+}
+
+/// AXPY operation on two strided vectors.
+template <typename T>
+void axpy(::std::size_t n, T alpha, T const* x, ::std::size_t incx, T* y, ::std::size_t incy, simd_isa_category isa = simd_default_isa())
+{
+	if (incx == 1 && incy == 1)
+	{
+		level1_kernel<T>::axpy(n, alpha, x, y, isa);
+		return;
+	}
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		y[i*incy] += alpha*x[i*incx];
+	}
+}
+
+/// Computes \f$x \gets \alpha x\f$ on a strided vector (\f$\alpha=0\f$ clears \a x).
+template <typename T>
+void scal(::std::size_t n, T alpha, T* x, ::std::size_t incx)
+{
+	if (alpha == T(1))
+	{
+		return;
+	}
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		// Assign zero rather than multiplying, so that NaNs and
+		// uninitialized values are discarded
+		x[i*incx] = (alpha == T(0)) ? T(0) : alpha*x[i*incx];
+	}
+}
+
+}}}} // Namespace dcs::math::la::detail
+
+
+#endif // DCS_MATH_LA_DETAIL_LEVEL1_HPP
@@ -0,0 +1,215 @@
+/**
+ * \file dcs/math/la/detail/simd.hpp
+ *
+ * \brief Vector register abstraction used by the dense linear algebra kernels.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_DETAIL_SIMD_HPP
+#define DCS_MATH_LA_DETAIL_SIMD_HPP
+
+
+// The vectorized kernels are compiled for their own instruction set through
+// the target attribute, whatever the flags of the including translation unit,
+// and are only called after checking the CPU at run time.
+#if (defined(__x86_64__) || defined(__i386__)) \
+	&& (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+# define DCS_MATH_LA_DETAIL_SIMD_X86 1
+#endif // (__x86_64__ || __i386__) && ...
+
+#ifdef DCS_MATH_LA_DETAIL_SIMD_X86
+# include <immintrin.h>
+# define DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ __attribute__((__target__("avx2,fma")))
+# define DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ __attribute__((__target__("avx2,fma,avx512f")))
+// Kernel bodies are shared by the instruction sets and are inlined into the
+// entry points compiled for each of them
+# define DCS_MATH_LA_DETAIL_SIMD_INLINE_ __attribute__((__always_inline__))
+#else // DCS_MATH_LA_DETAIL_SIMD_X86
+# define DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_
+# define DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_
+# define DCS_MATH_LA_DETAIL_SIMD_INLINE_
+#endif // DCS_MATH_LA_DETAIL_SIMD_X86
+
+
+namespace dcs { namespace math { namespace la { namespace detail {
+
+/// The vector instruction sets, from the least to the most capable.
+enum simd_isa_category
+{
+	no_simd_isa = 0, ///< Portable scalar code
+	avx2_simd_isa, ///< AVX2 and FMA
+	avx512_simd_isa ///< AVX-512 Foundation
+};
+
+/// Returns the most capable instruction set supported by the CPU.
+inline simd_isa_category simd_detect_isa()
+{
+#ifdef DCS_MATH_LA_DETAIL_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return avx512_simd_isa;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return avx2_simd_isa;
+	}
+#endif // DCS_MATH_LA_DETAIL_SIMD_X86
+
+	return no_simd_isa;
+}
+
+/// Returns the instruction set used by default, which is detected only once.
+inline simd_isa_category simd_default_isa()
+{
+	static const simd_isa_category isa(simd_detect_isa());
+
+	return isa;
+}
+
+/**
+ * \brief Operations on the vector registers of instruction set \a Isa
+ *  holding values of type \a T.
+ *
+ * When \a Isa has no vector registers for \a T, \c enabled is \c false and
+ * the kernels fall back to portable scalar code.
+ *
+ * When enabled, the specializations provide:
+ * - \c register_type, the vector register type,
+ * - \c width, the number of values held by a register,
+ * - \c zero(r), \c load(r,p), \c broadcast(r,v), \c store(p,r) (unaligned
+ *   memory accesses),
+ * - \c add(r,a) (i.e., \f$r \gets r+a\f$) and \c fmadd(r,a,b) (i.e.,
+ *   \f$r \gets a*b+r\f$),
+ * - \c reduce(r), the sum of the values of a register.
+ * .
+ * Registers are passed by reference, so that kernels not compiled for \a Isa
+ * never pass them by value to these functions (which would use a different
+ * calling convention).
+ */
+template <typename T, simd_isa_category Isa>
+struct simd_traits
+{
+	static const bool enabled = false;
+	static const unsigned int width = 1;
+};
+
+template <typename T, simd_isa_category Isa>
+const bool simd_traits<T,Isa>::enabled;
+
+template <typename T, simd_isa_category Isa>
+const unsigned int simd_traits<T,Isa>::width;
+
+#ifdef DCS_MATH_LA_DETAIL_SIMD_X86
+
+template <>
+struct simd_traits<double,avx512_simd_isa>
+{
+	typedef __m512d register_type;
+	static const bool enabled = true;
+	static const unsigned int width = 8;
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void zero(register_type& r) { r = _mm512_setzero_pd(); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void load(register_type& r, double const* p) { r = _mm512_loadu_pd(p); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void broadcast(register_type& r, double v) { r = _mm512_set1_pd(v); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void store(double* p, register_type const& r) { _mm512_storeu_pd(p, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void add(register_type& r, register_type const& a) { r = _mm512_add_pd(r, a); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void fmadd(register_type& r, register_type const& a, register_type const& b) { r = _mm512_fmadd_pd(a, b, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static double reduce(register_type const& r)
+	{
+		double v[width];
+		_mm512_storeu_pd(v, r);
+		return ((v[0]+v[1])+(v[2]+v[3]))+((v[4]+v[5])+(v[6]+v[7]));
+	}
+};
+
+template <>
+struct simd_traits<float,avx512_simd_isa>
+{
+	typedef __m512 register_type;
+	static const bool enabled = true;
+	static const unsigned int width = 16;
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void zero(register_type& r) { r = _mm512_setzero_ps(); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void load(register_type& r, float const* p) { r = _mm512_loadu_ps(p); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void broadcast(register_type& r, float v) { r = _mm512_set1_ps(v); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void store(float* p, register_type const& r) { _mm512_storeu_ps(p, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void add(register_type& r, register_type const& a) { r = _mm512_add_ps(r, a); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static void fmadd(register_type& r, register_type const& a, register_type const& b) { r = _mm512_fmadd_ps(a, b, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX512_TARGET_ static float reduce(register_type const& r)
+	{
+		float v[width];
+		_mm512_storeu_ps(v, r);
+		float s(0);
+		for (unsigned int i = 0; i < width; i += 2)
+		{
+			s += v[i]+v[i+1];
+		}
+		return s;
+	}
+};
+
+template <>
+struct simd_traits<double,avx2_simd_isa>
+{
+	typedef __m256d register_type;
+	static const bool enabled = true;
+	static const unsigned int width = 4;
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void zero(register_type& r) { r = _mm256_setzero_pd(); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void load(register_type& r, double const* p) { r = _mm256_loadu_pd(p); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void broadcast(register_type& r, double v) { r = _mm256_set1_pd(v); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void store(double* p, register_type const& r) { _mm256_storeu_pd(p, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void add(register_type& r, register_type const& a) { r = _mm256_add_pd(r, a); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void fmadd(register_type& r, register_type const& a, register_type const& b) { r = _mm256_fmadd_pd(a, b, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static double reduce(register_type const& r)
+	{
+		const __m128d s(_mm_add_pd(_mm256_castpd256_pd128(r), _mm256_extractf128_pd(r, 1)));
+		return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+};
+
+template <>
+struct simd_traits<float,avx2_simd_isa>
+{
+	typedef __m256 register_type;
+	static const bool enabled = true;
+	static const unsigned int width = 8;
+
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void zero(register_type& r) { r = _mm256_setzero_ps(); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void load(register_type& r, float const* p) { r = _mm256_loadu_ps(p); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void broadcast(register_type& r, float v) { r = _mm256_set1_ps(v); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void store(float* p, register_type const& r) { _mm256_storeu_ps(p, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void add(register_type& r, register_type const& a) { r = _mm256_add_ps(r, a); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static void fmadd(register_type& r, register_type const& a, register_type const& b) { r = _mm256_fmadd_ps(a, b, r); }
+	DCS_MATH_LA_DETAIL_SIMD_AVX2_TARGET_ static float reduce(register_type const& r)
+	{
+		__m128 s(_mm_add_ps(_mm256_castps256_ps128(r), _mm256_extractf128_ps(r, 1)));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+	}
+};
+
+#endif // DCS_MATH_LA_DETAIL_SIMD_X86
+
+}}}} // Namespace dcs::math::la::detail
+
+
+#endif // DCS_MATH_LA_DETAIL_SIMD_HPP
@@ -0,0 +1,103 @@
+/**
+ * \file dcs/math/la/fixed.hpp
+ *
+ * \brief Products and transposition of fixed-size matrices and vectors.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_FIXED_HPP
+#define DCS_MATH_LA_FIXED_HPP
+
+
+#include <cstddef>
+#include <dcs/math/type/fixed_matrix.hpp>
+#include <dcs/math/type/fixed_vector.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+
+
+namespace dcs { namespace math { namespace la {
+
+/**
+ * \brief Returns the matrix product \f$A B\f$ of two fixed-size matrices.
+ *
+ * All the loop bounds are compile-time constants, so that for small sizes
+ * (e.g., 2x2 or 4x4) the product is fully unrolled and kept in registers.
+ */
+template <typename T, ::std::size_t R, ::std::size_t K, ::std::size_t C, typename PA, typename PB>
+fixed_matrix<T,R,C,PA> prod(fixed_matrix<T,R,K,PA> const& A, fixed_matrix<T,K,C,PB> const& B)
+{
+	fixed_matrix<T,R,C,PA> AB(uninitialized);
+
+	for (::std::size_t r = 0; r < R; ++r)
+	{
+		for (::std::size_t c = 0; c < C; ++c)
+		{
+			T s(0);
+			for (::std::size_t k = 0; k < K; ++k)
+			{
+				s += A(r,k)*B(k,c);
+			}
+			AB(r,c) = s;
+		}
+	}
+
+	return AB;
+}
+
+/// Returns the matrix-vector product \f$A x\f$ of a fixed-size matrix and vector.
+template <typename T, ::std::size_t R, ::std::size_t C, typename PA>
+fixed_vector<T,R> prod(fixed_matrix<T,R,C,PA> const& A, fixed_vector<T,C> const& x)
+{
+	fixed_vector<T,R> y(uninitialized);
+
+	for (::std::size_t r = 0; r < R; ++r)
+	{
+		T s(0);
+		for (::std::size_t c = 0; c < C; ++c)
+		{
+			s += A(r,c)*x(c);
+		}
+		y(r) = s;
+	}
+
+	return y;
+}
+
+/// Returns the transpose of a fixed-size matrix.
+template <typename T, ::std::size_t R, ::std::size_t C, typename PA>
+fixed_matrix<T,C,R,PA> transpose(fixed_matrix<T,R,C,PA> const& A)
+{
+	fixed_matrix<T,C,R,PA> At(uninitialized);
+
+	for (::std::size_t r = 0; r < R; ++r)
+	{
+		for (::std::size_t c = 0; c < C; ++c)
+		{
+			At(c,r) = A(r,c);
+		}
+	}
+
+	return At;
+}
+
+}}} // Namespace dcs::math::la
+
+
+#endif // DCS_MATH_LA_FIXED_HPP
@@ -0,0 +1,193 @@
+/**
+ * \file dcs/math/la/gemm.hpp
+ *
+ * \brief General matrix-matrix product (GEMM).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_GEMM_HPP
+#define DCS_MATH_LA_GEMM_HPP
+
+
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/la/detail/gemm.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math { namespace la {
+
+namespace detail {
+
+/// Computes the product for a range of rows of \f$C\f$ (used by worker threads).
+template <typename T>
+struct gemm_rows_task
+{
+	void operator()() const
+	{
+		gemm(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+	}
+
+	::std::size_t m;
+	::std::size_t n;
+	::std::size_t k;
+	T alpha;
+	T const* a;
+	::std::size_t rsa;
+	::std::size_t csa;
+	T const* b;
+	::std::size_t rsb;
+	::std::size_t csb;
+	T beta;
+	T* c;
+	::std::size_t rsc;
+	::std::size_t csc;
+}; // gemm_rows_task
+
+/**
+ * \brief Number of threads used by default for a \a m x \a n x \a k product.
+ *
+ * Small products are not worth the cost of spawning threads; otherwise,
+ * every thread gets at least one cache block of rows of \f$C\f$.
+ */
+template <typename T>
+::std::size_t gemm_default_num_threads(::std::size_t m, ::std::size_t n, ::std::size_t k)
+{
+	const double min_work(2097152); // ~128^3 multiply-adds
+
+	if (static_cast<double>(m)*static_cast<double>(n)*static_cast<double>(k) < min_work)
+	{
+		return 1;
+	}
+
+	const ::std::size_t hw(::boost::thread::hardware_concurrency());
+	const ::std::size_t mc(gemm_kernel_mc<T>());
+
+	return ::std::max(::std::size_t(1), ::std::min(hw, m/mc));
+}
+
+} // Namespace detail
+
+/**
+ * \brief Computes \f$C \gets \alpha A B + \beta C\f$.
+ *
+ * Any combination of storage layouts is supported; packing absorbs the
+ * differences, so that the inner kernel always runs on contiguous data.
+ *
+ * When \a num_threads is greater than one, the rows of \f$C\f$ are split
+ * into as many contiguous ranges, each one computed by a separate thread
+ * with its own packing buffers.
+ * When \a num_threads is zero, the number of threads is chosen according to
+ * the size of the product and the available hardware concurrency.
+ *
+ * When \f$\beta=0\f$, \a C needs not be initialized.
+ * \a C must not share storage with \a A or \a B.
+ */
+template <typename T, typename PA, typename AA, typename PB, typename AB, typename PC, typename AC>
+void gemm(T alpha,
+		  matrix<T,PA,AA> const& A,
+		  matrix<T,PB,AB> const& B,
+		  T beta,
+		  matrix<T,PC,AC>& C,
+		  ::std::size_t num_threads = 0)
+{
+	// pre: num_columns(A) == num_rows(B)
+	DCS_ASSERT(A.num_columns() == B.num_rows(),
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Matrices have incompatible sizes"));
+	// pre: num_rows(C) == num_rows(A) && num_columns(C) == num_columns(B)
+	DCS_ASSERT(C.num_rows() == A.num_rows() && C.num_columns() == B.num_columns(),
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Matrices have incompatible sizes"));
+
+	const ::std::size_t m(A.num_rows());
+	const ::std::size_t n(B.num_columns());
+	const ::std::size_t k(A.num_columns());
+
+	if (num_threads == 0)
+	{
+		num_threads = detail::gemm_default_num_threads<T>(m, n, k);
+	}
+	num_threads = ::std::max(::std::size_t(1), ::std::min(num_threads, m));
+
+	detail::gemm_rows_task<T> task;
+	task.m = m;
+	task.n = n;
+	task.k = k;
+	task.alpha = alpha;
+	task.a = A.begin_data();
+	task.rsa = A.row_stride();
+	task.csa = A.column_stride();
+	task.b = B.begin_data();
+	task.rsb = B.row_stride();
+	task.csb = B.column_stride();
+	task.beta = beta;
+	task.c = C.begin_data();
+	task.rsc = C.row_stride();
+	task.csc = C.column_stride();
+
+	if (num_threads == 1)
+	{
+		task();
+		return;
+	}
+
+	::boost::thread_group workers;
+	const ::std::size_t chunk((m+num_threads-1)/num_threads);
+	for (::std::size_t i0 = 0; i0 < m; i0 += chunk)
+	{
+		detail::gemm_rows_task<T> sub(task);
+		sub.m = ::std::min(chunk, m-i0);
+		sub.a = task.a+i0*task.rsa;
+		sub.c = task.c+i0*task.rsc;
+
+		if ((i0+chunk) < m)
+		{
+			workers.create_thread(sub);
+		}
+		else
+		{
+			// The last range is computed by the calling thread
+			sub();
+		}
+	}
+	workers.join_all();
+}
+
+/// Returns the matrix product \f$A B\f$ (with the storage layout of \a A).
+template <typename T, typename PA, typename AA, typename PB, typename AB>
+matrix<T,PA,AA> prod(matrix<T,PA,AA> const& A, matrix<T,PB,AB> const& B)
+{
+	matrix<T,PA,AA> C(A.num_rows(), B.num_columns(), uninitialized, A.get_allocator());
+
+	gemm(T(1), A, B, T(0), C);
+
+	return C;
+}
+
+}}} // Namespace dcs::math::la
+
+
+#endif // DCS_MATH_LA_GEMM_HPP
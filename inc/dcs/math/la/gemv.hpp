@@ -0,0 +1,108 @@
+/**
+ * \file dcs/math/la/gemv.hpp
+ *
+ * \brief General matrix-vector product (GEMV).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_GEMV_HPP
+#define DCS_MATH_LA_GEMV_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/la/detail/level1.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <dcs/math/type/vector.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math { namespace la {
+
+/**
+ * \brief Computes \f$y \gets \alpha A x + \beta y\f$.
+ *
+ * The traversal follows the storage layout of \a A: a row-major matrix is
+ * processed as a sequence of dot products (one per row), while a
+ * column-major matrix is processed as a sequence of AXPY operations (one
+ * per column), so that \a A is always read contiguously.
+ *
+ * When \f$\beta=0\f$, \a y needs not be initialized.
+ */
+template <typename T, typename PA, typename AA, typename PX, typename AX, typename PY, typename AY>
+void gemv(T alpha, matrix<T,PA,AA> const& A, vector<T,PX,AX> const& x, T beta, vector<T,PY,AY>& y)
+{
+	// pre: num_columns(A) == size(x)
+	DCS_ASSERT(A.num_columns() == x.length(),
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Matrix and vector have incompatible sizes"));
+	// pre: num_rows(A) == size(y)
+	DCS_ASSERT(A.num_rows() == y.length(),
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Matrix and vector have incompatible sizes"));
+
+	const ::std::size_t m(A.num_rows());
+	const ::std::size_t n(A.num_columns());
+	const ::std::size_t rs(A.row_stride());
+	const ::std::size_t cs(A.column_stride());
+	T const* a(A.begin_data());
+	T const* xx(x.begin_data());
+	T* yy(y.begin_data());
+
+	detail::scal(m, beta, yy, 1);
+
+	if (m == 0 || n == 0 || alpha == T(0))
+	{
+		return;
+	}
+
+	if (cs == 1)
+	{
+		for (::std::size_t i = 0; i < m; ++i)
+		{
+			yy[i] += alpha*detail::level1_kernel<T>::dot(n, a+i*rs, xx);
+		}
+	}
+	else
+	{
+		for (::std::size_t j = 0; j < n; ++j)
+		{
+			detail::axpy(m, alpha*xx[j], a+j*cs, rs, yy, 1);
+		}
+	}
+}
+
+/// Returns the matrix-vector product \f$A x\f$.
+template <typename T, typename PA, typename AA, typename PX, typename AX>
+vector<T,PX,AX> prod(matrix<T,PA,AA> const& A, vector<T,PX,AX> const& x)
+{
+	vector<T,PX,AX> y(A.num_rows(), uninitialized, x.get_allocator());
+
+	gemv(T(1), A, x, T(0), y);
+
+	return y;
+}
+
+}}} // Namespace dcs::math::la
+
+
+#endif // DCS_MATH_LA_GEMV_HPP
@@ -0,0 +1,66 @@
+/**
+ * \file dcs/math/la/transpose.hpp
+ *
+ * \brief Matrix transposition.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_LA_TRANSPOSE_HPP
+#define DCS_MATH_LA_TRANSPOSE_HPP
+
+
+#include <dcs/math/la/detail/gemm.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+
+
+namespace dcs { namespace math { namespace la {
+
+/**
+ * \brief Stores the transpose of \a A into \a B.
+ *
+ * \a B is resized as needed; \a A and \a B may have different storage
+ * layouts but must not be the same object.
+ */
+template <typename T, typename PA, typename AA, typename PB, typename AB>
+void transpose(matrix<T,PA,AA> const& A, matrix<T,PB,AB>& B)
+{
+	B.resize(A.num_columns(), A.num_rows(), uninitialized);
+
+	detail::transpose(A.num_rows(), A.num_columns(),
+					  A.begin_data(), A.row_stride(), A.column_stride(),
+					  B.begin_data(), B.row_stride(), B.column_stride());
+}
+
+/// Returns the transpose of \a A.
+template <typename T, typename PA, typename AA>
+matrix<T,PA,AA> transpose(matrix<T,PA,AA> const& A)
+{
+	matrix<T,PA,AA> B(A.num_columns(), A.num_rows(), uninitialized, A.get_allocator());
+
+	transpose(A, B);
+
+	return B;
+}
+
+}}} // Namespace dcs::math::la
+
+
+#endif // DCS_MATH_LA_TRANSPOSE_HPP
@@ -27,6 +27,10 @@
 
 #include <dcs/math/optim/neos/client.hpp>
 #include <dcs/math/optim/neos/input_format.hpp>
+#include <dcs/math/optim/neos/job_manager.hpp>
+#include <dcs/math/optim/neos/job_status.hpp>
+#include <dcs/math/optim/neos/results_sink.hpp>
+#include <dcs/math/optim/neos/results_tailer.hpp>
 #include <dcs/math/optim/neos/solver_category.hpp>
 #include <dcs/math/optim/neos/solver_id.hpp>
 
@@ -27,9 +27,13 @@
 
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/smart_ptr.hpp>
 #include <boost/thread.hpp>
+#include <boost/thread/future.hpp>
 #include <boost/chrono.hpp>
 #include <cstddef>
 #include <dcs/assert.hpp>
@@ -38,27 +42,20 @@
 #include <dcs/math/optim/neos/solver_category.hpp>
 #include <dcs/math/optim/neos/solver_id.hpp>
 #include <dcs/math/optim/neos/input_format.hpp>
-#include <dcs/text/base64.hpp>
+#include <dcs/math/optim/neos/job_status.hpp>
+#include <dcs/math/optim/neos/results_sink.hpp>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 //#include <unistd.h>
+#include <vector>
 #include <xmlrpc-c/base.hpp>
-#include <xmlrpc-c/client_simple.hpp>
+#include <xmlrpc-c/client.hpp>
+#include <xmlrpc-c/client_transport.hpp>
 
 
 namespace dcs { namespace math { namespace optim {
 
-enum neos_job_status
-{
-	done_neos_job_status,
-	running_neos_job_status,
-	waiting_neos_job_status,
-	unknown_job_neos_job_status,
-	bad_password_neos_job_status
-};
-
-
 struct neos_solver_category_info
 {
 	neos_solver_category category;
@@ -89,6 +86,14 @@ struct submitted_neos_job_info
 }; // submitted_neos_job_info
 
 
+/// A chunk of the intermediate results of a NEOS job.
+struct neos_intermediate_results
+{
+	::std::vector<unsigned char> data; ///< The output, as raw bytes
+	int offset; ///< The offset where the next chunk starts
+}; // neos_intermediate_results
+
+
 namespace /*<unnamed>*/ { namespace neos_detail {
 
 inline
@@ -987,14 +992,244 @@ submitted_neos_job_info make_submitted_job_info(::std::string const& s)
 	return info;
 }
 
+inline
+void check_rpc_type(xmlrpc_c::value const& v, xmlrpc_c::value::type_t type)
+{
+	if (v.type() != type)
+	{
+		::std::ostringstream oss;
+		oss << "Expected type '" << to_string(type) << "' (" << type << "), got type '" << to_string(v.type()) << "' (" << v.type() << ").";
+		DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+	}
+}
+
+inline
+neos_job_credentials rpc_to_job_credentials(xmlrpc_c::value const& rpc_res)
+{
+	check_rpc_type(rpc_res, xmlrpc_c::value::TYPE_ARRAY);
+
+	xmlrpc_c::carray const job_creds = xmlrpc_c::value_array(rpc_res).vectorValueValue();
+	if (job_creds.size() != 2)
+	{
+		DCS_EXCEPTION_THROW(::std::runtime_error, "Expected (jobnumber,password) credentials.");
+	}
+	check_rpc_type(job_creds[0], xmlrpc_c::value::TYPE_INT);
+	check_rpc_type(job_creds[1], xmlrpc_c::value::TYPE_STRING);
+
+	neos_job_credentials res;
+	res.id = xmlrpc_c::value_int(job_creds[0]);
+	res.password = xmlrpc_c::value_string(job_creds[1]);
+
+	DCS_DEBUG_TRACE("jobNumber = " << res.id << "\tpassword = " << res.password);
+
+	// Check for NEOS error:
+	//   "In case of an error (NEOS Job queue is full), submitJob() will return (0,errorMessage)"
+	if (res.id == 0)
+	{
+		::std::ostringstream oss;
+		oss << "Error from NEOS: '" << res.password << "'.";
+		DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+	}
+
+	return res;
+}
+
+inline
+neos_job_status rpc_to_job_status(xmlrpc_c::value const& rpc_res)
+{
+	check_rpc_type(rpc_res, xmlrpc_c::value::TYPE_STRING);
+
+	::std::string const status_str = xmlrpc_c::value_string(rpc_res);
+	neos_job_status res = make_job_status(status_str);
+
+	DCS_DEBUG_TRACE("Status: " << status_str << " (" << res << ").");
+
+	return res;
+}
+
+inline
+::std::string rpc_to_final_results(xmlrpc_c::value const& rpc_res)
+{
+	check_rpc_type(rpc_res, xmlrpc_c::value::TYPE_BYTESTRING);
+
+	xmlrpc_c::cbytestring const msg = xmlrpc_c::value_bytestring(rpc_res).vectorUcharValue();
+
+	::std::string res(msg.begin(), msg.end());
+
+	DCS_DEBUG_TRACE("Message: " << res);
+
+	return res;
+}
+
+inline
+neos_intermediate_results rpc_to_intermediate_results(xmlrpc_c::value const& rpc_res)
+{
+	check_rpc_type(rpc_res, xmlrpc_c::value::TYPE_ARRAY);
+
+	xmlrpc_c::carray const msg_offs = xmlrpc_c::value_array(rpc_res).vectorValueValue();
+	if (msg_offs.size() != 2)
+	{
+		DCS_EXCEPTION_THROW(::std::runtime_error, "Expected (msg,offset) result pair.");
+	}
+	check_rpc_type(msg_offs[0], xmlrpc_c::value::TYPE_BYTESTRING);
+	check_rpc_type(msg_offs[1], xmlrpc_c::value::TYPE_INT);
+
+	neos_intermediate_results res;
+	res.data = xmlrpc_c::value_bytestring(msg_offs[0]).vectorUcharValue();
+	res.offset = xmlrpc_c::value_int(msg_offs[1]);
+
+	DCS_DEBUG_TRACE("Message size: " << res.data.size() << " - Offset: " << res.offset);
+
+	return res;
+}
+
+inline
+xmlrpc_c::paramList make_job_params(neos_job_credentials const& creds)
+{
+	xmlrpc_c::paramList params;
+	params.add(xmlrpc_c::value_int(creds.id));
+	params.add(xmlrpc_c::value_string(creds.password));
+	return params;
+}
+
+inline
+xmlrpc_c::paramList make_intermediate_results_params(neos_job_credentials const& creds, int offset)
+{
+	// pre: offset >= 0
+	DCS_ASSERT(offset >= 0,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid offset"));
+
+	xmlrpc_c::paramList params(make_job_params(creds));
+	params.add(xmlrpc_c::value_int(offset));
+	return params;
+}
+
 }} // Namespace <unnamed>::neos_detail
 
 
+namespace detail {
+
+/// The XML-RPC client and transport shared by copies of a neos_client.
+struct neos_connection: private ::boost::noncopyable
+{
+	neos_connection(::boost::shared_ptr<xmlrpc_c::clientXmlTransport> const& p_trans, ::std::string const& url)
+	: p_transport(p_trans),
+	  client(p_trans.get()),
+	  carriage_parm(url)
+	{
+	}
+
+	::boost::shared_ptr<xmlrpc_c::clientXmlTransport> p_transport;
+	xmlrpc_c::client_xml client;
+	xmlrpc_c::carriageParm_curl0 carriage_parm;
+	/// Serializes the use of the client (which is not thread-safe)
+	::boost::mutex mutex;
+}; // neos_connection
+
+
+/// An asynchronous RPC whose outcome is delivered to a future.
+template <typename T>
+class neos_async_rpc: public xmlrpc_c::rpc
+{
+	public: typedef T (*converter_type)(xmlrpc_c::value const&);
+
+
+	public: neos_async_rpc(::std::string const& method, xmlrpc_c::paramList const& params, converter_type conv)
+	: xmlrpc_c::rpc(method, params),
+	  conv_(conv),
+	  p_done_(new bool(false))
+	{
+	}
+
+	public: ::boost::promise<T>& promise()
+	{
+		return promise_;
+	}
+
+	/// The flag telling if this RPC is finished, which outlives the RPC.
+	public: ::boost::shared_ptr<bool> done_flag() const
+	{
+		return p_done_;
+	}
+
+	/// Called by the client, with the connection mutex held, as soon as the response arrives.
+	public: void notifyComplete()
+	{
+		try
+		{
+			promise_.set_value(conv_(this->getResult()));
+		}
+		catch (::std::exception const& e)
+		{
+			promise_.set_exception(::boost::copy_exception(::std::runtime_error(e.what())));
+		}
+		*p_done_ = true;
+	}
+
+
+	private: converter_type conv_;
+	private: ::boost::promise<T> promise_;
+	private: ::boost::shared_ptr<bool> p_done_;
+}; // neos_async_rpc
+
+
+/**
+ * Wait callback of the futures returned by the asynchronous API.
+ *
+ * Waiting on a future drives the connection until the related RPC is
+ * finished, hence futures need no dedicated thread to become ready.
+ * Other outstanding RPCs finishing meanwhile fulfil their own futures.
+ */
+template <typename T>
+struct neos_async_rpc_waiter
+{
+	typedef void result_type;
+
+	neos_async_rpc_waiter(::boost::shared_ptr<neos_connection> const& p_conn, ::boost::shared_ptr<bool> const& p_done)
+	: p_conn(p_conn),
+	  p_done(p_done)
+	{
+	}
+
+	void operator()(::boost::promise<T>&) const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(p_conn->mutex);
+
+		while (!*p_done)
+		{
+			p_conn->client.finishAsync(xmlrpc_c::timeout(poll_timeout_ms));
+		}
+	}
+
+	static const unsigned int poll_timeout_ms = 50;
+
+	::boost::shared_ptr<neos_connection> p_conn;
+	::boost::shared_ptr<bool> p_done;
+}; // neos_async_rpc_waiter
+
+} // Namespace detail
+
+
 /**
  * \brief Implements the XML-RPC NEOS API.
  *
  * See http://www.neos-server.org/neos/NEOS-API.html
  *
+ * All the calls go through a single XML-RPC transport, which keeps its
+ * (HTTP keep-alive) connection open across calls.
+ * Copies of a client share the same transport.
+ *
+ * Besides the blocking API, jobs can be submitted and polled
+ * asynchronously through the \c *_async methods, which start the RPC and
+ * return a future without waiting for the response.
+ * Many RPCs can thus be in flight at once (e.g., to poll the status of many
+ * jobs from a single thread).
+ * The outstanding RPCs progress whenever a future is waited on or
+ * wait_all() is called; the client must outlive the returned futures.
+ *
+ * The client is thread-safe, but the use of the transport is serialized
+ * (i.e., a blocking call delays the other calls until it returns).
+ *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 class neos_client
@@ -1009,20 +1244,34 @@ class neos_client
 	//private: static const float default_zzz_time;
 
 
+	/// Creates a client connected to the given NEOS server through the Curl transport.
 	public: explicit neos_client(::std::string const& host = default_neos_host,
 								 int port = default_neos_port)
-	: url_(neos_detail::make_url(host,port))
+	: url_(neos_detail::make_url(host,port)),
+	  p_conn_(new detail::neos_connection(::boost::shared_ptr<xmlrpc_c::clientXmlTransport>(new xmlrpc_c::clientXmlTransport_curl()), url_))
 	{
 	}
 
+	/**
+	 * Creates a client talking to a NEOS server through the given transport
+	 * (e.g., the transport of a neos_mock_server).
+	 */
+	public: explicit neos_client(::boost::shared_ptr<xmlrpc_c::clientXmlTransport> const& p_transport,
+								 ::std::string const& host = default_neos_host,
+								 int port = default_neos_port)
+	: url_(neos_detail::make_url(host,port)),
+	  p_conn_(new detail::neos_connection(p_transport, url_))
+	{
+		// pre: p_transport != null
+		DCS_ASSERT(p_transport,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid XML-RPC transport"));
+	}
+
 	public: ::std::string help() const
 	{
 		::std::string res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "help", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("help"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1041,10 +1290,7 @@ class neos_client
 	{
 		::std::string res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "welcome", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("welcome"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1063,10 +1309,7 @@ class neos_client
 	{
 		::std::string res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "version", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("version"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1085,10 +1328,7 @@ class neos_client
 	{
 		bool res(false);
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "ping", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("ping"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1116,10 +1356,7 @@ class neos_client
 	{
 		::std::string res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "printQueue", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("printQueue"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1139,16 +1376,12 @@ class neos_client
 	{
 		::std::string res;
 
-		xmlrpc_c::clientSimple neos;
+		xmlrpc_c::paramList params;
+		params.add(xmlrpc_c::value_string(neos_detail::to_string(category)));
+		params.add(xmlrpc_c::value_string(neos_detail::to_string(solver)));
+		params.add(xmlrpc_c::value_string(neos_detail::to_string(method)));
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_,
-				  "getSolverTemplate",
-				  "sss",
-				  &rpc_res,
-				  neos_detail::to_string(category).c_str(),
-				  neos_detail::to_string(solver).c_str(),
-				  neos_detail::to_string(method).c_str());
+		xmlrpc_c::value rpc_res(this->call("getSolverTemplate", params));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1176,10 +1409,7 @@ class neos_client
 
 		::std::vector<neos_solver_info> res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "listAllSolvers", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("listAllSolvers"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_ARRAY)
 		{
 			::std::ostringstream oss;
@@ -1219,10 +1449,7 @@ class neos_client
 
 		::std::vector<neos_solver_category_info> res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "listCategories", &rpc_res);
+		xmlrpc_c::value rpc_res(this->call("listCategories"));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_ARRAY)
 		{
 			::std::ostringstream oss;
@@ -1262,10 +1489,10 @@ class neos_client
 
 		::std::vector<neos_solver_info> res;
 
-		xmlrpc_c::clientSimple neos;
+		xmlrpc_c::paramList params;
+		params.add(xmlrpc_c::value_string(neos_detail::to_string(category)));
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "listSolversInCategory", "s", &rpc_res, neos_detail::to_string(category).c_str());
+		xmlrpc_c::value rpc_res(this->call("listSolversInCategory", params));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_ARRAY)
 		{
 			::std::ostringstream oss;
@@ -1303,74 +1530,57 @@ class neos_client
 	{
 		DCS_DEBUG_TRACE("Submitting job: " << xml);//XXX
 
-		neos_job_credentials res;
+		return neos_detail::rpc_to_job_credentials(this->call("submitJob", make_submit_params(xml)));
+	}
 
-		xmlrpc_c::clientSimple neos;
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "submitJob", "s", &rpc_res, xml.c_str());
-		if (rpc_res.type() != xmlrpc_c::value::TYPE_ARRAY)
-		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_ARRAY) << "' (" << xmlrpc_c::value::TYPE_ARRAY << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
+	/// Submits a job without waiting for its credentials.
+	public: ::boost::future<neos_job_credentials> submit_job_async(::std::string const& xml) const
+	{
+		DCS_DEBUG_TRACE("Submitting job: " << xml);//XXX
 
-		carray const job_creds = xmlrpc_c::value_array(rpc_res).vectorValueValue();
-		if (job_creds.size() != 2)
-		{
-			DCS_EXCEPTION_THROW(::std::runtime_error, "Expected (jobnumber,password) credentials.");
-		}
-		if (job_creds[0].type() != xmlrpc_c::value::TYPE_INT)
-		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_INT) << "' (" << xmlrpc_c::value::TYPE_INT << "), got type '" << neos_detail::to_string(job_creds[0].type()) << "' (" << job_creds[0].type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
-		if (job_creds[1].type() != xmlrpc_c::value::TYPE_STRING)
-		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_STRING) << "' (" << xmlrpc_c::value::TYPE_STRING << "), got type '" << neos_detail::to_string(job_creds[1].type()) << "' (" << job_creds[1].type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
+		return this->start_async("submitJob", make_submit_params(xml), &neos_detail::rpc_to_job_credentials);
+	}
 
-		res.id = xmlrpc_c::value_int(job_creds[0]);
-		res.password = xmlrpc_c::value_string(job_creds[1]);
 
-		DCS_DEBUG_TRACE("jobNumber = " << res.id << "\tpassword = " << res.password);
+	public: neos_job_status job_status(neos_job_credentials const& creds) const
+	{
+		return neos_detail::rpc_to_job_status(this->call("getJobStatus", neos_detail::make_job_params(creds)));
+	}
 
-		// Check for NEOS error:
-		//   "In case of an error (NEOS Job queue is full), submitJob() will return (0,errorMessage)"
-		if (res.id == 0)
-		{
-			::std::ostringstream oss;
-			oss << "Error from NEOS: '" << res.password << "'.";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
 
-		return res;
+	/// Polls the status of a job without waiting for it.
+	public: ::boost::future<neos_job_status> job_status_async(neos_job_credentials const& creds) const
+	{
+		return this->start_async("getJobStatus", neos_detail::make_job_params(creds), &neos_detail::rpc_to_job_status);
 	}
 
 
-	public: neos_job_status job_status(neos_job_credentials const& creds) const
+	/**
+	 * Polls the status of many jobs at once.
+	 *
+	 * The status requests are all in flight at the same time, so that the
+	 * whole poll costs about one round-trip.
+	 */
+	public: ::std::vector<neos_job_status> job_statuses(::std::vector<neos_job_credentials> const& creds) const
 	{
-		neos_job_status res;
-
-		xmlrpc_c::clientSimple neos;
+		const ::std::size_t n(creds.size());
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "getJobStatus", "is", &rpc_res, creds.id, creds.password.c_str());
-		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
+		::std::vector< ::boost::shared_future<neos_job_status> > futs;
+		futs.reserve(n);
+		for (::std::size_t i = 0; i < n; ++i)
 		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_STRING) << "' (" << xmlrpc_c::value::TYPE_STRING << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+			futs.push_back(this->job_status_async(creds[i]).share());
 		}
 
-		::std::string const status_str = xmlrpc_c::value_string(rpc_res);
-		res = neos_detail::make_job_status(status_str);
+		this->wait_all();
 
-		DCS_DEBUG_TRACE("Status: " << status_str << " (" << res << ").");
+		::std::vector<neos_job_status> res;
+		res.reserve(n);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			res.push_back(futs[i].get());
+		}
 
 		return res;
 	}
@@ -1380,10 +1590,7 @@ class neos_client
 	{
 		submitted_neos_job_info res;
 
-		xmlrpc_c::clientSimple neos;
-
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "getJobInfo", "is", &rpc_res, creds.id, creds.password.c_str());
+		xmlrpc_c::value rpc_res(this->call("getJobInfo", neos_detail::make_job_params(creds)));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1403,10 +1610,10 @@ class neos_client
 	///FIXME: what is the return type of 'killJob'?
 	public: void kill_job(neos_job_credentials const& creds, ::std::string const& kill_msg = "") const
 	{
-		xmlrpc_c::clientSimple neos;
+		xmlrpc_c::paramList params(neos_detail::make_job_params(creds));
+		params.add(xmlrpc_c::value_string(kill_msg));
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, "killJob", "iss", &rpc_res, creds.id, creds.password.c_str(), kill_msg.c_str());
+		xmlrpc_c::value rpc_res(this->call("killJob", params));
 		if (rpc_res.type() != xmlrpc_c::value::TYPE_STRING)
 		{
 			::std::ostringstream oss;
@@ -1416,103 +1623,121 @@ class neos_client
 	}
 
 
+	/**
+	 * Returns the output of a job starting from the given offset, and sets
+	 * \a offset to where the next chunk starts.
+	 */
 	public: ::std::string intermediate_results(neos_job_credentials const& creds, int& offset, bool blocking = true) const
 	{
-		// pre: offset > 0
-		DCS_ASSERT(
-				offset > 0,
-				DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid offset")
-			);
+		const neos_intermediate_results res(this->fetch_intermediate_results(creds, offset, blocking));
 
-		::std::string res;
+		offset = res.offset;
 
-		::std::string method;
-		if (blocking)
-		{
-			method = "getIntermediateResults";
-		}
-		else
-		{
-			method = "getIntermediateResultsNonBlocking";
-		}
+		return ::std::string(res.data.begin(), res.data.end());
+	}
 
-		xmlrpc_c::clientSimple neos;
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, method, "isi", &rpc_res, creds.id, creds.password.c_str(), offset);
-		if (rpc_res.type() != xmlrpc_c::value::TYPE_ARRAY)
-		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_ARRAY) << "' (" << xmlrpc_c::value::TYPE_ARRAY << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
+	/**
+	 * Appends the output of a job starting from the given offset to a sink,
+	 * and sets \a offset to where the next chunk starts.
+	 *
+	 * Returns the number of appended bytes.
+	 */
+	public: ::std::size_t intermediate_results(neos_job_credentials const& creds, int& offset, neos_results_sink& sink, bool blocking = true) const
+	{
+		const neos_intermediate_results res(this->fetch_intermediate_results(creds, offset, blocking));
 
-		carray const msg_offs = xmlrpc_c::value_array(rpc_res).vectorValueValue();
-		if (msg_offs.size() != 2)
-		{
-			DCS_EXCEPTION_THROW(std::runtime_error, "Expected (msg,offset) result pair.");
-		}
-		if (msg_offs[0].type() != xmlrpc_c::value::TYPE_BYTESTRING)
-		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_BYTESTRING) << "' (" << xmlrpc_c::value::TYPE_BYTESTRING << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
-		}
-		if (msg_offs[1].type() != xmlrpc_c::value::TYPE_INT)
+		if (!res.data.empty())
 		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_INT) << "' (" << xmlrpc_c::value::TYPE_INT << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+			sink.append(reinterpret_cast<char const*>(&res.data[0]), res.data.size());
 		}
+		offset = res.offset;
 
-		cbytestring const msg_enc = xmlrpc_c::value_bytestring(msg_offs[0]).vectorUcharValue();
+		return res.data.size();
+	}
 
-		res = dcs::text::base64_decode(dcs::text::base64_encode(msg_enc.data(), msg_enc.size()));
 
-		offset = xmlrpc_c::value_int(msg_offs[1]);
+	/// Requests the output of a job starting from the given offset without waiting for it.
+	public: ::boost::future<neos_intermediate_results> intermediate_results_async(neos_job_credentials const& creds, int offset, bool blocking = false) const
+	{
+		return this->start_async(blocking ? "getIntermediateResults" : "getIntermediateResultsNonBlocking",
+								 neos_detail::make_intermediate_results_params(creds, offset),
+								 &neos_detail::rpc_to_intermediate_results);
+	}
 
-		DCS_DEBUG_TRACE("Message: " << res << " - Offset: " << offset);
 
-		return res;
+	public: ::std::string final_results(neos_job_credentials const& creds, bool blocking = true) const
+	{
+		return neos_detail::rpc_to_final_results(this->call(blocking ? "getFinalResults" : "getFinalResultsNonBlocking", neos_detail::make_job_params(creds)));
 	}
 
 
-	public: ::std::string final_results(neos_job_credentials const& creds, bool blocking = true) const
+	/// Requests the final results of a job without waiting for them.
+	public: ::boost::future< ::std::string > final_results_async(neos_job_credentials const& creds, bool blocking = true) const
 	{
-		::std::string res;
+		return this->start_async(blocking ? "getFinalResults" : "getFinalResultsNonBlocking", neos_detail::make_job_params(creds), &neos_detail::rpc_to_final_results);
+	}
+
+
+	/// Waits for all the outstanding asynchronous RPCs to finish.
+	public: void wait_all() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(p_conn_->mutex);
+
+		p_conn_->client.finishAsync(xmlrpc_c::timeout());
+	}
 
-		::std::string method;
-		if (blocking)
-		{
-			method = "getFinalResults";
-		}
-		else
-		{
-			method = "getFinalResultsNonBlocking";
-		}
 
-		xmlrpc_c::clientSimple neos;
+	private: neos_intermediate_results fetch_intermediate_results(neos_job_credentials const& creds, int offset, bool blocking) const
+	{
+		return neos_detail::rpc_to_intermediate_results(this->call(blocking ? "getIntermediateResults" : "getIntermediateResultsNonBlocking",
+																   neos_detail::make_intermediate_results_params(creds, offset)));
+	}
+
+	private: static xmlrpc_c::paramList make_submit_params(::std::string const& xml)
+	{
+		xmlrpc_c::paramList params;
+		params.add(xmlrpc_c::value_string(xml));
+		return params;
+	}
+
+	/// Performs a blocking RPC.
+	private: xmlrpc_c::value call(::std::string const& method, xmlrpc_c::paramList const& params = xmlrpc_c::paramList()) const
+	{
+		xmlrpc_c::rpcPtr p_rpc(method, params);
 
-		xmlrpc_c::value rpc_res;
-		neos.call(url_, method, "is", &rpc_res, creds.id, creds.password.c_str());
-		if (rpc_res.type() != xmlrpc_c::value::TYPE_BYTESTRING)
 		{
-			::std::ostringstream oss;
-			oss << "Expected type '" << neos_detail::to_string(xmlrpc_c::value::TYPE_BYTESTRING) << "' (" << xmlrpc_c::value::TYPE_BYTESTRING << "), got type '" << neos_detail::to_string(rpc_res.type()) << "' (" << rpc_res.type() << ").";
-			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+			::boost::lock_guard< ::boost::mutex > lock(p_conn_->mutex);
+
+			p_rpc->call(&p_conn_->client, &p_conn_->carriage_parm);
 		}
 
-		cbytestring const msg_enc = xmlrpc_c::value_bytestring(rpc_res).vectorUcharValue();
+		return p_rpc->getResult();
+	}
 
-		res = dcs::text::base64_decode(dcs::text::base64_encode(msg_enc.data(), msg_enc.size()));
+	/// Starts an RPC whose result, converted by \a conv, is delivered to the returned future.
+	private: template <typename T>
+			 ::boost::future<T> start_async(::std::string const& method, xmlrpc_c::paramList const& params, T (*conv)(xmlrpc_c::value const&)) const
+	{
+		detail::neos_async_rpc<T>* p_async(new detail::neos_async_rpc<T>(method, params, conv));
+		xmlrpc_c::rpcPtr p_rpc(p_async);
 
-		DCS_DEBUG_TRACE("Message: " << res);
+		p_async->promise().set_wait_callback(detail::neos_async_rpc_waiter<T>(p_conn_, p_async->done_flag()));
 
-		return res;
+		{
+			::boost::lock_guard< ::boost::mutex > lock(p_conn_->mutex);
+
+			p_rpc->start(&p_conn_->client, &p_conn_->carriage_parm);
+		}
+
+		// The client holds the RPC until it finishes, while the future shares
+		// the state of the promise, so it outlives the RPC
+		return p_async->promise().get_future();
 	}
 
 
 	private: ::std::string url_;
+	private: ::boost::shared_ptr<detail::neos_connection> p_conn_;
 }; // neos_client
 
 //const ::std::string client::default_neos_host("neos-dev1.discovery.wisc.edu");
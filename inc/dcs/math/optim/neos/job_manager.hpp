@@ -0,0 +1,503 @@
+/**
+ * \file dcs/math/optim/neos/job_manager.hpp
+ *
+ * \brief Batching, deduplication and caching of NEOS jobs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_OPTIM_NEOS_JOB_MANAGER_HPP
+#define DCS_MATH_OPTIM_NEOS_JOB_MANAGER_HPP
+
+
+#include <algorithm>
+#include <boost/chrono.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/smart_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/future.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/digest/md5.hpp>
+#include <dcs/digest/utility.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/optim/neos/client.hpp>
+#include <dcs/math/optim/neos/job_status.hpp>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace math { namespace optim {
+
+namespace detail {
+
+/// Wait callback making the futures of a job manager drive it.
+template <typename ManagerT>
+struct neos_job_manager_waiter
+{
+	typedef void result_type;
+
+	neos_job_manager_waiter(ManagerT* p_mgr, ::boost::shared_ptr<bool> const& p_done)
+	: p_mgr(p_mgr),
+	  p_done(p_done)
+	{
+	}
+
+	void operator()(::boost::promise< ::std::string >&) const
+	{
+		p_mgr->run_until(*p_done);
+	}
+
+	ManagerT* p_mgr;
+	::boost::shared_ptr<bool> p_done;
+}; // neos_job_manager_waiter
+
+} // Namespace detail
+
+
+/**
+ * \brief Runs batches of NEOS jobs with deduplication, caching and
+ *  concurrency limits.
+ *
+ * Jobs are identified by the MD5 digest of their XML.
+ * Submitting a job identical to a job already submitted to this manager
+ * (running or finished) returns the same result, without contacting the
+ * NEOS server.
+ * If a cache directory is set, the final results are also stored there, one
+ * file per job, and reused by later managers.
+ * The cache is best effort: results that cannot be stored are still
+ * delivered.
+ *
+ * At most max_in_flight() jobs run on the NEOS server at once; the others
+ * wait in a local queue.
+ * The status of the running jobs is polled with exponential backoff: a job
+ * is polled again after an interval which starts at the minimum poll
+ * interval and grows by the backoff factor each time the job is found still
+ * running, up to the maximum poll interval.
+ * All the requests of a scheduling step (submissions, status polls and
+ * result fetches) are pipelined (see neos_client).
+ *
+ * Results are delivered through shared futures.
+ * The manager progresses by step(), by run(), or by waiting on any of its
+ * futures.
+ * The manager is not thread-safe and must outlive its futures.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_job_manager: private ::boost::noncopyable
+{
+	public: typedef ::boost::chrono::steady_clock clock_type;
+	public: typedef clock_type::duration duration_type;
+	public: typedef ::boost::shared_future< ::std::string > result_future;
+
+
+	private: struct job
+	{
+		::std::string key;
+		::std::string xml;
+		neos_job_credentials creds;
+		::boost::shared_ptr< ::boost::promise< ::std::string > > p_promise;
+		::boost::shared_ptr<bool> p_done;
+		clock_type::time_point next_poll;
+		duration_type interval;
+	}; // job
+
+
+	public: static const ::std::size_t default_max_in_flight = 8;
+
+
+	public: explicit neos_job_manager(neos_client const& neos, ::std::string const& cache_dir = "")
+	: neos_(neos),
+	  cache_dir_(cache_dir),
+	  max_in_flight_(default_max_in_flight),
+	  min_interval_(::boost::chrono::seconds(1)),
+	  max_interval_(::boost::chrono::seconds(60)),
+	  backoff_(1.5),
+	  num_neos_jobs_(0),
+	  num_hits_(0)
+	{
+	}
+
+	/// Sets the maximum number of jobs running at once on the NEOS server.
+	public: void max_in_flight(::std::size_t n)
+	{
+		// pre: n > 0
+		DCS_ASSERT(n > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid number of jobs"));
+
+		max_in_flight_ = n;
+	}
+
+	public: ::std::size_t max_in_flight() const
+	{
+		return max_in_flight_;
+	}
+
+	/// Sets the bounds of the poll interval and its growth factor.
+	public: void poll_interval(duration_type min_interval, duration_type max_interval, double backoff)
+	{
+		// pre: min_interval <= max_interval
+		DCS_ASSERT(min_interval <= max_interval,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid poll interval bounds"));
+		// pre: backoff >= 1
+		DCS_ASSERT(backoff >= 1,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument, "Invalid backoff factor"));
+
+		min_interval_ = min_interval;
+		max_interval_ = max_interval;
+		backoff_ = backoff;
+	}
+
+	/**
+	 * Submits a job and returns its final results.
+	 *
+	 * The job is actually sent to the NEOS server only if neither an
+	 * identical job has already been submitted to this manager nor its
+	 * results are in the cache directory.
+	 */
+	public: result_future submit(::std::string const& xml)
+	{
+		const ::std::string key(make_key(xml));
+
+		const ::std::map< ::std::string, result_future >::const_iterator it(results_.find(key));
+		if (it != results_.end())
+		{
+			++num_hits_;
+			return it->second;
+		}
+
+		job j;
+		j.key = key;
+		j.p_promise = ::boost::make_shared< ::boost::promise< ::std::string > >();
+		j.p_done = ::boost::make_shared<bool>(false);
+
+		const result_future fut(j.p_promise->get_future().share());
+		results_[key] = fut;
+
+		::std::string cached;
+		if (this->load_cached(key, cached))
+		{
+			++num_hits_;
+			j.p_promise->set_value(cached);
+			*j.p_done = true;
+		}
+		else
+		{
+			j.xml = xml;
+			j.p_promise->set_wait_callback(detail::neos_job_manager_waiter<neos_job_manager>(this, j.p_done));
+			queued_.push_back(j);
+		}
+
+		return fut;
+	}
+
+	/// Returns the number of jobs not yet finished (queued or running).
+	public: ::std::size_t num_pending() const
+	{
+		return queued_.size()+running_.size();
+	}
+
+	/// Returns the number of jobs running on the NEOS server.
+	public: ::std::size_t num_in_flight() const
+	{
+		return running_.size();
+	}
+
+	/// Returns the number of jobs sent to the NEOS server.
+	public: ::std::size_t num_neos_jobs() const
+	{
+		return num_neos_jobs_;
+	}
+
+	/// Returns the number of submissions served by a previous job or by the cache.
+	public: ::std::size_t num_hits() const
+	{
+		return num_hits_;
+	}
+
+	/**
+	 * Performs one scheduling step.
+	 *
+	 * Polls the running jobs which are due, fetches the results of those
+	 * found done, and submits queued jobs as long as there is room.
+	 * Returns the number of jobs not yet finished.
+	 */
+	public: ::std::size_t step()
+	{
+		typedef ::boost::shared_future<neos_job_credentials> creds_future;
+		typedef ::boost::shared_future<neos_job_status> status_future;
+		typedef ::boost::shared_future< ::std::string > string_future;
+
+		const clock_type::time_point now(clock_type::now());
+
+		// Issue all the requests before waiting for any of them
+
+		::std::vector< ::std::size_t > due;
+		::std::vector<status_future> statuses;
+		for (::std::size_t i = 0; i < running_.size(); ++i)
+		{
+			if (running_[i].next_poll <= now)
+			{
+				due.push_back(i);
+				statuses.push_back(neos_.job_status_async(running_[i].creds).share());
+			}
+		}
+
+		::std::vector<job> submitted;
+		::std::vector<creds_future> creds;
+		while (!queued_.empty() && (running_.size()+submitted.size()) < max_in_flight_)
+		{
+			submitted.push_back(queued_.front());
+			queued_.erase(queued_.begin());
+			creds.push_back(neos_.submit_job_async(submitted.back().xml).share());
+			++num_neos_jobs_;
+		}
+
+		neos_.wait_all();
+
+		// Jobs found done have their results fetched; the others are polled later
+		::std::vector< ::std::size_t > done;
+		::std::vector<string_future> results;
+		for (::std::size_t k = 0; k < due.size(); ++k)
+		{
+			job& j(running_[due[k]]);
+
+			try
+			{
+				const neos_job_status status(statuses[k].get());
+				switch (status)
+				{
+					case running_neos_job_status:
+					case waiting_neos_job_status:
+						j.interval = ::std::min(max_interval_, ::boost::chrono::duration_cast<duration_type>(j.interval*backoff_));
+						j.next_poll = now+j.interval;
+						break;
+					case done_neos_job_status:
+						done.push_back(due[k]);
+						results.push_back(neos_.final_results_async(j.creds, false).share());
+						break;
+					default:
+					{
+						::std::ostringstream oss;
+						oss << "NEOS job " << j.creds.id << " cannot be completed (status: " << status << ")";
+						this->fail(j, oss.str());
+						break;
+					}
+				}
+			}
+			catch (::std::exception const& e)
+			{
+				this->fail(j, e.what());
+			}
+		}
+
+		neos_.wait_all();
+
+		for (::std::size_t k = 0; k < done.size(); ++k)
+		{
+			job& j(running_[done[k]]);
+
+			try
+			{
+				const ::std::string res(results[k].get());
+				j.xml.clear();
+				*j.p_done = true;
+				j.p_promise->set_value(res);
+
+				// The results are already delivered, so the cache is just
+				// missed by later submissions if it cannot be written
+				try
+				{
+					this->store_cached(j.key, res);
+				}
+				catch (::std::exception const& e)
+				{
+					DCS_DEBUG_TRACE("Cannot cache the results of NEOS job " << j.creds.id << ": " << e.what());
+				}
+			}
+			catch (::std::exception const& e)
+			{
+				this->fail(j, e.what());
+			}
+		}
+
+		// Drop finished jobs
+		::std::vector<job> active;
+		active.reserve(running_.size()+submitted.size());
+		for (::std::size_t i = 0; i < running_.size(); ++i)
+		{
+			if (!*running_[i].p_done)
+			{
+				active.push_back(running_[i]);
+			}
+		}
+
+		for (::std::size_t k = 0; k < submitted.size(); ++k)
+		{
+			job& j(submitted[k]);
+
+			try
+			{
+				j.creds = creds[k].get();
+				j.interval = min_interval_;
+				j.next_poll = now+j.interval;
+				active.push_back(j);
+			}
+			catch (::std::exception const& e)
+			{
+				this->fail(j, e.what());
+			}
+		}
+		running_.swap(active);
+
+		return this->num_pending();
+	}
+
+	/// Runs all the jobs to completion.
+	public: void run()
+	{
+		const bool never(false);
+
+		this->run_until(never);
+	}
+
+	/// Runs jobs until the given flag is set or no job is left.
+	public: void run_until(bool const& flag)
+	{
+		while (!flag && this->step() > 0)
+		{
+			if (!flag)
+			{
+				this->sleep_until_due();
+			}
+		}
+	}
+
+
+	private: static ::std::string make_key(::std::string const& xml)
+	{
+		::dcs::digest::md5_algorithm md5;
+
+		const ::std::vector< ::dcs::digest::byte_type > dig(md5.digest(xml));
+
+		return ::dcs::digest::hex_string(&dig[0], dig.size());
+	}
+
+	/// Waits until the next running job is due, unless queued jobs can be submitted now.
+	private: void sleep_until_due() const
+	{
+		if (running_.empty() || (!queued_.empty() && running_.size() < max_in_flight_))
+		{
+			return;
+		}
+
+		clock_type::time_point next(running_.front().next_poll);
+		for (::std::size_t i = 1; i < running_.size(); ++i)
+		{
+			next = ::std::min(next, running_[i].next_poll);
+		}
+		if (next > clock_type::now())
+		{
+			::boost::this_thread::sleep_until(next);
+		}
+	}
+
+	/// Makes a job fail; failed jobs can be submitted again.
+	private: void fail(job& j, ::std::string const& what)
+	{
+		results_.erase(j.key);
+		*j.p_done = true;
+		j.p_promise->set_exception(::boost::copy_exception(::std::runtime_error(what)));
+	}
+
+	private: ::std::string cache_path(::std::string const& key) const
+	{
+		return cache_dir_+"/"+key+".neos";
+	}
+
+	private: bool load_cached(::std::string const& key, ::std::string& res) const
+	{
+		if (cache_dir_.empty())
+		{
+			return false;
+		}
+
+		::std::ifstream ifs(this->cache_path(key).c_str(), ::std::ios_base::in | ::std::ios_base::binary);
+		if (!ifs)
+		{
+			return false;
+		}
+		res.assign(::std::istreambuf_iterator<char>(ifs), ::std::istreambuf_iterator<char>());
+
+		return true;
+	}
+
+	private: void store_cached(::std::string const& key, ::std::string const& res) const
+	{
+		if (cache_dir_.empty())
+		{
+			return;
+		}
+
+		// Write to a temporary file first, so that readers never see partial results
+		const ::std::string path(this->cache_path(key));
+		const ::std::string tmp_path(path+".tmp");
+		{
+			::std::ofstream ofs(tmp_path.c_str(), ::std::ios_base::out | ::std::ios_base::binary | ::std::ios_base::trunc);
+			ofs.write(res.data(), static_cast< ::std::streamsize >(res.size()));
+			ofs.close();
+			if (!ofs)
+			{
+				::std::remove(tmp_path.c_str());
+				DCS_EXCEPTION_THROW(::std::runtime_error, "Cannot write to the NEOS results cache");
+			}
+		}
+		if (::std::rename(tmp_path.c_str(), path.c_str()) != 0)
+		{
+			::std::remove(tmp_path.c_str());
+			DCS_EXCEPTION_THROW(::std::runtime_error, "Cannot write to the NEOS results cache");
+		}
+	}
+
+
+	private: neos_client neos_;
+	private: ::std::string cache_dir_;
+	private: ::std::size_t max_in_flight_;
+	private: duration_type min_interval_;
+	private: duration_type max_interval_;
+	private: double backoff_;
+	private: ::std::size_t num_neos_jobs_;
+	private: ::std::size_t num_hits_;
+	private: ::std::map< ::std::string, result_future > results_;
+	private: ::std::vector<job> queued_;
+	private: ::std::vector<job> running_;
+}; // neos_job_manager
+
+}}} // Namespace dcs::math::optim
+
+
+#endif // DCS_MATH_OPTIM_NEOS_JOB_MANAGER_HPP
@@ -0,0 +1,43 @@
+/**
+ * \file dcs/math/optim/neos/job_status.hpp
+ *
+ * \brief Status of NEOS jobs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_OPTIM_NEOS_JOB_STATUS_HPP
+#define DCS_MATH_OPTIM_NEOS_JOB_STATUS_HPP
+
+
+namespace dcs { namespace math { namespace optim {
+
+enum neos_job_status
+{
+	done_neos_job_status,
+	running_neos_job_status,
+	waiting_neos_job_status,
+	unknown_job_neos_job_status,
+	bad_password_neos_job_status
+};
+
+}}} // Namespace dcs::math::optim
+
+
+#endif // DCS_MATH_OPTIM_NEOS_JOB_STATUS_HPP
@@ -0,0 +1,486 @@
+/**
+ * \file dcs/math/optim/neos/mock_server.hpp
+ *
+ * \brief In-process stand-in for the NEOS XML-RPC server.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_OPTIM_NEOS_MOCK_SERVER_HPP
+#define DCS_MATH_OPTIM_NEOS_MOCK_SERVER_HPP
+
+
+#include <algorithm>
+#include <boost/noncopyable.hpp>
+#include <boost/smart_ptr.hpp>
+#include <boost/thread.hpp>
+#include <cstddef>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/client_transport.hpp>
+#include <xmlrpc-c/registry.hpp>
+
+
+namespace dcs { namespace math { namespace optim {
+
+/**
+ * \brief In-process stand-in for the NEOS XML-RPC server.
+ *
+ * The mock server serves the job-related part of the NEOS API (see
+ * neos_client) without any network traffic: the XML-RPC calls made through
+ * the transport returned by transport() are processed by an XML-RPC method
+ * registry living in the same process.
+ * It is meant for tests and for measuring the client-side overhead.
+ *
+ * A submitted job is reported as running for a given number of status polls
+ * (see run_polls()), each of which appends a line to the job log, and then as
+ * done.
+ * Blocking result requests make the job done at once.
+ * The final results of a job are given by result_of().
+ *
+ * Asynchronous RPCs are queued by the transport and served when the client
+ * waits for them, so that pipelining can be observed (see
+ * num_pending_calls()).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_mock_server: private ::boost::noncopyable
+{
+	private: struct job
+	{
+		::std::string xml;
+		::std::string password;
+		::std::size_t num_polls;
+		bool done;
+		bool killed;
+		::std::string log;
+	}; // job
+
+	private: typedef void (neos_mock_server::*handler_type)(xmlrpc_c::paramList const&, xmlrpc_c::value*);
+
+	/// Forwards an XML-RPC method to a member of the server.
+	private: class method_adaptor: public xmlrpc_c::method
+	{
+		public: method_adaptor(neos_mock_server* p_server, handler_type handler)
+		: p_server_(p_server),
+		  handler_(handler)
+		{
+		}
+
+		public: void execute(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+		{
+			(p_server_->*handler_)(params, p_res);
+		}
+
+
+		private: neos_mock_server* p_server_;
+		private: handler_type handler_;
+	}; // method_adaptor
+
+	/// Transport delivering the XML-RPC calls to the server.
+	private: class transport_impl: public xmlrpc_c::clientXmlTransport
+	{
+		public: explicit transport_impl(neos_mock_server* p_server)
+		: p_server_(p_server)
+		{
+		}
+
+		public: void call(xmlrpc_c::carriageParm* /*p_parm*/, ::std::string const& call_xml, ::std::string* p_res_xml)
+		{
+			p_server_->process(call_xml, p_res_xml);
+		}
+
+		public: void start(xmlrpc_c::carriageParm* /*p_parm*/, ::std::string const& call_xml, xmlrpc_c::xmlTransactionPtr const& p_trans)
+		{
+			p_server_->add_pending();
+			pending_.push_back(::std::make_pair(call_xml, p_trans));
+		}
+
+		public: void finishAsync(xmlrpc_c::timeout /*timeout*/)
+		{
+			while (!pending_.empty())
+			{
+				const ::std::pair< ::std::string, xmlrpc_c::xmlTransactionPtr > call(pending_.front());
+				pending_.pop_front();
+				p_server_->remove_pending();
+
+				::std::string res_xml;
+				p_server_->process(call.first, &res_xml);
+				call.second->finish(res_xml);
+			}
+		}
+
+
+		private: neos_mock_server* p_server_;
+		private: ::std::deque< ::std::pair< ::std::string, xmlrpc_c::xmlTransactionPtr > > pending_;
+	}; // transport_impl
+
+
+	public: explicit neos_mock_server(::std::size_t run_polls = 1)
+	: run_polls_(run_polls),
+	  num_calls_(0),
+	  num_pending_(0),
+	  max_num_pending_(0)
+	{
+		this->add_method("help", &neos_mock_server::help);
+		this->add_method("welcome", &neos_mock_server::welcome);
+		this->add_method("version", &neos_mock_server::version);
+		this->add_method("ping", &neos_mock_server::ping);
+		this->add_method("printQueue", &neos_mock_server::print_queue);
+		this->add_method("getSolverTemplate", &neos_mock_server::solver_template);
+		this->add_method("submitJob", &neos_mock_server::submit_job);
+		this->add_method("getJobStatus", &neos_mock_server::job_status);
+		this->add_method("killJob", &neos_mock_server::kill_job);
+		this->add_method("getIntermediateResults", &neos_mock_server::intermediate_results);
+		this->add_method("getIntermediateResultsNonBlocking", &neos_mock_server::intermediate_results_nonblocking);
+		this->add_method("getFinalResults", &neos_mock_server::final_results);
+		this->add_method("getFinalResultsNonBlocking", &neos_mock_server::final_results_nonblocking);
+	}
+
+	/**
+	 * Returns a new transport talking to this server.
+	 *
+	 * The server must outlive the transport.
+	 */
+	public: ::boost::shared_ptr<xmlrpc_c::clientXmlTransport> transport()
+	{
+		return ::boost::shared_ptr<xmlrpc_c::clientXmlTransport>(new transport_impl(this));
+	}
+
+	/// Sets the number of status polls a job is running for.
+	public: void run_polls(::std::size_t n)
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		run_polls_ = n;
+	}
+
+	public: ::std::size_t run_polls() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		return run_polls_;
+	}
+
+	/// Returns the number of served XML-RPC calls.
+	public: ::std::size_t num_calls() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		return num_calls_;
+	}
+
+	public: ::std::size_t num_submitted_jobs() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		return jobs_.size();
+	}
+
+	/// Returns the number of asynchronous calls which are waiting to be served.
+	public: ::std::size_t num_pending_calls() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		return num_pending_;
+	}
+
+	/// Returns the maximum number of asynchronous calls which have been waiting at the same time.
+	public: ::std::size_t max_num_pending_calls() const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		return max_num_pending_;
+	}
+
+	/// Returns the final results of a job with the given XML.
+	public: static ::std::string result_of(::std::string const& xml)
+	{
+		::std::ostringstream oss;
+		oss << "Solved job of " << xml.size() << " bytes\n";
+		return oss.str();
+	}
+
+
+	private: void add_method(::std::string const& name, handler_type handler)
+	{
+		registry_.addMethod(name, xmlrpc_c::methodPtr(new method_adaptor(this, handler)));
+	}
+
+	private: void process(::std::string const& call_xml, ::std::string* p_res_xml)
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		++num_calls_;
+		registry_.processCall(call_xml, p_res_xml);
+	}
+
+	private: void add_pending()
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		++num_pending_;
+		if (num_pending_ > max_num_pending_)
+		{
+			max_num_pending_ = num_pending_;
+		}
+	}
+
+	private: void remove_pending()
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		--num_pending_;
+	}
+
+	/// Returns the job with the given credentials, or null if they are not valid.
+	private: job* find_job(xmlrpc_c::paramList const& params, ::std::string* p_status)
+	{
+		const int id(params.getInt(0));
+		const ::std::string password(params.getString(1));
+
+		if (id <= 0 || static_cast< ::std::size_t >(id) > jobs_.size())
+		{
+			*p_status = "Unknown Job";
+			return 0;
+		}
+		job& j(jobs_[id-1]);
+		if (j.password != password)
+		{
+			*p_status = "Bad Password";
+			return 0;
+		}
+
+		return &j;
+	}
+
+	private: static void finish(job& j)
+	{
+		if (!j.done)
+		{
+			j.done = true;
+			j.log += j.killed ? "Job killed\n" : "Optimal solution found\n";
+		}
+	}
+
+	private: static xmlrpc_c::value_bytestring make_bytestring(::std::string const& s)
+	{
+		return xmlrpc_c::value_bytestring(::std::vector<unsigned char>(s.begin(), s.end()));
+	}
+
+	private: void help(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(0);
+		*p_res = xmlrpc_c::value_string("Mock NEOS server: serves the job-related NEOS API in-process.");
+	}
+
+	private: void welcome(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(0);
+		*p_res = xmlrpc_c::value_string("Welcome to the mock NEOS server");
+	}
+
+	private: void version(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(0);
+		*p_res = xmlrpc_c::value_string("mock");
+	}
+
+	private: void ping(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(0);
+		*p_res = xmlrpc_c::value_string("NeosServer is alive");
+	}
+
+	private: void print_queue(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(0);
+
+		::std::ostringstream oss;
+		for (::std::size_t i = 0; i < jobs_.size(); ++i)
+		{
+			if (!jobs_[i].done)
+			{
+				oss << "Job " << (i+1) << ": Running\n";
+			}
+		}
+		*p_res = xmlrpc_c::value_string(oss.str());
+	}
+
+	private: void solver_template(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(3);
+
+		::std::ostringstream oss;
+		oss << "<document>"
+			<< "<category>" << params.getString(0) << "</category>"
+			<< "<solver>" << params.getString(1) << "</solver>"
+			<< "<inputMethod>" << params.getString(2) << "</inputMethod>"
+			<< "<model></model><data></data><commands></commands><options></options><comments></comments>"
+			<< "</document>";
+		*p_res = xmlrpc_c::value_string(oss.str());
+	}
+
+	private: void submit_job(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(1);
+
+		job j;
+		j.xml = params.getString(0);
+		j.num_polls = 0;
+		j.done = false;
+		j.killed = false;
+		jobs_.push_back(j);
+
+		const int id(static_cast<int>(jobs_.size()));
+		::std::ostringstream oss;
+		oss << "pw" << id;
+		jobs_.back().password = oss.str();
+
+		::std::vector<xmlrpc_c::value> creds;
+		creds.push_back(xmlrpc_c::value_int(id));
+		creds.push_back(xmlrpc_c::value_string(jobs_.back().password));
+		*p_res = xmlrpc_c::value_array(creds);
+	}
+
+	private: void job_status(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(2);
+
+		::std::string status;
+		job* p_job(this->find_job(params, &status));
+		if (p_job)
+		{
+			if (!p_job->done)
+			{
+				if (p_job->num_polls < run_polls_)
+				{
+					++p_job->num_polls;
+					::std::ostringstream oss;
+					oss << "Iteration " << p_job->num_polls << "\n";
+					p_job->log += oss.str();
+				}
+				if (p_job->num_polls >= run_polls_)
+				{
+					finish(*p_job);
+				}
+			}
+			status = p_job->done ? "Done" : "Running";
+		}
+		*p_res = xmlrpc_c::value_string(status);
+	}
+
+	private: void kill_job(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		params.verifyEnd(3);
+
+		::std::string status;
+		job* p_job(this->find_job(params, &status));
+		if (p_job)
+		{
+			if (!p_job->done)
+			{
+				p_job->killed = true;
+				finish(*p_job);
+			}
+			::std::ostringstream oss;
+			oss << "Job #" << params.getInt(0) << " is being killed";
+			status = oss.str();
+		}
+		*p_res = xmlrpc_c::value_string(status);
+	}
+
+	private: void intermediate_results(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		this->do_intermediate_results(params, p_res, true);
+	}
+
+	private: void intermediate_results_nonblocking(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		this->do_intermediate_results(params, p_res, false);
+	}
+
+	private: void do_intermediate_results(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res, bool blocking)
+	{
+		params.verifyEnd(3);
+
+		::std::string status;
+		job* p_job(this->find_job(params, &status));
+		if (!p_job)
+		{
+			throw xmlrpc_c::fault(status);
+		}
+		if (blocking)
+		{
+			finish(*p_job);
+		}
+
+		const ::std::size_t offset(::std::min(static_cast< ::std::size_t >(params.getInt(2, 0)), p_job->log.size()));
+		::std::vector<xmlrpc_c::value> res;
+		res.push_back(make_bytestring(p_job->log.substr(offset)));
+		res.push_back(xmlrpc_c::value_int(static_cast<int>(p_job->log.size())));
+		*p_res = xmlrpc_c::value_array(res);
+	}
+
+	private: void final_results(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		this->do_final_results(params, p_res, true);
+	}
+
+	private: void final_results_nonblocking(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res)
+	{
+		this->do_final_results(params, p_res, false);
+	}
+
+	private: void do_final_results(xmlrpc_c::paramList const& params, xmlrpc_c::value* p_res, bool blocking)
+	{
+		params.verifyEnd(2);
+
+		::std::string status;
+		job* p_job(this->find_job(params, &status));
+		if (!p_job)
+		{
+			throw xmlrpc_c::fault(status);
+		}
+		if (blocking)
+		{
+			finish(*p_job);
+		}
+
+		*p_res = make_bytestring((p_job->done && !p_job->killed) ? result_of(p_job->xml) : ::std::string());
+	}
+
+
+	private: ::std::size_t run_polls_;
+	private: ::std::size_t num_calls_;
+	private: ::std::size_t num_pending_;
+	private: ::std::size_t max_num_pending_;
+	private: ::std::vector<job> jobs_;
+	private: xmlrpc_c::registry registry_;
+	private: mutable ::boost::mutex mutex_;
+}; // neos_mock_server
+
+}}} // Namespace dcs::math::optim
+
+
+#endif // DCS_MATH_OPTIM_NEOS_MOCK_SERVER_HPP
@@ -0,0 +1,153 @@
+/**
+ * \file dcs/math/optim/neos/results_sink.hpp
+ *
+ * \brief Sinks receiving the output of NEOS jobs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_OPTIM_NEOS_RESULTS_SINK_HPP
+#define DCS_MATH_OPTIM_NEOS_RESULTS_SINK_HPP
+
+
+#include <cstddef>
+#include <dcs/math/optim/neos/job_status.hpp>
+#include <ostream>
+#include <string>
+
+
+namespace dcs { namespace math { namespace optim {
+
+/**
+ * \brief Receiver of the output of a NEOS job, a chunk at a time.
+ *
+ * Output chunks are appended as raw bytes, exactly as they are received.
+ *
+ * A sink which cannot take more output for the moment (e.g., because its
+ * consumer is lagging behind) tells so through ready(); it is not fed again
+ * until it gets ready (see neos_results_tailer).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_results_sink
+{
+	public: virtual ~neos_results_sink()
+	{
+	}
+
+	/// Tells if the sink can take more output now.
+	public: virtual bool ready() const
+	{
+		return true;
+	}
+
+	/// Appends a chunk of output.
+	public: virtual void append(char const* data, ::std::size_t n) = 0;
+
+	/// Called once the job is over and all of its output has been appended.
+	public: virtual void finish(neos_job_status /*status*/)
+	{
+	}
+}; // neos_results_sink
+
+
+/**
+ * \brief Sink appending the output of a NEOS job to a string.
+ *
+ * The sink is not ready while the string holds at least a given number of
+ * characters, so that the consumer can apply back-pressure by leaving the
+ * string unconsumed.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_string_sink: public neos_results_sink
+{
+	public: explicit neos_string_sink(::std::string& s, ::std::size_t max_size = ::std::string::npos)
+	: s_(s),
+	  max_size_(max_size),
+	  finished_(false),
+	  status_(running_neos_job_status)
+	{
+	}
+
+	public: bool ready() const
+	{
+		return s_.size() < max_size_;
+	}
+
+	public: void append(char const* data, ::std::size_t n)
+	{
+		s_.append(data, n);
+	}
+
+	public: void finish(neos_job_status status)
+	{
+		finished_ = true;
+		status_ = status;
+	}
+
+	public: bool finished() const
+	{
+		return finished_;
+	}
+
+	/// Returns the final status of the job (meaningful only if finished()).
+	public: neos_job_status status() const
+	{
+		return status_;
+	}
+
+
+	private: ::std::string& s_;
+	private: ::std::size_t max_size_;
+	private: bool finished_;
+	private: neos_job_status status_;
+}; // neos_string_sink
+
+
+/**
+ * \brief Sink writing the output of a NEOS job to an output stream.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_ostream_sink: public neos_results_sink
+{
+	public: explicit neos_ostream_sink(::std::ostream& os)
+	: os_(os)
+	{
+	}
+
+	public: void append(char const* data, ::std::size_t n)
+	{
+		os_.write(data, static_cast< ::std::streamsize >(n));
+	}
+
+	public: void finish(neos_job_status /*status*/)
+	{
+		os_.flush();
+	}
+
+
+	private: ::std::ostream& os_;
+}; // neos_ostream_sink
+
+}}} // Namespace dcs::math::optim
+
+
+#endif // DCS_MATH_OPTIM_NEOS_RESULTS_SINK_HPP
@@ -0,0 +1,202 @@
+/**
+ * \file dcs/math/optim/neos/results_tailer.hpp
+ *
+ * \brief Streaming of the output of many NEOS jobs to sinks.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_OPTIM_NEOS_RESULTS_TAILER_HPP
+#define DCS_MATH_OPTIM_NEOS_RESULTS_TAILER_HPP
+
+
+#include <boost/thread/future.hpp>
+#include <cstddef>
+#include <dcs/math/optim/neos/client.hpp>
+#include <dcs/math/optim/neos/job_status.hpp>
+#include <dcs/math/optim/neos/results_sink.hpp>
+#include <vector>
+
+
+namespace dcs { namespace math { namespace optim {
+
+/**
+ * \brief Streams the output of many NEOS jobs, as it is produced, to sinks.
+ *
+ * Each call to poll() asks for the new output of every job whose sink is
+ * ready, along with its status, and appends the received output to the
+ * sink.
+ * The requests for all the jobs are in flight at the same time, so that a
+ * poll costs about one round-trip regardless of the number of jobs.
+ *
+ * Jobs whose sink is not ready are skipped (back-pressure), hence their
+ * output waits on the server rather than piling up in memory.
+ *
+ * A job is over once the server reports it as done; its remaining output is
+ * then fetched by the next poll, after which the sink is finished (see
+ * neos_results_sink::finish) and the job is dropped.
+ * Sinks must outlive their jobs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class neos_results_tailer
+{
+	private: struct job_entry
+	{
+		neos_job_credentials creds;
+		neos_results_sink* p_sink;
+		int offset;
+		bool done; ///< Tells if the job was reported as over by a previous poll
+		neos_job_status status;
+	}; // job_entry
+
+
+	public: explicit neos_results_tailer(neos_client const& neos)
+	: neos_(neos)
+	{
+	}
+
+	/// Starts tailing the output of the given job, from the given offset.
+	public: void add(neos_job_credentials const& creds, neos_results_sink& sink, int offset = 0)
+	{
+		job_entry job;
+		job.creds = creds;
+		job.p_sink = &sink;
+		job.offset = offset;
+		job.done = false;
+		job.status = running_neos_job_status;
+
+		jobs_.push_back(job);
+	}
+
+	/// Returns the number of jobs still tailed.
+	public: ::std::size_t num_jobs() const
+	{
+		return jobs_.size();
+	}
+
+	public: bool empty() const
+	{
+		return jobs_.empty();
+	}
+
+	/**
+	 * Polls all the jobs with a ready sink and returns the number of appended
+	 * bytes.
+	 *
+	 * If a request fails, its error is rethrown and the jobs not processed
+	 * yet are kept as they were, to be polled again.
+	 */
+	public: ::std::size_t poll()
+	{
+		typedef ::boost::shared_future<neos_intermediate_results> results_future;
+		typedef ::boost::shared_future<neos_job_status> status_future;
+
+		const ::std::size_t n(jobs_.size());
+
+		// Issue all the requests before waiting for any of them
+		::std::vector<results_future> results(n);
+		::std::vector<status_future> statuses(n);
+		::std::vector<bool> polled(n, false);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			job_entry const& job(jobs_[i]);
+
+			if (!job.p_sink->ready())
+			{
+				continue;
+			}
+
+			polled[i] = true;
+			results[i] = neos_.intermediate_results_async(job.creds, job.offset).share();
+			if (!job.done)
+			{
+				statuses[i] = neos_.job_status_async(job.creds).share();
+			}
+		}
+		neos_.wait_all();
+
+		::std::size_t num_bytes(0);
+		::std::vector<job_entry> active;
+		active.reserve(n);
+		::std::size_t i(0);
+		try
+		{
+			for (; i < n; ++i)
+			{
+				job_entry& job(jobs_[i]);
+
+				if (polled[i])
+				{
+					// The output of a job already over when the request was
+					// made is complete
+					const bool over(job.done);
+
+					if (!over)
+					{
+						job.status = statuses[i].get();
+						if (job.status == unknown_job_neos_job_status
+							|| job.status == bad_password_neos_job_status)
+						{
+							// No output will ever come
+							job.p_sink->finish(job.status);
+							continue;
+						}
+						job.done = (job.status == done_neos_job_status);
+					}
+
+					neos_intermediate_results const& res(results[i].get());
+					if (!res.data.empty())
+					{
+						job.p_sink->append(reinterpret_cast<char const*>(&res.data[0]), res.data.size());
+						num_bytes += res.data.size();
+					}
+					job.offset = res.offset;
+
+					if (over)
+					{
+						job.p_sink->finish(job.status);
+						continue;
+					}
+				}
+
+				active.push_back(job);
+			}
+		}
+		catch (...)
+		{
+			// Drop the jobs already finished, so that no sink is finished twice
+			active.insert(active.end(), jobs_.begin()+i, jobs_.end());
+			jobs_.swap(active);
+			throw;
+		}
+		jobs_.swap(active);
+
+		return num_bytes;
+	}
+
+
+	private: neos_client neos_;
+	private: ::std::vector<job_entry> jobs_;
+}; // neos_results_tailer
+
+}}} // Namespace dcs::math::optim
+
+
+#endif // DCS_MATH_OPTIM_NEOS_RESULTS_TAILER_HPP
@@ -31,6 +31,7 @@
 #include <dcs/algorithm/order.hpp>
 #include <dcs/assert.hpp>
 #include <dcs/functional/bind.hpp>
+#include <dcs/iterator/any_chunked_range.hpp>
 //#include <dcs/iterator/any_forward_iterator.hpp>
 //#include <dcs/iterator/iterator_range.hpp>
 #include <dcs/math/policies.hpp>
@@ -178,15 +179,16 @@ class discrete_distribution
 	}
 
 
-//	///\todo: Avoid using const_cast.
-//	public: ::dcs::iterator::iterator_range< ::dcs::iterator::any_forward_iterator<value_type> > probabilities() const
-//	{
-//
-//		return ::dcs::iterator::make_iterator_range(
-//			::dcs::iterator::make_any_forward_iterator(const_cast<discrete_distribution*>(this)->probs_.begin()),
-//			::dcs::iterator::make_any_forward_iterator(const_cast<discrete_distribution*>(this)->probs_.end())
-//		);
-//	}
+	/**
+	 * Returns the probabilities without copying them.
+	 *
+	 * The returned range refers to the probabilities of this distribution,
+	 * hence it must not outlive it.
+	 */
+	public: ::dcs::iterator::any_chunked_range<value_type> probability_range() const
+	{
+		return ::dcs::iterator::make_any_chunked_range(probs_);
+	}
 
 
 	/// Return the PDF
@@ -215,6 +217,13 @@ class discrete_distribution
 	}
 
 
+	/// Return the CDF without copying it (see probability_range()).
+	public: ::dcs::iterator::any_chunked_range<value_type> cdf_range() const
+	{
+		return ::dcs::iterator::make_any_chunked_range(cum_probs_);
+	}
+
+
 	/// Compute the CDF for the given value.
 	public: value_type cdf(int_type x) const
 	{
@@ -297,15 +306,20 @@ template <
 {
 	os << "Discrete(";
 
-	::std::vector<RealT> probs = dist.probabilities();
-	::std::size_t size = probs.size();
-	for (::std::size_t i = 0; i < size; ++i)
+	const ::dcs::iterator::any_chunked_range<RealT> probs(dist.probability_range());
+	const ::std::size_t size(probs.size());
+	for (::std::size_t i = 0; i < size; )
 	{
-		if (i > 0)
+		RealT const* p(0);
+		const ::std::size_t n(probs.chunk(i, p, 0, 0));
+		for (::std::size_t k = 0; k < n; ++k, ++i)
 		{
-			os << ",";
+			if (i > 0)
+			{
+				os << ",";
+			}
+			os << "p_" << i << "=" << p[k];
 		}
-		os << "p_" << i << "=" << probs[i];
 	}
 	os << ")";
 
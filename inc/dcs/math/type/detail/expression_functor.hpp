@@ -0,0 +1,148 @@
+/**
+ * \file dcs/math/type/detail/expression_functor.hpp
+ *
+ * \brief Scalar operations applied element-wise by vector and matrix expressions.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_DETAIL_EXPRESSION_FUNCTOR_HPP
+#define DCS_MATH_TYPE_DETAIL_EXPRESSION_FUNCTOR_HPP
+
+
+#include <cmath>
+
+
+namespace dcs { namespace math { namespace detail {
+
+template <typename T>
+struct scalar_negate
+{
+	typedef T result_type;
+
+	static result_type apply(T x)
+	{
+		return -x;
+	}
+};
+
+template <typename T>
+struct scalar_abs
+{
+	typedef T result_type;
+
+	static result_type apply(T x)
+	{
+		return ::std::abs(x);
+	}
+};
+
+template <typename T>
+struct scalar_plus
+{
+	typedef T result_type;
+
+	static result_type apply(T x, T y)
+	{
+		return x+y;
+	}
+};
+
+template <typename T>
+struct scalar_minus
+{
+	typedef T result_type;
+
+	static result_type apply(T x, T y)
+	{
+		return x-y;
+	}
+};
+
+template <typename T>
+struct scalar_multiplies
+{
+	typedef T result_type;
+
+	static result_type apply(T x, T y)
+	{
+		return x*y;
+	}
+};
+
+template <typename T>
+struct scalar_divides
+{
+	typedef T result_type;
+
+	static result_type apply(T x, T y)
+	{
+		return x/y;
+	}
+};
+
+template <typename T>
+struct scalar_assign
+{
+	static void apply(T& x, T y)
+	{
+		x = y;
+	}
+};
+
+template <typename T>
+struct scalar_plus_assign
+{
+	static void apply(T& x, T y)
+	{
+		x += y;
+	}
+};
+
+template <typename T>
+struct scalar_minus_assign
+{
+	static void apply(T& x, T y)
+	{
+		x -= y;
+	}
+};
+
+template <typename T>
+struct scalar_multiplies_assign
+{
+	static void apply(T& x, T y)
+	{
+		x *= y;
+	}
+};
+
+template <typename T>
+struct scalar_divides_assign
+{
+	static void apply(T& x, T y)
+	{
+		x /= y;
+	}
+};
+
+}}} // Namespace dcs::math::detail
+
+
+#endif // DCS_MATH_TYPE_DETAIL_EXPRESSION_FUNCTOR_HPP
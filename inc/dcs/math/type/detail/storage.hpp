@@ -26,11 +26,77 @@
 #define DCS_MATH_TYPE_DETAIL_STORAGE_HPP
 
 
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <cstddef>
 #include <dcs/math/type/matrix_properties.hpp>
+#include <memory>
 
 
 namespace dcs { namespace math { namespace detail {
 
+/// Allocates storage for \a n elements initialized to \a v.
+template <typename AllocT>
+typename AllocT::pointer allocate_storage(AllocT& alloc, ::std::size_t n, typename AllocT::value_type const& v)
+{
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	typename AllocT::pointer p = alloc.allocate(n);
+	try
+	{
+		::std::uninitialized_fill_n(p, n, v);
+	}
+	catch (...)
+	{
+		alloc.deallocate(p, n);
+		throw;
+	}
+
+	return p;
+}
+
+/**
+ * Allocates storage for \a n elements without initializing them.
+ *
+ * Elements of non-POD type are default-constructed.
+ */
+template <typename AllocT>
+typename AllocT::pointer allocate_storage(AllocT& alloc, ::std::size_t n)
+{
+	typedef typename AllocT::value_type value_type;
+
+	if (!::boost::is_pod<value_type>::value)
+	{
+		return allocate_storage(alloc, n, value_type());
+	}
+
+	return (n > 0) ? alloc.allocate(n) : 0;
+}
+
+/// Destroys the \a n elements in \a p and frees the storage.
+template <typename AllocT>
+void deallocate_storage(AllocT& alloc, typename AllocT::pointer p, ::std::size_t n)
+{
+	typedef typename AllocT::value_type value_type;
+
+	if (!p)
+	{
+		return;
+	}
+
+	if (!::boost::has_trivial_destructor<value_type>::value)
+	{
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			alloc.destroy(p+i);
+		}
+	}
+	alloc.deallocate(p, n);
+}
+
 template <typename LT>
 struct matrix_storage_helper;
 
@@ -49,6 +115,20 @@ struct matrix_storage_helper< column_major_storage_layout >
 		return nr;
 	}
 
+	/// Distance between two consecutive elements of the same column.
+	template <typename S>
+	static S row_stride(S /*nr*/, S /*nc*/)
+	{
+		return 1;
+	}
+
+	/// Distance between two consecutive elements of the same row.
+	template <typename S>
+	static S column_stride(S nr, S /*nc*/)
+	{
+		return nr;
+	}
+
 	template <typename V, typename S>
 	static V& at(V* data, S nr, S nc, S r, S c)
 	{
@@ -92,6 +172,20 @@ struct matrix_storage_helper< row_major_storage_layout >
 		return nc;
 	}
 
+	/// Distance between two consecutive elements of the same column.
+	template <typename S>
+	static S row_stride(S /*nr*/, S nc)
+	{
+		return nc;
+	}
+
+	/// Distance between two consecutive elements of the same row.
+	template <typename S>
+	static S column_stride(S /*nr*/, S /*nc*/)
+	{
+		return 1;
+	}
+
 	template <typename V, typename S>
 	static V& at(V* data, S nr, S nc, S r, S c)
 	{
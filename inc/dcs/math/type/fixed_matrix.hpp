@@ -0,0 +1,279 @@
+/**
+ * \file dcs/math/type/fixed_matrix.hpp
+ *
+ * \brief A numerical 2D dense matrix whose dimensions are fixed at compile time.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_FIXED_MATRIX_HPP
+#define DCS_MATH_TYPE_FIXED_MATRIX_HPP
+
+
+#include <algorithm>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/macro.hpp>
+#include <dcs/math/type/base_matrix.hpp>
+#include <dcs/math/type/detail/expression_functor.hpp>
+#include <dcs/math/type/detail/storage.hpp>
+#include <dcs/math/type/matrix_expression.hpp>
+#include <dcs/math/type/matrix_properties.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math {
+
+/**
+ * \brief A numerical 2D dense matrix of \a R rows and \a C columns.
+ *
+ * Elements are stored inline according to the storage layout given by the
+ * matrix properties, without any heap allocation; all loops have trip
+ * counts known at compile time.
+ * Element access is only bound-checked in debug builds (except for \c at()).
+ *
+ * The interface mirrors the one of matrix, and a fixed_matrix is a matrix
+ * expression, so that it can be mixed with matrix in expressions and
+ * converted to and from a matrix.
+ */
+template <typename ValueT,
+		  ::std::size_t R,
+		  ::std::size_t C,
+		  typename PropsT = default_matrix_properties>
+class fixed_matrix: public base_matrix<ValueT>,
+					public matrix_expression< fixed_matrix<ValueT,R,C,PropsT> >
+{
+	BOOST_STATIC_ASSERT( R > 0 && C > 0 );
+
+	private: typedef detail::matrix_storage_helper<typename PropsT::storage_layout> storage_helper_type;
+	public: typedef ValueT value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef PropsT properties_type;
+	public: typedef typename PropsT::storage_layout storage_layout;
+	public: static const size_type static_num_rows = R;
+	public: static const size_type static_num_columns = C;
+
+
+	/// Creates a matrix with all elements set to zero.
+	public: fixed_matrix()
+	{
+		::std::fill(data_, data_+R*C, value_type/*zero*/());
+	}
+
+	/// Creates a matrix with all elements set to \a v.
+	public: explicit fixed_matrix(value_type const& v)
+	{
+		::std::fill(data_, data_+R*C, v);
+	}
+
+	/// Creates a matrix without initializing its elements.
+	public: explicit fixed_matrix(uninitialized_tag)
+	{
+	}
+
+	/// Creates a matrix holding the values of the given expression, which must be \a R x \a C.
+	public: template <typename E>
+			fixed_matrix(matrix_expression<E> const& e)
+	{
+		this->assign< detail::scalar_assign<value_type> >(e());
+	}
+
+	public: template <typename E>
+			fixed_matrix& operator=(matrix_expression<E> const& e)
+	{
+		this->assign< detail::scalar_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			fixed_matrix& operator+=(matrix_expression<E> const& e)
+	{
+		this->assign< detail::scalar_plus_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			fixed_matrix& operator-=(matrix_expression<E> const& e)
+	{
+		this->assign< detail::scalar_minus_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: fixed_matrix& operator*=(value_type s)
+	{
+		for (size_type i = 0; i < R*C; ++i)
+		{
+			data_[i] *= s;
+		}
+
+		return *this;
+	}
+
+	public: fixed_matrix& operator/=(value_type s)
+	{
+		for (size_type i = 0; i < R*C; ++i)
+		{
+			data_[i] /= s;
+		}
+
+		return *this;
+	}
+
+	public: void swap(fixed_matrix& that)
+	{
+		::std::swap_ranges(data_, data_+R*C, that.data_);
+	}
+
+	public: static DCS_MACRO_CONSTEXPR size_type num_rows()
+	{
+		return R;
+	}
+
+	public: static DCS_MACRO_CONSTEXPR size_type num_columns()
+	{
+		return C;
+	}
+
+	public: static DCS_MACRO_CONSTEXPR size_type num_elements()
+	{
+		return R*C;
+	}
+
+	public: static DCS_MACRO_CONSTEXPR bool empty()
+	{
+		return false;
+	}
+
+	public: static size_type leading_dimension()
+	{
+		return storage_helper_type::leading_dimension(R, C);
+	}
+
+	/// Returns the distance in the storage between the elements (r,c) and (r+1,c).
+	public: static size_type row_stride()
+	{
+		return storage_helper_type::row_stride(R, C);
+	}
+
+	/// Returns the distance in the storage between the elements (r,c) and (r,c+1).
+	public: static size_type column_stride()
+	{
+		return storage_helper_type::column_stride(R, C);
+	}
+
+	public: value_type& operator()(size_type r, size_type c)
+	{
+		DCS_DEBUG_ASSERT( r < R && c < C );
+
+		return storage_helper_type::at(data_, R, C, r, c);
+	}
+
+	public: value_type const& operator()(size_type r, size_type c) const
+	{
+		DCS_DEBUG_ASSERT( r < R && c < C );
+
+		return storage_helper_type::at(data_, R, C, r, c);
+	}
+
+	public: value_type& at(size_type r, size_type c)
+	{
+		// pre: r < R && c < C
+		DCS_ASSERT(r < R && c < C,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Index out-of-bound"));
+
+		return storage_helper_type::at(data_, R, C, r, c);
+	}
+
+	public: value_type const& at(size_type r, size_type c) const
+	{
+		// pre: r < R && c < C
+		DCS_ASSERT(r < R && c < C,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Index out-of-bound"));
+
+		return storage_helper_type::at(data_, R, C, r, c);
+	}
+
+	public: value_type* begin_data()
+	{
+		return data_;
+	}
+
+	public: value_type const* begin_data() const
+	{
+		return data_;
+	}
+
+	public: value_type* end_data()
+	{
+		return data_+R*C;
+	}
+
+	public: value_type const* end_data() const
+	{
+		return data_+R*C;
+	}
+
+	private: template <typename F, typename E>
+			 void assign(E const& e)
+	{
+		// pre: size(e) == (R,C)
+		DCS_ASSERT(e.num_rows() == R && e.num_columns() == C,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Matrix expressions of different size"));
+
+		detail::matrix_assign<F, storage_layout>(data_, R, C, e);
+	}
+
+
+	private: value_type data_[R*C];
+}; // fixed_matrix
+
+template <typename ValueT, ::std::size_t R, ::std::size_t C, typename PropsT>
+const typename fixed_matrix<ValueT,R,C,PropsT>::size_type fixed_matrix<ValueT,R,C,PropsT>::static_num_rows;
+
+template <typename ValueT, ::std::size_t R, ::std::size_t C, typename PropsT>
+const typename fixed_matrix<ValueT,R,C,PropsT>::size_type fixed_matrix<ValueT,R,C,PropsT>::static_num_columns;
+
+template <typename ValueT, ::std::size_t R, ::std::size_t C, typename PropsT>
+inline
+void swap(fixed_matrix<ValueT,R,C,PropsT>& a, fixed_matrix<ValueT,R,C,PropsT>& b)
+{
+	a.swap(b);
+}
+
+/// Fixed-size matrices are held in expressions through a matrix_reference.
+template <typename ValueT, ::std::size_t R, ::std::size_t C, typename PropsT>
+struct matrix_closure< fixed_matrix<ValueT,R,C,PropsT> >
+{
+	typedef matrix_reference<ValueT, typename PropsT::storage_layout> type;
+};
+
+}} // Namespace dcs::math
+
+
+#endif // DCS_MATH_TYPE_FIXED_MATRIX_HPP
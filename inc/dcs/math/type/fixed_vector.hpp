@@ -0,0 +1,255 @@
+/**
+ * \file dcs/math/type/fixed_vector.hpp
+ *
+ * \brief A numerical dense vector whose size is fixed at compile time.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_FIXED_VECTOR_HPP
+#define DCS_MATH_TYPE_FIXED_VECTOR_HPP
+
+
+#include <algorithm>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/macro.hpp>
+#include <dcs/math/type/base_array.hpp>
+#include <dcs/math/type/detail/expression_functor.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <dcs/math/type/vector_expression.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math {
+
+/**
+ * \brief A numerical dense vector of \a N elements.
+ *
+ * Elements are stored inline (i.e., inside the object, without any heap
+ * allocation), and all loops have a trip count known at compile time, which
+ * lets the compiler fully unroll them for small sizes.
+ * Element access is only bound-checked in debug builds (except for \c at()).
+ *
+ * The interface mirrors the one of vector, and a fixed_vector is a vector
+ * expression, so that it can be mixed with vector in expressions and
+ * converted to and from a vector.
+ */
+template <typename ValueT, ::std::size_t N>
+class fixed_vector: public base_array<ValueT>,
+					public vector_expression< fixed_vector<ValueT,N> >
+{
+	BOOST_STATIC_ASSERT( N > 0 );
+
+	public: typedef ValueT value_type;
+	public: typedef ::std::size_t size_type;
+	public: static const size_type static_size = N;
+
+
+	/// Creates a vector with all elements set to zero.
+	public: fixed_vector()
+	{
+		::std::fill(data_, data_+N, value_type/*zero*/());
+	}
+
+	/// Creates a vector with all elements set to \a v.
+	public: explicit fixed_vector(value_type const& v)
+	{
+		::std::fill(data_, data_+N, v);
+	}
+
+	/// Creates a vector without initializing its elements.
+	public: explicit fixed_vector(uninitialized_tag)
+	{
+	}
+
+	/// Creates a vector holding the values of the given expression, which must have \a N elements.
+	public: template <typename E>
+			fixed_vector(vector_expression<E> const& e)
+	{
+		this->assign< detail::scalar_assign<value_type> >(e());
+	}
+
+	public: template <typename E>
+			fixed_vector& operator=(vector_expression<E> const& e)
+	{
+		this->assign< detail::scalar_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			fixed_vector& operator+=(vector_expression<E> const& e)
+	{
+		this->assign< detail::scalar_plus_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			fixed_vector& operator-=(vector_expression<E> const& e)
+	{
+		this->assign< detail::scalar_minus_assign<value_type> >(e());
+
+		return *this;
+	}
+
+	public: fixed_vector& operator*=(value_type s)
+	{
+		for (size_type i = 0; i < N; ++i)
+		{
+			data_[i] *= s;
+		}
+
+		return *this;
+	}
+
+	public: fixed_vector& operator/=(value_type s)
+	{
+		for (size_type i = 0; i < N; ++i)
+		{
+			data_[i] /= s;
+		}
+
+		return *this;
+	}
+
+	public: void swap(fixed_vector& that)
+	{
+		::std::swap_ranges(data_, data_+N, that.data_);
+	}
+
+	public: value_type& operator()(size_type i)
+	{
+		DCS_DEBUG_ASSERT( i < N );
+
+		return data_[i];
+	}
+
+	public: value_type const& operator()(size_type i) const
+	{
+		DCS_DEBUG_ASSERT( i < N );
+
+		return data_[i];
+	}
+
+	public: value_type& operator[](size_type i)
+	{
+		return operator()(i);
+	}
+
+	public: value_type const& operator[](size_type i) const
+	{
+		return operator()(i);
+	}
+
+	public: value_type& at(size_type i)
+	{
+		// pre: i < N
+		DCS_ASSERT(i < N,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Index out-of-bound"));
+
+		return data_[i];
+	}
+
+	public: value_type const& at(size_type i) const
+	{
+		// pre: i < N
+		DCS_ASSERT(i < N,
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Index out-of-bound"));
+
+		return data_[i];
+	}
+
+	public: static DCS_MACRO_CONSTEXPR size_type length()
+	{
+		return N;
+	}
+
+	public: static DCS_MACRO_CONSTEXPR bool empty()
+	{
+		return false;
+	}
+
+	public: value_type* begin_data()
+	{
+		return data_;
+	}
+
+	public: value_type const* begin_data() const
+	{
+		return data_;
+	}
+
+	public: value_type* end_data()
+	{
+		return data_+N;
+	}
+
+	public: value_type const* end_data() const
+	{
+		return data_+N;
+	}
+
+	private: template <typename F, typename E>
+			 void assign(E const& e)
+	{
+		const typename vector_closure<E>::type x(e);
+
+		// pre: length(e) == N
+		DCS_ASSERT(x.length() == N,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Vector expressions of different size"));
+
+		for (size_type i = 0; i < N; ++i)
+		{
+			F::apply(data_[i], x(i));
+		}
+	}
+
+
+	private: value_type data_[N];
+}; // fixed_vector
+
+template <typename ValueT, ::std::size_t N>
+const typename fixed_vector<ValueT,N>::size_type fixed_vector<ValueT,N>::static_size;
+
+template <typename ValueT, ::std::size_t N>
+inline
+void swap(fixed_vector<ValueT,N>& a, fixed_vector<ValueT,N>& b)
+{
+	a.swap(b);
+}
+
+/// Fixed-size vectors are held in expressions through a vector_reference.
+template <typename ValueT, ::std::size_t N>
+struct vector_closure< fixed_vector<ValueT,N> >
+{
+	typedef vector_reference<ValueT> type;
+};
+
+}} // Namespace dcs::math
+
+
+#endif // DCS_MATH_TYPE_FIXED_VECTOR_HPP
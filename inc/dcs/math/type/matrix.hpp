@@ -32,49 +32,93 @@
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/math/type/base_matrix.hpp>
+#include <dcs/math/type/detail/expression_functor.hpp>
 #include <dcs/math/type/detail/storage.hpp>
+#include <dcs/math/type/matrix_expression.hpp>
 #include <dcs/math/type/matrix_properties.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <dcs/memory/aligned_allocator.hpp>
 #include <stdexcept>
+#if __cplusplus >= 201103L
+# include <utility>
+#endif // __cplusplus >= 201103L
 
 
 namespace dcs { namespace math {
 
-template <typename ValueT, typename PropsT = default_matrix_properties>
-class matrix: public base_matrix<ValueT>
+/**
+ * \brief A numerical 2D dense matrix.
+ *
+ * Elements are stored contiguously according to the storage layout given by
+ * the matrix properties, in a block obtained from the given allocator (by
+ * default, aligned to a cache-line boundary).
+ *
+ * The allocated block can be larger than the number of elements (see
+ * \c capacity()), so that resizing to a smaller or equal number of elements
+ * does not reallocate.
+ *
+ * A matrix is also a matrix expression (see matrix_expression), and can be
+ * constructed from and assigned with any matrix expression.
+ */
+template <typename ValueT,
+		  typename PropsT = default_matrix_properties,
+		  typename AllocT = ::dcs::memory::aligned_allocator<ValueT> >
+class matrix: public base_matrix<ValueT>,
+			  public matrix_expression< matrix<ValueT,PropsT,AllocT> >
 {
 	private: typedef base_matrix<ValueT> base_type;
+	private: typedef detail::matrix_storage_helper<typename PropsT::storage_layout> storage_helper_type;
 	public: typedef ValueT value_type;
 	public: typedef ::std::size_t size_type;
 	public: typedef PropsT properties_type;
+	public: typedef AllocT allocator_type;
+	public: typedef typename PropsT::storage_layout storage_layout;
 
 
 	public: matrix()
 	: nr_(0),
 	  nc_(0),
 	  n_(0),
+	  cap_(0),
+	  alloc_(),
 	  data_(0)
 	{
 	}
 
 	public: matrix(size_type nr,
 				   size_type nc,
-				   value_type v = value_type/*zero*/())
+				   value_type v = value_type/*zero*/(),
+				   allocator_type const& alloc = allocator_type())
 	: nr_(nr),
 	  nc_(nc),
 	  n_(nr*nc),
-	  data_((n_ > 0) ? new value_type[n_] : 0)
+	  cap_(n_),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_, v))
+	{
+	}
+
+	/// Creates a matrix without initializing its elements.
+	public: matrix(size_type nr,
+				   size_type nc,
+				   uninitialized_tag,
+				   allocator_type const& alloc = allocator_type())
+	: nr_(nr),
+	  nc_(nc),
+	  n_(nr*nc),
+	  cap_(n_),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_))
 	{
-		if (data_)
-		{
-			::std::fill(data_, data_+n_, v);
-		}
 	}
 
-	public: matrix(matrix<value_type,properties_type> const& m)
+	public: matrix(matrix const& m)
 	: nr_(m.nr_),
 	  nc_(m.nc_),
 	  n_(m.n_),
-	  data_((n_ > 0) ? new value_type[n_] : 0)
+	  cap_(n_),
+	  alloc_(m.alloc_),
+	  data_(detail::allocate_storage(alloc_, n_))
 	{
 		if (data_)
 		{
@@ -82,42 +126,155 @@ class matrix: public base_matrix<ValueT>
 		}
 	}
 
+	/// Creates a matrix holding the values of the given expression.
+	public: template <typename E>
+			matrix(matrix_expression<E> const& e, allocator_type const& alloc = allocator_type())
+	: nr_(e().num_rows()),
+	  nc_(e().num_columns()),
+	  n_(nr_*nc_),
+	  cap_(n_),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_))
+	{
+		detail::matrix_assign< detail::scalar_assign<value_type>, storage_layout >(data_, nr_, nc_, e());
+	}
+
+#if __cplusplus >= 201103L
+	public: matrix(matrix&& m) noexcept
+	: nr_(m.nr_),
+	  nc_(m.nc_),
+	  n_(m.n_),
+	  cap_(m.cap_),
+	  alloc_(::std::move(m.alloc_)),
+	  data_(m.data_)
+	{
+		m.nr_ = m.nc_ = m.n_ = m.cap_ = 0;
+		m.data_ = 0;
+	}
+#endif // __cplusplus >= 201103L
+
 	public: ~matrix()
 	{
-		if (data_)
-		{
-			delete[] data_;
-		}
+		detail::deallocate_storage(alloc_, data_, cap_);
 	}
 
-	public: matrix<value_type>& operator=(matrix<value_type,properties_type> const& that)
+	public: matrix& operator=(matrix const& that)
 	{
 		if (this != &that)
 		{
+			// Reuse the current storage whenever it is large enough
+			this->reserve_discard(that.n_);
+			::std::copy(that.begin_data(), that.end_data(), data_);
+
 			nr_ = that.nr_;
 			nc_ = that.nc_;
 			n_ = that.n_;
-			if (data_)
-			{
-				delete[] data_;
-			}
-			if (n_ > 0)
-			{
-				data_ = new value_type[n_];
-				::std::copy(that.begin_data(), that.end_data(), data_);
-			}
-			else
-			{
-				data_ = 0;
-			}
 		}
 
 		return *this;
 	}
 
+#if __cplusplus >= 201103L
+	public: matrix& operator=(matrix&& that) noexcept
+	{
+		if (this != &that)
+		{
+			matrix tmp(::std::move(that));
+			this->swap(tmp);
+		}
+
+		return *this;
+	}
+#endif // __cplusplus >= 201103L
+
+	/**
+	 * Assigns the values of the given expression, evaluated in a single loop.
+	 *
+	 * The expression may refer to this matrix.
+	 */
+	public: template <typename E>
+			matrix& operator=(matrix_expression<E> const& e)
+	{
+		// The storage is not reallocated if this matrix is an operand of e,
+		// since operands must have the same size of e
+		this->resize(e().num_rows(), e().num_columns(), uninitialized);
+
+		detail::matrix_assign< detail::scalar_assign<value_type>, storage_layout >(data_, nr_, nc_, e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			matrix& operator+=(matrix_expression<E> const& e)
+	{
+		// pre: size(e) == size(*this)
+		DCS_ASSERT(e().num_rows() == nr_ && e().num_columns() == nc_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Matrix expressions of different size"));
+
+		detail::matrix_assign< detail::scalar_plus_assign<value_type>, storage_layout >(data_, nr_, nc_, e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			matrix& operator-=(matrix_expression<E> const& e)
+	{
+		// pre: size(e) == size(*this)
+		DCS_ASSERT(e().num_rows() == nr_ && e().num_columns() == nc_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Matrix expressions of different size"));
+
+		detail::matrix_assign< detail::scalar_minus_assign<value_type>, storage_layout >(data_, nr_, nc_, e());
+
+		return *this;
+	}
+
+	public: matrix& operator*=(value_type s)
+	{
+		detail::matrix_assign_scalar< detail::scalar_multiplies_assign<value_type> >(data_, n_, s);
+
+		return *this;
+	}
+
+	public: matrix& operator/=(value_type s)
+	{
+		detail::matrix_assign_scalar< detail::scalar_divides_assign<value_type> >(data_, n_, s);
+
+		return *this;
+	}
+
+	/// Exchanges the content of this matrix with the one of the given matrix, without copying elements.
+	public: void swap(matrix& that)
+	{
+		::std::swap(nr_, that.nr_);
+		::std::swap(nc_, that.nc_);
+		::std::swap(n_, that.n_);
+		::std::swap(cap_, that.cap_);
+		::std::swap(alloc_, that.alloc_);
+		::std::swap(data_, that.data_);
+	}
+
+	public: allocator_type get_allocator() const
+	{
+		return alloc_;
+	}
+
 	public: size_type leading_dimension() const
 	{
-		return detail::matrix_storage_helper<typename properties_type::storage_layout>::leading_dimension(nr_, nc_);
+		return storage_helper_type::leading_dimension(nr_, nc_);
+	}
+
+	/// Returns the distance in the storage between the elements (r,c) and (r+1,c).
+	public: size_type row_stride() const
+	{
+		return storage_helper_type::row_stride(nr_, nc_);
+	}
+
+	/// Returns the distance in the storage between the elements (r,c) and (r,c+1).
+	public: size_type column_stride() const
+	{
+		return storage_helper_type::column_stride(nr_, nc_);
 	}
 
 	public: size_type num_rows() const
@@ -135,6 +292,12 @@ class matrix: public base_matrix<ValueT>
 		return n_;
 	}
 
+	/// Returns the number of elements the allocated storage can hold.
+	public: size_type capacity() const
+	{
+		return cap_;
+	}
+
 	public: value_type& operator()(size_type r, size_type c)
 	{
         // pre: data_ != null
@@ -150,7 +313,7 @@ class matrix: public base_matrix<ValueT>
 				   DCS_EXCEPTION_THROW(::std::logic_error,
 									   "Column index out-of-bound"));
 
-		return detail::matrix_storage_helper<typename properties_type::storage_layout>::template at(data_, nr_, nc_, r, c);
+		return storage_helper_type::at(data_, nr_, nc_, r, c);
 	}
 
 	public: value_type const& operator()(size_type r, size_type c) const
@@ -168,7 +331,7 @@ class matrix: public base_matrix<ValueT>
 				   DCS_EXCEPTION_THROW(::std::logic_error,
 									   "Column index out-of-bound"));
 
-		return detail::matrix_storage_helper<typename properties_type::storage_layout>::template at(data_, nr_, nc_, r, c);
+		return storage_helper_type::at(static_cast<value_type const*>(data_), nr_, nc_, r, c);
 	}
 
 	public: value_type& at(size_type r, size_type c)
@@ -181,6 +344,15 @@ class matrix: public base_matrix<ValueT>
 		return operator()(r,c);
 	}
 
+	/**
+	 * Resizes the matrix.
+	 *
+	 * When \a preserve is \c true, elements in the common area of the old and
+	 * of the new matrix are preserved, while the remaining ones are set to
+	 * zero.
+	 * Otherwise, all elements are set to zero.
+	 * The current storage is reused whenever possible.
+	 */
 	public: void resize(size_type nr, size_type nc, bool preserve = true)
 	{
 		const size_type n(nr*nc);
@@ -189,19 +361,18 @@ class matrix: public base_matrix<ValueT>
 		{
 			// Resize without data preservation
 
-			if (n_ > 0)
-			{
-				delete[] data_;
-			}
-			if (n > 0)
-			{
-				data_ = new value_type[n];
+			this->reserve_discard(n);
 
-				::std::fill(data_, data_+n, value_type/*zero*/());
-			}
-			else
+			::std::fill(data_, data_+n, value_type/*zero*/());
+		}
+		else if (n <= cap_ && storage_helper_type::leading_dimension(nr_, nc_) == storage_helper_type::leading_dimension(nr, nc))
+		{
+			// Resize in place with data preservation: the preserved elements
+			// are already in the right place
+
+			if (n > n_)
 			{
-				data_ = 0;
+				::std::fill(data_+n_, data_+n, value_type/*zero*/());
 			}
 		}
 		else
@@ -210,29 +381,22 @@ class matrix: public base_matrix<ValueT>
 
 			const size_type mnr(::std::min(nr_, nr));
 			const size_type mnc(::std::min(nc_, nc));
-			const size_type mn(mnr*mnc);
-
-			value_type* tmp_data = new value_type[mn];
+			const size_type ncap(::std::max(n, cap_));
 
-			// Back-up old data
-			//::std::copy(data_, data_+mn, tmp_data);
-			detail::matrix_storage_helper<typename properties_type::storage_layout>::template copy(data_, nr_, nc_, tmp_data, nr, nc, mnr, mnc);
-
-			delete[] data_;
-
-			data_ = new value_type[n];
+			value_type* tmp_data = detail::allocate_storage(alloc_, ncap);
 
 			// If the new dimension covers a larger area than the older one, fill the gap with zeros
-			if (n > mn)
+			if (n > (mnr*mnc))
 			{
-				::std::fill(data_, data_+n, value_type/*zero*/());
+				::std::fill(tmp_data, tmp_data+n, value_type/*zero*/());
 			}
 
-			// Restore old data
-			//::std::copy(tmp_data, tmp_data+mn, data_);
-			detail::matrix_storage_helper<typename properties_type::storage_layout>::template copy(tmp_data, nr, nc, data_, nr, nc, mnr, mnc);
+			storage_helper_type::copy(static_cast<value_type const*>(data_), nr_, nc_, tmp_data, nr, nc, mnr, mnc);
 
-			delete[] tmp_data;
+			detail::deallocate_storage(alloc_, data_, cap_);
+
+			data_ = tmp_data;
+			cap_ = ncap;
 		}
 
 		n_ = n;
@@ -240,6 +404,38 @@ class matrix: public base_matrix<ValueT>
 		nc_ = nc;
 	}
 
+	/**
+	 * Resizes the matrix without preserving nor initializing its elements.
+	 *
+	 * The current storage is reused whenever it is large enough.
+	 */
+	public: void resize(size_type nr, size_type nc, uninitialized_tag)
+	{
+		const size_type n(nr*nc);
+
+		this->reserve_discard(n);
+
+		n_ = n;
+		nr_ = nr;
+		nc_ = nc;
+	}
+
+	/// Makes the allocated storage large enough for \a n elements, preserving current elements.
+	public: void reserve(size_type n)
+	{
+		if (n > cap_)
+		{
+			value_type* tmp_data = detail::allocate_storage(alloc_, n);
+
+			::std::copy(data_, data_+n_, tmp_data);
+
+			detail::deallocate_storage(alloc_, data_, cap_);
+
+			data_ = tmp_data;
+			cap_ = n;
+		}
+	}
+
 	public: bool empty() const
 	{
 		return n_ == 0;
@@ -265,13 +461,43 @@ class matrix: public base_matrix<ValueT>
 		return data_+n_;
 	}
 
+	/// Makes the allocated storage large enough for \a n elements, without preserving current elements.
+	private: void reserve_discard(size_type n)
+	{
+		if (n > cap_)
+		{
+			value_type* tmp_data = detail::allocate_storage(alloc_, n);
+
+			detail::deallocate_storage(alloc_, data_, cap_);
+
+			data_ = tmp_data;
+			cap_ = n;
+		}
+	}
+
 
 	private: size_type nr_; ///< Number of rows
 	private: size_type nc_; ///< Number of columns
 	private: size_type n_; ///< Number of elements
+	private: size_type cap_; ///< Number of elements of the allocated storage
+	private: allocator_type alloc_; ///< The storage allocator
 	private: value_type* data_;
 }; // matrix
 
+/// Matrices are held in expressions through a matrix_reference.
+template <typename ValueT, typename PropsT, typename AllocT>
+struct matrix_closure< matrix<ValueT,PropsT,AllocT> >
+{
+	typedef matrix_reference<ValueT, typename PropsT::storage_layout> type;
+};
+
+template <typename ValueT, typename PropsT, typename AllocT>
+inline
+void swap(matrix<ValueT,PropsT,AllocT>& a, matrix<ValueT,PropsT,AllocT>& b)
+{
+	a.swap(b);
+}
+
 }} // Namespace dcs::math
 
 #endif // DCS_MATH_TYPE_MATRIX_HPP
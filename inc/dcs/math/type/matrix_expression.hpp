@@ -0,0 +1,577 @@
+/**
+ * \file dcs/math/type/matrix_expression.hpp
+ *
+ * \brief Lazy element-wise expressions over numerical dense matrices.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_MATRIX_EXPRESSION_HPP
+#define DCS_MATH_TYPE_MATRIX_EXPRESSION_HPP
+
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/type/detail/expression_functor.hpp>
+#include <dcs/math/type/matrix_properties.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math {
+
+/// Storage layout of expressions whose operands have different storage layouts.
+struct mixed_storage_layout { };
+
+
+/**
+ * \brief Base class of all matrix expressions (Curiously Recurring Template
+ *  Pattern).
+ *
+ * A matrix expression \c E held in an expression (see matrix_closure)
+ * provides:
+ * - \c value_type and \c size_type,
+ * - \c storage_layout, the storage layout shared by all the operands (or
+ *   mixed_storage_layout),
+ * - \c num_rows() and \c num_columns(),
+ * - \c operator()(r,c), the value of the element at row r and column c,
+ * - \c linear(i), the value of the i-th element in storage order (only
+ *   meaningful when the storage layout is not mixed).
+ * .
+ *
+ * As for vector expressions (see vector_expression), values are only
+ * computed, in a single loop and without intermediate matrices, when the
+ * expression is assigned to a matrix or reduced to a scalar.
+ * When the storage layout of the expression matches the one of the target
+ * matrix, elements are visited in storage order as a flat array; otherwise,
+ * they are visited following the storage layout of the target matrix.
+ */
+template <typename E>
+struct matrix_expression
+{
+	typedef E expression_type;
+
+	/// Returns the actual expression.
+	E const& operator()() const
+	{
+		return *static_cast<E const*>(this);
+	}
+}; // matrix_expression
+
+
+/// Lightweight view of the elements of a dense matrix (see vector_reference).
+template <typename T, typename LayoutT>
+class matrix_reference: public matrix_expression< matrix_reference<T,LayoutT> >
+{
+	public: typedef T value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef LayoutT storage_layout;
+
+
+	public: template <typename MatrixT>
+			explicit matrix_reference(MatrixT const& m)
+	: data_(m.begin_data()),
+	  nr_(m.num_rows()),
+	  nc_(m.num_columns()),
+	  rs_(m.row_stride()),
+	  cs_(m.column_stride())
+	{
+	}
+
+	public: size_type num_rows() const
+	{
+		return nr_;
+	}
+
+	public: size_type num_columns() const
+	{
+		return nc_;
+	}
+
+	public: value_type const& operator()(size_type r, size_type c) const
+	{
+		return data_[r*rs_+c*cs_];
+	}
+
+	public: value_type const& linear(size_type i) const
+	{
+		return data_[i];
+	}
+
+
+	private: value_type const* data_;
+	private: size_type nr_;
+	private: size_type nc_;
+	private: size_type rs_;
+	private: size_type cs_;
+}; // matrix_reference
+
+
+/// The type used to hold an operand of type \a E in an expression (see vector_closure).
+template <typename E>
+struct matrix_closure
+{
+	typedef E type;
+};
+
+
+namespace detail {
+
+template <typename L1, typename L2>
+struct common_storage_layout
+{
+	typedef mixed_storage_layout type;
+};
+
+template <typename L>
+struct common_storage_layout<L,L>
+{
+	typedef L type;
+};
+
+} // Namespace detail
+
+
+/// Element-wise application of a unary operation.
+template <typename E, typename F>
+class matrix_unary: public matrix_expression< matrix_unary<E,F> >
+{
+	private: typedef typename matrix_closure<E>::type closure_type;
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef typename closure_type::storage_layout storage_layout;
+
+
+	public: explicit matrix_unary(E const& e)
+	: e_(e)
+	{
+	}
+
+	public: size_type num_rows() const
+	{
+		return e_.num_rows();
+	}
+
+	public: size_type num_columns() const
+	{
+		return e_.num_columns();
+	}
+
+	public: value_type operator()(size_type r, size_type c) const
+	{
+		return F::apply(e_(r,c));
+	}
+
+	public: value_type linear(size_type i) const
+	{
+		return F::apply(e_.linear(i));
+	}
+
+
+	private: closure_type e_;
+}; // matrix_unary
+
+
+/// Element-wise application of a binary operation.
+template <typename E1, typename E2, typename F>
+class matrix_binary: public matrix_expression< matrix_binary<E1,E2,F> >
+{
+	private: typedef typename matrix_closure<E1>::type closure1_type;
+	private: typedef typename matrix_closure<E2>::type closure2_type;
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef typename detail::common_storage_layout<typename closure1_type::storage_layout,
+														   typename closure2_type::storage_layout>::type storage_layout;
+
+
+	public: matrix_binary(E1 const& e1, E2 const& e2)
+	: e1_(e1),
+	  e2_(e2)
+	{
+		// pre: size(e1) == size(e2)
+		DCS_ASSERT(e1_.num_rows() == e2_.num_rows() && e1_.num_columns() == e2_.num_columns(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Matrix expressions of different size"));
+	}
+
+	public: size_type num_rows() const
+	{
+		return e1_.num_rows();
+	}
+
+	public: size_type num_columns() const
+	{
+		return e1_.num_columns();
+	}
+
+	public: value_type operator()(size_type r, size_type c) const
+	{
+		return F::apply(e1_(r,c), e2_(r,c));
+	}
+
+	public: value_type linear(size_type i) const
+	{
+		return F::apply(e1_.linear(i), e2_.linear(i));
+	}
+
+
+	private: closure1_type e1_;
+	private: closure2_type e2_;
+}; // matrix_binary
+
+
+/// Binary operation between each element and a scalar (the element being the left operand).
+template <typename E, typename F>
+class matrix_binary_scalar2: public matrix_expression< matrix_binary_scalar2<E,F> >
+{
+	private: typedef typename matrix_closure<E>::type closure_type;
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef typename closure_type::storage_layout storage_layout;
+
+
+	public: matrix_binary_scalar2(E const& e, value_type s)
+	: e_(e),
+	  s_(s)
+	{
+	}
+
+	public: size_type num_rows() const
+	{
+		return e_.num_rows();
+	}
+
+	public: size_type num_columns() const
+	{
+		return e_.num_columns();
+	}
+
+	public: value_type operator()(size_type r, size_type c) const
+	{
+		return F::apply(e_(r,c), s_);
+	}
+
+	public: value_type linear(size_type i) const
+	{
+		return F::apply(e_.linear(i), s_);
+	}
+
+
+	private: closure_type e_;
+	private: value_type s_;
+}; // matrix_binary_scalar2
+
+
+/// Binary operation between a scalar and each element (the element being the right operand).
+template <typename E, typename F>
+class matrix_binary_scalar1: public matrix_expression< matrix_binary_scalar1<E,F> >
+{
+	private: typedef typename matrix_closure<E>::type closure_type;
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+	public: typedef typename closure_type::storage_layout storage_layout;
+
+
+	public: matrix_binary_scalar1(value_type s, E const& e)
+	: s_(s),
+	  e_(e)
+	{
+	}
+
+	public: size_type num_rows() const
+	{
+		return e_.num_rows();
+	}
+
+	public: size_type num_columns() const
+	{
+		return e_.num_columns();
+	}
+
+	public: value_type operator()(size_type r, size_type c) const
+	{
+		return F::apply(s_, e_(r,c));
+	}
+
+	public: value_type linear(size_type i) const
+	{
+		return F::apply(s_, e_.linear(i));
+	}
+
+
+	private: value_type s_;
+	private: closure_type e_;
+}; // matrix_binary_scalar1
+
+
+namespace detail {
+
+template <typename F, typename T, typename LayoutT, typename E>
+void matrix_assign(T* data, ::std::size_t /*nr*/, ::std::size_t /*nc*/, LayoutT, E const& x, ::std::size_t n, ::boost::true_type)
+{
+	// Same layout: a flat loop over the storage
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		F::apply(data[i], x.linear(i));
+	}
+}
+
+template <typename F, typename T, typename E>
+void matrix_assign(T* data, ::std::size_t nr, ::std::size_t nc, row_major_storage_layout, E const& x, ::std::size_t /*n*/, ::boost::false_type)
+{
+	for (::std::size_t r = 0; r < nr; ++r)
+	{
+		for (::std::size_t c = 0; c < nc; ++c)
+		{
+			F::apply(data[r*nc+c], x(r,c));
+		}
+	}
+}
+
+template <typename F, typename T, typename E>
+void matrix_assign(T* data, ::std::size_t nr, ::std::size_t nc, column_major_storage_layout, E const& x, ::std::size_t /*n*/, ::boost::false_type)
+{
+	for (::std::size_t c = 0; c < nc; ++c)
+	{
+		for (::std::size_t r = 0; r < nr; ++r)
+		{
+			F::apply(data[c*nr+r], x(r,c));
+		}
+	}
+}
+
+/**
+ * \brief Evaluates the expression \a e into the \a nr x \a nc matrix
+ *  storage \a data with layout \a LayoutT, combining old and new values
+ *  through \a F.
+ */
+template <typename F, typename LayoutT, typename T, typename E>
+void matrix_assign(T* data, ::std::size_t nr, ::std::size_t nc, E const& e)
+{
+	typedef typename matrix_closure<E>::type closure_type;
+
+	const closure_type x(e);
+
+	matrix_assign<F>(data, nr, nc, LayoutT(), x, nr*nc, ::boost::is_same<LayoutT, typename closure_type::storage_layout>());
+}
+
+/// Combines each of the \a n elements pointed by \a data with the scalar \a s through \a F.
+template <typename F, typename T>
+void matrix_assign_scalar(T* data, ::std::size_t n, T s)
+{
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		F::apply(data[i], s);
+	}
+}
+
+template <typename E, typename OpT>
+void matrix_visit(E const& x, OpT& op, ::boost::true_type)
+{
+	// Mixed layout: visit row by row
+	const ::std::size_t nr(x.num_rows());
+	const ::std::size_t nc(x.num_columns());
+	for (::std::size_t r = 0; r < nr; ++r)
+	{
+		for (::std::size_t c = 0; c < nc; ++c)
+		{
+			op(x(r,c));
+		}
+	}
+}
+
+template <typename E, typename OpT>
+void matrix_visit(E const& x, OpT& op, ::boost::false_type)
+{
+	const ::std::size_t n(x.num_rows()*x.num_columns());
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		op(x.linear(i));
+	}
+}
+
+/// Applies \a op to every element of the expression \a e, in storage order.
+template <typename E, typename OpT>
+void matrix_visit(E const& e, OpT& op)
+{
+	typedef typename matrix_closure<E>::type closure_type;
+
+	const closure_type x(e);
+
+	matrix_visit(x, op, ::boost::is_same<typename closure_type::storage_layout, mixed_storage_layout>());
+}
+
+template <typename T>
+struct sum_visitor
+{
+	sum_visitor() : s(0) { }
+	void operator()(T x) { s += x; }
+	T s;
+};
+
+template <typename T>
+struct sum_squares_visitor
+{
+	sum_squares_visitor() : s(0) { }
+	void operator()(T x) { s += x*x; }
+	T s;
+};
+
+template <typename T>
+struct max_visitor
+{
+	max_visitor() : empty(true), m(0) { }
+	void operator()(T x) { if (empty || m < x) { m = x; empty = false; } }
+	bool empty;
+	T m;
+};
+
+template <typename T>
+struct min_visitor
+{
+	min_visitor() : empty(true), m(0) { }
+	void operator()(T x) { if (empty || x < m) { m = x; empty = false; } }
+	bool empty;
+	T m;
+};
+
+} // Namespace detail
+
+
+/// Returns the element-wise sum of two matrix expressions.
+template <typename E1, typename E2>
+matrix_binary< E1, E2, detail::scalar_plus<typename E1::value_type> > operator+(matrix_expression<E1> const& e1, matrix_expression<E2> const& e2)
+{
+	return matrix_binary< E1, E2, detail::scalar_plus<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise difference of two matrix expressions.
+template <typename E1, typename E2>
+matrix_binary< E1, E2, detail::scalar_minus<typename E1::value_type> > operator-(matrix_expression<E1> const& e1, matrix_expression<E2> const& e2)
+{
+	return matrix_binary< E1, E2, detail::scalar_minus<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise product of two matrix expressions.
+template <typename E1, typename E2>
+matrix_binary< E1, E2, detail::scalar_multiplies<typename E1::value_type> > element_prod(matrix_expression<E1> const& e1, matrix_expression<E2> const& e2)
+{
+	return matrix_binary< E1, E2, detail::scalar_multiplies<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise quotient of two matrix expressions.
+template <typename E1, typename E2>
+matrix_binary< E1, E2, detail::scalar_divides<typename E1::value_type> > element_div(matrix_expression<E1> const& e1, matrix_expression<E2> const& e2)
+{
+	return matrix_binary< E1, E2, detail::scalar_divides<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the opposite of a matrix expression.
+template <typename E>
+matrix_unary< E, detail::scalar_negate<typename E::value_type> > operator-(matrix_expression<E> const& e)
+{
+	return matrix_unary< E, detail::scalar_negate<typename E::value_type> >(e());
+}
+
+/// Returns the element-wise absolute value of a matrix expression.
+template <typename E>
+matrix_unary< E, detail::scalar_abs<typename E::value_type> > abs(matrix_expression<E> const& e)
+{
+	return matrix_unary< E, detail::scalar_abs<typename E::value_type> >(e());
+}
+
+/// Returns the product of a matrix expression by a scalar.
+template <typename E>
+matrix_binary_scalar2< E, detail::scalar_multiplies<typename E::value_type> > operator*(matrix_expression<E> const& e, typename E::value_type s)
+{
+	return matrix_binary_scalar2< E, detail::scalar_multiplies<typename E::value_type> >(e(), s);
+}
+
+/// Returns the product of a scalar by a matrix expression.
+template <typename E>
+matrix_binary_scalar1< E, detail::scalar_multiplies<typename E::value_type> > operator*(typename E::value_type s, matrix_expression<E> const& e)
+{
+	return matrix_binary_scalar1< E, detail::scalar_multiplies<typename E::value_type> >(s, e());
+}
+
+/// Returns the quotient of a matrix expression by a scalar.
+template <typename E>
+matrix_binary_scalar2< E, detail::scalar_divides<typename E::value_type> > operator/(matrix_expression<E> const& e, typename E::value_type s)
+{
+	return matrix_binary_scalar2< E, detail::scalar_divides<typename E::value_type> >(e(), s);
+}
+
+
+/// Returns the sum of the elements of a matrix expression.
+template <typename E>
+typename E::value_type sum(matrix_expression<E> const& e)
+{
+	detail::sum_visitor<typename E::value_type> op;
+	detail::matrix_visit(e(), op);
+
+	return op.s;
+}
+
+/// Returns the Frobenius norm (the square root of the sum of squares) of a matrix expression.
+template <typename E>
+typename E::value_type norm_frobenius(matrix_expression<E> const& e)
+{
+	detail::sum_squares_visitor<typename E::value_type> op;
+	detail::matrix_visit(e(), op);
+
+	return ::std::sqrt(op.s);
+}
+
+/// Returns the maximum element of a non-empty matrix expression.
+template <typename E>
+typename E::value_type max(matrix_expression<E> const& e)
+{
+	detail::max_visitor<typename E::value_type> op;
+	detail::matrix_visit(e(), op);
+
+	// pre: e is not empty
+	DCS_ASSERT(!op.empty,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Empty matrix expression"));
+
+	return op.m;
+}
+
+/// Returns the minimum element of a non-empty matrix expression.
+template <typename E>
+typename E::value_type min(matrix_expression<E> const& e)
+{
+	detail::min_visitor<typename E::value_type> op;
+	detail::matrix_visit(e(), op);
+
+	// pre: e is not empty
+	DCS_ASSERT(!op.empty,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Empty matrix expression"));
+
+	return op.m;
+}
+
+}} // Namespace dcs::math
+
+
+#endif // DCS_MATH_TYPE_MATRIX_EXPRESSION_HPP
@@ -0,0 +1,44 @@
+/**
+ * \file dcs/math/type/uninitialized.hpp
+ *
+ * \brief Tag for constructing containers without initializing their elements.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_UNINITIALIZED_HPP
+#define DCS_MATH_TYPE_UNINITIALIZED_HPP
+
+namespace dcs { namespace math {
+
+/**
+ * Tag type telling a container not to initialize its elements.
+ *
+ * Elements of POD type are left with an indeterminate value, while elements
+ * of other types are default-constructed.
+ * Useful when all the elements are going to be overwritten anyway.
+ */
+struct uninitialized_tag { };
+
+/// The (unique) value of the uninitialized_tag type.
+const uninitialized_tag uninitialized = uninitialized_tag();
+
+}} // Namespace dcs::math
+
+#endif // DCS_MATH_TYPE_UNINITIALIZED_HPP
@@ -27,11 +27,21 @@
 
 
 #include <algorithm>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
 #include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/math/type/base_array.hpp>
+#include <dcs/math/type/detail/storage.hpp>
+#include <dcs/math/type/uninitialized.hpp>
+#include <dcs/math/type/vector_expression.hpp>
+#include <dcs/memory/aligned_allocator.hpp>
 #include <dcs/exception.hpp>
+#include <iterator>
 #include <stdexcept>
+#if __cplusplus >= 201103L
+# include <utility>
+#endif // __cplusplus >= 201103L
 
 
 namespace dcs { namespace math {
@@ -40,33 +50,65 @@ namespace dcs { namespace math {
 struct default_vector_properties { };
 
 
-template <typename ValueT, typename PropsT = default_vector_properties>
-class vector: public base_array<ValueT>
+/**
+ * \brief A numerical dense vector.
+ *
+ * Elements are stored contiguously in a block obtained from the given
+ * allocator (by default, aligned to a cache-line boundary).
+ *
+ * The allocated block can be larger than the number of elements (see
+ * \c capacity()), so that resizing to a smaller or equal number of elements
+ * does not reallocate.
+ *
+ * A vector is also a vector expression (see vector_expression), and can be
+ * constructed from and assigned with any vector expression.
+ */
+template <typename ValueT,
+		  typename PropsT = default_vector_properties,
+		  typename AllocT = ::dcs::memory::aligned_allocator<ValueT> >
+class vector: public base_array<ValueT>,
+			  public vector_expression< vector<ValueT,PropsT,AllocT> >
 {
 	public: typedef ValueT value_type;
 	public: typedef PropsT properties_type;
 	public: typedef ::std::size_t size_type;
+	public: typedef AllocT allocator_type;
 
 
 	public: vector()
 	: n_(0),
+	  cap_(0),
+	  alloc_(),
 	  data_(0)
 	{
 	}
 
-	public: explicit vector(::std::size_t n, value_type const& v = value_type/*zero*/())
+	public: explicit vector(::std::size_t n,
+							value_type const& v = value_type/*zero*/(),
+							allocator_type const& alloc = allocator_type())
 	: n_(n),
-	  data_((n > 0) ? new value_type[n] : 0)
+	  cap_(n),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_, v))
 	{
-		if (data_)
-		{
-			::std::fill(data_, data_+n_, v);
-		}
 	}
 
-	public: vector(vector<value_type> const& v)
+	/// Creates a vector without initializing its elements.
+	public: vector(::std::size_t n,
+				   uninitialized_tag,
+				   allocator_type const& alloc = allocator_type())
+	: n_(n),
+	  cap_(n),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_))
+	{
+	}
+
+	public: vector(vector const& v)
 	: n_(v.n_),
-	  data_((n_ > 0) ? new value_type[n_] : 0)
+	  cap_(n_),
+	  alloc_(v.alloc_),
+	  data_(detail::allocate_storage(alloc_, n_))
 	{
 		if (data_)
 		{
@@ -75,9 +117,11 @@ class vector: public base_array<ValueT>
 	}
 
 	public: template <typename IterT>
-			vector(IterT first, IterT last)
+			vector(IterT first, IterT last, typename ::boost::disable_if< ::boost::is_integral<IterT> >::type* = 0)
 	: n_(::std::distance(first, last)),
-	  data_((n_ > 0) ? new value_type[n_] : 0)
+	  cap_(n_),
+	  alloc_(),
+	  data_(detail::allocate_storage(alloc_, n_))
 	{
 		if (data_)
 		{
@@ -85,65 +129,150 @@ class vector: public base_array<ValueT>
 		}
 	}
 
+	/// Creates a vector holding the values of the given expression.
+	public: template <typename E>
+			vector(vector_expression<E> const& e, allocator_type const& alloc = allocator_type())
+	: n_(e().length()),
+	  cap_(n_),
+	  alloc_(alloc),
+	  data_(detail::allocate_storage(alloc_, n_))
+	{
+		detail::vector_assign< detail::scalar_assign<value_type> >(data_, e());
+	}
+
+#if __cplusplus >= 201103L
+	public: vector(vector&& v) noexcept
+	: n_(v.n_),
+	  cap_(v.cap_),
+	  alloc_(::std::move(v.alloc_)),
+	  data_(v.data_)
+	{
+		v.n_ = v.cap_ = 0;
+		v.data_ = 0;
+	}
+#endif // __cplusplus >= 201103L
+
 	public: ~vector()
 	{
-		if (data_)
-		{
-			delete[] data_;
-		}
+		detail::deallocate_storage(alloc_, data_, cap_);
 	}
 
-	public: vector<value_type> operator=(vector<value_type> const& that)
+	public: vector& operator=(vector const& that)
 	{
 		if (this != &that)
 		{
+			// Reuse the current storage whenever it is large enough
+			this->reserve_discard(that.n_);
+			::std::copy(that.begin_data(), that.end_data(), data_);
+
 			n_ = that.n_;
+		}
 
-			if (data_)
-			{
-				delete[] data_;
-			}
-			if (n_ > 0)
-			{
-				data_ = new value_type[n_];
-				::std::copy(that.begin_data(), that.end_data(), data_);
-			}
-			else
-			{
-				data_ = 0;
-			}
+		return *this;
+	}
+
+#if __cplusplus >= 201103L
+	public: vector& operator=(vector&& that) noexcept
+	{
+		if (this != &that)
+		{
+			vector tmp(::std::move(that));
+			this->swap(tmp);
 		}
 
 		return *this;
 	}
+#endif // __cplusplus >= 201103L
+
+	/**
+	 * Assigns the values of the given expression, evaluated in a single loop.
+	 *
+	 * The expression may refer to this vector.
+	 */
+	public: template <typename E>
+			vector& operator=(vector_expression<E> const& e)
+	{
+		// The storage is not reallocated if this vector is an operand of e,
+		// since operands must have the same size of e
+		this->reserve_discard(e().length());
+		n_ = e().length();
+
+		detail::vector_assign< detail::scalar_assign<value_type> >(data_, e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			vector& operator+=(vector_expression<E> const& e)
+	{
+		// pre: length(e) == n_
+		DCS_ASSERT(e().length() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Vector expressions of different size"));
+
+		detail::vector_assign< detail::scalar_plus_assign<value_type> >(data_, e());
+
+		return *this;
+	}
+
+	public: template <typename E>
+			vector& operator-=(vector_expression<E> const& e)
+	{
+		// pre: length(e) == n_
+		DCS_ASSERT(e().length() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Vector expressions of different size"));
+
+		detail::vector_assign< detail::scalar_minus_assign<value_type> >(data_, e());
+
+		return *this;
+	}
+
+	public: vector& operator*=(value_type s)
+	{
+		detail::vector_assign_scalar< detail::scalar_multiplies_assign<value_type> >(data_, n_, s);
+
+		return *this;
+	}
+
+	public: vector& operator/=(value_type s)
+	{
+		detail::vector_assign_scalar< detail::scalar_divides_assign<value_type> >(data_, n_, s);
+
+		return *this;
+	}
+
+	/// Exchanges the content of this vector with the one of the given vector, without copying elements.
+	public: void swap(vector& that)
+	{
+		::std::swap(n_, that.n_);
+		::std::swap(cap_, that.cap_);
+		::std::swap(alloc_, that.alloc_);
+		::std::swap(data_, that.data_);
+	}
+
+	public: allocator_type get_allocator() const
+	{
+		return alloc_;
+	}
 
 	public: value_type& operator()(size_type i)
 	{
-		// pre: data_ != null
-		DCS_ASSERT(data_,
-				   DCS_EXCEPTION_THROW(::std::logic_error,
-									   "Zero-length vector"));
 		// pre: i < n_
 		DCS_ASSERT(i < n_,
 				   DCS_EXCEPTION_THROW(::std::logic_error,
 									   "Index out-of-bound"));
 
-		// Retrieve value in column-major order
 		return data_[i];
 	}
 
 	public: value_type const& operator()(size_type i) const
 	{
-		// pre: data_ != null
-		DCS_ASSERT(data_,
-				   DCS_EXCEPTION_THROW(::std::logic_error,
-									   "Zero-length vector"));
 		// pre: i < n_
 		DCS_ASSERT(i < n_,
 				   DCS_EXCEPTION_THROW(::std::logic_error,
 									   "Index out-of-bound"));
 
-		// Retrieve value in column-major order
 		return data_[i];
 	}
 
@@ -172,53 +301,70 @@ class vector: public base_array<ValueT>
 		return n_;
 	}
 
+	/// Returns the number of elements the allocated storage can hold.
+	public: size_type capacity() const
+	{
+		return cap_;
+	}
+
+	/**
+	 * Resizes the vector.
+	 *
+	 * When \a preserve is \c true, the first elements are preserved and the
+	 * new ones (if any) are set to zero.
+	 * Otherwise, all elements are set to zero.
+	 * The current storage is reused whenever it is large enough.
+	 */
 	public: void resize(size_type n, bool preserve = true)
 	{
 		if (!preserve || !n_ || !n)
 		{
-			if (data_)
-			{
-				delete[] data_;
-			}
-			if (n > 0)
-			{
-				data_ = new value_type[n];
+			this->reserve_discard(n);
 
-				::std::fill(data_, data_+n, value_type/*zero*/());
-			}
-			else
-			{
-				data_ = 0;
-			}
+			::std::fill(data_, data_+n, value_type/*zero*/());
 		}
 		else
 		{
-			const size_type mn(::std::min(n_, n));
-
-			value_type* tmp_data = new value_type[mn];
-
-			// Back-up old data
-			::std::copy(data_, data_+mn, tmp_data);
-
-			delete[] data_;
-
-			data_ = new value_type[n];
-
-			// Restore old data
-			::std::copy(tmp_data, tmp_data+mn, data_);
+			this->reserve(n);
 
 			// If the new dimension is bigger than the older one, fill the gap with zeros
 			if (n > n_)
 			{
 				::std::fill(data_+n_, data_+n, value_type/*zero*/());
 			}
-
-			delete[] tmp_data;
 		}
 
 		n_ = n;
 	}
 
+	/**
+	 * Resizes the vector without preserving nor initializing its elements.
+	 *
+	 * The current storage is reused whenever it is large enough.
+	 */
+	public: void resize(size_type n, uninitialized_tag)
+	{
+		this->reserve_discard(n);
+
+		n_ = n;
+	}
+
+	/// Makes the allocated storage large enough for \a n elements, preserving current elements.
+	public: void reserve(size_type n)
+	{
+		if (n > cap_)
+		{
+			value_type* tmp_data = detail::allocate_storage(alloc_, n);
+
+			::std::copy(data_, data_+n_, tmp_data);
+
+			detail::deallocate_storage(alloc_, data_, cap_);
+
+			data_ = tmp_data;
+			cap_ = n;
+		}
+	}
+
 	public: bool empty() const
 	{
 		return n_ == 0;
@@ -244,11 +390,41 @@ class vector: public base_array<ValueT>
 		return data_+n_;
 	}
 
+	/// Makes the allocated storage large enough for \a n elements, without preserving current elements.
+	private: void reserve_discard(size_type n)
+	{
+		if (n > cap_)
+		{
+			value_type* tmp_data = detail::allocate_storage(alloc_, n);
+
+			detail::deallocate_storage(alloc_, data_, cap_);
+
+			data_ = tmp_data;
+			cap_ = n;
+		}
+	}
+
 
 	private: ::std::size_t n_; ///< Number of elements
+	private: ::std::size_t cap_; ///< Number of elements of the allocated storage
+	private: allocator_type alloc_; ///< The storage allocator
 	private: value_type* data_; ///< The raw storage
 }; // vector
 
+/// Vectors are held in expressions through a vector_reference.
+template <typename ValueT, typename PropsT, typename AllocT>
+struct vector_closure< vector<ValueT,PropsT,AllocT> >
+{
+	typedef vector_reference<ValueT> type;
+};
+
+template <typename ValueT, typename PropsT, typename AllocT>
+inline
+void swap(vector<ValueT,PropsT,AllocT>& a, vector<ValueT,PropsT,AllocT>& b)
+{
+	a.swap(b);
+}
+
 }} // Namespace dcs::math
 
 #endif // DCS_MATH_TYPE_VECTOR_HPP
@@ -0,0 +1,497 @@
+/**
+ * \file dcs/math/type/vector_expression.hpp
+ *
+ * \brief Lazy element-wise expressions over numerical dense vectors.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MATH_TYPE_VECTOR_EXPRESSION_HPP
+#define DCS_MATH_TYPE_VECTOR_EXPRESSION_HPP
+
+
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/type/detail/expression_functor.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace math {
+
+/**
+ * \brief Base class of all vector expressions (Curiously Recurring Template
+ *  Pattern).
+ *
+ * A vector expression \c E provides:
+ * - \c value_type and \c size_type,
+ * - \c length(), the number of elements,
+ * - \c operator()(i), the value of the i-th element.
+ * .
+ *
+ * Expressions are lazy: building \c a+2*b only records the operands, while
+ * the values are computed, element by element and in a single loop, when the
+ * expression is assigned to a vector or reduced to a scalar.
+ * Hence, no intermediate vector is ever allocated.
+ */
+template <typename E>
+struct vector_expression
+{
+	typedef E expression_type;
+
+	/// Returns the actual expression.
+	E const& operator()() const
+	{
+		return *static_cast<E const*>(this);
+	}
+}; // vector_expression
+
+
+/**
+ * \brief Lightweight view of the elements of a dense vector.
+ *
+ * Operands of expressions that are vectors are held through this class, so
+ * that elements are read directly from the storage (without bound checks),
+ * which lets the compiler vectorize the evaluation loops.
+ */
+template <typename T>
+class vector_reference: public vector_expression< vector_reference<T> >
+{
+	public: typedef T value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: template <typename VectorT>
+			explicit vector_reference(VectorT const& v)
+	: data_(v.begin_data()),
+	  n_(v.length())
+	{
+	}
+
+	public: size_type length() const
+	{
+		return n_;
+	}
+
+	public: value_type const& operator()(size_type i) const
+	{
+		return data_[i];
+	}
+
+
+	private: value_type const* data_;
+	private: size_type n_;
+}; // vector_reference
+
+
+/**
+ * \brief The type used to hold an operand of type \a E in an expression.
+ *
+ * Expressions are held by value (they only store references to their own
+ * operands); containers specialize this class to be held through a
+ * vector_reference.
+ */
+template <typename E>
+struct vector_closure
+{
+	typedef E type;
+};
+
+
+/// Element-wise application of a unary operation.
+template <typename E, typename F>
+class vector_unary: public vector_expression< vector_unary<E,F> >
+{
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: explicit vector_unary(E const& e)
+	: e_(e)
+	{
+	}
+
+	public: size_type length() const
+	{
+		return e_.length();
+	}
+
+	public: value_type operator()(size_type i) const
+	{
+		return F::apply(e_(i));
+	}
+
+
+	private: typename vector_closure<E>::type e_;
+}; // vector_unary
+
+
+/// Element-wise application of a binary operation.
+template <typename E1, typename E2, typename F>
+class vector_binary: public vector_expression< vector_binary<E1,E2,F> >
+{
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: vector_binary(E1 const& e1, E2 const& e2)
+	: e1_(e1),
+	  e2_(e2)
+	{
+		// pre: length(e1) == length(e2)
+		DCS_ASSERT(e1_.length() == e2_.length(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Vector expressions of different size"));
+	}
+
+	public: size_type length() const
+	{
+		return e1_.length();
+	}
+
+	public: value_type operator()(size_type i) const
+	{
+		return F::apply(e1_(i), e2_(i));
+	}
+
+
+	private: typename vector_closure<E1>::type e1_;
+	private: typename vector_closure<E2>::type e2_;
+}; // vector_binary
+
+
+/// Binary operation between each element and a scalar (the element being the left operand).
+template <typename E, typename F>
+class vector_binary_scalar2: public vector_expression< vector_binary_scalar2<E,F> >
+{
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: vector_binary_scalar2(E const& e, value_type s)
+	: e_(e),
+	  s_(s)
+	{
+	}
+
+	public: size_type length() const
+	{
+		return e_.length();
+	}
+
+	public: value_type operator()(size_type i) const
+	{
+		return F::apply(e_(i), s_);
+	}
+
+
+	private: typename vector_closure<E>::type e_;
+	private: value_type s_;
+}; // vector_binary_scalar2
+
+
+/// Binary operation between a scalar and each element (the element being the right operand).
+template <typename E, typename F>
+class vector_binary_scalar1: public vector_expression< vector_binary_scalar1<E,F> >
+{
+	public: typedef typename F::result_type value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: vector_binary_scalar1(value_type s, E const& e)
+	: s_(s),
+	  e_(e)
+	{
+	}
+
+	public: size_type length() const
+	{
+		return e_.length();
+	}
+
+	public: value_type operator()(size_type i) const
+	{
+		return F::apply(s_, e_(i));
+	}
+
+
+	private: value_type s_;
+	private: typename vector_closure<E>::type e_;
+}; // vector_binary_scalar1
+
+
+/**
+ * \brief Cumulative sum of the elements of an expression.
+ *
+ * The i-th element is the sum of the first i+1 elements of the operand.
+ * Since expressions are evaluated in increasing order of position, the last
+ * computed partial sum is cached, so that a complete evaluation takes linear
+ * time; accessing elements out of order is still correct, but restarts the
+ * sum from the first element.
+ */
+template <typename E>
+class vector_cumsum: public vector_expression< vector_cumsum<E> >
+{
+	public: typedef typename E::value_type value_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: explicit vector_cumsum(E const& e)
+	: e_(e),
+	  next_(0),
+	  s_(0)
+	{
+	}
+
+	public: size_type length() const
+	{
+		return e_.length();
+	}
+
+	public: value_type operator()(size_type i) const
+	{
+		if (i < next_)
+		{
+			next_ = 0;
+			s_ = value_type(0);
+		}
+		for (; next_ <= i; ++next_)
+		{
+			s_ += e_(next_);
+		}
+
+		return s_;
+	}
+
+
+	private: typename vector_closure<E>::type e_;
+	private: mutable size_type next_; ///< The position of the next element to add to the partial sum
+	private: mutable value_type s_; ///< The partial sum up to position next_-1
+}; // vector_cumsum
+
+
+namespace detail {
+
+/// Evaluates the expression \a e into the elements pointed by \a data, combining old and new values through \a F.
+template <typename F, typename T, typename E>
+void vector_assign(T* data, E const& e)
+{
+	const typename vector_closure<E>::type x(e);
+	const ::std::size_t n(x.length());
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		F::apply(data[i], x(i));
+	}
+}
+
+/// Combines each of the \a n elements pointed by \a data with the scalar \a s through \a F.
+template <typename F, typename T>
+void vector_assign_scalar(T* data, ::std::size_t n, T s)
+{
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		F::apply(data[i], s);
+	}
+}
+
+} // Namespace detail
+
+
+/// Returns the element-wise sum of two vector expressions.
+template <typename E1, typename E2>
+vector_binary< E1, E2, detail::scalar_plus<typename E1::value_type> > operator+(vector_expression<E1> const& e1, vector_expression<E2> const& e2)
+{
+	return vector_binary< E1, E2, detail::scalar_plus<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise difference of two vector expressions.
+template <typename E1, typename E2>
+vector_binary< E1, E2, detail::scalar_minus<typename E1::value_type> > operator-(vector_expression<E1> const& e1, vector_expression<E2> const& e2)
+{
+	return vector_binary< E1, E2, detail::scalar_minus<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise product of two vector expressions.
+template <typename E1, typename E2>
+vector_binary< E1, E2, detail::scalar_multiplies<typename E1::value_type> > element_prod(vector_expression<E1> const& e1, vector_expression<E2> const& e2)
+{
+	return vector_binary< E1, E2, detail::scalar_multiplies<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the element-wise quotient of two vector expressions.
+template <typename E1, typename E2>
+vector_binary< E1, E2, detail::scalar_divides<typename E1::value_type> > element_div(vector_expression<E1> const& e1, vector_expression<E2> const& e2)
+{
+	return vector_binary< E1, E2, detail::scalar_divides<typename E1::value_type> >(e1(), e2());
+}
+
+/// Returns the opposite of a vector expression.
+template <typename E>
+vector_unary< E, detail::scalar_negate<typename E::value_type> > operator-(vector_expression<E> const& e)
+{
+	return vector_unary< E, detail::scalar_negate<typename E::value_type> >(e());
+}
+
+/// Returns the element-wise absolute value of a vector expression.
+template <typename E>
+vector_unary< E, detail::scalar_abs<typename E::value_type> > abs(vector_expression<E> const& e)
+{
+	return vector_unary< E, detail::scalar_abs<typename E::value_type> >(e());
+}
+
+/// Returns the product of a vector expression by a scalar.
+template <typename E>
+vector_binary_scalar2< E, detail::scalar_multiplies<typename E::value_type> > operator*(vector_expression<E> const& e, typename E::value_type s)
+{
+	return vector_binary_scalar2< E, detail::scalar_multiplies<typename E::value_type> >(e(), s);
+}
+
+/// Returns the product of a scalar by a vector expression.
+template <typename E>
+vector_binary_scalar1< E, detail::scalar_multiplies<typename E::value_type> > operator*(typename E::value_type s, vector_expression<E> const& e)
+{
+	return vector_binary_scalar1< E, detail::scalar_multiplies<typename E::value_type> >(s, e());
+}
+
+/// Returns the quotient of a vector expression by a scalar.
+template <typename E>
+vector_binary_scalar2< E, detail::scalar_divides<typename E::value_type> > operator/(vector_expression<E> const& e, typename E::value_type s)
+{
+	return vector_binary_scalar2< E, detail::scalar_divides<typename E::value_type> >(e(), s);
+}
+
+/// Returns the cumulative sum of a vector expression.
+template <typename E>
+vector_cumsum<E> cumsum(vector_expression<E> const& e)
+{
+	return vector_cumsum<E>(e());
+}
+
+
+/// Returns the sum of the elements of a vector expression.
+template <typename E>
+typename E::value_type sum(vector_expression<E> const& e)
+{
+	typedef typename E::value_type value_type;
+
+	const typename vector_closure<E>::type x(e());
+	const ::std::size_t n(x.length());
+
+	value_type s(0);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		s += x(i);
+	}
+
+	return s;
+}
+
+/// Returns the 1-norm (the sum of absolute values) of a vector expression.
+template <typename E>
+typename E::value_type norm_1(vector_expression<E> const& e)
+{
+	return sum(abs(e));
+}
+
+/// Returns the 2-norm (the Euclidean norm) of a vector expression.
+template <typename E>
+typename E::value_type norm_2(vector_expression<E> const& e)
+{
+	typedef typename E::value_type value_type;
+
+	const typename vector_closure<E>::type x(e());
+	const ::std::size_t n(x.length());
+
+	value_type s(0);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		const value_type xi(x(i));
+		s += xi*xi;
+	}
+
+	return ::std::sqrt(s);
+}
+
+/// Returns the maximum element of a non-empty vector expression.
+template <typename E>
+typename E::value_type max(vector_expression<E> const& e)
+{
+	typedef typename E::value_type value_type;
+
+	const typename vector_closure<E>::type x(e());
+	const ::std::size_t n(x.length());
+
+	// pre: n > 0
+	DCS_ASSERT(n > 0,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Empty vector expression"));
+
+	value_type m(x(0));
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		const value_type xi(x(i));
+		if (m < xi)
+		{
+			m = xi;
+		}
+	}
+
+	return m;
+}
+
+/// Returns the minimum element of a non-empty vector expression.
+template <typename E>
+typename E::value_type min(vector_expression<E> const& e)
+{
+	typedef typename E::value_type value_type;
+
+	const typename vector_closure<E>::type x(e());
+	const ::std::size_t n(x.length());
+
+	// pre: n > 0
+	DCS_ASSERT(n > 0,
+			   DCS_EXCEPTION_THROW(::std::invalid_argument,
+								   "Empty vector expression"));
+
+	value_type m(x(0));
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		const value_type xi(x(i));
+		if (xi < m)
+		{
+			m = xi;
+		}
+	}
+
+	return m;
+}
+
+/// Returns the infinity norm (the maximum absolute value) of a vector expression.
+template <typename E>
+typename E::value_type norm_inf(vector_expression<E> const& e)
+{
+	return max(abs(e));
+}
+
+}} // Namespace dcs::math
+
+
+#endif // DCS_MATH_TYPE_VECTOR_EXPRESSION_HPP
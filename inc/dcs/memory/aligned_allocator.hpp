@@ -0,0 +1,163 @@
+/**
+ * \file dcs/memory/aligned_allocator.hpp
+ *
+ * \brief Standard-conforming allocator returning over-aligned storage.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2013 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_MEMORY_ALIGNED_ALLOCATOR_HPP
+#define DCS_MEMORY_ALIGNED_ALLOCATOR_HPP
+
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+
+namespace dcs { namespace memory {
+
+/// The default alignment (in bytes), which matches the cache-line size of most CPUs.
+static const ::std::size_t default_alignment = 64;
+
+/**
+ * \brief Allocator whose storage is aligned to a given boundary.
+ *
+ * Aligned storage lets vectorized code use aligned loads/stores and prevents
+ * a block of data to start in the middle of a cache line.
+ *
+ * The storage is obtained from \c std::malloc, over-allocating enough room
+ * to align the returned address and to store the original address just
+ * before it.
+ *
+ * \tparam T The type of the allocated objects.
+ * \tparam Alignment The alignment (in bytes) of allocated storage; it must
+ *  be a power of two, not smaller than the size of a pointer.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename T, ::std::size_t Alignment = default_alignment>
+class aligned_allocator
+{
+	BOOST_STATIC_ASSERT( (Alignment & (Alignment-1)) == 0 );
+	BOOST_STATIC_ASSERT( Alignment >= sizeof(void*) );
+
+	public: typedef T value_type;
+	public: typedef T* pointer;
+	public: typedef T const* const_pointer;
+	public: typedef T& reference;
+	public: typedef T const& const_reference;
+	public: typedef ::std::size_t size_type;
+	public: typedef ::std::ptrdiff_t difference_type;
+	public: template <typename U>
+			struct rebind
+	{
+		typedef aligned_allocator<U,Alignment> other;
+	};
+	public: static const ::std::size_t alignment = Alignment;
+
+
+	public: aligned_allocator()
+	{
+	}
+
+	public: template <typename U>
+			aligned_allocator(aligned_allocator<U,Alignment> const&)
+	{
+	}
+
+	public: pointer address(reference x) const
+	{
+		return &x;
+	}
+
+	public: const_pointer address(const_reference x) const
+	{
+		return &x;
+	}
+
+	public: pointer allocate(size_type n, void const* /*hint*/ = 0)
+	{
+		if (n > this->max_size())
+		{
+			throw ::std::bad_alloc();
+		}
+
+		void* raw = ::std::malloc(n*sizeof(T)+Alignment-1+sizeof(void*));
+		if (!raw)
+		{
+			throw ::std::bad_alloc();
+		}
+
+		const ::boost::uintptr_t addr((reinterpret_cast< ::boost::uintptr_t >(raw)+sizeof(void*)+Alignment-1) & ~static_cast< ::boost::uintptr_t >(Alignment-1));
+
+		// Remember where the raw block starts
+		reinterpret_cast<void**>(addr)[-1] = raw;
+
+		return reinterpret_cast<pointer>(addr);
+	}
+
+	public: void deallocate(pointer p, size_type /*n*/)
+	{
+		if (p)
+		{
+			::std::free(reinterpret_cast<void**>(p)[-1]);
+		}
+	}
+
+	public: size_type max_size() const
+	{
+		return (::std::numeric_limits<size_type>::max()-Alignment-sizeof(void*))/sizeof(T);
+	}
+
+	public: void construct(pointer p, const_reference v)
+	{
+		::new (static_cast<void*>(p)) T(v);
+	}
+
+	public: void destroy(pointer p)
+	{
+		p->~T();
+	}
+}; // aligned_allocator
+
+template <typename T, ::std::size_t Alignment>
+const ::std::size_t aligned_allocator<T,Alignment>::alignment;
+
+template <typename T, typename U, ::std::size_t Alignment>
+inline
+bool operator==(aligned_allocator<T,Alignment> const&, aligned_allocator<U,Alignment> const&)
+{
+	return true;
+}
+
+template <typename T, typename U, ::std::size_t Alignment>
+inline
+bool operator!=(aligned_allocator<T,Alignment> const&, aligned_allocator<U,Alignment> const&)
+{
+	return false;
+}
+
+}} // Namespace dcs::memory
+
+
+#endif // DCS_MEMORY_ALIGNED_ALLOCATOR_HPP
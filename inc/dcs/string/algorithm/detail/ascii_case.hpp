@@ -0,0 +1,73 @@
+/**
+ * \file dcs/string/algorithm/detail/ascii_case.hpp
+ *
+ * \brief Case conversion of ASCII letters.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2009 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DCS_STRING_ALGORITHM_DETAIL_ASCII_CASE_HPP
+#define DCS_STRING_ALGORITHM_DETAIL_ASCII_CASE_HPP
+
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif // __SSE2__
+
+
+namespace dcs { namespace string { namespace detail {
+
+/**
+ * Flips the case of the characters of [first,last) in the range of letters
+ * starting at \a a (either 'A' or 'a'), in place.
+ *
+ * Other characters (including non-ASCII bytes of UTF-8 text) are left as
+ * they are.
+ */
+inline void ascii_flip_case(char* first, char* last, char a)
+{
+#ifdef __SSE2__
+	// Shift the letters to the bottom of the signed range, so that a single
+	// signed comparison tells them apart
+	const __m128i shift(_mm_set1_epi8(static_cast<char>(0x80-a)));
+	const __m128i limit(_mm_set1_epi8(static_cast<char>(0x80+26)));
+	const __m128i flip(_mm_set1_epi8(0x20));
+	while ((last-first) >= 16)
+	{
+		const __m128i x(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first)));
+		const __m128i letters(_mm_cmplt_epi8(_mm_add_epi8(x, shift), limit));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(first), _mm_xor_si128(x, _mm_and_si128(letters, flip)));
+		first += 16;
+	}
+#endif // __SSE2__
+
+	for (; first != last; ++first)
+	{
+		if (static_cast<unsigned char>(*first-a) < 26)
+		{
+			*first ^= 0x20;
+		}
+	}
+}
+
+}}} // Namespace dcs::string::detail
+
+
+#endif // DCS_STRING_ALGORITHM_DETAIL_ASCII_CASE_HPP
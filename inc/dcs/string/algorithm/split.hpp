@@ -27,19 +27,33 @@
 
 
 #include <boost/algorithm/string/split.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
 #include <dcs/macro.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #ifndef DCS_MACRO_CXX11
 # include <functional> // for std::bind1st() and std::equalt_to()
 #endif // DCS_MACRO_CXX11
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif // __SSE2__
 
 
 namespace dcs { namespace string {
 
 using ::boost::algorithm::split;
+using ::boost::algorithm::token_compress_mode_type;
+using ::boost::algorithm::token_compress_on;
+using ::boost::algorithm::token_compress_off;
 
 // Alternative split function (with a different prototype)
-std::vector<std::string> split(const std::string& s, char delimiter = ' ')
+inline std::vector<std::string> split(const std::string& s, char delimiter = ' ')
 {
 	std::vector<std::string> tokens;
 
@@ -60,6 +74,450 @@ std::vector<std::string> split(const std::string& s, char delimiter = ' ')
 #endif // DCS_MACRO_CXX11
 }
 
+
+namespace detail {
+
+/// Returns the first occurrence of the \a n > 1 characters at \a d in
+/// [first,last), or \a last if there is none.
+inline char const* split_find_string(char const* first, char const* last, char const* d, ::std::size_t n)
+{
+	if (static_cast< ::std::size_t >(last-first) < n)
+	{
+		return last;
+	}
+
+#ifdef __SSE2__
+	// Compare the first and the last character of the delimiter at 16
+	// positions at once, and only check the middle ones at the candidate
+	// positions (see W. Mula, "SIMD-friendly algorithms for substring
+	// searching", 2016)
+	const __m128i first16(_mm_set1_epi8(d[0]));
+	const __m128i last16(_mm_set1_epi8(d[n-1]));
+	while (static_cast< ::std::size_t >(last-first) >= n+15)
+	{
+		const __m128i x0(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first)));
+		const __m128i x1(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first+n-1)));
+		unsigned int m(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(x0, first16), _mm_cmpeq_epi8(x1, last16))));
+		while (m)
+		{
+			const unsigned int i(__builtin_ctz(m));
+			if (::std::memcmp(first+i+1, d+1, n-2) == 0)
+			{
+				return first+i;
+			}
+			m &= m-1;
+		}
+		first += 16;
+	}
+#endif // __SSE2__
+
+	for (char const* stop = last-n; first <= stop; ++first)
+	{
+		if (*first == d[0] && ::std::memcmp(first+1, d+1, n-1) == 0)
+		{
+			return first;
+		}
+	}
+
+	return last;
+}
+
+/**
+ * Returns the first character of [first,last) among the \a n characters at
+ * \a chars (whose membership table is \a table), or \a last if there is
+ * none.
+ */
+inline char const* split_find_any(char const* first, char const* last, char const* chars, ::std::size_t n, unsigned char const* table)
+{
+#ifdef __SSE2__
+	// Tokens are often short: look at the first characters with the table,
+	// before paying for setting up the vectorized loop
+	for (char const* stop = first+((last-first) < 16 ? (last-first) : 16); first != stop; ++first)
+	{
+		if (table[static_cast<unsigned char>(*first)])
+		{
+			return first;
+		}
+	}
+
+	// Up to 16 characters, compare each of them at 16 positions at once
+	if (n <= 16)
+	{
+		__m128i set[16];
+		for (::std::size_t k = 0; k < n; ++k)
+		{
+			set[k] = _mm_set1_epi8(chars[k]);
+		}
+		while ((last-first) >= 16)
+		{
+			const __m128i x(_mm_loadu_si128(reinterpret_cast<__m128i const*>(first)));
+			__m128i eq(_mm_setzero_si128());
+			for (::std::size_t k = 0; k < n; ++k)
+			{
+				eq = _mm_or_si128(eq, _mm_cmpeq_epi8(x, set[k]));
+			}
+			const unsigned int m(_mm_movemask_epi8(eq));
+			if (m)
+			{
+				return first+__builtin_ctz(m);
+			}
+			first += 16;
+		}
+	}
+#else // __SSE2__
+	(void) chars;
+	(void) n;
+#endif // __SSE2__
+
+	while (first != last && !table[static_cast<unsigned char>(*first)])
+	{
+		++first;
+	}
+
+	return first;
+}
+
+inline void split_assign(::std::string& token, ::boost::string_ref s)
+{
+	token.assign(s.data(), s.size());
+}
+
+inline void split_assign(::boost::string_ref& token, ::boost::string_ref s)
+{
+	token = s;
+}
+
+template <typename T>
+inline void split_assign(T& token, ::boost::string_ref s)
+{
+	token = T(s.begin(), s.end());
+}
+
+} // Namespace detail
+
+
+/**
+ * A delimiter made of a single character.
+ *
+ * Delimiters provide:
+ * - <code>find(first, last)</code>, which returns the position of the first
+ *   delimiter in [first,last), or \c last if there is none;
+ * - <code>match(first, last)</code>, which tells if [first,last) starts with
+ *   a delimiter;
+ * - <code>size()</code>, which returns the length of the delimiter.
+ */
+class char_delimiter
+{
+	public: explicit char_delimiter(char c)
+	: c_(c)
+	{
+	}
+
+	public: char const* find(char const* first, char const* last) const
+	{
+		if (first == last)
+		{
+			return last;
+		}
+
+		char const* p(static_cast<char const*>(::std::memchr(first, c_, last-first)));
+
+		return p ? p : last;
+	}
+
+	public: bool match(char const* first, char const* last) const
+	{
+		return first != last && *first == c_;
+	}
+
+	public: ::std::size_t size() const
+	{
+		return 1;
+	}
+
+
+	private: char c_;
+}; // char_delimiter
+
+
+/**
+ * A delimiter made of a (non-empty) sequence of characters, such as ", " or
+ * "\r\n".
+ *
+ * The characters must outlive the delimiter.
+ */
+class string_delimiter
+{
+	public: explicit string_delimiter(::boost::string_ref d)
+	: d_(d)
+	{
+		// pre: !d.empty()
+		DCS_ASSERT(!d_.empty(),
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Empty delimiter"));
+	}
+
+	public: char const* find(char const* first, char const* last) const
+	{
+		if (d_.size() == 1 && first != last)
+		{
+			char const* p(static_cast<char const*>(::std::memchr(first, d_[0], last-first)));
+
+			return p ? p : last;
+		}
+
+		return detail::split_find_string(first, last, d_.data(), d_.size());
+	}
+
+	public: bool match(char const* first, char const* last) const
+	{
+		return static_cast< ::std::size_t >(last-first) >= d_.size()
+			   && ::std::memcmp(first, d_.data(), d_.size()) == 0;
+	}
+
+	public: ::std::size_t size() const
+	{
+		return d_.size();
+	}
+
+
+	private: ::boost::string_ref d_;
+}; // string_delimiter
+
+
+/**
+ * A delimiter made of any single character of a class, such as the
+ * whitespace class " \t".
+ *
+ * The characters must outlive the delimiter.
+ */
+class char_class_delimiter
+{
+	public: explicit char_class_delimiter(::boost::string_ref chars)
+	: chars_(chars)
+	{
+		::std::memset(table_, 0, sizeof(table_));
+		for (::std::size_t i = 0; i < chars_.size(); ++i)
+		{
+			table_[static_cast<unsigned char>(chars_[i])] = 1;
+		}
+	}
+
+	public: char const* find(char const* first, char const* last) const
+	{
+		return detail::split_find_any(first, last, chars_.data(), chars_.size(), table_);
+	}
+
+	public: bool match(char const* first, char const* last) const
+	{
+		return first != last && table_[static_cast<unsigned char>(*first)];
+	}
+
+	public: ::std::size_t size() const
+	{
+		return 1;
+	}
+
+
+	private: ::boost::string_ref chars_;
+	private: unsigned char table_[256];
+}; // char_class_delimiter
+
+
+/**
+ * A lazy view of the tokens of a string separated by a delimiter (see
+ * char_delimiter, string_delimiter and char_class_delimiter).
+ *
+ * Tokens are views of the string, which must outlive the view, and are
+ * located as the view is iterated.
+ * Tokens are the same as those of <code>boost::algorithm::split()</code>:
+ * adjacent delimiters give empty tokens, unless compressed with
+ * \c token_compress_on, and the empty string has a single empty token.
+ * Iterators refer to the delimiter of the view, and thus must not outlive
+ * it.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename DelimiterT>
+class split_view
+{
+	public: typedef DelimiterT delimiter_type;
+	public: typedef ::boost::string_ref string_ref_type;
+
+	public: class const_iterator
+	{
+		public: typedef ::std::forward_iterator_tag iterator_category;
+		public: typedef string_ref_type value_type;
+		public: typedef ::std::ptrdiff_t difference_type;
+		public: typedef string_ref_type const* pointer;
+		public: typedef string_ref_type const& reference;
+
+
+		public: const_iterator()
+		: next_(0),
+		  last_(0),
+		  delim_(0),
+		  compress_(false),
+		  done_(true)
+		{
+		}
+
+		public: const_iterator(char const* first, char const* last, delimiter_type const& delim, bool compress)
+		: next_(first),
+		  last_(last),
+		  delim_(&delim),
+		  compress_(compress),
+		  done_(false)
+		{
+			this->advance();
+		}
+
+		public: reference operator*() const
+		{
+			return tok_;
+		}
+
+		public: pointer operator->() const
+		{
+			return &tok_;
+		}
+
+		public: const_iterator& operator++()
+		{
+			this->advance();
+			return *this;
+		}
+
+		public: const_iterator operator++(int)
+		{
+			const_iterator tmp(*this);
+			this->advance();
+			return tmp;
+		}
+
+		public: friend bool operator==(const_iterator const& a, const_iterator const& b)
+		{
+			return a.done_ == b.done_ && (a.done_ || a.tok_.data() == b.tok_.data());
+		}
+
+		public: friend bool operator!=(const_iterator const& a, const_iterator const& b)
+		{
+			return !(a == b);
+		}
+
+		private: void advance()
+		{
+			if (!next_)
+			{
+				// The previous token was the last one
+				done_ = true;
+				tok_ = string_ref_type();
+				return;
+			}
+
+			char const* d(delim_->find(next_, last_));
+			tok_ = string_ref_type(next_, d-next_);
+			if (d == last_)
+			{
+				next_ = 0;
+			}
+			else
+			{
+				next_ = d+delim_->size();
+				if (compress_)
+				{
+					while (delim_->match(next_, last_))
+					{
+						next_ += delim_->size();
+					}
+				}
+			}
+		}
+
+
+		private: string_ref_type tok_;
+		private: char const* next_; ///< The beginning of the next token, or null if tok_ is the last one
+		private: char const* last_;
+		private: delimiter_type const* delim_;
+		private: bool compress_;
+		private: bool done_;
+	}; // const_iterator
+
+
+	public: split_view(string_ref_type s, delimiter_type const& delim, token_compress_mode_type compress = token_compress_off)
+	: s_(s),
+	  delim_(delim),
+	  compress_(compress == token_compress_on)
+	{
+	}
+
+	public: const_iterator begin() const
+	{
+		return const_iterator(s_.data(), s_.data()+s_.size(), delim_, compress_);
+	}
+
+	public: const_iterator end() const
+	{
+		return const_iterator();
+	}
+
+
+	private: string_ref_type s_;
+	private: delimiter_type delim_;
+	private: bool compress_;
+}; // split_view
+
+
+template <typename DelimiterT>
+inline split_view<DelimiterT> make_split_view(::boost::string_ref s, DelimiterT const& delim, token_compress_mode_type compress = token_compress_off)
+{
+	return split_view<DelimiterT>(s, delim, compress);
+}
+
+inline split_view<char_delimiter> make_split_view(::boost::string_ref s, char delim, token_compress_mode_type compress = token_compress_off)
+{
+	return split_view<char_delimiter>(s, char_delimiter(delim), compress);
+}
+
+
+/**
+ * Splits \a s into \a tokens, replacing their previous content.
+ *
+ * \a tokens is a random-access container of \c boost::string_ref (which
+ * views \a s), \c std::string or any type constructible from a pair of
+ * character iterators.
+ * Its elements are assigned in place, so that a container reused across
+ * calls only allocates memory when it (or one of its strings) grows.
+ * Returns the number of tokens.
+ */
+template <typename ContainerT, typename DelimiterT>
+::std::size_t split_into(ContainerT& tokens, ::boost::string_ref s, DelimiterT const& delim, token_compress_mode_type compress = token_compress_off)
+{
+	typedef typename split_view<DelimiterT>::const_iterator iterator;
+
+	const split_view<DelimiterT> view(s, delim, compress);
+	::std::size_t n(0);
+	const iterator end_it(view.end());
+	for (iterator it = view.begin(); it != end_it; ++it)
+	{
+		if (n == tokens.size())
+		{
+			tokens.push_back(typename ContainerT::value_type());
+		}
+		detail::split_assign(tokens[n], *it);
+		++n;
+	}
+	tokens.resize(n);
+
+	return n;
+}
+
+template <typename ContainerT>
+::std::size_t split_into(ContainerT& tokens, ::boost::string_ref s, char delim, token_compress_mode_type compress = token_compress_off)
+{
+	return split_into(tokens, s, char_delimiter(delim), compress);
+}
+
 }} // Namespace dcs::string
 
 
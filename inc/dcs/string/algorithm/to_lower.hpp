@@ -27,6 +27,9 @@
 
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <dcs/string/algorithm/detail/ascii_case.hpp>
+#include <string>
 
 
 namespace dcs { namespace string {
@@ -34,6 +37,33 @@ namespace dcs { namespace string {
 using ::boost::algorithm::to_lower;
 using ::boost::algorithm::to_lower_copy;
 
+/**
+ * Converts the ASCII letters of [first,last) to lower case, in place.
+ *
+ * Unlike to_lower(), no locale is involved, and other characters (including
+ * non-ASCII bytes of UTF-8 text) are left as they are.
+ */
+inline void ascii_to_lower(char* first, char* last)
+{
+	detail::ascii_flip_case(first, last, 'A');
+}
+
+inline void ascii_to_lower(::std::string& s)
+{
+	if (!s.empty())
+	{
+		ascii_to_lower(&s[0], &s[0]+s.size());
+	}
+}
+
+/// Copies \a s into \a out, converting ASCII letters to lower case and
+/// reusing the capacity of \a out.
+inline void ascii_to_lower_copy(::boost::string_ref s, ::std::string& out)
+{
+	out.assign(s.data(), s.size());
+	ascii_to_lower(out);
+}
+
 }} // Namespace dcs::string
 
 
@@ -27,6 +27,9 @@
 
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <dcs/string/algorithm/detail/ascii_case.hpp>
+#include <string>
 
 
 namespace dcs { namespace string {
@@ -34,6 +37,33 @@ namespace dcs { namespace string {
 using ::boost::algorithm::to_upper;
 using ::boost::algorithm::to_upper_copy;
 
+/**
+ * Converts the ASCII letters of [first,last) to upper case, in place.
+ *
+ * Unlike to_upper(), no locale is involved, and other characters (including
+ * non-ASCII bytes of UTF-8 text) are left as they are.
+ */
+inline void ascii_to_upper(char* first, char* last)
+{
+	detail::ascii_flip_case(first, last, 'a');
+}
+
+inline void ascii_to_upper(::std::string& s)
+{
+	if (!s.empty())
+	{
+		ascii_to_upper(&s[0], &s[0]+s.size());
+	}
+}
+
+/// Copies \a s into \a out, converting ASCII letters to upper case and
+/// reusing the capacity of \a out.
+inline void ascii_to_upper_copy(::boost::string_ref s, ::std::string& out)
+{
+	out.assign(s.data(), s.size());
+	ascii_to_upper(out);
+}
+
 }} // Namespace dcs::string
 
 
@@ -0,0 +1,856 @@
+/**
+ * \file dcs/system/posix_process_pool.hpp
+ *
+ * \brief Event-driven runner of many processes in POSIX-compliant (Linux) systems.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_SYSTEM_POSIX_PROCESS_POOL_HPP
+#define DCS_SYSTEM_POSIX_PROCESS_POOL_HPP
+
+
+#ifndef __linux__
+# error "The process pool needs epoll(7), which is only available on Linux."
+#endif // __linux__
+
+
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/logging.hpp>
+#include <dcs/system/process_status_category.hpp>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+
+extern char** environ;
+
+
+namespace dcs { namespace system {
+
+namespace detail {
+
+/// Opens a file descriptor referring to process \a pid, or returns -1 (with
+/// \c errno set to \c ENOSYS on kernels older than 5.3).
+inline int posix_pidfd_open(::pid_t pid)
+{
+#ifdef SYS_pidfd_open
+	return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#else // SYS_pidfd_open
+	(void) pid;
+	errno = ENOSYS;
+	return -1;
+#endif // SYS_pidfd_open
+}
+
+/// Writes to a pipe whose reader may be gone, without being killed by
+/// SIGPIPE (which is blocked, and discarded if raised, during the write).
+inline ::ssize_t posix_write_nosigpipe(int fd, char const* data, ::std::size_t n)
+{
+	::sigset_t pipe_set;
+	::sigset_t old_set;
+	::sigemptyset(&pipe_set);
+	::sigaddset(&pipe_set, SIGPIPE);
+	::pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+	const ::ssize_t ret(::write(fd, data, n));
+	const int write_errno(errno);
+
+	if (ret == -1 && write_errno == EPIPE && !::sigismember(&old_set, SIGPIPE))
+	{
+		const ::timespec zero = {0, 0};
+		while (::sigtimedwait(&pipe_set, 0, &zero) == -1 && errno == EINTR)
+		{
+		}
+	}
+	::pthread_sigmask(SIG_SETMASK, &old_set, 0);
+	errno = write_errno;
+
+	return ret;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Runs many processes at once, with a limit on the number of running
+ *  ones, from a single thread.
+ *
+ * Processes are submitted as jobs, each with a command, its arguments and an
+ * optional standard input, and are started in submission order as soon as
+ * fewer than the given limit are running.
+ * The standard output and error of each process are captured into strings.
+ *
+ * Processes are created with posix_spawnp(3) (which, unlike fork(2), does
+ * not copy the page tables of the parent), through pipes that are closed on
+ * exec so that children do not inherit each other's pipes.
+ * A single epoll(7) loop, run by the thread calling wait_any() or
+ * wait_all(), drains all output pipes, feeds the input pipes, and detects
+ * the termination of children through a pidfd for each of them (or, on
+ * kernels without pidfd_open(2), through a signalfd(2) for \c SIGCHLD).
+ *
+ * A job is done when its process has terminated and its output pipes have
+ * been closed (thus, a background process inheriting them delays the job).
+ *
+ * This class is not thread-safe.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class posix_process_pool: private ::boost::noncopyable
+{
+	public: typedef ::std::size_t job_id_type;
+	public: typedef ::pid_t pid_type;
+
+
+	private: enum fd_category
+	{
+		process_fd = 0,
+		out_fd,
+		err_fd,
+		in_fd
+	};
+
+	private: struct job
+	{
+		job()
+		: pid(-1),
+		  status(undefined_process_status),
+		  exit_status(EXIT_SUCCESS),
+		  sig(-1),
+		  exited(false),
+		  reported(false),
+		  input_off(0)
+		{
+			fds[process_fd] = fds[out_fd] = fds[err_fd] = fds[in_fd] = -1;
+		}
+
+		::std::string cmd;
+		::std::vector< ::std::string > args;
+		::std::string input;
+		::std::string output;
+		::std::string error;
+		pid_type pid;
+		int fds[4]; ///< The pidfd and the pipes of the process, or -1
+		process_status_category status;
+		int exit_status;
+		int sig;
+		bool exited;
+		bool reported; ///< Tells if wait_any() has returned the job
+		::std::size_t input_off; ///< The amount of input written so far
+	}; // job
+
+
+	/**
+	 * \brief Creates a pool running at most \a max_running processes at once
+	 *  (by default, as many as the online processors).
+	 */
+	public: explicit posix_process_pool(::std::size_t max_running = 0)
+	: max_running_(max_running),
+	  num_running_(0),
+	  next_pending_(0),
+	  epfd_(-1),
+	  sigfd_(-1),
+	  use_pidfd_(true),
+	  buf_(1 << 16)
+	{
+		if (max_running_ == 0)
+		{
+			const long ncpus(::sysconf(_SC_NPROCESSORS_ONLN));
+			max_running_ = ncpus > 0 ? static_cast< ::std::size_t >(ncpus) : 1;
+		}
+
+		epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+		if (epfd_ == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to epoll_create1(2) failed: " << ::strerror(errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+	}
+
+	public: ~posix_process_pool()
+	{
+		// Kill and reap the children that are still running, to prevent zombies
+		for (::std::size_t i = 0; i < jobs_.size(); ++i)
+		{
+			job& j(jobs_[i]);
+			if (j.pid != -1 && !j.exited)
+			{
+				::kill(j.pid, SIGKILL);
+				int wstatus;
+				while (::waitpid(j.pid, &wstatus, 0) == -1 && errno == EINTR)
+				{
+				}
+				j.exited = true;
+
+				::std::ostringstream oss;
+				oss << "Killed command '" << j.cmd << "' still running at pool destruction";
+				dcs::log_warn(DCS_LOGGING_AT, oss.str());
+			}
+			this->close_fds(j);
+		}
+		if (sigfd_ != -1)
+		{
+			::close(sigfd_);
+			::pthread_sigmask(SIG_SETMASK, &old_sigmask_, 0);
+		}
+		::close(epfd_);
+	}
+
+	/// Submits a job running \a cmd without arguments.
+	public: job_id_type submit(::std::string const& cmd)
+	{
+		::std::vector< ::std::string > args;
+		return this->submit(cmd, args.begin(), args.end());
+	}
+
+	/**
+	 * \brief Submits a job running \a cmd (searched in the \c PATH, if it has
+	 *  no slash) with the arguments in [\a arg_first, \a arg_last), and
+	 *  writing \a input to its standard input (which, otherwise, reads from
+	 *  /dev/null).
+	 *
+	 * The job is started by the next call to wait_any() or wait_all(), as
+	 * soon as the number of running processes allows it.
+	 */
+	public: template <typename FwdIterT>
+			job_id_type submit(::std::string const& cmd, FwdIterT arg_first, FwdIterT arg_last, ::std::string const& input = ::std::string())
+	{
+		jobs_.push_back(job());
+		job& j(jobs_.back());
+		j.cmd = cmd;
+		j.args.assign(arg_first, arg_last);
+		j.input = input;
+
+		return jobs_.size()-1;
+	}
+
+	/**
+	 * \brief Runs the jobs until one of them is done, and sets \a id to it.
+	 *
+	 * Each job is returned once, in completion order. Returns \c false if all
+	 * jobs have already been returned.
+	 */
+	public: bool wait_any(job_id_type& id)
+	{
+		while (done_.empty() && (num_running_ > 0 || next_pending_ < jobs_.size()))
+		{
+			this->poll(-1);
+		}
+		if (done_.empty())
+		{
+			return false;
+		}
+
+		id = done_.front();
+		done_.pop_front();
+		jobs_[id].reported = true;
+
+		return true;
+	}
+
+	/// Runs the jobs until all of them are done.
+	public: void wait_all()
+	{
+		while (num_running_ > 0 || next_pending_ < jobs_.size())
+		{
+			this->poll(-1);
+		}
+		for (::std::size_t i = 0; i < done_.size(); ++i)
+		{
+			jobs_[done_[i]].reported = true;
+		}
+		done_.clear();
+	}
+
+	/**
+	 * \brief Starts pending jobs, if possible, and handles the events that
+	 *  occur within \a timeout_ms milliseconds (-1 meaning no limit).
+	 *
+	 * Returns the number of handled events.
+	 */
+	public: ::std::size_t poll(int timeout_ms)
+	{
+		this->start_pending();
+		if (num_running_ == 0)
+		{
+			return 0;
+		}
+
+		// Without pidfds, signals may get lost (e.g., if another thread
+		// receives SIGCHLD), thus look for terminated children periodically
+		if (!use_pidfd_ && (timeout_ms < 0 || timeout_ms > reap_period_ms))
+		{
+			timeout_ms = reap_period_ms;
+		}
+
+		::epoll_event events[max_events];
+		int n;
+		while ((n = ::epoll_wait(epfd_, events, max_events, timeout_ms)) == -1 && errno == EINTR)
+		{
+		}
+		if (n == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to epoll_wait(2) failed: " << ::strerror(errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		for (int e = 0; e < n; ++e)
+		{
+			const ::boost::uint64_t tag(events[e].data.u64);
+			if (tag == signal_tag)
+			{
+				this->drain_signals();
+				continue;
+			}
+
+			const ::std::size_t id(static_cast< ::std::size_t >(tag >> 2));
+			const fd_category kind(static_cast<fd_category>(tag & 3));
+			if (jobs_[id].fds[kind] == -1)
+			{
+				// Closed while handling a previous event
+				continue;
+			}
+			switch (kind)
+			{
+				case process_fd:
+					this->reap(id);
+					break;
+				case out_fd:
+					this->drain(id, out_fd, jobs_[id].output);
+					break;
+				case err_fd:
+					this->drain(id, err_fd, jobs_[id].error);
+					break;
+				case in_fd:
+					this->feed(id);
+					break;
+			}
+		}
+		if (!use_pidfd_)
+		{
+			this->reap_all();
+		}
+
+		this->start_pending();
+
+		return static_cast< ::std::size_t >(n);
+	}
+
+	/// Sends signal \a sig to all running processes.
+	public: void signal_all(int sig)
+	{
+		for (::std::size_t i = 0; i < jobs_.size(); ++i)
+		{
+			if (jobs_[i].status == running_process_status && !jobs_[i].exited)
+			{
+				::kill(jobs_[i].pid, sig);
+			}
+		}
+	}
+
+	/// Returns the number of submitted jobs.
+	public: ::std::size_t size() const
+	{
+		return jobs_.size();
+	}
+
+	public: ::std::size_t max_running() const
+	{
+		return max_running_;
+	}
+
+	/// Returns the number of jobs whose process is running.
+	public: ::std::size_t num_running() const
+	{
+		return num_running_;
+	}
+
+	/// Returns the number of jobs not started yet.
+	public: ::std::size_t num_pending() const
+	{
+		return jobs_.size()-next_pending_;
+	}
+
+	/// Tells if the job is done.
+	public: bool done(job_id_type id) const
+	{
+		this->check_id(id);
+
+		job const& j(jobs_[id]);
+		return j.status != undefined_process_status && j.status != running_process_status;
+	}
+
+	/**
+	 * \brief Returns the status of the job: undefined_process_status if it
+	 *  has not been started, running_process_status if it is not done,
+	 *  terminated_process_status or failed_process_status if its process
+	 *  exited with a zero or nonzero status (or could not be spawned), and
+	 *  aborted_process_status if its process was killed by a signal.
+	 */
+	public: process_status_category status(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].status;
+	}
+
+	/// Returns the exit status of the process of the job (127 if it could
+	/// not be spawned).
+	public: int exit_status(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].exit_status;
+	}
+
+	/// Returns the signal that killed the process of the job, or -1.
+	public: int signal(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].sig;
+	}
+
+	public: pid_type pid(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].pid;
+	}
+
+	/// Returns the standard output of the job (so far).
+	public: ::std::string const& output(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].output;
+	}
+
+	/// Returns the standard error of the job (so far).
+	public: ::std::string const& error(job_id_type id) const
+	{
+		this->check_id(id);
+
+		return jobs_[id].error;
+	}
+
+	private: void check_id(job_id_type id) const
+	{
+		// pre: id < size()
+		DCS_ASSERT(id < jobs_.size(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Invalid job identifier"));
+	}
+
+	private: void start_pending()
+	{
+		while (num_running_ < max_running_ && next_pending_ < jobs_.size())
+		{
+			this->start(next_pending_++);
+		}
+	}
+
+	private: void start(job_id_type id)
+	{
+		job& j(jobs_[id]);
+
+		int out_pipe[2] = {-1, -1};
+		int err_pipe[2] = {-1, -1};
+		int in_pipe[2] = {-1, -1};
+		if (::pipe2(out_pipe, O_CLOEXEC) == -1
+			|| ::pipe2(err_pipe, O_CLOEXEC) == -1
+			|| (!j.input.empty() && ::pipe2(in_pipe, O_CLOEXEC) == -1))
+		{
+			const int pipe_errno(errno);
+			const int fds[6] = {out_pipe[0], out_pipe[1], err_pipe[0], err_pipe[1], in_pipe[0], in_pipe[1]};
+			for (int k = 0; k < 6; ++k)
+			{
+				if (fds[k] != -1)
+				{
+					::close(fds[k]);
+				}
+			}
+
+			::std::ostringstream oss;
+			oss << "Call to pipe2(2) failed for command '" << j.cmd << "': " << ::strerror(pipe_errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		// Connect the pipes to the standard streams of the child (dup2
+		// clears the close-on-exec flag of the copies)
+		::posix_spawn_file_actions_t actions;
+		::posix_spawn_file_actions_init(&actions);
+		if (in_pipe[0] != -1)
+		{
+			::posix_spawn_file_actions_adddup2(&actions, in_pipe[0], STDIN_FILENO);
+		}
+		else
+		{
+			::posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+		}
+		::posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+		::posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+
+		// Do not pass on the signal mask of this thread (which may block
+		// SIGCHLD and SIGPIPE) and the handlers of these signals
+		::posix_spawnattr_t attr;
+		::posix_spawnattr_init(&attr);
+		::sigset_t sigs;
+		::sigemptyset(&sigs);
+		::posix_spawnattr_setsigmask(&attr, &sigs);
+		::sigaddset(&sigs, SIGCHLD);
+		::sigaddset(&sigs, SIGPIPE);
+		::posix_spawnattr_setsigdefault(&attr, &sigs);
+		::posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+		::std::vector<char*> argv;
+		argv.push_back(const_cast<char*>(j.cmd.c_str()));
+		for (::std::size_t k = 0; k < j.args.size(); ++k)
+		{
+			argv.push_back(const_cast<char*>(j.args[k].c_str()));
+		}
+		argv.push_back(0);
+
+		if (!use_pidfd_)
+		{
+			this->init_signalfd();
+		}
+
+		pid_type pid(-1);
+		const int ret(::posix_spawnp(&pid, j.cmd.c_str(), &actions, &attr, &argv[0], environ));
+
+		::posix_spawn_file_actions_destroy(&actions);
+		::posix_spawnattr_destroy(&attr);
+		::close(out_pipe[1]);
+		::close(err_pipe[1]);
+		if (in_pipe[0] != -1)
+		{
+			::close(in_pipe[0]);
+		}
+
+		j.fds[out_fd] = out_pipe[0];
+		j.fds[err_fd] = err_pipe[0];
+		j.fds[in_fd] = in_pipe[1];
+
+		if (ret != 0)
+		{
+			// Most likely, the command cannot be executed: report it as a
+			// shell would
+			::std::ostringstream oss;
+			oss << "Call to posix_spawnp(3) failed for command '" << j.cmd << "': " << ::strerror(ret);
+			dcs::log_warn(DCS_LOGGING_AT, oss.str());
+
+			this->close_fds(j);
+			j.error = oss.str();
+			j.exit_status = 127;
+			j.status = failed_process_status;
+			done_.push_back(id);
+			return;
+		}
+
+		j.pid = pid;
+		j.status = running_process_status;
+		++num_running_;
+
+		if (use_pidfd_)
+		{
+			j.fds[process_fd] = detail::posix_pidfd_open(pid);
+			if (j.fds[process_fd] == -1)
+			{
+				if (errno != ENOSYS)
+				{
+					::std::ostringstream oss;
+					oss << "Call to pidfd_open(2) failed for command '" << j.cmd << "': " << ::strerror(errno);
+
+					DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+				}
+
+				// Switch to signalfd (the child, if already terminated,
+				// will be found by polling)
+				use_pidfd_ = false;
+				this->init_signalfd();
+			}
+		}
+
+		for (int k = 0; k < 4; ++k)
+		{
+			if (j.fds[k] == -1)
+			{
+				continue;
+			}
+			if (k != process_fd)
+			{
+				::fcntl(j.fds[k], F_SETFL, ::fcntl(j.fds[k], F_GETFL) | O_NONBLOCK);
+			}
+
+			::epoll_event ev;
+			ev.events = (k == in_fd) ? EPOLLOUT : EPOLLIN;
+			ev.data.u64 = (static_cast< ::boost::uint64_t >(id) << 2) | static_cast< ::boost::uint64_t >(k);
+			if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, j.fds[k], &ev) == -1)
+			{
+				::std::ostringstream oss;
+				oss << "Call to epoll_ctl(2) failed for command '" << j.cmd << "': " << ::strerror(errno);
+
+				DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+			}
+		}
+	}
+
+	/// Watches SIGCHLD through a signalfd, blocking it in this thread.
+	private: void init_signalfd()
+	{
+		if (sigfd_ != -1)
+		{
+			return;
+		}
+
+		::sigset_t sigs;
+		::sigemptyset(&sigs);
+		::sigaddset(&sigs, SIGCHLD);
+		::pthread_sigmask(SIG_BLOCK, &sigs, &old_sigmask_);
+
+		sigfd_ = ::signalfd(-1, &sigs, SFD_NONBLOCK | SFD_CLOEXEC);
+		if (sigfd_ == -1)
+		{
+			const int sig_errno(errno);
+			::pthread_sigmask(SIG_SETMASK, &old_sigmask_, 0);
+
+			::std::ostringstream oss;
+			oss << "Call to signalfd(2) failed: " << ::strerror(sig_errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		::epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.u64 = signal_tag;
+		if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, sigfd_, &ev) == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to epoll_ctl(2) failed for the signalfd: " << ::strerror(errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+	}
+
+	private: void drain_signals()
+	{
+		// Several SIGCHLD may be merged into one, thus the children are
+		// checked all together afterwards
+		::signalfd_siginfo info;
+		while (::read(sigfd_, &info, sizeof(info)) == static_cast< ::ssize_t >(sizeof(info)))
+		{
+		}
+	}
+
+	private: void reap_all()
+	{
+		for (::std::size_t i = 0; i < next_pending_; ++i)
+		{
+			if (jobs_[i].status == running_process_status && !jobs_[i].exited)
+			{
+				this->reap(i);
+			}
+		}
+	}
+
+	/// Collects the exit status of the process of the job, if terminated.
+	private: void reap(job_id_type id)
+	{
+		job& j(jobs_[id]);
+
+		int wstatus;
+		::pid_t ret;
+		while ((ret = ::waitpid(j.pid, &wstatus, WNOHANG)) == -1 && errno == EINTR)
+		{
+		}
+		if (ret == 0)
+		{
+			// Still running (e.g., woken up by a stop)
+			return;
+		}
+		if (ret == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Call to waitpid(2) failed for command '" << j.cmd << "': " << ::strerror(errno);
+
+			DCS_EXCEPTION_THROW(::std::runtime_error, oss.str());
+		}
+
+		j.exited = true;
+		if (WIFEXITED(wstatus))
+		{
+			j.exit_status = WEXITSTATUS(wstatus);
+		}
+		else if (WIFSIGNALED(wstatus))
+		{
+			j.sig = WTERMSIG(wstatus);
+		}
+		this->close_fd(j, process_fd);
+		// Nobody is left to read the input
+		this->close_fd(j, in_fd);
+
+		this->finish(id);
+	}
+
+	/// Reads the available data from a pipe.
+	private: void drain(job_id_type id, fd_category kind, ::std::string& out)
+	{
+		job& j(jobs_[id]);
+
+		while (true)
+		{
+			const ::ssize_t n(::read(j.fds[kind], &buf_[0], buf_.size()));
+			if (n > 0)
+			{
+				out.append(&buf_[0], static_cast< ::std::size_t >(n));
+				continue;
+			}
+			if (n == -1 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				return;
+			}
+			// End of file (or error)
+			this->close_fd(j, kind);
+			this->finish(id);
+			return;
+		}
+	}
+
+	/// Writes as much input as the pipe accepts.
+	private: void feed(job_id_type id)
+	{
+		job& j(jobs_[id]);
+
+		while (j.input_off < j.input.size())
+		{
+			const ::ssize_t n(detail::posix_write_nosigpipe(j.fds[in_fd], j.input.data()+j.input_off, j.input.size()-j.input_off));
+			if (n > 0)
+			{
+				j.input_off += static_cast< ::std::size_t >(n);
+				continue;
+			}
+			if (n == -1 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				return;
+			}
+			// The child closed its input
+			break;
+		}
+		// Let the child see the end of its input
+		this->close_fd(j, in_fd);
+	}
+
+	/// Marks the job as done once its process has terminated and its output
+	/// has been read.
+	private: void finish(job_id_type id)
+	{
+		job& j(jobs_[id]);
+		if (!j.exited || j.fds[out_fd] != -1 || j.fds[err_fd] != -1)
+		{
+			return;
+		}
+
+		if (j.sig != -1)
+		{
+			j.status = aborted_process_status;
+		}
+		else
+		{
+			j.status = (j.exit_status == EXIT_SUCCESS) ? terminated_process_status : failed_process_status;
+		}
+		--num_running_;
+		done_.push_back(id);
+	}
+
+	private: void close_fd(job& j, fd_category kind)
+	{
+		if (j.fds[kind] != -1)
+		{
+			// Closing the descriptor is not enough, since a child being
+			// spawned may briefly hold a copy of it
+			::epoll_ctl(epfd_, EPOLL_CTL_DEL, j.fds[kind], 0);
+			::close(j.fds[kind]);
+			j.fds[kind] = -1;
+		}
+	}
+
+	private: void close_fds(job& j)
+	{
+		this->close_fd(j, process_fd);
+		this->close_fd(j, out_fd);
+		this->close_fd(j, err_fd);
+		this->close_fd(j, in_fd);
+	}
+
+
+	private: static const int max_events = 64;
+	private: static const int reap_period_ms = 100;
+	private: static const ::boost::uint64_t signal_tag = static_cast< ::boost::uint64_t >(-1);
+
+
+	private: ::std::size_t max_running_; ///< The maximum number of running processes
+	private: ::std::size_t num_running_; ///< The number of jobs started and not done
+	private: ::std::size_t next_pending_; ///< The first job not started yet
+	private: ::std::vector<job> jobs_;
+	private: ::std::deque<job_id_type> done_; ///< The jobs done and not returned by wait_any() yet
+	private: int epfd_;
+	private: int sigfd_;
+	private: bool use_pidfd_;
+	private: ::sigset_t old_sigmask_; ///< The signal mask before blocking SIGCHLD
+	private: ::std::vector<char> buf_; ///< The buffer for reading pipes
+}; // posix_process_pool
+
+}} // Namespace dcs::system
+
+
+#endif // DCS_SYSTEM_POSIX_PROCESS_POOL_HPP
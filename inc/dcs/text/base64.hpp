@@ -1,7 +1,7 @@
 /**
  * \file dcs/text/base64.hpp
  *
- * \brief Base64 coder/deconder.
+ * \brief Base64 coder/decoder.
  *
  * <hr/>
  *
@@ -47,135 +47,541 @@
 #define DCS_TEXT_BASE64_HPP
 
 
-#include <cctype>
+#include <boost/cstdint.hpp>
 #include <cstddef>
+#include <dcs/text/detail/base64_x86.hpp>
 #include <string>
-#include <boost/cstdint.hpp>
 
 
 namespace dcs { namespace text {
 
-namespace /*<unnamed>*/ { namespace detail {
+/// The Base64 alphabets (see RFC 4648).
+enum base64_alphabet_category
+{
+	standard_base64_alphabet, ///< The standard alphabet, ending with '+' and '/'
+	url_safe_base64_alphabet ///< The URL and filename safe alphabet, ending with '-' and '_'
+};
+
+
+namespace detail {
 
-static const ::std::string base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-										  "abcdefghijklmnopqrstuvwxyz"
-										  "0123456789+/";
+/// The implementations of the bulk encoding/decoding loops.
+enum base64_kernel_category
+{
+	scalar_base64_kernel,
+	ssse3_base64_kernel,
+	avx2_base64_kernel
+};
 
-inline
-static bool is_base64(::boost::uint8_t c)
+inline char const* base64_chars(base64_alphabet_category alphabet)
 {
-	return (::std::isalnum(c) || (c == '+') || (c == '/'));
+	return alphabet == url_safe_base64_alphabet
+		   ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+		   : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 }
 
-}} // Namespace <unnamed>::detail
+/// Returns the table mapping characters to their index, or to 0xff if they are not in the alphabet.
+inline ::boost::uint8_t const* base64_index_table(base64_alphabet_category alphabet)
+{
+	static const ::boost::uint8_t standard_table[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+	};
+	static const ::boost::uint8_t url_safe_table[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff,
+		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0x3f,
+		0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+	};
 
+	return alphabet == url_safe_base64_alphabet ? url_safe_table : standard_table;
+}
 
-::std::string base64_encode(::boost::uint8_t const* bytes_to_encode, ::std::size_t in_len)
+/// Returns the fastest kernel supported by the CPU.
+inline base64_kernel_category base64_detect_kernel()
 {
-	::std::string ret;
-	::std::size_t i = 0;
-	::std::size_t j = 0;
-	::boost::uint8_t byte_array_3[3];
-	::boost::uint8_t byte_array_4[4];
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+	if (base64_x86_has_avx2())
+	{
+		return avx2_base64_kernel;
+	}
+	if (base64_x86_has_ssse3())
+	{
+		return ssse3_base64_kernel;
+	}
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+	return scalar_base64_kernel;
+}
+
+/// Returns the kernel used by default, which is detected only once.
+inline base64_kernel_category base64_default_kernel()
+{
+	static const base64_kernel_category kernel(base64_detect_kernel());
+
+	return kernel;
+}
+
+/// Encodes the last 1 or 2 bytes of the input.
+inline ::std::size_t base64_encode_tail(::boost::uint8_t const* in, ::std::size_t n, char* out, char const* chars, bool padding)
+{
+	const ::boost::uint32_t b0(in[0]);
+	const ::boost::uint32_t b1(n > 1 ? in[1] : 0);
 
-	while (in_len--)
+	out[0] = chars[b0 >> 2];
+	out[1] = chars[((b0 & 0x03) << 4) | (b1 >> 4)];
+	if (n > 1)
 	{
-		byte_array_3[i++] = *(bytes_to_encode++);
-		if (i == 3)
-		{
-			byte_array_4[0] = (byte_array_3[0] & 0xfc) >> 2;
-			byte_array_4[1] = ((byte_array_3[0] & 0x03) << 4) + ((byte_array_3[1] & 0xf0) >> 4);
-			byte_array_4[2] = ((byte_array_3[1] & 0x0f) << 2) + ((byte_array_3[2] & 0xc0) >> 6);
-			byte_array_4[3] = byte_array_3[2] & 0x3f;
+		out[2] = chars[(b1 & 0x0f) << 2];
+	}
+	if (!padding)
+	{
+		return n+1;
+	}
+	if (n == 1)
+	{
+		out[2] = '=';
+	}
+	out[3] = '=';
+	return 4;
+}
 
-			for(i = 0; i < 4; ++i)
-			{
-				ret += detail::base64_chars[byte_array_4[i]];
-			}
-			i = 0;
+/// Encodes the whole 3-byte groups of the input and returns the number of bytes consumed.
+inline ::std::size_t base64_encode_scalar(::boost::uint8_t const* in, ::std::size_t n, char* out, char const* chars)
+{
+	const ::std::size_t m(n-n%3);
+
+	for (::std::size_t i = 0; i < m; i += 3, out += 4)
+	{
+		const ::boost::uint32_t w((static_cast< ::boost::uint32_t >(in[i]) << 16)
+								  | (static_cast< ::boost::uint32_t >(in[i+1]) << 8)
+								  | in[i+2]);
+
+		out[0] = chars[w >> 18];
+		out[1] = chars[(w >> 12) & 0x3f];
+		out[2] = chars[(w >> 6) & 0x3f];
+		out[3] = chars[w & 0x3f];
+	}
+
+	return m;
+}
+
+/**
+ * Decodes the whole 4-character groups of the input up to the first group
+ * holding a character outside the alphabet, and returns the number of
+ * characters consumed.
+ */
+inline ::std::size_t base64_decode_scalar(char const* in, ::std::size_t n, ::boost::uint8_t* out, ::boost::uint8_t const* table)
+{
+	::std::size_t i(0);
+	for (; (n-i) >= 4; i += 4, out += 3)
+	{
+		const ::boost::uint32_t a(table[static_cast<unsigned char>(in[i])]);
+		const ::boost::uint32_t b(table[static_cast<unsigned char>(in[i+1])]);
+		const ::boost::uint32_t c(table[static_cast<unsigned char>(in[i+2])]);
+		const ::boost::uint32_t d(table[static_cast<unsigned char>(in[i+3])]);
+
+		if ((a | b | c | d) & 0x80)
+		{
+			break;
 		}
+
+		const ::boost::uint32_t w((a << 18) | (b << 12) | (c << 6) | d);
+		out[0] = static_cast< ::boost::uint8_t >(w >> 16);
+		out[1] = static_cast< ::boost::uint8_t >(w >> 8);
+		out[2] = static_cast< ::boost::uint8_t >(w);
+	}
+
+	return i;
+}
+
+/// Encodes the whole 3-byte groups of the input and returns the number of bytes consumed.
+inline ::std::size_t base64_encode_bulk(::boost::uint8_t const* in, ::std::size_t n, char* out, base64_alphabet_category alphabet, base64_kernel_category kernel)
+{
+	char const* chars(base64_chars(alphabet));
+	::std::size_t i(0);
+
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+	switch (kernel)
+	{
+		case avx2_base64_kernel:
+			i = base64_encode_avx2(in, n, out, chars[62], chars[63]);
+			break;
+		case ssse3_base64_kernel:
+			i = base64_encode_ssse3(in, n, out, chars[62], chars[63]);
+			break;
+		default:
+			break;
+	}
+#else // DCS_TEXT_DETAIL_BASE64_X86
+	(void) kernel;
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+
+	return i+base64_encode_scalar(in+i, n-i, out+i/3*4, chars);
+}
+
+/// Decodes the valid whole 4-character groups of the input and returns the number of characters consumed.
+inline ::std::size_t base64_decode_bulk(char const* in, ::std::size_t n, ::boost::uint8_t* out, base64_alphabet_category alphabet, base64_kernel_category kernel)
+{
+	::std::size_t i(0);
+
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+	char const* chars(base64_chars(alphabet));
+	switch (kernel)
+	{
+		case avx2_base64_kernel:
+			i = base64_decode_avx2(in, n, out, chars[62], chars[63]);
+			break;
+		case ssse3_base64_kernel:
+			i = base64_decode_ssse3(in, n, out, chars[62], chars[63]);
+			break;
+		default:
+			break;
+	}
+#else // DCS_TEXT_DETAIL_BASE64_X86
+	(void) kernel;
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+
+	return i+base64_decode_scalar(in+i, n-i, out+i/4*3, base64_index_table(alphabet));
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Incremental Base64 encoder.
+ *
+ * Encodes a stream of bytes given in chunks of any size into caller-provided
+ * buffers.
+ * Up to two bytes of each chunk are held back until the next chunk (or the
+ * call to finish()) completes their 3-byte group.
+ *
+ * Bulk data are encoded by SSSE3 or AVX2 code, when supported by the CPU.
+ */
+class base64_encoder
+{
+	public: explicit base64_encoder(base64_alphabet_category alphabet = standard_base64_alphabet, bool padding = true)
+	: alphabet_(alphabet),
+	  padding_(padding),
+	  kernel_(detail::base64_default_kernel()),
+	  npend_(0)
+	{
 	}
 
-	if (i)
+	/// Returns the number of characters written by encode() for \a n bytes.
+	public: ::std::size_t encoded_size(::std::size_t n) const
 	{
-		for (j = i; j < 3; ++j)
+		return (npend_+n)/3*4;
+	}
+
+	/// Returns the maximum number of characters written by finish().
+	public: static ::std::size_t max_finish_size()
+	{
+		return 4;
+	}
+
+	/**
+	 * Encodes \a n bytes into \a out, which must have room for
+	 * encoded_size(n) characters.
+	 * Returns the number of characters written.
+	 */
+	public: ::std::size_t encode(::boost::uint8_t const* in, ::std::size_t n, char* out)
+	{
+		::std::size_t i(0);
+		::std::size_t w(0);
+
+		if (npend_ > 0)
 		{
-			byte_array_3[j] = '\0';
+			while (npend_ < 3 && i < n)
+			{
+				pend_[npend_++] = in[i++];
+			}
+			if (npend_ < 3)
+			{
+				return 0;
+			}
+			w = detail::base64_encode_scalar(pend_, 3, out, detail::base64_chars(alphabet_))/3*4;
+			npend_ = 0;
 		}
 
-		byte_array_4[0] = (byte_array_3[0] & 0xfc) >> 2;
-		byte_array_4[1] = ((byte_array_3[0] & 0x03) << 4) + ((byte_array_3[1] & 0xf0) >> 4);
-		byte_array_4[2] = ((byte_array_3[1] & 0x0f) << 2) + ((byte_array_3[2] & 0xc0) >> 6);
-		byte_array_4[3] = byte_array_3[2] & 0x3f;
+		const ::std::size_t k(detail::base64_encode_bulk(in+i, n-i, out+w, alphabet_, kernel_));
+		i += k;
+		w += k/3*4;
 
-		for (j = 0; (j < i + 1); ++j)
+		while (i < n)
 		{
-			ret += detail::base64_chars[byte_array_4[j]];
+			pend_[npend_++] = in[i++];
 		}
 
-		while (++i <= 3)
+		return w;
+	}
+
+	/**
+	 * Encodes the bytes held back, with padding if enabled, and resets the
+	 * encoder.
+	 * Returns the number of characters written.
+	 */
+	public: ::std::size_t finish(char* out)
+	{
+		::std::size_t w(0);
+
+		if (npend_ > 0)
 		{
-			ret += '=';
+			w = detail::base64_encode_tail(pend_, npend_, out, detail::base64_chars(alphabet_), padding_);
 		}
+		npend_ = 0;
+
+		return w;
 	}
 
-	return ret;
+	/// Discards the bytes held back.
+	public: void reset()
+	{
+		npend_ = 0;
+	}
 
-}
 
-::std::string base64_decode(::std::string const& encoded_string)
+	private: base64_alphabet_category alphabet_;
+	private: bool padding_;
+	private: detail::base64_kernel_category kernel_;
+	private: ::boost::uint8_t pend_[3];
+	private: ::std::size_t npend_;
+}; // base64_encoder
+
+
+/**
+ * \brief Incremental Base64 decoder.
+ *
+ * Decodes a stream of characters given in chunks of any size into
+ * caller-provided buffers.
+ * Up to three characters of each chunk are held back until the next chunk
+ * (or the call to finish()) completes their 4-character group.
+ *
+ * Decoding ends at the first character outside the alphabet (e.g., the
+ * padding character '='); the rest of the stream is ignored.
+ *
+ * Bulk data are decoded by SSSE3 or AVX2 code, when supported by the CPU.
+ */
+class base64_decoder
 {
-	::std::size_t in_len = encoded_string.size();
-	::std::size_t i = 0;
-	::std::size_t j = 0;
-	::std::size_t k = 0;
-	::boost::uint8_t byte_array_3[3];
-	::boost::uint8_t byte_array_4[4];
-	::std::string ret;
+	public: explicit base64_decoder(base64_alphabet_category alphabet = standard_base64_alphabet)
+	: alphabet_(alphabet),
+	  kernel_(detail::base64_default_kernel()),
+	  npend_(0),
+	  done_(false)
+	{
+	}
+
+	/// Returns the maximum number of bytes written by decode() for \a n characters.
+	public: ::std::size_t max_decoded_size(::std::size_t n) const
+	{
+		return (npend_+n)/4*3;
+	}
+
+	/// Returns the maximum number of bytes written by finish().
+	public: static ::std::size_t max_finish_size()
+	{
+		return 2;
+	}
+
+	/// Tells if the end of the encoded data has been found.
+	public: bool done() const
+	{
+		return done_;
+	}
 
-	while (in_len-- && (encoded_string[k] != '=') && detail::is_base64(encoded_string[k]))
+	/**
+	 * Decodes \a n characters into \a out, which must have room for
+	 * max_decoded_size(n) bytes.
+	 * Returns the number of bytes written.
+	 */
+	public: ::std::size_t decode(char const* in, ::std::size_t n, ::boost::uint8_t* out)
 	{
-		byte_array_4[i++] = encoded_string[k];
-		++k;
-		if (i == 4)
+		::boost::uint8_t const* table(detail::base64_index_table(alphabet_));
+		::std::size_t i(0);
+		::std::size_t w(0);
+
+		if (done_)
+		{
+			return 0;
+		}
+
+		if (npend_ > 0)
 		{
-			for (i = 0; i < 4; ++i)
+			while (npend_ < 4 && i < n)
 			{
-				byte_array_4[i] = detail::base64_chars.find(byte_array_4[i]);
+				if (table[static_cast<unsigned char>(in[i])] & 0x80)
+				{
+					done_ = true;
+					return 0;
+				}
+				pend_[npend_++] = in[i++];
 			}
+			if (npend_ < 4)
+			{
+				return 0;
+			}
+			w = detail::base64_decode_scalar(pend_, 4, out, table)/4*3;
+			npend_ = 0;
+		}
 
-			byte_array_3[0] = (byte_array_4[0] << 2) + ((byte_array_4[1] & 0x30) >> 4);
-			byte_array_3[1] = ((byte_array_4[1] & 0xf) << 4) + ((byte_array_4[2] & 0x3c) >> 2);
-			byte_array_3[2] = ((byte_array_4[2] & 0x3) << 6) + byte_array_4[3];
+		const ::std::size_t k(detail::base64_decode_bulk(in+i, n-i, out+w, alphabet_, kernel_));
+		i += k;
+		w += k/4*3;
 
-			for (i = 0; (i < 3); ++i)
+		// Less than 4 characters are left before the end of the chunk or of the data
+		for (; i < n; ++i)
+		{
+			if (table[static_cast<unsigned char>(in[i])] & 0x80)
 			{
-				ret += byte_array_3[i];
+				done_ = true;
+				break;
 			}
-			i = 0;
+			pend_[npend_++] = in[i];
 		}
+
+		return w;
 	}
 
-	if (i)
+	/**
+	 * Decodes the characters held back and resets the decoder.
+	 * Returns the number of bytes written.
+	 */
+	public: ::std::size_t finish(::boost::uint8_t* out)
 	{
-		for (j = i; j < 4; ++j)
-		{
-			byte_array_4[j] = 0;
-		}
+		::std::size_t w(0);
 
-		for (j = 0; j < 4; ++j)
+		if (npend_ > 1)
 		{
-			byte_array_4[j] = detail::base64_chars.find(byte_array_4[j]);
+			// Complete the group with 'A' (i.e., zero bits) and drop the bytes it adds
+			::boost::uint8_t buf[3];
+			for (::std::size_t j = npend_; j < 4; ++j)
+			{
+				pend_[j] = 'A';
+			}
+			detail::base64_decode_scalar(pend_, 4, buf, detail::base64_index_table(alphabet_));
+			w = npend_-1;
+			for (::std::size_t j = 0; j < w; ++j)
+			{
+				out[j] = buf[j];
+			}
 		}
+		this->reset();
 
-		byte_array_3[0] = (byte_array_4[0] << 2) + ((byte_array_4[1] & 0x30) >> 4);
-		byte_array_3[1] = ((byte_array_4[1] & 0xf) << 4) + ((byte_array_4[2] & 0x3c) >> 2);
-		byte_array_3[2] = ((byte_array_4[2] & 0x3) << 6) + byte_array_4[3];
+		return w;
+	}
 
-		for (j = 0; j < (i-1); ++j)
-		{
-			ret += byte_array_3[j];
-		}
+	/// Discards the characters held back and restarts decoding.
+	public: void reset()
+	{
+		npend_ = 0;
+		done_ = false;
+	}
+
+
+	private: base64_alphabet_category alphabet_;
+	private: detail::base64_kernel_category kernel_;
+	private: char pend_[4];
+	private: ::std::size_t npend_;
+	private: bool done_;
+}; // base64_decoder
+
+
+/// Returns the number of characters of the Base64 encoding of \a n bytes.
+inline ::std::size_t base64_encoded_size(::std::size_t n, bool padding = true)
+{
+	return padding ? (n+2)/3*4 : n/3*4+(n%3 ? n%3+1 : 0);
+}
+
+/**
+ * Returns the number of bytes encoded by the \a n characters starting at
+ * \a in, with or without padding.
+ *
+ * The size is exact for well-formed input and an upper bound otherwise.
+ */
+inline ::std::size_t base64_decoded_size(char const* in, ::std::size_t n)
+{
+	for (::std::size_t k = 0; k < 2 && n > 0 && in[n-1] == '='; ++k)
+	{
+		--n;
+	}
+
+	return n/4*3+(n%4 ? n%4-1 : 0);
+}
+
+/**
+ * Encodes \a n bytes into \a out, which must have room for
+ * base64_encoded_size(n, padding) characters.
+ * Returns the number of characters written.
+ */
+inline ::std::size_t base64_encode(::boost::uint8_t const* in, ::std::size_t n, char* out, base64_alphabet_category alphabet = standard_base64_alphabet, bool padding = true)
+{
+	base64_encoder enc(alphabet, padding);
+
+	const ::std::size_t w(enc.encode(in, n, out));
+
+	return w+enc.finish(out+w);
+}
+
+/**
+ * Decodes \a n characters into \a out, which must have room for
+ * base64_decoded_size(in, n) bytes.
+ * Decoding ends at the first character outside the alphabet.
+ * Returns the number of bytes written.
+ */
+inline ::std::size_t base64_decode(char const* in, ::std::size_t n, ::boost::uint8_t* out, base64_alphabet_category alphabet = standard_base64_alphabet)
+{
+	base64_decoder dec(alphabet);
+
+	const ::std::size_t w(dec.decode(in, n, out));
+
+	return w+dec.finish(out+w);
+}
+
+inline ::std::string base64_encode(::boost::uint8_t const* bytes_to_encode, ::std::size_t in_len, base64_alphabet_category alphabet = standard_base64_alphabet, bool padding = true)
+{
+	::std::string ret(base64_encoded_size(in_len, padding), '\0');
+
+	if (!ret.empty())
+	{
+		base64_encode(bytes_to_encode, in_len, &ret[0], alphabet, padding);
+	}
+
+	return ret;
+}
+
+inline ::std::string base64_decode(::std::string const& encoded_string, base64_alphabet_category alphabet = standard_base64_alphabet)
+{
+	::std::string ret(base64_decoded_size(encoded_string.data(), encoded_string.size()), '\0');
+
+	if (!ret.empty())
+	{
+		ret.resize(base64_decode(encoded_string.data(), encoded_string.size(), reinterpret_cast< ::boost::uint8_t* >(&ret[0]), alphabet));
 	}
 
 	return ret;
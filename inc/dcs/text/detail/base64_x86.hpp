@@ -0,0 +1,263 @@
+/**
+ * \file dcs/text/detail/base64_x86.hpp
+ *
+ * \brief SSSE3 and AVX2 kernels of the Base64 codec.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_TEXT_DETAIL_BASE64_X86_HPP
+#define DCS_TEXT_DETAIL_BASE64_X86_HPP
+
+
+// The kernels are compiled for their own instruction set through the target
+// attribute, whatever the flags of the including translation unit, and are
+// only called after checking the CPU at run time.
+#if (defined(__x86_64__) || defined(__i386__)) \
+	&& (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+# define DCS_TEXT_DETAIL_BASE64_X86 1
+#endif // (__x86_64__ || __i386__) && ...
+
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstring>
+#include <immintrin.h>
+
+
+#define DCS_TEXT_DETAIL_BASE64_X86_TARGET_(x) __attribute__((__target__(x)))
+
+
+namespace dcs { namespace text { namespace detail {
+
+/// Returns \c true if the CPU supports SSSE3.
+inline bool base64_x86_has_ssse3()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("ssse3");
+}
+
+/// Returns \c true if the CPU supports AVX2.
+inline bool base64_x86_has_avx2()
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+
+
+// The algorithms are the ones by W. Mula and D. Lemire,
+// "Faster Base64 Encoding and Decoding Using AVX2 Instructions", 2018.
+//
+// Encoding: the bytes of each 3-byte group are spread over a 32-bit word,
+// the four 6-bit indices are moved to their own byte by multiplications, and
+// each index is turned into its character by adding an offset looked up by
+// range (upper case, lower case, digits, and the two last characters, which
+// depend on the alphabet).
+//
+// Decoding: each character is classified by range and translated into its
+// index, then the indices are packed by multiply-add instructions and the
+// resulting bytes are gathered.
+// A block holding a character outside the alphabet stops the kernel, leaving
+// it to the scalar code.
+
+
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("ssse3")
+inline __m128i base64_encode_ssse3_block(__m128i in, __m128i shift_lut)
+{
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+	const __m128i t0(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)));
+	const __m128i t1(_mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040)));
+	const __m128i t2(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)));
+	const __m128i t3(_mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010)));
+	const __m128i indices(_mm_or_si128(t1, t3));
+
+	__m128i lut_idx(_mm_subs_epu8(indices, _mm_set1_epi8(51)));
+	const __m128i upper(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices));
+	lut_idx = _mm_or_si128(lut_idx, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+	return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, lut_idx), indices);
+}
+
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("ssse3")
+inline __m128i base64_encode_shift_lut_ssse3(char c62, char c63)
+{
+	return _mm_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+						 '0'-52, '0'-52, '0'-52, static_cast<char>(c62-62), static_cast<char>(c63-63), 'A', 0, 0);
+}
+
+/**
+ * Encodes the longest prefix of whole 12-byte blocks that can be loaded
+ * 16 bytes at a time.
+ * Returns the number of bytes consumed; \a out receives 4/3 of them.
+ */
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("ssse3")
+inline ::std::size_t base64_encode_ssse3(::boost::uint8_t const* in, ::std::size_t n, char* out, char c62, char c63)
+{
+	const __m128i shift_lut(base64_encode_shift_lut_ssse3(c62, c63));
+
+	::std::size_t i(0);
+	for (; (n-i) >= 16; i += 12, out += 16)
+	{
+		const __m128i chars(base64_encode_ssse3_block(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in+i)), shift_lut));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+	}
+
+	return i;
+}
+
+/**
+ * Decodes the longest prefix of whole 16-character blocks made of characters
+ * of the alphabet.
+ * Returns the number of characters consumed; \a out receives 3/4 of them.
+ */
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("ssse3")
+inline ::std::size_t base64_decode_ssse3(char const* in, ::std::size_t n, ::boost::uint8_t* out, char c62, char c63)
+{
+	::std::size_t i(0);
+	for (; (n-i) >= 16; i += 16, out += 12)
+	{
+		const __m128i c(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in+i)));
+
+		const __m128i upper(_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A'-1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z'+1), c)));
+		const __m128i lower(_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a'-1)), _mm_cmpgt_epi8(_mm_set1_epi8('z'+1), c)));
+		const __m128i digit(_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0'-1)), _mm_cmpgt_epi8(_mm_set1_epi8('9'+1), c)));
+		const __m128i is62(_mm_cmpeq_epi8(c, _mm_set1_epi8(c62)));
+		const __m128i is63(_mm_cmpeq_epi8(c, _mm_set1_epi8(c63)));
+
+		const __m128i valid(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, is62)), is63));
+		if (_mm_movemask_epi8(valid) != 0xffff)
+		{
+			break;
+		}
+
+		__m128i shift(_mm_and_si128(upper, _mm_set1_epi8(-'A')));
+		shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26-'a')));
+		shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52-'0')));
+		shift = _mm_or_si128(shift, _mm_and_si128(is62, _mm_set1_epi8(static_cast<char>(62-c62))));
+		shift = _mm_or_si128(shift, _mm_and_si128(is63, _mm_set1_epi8(static_cast<char>(63-c63))));
+		const __m128i indices(_mm_add_epi8(c, shift));
+
+		const __m128i pairs(_mm_maddubs_epi16(indices, _mm_set1_epi32(0x01400140)));
+		const __m128i words(_mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000)));
+		const __m128i bytes(_mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+
+		::boost::uint8_t buf[16];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(buf), bytes);
+		::std::memcpy(out, buf, 12);
+	}
+
+	return i;
+}
+
+/**
+ * Encodes the longest prefix of whole 24-byte blocks that can be loaded
+ * as two overlapping 16-byte halves.
+ * Returns the number of bytes consumed; \a out receives 4/3 of them.
+ */
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("avx2")
+inline ::std::size_t base64_encode_avx2(::boost::uint8_t const* in, ::std::size_t n, char* out, char c62, char c63)
+{
+	const __m256i shift_lut(_mm256_setr_epi8('a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+											 '0'-52, '0'-52, '0'-52, static_cast<char>(c62-62), static_cast<char>(c63-63), 'A', 0, 0,
+											 'a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+											 '0'-52, '0'-52, '0'-52, static_cast<char>(c62-62), static_cast<char>(c63-63), 'A', 0, 0));
+
+	::std::size_t i(0);
+	for (; (n-i) >= 28; i += 24, out += 32)
+	{
+		// Each 128-bit lane holds the 12 bytes of one half of the block
+		const __m128i lo(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in+i)));
+		const __m128i hi(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in+i+12)));
+		__m256i v(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1));
+
+		v = _mm256_shuffle_epi8(v, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+												   10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+		const __m256i t0(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)));
+		const __m256i t1(_mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040)));
+		const __m256i t2(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)));
+		const __m256i t3(_mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010)));
+		const __m256i indices(_mm256_or_si256(t1, t3));
+
+		__m256i lut_idx(_mm256_subs_epu8(indices, _mm256_set1_epi8(51)));
+		const __m256i upper(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices));
+		lut_idx = _mm256_or_si256(lut_idx, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+		const __m256i chars(_mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, lut_idx), indices));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+	}
+
+	return i;
+}
+
+/**
+ * Decodes the longest prefix of whole 32-character blocks made of characters
+ * of the alphabet.
+ * Returns the number of characters consumed; \a out receives 3/4 of them.
+ */
+DCS_TEXT_DETAIL_BASE64_X86_TARGET_("avx2")
+inline ::std::size_t base64_decode_avx2(char const* in, ::std::size_t n, ::boost::uint8_t* out, char c62, char c63)
+{
+	::std::size_t i(0);
+	for (; (n-i) >= 32; i += 32, out += 24)
+	{
+		const __m256i c(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(in+i)));
+
+		const __m256i upper(_mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A'-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z'+1), c)));
+		const __m256i lower(_mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a'-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z'+1), c)));
+		const __m256i digit(_mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0'-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9'+1), c)));
+		const __m256i is62(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(c62)));
+		const __m256i is63(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(c63)));
+
+		const __m256i valid(_mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, is62)), is63));
+		if (_mm256_movemask_epi8(valid) != -1)
+		{
+			break;
+		}
+
+		__m256i shift(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26-'a')));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52-'0')));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(is62, _mm256_set1_epi8(static_cast<char>(62-c62))));
+		shift = _mm256_or_si256(shift, _mm256_and_si256(is63, _mm256_set1_epi8(static_cast<char>(63-c63))));
+		const __m256i indices(_mm256_add_epi8(c, shift));
+
+		const __m256i pairs(_mm256_maddubs_epi16(indices, _mm256_set1_epi32(0x01400140)));
+		const __m256i words(_mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000)));
+		const __m256i bytes(_mm256_shuffle_epi8(words, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+																		 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+
+		// Each lane holds 12 bytes
+		::boost::uint8_t buf[32];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(buf), bytes);
+		::std::memcpy(out, buf, 12);
+		::std::memcpy(out+12, buf+16, 12);
+	}
+
+	return i;
+}
+
+}}} // Namespace dcs::text::detail
+
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+
+
+#endif // DCS_TEXT_DETAIL_BASE64_X86_HPP
@@ -36,9 +36,10 @@
 
 #include <algorithm>
 #include <dcs/assert.hpp>
+#include <dcs/detail/uri.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/string/algorithm/to_lower.hpp>
-#include <iomanip>
+#include <dcs/uri_query.hpp>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -376,6 +377,18 @@ class uri
 		return query_;
 	}
 
+	/**
+	 * Returns a view of the parameters of the query part of the URI, which
+	 * is valid until the query is changed.
+	 *
+	 * Unlike query(), the query is not decoded as a whole; see
+	 * uri_query_view.
+	 */
+	public: uri_query_view query_params(bool plus_as_space = true) const
+	{
+		return uri_query_view(uri_query_view::string_ref_type(query_.data(), query_.size()), plus_as_space);
+	}
+
 	/// Sets the query part of the URI.
 	public: void raw_query(::std::string const& str)
 	{
@@ -946,163 +959,62 @@ class uri
 	/// or 0 if the port number is not known.
 	private: static unsigned short well_known_port(::std::string const& scheme)
 	{
-		//TODO: incomplete
-		// See:
-		// - https://en.wikipedia.org/wiki/List_of_TCP_and_UDP_port_numbers
-		// - https://www.iana.org/assignments/uri-schemes.html
-		// - http://www.iana.org/assignments/port-numbers
+		return ::dcs::detail::uri_well_known_port(scheme.data(), scheme.size());
+	}
 
-		if (scheme == "ftp")
-		{
-			return 21;
-		}
-		else if (scheme == "ssh")
-		{
-			return 22;
-		}
-		else if (scheme == "telnet")
-		{
-			return 23;
-		}
-		else if (scheme == "http")
-		{
-			return 80;
-		}
-		else if (scheme == "nntp")
-		{
-			return 119;
-		}
-		else if (scheme == "ldap")
-		{
-			return 389;
-		}
-		else if (scheme == "https")
-		{
-			return 443;
-		}
-		else if (scheme == "rtsp")
+	/// URI-encodes the given string by escaping reserved and non-ASCII
+	/// characters.
+	public: static ::std::string encode(::std::string const& str, ::std::string const& reserved)
+	{
+		// Unreserved characters are never escaped; the other printable
+		// ASCII characters only if illegal or reserved
+		unsigned char const* classes(::dcs::detail::uri_chars().classes);
+		unsigned char safe[256];
+		for (int c = 0; c < 256; ++c)
 		{
-			return 554;
+			safe[c] = (c > 0x20 && c < 0x7f) ? 1 : 0;
 		}
-		else if (scheme == "sip")
+		for (::std::string::size_type i = 0; i < illegal_chars.size(); ++i)
 		{
-			return 5060;
+			safe[static_cast<unsigned char>(illegal_chars[i])] = 0;
 		}
-		else if (scheme == "sips")
+		for (::std::string::size_type i = 0; i < reserved.size(); ++i)
 		{
-			return 5061;
+			safe[static_cast<unsigned char>(reserved[i])] = 0;
 		}
-		else if (scheme == "xmpp")
+		for (int c = 0; c < 256; ++c)
 		{
-			return 5222;
+			safe[c] |= classes[c] & ::dcs::detail::uri_unreserved_char;
 		}
 
-		return invalid_port;
-	}
-
-	/// URI-encodes the given string by escaping reserved and non-ASCII
-	/// characters.
-	public: static ::std::string encode(::std::string const& str, ::std::string const& reserved)
-	{
-		typedef ::std::string::const_iterator string_iterator;
-
-		::std::ostringstream oss;
-		string_iterator end_it(str.end());
-		for (string_iterator it = str.begin(); it != end_it; ++it)
+		::std::string out(3*str.size(), '\0');
+		if (!out.empty())
 		{
-			char c = *it;
-			if (   (c >= 'a' && c <= 'z')
-				|| (c >= 'A' && c <= 'Z')
-				|| (c >= '0' && c <= '9')
-				|| c == '-'
-				|| c == '_'
-				|| c == '.'
-				|| c == '~')
-			{
-				oss << c;
-			}
-			else if (c <= 0x20 || c >= 0x7F || illegal_chars.find(c) != ::std::string::npos || reserved.find(c) != ::std::string::npos)
-			{
-				oss << '%' << ::std::setw(2) << ::std::hex << c;
-			}
-			else
-			{
-				oss << c;
-			}
+			char* const begin(&out[0]);
+			out.resize(::dcs::detail::uri_percent_encode(str.data(), str.data()+str.size(), begin, safe, 0xff)-begin);
 		}
 
-		return oss.str();
+		return out;
 	}
 
 	/// URI-decodes the given string by replacing percent-encoded
 	/// characters with the actual character.
 	public: static ::std::string decode(::std::string const& str)
 	{
-		typedef ::std::string::const_iterator string_iterator;
-
-		::std::ostringstream oss;
-
-		string_iterator it(str.begin());
-		string_iterator end_it(str.end());
-		while (it != end_it)
+		::std::string out(str);
+		if (!out.empty())
 		{
-			char c = *it++;
-			if (c == '%')
+			char* const begin(&out[0]);
+			char* const end(::dcs::detail::uri_percent_decode(begin, begin+out.size(), begin, false, false));
+			if (!end)
 			{
-				if (it == end_it)
-				{
-					DCS_EXCEPTION_THROW(::std::logic_error,
-										"No hex digit following percent sign: " + str);
-				}
-
-				char hi = *it++;
-				if (it == end_it)
-				{
-					DCS_EXCEPTION_THROW(::std::logic_error,
-										"Two hex digits must follow percent sign: " + str);
-				}
-
-				char lo = *it++;
-				if (hi >= '0' && hi <= '9')
-				{
-					c = hi - '0';
-				}
-				else if (hi >= 'A' && hi <= 'F')
-				{
-					c = hi - 'A' + 10;
-				}
-				else if (hi >= 'a' && hi <= 'f')
-				{
-					c = hi - 'a' + 10;
-				}
-				else
-				{
-					DCS_EXCEPTION_THROW(::std::logic_error,
-										"Not a hex digit");
-				}
-				c *= 16;
-				if (lo >= '0' && lo <= '9')
-				{
-					c += lo - '0';
-				}
-				else if (lo >= 'A' && lo <= 'F')
-				{
-					c += lo - 'A' + 10;
-				}
-				else if (lo >= 'a' && lo <= 'f')
-				{
-					c += lo - 'a' + 10;
-				}
-				else
-				{
-					DCS_EXCEPTION_THROW(::std::logic_error,
-										"Not a hex digit");
-				}
+				DCS_EXCEPTION_THROW(::std::logic_error,
+									"Two hex digits must follow percent sign: " + str);
 			}
-			oss << c;
+			out.resize(end-begin);
 		}
 
-		return oss.str();
+		return out;
 	}
 
 	/// Places the single path segments (delimited by slashes) into the
@@ -0,0 +1,358 @@
+/**
+ * \file dcs/uri_query.hpp
+ *
+ * \brief Lazy iteration over the parameters of a URI query.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_URI_QUERY_HPP
+#define DCS_URI_QUERY_HPP
+
+
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstring>
+#include <dcs/detail/uri.hpp>
+#include <iterator>
+#include <string>
+
+
+namespace dcs {
+
+/**
+ * A parameter of a URI query, that is a "key=value" pair (where "=value" may
+ * be missing).
+ *
+ * The key and the value are views of the (percent-encoded) query, and are
+ * only decoded when asked for.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class uri_query_param
+{
+	public: typedef ::boost::string_ref string_ref_type;
+
+
+	public: uri_query_param()
+	: has_value_(false),
+	  plus_as_space_(true)
+	{
+	}
+
+	public: uri_query_param(string_ref_type raw_key, string_ref_type raw_value, bool has_value, bool plus_as_space)
+	: raw_key_(raw_key),
+	  raw_value_(raw_value),
+	  has_value_(has_value),
+	  plus_as_space_(plus_as_space)
+	{
+	}
+
+	/// Returns the key as it appears in the query.
+	public: string_ref_type raw_key() const
+	{
+		return raw_key_;
+	}
+
+	/// Returns the value as it appears in the query.
+	public: string_ref_type raw_value() const
+	{
+		return raw_value_;
+	}
+
+	/// Tells if the key is followed by "=" (possibly with an empty value).
+	public: bool has_value() const
+	{
+		return has_value_;
+	}
+
+	/**
+	 * Returns the decoded key.
+	 *
+	 * The returned view is either the raw key, if there is nothing to
+	 * decode, or \a buf, where the key is decoded.
+	 */
+	public: string_ref_type key(::std::string& buf) const
+	{
+		return decode(raw_key_, plus_as_space_, buf);
+	}
+
+	public: ::std::string key() const
+	{
+		::std::string buf;
+		return this->key(buf).to_string();
+	}
+
+	/**
+	 * Returns the decoded value.
+	 *
+	 * The returned view is either the raw value, if there is nothing to
+	 * decode, or \a buf, where the value is decoded.
+	 */
+	public: string_ref_type value(::std::string& buf) const
+	{
+		return decode(raw_value_, plus_as_space_, buf);
+	}
+
+	public: ::std::string value() const
+	{
+		::std::string buf;
+		return this->value(buf).to_string();
+	}
+
+	/// Tells if the decoded key equals \a key, without decoding the key.
+	public: bool key_equals(string_ref_type key) const
+	{
+		return ::dcs::detail::uri_percent_equal(raw_key_.data(), raw_key_.data()+raw_key_.size(), key.data(), key.size(), plus_as_space_);
+	}
+
+	private: static string_ref_type decode(string_ref_type raw, bool plus_as_space, ::std::string& buf)
+	{
+		if (raw.empty()
+			|| (!::std::memchr(raw.data(), '%', raw.size())
+				&& !(plus_as_space && ::std::memchr(raw.data(), '+', raw.size()))))
+		{
+			return raw;
+		}
+
+		buf.resize(raw.size());
+		char* const begin(&buf[0]);
+		buf.resize(::dcs::detail::uri_percent_decode(raw.data(), raw.data()+raw.size(), begin, plus_as_space, true)-begin);
+
+		return string_ref_type(buf.data(), buf.size());
+	}
+
+
+	private: string_ref_type raw_key_;
+	private: string_ref_type raw_value_;
+	private: bool has_value_;
+	private: bool plus_as_space_;
+}; // uri_query_param
+
+
+/**
+ * A view of the parameters of a (percent-encoded) URI query, such as
+ * "q=a+b&lang=en&debug".
+ *
+ * Parameters are separated by "&" (empty ones are skipped), and are split
+ * into key and value by the first "=".
+ * Iterating only locates the parameters; keys and values are decoded on
+ * demand (see uri_query_param).
+ * By default, "+" is decoded as a space, as in HTML form data.
+ *
+ * The query must outlive the view.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class uri_query_view
+{
+	public: typedef ::boost::string_ref string_ref_type;
+
+	public: class const_iterator
+	{
+		public: typedef ::std::forward_iterator_tag iterator_category;
+		public: typedef uri_query_param value_type;
+		public: typedef ::std::ptrdiff_t difference_type;
+		public: typedef uri_query_param const* pointer;
+		public: typedef uri_query_param const& reference;
+
+
+		public: const_iterator()
+		: cur_(0),
+		  next_(0),
+		  last_(0),
+		  plus_as_space_(true)
+		{
+		}
+
+		public: const_iterator(char const* first, char const* last, bool plus_as_space)
+		: cur_(first),
+		  next_(first),
+		  last_(last),
+		  plus_as_space_(plus_as_space)
+		{
+			this->advance();
+		}
+
+		public: reference operator*() const
+		{
+			return param_;
+		}
+
+		public: pointer operator->() const
+		{
+			return &param_;
+		}
+
+		public: const_iterator& operator++()
+		{
+			this->advance();
+			return *this;
+		}
+
+		public: const_iterator operator++(int)
+		{
+			const_iterator tmp(*this);
+			this->advance();
+			return tmp;
+		}
+
+		public: friend bool operator==(const_iterator const& a, const_iterator const& b)
+		{
+			return a.cur_ == b.cur_;
+		}
+
+		public: friend bool operator!=(const_iterator const& a, const_iterator const& b)
+		{
+			return a.cur_ != b.cur_;
+		}
+
+		private: void advance()
+		{
+			while (next_ != last_ && *next_ == '&')
+			{
+				++next_;
+			}
+			cur_ = next_;
+			if (cur_ == last_)
+			{
+				param_ = uri_query_param();
+				return;
+			}
+
+			char const* end(static_cast<char const*>(::std::memchr(cur_, '&', last_-cur_)));
+			if (!end)
+			{
+				end = last_;
+			}
+			char const* eq(static_cast<char const*>(::std::memchr(cur_, '=', end-cur_)));
+			if (eq)
+			{
+				param_ = uri_query_param(string_ref_type(cur_, eq-cur_), string_ref_type(eq+1, end-eq-1), true, plus_as_space_);
+			}
+			else
+			{
+				param_ = uri_query_param(string_ref_type(cur_, end-cur_), string_ref_type(end, 0), false, plus_as_space_);
+			}
+			next_ = end;
+		}
+
+
+		private: char const* cur_; ///< The beginning of the current parameter
+		private: char const* next_; ///< The end of the current parameter
+		private: char const* last_;
+		private: bool plus_as_space_;
+		private: uri_query_param param_;
+	}; // const_iterator
+
+
+	public: uri_query_view()
+	: plus_as_space_(true)
+	{
+	}
+
+	public: explicit uri_query_view(string_ref_type query, bool plus_as_space = true)
+	: query_(query),
+	  plus_as_space_(plus_as_space)
+	{
+	}
+
+	public: string_ref_type str() const
+	{
+		return query_;
+	}
+
+	public: const_iterator begin() const
+	{
+		return const_iterator(query_.data(), query_.data()+query_.size(), plus_as_space_);
+	}
+
+	public: const_iterator end() const
+	{
+		char const* last(query_.data()+query_.size());
+		return const_iterator(last, last, plus_as_space_);
+	}
+
+	/// Tells if the query has no parameters.
+	public: bool empty() const
+	{
+		return this->begin() == this->end();
+	}
+
+	/**
+	 * Returns the first parameter whose decoded key is \a key, or end() if
+	 * there is none.
+	 *
+	 * Keys are compared as they are decoded, and no value is decoded.
+	 */
+	public: const_iterator find(string_ref_type key) const
+	{
+		const_iterator it(this->begin());
+		const const_iterator end_it(this->end());
+		while (it != end_it && !it->key_equals(key))
+		{
+			++it;
+		}
+
+		return it;
+	}
+
+	/// Returns the number of parameters whose decoded key is \a key.
+	public: ::std::size_t count(string_ref_type key) const
+	{
+		::std::size_t n(0);
+		const const_iterator end_it(this->end());
+		for (const_iterator it = this->begin(); it != end_it; ++it)
+		{
+			if (it->key_equals(key))
+			{
+				++n;
+			}
+		}
+
+		return n;
+	}
+
+	/**
+	 * Looks up the first parameter whose decoded key is \a key and, if found,
+	 * sets \a value to its decoded value (using \a buf if needed, see
+	 * uri_query_param::value()).
+	 *
+	 * Returns \c false if there is no such parameter.
+	 */
+	public: bool get(string_ref_type key, string_ref_type& value, ::std::string& buf) const
+	{
+		const const_iterator it(this->find(key));
+		if (it == this->end())
+		{
+			return false;
+		}
+		value = it->value(buf);
+
+		return true;
+	}
+
+
+	private: string_ref_type query_;
+	private: bool plus_as_space_;
+}; // uri_query_view
+
+} // Namespace dcs
+
+#endif // DCS_URI_QUERY_HPP
@@ -0,0 +1,981 @@
+/**
+ * \file dcs/uri_view.hpp
+ *
+ * \brief A non-owning, allocation-free view of a URI, as specified by RFC 3986.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2014 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_URI_VIEW_HPP
+#define DCS_URI_VIEW_HPP
+
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/detail/uri.hpp>
+#include <dcs/digest/xxhash.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/uri_query.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs {
+
+namespace detail {
+
+/**
+ * Returns the first character in [first,last) of any of the classes in
+ * \a end_mask, or \a last if there is none, checking on the way that percent
+ * signs are followed by two hex digits.
+ * Returns a null pointer on a bad percent-encoding.
+ */
+inline char const* uri_scan(char const* first, char const* last, unsigned char end_mask)
+{
+	unsigned char const* classes(uri_chars().classes);
+
+	while (first != last)
+	{
+		const unsigned char cls(classes[static_cast<unsigned char>(*first)]);
+		if (cls & (end_mask | uri_percent_char))
+		{
+			if (cls & end_mask)
+			{
+				return first;
+			}
+			if ((last-first) < 3
+				|| !(classes[static_cast<unsigned char>(first[1])] & uri_hex_digit_char)
+				|| !(classes[static_cast<unsigned char>(first[2])] & uri_hex_digit_char))
+			{
+				return 0;
+			}
+			first += 3;
+		}
+		else
+		{
+			++first;
+		}
+	}
+
+	return first;
+}
+
+/**
+ * Copies [first,last) to \a out, normalizing percent-encodings as by section
+ * 6.2.2 of RFC 3986 (i.e., decoding unreserved characters and using
+ * upper-case hex digits for the others), and optionally converting letters
+ * to lower case.
+ * The input must have been validated by uri_scan(). Returns the new end of
+ * the output.
+ */
+inline char* uri_copy_normalized(char const* first, char const* last, char* out, bool lower)
+{
+	static const char hex_digits[] = "0123456789ABCDEF";
+	uri_char_table const& chars(uri_chars());
+
+	for (; first != last; ++first)
+	{
+		char c(*first);
+		if (c == '%')
+		{
+			const unsigned char v(static_cast<unsigned char>((chars.hex_values[static_cast<unsigned char>(first[1])] << 4)
+															 | chars.hex_values[static_cast<unsigned char>(first[2])]));
+			first += 2;
+			if (!(chars.classes[v] & uri_unreserved_char))
+			{
+				*out++ = '%';
+				*out++ = hex_digits[v >> 4];
+				*out++ = hex_digits[v & 0x0f];
+				continue;
+			}
+			c = static_cast<char>(v);
+		}
+		if (lower && c >= 'A' && c <= 'Z')
+		{
+			c = static_cast<char>(c-'A'+'a');
+		}
+		*out++ = c;
+	}
+
+	return out;
+}
+
+/**
+ * Removes the dot segments from the path in [first,last) in place, following
+ * the algorithm in section 5.2.4 of RFC 3986.
+ * Returns the new end of the path.
+ */
+inline char* uri_remove_dot_segments(char* first, char* last)
+{
+	// Output never overtakes input, so that they can share the buffer; the
+	// rules that replace a prefix of the input with "/" write the slash in
+	// the input itself
+	char* w(first);
+	char* r(first);
+	while (r != last)
+	{
+		const ::std::size_t n(last-r);
+
+		if (n >= 3 && r[0] == '.' && r[1] == '.' && r[2] == '/')
+		{
+			r += 3;
+		}
+		else if (n >= 2 && r[0] == '.' && r[1] == '/')
+		{
+			r += 2;
+		}
+		else if (n >= 3 && r[0] == '/' && r[1] == '.' && r[2] == '/')
+		{
+			r += 2;
+		}
+		else if (n == 2 && r[0] == '/' && r[1] == '.')
+		{
+			r[1] = '/';
+			r += 1;
+		}
+		else if ((n >= 4 && r[0] == '/' && r[1] == '.' && r[2] == '.' && r[3] == '/')
+				 || (n == 3 && r[0] == '/' && r[1] == '.' && r[2] == '.'))
+		{
+			if (n == 3)
+			{
+				r[2] = '/';
+			}
+			r += (n == 3) ? 2 : 3;
+			// Remove the last output segment and its leading slash
+			while (w != first && *--w != '/')
+			{
+			}
+		}
+		else if ((n == 1 && r[0] == '.') || (n == 2 && r[0] == '.' && r[1] == '.'))
+		{
+			r = last;
+		}
+		else
+		{
+			do
+			{
+				*w++ = *r++;
+			}
+			while (r != last && *r != '/');
+		}
+	}
+
+	return w;
+}
+
+/**
+ * Prefixes with "/." a path without authority that starts with "//" (which
+ * dot-segment removal may yield, e.g., from "/.//a"), so that it is not taken
+ * for an authority.
+ * Such a path is at least two characters shorter than before dot-segment
+ * removal, thus it can grow in place. Returns the new end of the path.
+ */
+inline char* uri_protect_path(char* first, char* last)
+{
+	if ((last-first) >= 2 && first[0] == '/' && first[1] == '/')
+	{
+		::std::memmove(first+2, first, last-first);
+		first[0] = '/';
+		first[1] = '.';
+		last += 2;
+	}
+
+	return last;
+}
+
+inline char* uri_copy(char const* first, char const* last, char* out)
+{
+	const ::std::size_t n(last-first);
+	::std::memcpy(out, first, n);
+	return out+n;
+}
+
+} // Namespace detail
+
+
+/**
+ * A view of a URI stored elsewhere, as specified by RFC 3986.
+ *
+ * Parsing makes a single pass over the characters and only records the
+ * offsets of the URI parts, so that no memory is allocated; the parsed
+ * characters must outlive the view.
+ * Parts are returned as they appear in the URI (e.g., percent-encoded);
+ * a host given as an IP literal keeps its square brackets.
+ *
+ * Unlike uri, the view distinguishes absent parts from empty ones (e.g.,
+ * "http://h/p?" has an empty query, while "http://h/p" has none), which
+ * matters for resolution.
+ *
+ * Normalization and resolution write the resulting URI into a string
+ * provided by the caller, whose capacity is reused across calls.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class uri_view
+{
+	public: typedef ::boost::string_ref string_ref_type;
+	private: typedef ::boost::uint32_t offset_type;
+
+	private: enum part_category
+	{
+		scheme_part = 0,
+		authority_part,
+		user_info_part,
+		host_part,
+		port_part,
+		path_part,
+		query_part,
+		fragment_part,
+		num_parts
+	};
+
+	private: enum flag_category
+	{
+		valid_flag = 0x01,
+		scheme_flag = 0x02,
+		authority_flag = 0x04,
+		user_info_flag = 0x08,
+		port_flag = 0x10,
+		query_flag = 0x20,
+		fragment_flag = 0x40
+	};
+
+
+	/// Creates an empty (and valid) URI view.
+	public: uri_view()
+	{
+		this->reset(0, 0);
+		flags_ = valid_flag;
+	}
+
+	/**
+	 * \brief Parses the URI in [\a first, \a last).
+	 *
+	 * Throws an exception if the given URI is not valid.
+	 */
+	public: uri_view(char const* first, char const* last)
+	{
+		if (!this->parse(first, last))
+		{
+			DCS_EXCEPTION_THROW(::std::logic_error,
+								"Invalid URI: " + ::std::string(first, last));
+		}
+	}
+
+	/**
+	 * \brief Parses the given null-terminated URI, which must outlive the view.
+	 *
+	 * Throws an exception if the given URI is not valid.
+	 */
+	public: explicit uri_view(char const* str)
+	{
+		if (!this->parse(str, str+::std::strlen(str)))
+		{
+			DCS_EXCEPTION_THROW(::std::logic_error,
+								"Invalid URI: " + ::std::string(str));
+		}
+	}
+
+	/**
+	 * \brief Parses the URI in the given string, which must outlive the view.
+	 *
+	 * Throws an exception if the given URI is not valid.
+	 */
+	public: explicit uri_view(::std::string const& str)
+	{
+		if (!this->parse(str.data(), str.data()+str.size()))
+		{
+			DCS_EXCEPTION_THROW(::std::logic_error,
+								"Invalid URI: " + str);
+		}
+	}
+
+	/**
+	 * \brief Parses the URI in [\a first, \a last).
+	 *
+	 * Returns \c false, and leaves the view invalid and empty, if the URI is
+	 * not valid (i.e., it contains a bad percent-encoding, a bad port number
+	 * or an unterminated IP literal).
+	 */
+	public: bool parse(char const* first, char const* last)
+	{
+		this->reset(first, last);
+		if (static_cast< ::std::size_t >(last-first) > static_cast<offset_type>(-1))
+		{
+			return this->fail();
+		}
+
+		unsigned char const* classes(detail::uri_chars().classes);
+		char const* p(first);
+
+		// Scheme
+		if (p != last && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z')))
+		{
+			char const* q(p+1);
+			while (q != last && (classes[static_cast<unsigned char>(*q)] & detail::uri_scheme_char))
+			{
+				++q;
+			}
+			if (q != last && *q == ':')
+			{
+				this->set(scheme_part, p, q, scheme_flag);
+				p = q+1;
+			}
+		}
+
+		// Authority
+		if ((last-p) >= 2 && p[0] == '/' && p[1] == '/')
+		{
+			p += 2;
+			char const* q(detail::uri_scan(p, last, detail::uri_authority_end_char));
+			if (!q)
+			{
+				return this->fail();
+			}
+			this->set(authority_part, p, q, authority_flag);
+
+			char const* h(q);
+			while (h != p && h[-1] != '@')
+			{
+				--h;
+			}
+			if (h != p)
+			{
+				this->set(user_info_part, p, h-1, user_info_flag);
+			}
+
+			char const* e(h);
+			if (e != q && *e == '[')
+			{
+				e = static_cast<char const*>(::std::memchr(e, ']', q-e));
+				if (!e)
+				{
+					return this->fail();
+				}
+				++e;
+				if (e != q && *e != ':')
+				{
+					return this->fail();
+				}
+			}
+			else
+			{
+				while (e != q && *e != ':')
+				{
+					++e;
+				}
+			}
+			this->set(host_part, h, e, 0);
+
+			if (e != q)
+			{
+				this->set(port_part, e+1, q, port_flag);
+				unsigned long port(0);
+				for (char const* d = e+1; d != q; ++d)
+				{
+					if (*d < '0' || *d > '9' || (port = port*10+(*d-'0')) > 0xffff)
+					{
+						return this->fail();
+					}
+				}
+				port_ = static_cast<unsigned short>(port);
+			}
+			p = q;
+		}
+
+		// Path
+		char const* q(detail::uri_scan(p, last, detail::uri_path_end_char));
+		if (!q)
+		{
+			return this->fail();
+		}
+		this->set(path_part, p, q, 0);
+		p = q;
+
+		// Query
+		if (p != last && *p == '?')
+		{
+			q = detail::uri_scan(++p, last, detail::uri_query_end_char);
+			if (!q)
+			{
+				return this->fail();
+			}
+			this->set(query_part, p, q, query_flag);
+			p = q;
+		}
+
+		// Fragment
+		if (p != last)
+		{
+			q = detail::uri_scan(++p, last, 0);
+			if (!q)
+			{
+				return this->fail();
+			}
+			this->set(fragment_part, p, q, fragment_flag);
+		}
+
+		flags_ |= valid_flag;
+
+		return true;
+	}
+
+	/// Tells if the last parse succeeded.
+	public: bool valid() const
+	{
+		return flags_ & valid_flag;
+	}
+
+	/// Returns the whole URI.
+	public: string_ref_type str() const
+	{
+		return string_ref_type(data_, length_);
+	}
+
+	public: bool has_scheme() const
+	{
+		return flags_ & scheme_flag;
+	}
+
+	public: bool has_authority() const
+	{
+		return flags_ & authority_flag;
+	}
+
+	public: bool has_user_info() const
+	{
+		return flags_ & user_info_flag;
+	}
+
+	public: bool has_port() const
+	{
+		return flags_ & port_flag;
+	}
+
+	public: bool has_query() const
+	{
+		return flags_ & query_flag;
+	}
+
+	public: bool has_fragment() const
+	{
+		return flags_ & fragment_flag;
+	}
+
+	/// Returns the scheme part of the URI (not converted to lower case).
+	public: string_ref_type scheme() const
+	{
+		return this->part(scheme_part);
+	}
+
+	/// Returns the authority part (user-info, host and port) of the URI.
+	public: string_ref_type authority() const
+	{
+		return this->part(authority_part);
+	}
+
+	public: string_ref_type user_info() const
+	{
+		return this->part(user_info_part);
+	}
+
+	public: string_ref_type host() const
+	{
+		return this->part(host_part);
+	}
+
+	/**
+	 * Returns the port number part of the URI.
+	 *
+	 * If no port number has been specified, the well-known port number of
+	 * the scheme is returned, if known, and 0 otherwise.
+	 */
+	public: unsigned short port() const
+	{
+		if (this->has_port() && size_[port_part] > 0)
+		{
+			return port_;
+		}
+
+		return this->well_known_port();
+	}
+
+	public: string_ref_type path() const
+	{
+		return this->part(path_part);
+	}
+
+	/// Returns the (percent-encoded) query part of the URI.
+	public: string_ref_type query() const
+	{
+		return this->part(query_part);
+	}
+
+	/// Returns a view of the parameters of the query part of the URI.
+	public: uri_query_view query_params(bool plus_as_space = true) const
+	{
+		return uri_query_view(this->part(query_part), plus_as_space);
+	}
+
+	public: string_ref_type fragment() const
+	{
+		return this->part(fragment_part);
+	}
+
+	/// Tells if the URI is a relative reference (i.e., it has no scheme).
+	public: bool relative() const
+	{
+		return !this->has_scheme();
+	}
+
+	public: bool empty() const
+	{
+		return length_ == 0;
+	}
+
+	/**
+	 * Writes the normalized URI into \a out, replacing its content.
+	 *
+	 * The normalizations of sections 6.2.2 and 6.2.3 of RFC 3986 are applied:
+	 *   * scheme and host are converted to lower case;
+	 *   * percent-encoded unreserved characters are decoded, and the other
+	 *     percent-encodings use upper-case hex digits;
+	 *   * dot segments are removed from the path, unless it is a relative
+	 *     path (whose dot segments are only meaningful against a base);
+	 *   * an empty or well-known port is removed;
+	 *   * an empty path following an authority becomes "/".
+	 */
+	public: void normalize(::std::string& out) const
+	{
+		// pre: valid()
+		DCS_ASSERT(this->valid(),
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot normalize an invalid URI"));
+
+		// Normalization never makes an URI longer, except for the "/" path
+		out.resize(length_+1);
+		char* const begin(&out[0]);
+		char* o(begin);
+
+		if (this->has_scheme())
+		{
+			o = detail::uri_copy_normalized(this->part_begin(scheme_part), this->part_end(scheme_part), o, true);
+			*o++ = ':';
+		}
+		if (this->has_authority())
+		{
+			*o++ = '/';
+			*o++ = '/';
+			if (this->has_user_info())
+			{
+				o = detail::uri_copy_normalized(this->part_begin(user_info_part), this->part_end(user_info_part), o, false);
+				*o++ = '@';
+			}
+			o = detail::uri_copy_normalized(this->part_begin(host_part), this->part_end(host_part), o, true);
+			if (this->has_port() && size_[port_part] > 0 && port_ != this->well_known_port())
+			{
+				char digits[5];
+				int n(0);
+				unsigned int port(port_);
+				do
+				{
+					digits[n++] = static_cast<char>('0'+port % 10);
+					port /= 10;
+				}
+				while (port > 0);
+				*o++ = ':';
+				while (n > 0)
+				{
+					*o++ = digits[--n];
+				}
+			}
+		}
+
+		char* const path(o);
+		o = detail::uri_copy_normalized(this->part_begin(path_part), this->part_end(path_part), o, false);
+		if (this->has_scheme() || this->has_authority() || (path != o && *path == '/'))
+		{
+			o = detail::uri_remove_dot_segments(path, o);
+		}
+		if (this->has_authority())
+		{
+			if (path == o)
+			{
+				*o++ = '/';
+			}
+		}
+		else
+		{
+			o = detail::uri_protect_path(path, o);
+		}
+
+		if (this->has_query())
+		{
+			*o++ = '?';
+			o = detail::uri_copy_normalized(this->part_begin(query_part), this->part_end(query_part), o, false);
+		}
+		if (this->has_fragment())
+		{
+			*o++ = '#';
+			o = detail::uri_copy_normalized(this->part_begin(fragment_part), this->part_end(fragment_part), o, false);
+		}
+
+		out.resize(o-begin);
+	}
+
+	/**
+	 * Resolves the reference \a ref against this (base) URI and writes the
+	 * resulting URI into \a out, replacing its content.
+	 *
+	 * See section 5.2 of RFC 3986 for the algorithm used; parts are copied as
+	 * they are, without normalization.
+	 */
+	public: void resolve(uri_view const& ref, ::std::string& out) const
+	{
+		// pre: valid() && ref.valid()
+		DCS_ASSERT(this->valid() && ref.valid(),
+				   DCS_EXCEPTION_THROW(::std::logic_error,
+									   "Cannot resolve invalid URIs"));
+
+		// The target is made of parts of both, plus at most a "/" from merging paths
+		out.resize(length_+ref.length_+1);
+		char* const begin(&out[0]);
+		char* o(begin);
+
+		uri_view const& scheme_src(ref.has_scheme() ? ref : *this);
+		if (scheme_src.has_scheme())
+		{
+			o = detail::uri_copy(scheme_src.part_begin(scheme_part), scheme_src.part_end(scheme_part), o);
+			*o++ = ':';
+		}
+
+		uri_view const& auth_src((ref.has_scheme() || ref.has_authority()) ? ref : *this);
+		if (auth_src.has_authority())
+		{
+			*o++ = '/';
+			*o++ = '/';
+			o = detail::uri_copy(auth_src.part_begin(authority_part), auth_src.part_end(authority_part), o);
+		}
+
+		uri_view const* query_src(&ref);
+		char* const path(o);
+		if (&auth_src == &ref)
+		{
+			o = detail::uri_remove_dot_segments(path, detail::uri_copy(ref.part_begin(path_part), ref.part_end(path_part), o));
+		}
+		else if (ref.size_[path_part] == 0)
+		{
+			o = detail::uri_copy(this->part_begin(path_part), this->part_end(path_part), o);
+			if (!ref.has_query())
+			{
+				query_src = this;
+			}
+		}
+		else
+		{
+			if (*ref.part_begin(path_part) != '/')
+			{
+				// Merge with the base path, up to its last slash
+				if (this->has_authority() && size_[path_part] == 0)
+				{
+					*o++ = '/';
+				}
+				else
+				{
+					char const* e(this->part_end(path_part));
+					while (e != this->part_begin(path_part) && e[-1] != '/')
+					{
+						--e;
+					}
+					o = detail::uri_copy(this->part_begin(path_part), e, o);
+				}
+			}
+			o = detail::uri_remove_dot_segments(path, detail::uri_copy(ref.part_begin(path_part), ref.part_end(path_part), o));
+		}
+
+		if (!auth_src.has_authority())
+		{
+			o = detail::uri_protect_path(path, o);
+		}
+
+		if (query_src->has_query())
+		{
+			*o++ = '?';
+			o = detail::uri_copy(query_src->part_begin(query_part), query_src->part_end(query_part), o);
+		}
+		if (ref.has_fragment())
+		{
+			*o++ = '#';
+			o = detail::uri_copy(ref.part_begin(fragment_part), ref.part_end(fragment_part), o);
+		}
+
+		out.resize(o-begin);
+	}
+
+	private: void reset(char const* first, char const* last)
+	{
+		data_ = first;
+		length_ = static_cast<offset_type>(last-first);
+		::std::memset(first_, 0, sizeof(first_));
+		::std::memset(size_, 0, sizeof(size_));
+		flags_ = 0;
+		port_ = 0;
+	}
+
+	private: bool fail()
+	{
+		this->reset(0, 0);
+		return false;
+	}
+
+	private: void set(part_category part, char const* first, char const* last, unsigned int flag)
+	{
+		first_[part] = static_cast<offset_type>(first-data_);
+		size_[part] = static_cast<offset_type>(last-first);
+		flags_ |= flag;
+	}
+
+	private: char const* part_begin(part_category part) const
+	{
+		return data_+first_[part];
+	}
+
+	private: char const* part_end(part_category part) const
+	{
+		return data_+first_[part]+size_[part];
+	}
+
+	private: string_ref_type part(part_category part) const
+	{
+		return string_ref_type(data_+first_[part], size_[part]);
+	}
+
+	private: unsigned short well_known_port() const
+	{
+		// Schemes are short: compare their lower-case form
+		char scheme[8];
+		const ::std::size_t n(size_[scheme_part]);
+		if (n > sizeof(scheme))
+		{
+			return 0;
+		}
+		char const* s(this->part_begin(scheme_part));
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			scheme[i] = (s[i] >= 'A' && s[i] <= 'Z') ? static_cast<char>(s[i]-'A'+'a') : s[i];
+		}
+		return detail::uri_well_known_port(scheme, n);
+	}
+
+
+	private: char const* data_;
+	private: offset_type length_; ///< The length of the URI
+	private: offset_type first_[num_parts]; ///< The offset of each part
+	private: offset_type size_[num_parts]; ///< The length of each part
+	private: unsigned int flags_;
+	private: unsigned short port_;
+}; // uri_view
+
+
+/**
+ * Parses each URI in [\a first, \a last) (a range of strings, such as
+ * \c std::string or \c boost::string_ref) into \a views, whose previous
+ * content is replaced (but whose capacity is reused).
+ *
+ * Invalid URIs give invalid views. Returns the number of invalid URIs.
+ */
+template <typename FwdIterT>
+::std::size_t parse_uri_views(FwdIterT first, FwdIterT last, ::std::vector<uri_view>& views)
+{
+	::std::size_t num_invalid(0);
+
+	views.clear();
+	for (; first != last; ++first)
+	{
+		views.push_back(uri_view());
+		if (!views.back().parse(first->data(), first->data()+first->size()))
+		{
+			++num_invalid;
+		}
+	}
+
+	return num_invalid;
+}
+
+/**
+ * Parses each line in [\a first, \a last) (e.g., a column of URIs extracted
+ * from an access log) into \a views, whose previous content is replaced (but
+ * whose capacity is reused).
+ *
+ * Lines end with "\n" or "\r\n"; a final empty line is ignored.
+ * Invalid URIs give invalid views. Returns the number of invalid URIs.
+ */
+inline ::std::size_t parse_uri_lines(char const* first, char const* last, ::std::vector<uri_view>& views)
+{
+	::std::size_t num_invalid(0);
+
+	views.clear();
+	while (first != last)
+	{
+		char const* eol(static_cast<char const*>(::std::memchr(first, '\n', last-first)));
+		char const* next(eol ? eol+1 : last);
+		if (!eol)
+		{
+			eol = last;
+		}
+		if (eol != first && eol[-1] == '\r')
+		{
+			--eol;
+		}
+
+		views.push_back(uri_view());
+		if (!views.back().parse(first, eol))
+		{
+			++num_invalid;
+		}
+		first = next;
+	}
+
+	return num_invalid;
+}
+
+
+/**
+ * A cache of normalized URIs, for inputs (like access logs) where the same
+ * URIs occur many times.
+ *
+ * The cache has a fixed number of slots, each holding an URI and its
+ * normalized form, and an URI can only be stored in the slot given by its
+ * hash value (a later URI with the same slot replaces it).
+ * Slots reuse their strings, so that memory is only allocated while the
+ * cache warms up.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class uri_normalization_cache: private ::boost::noncopyable
+{
+	private: struct slot
+	{
+		slot()
+		: used(false)
+		{
+		}
+
+		bool used;
+		::std::string key; ///< The URI as given
+		::std::string value; ///< The normalized URI
+		uri_view view; ///< The view of the normalized URI
+	}; // slot
+
+
+	/// Creates a cache with at least \a capacity slots.
+	public: explicit uri_normalization_cache(::std::size_t capacity = 4096)
+	: num_hits_(0),
+	  num_misses_(0)
+	{
+		::std::size_t n(1);
+		while (n < capacity)
+		{
+			n *= 2;
+		}
+		slots_.resize(n);
+	}
+
+	/**
+	 * Returns the view of the normalized form of the URI in [\a first,
+	 * \a last), which stays valid until the slot is reused.
+	 *
+	 * The view is invalid if the URI is invalid.
+	 */
+	public: uri_view const& normalize(char const* first, char const* last)
+	{
+		const ::std::size_t n(last-first);
+		slot& s(slots_[static_cast< ::std::size_t >(::dcs::digest::xxh3_algorithm::hash(reinterpret_cast< ::dcs::digest::byte_type const* >(first), n)) & (slots_.size()-1)]);
+
+		if (s.used && s.key.size() == n && ::std::memcmp(s.key.data(), first, n) == 0)
+		{
+			++num_hits_;
+			return s.view;
+		}
+
+		++num_misses_;
+		s.used = true;
+		s.key.assign(first, last);
+		if (s.view.parse(first, last))
+		{
+			s.view.normalize(s.value);
+			s.view.parse(s.value.data(), s.value.data()+s.value.size());
+		}
+
+		return s.view;
+	}
+
+	public: uri_view const& normalize(::std::string const& str)
+	{
+		return this->normalize(str.data(), str.data()+str.size());
+	}
+
+	public: ::std::size_t capacity() const
+	{
+		return slots_.size();
+	}
+
+	public: ::std::size_t num_hits() const
+	{
+		return num_hits_;
+	}
+
+	public: ::std::size_t num_misses() const
+	{
+		return num_misses_;
+	}
+
+	public: void clear()
+	{
+		for (::std::size_t i = 0; i < slots_.size(); ++i)
+		{
+			slots_[i].used = false;
+		}
+		num_hits_ = num_misses_ = 0;
+	}
+
+
+	private: ::std::vector<slot> slots_;
+	private: ::std::size_t num_hits_;
+	private: ::std::size_t num_misses_;
+}; // uri_normalization_cache
+
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, uri_view const& u)
+{
+	os << u.str();
+
+	return os;
+}
+
+} // Namespace dcs
+
+#endif // DCS_URI_VIEW_HPP
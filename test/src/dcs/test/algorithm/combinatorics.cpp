@@ -1,10 +1,16 @@
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <cstddef>
 #include <dcs/algorithm/combinatorics.hpp>
+#include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
 #include <dcs/test.hpp>
 #include <iostream>
+#include <set>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace /*<unnamed>*/ {
@@ -48,6 +54,89 @@ template <typename CharT, typename CharTraitsT, typename ElemT>
     return os;
 }
 
+/// Stores every combination visited by for_each_combination.
+struct combination_collector
+{
+	explicit combination_collector(::std::vector< ::std::vector< ::std::size_t > >& combs)
+	: p_combs(&combs)
+	{
+	}
+
+	template <typename IterT>
+	bool operator()(IterT first, IterT last)
+	{
+		p_combs->push_back(::std::vector< ::std::size_t >(first, last));
+		return false;
+	}
+
+	::std::vector< ::std::vector< ::std::size_t > >* p_combs;
+};
+
+/**
+ * Collects the complete prefixes; prefixes of size less than \c size_ whose
+ * last element is \c skip_ are pruned and the enumeration stops after
+ * \c stop_after_ complete prefixes.
+ */
+struct prefix_collector
+{
+	prefix_collector(::std::size_t size,
+					 ::std::vector< ::std::vector< ::std::size_t > >& objs,
+					 ::std::size_t skip = ::std::size_t(-1),
+					 ::std::size_t stop_after = ::std::size_t(-1))
+	: size_(size),
+	  skip_(skip),
+	  stop_after_(stop_after),
+	  p_objs(&objs)
+	{
+	}
+
+	template <typename IterT>
+	dcs::algorithm::prefix_visit_action operator()(IterT first, IterT last)
+	{
+		const ::std::vector< ::std::size_t > prefix(first, last);
+
+		if (prefix.size() < size_)
+		{
+			return prefix.back() == skip_ ? dcs::algorithm::skip_prefix_visit_action
+										  : dcs::algorithm::descend_prefix_visit_action;
+		}
+
+		p_objs->push_back(prefix);
+
+		return p_objs->size() == stop_after_ ? dcs::algorithm::stop_prefix_visit_action
+											 : dcs::algorithm::descend_prefix_visit_action;
+	}
+
+	template <typename IterT>
+	dcs::algorithm::prefix_visit_action operator()(IterT first, IterT last, ::std::size_t num_subsets)
+	{
+		DCS_ASSERT(num_subsets == (first == last ? 0 : (*::std::max_element(first, last)+1)),
+				   DCS_EXCEPTION_THROW(::std::logic_error, "Wrong number of subsets"));
+
+		return (*this)(first, last);
+	}
+
+	::std::size_t size_;
+	::std::size_t skip_;
+	::std::size_t stop_after_;
+	::std::vector< ::std::vector< ::std::size_t > >* p_objs;
+};
+
+/// The objects none of whose elements but the last is equal to \a skip.
+::std::vector< ::std::vector< ::std::size_t > > unpruned(::std::vector< ::std::vector< ::std::size_t > > const& objs, ::std::size_t skip)
+{
+	::std::vector< ::std::vector< ::std::size_t > > res;
+	for (::std::size_t i = 0; i < objs.size(); ++i)
+	{
+		if (objs[i].empty() || ::std::find(objs[i].begin(), objs[i].end()-1, skip) == (objs[i].end()-1))
+		{
+			res.push_back(objs[i]);
+		}
+	}
+
+	return res;
+}
+
 } // Namespace <unnamed>
 
 DCS_TEST_DEF( test_partition_class )
@@ -795,6 +884,628 @@ DCS_TEST_DEF( test_k_subset_class )
 	}
 }
 
+DCS_TEST_DEF( test_subset_rank )
+{
+	DCS_TEST_TRACE( "Test case: Subset - Rank/Unrank" );
+
+	const ::std::size_t sz(5);
+
+	for (int e = 0; e < 2; ++e)
+	{
+		dcs::algorithm::lexicographic_subset subset(sz, e == 0);
+
+		::std::size_t r(0);
+		while (subset.has_next())
+		{
+			DCS_TEST_CHECK_EQ( subset.rank(), r );
+
+			dcs::algorithm::lexicographic_subset other(sz, e == 0);
+			other.unrank(r);
+			DCS_TEST_CHECK( other() == subset() );
+
+			++subset;
+			++r;
+		}
+		DCS_TEST_CHECK_EQ( r, subset.count() );
+	}
+}
+
+DCS_TEST_DEF( test_k_subset_rank )
+{
+	DCS_TEST_TRACE( "Test case: k-Subset - Rank/Unrank" );
+
+	const ::std::size_t sz(6);
+
+	for (::std::size_t k = 1; k <= sz; ++k)
+	{
+		dcs::algorithm::lexicographic_k_subset subset(sz, k);
+
+		::std::size_t r(0);
+		while (subset.has_next())
+		{
+			DCS_TEST_CHECK_EQ( subset.rank(), r );
+
+			dcs::algorithm::lexicographic_k_subset other(sz, k);
+			other.unrank(r);
+			DCS_TEST_CHECK( ::std::equal(subset.begin(), subset.end(), other.begin()) );
+
+			++subset;
+			++r;
+		}
+		DCS_TEST_CHECK_EQ( r, subset.count() );
+	}
+}
+
+DCS_TEST_DEF( test_partition_rank )
+{
+	DCS_TEST_TRACE( "Test case: Partition - Rank/Unrank" );
+
+	const ::std::size_t sz(6);
+
+	dcs::algorithm::lexicographic_partition part(sz);
+
+	// Bell number B(6)
+	DCS_TEST_CHECK_EQ( part.count(), 203u );
+
+	::std::size_t r(0);
+	while (part.has_next())
+	{
+		DCS_TEST_CHECK_EQ( part.rank(), r );
+
+		dcs::algorithm::lexicographic_partition other(sz);
+		other.unrank(r);
+		DCS_TEST_CHECK( ::std::equal(part.begin(), part.end(), other.begin()) );
+		DCS_TEST_CHECK_EQ( other.num_subsets(), part.num_subsets() );
+
+		++part;
+		++r;
+	}
+	DCS_TEST_CHECK_EQ( r, part.count() );
+}
+
+DCS_TEST_DEF( test_k_partition_rank )
+{
+	DCS_TEST_TRACE( "Test case: k-Partition - Rank/Unrank" );
+
+	const ::std::size_t sz(6);
+
+	for (::std::size_t k = 1; k <= sz; ++k)
+	{
+		dcs::algorithm::lexicographic_k_partition part(sz, k);
+
+		::std::size_t r(0);
+		while (part.has_next())
+		{
+			DCS_TEST_CHECK_EQ( part.rank(), r );
+
+			dcs::algorithm::lexicographic_k_partition other(sz, k);
+			other.unrank(r);
+			DCS_TEST_CHECK( ::std::equal(part.begin(), part.end(), other.begin()) );
+
+			++part;
+			++r;
+		}
+		DCS_TEST_CHECK_EQ( r, part.count() );
+	}
+
+	// Stirling number of the second kind S(6,3)
+	DCS_TEST_CHECK_EQ( dcs::algorithm::lexicographic_k_partition(sz, 3).count(), 90u );
+}
+
+DCS_TEST_DEF( test_combination_rank )
+{
+	DCS_TEST_TRACE( "Test case: Combination - Rank/Unrank" );
+
+	const ::std::size_t n(7);
+	const ::std::size_t k(3);
+
+	::std::vector< ::std::size_t > pos(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pos[i] = i;
+	}
+
+	::std::vector< ::std::vector< ::std::size_t > > combs;
+	dcs::algorithm::for_each_combination(pos.begin(), pos.begin()+k, pos.end(), combination_collector(combs));
+
+	DCS_TEST_CHECK_EQ( combs.size(), dcs::algorithm::count_each_combination(pos.begin(), pos.begin()+k, pos.end()) );
+	for (::std::size_t r = 0; r < combs.size(); ++r)
+	{
+		DCS_TEST_CHECK_EQ( dcs::algorithm::rank_combination(combs[r].begin(), combs[r].end(), n), r );
+
+		::std::vector< ::std::size_t > c(k);
+		dcs::algorithm::unrank_combination(r, n, k, c.begin());
+		DCS_TEST_CHECK( c == combs[r] );
+	}
+}
+
+DCS_TEST_DEF( test_permutation_rank )
+{
+	DCS_TEST_TRACE( "Test case: Permutation - Rank/Unrank" );
+
+	const ::std::size_t n(6);
+	const ::std::size_t k(3);
+
+	const ::std::size_t count(dcs::algorithm::count_each_permutation< ::std::size_t >(k, n-k));
+
+	DCS_TEST_CHECK_EQ( count, 120u );
+
+	::std::vector< ::std::size_t > prev;
+	for (::std::size_t r = 0; r < count; ++r)
+	{
+		::std::vector< ::std::size_t > p(k);
+		dcs::algorithm::unrank_permutation(r, n, k, p.begin());
+
+		DCS_TEST_CHECK_EQ( dcs::algorithm::rank_permutation(p.begin(), p.end(), n), r );
+		// Permutations are in increasing lexicographic order
+		DCS_TEST_CHECK( prev < p );
+
+		prev = p;
+	}
+}
+
+
+DCS_TEST_DEF( test_reversible_permutation )
+{
+	DCS_TEST_TRACE( "Test case: Reversible Permutation" );
+
+	const ::std::size_t n(5);
+
+	::std::vector< ::std::size_t > pos(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pos[i] = i;
+	}
+	const ::std::vector< ::std::size_t > orig(pos);
+
+	for (::std::size_t k = 0; k <= n; ++k)
+	{
+		::std::vector< ::std::vector< ::std::size_t > > perms;
+		dcs::algorithm::for_each_reversible_permutation(pos.begin(), pos.begin()+k, pos.end(), combination_collector(perms));
+
+		DCS_TEST_CHECK_EQ( perms.size(), dcs::algorithm::count_each_reversible_permutation(pos.begin(), pos.begin()+k, pos.end()) );
+		DCS_TEST_CHECK( pos == orig );
+
+		// Each permutation is visited either as it is or reversed, but not both
+		::std::set< ::std::vector< ::std::size_t > > seen;
+		for (::std::size_t i = 0; i < perms.size(); ++i)
+		{
+			::std::vector< ::std::size_t > rev(perms[i].rbegin(), perms[i].rend());
+
+			DCS_TEST_CHECK( seen.count(perms[i]) == 0 );
+			DCS_TEST_CHECK( k < 2 || seen.count(rev) == 0 );
+
+			seen.insert(perms[i]);
+		}
+	}
+}
+
+DCS_TEST_DEF( test_gray_code_subset )
+{
+	DCS_TEST_TRACE( "Test case: Gray code Subset" );
+
+	const ::std::size_t sz(10);
+
+	dcs::algorithm::gray_code_subset subset(sz);
+
+	::std::vector<bool> seen(subset.count(), false);
+	::std::vector< ::std::size_t > prev;
+	::std::size_t r(0);
+	while (subset.has_next())
+	{
+		DCS_DEBUG_TRACE( "Subset: " << subset << " [size=" << subset.size() << "]" );
+
+		const ::std::vector< ::std::size_t > cur(subset());
+
+		DCS_TEST_CHECK_EQ( subset.rank(), r );
+		DCS_TEST_CHECK_EQ( cur.size(), subset.size() );
+
+		// Each subset is new and differs from the previous one by one element
+		::std::size_t mask(0);
+		for (::std::size_t i = 0; i < cur.size(); ++i)
+		{
+			mask |= ::std::size_t(1) << cur[i];
+		}
+		DCS_TEST_CHECK( !seen[mask] );
+		seen[mask] = true;
+		if (r > 0)
+		{
+			::std::vector< ::std::size_t > diff;
+			::std::set_symmetric_difference(prev.begin(), prev.end(), cur.begin(), cur.end(), ::std::back_inserter(diff));
+			DCS_TEST_CHECK_EQ( diff.size(), 1u );
+			DCS_TEST_CHECK_EQ( diff[0], subset.changed_element() );
+			DCS_TEST_CHECK_EQ( subset.added(), cur.size() > prev.size() );
+		}
+
+		dcs::algorithm::gray_code_subset other(sz);
+		other.unrank(r);
+		DCS_TEST_CHECK( other() == cur );
+
+		prev = cur;
+		++subset;
+		++r;
+	}
+	DCS_TEST_CHECK_EQ( r, subset.count() );
+
+	while (subset.has_prev())
+	{
+		--r;
+		DCS_TEST_CHECK_EQ( subset.rank(), r );
+		--subset;
+	}
+	DCS_TEST_CHECK_EQ( subset.size(), 0u );
+}
+
+DCS_TEST_DEF( test_multiword_k_subset )
+{
+	DCS_TEST_TRACE( "Test case: k-Subset - More elements than bits in a word" );
+
+	const ::std::size_t sz(150);
+	const ::std::size_t k(2);
+
+	dcs::algorithm::lexicographic_k_subset subset(sz, k);
+
+	// Reference colexicographic enumeration
+	::std::vector< ::std::size_t > ref(k);
+	for (::std::size_t i = 0; i < k; ++i)
+	{
+		ref[i] = i;
+	}
+
+	::std::size_t r(0);
+	while (subset.has_next())
+	{
+		DCS_TEST_CHECK( ::std::equal(ref.begin(), ref.end(), subset.begin()) );
+		DCS_TEST_CHECK_EQ( subset.mask().count(), k );
+		DCS_TEST_CHECK_EQ( subset.rank(), r );
+
+		++subset;
+		++r;
+
+		::std::size_t i(0);
+		while (i < (k-1) && (ref[i]+1) == ref[i+1])
+		{
+			++i;
+		}
+		++ref[i];
+		for (::std::size_t j = 0; j < i; ++j)
+		{
+			ref[j] = j;
+		}
+	}
+	DCS_TEST_CHECK_EQ( r, subset.count() );
+
+	while (subset.has_prev())
+	{
+		--r;
+		DCS_TEST_CHECK_EQ( subset.rank(), r );
+		--subset;
+	}
+	DCS_TEST_CHECK_EQ( subset.rank(), 0u );
+}
+
+DCS_TEST_DEF( test_multiword_subset )
+{
+	DCS_TEST_TRACE( "Test case: Subset - More elements than bits in a word" );
+
+	const ::std::size_t sz(130);
+
+	dcs::algorithm::lexicographic_subset subset(sz, false);
+
+	for (::std::size_t i = 0; i < 1000; ++i)
+	{
+		++subset;
+	}
+	DCS_TEST_CHECK_EQ( subset.rank(), 1000u );
+	DCS_TEST_CHECK_EQ( subset.size(), subset.mask().count() );
+
+	for (::std::size_t i = 0; i < 1000; ++i)
+	{
+		--subset;
+	}
+	DCS_TEST_CHECK_EQ( subset.size(), 1u );
+	DCS_TEST_CHECK_EQ( *subset.begin(), 0u );
+
+	// A bitmask view over several words
+	dcs::algorithm::bitmask_word_type words[3] = {0, 0, 0};
+	words[0] = 1;
+	words[1] = dcs::algorithm::bitmask_word_type(1) << 63;
+	words[2] = 2;
+	const dcs::algorithm::bitmask_view mask(words, sz);
+	const ::std::vector< ::std::size_t > pos(mask.begin(), mask.end());
+	DCS_TEST_CHECK_EQ( pos.size(), 3u );
+	DCS_TEST_CHECK_EQ( pos[0], 0u );
+	DCS_TEST_CHECK_EQ( pos[1], 127u );
+	DCS_TEST_CHECK_EQ( pos[2], 129u );
+	DCS_TEST_CHECK_EQ( *(mask.end()-1), 129u );
+	DCS_TEST_CHECK_EQ( mask.find_prev(129), 127u );
+	DCS_TEST_CHECK( mask.test(127) && !mask.test(128) );
+}
+
+
+DCS_TEST_DEF( test_revolving_door_k_subset )
+{
+	DCS_TEST_TRACE( "Test case: Revolving-door k-Subset" );
+
+	const ::std::size_t sz(7);
+
+	for (::std::size_t k = 0; k <= sz; ++k)
+	{
+		dcs::algorithm::revolving_door_k_subset subset(sz, k);
+
+		::std::set< ::std::vector< ::std::size_t > > seen;
+		::std::vector< ::std::size_t > prev;
+		while (subset.has_next())
+		{
+			const ::std::vector< ::std::size_t > cur(subset.begin(), subset.end());
+
+			DCS_TEST_CHECK( ::std::equal(cur.begin(), cur.end(), subset.mask().begin()) );
+			if (!seen.empty())
+			{
+				// The previous subset, with one element swapped in and one out
+				::std::set< ::std::size_t > expect(prev.begin(), prev.end());
+				DCS_TEST_CHECK_EQ( expect.erase(subset.removed_element()), 1u );
+				DCS_TEST_CHECK( expect.insert(subset.added_element()).second );
+				DCS_TEST_CHECK( ::std::equal(expect.begin(), expect.end(), cur.begin()) );
+			}
+			DCS_TEST_CHECK( seen.insert(cur).second );
+
+			prev = cur;
+			++subset;
+		}
+		DCS_TEST_CHECK_EQ( seen.size(), subset.count() );
+	}
+}
+
+template <typename PermutationT>
+static void check_swap_permutation(::std::size_t n, bool adjacent, DCS_TEST_CONTEXT_FUNC_PARAM)
+{
+	PermutationT perm(n);
+
+	::std::set< ::std::vector< ::std::size_t > > seen;
+	::std::vector< ::std::size_t > prev;
+	while (perm.has_next())
+	{
+		const ::std::vector< ::std::size_t > cur(perm.begin(), perm.end());
+
+		if (!seen.empty())
+		{
+			const ::std::pair< ::std::size_t, ::std::size_t > sw(perm.swapped());
+
+			::std::swap(prev[sw.first], prev[sw.second]);
+			DCS_TEST_CHECK( prev == cur );
+			if (adjacent)
+			{
+				DCS_TEST_CHECK_EQ( sw.second, sw.first+1 );
+			}
+		}
+		DCS_TEST_CHECK( seen.insert(cur).second );
+
+		prev = cur;
+		++perm;
+	}
+	DCS_TEST_CHECK_EQ( seen.size(), perm.count() );
+
+	perm.reset();
+	DCS_TEST_CHECK( perm.has_next() );
+	DCS_TEST_CHECK_EQ( *perm.begin(), 0u );
+}
+
+DCS_TEST_DEF( test_plain_change_permutation )
+{
+	DCS_TEST_TRACE( "Test case: Plain-change (Steinhaus-Johnson-Trotter) Permutation" );
+
+	for (::std::size_t n = 1; n <= 6; ++n)
+	{
+		check_swap_permutation<dcs::algorithm::plain_change_permutation>(n, true, DCS_TEST_CONTEXT_FUNC_ARG);
+	}
+}
+
+DCS_TEST_DEF( test_heap_permutation )
+{
+	DCS_TEST_TRACE( "Test case: Heap's Permutation" );
+
+	for (::std::size_t n = 1; n <= 6; ++n)
+	{
+		check_swap_permutation<dcs::algorithm::heap_permutation>(n, false, DCS_TEST_CONTEXT_FUNC_ARG);
+	}
+
+	const ::std::string s("abc");
+	dcs::algorithm::heap_permutation perm(s.size());
+	++perm;
+	const ::std::vector<char> v(perm(::std::vector<char>(s.begin(), s.end())));
+	DCS_TEST_CHECK_EQ( ::std::string(v.begin(), v.end()), ::std::string("bac") );
+}
+
+DCS_TEST_DEF( test_gray_code_partition )
+{
+	DCS_TEST_TRACE( "Test case: Gray code Partition" );
+
+	const ::std::size_t sz(6);
+
+	dcs::algorithm::gray_code_partition part(sz);
+
+	::std::set< ::std::vector< ::std::size_t > > seen;
+	::std::vector< ::std::size_t > prev;
+	while (part.has_next())
+	{
+		DCS_DEBUG_STREAM << part << " : " << part.num_subsets() << ::std::endl;
+
+		const ::std::vector< ::std::size_t > cur(part.begin(), part.end());
+
+		if (!seen.empty())
+		{
+			const ::std::size_t e(part.moved_element());
+
+			DCS_TEST_CHECK_EQ( prev[e], part.from_subset() );
+			DCS_TEST_CHECK_EQ( cur[e], part.to_subset() );
+
+			// Only the moved element changes subset: pairs of other elements
+			// are together in the previous partition iff they are in the
+			// current one
+			for (::std::size_t i = 0; i < sz; ++i)
+			{
+				for (::std::size_t j = i+1; j < sz; ++j)
+				{
+					if (i != e && j != e)
+					{
+						DCS_TEST_CHECK_EQ( prev[i] == prev[j], cur[i] == cur[j] );
+					}
+				}
+			}
+		}
+		DCS_TEST_CHECK( seen.insert(cur).second );
+
+		prev = cur;
+		++part;
+	}
+	DCS_TEST_CHECK_EQ( seen.size(), part.count() );
+}
+
+
+DCS_TEST_DEF( test_combination_prefix )
+{
+	DCS_TEST_TRACE( "Test case: Combination - Prefix visit" );
+
+	const ::std::size_t n(7);
+
+	::std::vector< ::std::size_t > pos(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pos[i] = i;
+	}
+	const ::std::vector< ::std::size_t > orig(pos);
+
+	for (::std::size_t k = 0; k <= n; ++k)
+	{
+		::std::vector< ::std::vector< ::std::size_t > > expect;
+		dcs::algorithm::for_each_combination(pos.begin(), pos.begin()+k, pos.end(), combination_collector(expect));
+
+		::std::vector< ::std::vector< ::std::size_t > > combs;
+		dcs::algorithm::for_each_combination_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, combs));
+		DCS_TEST_CHECK_EQ( combs.size(), dcs::algorithm::count_each_combination(pos.begin(), pos.begin()+k, pos.end()) );
+		DCS_TEST_CHECK( combs == expect );
+		DCS_TEST_CHECK( pos == orig );
+
+		combs.clear();
+		dcs::algorithm::for_each_combination_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, combs, 2));
+		DCS_TEST_CHECK( combs == unpruned(expect, 2) );
+		DCS_TEST_CHECK( pos == orig );
+
+		combs.clear();
+		dcs::algorithm::for_each_combination_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, combs, n, 3));
+		DCS_TEST_CHECK_EQ( combs.size(), ::std::min(expect.size(), ::std::size_t(3)) );
+		DCS_TEST_CHECK( pos == orig );
+	}
+}
+
+DCS_TEST_DEF( test_permutation_prefix )
+{
+	DCS_TEST_TRACE( "Test case: Permutation - Prefix visit" );
+
+	const ::std::size_t n(5);
+
+	::std::vector< ::std::size_t > pos(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pos[i] = i;
+	}
+	const ::std::vector< ::std::size_t > orig(pos);
+
+	for (::std::size_t k = 0; k <= n; ++k)
+	{
+		const ::std::size_t cnt(dcs::algorithm::count_each_permutation(pos.begin(), pos.begin()+k, pos.end()));
+
+		::std::vector< ::std::vector< ::std::size_t > > expect;
+		for (::std::size_t r = 0; r < cnt; ++r)
+		{
+			::std::vector< ::std::size_t > p(k);
+			dcs::algorithm::unrank_permutation(r, n, k, p.begin());
+			expect.push_back(p);
+		}
+
+		::std::vector< ::std::vector< ::std::size_t > > perms;
+		dcs::algorithm::for_each_permutation_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, perms));
+		DCS_TEST_CHECK_EQ( perms.size(), cnt );
+		DCS_TEST_CHECK( perms == expect );
+		DCS_TEST_CHECK( pos == orig );
+
+		perms.clear();
+		dcs::algorithm::for_each_permutation_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, perms, 1));
+		DCS_TEST_CHECK( perms == unpruned(expect, 1) );
+		DCS_TEST_CHECK( pos == orig );
+
+		perms.clear();
+		dcs::algorithm::for_each_permutation_prefix(pos.begin(), pos.begin()+k, pos.end(), prefix_collector(k, perms, n, 4));
+		DCS_TEST_CHECK_EQ( perms.size(), ::std::min(cnt, ::std::size_t(4)) );
+		DCS_TEST_CHECK( pos == orig );
+	}
+}
+
+DCS_TEST_DEF( test_partition_prefix )
+{
+	DCS_TEST_TRACE( "Test case: Partition - Prefix visit" );
+
+	const ::std::size_t n(6);
+
+	dcs::algorithm::lexicographic_partition part(n);
+
+	::std::vector< ::std::vector< ::std::size_t > > expect;
+	for (::std::size_t r = 0; r < part.count(); ++r)
+	{
+		part.unrank(r);
+		expect.push_back(::std::vector< ::std::size_t >(part.begin(), part.end()));
+	}
+
+	::std::vector< ::std::vector< ::std::size_t > > parts;
+	dcs::algorithm::for_each_partition_prefix(n, prefix_collector(n, parts));
+	DCS_TEST_CHECK_EQ( parts.size(), dcs::algorithm::count_each_partition(n) );
+	DCS_TEST_CHECK( parts == expect );
+
+	parts.clear();
+	dcs::algorithm::for_each_partition_prefix(n, prefix_collector(n, parts, 1));
+	DCS_TEST_CHECK( parts == unpruned(expect, 1) );
+
+	parts.clear();
+	dcs::algorithm::for_each_partition_prefix(n, prefix_collector(n, parts, n, 5));
+	DCS_TEST_CHECK_EQ( parts.size(), 5u );
+
+	parts.clear();
+	dcs::algorithm::for_each_partition_prefix(0, prefix_collector(0, parts));
+	DCS_TEST_CHECK_EQ( parts.size(), dcs::algorithm::count_each_partition(0) );
+}
+
+DCS_TEST_DEF( test_k_partition_prefix )
+{
+	DCS_TEST_TRACE( "Test case: k-Partition - Prefix visit" );
+
+	const ::std::size_t n(6);
+
+	for (::std::size_t k = 1; k <= n; ++k)
+	{
+		dcs::algorithm::lexicographic_k_partition part(n, k);
+
+		::std::vector< ::std::vector< ::std::size_t > > expect;
+		for (::std::size_t r = 0; r < part.count(); ++r)
+		{
+			part.unrank(r);
+			expect.push_back(::std::vector< ::std::size_t >(part.begin(), part.end()));
+		}
+
+		::std::vector< ::std::vector< ::std::size_t > > parts;
+		dcs::algorithm::for_each_k_partition_prefix(n, k, prefix_collector(n, parts));
+		DCS_TEST_CHECK_EQ( parts.size(), dcs::algorithm::count_each_k_partition(n, k) );
+		DCS_TEST_CHECK( parts == expect );
+
+		parts.clear();
+		dcs::algorithm::for_each_k_partition_prefix(n, k, prefix_collector(n, parts, 0));
+		DCS_TEST_CHECK( parts == unpruned(expect, 0) );
+	}
+
+	DCS_TEST_CHECK_EQ( dcs::algorithm::count_each_k_partition(n, 0), 0u );
+	DCS_TEST_CHECK_EQ( dcs::algorithm::count_each_k_partition(n, n+1), 0u );
+	DCS_TEST_CHECK_EQ( dcs::algorithm::count_each_k_partition(0, 0), 1u );
+}
 
 int main()
 {
@@ -816,5 +1527,23 @@ int main()
 		DCS_TEST_DO(test_next_subset_without_empty);
 		DCS_TEST_DO(test_prev_subset_without_empty);
 		DCS_TEST_DO(test_k_subset_class);
+		DCS_TEST_DO(test_subset_rank);
+		DCS_TEST_DO(test_k_subset_rank);
+		DCS_TEST_DO(test_partition_rank);
+		DCS_TEST_DO(test_k_partition_rank);
+		DCS_TEST_DO(test_combination_rank);
+		DCS_TEST_DO(test_permutation_rank);
+		DCS_TEST_DO(test_reversible_permutation);
+		DCS_TEST_DO(test_gray_code_subset);
+		DCS_TEST_DO(test_multiword_k_subset);
+		DCS_TEST_DO(test_multiword_subset);
+		DCS_TEST_DO(test_revolving_door_k_subset);
+		DCS_TEST_DO(test_plain_change_permutation);
+		DCS_TEST_DO(test_heap_permutation);
+		DCS_TEST_DO(test_gray_code_partition);
+		DCS_TEST_DO(test_combination_prefix);
+		DCS_TEST_DO(test_permutation_prefix);
+		DCS_TEST_DO(test_partition_prefix);
+		DCS_TEST_DO(test_k_partition_prefix);
 	DCS_TEST_END();
 }
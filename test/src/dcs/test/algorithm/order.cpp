@@ -1,8 +1,11 @@
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
 #include <dcs/algorithm/order.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/test.hpp>
+#include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -112,6 +115,164 @@ DCS_TEST_DEF( test_vector_comparator )
 	}
 }
 
+namespace /*<unnamed>*/ {
+
+/// Tells if the indices are a permutation that orders the given elements and,
+/// if \a stable is \c true, that keeps equivalent elements in their original
+/// order.
+template <typename T>
+bool is_order(::std::vector<T> const& v, ::std::vector< ::std::size_t > const& indices, bool stable)
+{
+	if (indices.size() != v.size())
+	{
+		return false;
+	}
+
+	::std::vector<bool> seen(v.size(), false);
+	for (::std::size_t i = 0; i < indices.size(); ++i)
+	{
+		if (indices[i] >= v.size() || seen[indices[i]])
+		{
+			return false;
+		}
+		seen[indices[i]] = true;
+
+		if (i > 0)
+		{
+			const ::std::size_t a(indices[i-1]);
+			const ::std::size_t b(indices[i]);
+
+			if (v[b] < v[a] || (stable && !(v[a] < v[b]) && b < a))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_radix_integer )
+{
+	DCS_DEBUG_TRACE("Test case: radix sort of integers");
+
+	const ::std::size_t n(5000);
+
+	::std::vector<int> v(n);
+	::std::vector<unsigned char> c(n);
+	::std::vector<long> l(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = ::std::rand() % 200 - 100;
+		c[i] = static_cast<unsigned char>(::std::rand());
+		l[i] = (i % 2 ? -1L : 1L)*static_cast<long>(::std::rand());
+	}
+	v[0] = ::std::numeric_limits<int>::min();
+	v[1] = ::std::numeric_limits<int>::max();
+
+	::std::vector< ::std::size_t > indices(n);
+
+	::dcs::algorithm::radix_order(v.begin(), v.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(v, indices, true) );
+
+	::dcs::algorithm::radix_order(c.begin(), c.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(c, indices, true) );
+
+	::dcs::algorithm::radix_order(l.begin(), l.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(l, indices, true) );
+
+	// Dispatched to radix sort
+	::dcs::algorithm::order(v.begin(), v.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(v, indices, true) );
+}
+
+
+DCS_TEST_DEF( test_radix_floating_point )
+{
+	DCS_DEBUG_TRACE("Test case: radix sort of floating-point numbers");
+
+	const ::std::size_t n(3000);
+
+	::std::vector<double> v(n);
+	::std::vector<float> f(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = (::std::rand() % 2001 - 1000)/7.0;
+		f[i] = static_cast<float>(v[i]*1.0e-30);
+	}
+	v[0] = -::std::numeric_limits<double>::infinity();
+	v[1] = ::std::numeric_limits<double>::infinity();
+	v[2] = ::std::numeric_limits<double>::denorm_min();
+	v[3] = -::std::numeric_limits<double>::denorm_min();
+	v[4] = ::std::numeric_limits<double>::max();
+	v[5] = -0.0;
+
+	::std::vector< ::std::size_t > indices(n);
+
+	::dcs::algorithm::radix_order(v.begin(), v.end(), indices.begin());
+	DCS_TEST_CHECK( v[indices.front()] == -::std::numeric_limits<double>::infinity() );
+	DCS_TEST_CHECK( v[indices.back()] == ::std::numeric_limits<double>::infinity() );
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		DCS_TEST_CHECK( !(v[indices[i]] < v[indices[i-1]]) );
+	}
+
+	::dcs::algorithm::radix_order(f.begin(), f.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(f, indices, true) );
+}
+
+
+DCS_TEST_DEF( test_key_index )
+{
+	DCS_DEBUG_TRACE("Test case: sort of key-index pairs");
+
+	const ::std::size_t n(3000);
+
+	::std::vector<int> v(n);
+	::std::vector<int const*> p(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = ::std::rand() % 100;
+		p[i] = &v[(i*7919) % n];
+	}
+
+	::std::vector< ::std::size_t > indices(n);
+
+	::dcs::algorithm::key_index_order(v.begin(), v.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(v, indices, false) );
+
+	::dcs::algorithm::order(v.begin(), v.end(), indices.begin(), ::std::greater<int>());
+	for (::std::size_t i = 1; i < n; ++i)
+	{
+		DCS_TEST_CHECK( v[indices[i-1]] >= v[indices[i]] );
+	}
+
+	// Dispatched to the sort of key-index pairs
+	::dcs::algorithm::order(p.begin(), p.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(p, indices, false) );
+}
+
+
+DCS_TEST_DEF( test_many_ties )
+{
+	DCS_DEBUG_TRACE("Test case: many equivalent elements");
+
+	const ::std::size_t n(2000);
+
+	::std::vector< ::std::string > v(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = ::std::string(1, static_cast<char>('a' + ::std::rand() % 5));
+	}
+
+	::std::vector< ::std::size_t > indices(n);
+	::dcs::algorithm::order(v.begin(), v.end(), indices.begin());
+	DCS_TEST_CHECK( is_order(v, indices, false) );
+}
+
 
 int main()
 {
@@ -122,6 +283,10 @@ int main()
 	DCS_TEST_DO(test_vector);
 	DCS_TEST_DO(test_carray);
 	DCS_TEST_DO(test_vector_comparator);
+	DCS_TEST_DO(test_radix_integer);
+	DCS_TEST_DO(test_radix_floating_point);
+	DCS_TEST_DO(test_key_index);
+	DCS_TEST_DO(test_many_ties);
 
 	DCS_TEST_END();
 }
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <dcs/algorithm/parallel_combinatorics.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/test.hpp>
+#include <vector>
+
+
+namespace /*<unnamed>*/ {
+
+/// Counts how many times each rank is visited.
+class rank_counter
+{
+	public: rank_counter(::std::size_t count, ::boost::mutex& mtx)
+	: p_hits_(new ::std::vector< ::std::size_t >(count, 0)),
+	  p_mtx_(&mtx),
+	  n_(0),
+	  permutation_(false)
+	{
+	}
+
+	public: template <typename GeneratorT>
+			bool operator()(GeneratorT const& gen) const
+	{
+		this->hit(gen.rank());
+		return false;
+	}
+
+	public: template <typename IterT>
+			bool operator()(IterT first, IterT mid) const
+	{
+		::std::vector< ::std::size_t > pos(first, mid);
+		this->hit(permutation_ ? ::dcs::algorithm::rank_permutation(pos.begin(), pos.end(), n_)
+							   : ::dcs::algorithm::rank_combination(pos.begin(), pos.end(), n_));
+		return false;
+	}
+
+	public: rank_counter& positions(::std::size_t n, bool permutation)
+	{
+		n_ = n;
+		permutation_ = permutation;
+		return *this;
+	}
+
+	public: bool all_once() const
+	{
+		return ::std::count(p_hits_->begin(), p_hits_->end(), 1u) == static_cast< ::std::ptrdiff_t >(p_hits_->size());
+	}
+
+	private: void hit(::std::size_t r) const
+	{
+		::boost::lock_guard< ::boost::mutex > lock(*p_mtx_);
+		++(*p_hits_)[r];
+	}
+
+
+	private: ::boost::shared_ptr< ::std::vector< ::std::size_t > > p_hits_;
+	private: ::boost::mutex* p_mtx_;
+	private: ::std::size_t n_;
+	private: bool permutation_;
+}; // rank_counter
+
+/// Stops the enumeration at a given rank.
+struct stop_at
+{
+	explicit stop_at(::std::size_t r)
+	: r(r)
+	{
+	}
+
+	template <typename GeneratorT>
+	bool operator()(GeneratorT const& gen) const
+	{
+		return gen.rank() == r;
+	}
+
+	::std::size_t r;
+}; // stop_at
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_generators )
+{
+	DCS_TEST_TRACE( "Test case: Parallel generators" );
+
+	namespace alg = ::dcs::algorithm;
+
+	const ::std::size_t n(7);
+	const ::std::size_t k(3);
+	const ::std::size_t num_threads(4);
+
+	::boost::mutex mtx;
+
+	rank_counter subs(alg::lexicographic_subset(n).count(), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_subset(n, true, subs, num_threads) );
+	DCS_TEST_CHECK( subs.all_once() );
+
+	rank_counter ksubs(alg::lexicographic_k_subset(n, k).count(), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_k_subset(n, k, ksubs, num_threads) );
+	DCS_TEST_CHECK( ksubs.all_once() );
+
+	rank_counter parts(alg::lexicographic_partition(n).count(), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_partition(n, parts, num_threads) );
+	DCS_TEST_CHECK( parts.all_once() );
+
+	rank_counter kparts(alg::lexicographic_k_partition(n, k).count(), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_k_partition(n, k, kparts, num_threads) );
+	DCS_TEST_CHECK( kparts.all_once() );
+
+	// More threads than objects
+	rank_counter few(alg::lexicographic_k_partition(n, n).count(), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_k_partition(n, n, few, num_threads) );
+	DCS_TEST_CHECK( few.all_once() );
+
+	DCS_TEST_CHECK( alg::parallel_for_each_partition(n, stop_at(100), num_threads) );
+}
+
+DCS_TEST_DEF( test_combinations_permutations )
+{
+	DCS_TEST_TRACE( "Test case: Parallel combinations and permutations" );
+
+	namespace alg = ::dcs::algorithm;
+
+	const ::std::size_t n(7);
+	const ::std::size_t k(3);
+	const ::std::size_t num_threads(3);
+
+	::std::vector< ::std::size_t > pos(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		pos[i] = i;
+	}
+
+	::boost::mutex mtx;
+
+	rank_counter combs(alg::count_each_combination(pos.begin(), pos.begin()+k, pos.end()), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_combination(pos.begin(), pos.begin()+k, pos.end(), combs.positions(n, false), num_threads) );
+	DCS_TEST_CHECK( combs.all_once() );
+
+	rank_counter perms(alg::count_each_permutation(pos.begin(), pos.begin()+k, pos.end()), mtx);
+	DCS_TEST_CHECK( !alg::parallel_for_each_permutation(pos.begin(), pos.begin()+k, pos.end(), perms.positions(n, true), num_threads) );
+	DCS_TEST_CHECK( perms.all_once() );
+
+	// The input range is left untouched
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ( pos[i], i );
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "Algorithms test suite: Parallel combinatorics" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO(test_generators);
+		DCS_TEST_DO(test_combinations_permutations);
+	DCS_TEST_END();
+}
@@ -0,0 +1,135 @@
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/algorithm/order.hpp>
+#include <dcs/algorithm/parallel_order.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/test.hpp>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace alg = ::dcs::algorithm;
+
+
+namespace /*<unnamed>*/ {
+
+/// Tells if the indices are a permutation that orders the given elements.
+template <typename T, typename ComparatorT>
+bool is_order(::std::vector<T> const& v, ::std::vector< ::std::size_t > const& indices, ComparatorT comp)
+{
+	::std::vector<bool> seen(v.size(), false);
+	for (::std::size_t i = 0; i < indices.size(); ++i)
+	{
+		if (indices[i] >= v.size() || seen[indices[i]])
+		{
+			return false;
+		}
+		seen[indices[i]] = true;
+
+		if (i > 0 && comp(v[indices[i]], v[indices[i-1]]))
+		{
+			return false;
+		}
+	}
+
+	return indices.size() == v.size();
+}
+
+/// Comparator that throws after a given number of comparisons.
+struct throwing_less
+{
+	explicit throwing_less(::std::size_t max_calls)
+	: calls(0),
+	  max_calls(max_calls)
+	{
+	}
+
+	bool operator()(double a, double b)
+	{
+		if (++calls > max_calls)
+		{
+			throw ::std::runtime_error("Too many comparisons");
+		}
+		return a < b;
+	}
+
+	::std::size_t calls;
+	::std::size_t max_calls;
+};
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_order )
+{
+	DCS_TEST_TRACE( "Test case: Ordering" );
+
+	const ::std::size_t n((1 << 17)+3);
+
+	::std::vector<int> v(n);
+	::std::vector<double> d(n);
+	::std::vector< ::std::string > s(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = ::std::rand() % 1000 - 500;
+		d[i] = (::std::rand() % 2000 - 1000)/7.0;
+		s[i] = ::std::string(1, static_cast<char>('a' + ::std::rand() % 20));
+	}
+
+	::std::vector< ::std::size_t > expect(n);
+	::std::vector< ::std::size_t > indices(n);
+	for (::std::size_t num_threads = 1; num_threads <= 5; num_threads += 2)
+	{
+		DCS_DEBUG_TRACE( "Threads: " << num_threads );
+
+		// Radix sort is stable, so the result is the same as the serial one
+		alg::order(v.begin(), v.end(), expect.begin());
+		alg::parallel_order(v.begin(), v.end(), indices.begin(), num_threads);
+		DCS_TEST_CHECK( indices == expect );
+
+		alg::parallel_order(d.begin(), d.end(), indices.begin(), ::std::greater<double>(), num_threads);
+		DCS_TEST_CHECK( is_order(d, indices, ::std::greater<double>()) );
+
+		alg::parallel_order(s.begin(), s.end(), indices.begin(), num_threads);
+		DCS_TEST_CHECK( is_order(s, indices, ::std::less< ::std::string >()) );
+	}
+}
+
+
+DCS_TEST_DEF( test_exception )
+{
+	DCS_TEST_TRACE( "Test case: Exception thrown by the comparator" );
+
+	const ::std::size_t n(1 << 17);
+
+	::std::vector<double> d(n);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		d[i] = ::std::rand();
+	}
+
+	::std::vector< ::std::size_t > indices(n);
+	bool thrown(false);
+	try
+	{
+		alg::parallel_order(d.begin(), d.end(), indices.begin(), throwing_less(1000), 4);
+	}
+	catch (::std::runtime_error const&)
+	{
+		thrown = true;
+	}
+	DCS_TEST_CHECK( thrown );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "Algorithms test suite: Parallel order" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO(test_order);
+		DCS_TEST_DO(test_exception);
+	DCS_TEST_END();
+}
@@ -3,10 +3,33 @@
 #include <dcs/algorithm/reorder.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/test.hpp>
+#include <list>
 #include <string>
 #include <vector>
 
 
+namespace /*<unnamed>*/ {
+
+/// Returns a pseudo-random permutation of 0,...,n-1 made of few long cycles.
+std::vector<std::size_t> make_permutation(std::size_t n)
+{
+	std::vector<std::size_t> idx(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		idx[i] = i;
+	}
+	std::size_t seed(12345);
+	for (std::size_t i = n; i > 1; --i)
+	{
+		seed = seed*1103515245+12345;
+		std::swap(idx[i-1], idx[(seed >> 8) % i]);
+	}
+	return idx;
+}
+
+} // Namespace <unnamed>
+
+
 DCS_TEST_DEF( test_vector )
 {
 	DCS_DEBUG_TRACE("Test case: STL vector");
@@ -144,6 +167,145 @@ DCS_TEST_DEF( test_carray_copy )
 	}
 }
 
+DCS_TEST_DEF( test_list_copy )
+{
+	DCS_DEBUG_TRACE("Test case: STL list - Copy");
+
+	const std::size_t n(1000);
+
+	const std::vector<std::size_t> idx(make_permutation(n));
+	std::list<std::size_t> l;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		l.push_back(i*10);
+	}
+
+	std::vector<std::size_t> out(n);
+	dcs::algorithm::reorder_copy(idx.begin(), idx.end(), l.begin(), out.begin());
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(out[i], idx[i]*10);
+	}
+
+	// The list is reordered by copying
+	dcs::algorithm::reorder(idx.begin(), idx.end(), l.begin());
+
+	DCS_TEST_CHECK(std::equal(out.begin(), out.end(), l.begin()));
+}
+
+DCS_TEST_DEF( test_cycles )
+{
+	DCS_DEBUG_TRACE("Test case: Cycle following");
+
+	const std::size_t n(5000);
+
+	const std::vector<std::size_t> idx(make_permutation(n));
+	std::vector<std::string> v(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = std::string(1+i%7, 'a'+i%26);
+	}
+
+	std::vector<std::string> expect(n);
+	dcs::algorithm::reorder_copy(idx.begin(), idx.end(), v.begin(), expect.begin());
+
+	// Indices from a non-random-access sequence
+	std::vector<std::string> w(v);
+	const std::list<std::size_t> idx_list(idx.begin(), idx.end());
+	dcs::algorithm::reorder(idx_list.begin(), idx_list.end(), w.begin());
+	DCS_TEST_CHECK(w == expect);
+
+	dcs::algorithm::reorder(idx.begin(), idx.end(), v.begin());
+	DCS_TEST_CHECK(v == expect);
+
+	// The identity permutation leaves the sequence untouched
+	std::vector<std::size_t> id(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		id[i] = i;
+	}
+	dcs::algorithm::reorder(id.begin(), id.end(), v.begin());
+	DCS_TEST_CHECK(v == expect);
+}
+
+DCS_TEST_DEF( test_multi )
+{
+	DCS_DEBUG_TRACE("Test case: Several sequences");
+
+	const std::size_t n(3000);
+
+	const std::vector<std::size_t> idx(make_permutation(n));
+	std::vector<int> a(n);
+	std::vector<double> b(n);
+	std::vector<std::string> c(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		a[i] = static_cast<int>(i);
+		b[i] = 0.5*i;
+		c[i] = std::string(1+i%5, 'x');
+	}
+
+	std::vector<int> a2(a);
+	std::vector<double> b2(b);
+	std::vector<std::string> c2(c);
+
+	dcs::algorithm::reorder(idx.begin(), idx.end(), a.begin(), b.begin(), c.begin());
+	dcs::algorithm::reorder(idx.begin(), idx.end(), &a2[0], b2.begin());
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(a[i], static_cast<int>(idx[i]));
+		DCS_TEST_CHECK_EQ(b[i], 0.5*idx[i]);
+		DCS_TEST_CHECK_EQ(c[i].size(), 1+idx[i]%5);
+		DCS_TEST_CHECK_EQ(a2[i], a[i]);
+		DCS_TEST_CHECK_EQ(b2[i], b[i]);
+	}
+}
+
+DCS_TEST_DEF( test_marking )
+{
+	DCS_DEBUG_TRACE("Test case: Marking indices");
+
+	const std::size_t n(128);
+
+	const std::vector<std::size_t> perm(make_permutation(n));
+
+	// The narrowest unsigned type able to represent 2n-1
+	std::vector<unsigned char> idx(perm.begin(), perm.end());
+	std::vector<int> v(n);
+	std::vector<int> w(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = static_cast<int>(i)*3;
+		w[i] = -static_cast<int>(i);
+	}
+
+	dcs::algorithm::reorder_marking(idx.begin(), idx.end(), v.begin(), w.begin());
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(static_cast<std::size_t>(idx[i]), perm[i]);
+		DCS_TEST_CHECK_EQ(v[i], static_cast<int>(perm[i])*3);
+		DCS_TEST_CHECK_EQ(w[i], -static_cast<int>(perm[i]));
+	}
+
+	// Signed indices
+	std::vector<signed char> sidx(perm.begin(), perm.begin()+100);
+	std::vector<int> u(100);
+	for (std::size_t i = 0; i < 100; ++i)
+	{
+		sidx[i] = static_cast<signed char>(i == 99 ? 0 : i+1);
+		u[i] = static_cast<int>(i);
+	}
+	dcs::algorithm::reorder_marking(sidx.begin(), sidx.end(), u.begin());
+	for (std::size_t i = 0; i < 100; ++i)
+	{
+		DCS_TEST_CHECK_EQ(static_cast<std::size_t>(sidx[i]), i == 99 ? 0 : i+1);
+		DCS_TEST_CHECK_EQ(u[i], static_cast<int>(sidx[i]));
+	}
+}
+
 
 int main()
 {
@@ -155,6 +317,10 @@ int main()
 	DCS_TEST_DO(test_carray);
 	DCS_TEST_DO(test_vector_copy);
 	DCS_TEST_DO(test_carray_copy);
+	DCS_TEST_DO(test_list_copy);
+	DCS_TEST_DO(test_cycles);
+	DCS_TEST_DO(test_multi);
+	DCS_TEST_DO(test_marking);
 
 	DCS_TEST_END();
 }
@@ -0,0 +1,180 @@
+/**
+ * \file dcs/test/concurrent/disjoint_sets.cpp
+ *
+ * \brief Test suite for the lock-free disjoint-sets data structure.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+#include <cstddef>
+#include <dcs/concurrent/disjoint_sets.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/disjoint_sets.hpp>
+#include <dcs/test.hpp>
+#include <utility>
+#include <vector>
+
+
+namespace /*<unnamed>*/ {
+
+typedef std::vector< std::pair<std::size_t,std::size_t> > pair_container;
+typedef dcs::concurrent::disjoint_sets<boost::uint32_t> concurrent_sets_type;
+
+pair_container make_pairs(std::size_t n, std::size_t m, std::size_t seed)
+{
+	pair_container pairs(m);
+	for (std::size_t k = 0; k < m; ++k)
+	{
+		seed = seed*1103515245+12345;
+		pairs[k].first = (seed >> 8) % n;
+		seed = seed*1103515245+12345;
+		pairs[k].second = (seed >> 8) % n;
+	}
+	return pairs;
+}
+
+/// Unites the pairs of the given stripe and counts the merges.
+void unite_stripe(concurrent_sets_type* p_sets, pair_container const* p_pairs, std::size_t stripe, std::size_t num_stripes, boost::atomic<std::size_t>* p_merges)
+{
+	std::size_t merges(0);
+	for (std::size_t k = stripe; k < p_pairs->size(); k += num_stripes)
+	{
+		if (p_sets->union_sets((*p_pairs)[k].first, (*p_pairs)[k].second))
+		{
+			++merges;
+		}
+	}
+	p_merges->fetch_add(merges);
+}
+
+/// Checks that elements known to be in the same set stay so while unions run.
+void watch_pairs(concurrent_sets_type const* p_sets, pair_container const* p_pairs, boost::atomic<bool>* p_done, boost::atomic<std::size_t>* p_errors)
+{
+	std::vector<bool> seen_same(p_pairs->size(), false);
+	do
+	{
+		for (std::size_t k = 0; k < p_pairs->size(); k += 7)
+		{
+			const bool same(p_sets->same_set((*p_pairs)[k].first, (*p_pairs)[k].second));
+			if (seen_same[k] && !same)
+			{
+				p_errors->fetch_add(1);
+			}
+			seen_same[k] = seen_same[k] || same;
+		}
+	}
+	while (!p_done->load());
+}
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_serial )
+{
+	DCS_TEST_CASE( "Single thread" );
+
+	concurrent_sets_type sets(10);
+
+	DCS_TEST_CHECK_EQ(sets.size(), 10u);
+	DCS_TEST_CHECK_EQ(sets.num_sets(), 10u);
+	DCS_TEST_CHECK(sets.union_sets(1, 2));
+	DCS_TEST_CHECK(sets.union_sets(3, 2));
+	DCS_TEST_CHECK(!sets.union_sets(1, 3));
+	DCS_TEST_CHECK(sets.union_sets(7, 8));
+	DCS_TEST_CHECK(sets.same_set(1, 3));
+	DCS_TEST_CHECK(!sets.same_set(1, 7));
+	DCS_TEST_CHECK_EQ(sets.find_set(1), sets.find_set(3));
+	DCS_TEST_CHECK_EQ(sets.num_sets(), 7u);
+}
+
+DCS_TEST_DEF( test_stress )
+{
+	DCS_TEST_CASE( "Multiple threads" );
+
+	const std::size_t n(20000);
+	const std::size_t num_threads(4);
+
+	for (std::size_t round = 0; round < 3; ++round)
+	{
+		DCS_TEST_TRACE( "Round " << round );
+
+		// Fewer pairs than elements, so that many sets survive
+		const pair_container pairs(make_pairs(n, n*3/4, round+1));
+
+		dcs::dense_disjoint_sets<> expect(n);
+		const std::size_t expect_merges(expect.union_all(pairs.begin(), pairs.end()));
+
+		concurrent_sets_type sets(n);
+		boost::atomic<std::size_t> merges(0);
+		boost::atomic<std::size_t> errors(0);
+		boost::atomic<bool> done(false);
+
+		boost::thread watcher(boost::bind(&watch_pairs, &sets, &pairs, &done, &errors));
+		boost::thread_group workers;
+		for (std::size_t t = 0; t < num_threads; ++t)
+		{
+			workers.create_thread(boost::bind(&unite_stripe, &sets, &pairs, t, num_threads, &merges));
+		}
+		workers.join_all();
+		done.store(true);
+		watcher.join();
+
+		DCS_TEST_CHECK_EQ(errors.load(), 0u);
+		DCS_TEST_CHECK_EQ(merges.load(), expect_merges);
+		DCS_TEST_CHECK_EQ(sets.num_sets(), expect.num_sets());
+
+		// Both structures define the same partition
+		std::vector<std::size_t> rep_map(n, n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const std::size_t r(sets.find_set(i));
+			const std::size_t er(expect.find_set(i));
+			if (rep_map[r] == n)
+			{
+				rep_map[r] = er;
+			}
+			DCS_TEST_CHECK_EQ(rep_map[r], er);
+		}
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "DCS Concurrent Disjoint Sets Test Suite" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_serial );
+	DCS_TEST_DO( test_stress );
+
+	DCS_TEST_END();
+}
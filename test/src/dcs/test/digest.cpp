@@ -30,14 +30,84 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <dcs/debug.hpp>
 #include <dcs/digest/md5.hpp>
+#include <dcs/digest/sha256.hpp>
+#include <dcs/digest/tree_hash.hpp>
+#include <dcs/digest/xxhash.hpp>
 #include <dcs/test.hpp>
 #include <iostream>
 #include <string>
+#include <unistd.h>
 #include <vector>
 
 
+namespace /*<unnamed>*/ {
+
+std::vector<dcs::digest::byte_type> make_bytes(std::size_t n)
+{
+	std::vector<dcs::digest::byte_type> bytes(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		bytes[i] = static_cast<dcs::digest::byte_type>((i*7) & 0xff);
+	}
+	return bytes;
+}
+
+template <typename DigestT>
+std::string chunked_digest(DigestT& dig, std::vector<dcs::digest::byte_type> const& bytes, std::size_t chunk)
+{
+	dig.reset();
+	for (std::size_t i = 0; i < bytes.size(); i += chunk)
+	{
+		dig.update(&bytes[0]+i, std::min(chunk, bytes.size()-i));
+	}
+	dig.finish();
+	return dcs::digest::hex_string(dig.digest());
+}
+
+/// The Merkle tree hash of RFC 6962 of the chunks [first,last), computed recursively.
+std::vector<dcs::digest::byte_type> reference_tree_hash(std::vector<dcs::digest::byte_type> const& bytes, std::size_t chunk, std::size_t first, std::size_t last)
+{
+	dcs::digest::sha256_algorithm dig;
+
+	if ((last-first) == 1)
+	{
+		const dcs::digest::byte_type prefix(0x00);
+		const std::size_t off(std::min(first*chunk, bytes.size()));
+		dig.update(&prefix, 1);
+		dig.update((bytes.empty() ? 0 : &bytes[0])+off, std::min(chunk, bytes.size()-off));
+		dig.finish();
+		return dig.digest();
+	}
+
+	std::size_t k(1);
+	while ((2*k) < (last-first))
+	{
+		k *= 2;
+	}
+	const std::vector<dcs::digest::byte_type> left(reference_tree_hash(bytes, chunk, first, first+k));
+	const std::vector<dcs::digest::byte_type> right(reference_tree_hash(bytes, chunk, first+k, last));
+	const dcs::digest::byte_type prefix(0x01);
+	dig.update(&prefix, 1);
+	dig.update(&left[0], left.size());
+	dig.update(&right[0], right.size());
+	dig.finish();
+	return dig.digest();
+}
+
+std::string reference_tree_hash(std::vector<dcs::digest::byte_type> const& bytes, std::size_t chunk)
+{
+	return dcs::digest::hex_string(reference_tree_hash(bytes, chunk, 0, bytes.empty() ? 1 : (bytes.size()-1)/chunk+1));
+}
+
+} // Namespace <unnamed>
+
+
 DCS_TEST_DEF( md5 )
 {
 	DCS_TEST_CASE( "MD5 Digest" );
@@ -54,7 +124,7 @@ DCS_TEST_DEF( md5 )
 	expect = "d41d8cd98f00b204e9800998ecf8427e";
 	bytes = dig.digest(test);
 	//res = dcs::digest::hex_string(bytes.begin(), bytes.end());
-	res = dcs::digest::hex_string(bytes.data(), bytes.size());
+	res = dcs::digest::hex_string(&bytes[0], bytes.size());
 	DCS_DEBUG_TRACE("RES    = '" << res << "' (" << res.length() << ")");
 	DCS_DEBUG_TRACE("EXPECT = '" << expect << "' (" << expect.length() << ")");
 	DCS_TEST_CHECK_EQ( res, expect );
@@ -64,17 +134,253 @@ DCS_TEST_DEF( md5 )
 	expect = "9e107d9d372bb6826bd81d3542a419d6";
 	bytes = dig.digest(test);
 	//res = dcs::digest::hex_string(bytes.begin(), bytes.end());
-	res = dcs::digest::hex_string(bytes.data(), bytes.size());
+	res = dcs::digest::hex_string(&bytes[0], bytes.size());
 	DCS_DEBUG_TRACE("RES    = '" << res << "' (" << res.length() << ")");
 	DCS_DEBUG_TRACE("EXPECT = '" << expect << "' (" << expect.length() << ")");
 	DCS_TEST_CHECK_EQ( res, expect );
 }
 
+DCS_TEST_DEF( md5_array )
+{
+	DCS_TEST_CASE( "MD5 Digest as Array" );
+
+	dcs::digest::md5_algorithm dig;
+
+	dig.digest(std::string("The quick brown fox jumps over the lazy dog"));
+	const boost::array<dcs::digest::byte_type,dcs::digest::md5_algorithm::digest_size> arr(dig.digest_array());
+
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(arr.begin(), arr.end()), std::string("9e107d9d372bb6826bd81d3542a419d6") );
+}
+
+DCS_TEST_DEF( sha256 )
+{
+	DCS_TEST_CASE( "SHA-256 Digest" );
+
+	dcs::digest::sha256_algorithm dig;
+
+	std::string res;
+
+	DCS_TEST_TRACE( "Empty String" );
+	res = dcs::digest::hex_string(dig.digest(std::string()));
+	DCS_DEBUG_TRACE("RES    = '" << res << "'");
+	DCS_TEST_CHECK_EQ( res, std::string("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855") );
+
+	DCS_TEST_TRACE( "String 'abc'" );
+	res = dcs::digest::hex_string(dig.digest(std::string("abc")));
+	DCS_DEBUG_TRACE("RES    = '" << res << "'");
+	DCS_TEST_CHECK_EQ( res, std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") );
+
+	DCS_TEST_TRACE( "448-bit String" );
+	res = dcs::digest::hex_string(dig.digest(std::string("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")));
+	DCS_DEBUG_TRACE("RES    = '" << res << "'");
+	DCS_TEST_CHECK_EQ( res, std::string("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") );
+
+	DCS_TEST_TRACE( "Streaming" );
+	const std::vector<dcs::digest::byte_type> bytes(make_bytes(1000));
+	const std::string expect(dcs::digest::hex_string(dig.digest(&bytes[0], bytes.size())));
+	DCS_TEST_CHECK_EQ( chunked_digest(dig, bytes, 1), expect );
+	DCS_TEST_CHECK_EQ( chunked_digest(dig, bytes, 63), expect );
+	DCS_TEST_CHECK_EQ( chunked_digest(dig, bytes, 100), expect );
+}
+
+DCS_TEST_DEF( sha256_many )
+{
+	DCS_TEST_CASE( "SHA-256 Digest of Many Messages" );
+
+	namespace detail = dcs::digest::detail;
+
+	const std::size_t n(100);
+	const std::vector<dcs::digest::byte_type> bytes(make_bytes(1000));
+	std::vector<dcs::digest::byte_type const*> data(n);
+	std::vector<std::size_t> lens(n);
+	std::vector<dcs::digest::byte_type> expect(32*n);
+	dcs::digest::sha256_algorithm dig;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		data[i] = &bytes[0]+(i % 13);
+		lens[i] = (i*37) % 300;
+		dig.digest(data[i], lens[i]);
+		std::copy(dig.raw_digest(), dig.raw_digest()+32, expect.begin()+32*i);
+	}
+
+	std::vector<detail::sha256_kernel_category> kernels;
+	kernels.push_back(detail::scalar_sha256_kernel);
+#ifdef DCS_DIGEST_DETAIL_SHA256_X86
+	kernels.push_back(detail::sse2_x4_sha256_kernel);
+	if (detail::sha256_x86_has_sha())
+	{
+		kernels.push_back(detail::shani_sha256_kernel);
+	}
+	if (detail::sha256_x86_has_avx2())
+	{
+		kernels.push_back(detail::avx2_x8_sha256_kernel);
+	}
+#endif // DCS_DIGEST_DETAIL_SHA256_X86
+
+	for (std::size_t k = 0; k < kernels.size(); ++k)
+	{
+		DCS_TEST_TRACE( "Kernel " << kernels[k] );
+
+		std::vector<dcs::digest::byte_type> out(32*n);
+		dcs::digest::sha256_digest_many(&data[0], &lens[0], n, &out[0], kernels[k]);
+		DCS_TEST_CHECK( out == expect );
+	}
+}
+
+DCS_TEST_DEF( xxh64 )
+{
+	DCS_TEST_CASE( "XXH64 Digest" );
+
+	dcs::digest::xxh64_algorithm dig;
+
+	DCS_TEST_TRACE( "Empty String" );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(dig.digest(std::string())), std::string("ef46db3751d8e999") );
+
+	DCS_TEST_TRACE( "String 'abc'" );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(dig.digest(std::string("abc"))), std::string("44bc2cf5ad770999") );
+
+	DCS_TEST_TRACE( "String 'The quick brown fox jumps over the lazy dog'" );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(dig.digest(std::string("The quick brown fox jumps over the lazy dog"))), std::string("0b242d361fda71bc") );
+
+	DCS_TEST_TRACE( "Seeded Streaming" );
+	const std::vector<dcs::digest::byte_type> bytes(make_bytes(1000));
+	dcs::digest::xxh64_algorithm seeded(42);
+	DCS_TEST_CHECK_EQ( chunked_digest(seeded, bytes, 1), std::string("6d70f8faa18af724") );
+	DCS_TEST_CHECK_EQ( chunked_digest(seeded, bytes, 33), std::string("6d70f8faa18af724") );
+	DCS_TEST_CHECK( dcs::digest::xxh64_algorithm::hash(&bytes[0], bytes.size(), 42) == seeded.value() );
+}
+
+DCS_TEST_DEF( xxh3 )
+{
+	DCS_TEST_CASE( "XXH3 Digest" );
+
+	dcs::digest::xxh3_algorithm dig;
+
+	DCS_TEST_TRACE( "Empty String" );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(dig.digest(std::string())), std::string("2d06800538d394c2") );
+
+	DCS_TEST_TRACE( "String 'The quick brown fox jumps over the lazy dog'" );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(dig.digest(std::string("The quick brown fox jumps over the lazy dog"))), std::string("ce7d19a5418fb365") );
+
+	DCS_TEST_TRACE( "Streaming" );
+	const std::vector<dcs::digest::byte_type> bytes(make_bytes(1000));
+	DCS_TEST_CHECK_EQ( chunked_digest(dig, bytes, 1), std::string("10ad30264426c830") );
+	DCS_TEST_CHECK_EQ( chunked_digest(dig, bytes, 65), std::string("10ad30264426c830") );
+
+	DCS_TEST_TRACE( "Seeded Streaming" );
+	dcs::digest::xxh3_algorithm seeded(42);
+	DCS_TEST_CHECK_EQ( chunked_digest(seeded, bytes, 7), std::string("715c5bbc12530d92") );
+	DCS_TEST_CHECK( dcs::digest::xxh3_algorithm::hash(&bytes[0], bytes.size(), 42) == seeded.value() );
+	const boost::array<dcs::digest::byte_type,8> arr(seeded.digest_array());
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(arr.begin(), arr.end()), std::string("715c5bbc12530d92") );
+}
+
+
+DCS_TEST_DEF( tree_hash )
+{
+	DCS_TEST_CASE( "Tree Hash" );
+
+	typedef dcs::digest::tree_hash<dcs::digest::sha256_algorithm> tree_hash_type;
+
+	const std::size_t chunk(100);
+	std::vector<dcs::digest::byte_type> bytes(make_bytes(1234));
+
+	DCS_TEST_TRACE( "Empty Data" );
+	tree_hash_type seq(chunk, 1);
+	seq.hash(&bytes[0], 0);
+	DCS_TEST_CHECK_EQ( seq.num_chunks(), 1u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(seq.digest()), reference_tree_hash(std::vector<dcs::digest::byte_type>(), chunk) );
+
+	DCS_TEST_TRACE( "Sequential and Parallel" );
+	tree_hash_type par(chunk, 4);
+	const std::size_t lens[] = {1, 99, 100, 101, 200, 300, 700, 1234};
+	for (std::size_t i = 0; i < sizeof(lens)/sizeof(lens[0]); ++i)
+	{
+		const std::vector<dcs::digest::byte_type> data(bytes.begin(), bytes.begin()+lens[i]);
+		const std::string expect(reference_tree_hash(data, chunk));
+		seq.hash(data.empty() ? 0 : &data[0], data.size());
+		par.hash(data.empty() ? 0 : &data[0], data.size());
+		DCS_DEBUG_TRACE("LEN = " << lens[i] << ", RES = '" << seq << "'");
+		DCS_TEST_CHECK_EQ( dcs::digest::hex_string(seq.digest()), expect );
+		DCS_TEST_CHECK_EQ( dcs::digest::hex_string(par.digest()), expect );
+	}
+
+	DCS_TEST_TRACE( "Incremental Rehash" );
+	par.hash(&bytes[0], bytes.size());
+	bytes[550] ^= 0xff;
+	bytes[551] ^= 0xff;
+	par.invalidate(550, 2);
+	par.rehash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( par.num_rehashed_chunks(), 1u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(par.digest()), reference_tree_hash(bytes, chunk) );
+
+	DCS_TEST_TRACE( "Incremental Rehash after Growing" );
+	bytes.resize(2100, 0x5a);
+	par.rehash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( par.num_rehashed_chunks(), 9u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(par.digest()), reference_tree_hash(bytes, chunk) );
+
+	DCS_TEST_TRACE( "Incremental Rehash after Shrinking" );
+	bytes.resize(400);
+	par.rehash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( par.num_rehashed_chunks(), 0u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(par.digest()), reference_tree_hash(bytes, chunk) );
+	bytes.resize(333);
+	par.rehash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( par.num_rehashed_chunks(), 1u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(par.digest()), reference_tree_hash(bytes, chunk) );
+}
+
+DCS_TEST_DEF( tree_hash_file )
+{
+	DCS_TEST_CASE( "Tree Hash of Files" );
+
+	typedef dcs::digest::tree_hash<dcs::digest::md5_algorithm> tree_hash_type;
+
+	char path[] = "/tmp/dcs_test_tree_hash_XXXXXX";
+	const int fd(::mkstemp(path));
+	DCS_TEST_CHECK( fd != -1 );
+
+	tree_hash_type file_th(64, 3);
+	tree_hash_type mem_th(64, 1);
+
+	DCS_TEST_TRACE( "Empty File" );
+	file_th.hash_file(path);
+	mem_th.hash(0, 0);
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(file_th.digest()), dcs::digest::hex_string(mem_th.digest()) );
+
+	DCS_TEST_TRACE( "Non-empty File" );
+	std::vector<dcs::digest::byte_type> bytes(make_bytes(1000));
+	DCS_TEST_CHECK( ::write(fd, &bytes[0], bytes.size()) == static_cast<ssize_t>(bytes.size()) );
+	file_th.hash_file(path);
+	mem_th.hash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(file_th.digest()), dcs::digest::hex_string(mem_th.digest()) );
+
+	DCS_TEST_TRACE( "Modified File" );
+	bytes[10] = 0;
+	DCS_TEST_CHECK( ::pwrite(fd, &bytes[0]+10, 1, 10) == 1 );
+	file_th.invalidate(10, 1);
+	file_th.rehash_file(path);
+	mem_th.hash(&bytes[0], bytes.size());
+	DCS_TEST_CHECK_EQ( file_th.num_rehashed_chunks(), 1u );
+	DCS_TEST_CHECK_EQ( dcs::digest::hex_string(file_th.digest()), dcs::digest::hex_string(mem_th.digest()) );
+
+	::close(fd);
+	std::remove(path);
+}
+
 
 int main()
 {
 	DCS_TEST_SUITE( "Digest" );
 	DCS_TEST_BEGIN();
 		DCS_TEST_DO( md5 );
+		DCS_TEST_DO( md5_array );
+		DCS_TEST_DO( sha256 );
+		DCS_TEST_DO( sha256_many );
+		DCS_TEST_DO( xxh64 );
+		DCS_TEST_DO( xxh3 );
+		DCS_TEST_DO( tree_hash );
+		DCS_TEST_DO( tree_hash_file );
 	DCS_TEST_END();
 }
@@ -0,0 +1,227 @@
+/**
+ * \file dcs/test/disjoint_sets.cpp
+ *
+ * \brief Test suite for the disjoint-sets data structures.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/disjoint_sets.hpp>
+#include <dcs/test.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace /*<unnamed>*/ {
+
+/// Naive reference: the label of each element is the smallest element of its set.
+void naive_union(std::vector<std::size_t>& labels, std::size_t i, std::size_t j)
+{
+	const std::size_t li(labels[i]);
+	const std::size_t lj(labels[j]);
+	const std::size_t l(li < lj ? li : lj);
+	for (std::size_t k = 0; k < labels.size(); ++k)
+	{
+		if (labels[k] == li || labels[k] == lj)
+		{
+			labels[k] = l;
+		}
+	}
+}
+
+template <typename SetsT>
+void check_against_labels(SetsT const& sets, std::vector<std::size_t> const& labels, DCS_TEST_CONTEXT_FUNC_PARAM)
+{
+	std::size_t num_sets(0);
+	for (std::size_t i = 0; i < labels.size(); ++i)
+	{
+		if (labels[i] == i)
+		{
+			++num_sets;
+		}
+		DCS_TEST_CHECK(sets.same_set(i, labels[i]));
+		DCS_TEST_CHECK(i == 0 || sets.same_set(i, i-1) == (labels[i] == labels[i-1]));
+	}
+	DCS_TEST_CHECK_EQ(sets.num_sets(), num_sets);
+}
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_dense )
+{
+	DCS_TEST_CASE( "Dense disjoint sets" );
+
+	typedef dcs::dense_disjoint_sets<boost::uint32_t> sets_type;
+
+	const std::size_t n(300);
+
+	sets_type sets(n);
+	std::vector<std::size_t> labels(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		labels[i] = i;
+	}
+
+	DCS_TEST_CHECK_EQ(sets.size(), n);
+	DCS_TEST_CHECK_EQ(sets.num_sets(), n);
+
+	std::size_t seed(7);
+	for (std::size_t k = 0; k < n/2; ++k)
+	{
+		seed = seed*1103515245+12345;
+		const std::size_t i((seed >> 8) % n);
+		seed = seed*1103515245+12345;
+		const std::size_t j((seed >> 8) % n);
+
+		const bool merged(sets.union_sets(static_cast<boost::uint32_t>(i), static_cast<boost::uint32_t>(j)));
+		DCS_TEST_CHECK_EQ(merged, labels[i] != labels[j]);
+		naive_union(labels, i, j);
+	}
+
+	check_against_labels(sets, labels, DCS_TEST_CONTEXT_FUNC_ARG);
+
+	std::size_t total(0);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		if (sets.find_set(static_cast<boost::uint32_t>(i)) == i)
+		{
+			total += sets.set_size(static_cast<boost::uint32_t>(i));
+		}
+	}
+	DCS_TEST_CHECK_EQ(total, n);
+
+	const boost::uint32_t e(sets.make_set());
+	DCS_TEST_CHECK_EQ(static_cast<std::size_t>(e), n);
+	DCS_TEST_CHECK_EQ(sets.set_size(e), 1u);
+}
+
+DCS_TEST_DEF( test_union_all )
+{
+	DCS_TEST_CASE( "Bulk union" );
+
+	const std::size_t n(1000);
+
+	// A chain over even elements and a chain over odd elements
+	std::vector< std::pair<std::size_t,std::size_t> > pairs;
+	for (std::size_t i = 2; i < n; ++i)
+	{
+		pairs.push_back(std::make_pair(i-2, i));
+	}
+	pairs.push_back(std::make_pair(std::size_t(0), std::size_t(n-2)));
+
+	dcs::dense_disjoint_sets<> dense(n);
+	DCS_TEST_CHECK_EQ(dense.union_all(pairs.begin(), pairs.end()), n-2);
+	DCS_TEST_CHECK_EQ(dense.num_sets(), 2u);
+	DCS_TEST_CHECK(dense.same_set(0, n-2));
+	DCS_TEST_CHECK(dense.same_set(1, n-1));
+	DCS_TEST_CHECK(!dense.same_set(0, 1));
+	DCS_TEST_CHECK_EQ(dense.set_size(3), n/2);
+
+	dcs::dense_disjoint_sets<std::size_t,dcs::find_with_full_path_compression> full(n);
+	DCS_TEST_CHECK_EQ(full.union_all(pairs.begin(), pairs.end()), n-2);
+	DCS_TEST_CHECK_EQ(full.num_sets(), 2u);
+
+	dcs::dense_disjoint_sets<std::size_t,dcs::find_with_path_halving> halving(n);
+	DCS_TEST_CHECK_EQ(halving.union_all(pairs.begin(), pairs.end()), n-2);
+	DCS_TEST_CHECK(halving.same_set(1, n-1));
+}
+
+DCS_TEST_DEF( test_hashed )
+{
+	DCS_TEST_CASE( "Hashed disjoint sets" );
+
+	dcs::disjoint_sets<std::string> sets;
+
+	sets.make_set("a");
+	sets.make_set("b");
+	sets.make_set("a");
+	DCS_TEST_CHECK_EQ(sets.size(), 2u);
+	DCS_TEST_CHECK_EQ(sets.num_sets(), 2u);
+	DCS_TEST_CHECK(sets.contains("a"));
+	DCS_TEST_CHECK(!sets.contains("c"));
+
+	DCS_TEST_CHECK(sets.union_sets("a", "c"));
+	DCS_TEST_CHECK(!sets.union_sets("c", "a"));
+	sets.link_sets("d", "e");
+	DCS_TEST_CHECK_EQ(sets.size(), 5u);
+	DCS_TEST_CHECK_EQ(sets.num_sets(), 3u);
+	DCS_TEST_CHECK(sets.same_set("a", "c"));
+	DCS_TEST_CHECK(!sets.same_set("a", "d"));
+	DCS_TEST_CHECK_EQ(sets.set_size("c"), 2u);
+
+	const std::string rep(sets.element(sets.find_set("c")));
+	DCS_TEST_CHECK(rep == "a" || rep == "c");
+
+	bool thrown(false);
+	try
+	{
+		sets.find_set("z");
+	}
+	catch (std::out_of_range const&)
+	{
+		thrown = true;
+	}
+	DCS_TEST_CHECK(thrown);
+
+	// Sparse integer keys
+	const std::size_t n(5000);
+	dcs::disjoint_sets<boost::uint64_t> flows;
+	std::vector< std::pair<boost::uint64_t,boost::uint64_t> > pairs;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		const boost::uint64_t key(static_cast<boost::uint64_t>(i) << 40);
+		pairs.push_back(std::make_pair(key, key+(i%3)));
+	}
+	DCS_TEST_CHECK_EQ(flows.union_all(pairs.begin(), pairs.end()), n-(n+2)/3);
+	DCS_TEST_CHECK_EQ(flows.size(), n+n-(n+2)/3);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		const boost::uint64_t key(static_cast<boost::uint64_t>(i) << 40);
+		DCS_TEST_CHECK(flows.same_set(key, key+(i%3)));
+		DCS_TEST_CHECK(i == 0 || !flows.same_set(key, static_cast<boost::uint64_t>(i-1) << 40));
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "DCS Disjoint Sets Test Suite" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_dense );
+	DCS_TEST_DO( test_union_all );
+	DCS_TEST_DO( test_hashed );
+
+	DCS_TEST_END();
+}
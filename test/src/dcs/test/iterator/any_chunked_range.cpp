@@ -0,0 +1,141 @@
+#include <cstddef>
+#include <deque>
+#include <dcs/debug.hpp>
+#include <dcs/iterator/any_chunked_range.hpp>
+#include <dcs/math/curvefit/interpolation/linear.hpp>
+#include <dcs/test.hpp>
+#include <vector>
+
+
+namespace /*<unnamed>*/ {
+
+struct chunk_summer
+{
+	chunk_summer()
+	: sum(0),
+	  num_chunks(0)
+	{
+	}
+
+	void operator()(double const* data, std::size_t n)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			sum += data[i];
+		}
+		++num_chunks;
+	}
+
+	double sum;
+	std::size_t num_chunks;
+};
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_contiguous )
+{
+	DCS_TEST_CASE("Contiguous range");
+
+	std::vector<double> v;
+	for (std::size_t i = 0; i < 1000; ++i)
+	{
+		v.push_back(i);
+	}
+
+	const dcs::iterator::any_chunked_range<double> range(dcs::iterator::make_any_chunked_range(v));
+
+	DCS_TEST_CHECK_EQ(range.size(), v.size());
+	DCS_TEST_CHECK(range.contiguous());
+
+	// The whole vector is handed out in a single chunk, without copy
+	double const* data(0);
+	DCS_TEST_CHECK_EQ(range.chunk(0, data, 0, 0), v.size());
+	DCS_TEST_CHECK(data == &v[0]);
+	DCS_TEST_CHECK_EQ(range.chunk(10, data, 0, 0), v.size()-10);
+	DCS_TEST_CHECK(data == &v[10]);
+
+	const chunk_summer s(dcs::iterator::for_each_chunk(range, chunk_summer()));
+	DCS_TEST_CHECK_EQ(s.num_chunks, 1u);
+	DCS_TEST_CHECK_EQ(s.sum, 999.0*1000.0/2.0);
+
+	const double a[] = {1, 2, 3};
+	const dcs::iterator::any_chunked_range<double> array_range(a, a+3);
+	DCS_TEST_CHECK(array_range.contiguous());
+	DCS_TEST_CHECK_EQ(array_range.size(), 3u);
+}
+
+DCS_TEST_DEF( test_copying )
+{
+	DCS_TEST_CASE("Non-contiguous range");
+
+	const std::size_t n(1000);
+	std::deque<double> d;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		d.push_back(i);
+	}
+
+	const dcs::iterator::any_chunked_range<double> range(dcs::iterator::make_any_chunked_range(d.begin(), d.end()));
+
+	DCS_TEST_CHECK_EQ(range.size(), n);
+	DCS_TEST_CHECK(!range.contiguous());
+
+	double buf[64];
+	double const* data(0);
+	DCS_TEST_CHECK_EQ(range.chunk(0, data, buf, 64), 64u);
+	DCS_TEST_CHECK(data == buf);
+	DCS_TEST_CHECK_EQ(buf[63], 63.0);
+	DCS_TEST_CHECK_EQ(range.chunk(n-10, data, buf, 64), 10u);
+	DCS_TEST_CHECK_EQ(buf[9], static_cast<double>(n-1));
+
+	const chunk_summer s(dcs::iterator::for_each_chunk(range, chunk_summer()));
+	const std::size_t chunk_size(dcs::iterator::any_chunked_range<double>::default_chunk_size);
+	DCS_TEST_CHECK_EQ(s.num_chunks, (n+chunk_size-1)/chunk_size);
+	DCS_TEST_CHECK_EQ(s.sum, (n-1.0)*n/2.0);
+
+	std::vector<double> out(n);
+	dcs::iterator::copy(range, out.begin());
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(out[i], d[i]);
+	}
+}
+
+DCS_TEST_DEF( test_empty )
+{
+	DCS_TEST_CASE("Empty range");
+
+	const dcs::iterator::any_chunked_range<double> range;
+	DCS_TEST_CHECK(range.empty());
+	DCS_TEST_CHECK_EQ(dcs::iterator::for_each_chunk(range, chunk_summer()).num_chunks, 0u);
+
+	const std::vector<double> v;
+	DCS_TEST_CHECK(dcs::iterator::make_any_chunked_range(v).empty());
+}
+
+DCS_TEST_DEF( test_interpolator_data )
+{
+	DCS_TEST_CASE("Interpolator data");
+
+	const double x[] = {0, 1, 2};
+	const double y[] = {0, 10, 20};
+	const dcs::math::curvefit::linear_interpolator<double> interp(x, x+3, y, y+3);
+
+	DCS_TEST_CHECK_EQ(dcs::iterator::for_each_chunk(interp.node_range(), chunk_summer()).sum, 3.0);
+	DCS_TEST_CHECK_EQ(dcs::iterator::for_each_chunk(interp.value_range(), chunk_summer()).sum, 30.0);
+	DCS_TEST_CHECK(interp.values() == std::vector<double>(y, y+3));
+}
+
+
+int main()
+{
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_contiguous );
+	DCS_TEST_DO( test_copying );
+	DCS_TEST_DO( test_empty );
+	DCS_TEST_DO( test_interpolator_data );
+
+	DCS_TEST_END();
+}
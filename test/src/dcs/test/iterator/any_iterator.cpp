@@ -1,14 +1,134 @@
 #include <cstddef>
+#include <cstdlib>
 #include <dcs/debug.hpp>
 #include <dcs/iterator/any_iterator.hpp>
 #include <dcs/test.hpp>
 #include <set>
 #include <list>
+#include <new>
 #include <vector>
 //#include <boost/iterator.hpp>
 #include <iterator>
 
 
+namespace /*<unnamed>*/ {
+
+std::size_t num_allocations = 0;
+
+/// A random access iterator too large for the buffer of any_iterator.
+class padded_iterator: public std::iterator<std::random_access_iterator_tag, int>
+{
+	public: padded_iterator()
+	: p_(0)
+	{
+	}
+
+	public: explicit padded_iterator(int* p)
+	: p_(p)
+	{
+	}
+
+	public: int& operator*() const { return *p_; }
+	public: padded_iterator& operator++() { ++p_; return *this; }
+	public: padded_iterator operator++(int) { padded_iterator tmp(*this); ++p_; return tmp; }
+	public: padded_iterator& operator--() { --p_; return *this; }
+	public: padded_iterator operator--(int) { padded_iterator tmp(*this); --p_; return tmp; }
+	public: padded_iterator& operator+=(std::ptrdiff_t n) { p_ += n; return *this; }
+	public: padded_iterator& operator-=(std::ptrdiff_t n) { p_ -= n; return *this; }
+	public: padded_iterator operator+(std::ptrdiff_t n) const { return padded_iterator(p_+n); }
+	public: padded_iterator operator-(std::ptrdiff_t n) const { return padded_iterator(p_-n); }
+	public: std::ptrdiff_t operator-(padded_iterator const& other) const { return p_-other.p_; }
+	public: int& operator[](std::ptrdiff_t n) const { return p_[n]; }
+	public: bool operator==(padded_iterator const& other) const { return p_ == other.p_; }
+	public: bool operator!=(padded_iterator const& other) const { return p_ != other.p_; }
+	public: bool operator<(padded_iterator const& other) const { return p_ < other.p_; }
+
+
+	private: int* p_;
+	private: char pad_[DCS_ITERATOR_ANY_ITERATOR_BUFFER_SIZE];
+}; // padded_iterator
+
+} // Namespace <unnamed>
+
+
+// Count the allocations made by any_iterator.
+// All the replaceable allocation functions are replaced, so that memory is
+// never released by a function not matching the one that allocated it.
+
+#if __cplusplus < 201103L
+# define DCS_TEST_NEW_THROW_ throw (std::bad_alloc)
+# define DCS_TEST_NOTHROW_ throw ()
+#else
+# define DCS_TEST_NEW_THROW_
+# define DCS_TEST_NOTHROW_ noexcept
+#endif // __cplusplus
+
+void* operator new(std::size_t n) DCS_TEST_NEW_THROW_
+{
+	++num_allocations;
+	void* p = std::malloc(n > 0 ? n : 1);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](std::size_t n) DCS_TEST_NEW_THROW_
+{
+	return ::operator new(n);
+}
+
+void* operator new(std::size_t n, std::nothrow_t const&) DCS_TEST_NOTHROW_
+{
+	try
+	{
+		return ::operator new(n);
+	}
+	catch (std::bad_alloc const&)
+	{
+		return 0;
+	}
+}
+
+void* operator new[](std::size_t n, std::nothrow_t const&) DCS_TEST_NOTHROW_
+{
+	return ::operator new(n, std::nothrow);
+}
+
+void operator delete(void* p) DCS_TEST_NOTHROW_
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) DCS_TEST_NOTHROW_
+{
+	::operator delete(p);
+}
+
+void operator delete(void* p, std::nothrow_t const&) DCS_TEST_NOTHROW_
+{
+	::operator delete(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) DCS_TEST_NOTHROW_
+{
+	::operator delete(p);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) DCS_TEST_NOTHROW_
+{
+	::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) DCS_TEST_NOTHROW_
+{
+	::operator delete(p);
+}
+#endif // __cpp_sized_deallocation
+
+
 DCS_TEST_DEF( test_vector_iteration )
 {
 	std::vector<int> vector_of_ints;
@@ -116,6 +236,117 @@ DCS_TEST_DEF( test_vector_list_iteration_mix )
 }
 
 
+DCS_TEST_DEF( test_small_buffer )
+{
+	typedef std::vector<int>::iterator vector_iterator;
+	typedef dcs::iterator::make_any_iterator_type<vector_iterator>::type any_vector_iterator;
+	typedef dcs::iterator::any_iterator<int const, std::random_access_iterator_tag, int const&, std::ptrdiff_t> any_const_iterator;
+	typedef dcs::iterator::any_iterator<int, std::forward_iterator_tag, int&, std::ptrdiff_t> any_fwd_iterator;
+
+	std::vector<int> v(10);
+	for (std::size_t i = 0; i < v.size(); ++i)
+	{
+		v[i] = static_cast<int>(i);
+	}
+
+	// Small wrapped iterators are not allocated
+	std::size_t old_num_allocations(num_allocations);
+	{
+		any_vector_iterator it(v.begin());
+		any_vector_iterator it2(it);
+		any_vector_iterator it3;
+		it3 = it2;
+		++it3;
+		it2 = v.begin()+2;
+		any_const_iterator cit(it3);
+		any_fwd_iterator fit(it2);
+		DCS_TEST_CHECK_EQ(*it, 0);
+		DCS_TEST_CHECK_EQ(*it3, 1);
+		DCS_TEST_CHECK_EQ(*cit, 1);
+		DCS_TEST_CHECK_EQ(*fit, 2);
+		DCS_TEST_CHECK_EQ(it2-it, 2);
+	}
+	DCS_DEBUG_TRACE( "Allocations with small iterators: " << (num_allocations-old_num_allocations) );
+	DCS_TEST_CHECK_EQ(num_allocations, old_num_allocations);
+
+	// Large ones are still supported
+	typedef dcs::iterator::make_any_iterator_type<padded_iterator>::type any_padded_iterator;
+	old_num_allocations = num_allocations;
+	{
+		const padded_iterator first(&v[0]);
+		any_padded_iterator it(first);
+		any_padded_iterator it2(it);
+		it2 += 3;
+		any_const_iterator cit(it2);
+		DCS_TEST_CHECK_EQ(*it2, 3);
+		DCS_TEST_CHECK_EQ(*cit, 3);
+		DCS_TEST_CHECK_EQ(it2-it, 3);
+	}
+	DCS_DEBUG_TRACE( "Allocations with large iterators: " << (num_allocations-old_num_allocations) );
+	DCS_TEST_CHECK(num_allocations > old_num_allocations);
+}
+
+
+DCS_TEST_DEF( test_batch_operations )
+{
+	typedef dcs::iterator::any_iterator<int, std::random_access_iterator_tag, int&, std::ptrdiff_t> any_ra_iterator;
+	typedef dcs::iterator::any_iterator<int, std::bidirectional_iterator_tag, int&, std::ptrdiff_t> any_bidi_iterator;
+
+	const std::size_t n(100);
+
+	std::vector<int> v(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		v[i] = static_cast<int>(i);
+	}
+	std::list<int> l(v.begin(), v.end());
+
+	any_ra_iterator ra_it(v.begin());
+	any_ra_iterator ra_end(v.end());
+	any_bidi_iterator bidi_it(l.begin());
+	any_bidi_iterator bidi_end(l.end());
+
+	ra_it.advance_n(10);
+	bidi_it.advance_n(10);
+	DCS_TEST_CHECK_EQ(*ra_it, 10);
+	DCS_TEST_CHECK_EQ(*bidi_it, 10);
+	ra_it.advance_n(-5);
+	bidi_it.advance_n(-5);
+	DCS_TEST_CHECK_EQ(*ra_it, 5);
+	DCS_TEST_CHECK_EQ(*bidi_it, 5);
+
+	std::vector<int> block(32);
+	DCS_TEST_CHECK_EQ(ra_it.copy_n_to(&block[0], 32), 32);
+	for (std::size_t i = 0; i < 32; ++i)
+	{
+		DCS_TEST_CHECK_EQ(block[i], static_cast<int>(5+i));
+	}
+	DCS_TEST_CHECK_EQ(*ra_it, 37);
+	DCS_TEST_CHECK_EQ(bidi_it.copy_n_to(&block[0], 32), 32);
+	DCS_TEST_CHECK_EQ(block[31], 36);
+	DCS_TEST_CHECK_EQ(*bidi_it, 37);
+
+	// Consume the rest in blocks
+	std::size_t count(0);
+	std::ptrdiff_t k(0);
+	while ((k = ra_it.copy_n_to(&block[0], 32, ra_end)) > 0)
+	{
+		DCS_TEST_CHECK_EQ(block[0], static_cast<int>(37+count));
+		count += k;
+	}
+	DCS_TEST_CHECK_EQ(count, n-37);
+	DCS_TEST_CHECK(ra_it == ra_end);
+	count = 0;
+	while ((k = bidi_it.copy_n_to(&block[0], 32, bidi_end)) > 0)
+	{
+		DCS_TEST_CHECK_EQ(block[k-1], static_cast<int>(37+count+k-1));
+		count += k;
+	}
+	DCS_TEST_CHECK_EQ(count, n-37);
+	DCS_TEST_CHECK(bidi_it == bidi_end);
+}
+
+
 int main()
 {
 	DCS_TEST_BEGIN();
@@ -123,6 +354,8 @@ int main()
 	DCS_TEST_DO( test_vector_iteration );
 	DCS_TEST_DO( test_set_iteration );
 	DCS_TEST_DO( test_vector_list_iteration_mix );
+	DCS_TEST_DO( test_small_buffer );
+	DCS_TEST_DO( test_batch_operations );
 
 	DCS_TEST_END();
 }
@@ -0,0 +1,321 @@
+/**
+ * \file test/src/dcs/test/math/curvefit/interp_gridded.cpp
+ *
+ * \brief Test suite for interpolation of gridded data.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cmath>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/math/curvefit/detail/node_search.hpp>
+#include <dcs/math/curvefit/interpolation/cubic_spline.hpp>
+#include <dcs/math/curvefit/interpolation/multilinear.hpp>
+#include <dcs/math/curvefit/interpolation/tensor_cubic_spline.hpp>
+#include <dcs/test.hpp>
+#include <vector>
+
+
+namespace dmc = dcs::math::curvefit;
+
+
+const double tol = 1e-5;
+
+DCS_TEST_DEF( hinted_find )
+{
+	DCS_TEST_TRACE("Hinted find");
+
+	typedef double real_type;
+
+	const std::size_t n(7);
+
+	std::vector<real_type> x(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		x[i] = i*i;
+	}
+
+	for (std::size_t hint = 0; hint < n; ++hint)
+	{
+		for (real_type xx = -2; xx < 40; xx += 0.25)
+		{
+			const std::size_t j1 = dmc::detail::bsearch_find(&x[0], n, xx);
+			const std::size_t j2 = dmc::detail::hinted_find(&x[0], n, xx, hint);
+
+			DCS_DEBUG_TRACE("x = " << xx << ", hint = " << hint << " ==> " << j1 << " vs. " << j2);
+			DCS_TEST_CHECK_EQUAL(j1, j2);
+		}
+	}
+}
+
+DCS_TEST_DEF( bilinear )
+{
+	DCS_TEST_TRACE("Bilinear");
+
+	typedef double real_type;
+
+	const std::size_t nx(4);
+	const std::size_t ny(3);
+
+	// f(x,y) = 1+2x-3y+xy, which is reproduced exactly by bilinear interpolation
+	std::vector<real_type> x(nx);
+	x[0] = 0; x[1] = 0.5; x[2] = 2; x[3] = 3;
+	std::vector<real_type> y(ny);
+	y[0] = -1; y[1] = 1; y[2] = 1.5;
+	std::vector<real_type> z(nx*ny);
+	for (std::size_t i = 0; i < nx; ++i)
+	{
+		for (std::size_t j = 0; j < ny; ++j)
+		{
+			z[i*ny+j] = 1+2*x[i]-3*y[j]+x[i]*y[j];
+		}
+	}
+
+	dmc::multilinear_interpolator<real_type> interp(x.begin(), x.end(),
+													y.begin(), y.end(),
+													z.begin(), z.end());
+
+	DCS_TEST_CHECK_EQUAL(interp.dimensions(), 2);
+
+	for (real_type xx = -0.5; xx <= 3.5; xx += 0.3)
+	{
+		for (real_type yy = -1.5; yy <= 2; yy += 0.2)
+		{
+			const real_type zz = interp(xx, yy);
+
+			DCS_DEBUG_TRACE("(" << xx << "," << yy << ") ==> " << zz);
+			DCS_TEST_CHECK_CLOSE(zz, 1+2*xx-3*yy+xx*yy, tol);
+		}
+	}
+}
+
+DCS_TEST_DEF( trilinear )
+{
+	DCS_TEST_TRACE("Trilinear");
+
+	typedef double real_type;
+
+	const std::size_t n(3);
+
+	// f(x,y,z) = x+2y+3z+xyz, which is reproduced exactly by trilinear interpolation
+	std::vector< std::vector<real_type> > axes(3, std::vector<real_type>(n));
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		axes[0][i] = i;
+		axes[1][i] = 2.0*i;
+		axes[2][i] = i*i;
+	}
+	std::vector<real_type> v;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			for (std::size_t k = 0; k < n; ++k)
+			{
+				const real_type xx(axes[0][i]);
+				const real_type yy(axes[1][j]);
+				const real_type zz(axes[2][k]);
+				v.push_back(xx+2*yy+3*zz+xx*yy*zz);
+			}
+		}
+	}
+
+	dmc::multilinear_interpolator<real_type> interp(axes.begin(), axes.end(), v.begin(), v.end());
+
+	DCS_TEST_CHECK_EQUAL(interp.dimensions(), 3);
+
+	for (real_type xx = 0; xx <= 2; xx += 0.25)
+	{
+		for (real_type yy = 0; yy <= 4; yy += 0.5)
+		{
+			for (real_type zz = 0; zz <= 4; zz += 0.5)
+			{
+				DCS_TEST_CHECK_CLOSE(interp(xx, yy, zz), xx+2*yy+3*zz+xx*yy*zz, tol);
+			}
+		}
+	}
+}
+
+DCS_TEST_DEF( batch )
+{
+	DCS_TEST_TRACE("Batch");
+
+	typedef double real_type;
+
+	const std::size_t nx(6);
+	const std::size_t ny(5);
+
+	std::vector<real_type> x(nx);
+	for (std::size_t i = 0; i < nx; ++i)
+	{
+		x[i] = i;
+	}
+	std::vector<real_type> y(ny);
+	for (std::size_t j = 0; j < ny; ++j)
+	{
+		y[j] = 0.5*j;
+	}
+	std::vector<real_type> z(nx*ny);
+	for (std::size_t i = 0; i < nx; ++i)
+	{
+		for (std::size_t j = 0; j < ny; ++j)
+		{
+			z[i*ny+j] = std::sin(x[i])*std::cos(y[j]);
+		}
+	}
+
+	dmc::multilinear_interpolator<real_type> linear(x.begin(), x.end(), y.begin(), y.end(), z.begin(), z.end());
+	dmc::tensor_cubic_spline_interpolator<real_type> spline(x.begin(), x.end(), y.begin(), y.end(), z.begin(), z.end(), dmc::natural_spline_boundary_condition);
+
+	// A coherent stream of points along a curve, plus some jumps
+	std::vector<real_type> pts;
+	for (real_type t = -0.5; t <= 6; t += 0.05)
+	{
+		pts.push_back(t);
+		pts.push_back(0.4*t);
+	}
+	pts.push_back(0.1);
+	pts.push_back(1.9);
+	pts.push_back(4.8);
+	pts.push_back(0.2);
+
+	const std::size_t np(pts.size()/2);
+
+	std::vector<real_type> out_linear(np);
+	std::vector<real_type> out_spline(np);
+	linear.interpolate(pts.begin(), pts.end(), out_linear.begin());
+	spline.interpolate(pts.begin(), pts.end(), out_spline.begin());
+
+	for (std::size_t i = 0; i < np; ++i)
+	{
+		DCS_TEST_CHECK_CLOSE(out_linear[i], linear(pts[2*i], pts[2*i+1]), tol);
+		DCS_TEST_CHECK_CLOSE(out_spline[i], spline(pts[2*i], pts[2*i+1]), tol);
+		DCS_TEST_CHECK_CLOSE(out_spline[i], spline.interpolate(pts.begin()+2*i), tol);
+	}
+}
+
+DCS_TEST_DEF( tensor_cubic_spline_nodes )
+{
+	DCS_TEST_TRACE("Tensor-product cubic spline - Nodes");
+
+	typedef double real_type;
+
+	const std::size_t n(5);
+
+	std::vector< std::vector<real_type> > axes(3, std::vector<real_type>(n));
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		axes[0][i] = i;
+		axes[1][i] = std::sqrt(static_cast<real_type>(i));
+		axes[2][i] = 0.5*i+1;
+	}
+	std::vector<real_type> v(n*n*n);
+	for (std::size_t i = 0; i < v.size(); ++i)
+	{
+		v[i] = std::cos(0.1*i);
+	}
+
+	dmc::tensor_cubic_spline_interpolator<real_type> interp(axes.begin(), axes.end(), v.begin(), v.end(), dmc::not_a_knot_spline_boundary_condition);
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			for (std::size_t k = 0; k < n; ++k)
+			{
+				DCS_TEST_CHECK_CLOSE(interp(axes[0][i], axes[1][j], axes[2][k]), v[(i*n+j)*n+k], tol);
+			}
+		}
+	}
+}
+
+DCS_TEST_DEF( tensor_cubic_spline_separable )
+{
+	DCS_TEST_TRACE("Tensor-product cubic spline - Separable data");
+
+	typedef double real_type;
+
+	const std::size_t nx(6);
+	const std::size_t ny(4);
+
+	// Data is g(x)h(y), so the tensor-product spline must be the product of the 1D splines
+	std::vector<real_type> x(nx);
+	std::vector<real_type> gx(nx);
+	for (std::size_t i = 0; i < nx; ++i)
+	{
+		x[i] = 0.3*i*i;
+		gx[i] = std::exp(-x[i]);
+	}
+	std::vector<real_type> y(ny);
+	std::vector<real_type> hy(ny);
+	for (std::size_t j = 0; j < ny; ++j)
+	{
+		y[j] = j;
+		hy[j] = 1+j*j;
+	}
+	std::vector<real_type> z(nx*ny);
+	for (std::size_t i = 0; i < nx; ++i)
+	{
+		for (std::size_t j = 0; j < ny; ++j)
+		{
+			z[i*ny+j] = gx[i]*hy[j];
+		}
+	}
+
+	dmc::cubic_spline_interpolator<real_type> spline_x(x.begin(), x.end(), gx.begin(), gx.end(), dmc::natural_spline_boundary_condition);
+	dmc::cubic_spline_interpolator<real_type> spline_y(y.begin(), y.end(), hy.begin(), hy.end(), dmc::natural_spline_boundary_condition);
+	dmc::tensor_cubic_spline_interpolator<real_type> interp(x.begin(), x.end(), y.begin(), y.end(), z.begin(), z.end(), dmc::natural_spline_boundary_condition);
+
+	for (real_type xx = -0.5; xx <= 8; xx += 0.35)
+	{
+		for (real_type yy = -0.5; yy <= 3.5; yy += 0.25)
+		{
+			const real_type zz = interp(xx, yy);
+
+			DCS_DEBUG_TRACE("(" << xx << "," << yy << ") ==> " << zz);
+			DCS_TEST_CHECK_CLOSE(zz, spline_x(xx)*spline_y(yy), tol);
+		}
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE("Gridded Data Interpolation");
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( hinted_find );
+		DCS_TEST_DO( bilinear );
+		DCS_TEST_DO( trilinear );
+		DCS_TEST_DO( batch );
+		DCS_TEST_DO( tensor_cubic_spline_nodes );
+		DCS_TEST_DO( tensor_cubic_spline_separable );
+	DCS_TEST_END();
+}
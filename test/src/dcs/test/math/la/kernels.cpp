@@ -0,0 +1,344 @@
+/**
+ * \file test/src/dcs/test/math/la/kernels.cpp
+ *
+ * \brief Test suite for the dense linear algebra kernels.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <cmath>
+#include <cstddef>
+#include <dcs/math/la.hpp>
+#include <dcs/math/la/detail/gemm.hpp>
+#include <dcs/math/la/detail/level1.hpp>
+#include <dcs/math/la/detail/simd.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/vector.hpp>
+#include <dcs/test.hpp>
+#include <vector>
+
+
+namespace math = ::dcs::math;
+
+typedef math::matrix< double, math::matrix_properties<math::row_major_storage_layout> > row_major_matrix;
+typedef math::matrix< double, math::matrix_properties<math::column_major_storage_layout> > col_major_matrix;
+typedef math::matrix< float, math::matrix_properties<math::row_major_storage_layout> > float_row_major_matrix;
+typedef math::vector<double> vector_type;
+
+
+namespace /*<unnamed>*/ { namespace detail {
+
+template <typename MatrixT>
+void fill(MatrixT& A, unsigned int seed)
+{
+	for (std::size_t i = 0; i < A.num_rows(); ++i)
+	{
+		for (std::size_t j = 0; j < A.num_columns(); ++j)
+		{
+			// Small integers, so that sums are exact
+			A(i,j) = static_cast<typename MatrixT::value_type>(static_cast<int>((i*7+j*3+seed) % 11) - 5);
+		}
+	}
+}
+
+template <typename MatrixT>
+void fill(MatrixT& A, std::size_t nr, std::size_t nc, unsigned int seed)
+{
+	A.resize(nr, nc, false);
+	fill(A, seed);
+}
+
+template <typename MatrixAT, typename MatrixBT, typename MatrixCT>
+void naive_gemm(double alpha, MatrixAT const& A, MatrixBT const& B, double beta, MatrixCT& C)
+{
+	for (std::size_t i = 0; i < C.num_rows(); ++i)
+	{
+		for (std::size_t j = 0; j < C.num_columns(); ++j)
+		{
+			double s(0);
+			for (std::size_t p = 0; p < A.num_columns(); ++p)
+			{
+				s += A(i,p)*B(p,j);
+			}
+			C(i,j) = alpha*s+beta*C(i,j);
+		}
+	}
+}
+
+template <typename MatrixAT, typename MatrixBT>
+bool equal(MatrixAT const& A, MatrixBT const& B, double tol)
+{
+	if (A.num_rows() != B.num_rows() || A.num_columns() != B.num_columns())
+	{
+		return false;
+	}
+	for (std::size_t i = 0; i < A.num_rows(); ++i)
+	{
+		for (std::size_t j = 0; j < A.num_columns(); ++j)
+		{
+			if (std::abs(A(i,j)-B(i,j)) > tol)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename MatrixAT, typename MatrixBT, typename MatrixCT>
+bool check_gemm(std::size_t m, std::size_t n, std::size_t k, std::size_t num_threads)
+{
+	MatrixAT A;
+	MatrixBT B;
+	MatrixCT C;
+	MatrixCT C_ok;
+
+	fill(A, m, k, 1);
+	fill(B, k, n, 2);
+	fill(C, m, n, 3);
+	fill(C_ok, m, n, 3);
+
+	math::la::gemm(2.0, A, B, -1.0, C, num_threads);
+	naive_gemm(2.0, A, B, -1.0, C_ok);
+
+	return equal(C, C_ok, 0);
+}
+
+template <typename T>
+bool check_isa(math::la::detail::simd_isa_category isa)
+{
+	namespace la_detail = math::la::detail;
+
+	// Sizes are not multiples of the register widths
+	const std::size_t m(23);
+	const std::size_t n(41);
+	const std::size_t k(37);
+
+	std::vector<T> a(m*k);
+	std::vector<T> b(k*n);
+	std::vector<T> c(m*n);
+	for (std::size_t i = 0; i < a.size(); ++i)
+	{
+		a[i] = static_cast<T>(static_cast<int>(i % 7)-3);
+	}
+	for (std::size_t i = 0; i < b.size(); ++i)
+	{
+		b[i] = static_cast<T>(static_cast<int>(i % 5)-2);
+	}
+	for (std::size_t i = 0; i < c.size(); ++i)
+	{
+		c[i] = static_cast<T>(static_cast<int>(i % 3)-1);
+	}
+	std::vector<T> c_ok(c);
+
+	la_detail::gemm(m, n, k, T(2), &a[0], k, 1, &b[0], n, 1, T(-1), &c[0], n, 1, isa);
+	la_detail::gemm(m, n, k, T(2), &a[0], k, 1, &b[0], n, 1, T(-1), &c_ok[0], n, 1, la_detail::no_simd_isa);
+	if (c != c_ok)
+	{
+		return false;
+	}
+
+	if (la_detail::dot(k, &a[0], 1, &b[0], 1, isa) != la_detail::dot(k, &a[0], 1, &b[0], 1, la_detail::no_simd_isa))
+	{
+		return false;
+	}
+
+	la_detail::axpy(n, T(3), &b[0], 1, &c[0], 1, isa);
+	la_detail::axpy(n, T(3), &b[0], 1, &c_ok[0], 1, la_detail::no_simd_isa);
+
+	return c == c_ok;
+}
+
+}} // Namespace <unnamed>::detail
+
+
+DCS_TEST_DEF( dot_axpy )
+{
+	DCS_TEST_CASE("Dot Product and AXPY");
+
+	const std::size_t n(37);
+
+	vector_type x(n);
+	vector_type y(n);
+	double s(0);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		x(i) = static_cast<double>(i);
+		y(i) = 2.0-static_cast<double>(i % 3);
+		s += x(i)*y(i);
+	}
+
+	DCS_TEST_CHECK_EQ( math::la::dot(x, y), s );
+
+	math::la::axpy(3.0, x, y);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ( y(i), 3.0*static_cast<double>(i)+2.0-static_cast<double>(i % 3) );
+	}
+}
+
+DCS_TEST_DEF( gemv )
+{
+	DCS_TEST_CASE("Matrix-Vector Product");
+
+	const std::size_t m(13);
+	const std::size_t n(21);
+
+	row_major_matrix A;
+	detail::fill(A, m, n, 4);
+	col_major_matrix A_cm(m, n);
+	detail::fill(A_cm, 4);
+
+	vector_type x(n);
+	for (std::size_t j = 0; j < n; ++j)
+	{
+		x(j) = static_cast<double>(j % 5)-2.0;
+	}
+
+	const vector_type y(math::la::prod(A, x));
+	vector_type y_cm(m, 1.0);
+	math::la::gemv(1.0, A_cm, x, 2.0, y_cm);
+
+	for (std::size_t i = 0; i < m; ++i)
+	{
+		double s(0);
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			s += A(i,j)*x(j);
+		}
+		DCS_TEST_CHECK_EQ( y(i), s );
+		DCS_TEST_CHECK_EQ( y_cm(i), s+2.0 );
+	}
+}
+
+DCS_TEST_DEF( gemm_layouts )
+{
+	DCS_TEST_CASE("Matrix-Matrix Product - Storage Layouts");
+
+	// Sizes are not multiples of the register and cache blocks, and k
+	// spans more than one cache block
+	const std::size_t m(37);
+	const std::size_t n(29);
+	const std::size_t k(300);
+
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,row_major_matrix,row_major_matrix>(m, n, k, 1)) );
+	DCS_TEST_CHECK( (detail::check_gemm<col_major_matrix,col_major_matrix,col_major_matrix>(m, n, k, 1)) );
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,col_major_matrix,row_major_matrix>(m, n, k, 1)) );
+	DCS_TEST_CHECK( (detail::check_gemm<col_major_matrix,row_major_matrix,col_major_matrix>(m, n, k, 1)) );
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,row_major_matrix,row_major_matrix>(1, 1, 1, 1)) );
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,row_major_matrix,row_major_matrix>(5, 3, 0, 1)) );
+}
+
+DCS_TEST_DEF( gemm_threads )
+{
+	DCS_TEST_CASE("Matrix-Matrix Product - Multiple Threads");
+
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,row_major_matrix,row_major_matrix>(131, 70, 45, 3)) );
+	DCS_TEST_CHECK( (detail::check_gemm<col_major_matrix,row_major_matrix,col_major_matrix>(131, 70, 45, 4)) );
+	DCS_TEST_CHECK( (detail::check_gemm<row_major_matrix,row_major_matrix,row_major_matrix>(2, 70, 45, 8)) );
+}
+
+DCS_TEST_DEF( gemm_float )
+{
+	DCS_TEST_CASE("Matrix-Matrix Product - Single Precision");
+
+	float_row_major_matrix A;
+	float_row_major_matrix B;
+	detail::fill(A, 19, 40, 5);
+	detail::fill(B, 40, 35, 6);
+
+	const float_row_major_matrix C(math::la::prod(A, B));
+
+	float_row_major_matrix C_ok(19, 35);
+	detail::naive_gemm(1.0, A, B, 0.0, C_ok);
+
+	DCS_TEST_CHECK( detail::equal(C, C_ok, 0) );
+}
+
+DCS_TEST_DEF( transpose )
+{
+	DCS_TEST_CASE("Matrix Transposition");
+
+	row_major_matrix A;
+	detail::fill(A, 45, 70, 7);
+
+	const row_major_matrix At(math::la::transpose(A));
+	col_major_matrix At_cm;
+	math::la::transpose(A, At_cm);
+
+	DCS_TEST_CHECK_EQ( At.num_rows(), A.num_columns() );
+	DCS_TEST_CHECK_EQ( At.num_columns(), A.num_rows() );
+	bool ok(true);
+	for (std::size_t i = 0; i < A.num_rows(); ++i)
+	{
+		for (std::size_t j = 0; j < A.num_columns(); ++j)
+		{
+			ok = ok && At(j,i) == A(i,j) && At_cm(j,i) == A(i,j);
+		}
+	}
+	DCS_TEST_CHECK( ok );
+}
+
+DCS_TEST_DEF( instruction_sets )
+{
+	DCS_TEST_CASE("Kernels - Instruction Sets");
+
+	namespace la_detail = math::la::detail;
+
+	// Every instruction set supported by this CPU gives the results of the
+	// scalar kernels
+	const la_detail::simd_isa_category isas[] = { la_detail::no_simd_isa,
+												  la_detail::avx2_simd_isa,
+												  la_detail::avx512_simd_isa };
+	for (std::size_t i = 0; i < sizeof(isas)/sizeof(isas[0]); ++i)
+	{
+		if (isas[i] <= la_detail::simd_default_isa())
+		{
+			DCS_TEST_CHECK( detail::check_isa<double>(isas[i]) );
+			DCS_TEST_CHECK( detail::check_isa<float>(isas[i]) );
+		}
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE("Dense Linear Algebra Kernels");
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( dot_axpy );
+		DCS_TEST_DO( gemv );
+		DCS_TEST_DO( gemm_layouts );
+		DCS_TEST_DO( gemm_threads );
+		DCS_TEST_DO( gemm_float );
+		DCS_TEST_DO( transpose );
+		DCS_TEST_DO( instruction_sets );
+	DCS_TEST_END();
+}
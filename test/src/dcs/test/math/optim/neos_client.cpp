@@ -0,0 +1,523 @@
+#include <algorithm>
+#include <boost/chrono.hpp>
+#include <boost/smart_ptr.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+#include <dcs/digest/md5.hpp>
+#include <dcs/digest/utility.hpp>
+#include <dcs/math/optim/neos/client.hpp>
+#include <dcs/math/optim/neos/job_manager.hpp>
+#include <dcs/math/optim/neos/mock_server.hpp>
+#include <dcs/math/optim/neos/results_sink.hpp>
+#include <dcs/math/optim/neos/results_tailer.hpp>
+#include <dcs/test.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <xmlrpc-c/client_transport.hpp>
+#include <xmlrpc-c/girerr.hpp>
+
+
+namespace dcs_optim = dcs::math::optim;
+
+
+namespace /*<unnamed>*/ {
+
+std::string make_job_xml(std::size_t i)
+{
+	std::ostringstream oss;
+	oss << "<document><model>job " << i << "</model></document>";
+	return oss.str();
+}
+
+/// Transport failing the n-th asynchronous call, as on a connection reset.
+class failing_transport: public xmlrpc_c::clientXmlTransport
+{
+	public: explicit failing_transport(boost::shared_ptr<xmlrpc_c::clientXmlTransport> const& p_trans)
+	: p_trans_(p_trans),
+	  num_calls_(0),
+	  fail_at_(0)
+	{
+	}
+
+	public: void fail_after(std::size_t n)
+	{
+		fail_at_ = num_calls_+n;
+	}
+
+	public: void call(xmlrpc_c::carriageParm* p_parm, std::string const& call_xml, std::string* p_res_xml)
+	{
+		p_trans_->call(p_parm, call_xml, p_res_xml);
+	}
+
+	public: void start(xmlrpc_c::carriageParm* p_parm, std::string const& call_xml, xmlrpc_c::xmlTransactionPtr const& p_trans)
+	{
+		if (++num_calls_ == fail_at_)
+		{
+			p_trans->finishErr(girerr::error("Connection reset"));
+			return;
+		}
+		p_trans_->start(p_parm, call_xml, p_trans);
+	}
+
+	public: void finishAsync(xmlrpc_c::timeout timeout)
+	{
+		p_trans_->finishAsync(timeout);
+	}
+
+
+	private: boost::shared_ptr<xmlrpc_c::clientXmlTransport> p_trans_;
+	private: std::size_t num_calls_;
+	private: std::size_t fail_at_;
+}; // failing_transport
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_blocking_calls )
+{
+	DCS_TEST_CASE("Blocking calls");
+
+	dcs_optim::neos_mock_server server(2);
+	const dcs_optim::neos_client neos(server.transport());
+
+	DCS_TEST_CHECK(neos.ping());
+	DCS_TEST_CHECK_EQ(neos.version(), std::string("mock"));
+
+	const std::string xml(make_job_xml(0));
+	const dcs_optim::neos_job_credentials creds(neos.submit_job(xml));
+	DCS_TEST_CHECK_EQ(creds.id, 1);
+	DCS_TEST_CHECK_EQ(neos.job_status(creds), dcs_optim::running_neos_job_status);
+	DCS_TEST_CHECK(neos.final_results(creds, false).empty());
+	DCS_TEST_CHECK_EQ(neos.job_status(creds), dcs_optim::done_neos_job_status);
+	DCS_TEST_CHECK_EQ(neos.final_results(creds), dcs_optim::neos_mock_server::result_of(xml));
+
+	dcs_optim::neos_job_credentials bad_creds(creds);
+	bad_creds.password = "wrong";
+	DCS_TEST_CHECK_EQ(neos.job_status(bad_creds), dcs_optim::bad_password_neos_job_status);
+	bad_creds.id = 42;
+	DCS_TEST_CHECK_EQ(neos.job_status(bad_creds), dcs_optim::unknown_job_neos_job_status);
+
+	DCS_TEST_CHECK_EQ(server.num_calls(), 9u);
+}
+
+DCS_TEST_DEF( test_async_calls )
+{
+	DCS_TEST_CASE("Pipelined asynchronous calls");
+
+	const std::size_t n(16);
+
+	dcs_optim::neos_mock_server server(3);
+	const dcs_optim::neos_client neos(server.transport());
+
+	// Submit all the jobs before waiting for any of them
+	std::vector< boost::shared_future<dcs_optim::neos_job_credentials> > futs;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		futs.push_back(neos.submit_job_async(make_job_xml(i)).share());
+	}
+	DCS_TEST_CHECK_EQ(server.num_pending_calls(), n);
+	DCS_TEST_CHECK_EQ(server.num_calls(), 0u);
+
+	// Waiting for the first job serves all of them
+	std::vector<dcs_optim::neos_job_credentials> creds;
+	creds.push_back(futs[0].get());
+	DCS_TEST_CHECK_EQ(server.num_pending_calls(), 0u);
+	for (std::size_t i = 1; i < n; ++i)
+	{
+		DCS_TEST_CHECK(futs[i].is_ready());
+		creds.push_back(futs[i].get());
+		DCS_TEST_CHECK_EQ(creds[i].id, static_cast<int>(i+1));
+	}
+	DCS_TEST_CHECK_EQ(server.num_submitted_jobs(), n);
+
+	// Poll all the jobs from this thread until they are done
+	std::size_t num_polls(0);
+	std::size_t num_done(0);
+	while (num_done < n)
+	{
+		const std::vector<dcs_optim::neos_job_status> statuses(neos.job_statuses(creds));
+		DCS_TEST_CHECK_EQ(statuses.size(), n);
+
+		num_done = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			if (statuses[i] == dcs_optim::done_neos_job_status)
+			{
+				++num_done;
+			}
+		}
+		++num_polls;
+	}
+	DCS_TEST_CHECK_EQ(num_polls, server.run_polls());
+	DCS_TEST_CHECK_EQ(server.max_num_pending_calls(), n);
+
+	std::vector< boost::shared_future<std::string> > results;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		results.push_back(neos.final_results_async(creds[i], false).share());
+	}
+	neos.wait_all();
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(results[i].get(), dcs_optim::neos_mock_server::result_of(make_job_xml(i)));
+	}
+}
+
+DCS_TEST_DEF( test_async_errors )
+{
+	DCS_TEST_CASE("Errors of asynchronous calls");
+
+	dcs_optim::neos_mock_server server;
+	const dcs_optim::neos_client neos(server.transport());
+
+	dcs_optim::neos_job_credentials creds;
+	creds.id = 7;
+	creds.password = "none";
+
+	boost::future<std::string> fut(neos.final_results_async(creds));
+	bool failed(false);
+	try
+	{
+		fut.get();
+	}
+	catch (std::runtime_error const& e)
+	{
+		DCS_DEBUG_TRACE("Caught expected error: " << e.what());
+		failed = true;
+	}
+	DCS_TEST_CHECK(failed);
+}
+
+DCS_TEST_DEF( test_shared_connection )
+{
+	DCS_TEST_CASE("Copies share the connection");
+
+	dcs_optim::neos_mock_server server;
+	const dcs_optim::neos_client neos(server.transport());
+	const dcs_optim::neos_client neos_copy(neos);
+
+	boost::future<dcs_optim::neos_job_credentials> fut1(neos.submit_job_async(make_job_xml(1)));
+	boost::future<dcs_optim::neos_job_credentials> fut2(neos_copy.submit_job_async(make_job_xml(2)));
+	DCS_TEST_CHECK_EQ(server.num_pending_calls(), 2u);
+	neos_copy.wait_all();
+	DCS_TEST_CHECK(fut1.is_ready());
+	DCS_TEST_CHECK_EQ(fut1.get().id, 1);
+	DCS_TEST_CHECK_EQ(fut2.get().id, 2);
+}
+
+DCS_TEST_DEF( test_intermediate_results )
+{
+	DCS_TEST_CASE("Intermediate results");
+
+	// A blocking request ends the job after the first iteration
+	const std::string log("Iteration 1\nOptimal solution found\n");
+
+	dcs_optim::neos_mock_server server(2);
+	const dcs_optim::neos_client neos(server.transport());
+
+	const dcs_optim::neos_job_credentials creds(neos.submit_job(make_job_xml(0)));
+
+	int offset(0);
+	DCS_TEST_CHECK(neos.intermediate_results(creds, offset, false).empty());
+	DCS_TEST_CHECK_EQ(offset, 0);
+	neos.job_status(creds);
+	DCS_TEST_CHECK_EQ(neos.intermediate_results(creds, offset, false), std::string("Iteration 1\n"));
+	DCS_TEST_CHECK_EQ(offset, 12);
+
+	// Blocking requests wait for the job to be over
+	std::string out;
+	dcs_optim::neos_string_sink sink(out);
+	DCS_TEST_CHECK_EQ(neos.intermediate_results(creds, offset, sink), log.size()-12);
+	DCS_TEST_CHECK_EQ(out, log.substr(12));
+	DCS_TEST_CHECK_EQ(offset, static_cast<int>(log.size()));
+	DCS_TEST_CHECK_EQ(neos.intermediate_results(creds, offset, sink), 0u);
+}
+
+DCS_TEST_DEF( test_results_tailer )
+{
+	DCS_TEST_CASE("Tailing the output of many jobs");
+
+	const std::size_t n(4);
+	const std::string log("Iteration 1\nIteration 2\nIteration 3\nOptimal solution found\n");
+
+	dcs_optim::neos_mock_server server(3);
+	const dcs_optim::neos_client neos(server.transport());
+	dcs_optim::neos_results_tailer tailer(neos);
+
+	std::vector<std::string> outs(n);
+	std::vector<dcs_optim::neos_string_sink> sinks;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		sinks.push_back(dcs_optim::neos_string_sink(outs[i]));
+	}
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		tailer.add(neos.submit_job(make_job_xml(i)), sinks[i]);
+	}
+	DCS_TEST_CHECK_EQ(tailer.num_jobs(), n);
+
+	std::size_t num_polls(0);
+	std::size_t num_bytes(0);
+	while (!tailer.empty() && num_polls < 10)
+	{
+		num_bytes += tailer.poll();
+		++num_polls;
+	}
+	DCS_TEST_CHECK(tailer.empty());
+	// One more poll fetches the remaining output of done jobs
+	DCS_TEST_CHECK_EQ(num_polls, server.run_polls()+1);
+	DCS_TEST_CHECK_EQ(num_bytes, n*log.size());
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(outs[i], log);
+		DCS_TEST_CHECK(sinks[i].finished());
+		DCS_TEST_CHECK_EQ(sinks[i].status(), dcs_optim::done_neos_job_status);
+	}
+
+	// Every poll of every job is two pipelined calls
+	DCS_TEST_CHECK_EQ(server.max_num_pending_calls(), 2*n);
+}
+
+DCS_TEST_DEF( test_results_tailer_back_pressure )
+{
+	DCS_TEST_CASE("Back-pressure of results sinks");
+
+	const std::string log("Iteration 1\nOptimal solution found\n");
+
+	dcs_optim::neos_mock_server server(1);
+	const dcs_optim::neos_client neos(server.transport());
+	dcs_optim::neos_results_tailer tailer(neos);
+
+	// The sink gets full as soon as it holds anything
+	std::string out;
+	dcs_optim::neos_string_sink sink(out, 1);
+	tailer.add(neos.submit_job(make_job_xml(0)), sink);
+
+	// First poll: the job is done but its output is still on the server
+	DCS_TEST_CHECK_EQ(tailer.poll(), 0u);
+	// Second poll: all the output is delivered and the job is over
+	DCS_TEST_CHECK_EQ(tailer.poll(), log.size());
+	DCS_TEST_CHECK(tailer.empty());
+	DCS_TEST_CHECK(sink.finished());
+
+	// A full sink stops the polling of its job until it is drained
+	std::string full_out("x");
+	dcs_optim::neos_string_sink full_sink(full_out, 1);
+	tailer.add(neos.submit_job(make_job_xml(1)), full_sink);
+
+	const std::size_t num_calls(server.num_calls());
+	DCS_TEST_CHECK_EQ(tailer.poll(), 0u);
+	DCS_TEST_CHECK_EQ(tailer.poll(), 0u);
+	DCS_TEST_CHECK_EQ(server.num_calls(), num_calls);
+	DCS_TEST_CHECK_EQ(tailer.num_jobs(), 1u);
+
+	full_out.clear();
+	tailer.poll();
+	tailer.poll();
+	DCS_TEST_CHECK(tailer.empty());
+	DCS_TEST_CHECK_EQ(full_out, log);
+
+	// Jobs unknown to the server are dropped at once
+	dcs_optim::neos_job_credentials bad_creds;
+	bad_creds.id = 99;
+	bad_creds.password = "none";
+	std::string bad_out;
+	dcs_optim::neos_string_sink bad_sink(bad_out);
+	tailer.add(bad_creds, bad_sink);
+	tailer.poll();
+	DCS_TEST_CHECK(tailer.empty());
+	DCS_TEST_CHECK_EQ(bad_sink.status(), dcs_optim::unknown_job_neos_job_status);
+}
+
+
+DCS_TEST_DEF( test_results_tailer_errors )
+{
+	DCS_TEST_CASE("Errors while tailing the output of many jobs");
+
+	const std::size_t n(3);
+	const std::string log("Iteration 1\nOptimal solution found\n");
+
+	dcs_optim::neos_mock_server server(1);
+	failing_transport* p_trans(new failing_transport(server.transport()));
+	const dcs_optim::neos_client neos((boost::shared_ptr<xmlrpc_c::clientXmlTransport>(p_trans)));
+	dcs_optim::neos_results_tailer tailer(neos);
+
+	std::vector<std::string> outs(n);
+	std::vector<dcs_optim::neos_string_sink> sinks;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		sinks.push_back(dcs_optim::neos_string_sink(outs[i]));
+	}
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		tailer.add(neos.submit_job(make_job_xml(i)), sinks[i]);
+	}
+
+	// All the jobs are done after the first poll, so the second one only
+	// fetches their output: make the request of the last job fail
+	tailer.poll();
+	p_trans->fail_after(n);
+	bool failed(false);
+	try
+	{
+		tailer.poll();
+	}
+	catch (std::exception const& e)
+	{
+		failed = true;
+		DCS_DEBUG_TRACE("Caught expected error: " << e.what());
+	}
+	DCS_TEST_CHECK(failed);
+	DCS_TEST_CHECK_EQ(tailer.num_jobs(), 1u);
+
+	// The failed job is polled again, and no sink is finished twice
+	tailer.poll();
+	DCS_TEST_CHECK(tailer.empty());
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK(sinks[i].finished());
+		DCS_TEST_CHECK_EQ(outs[i], log);
+	}
+}
+
+
+DCS_TEST_DEF( test_job_manager )
+{
+	DCS_TEST_CASE("Job manager with deduplication and in-flight limit");
+
+	const std::size_t n(12);
+	const std::size_t max_in_flight(4);
+
+	dcs_optim::neos_mock_server server(3);
+	const dcs_optim::neos_client neos(server.transport());
+
+	dcs_optim::neos_job_manager mgr(neos);
+	mgr.max_in_flight(max_in_flight);
+	mgr.poll_interval(boost::chrono::milliseconds(0), boost::chrono::milliseconds(0), 1);
+
+	// Every job is submitted twice
+	std::vector< dcs_optim::neos_job_manager::result_future > futs;
+	for (std::size_t i = 0; i < 2*n; ++i)
+	{
+		futs.push_back(mgr.submit(make_job_xml(i % n)));
+	}
+	DCS_TEST_CHECK_EQ(mgr.num_pending(), n);
+	DCS_TEST_CHECK_EQ(mgr.num_hits(), n);
+
+	std::size_t max_seen(0);
+	while (mgr.step() > 0)
+	{
+		max_seen = std::max(max_seen, mgr.num_in_flight());
+	}
+	DCS_TEST_CHECK_EQ(max_seen, max_in_flight);
+	DCS_TEST_CHECK_EQ(mgr.num_neos_jobs(), n);
+	DCS_TEST_CHECK_EQ(server.num_submitted_jobs(), n);
+
+	for (std::size_t i = 0; i < 2*n; ++i)
+	{
+		DCS_TEST_CHECK(futs[i].is_ready());
+		DCS_TEST_CHECK_EQ(futs[i].get(), dcs_optim::neos_mock_server::result_of(make_job_xml(i % n)));
+	}
+
+	// Finished jobs are not run again
+	DCS_TEST_CHECK_EQ(mgr.submit(make_job_xml(0)).get(), dcs_optim::neos_mock_server::result_of(make_job_xml(0)));
+	DCS_TEST_CHECK_EQ(server.num_submitted_jobs(), n);
+}
+
+DCS_TEST_DEF( test_job_manager_futures )
+{
+	DCS_TEST_CASE("Waiting on job manager futures");
+
+	dcs_optim::neos_mock_server server(2);
+	const dcs_optim::neos_client neos(server.transport());
+
+	dcs_optim::neos_job_manager mgr(neos);
+	mgr.max_in_flight(1);
+	mgr.poll_interval(boost::chrono::milliseconds(0), boost::chrono::milliseconds(0), 1);
+
+	dcs_optim::neos_job_manager::result_future fut1(mgr.submit(make_job_xml(1)));
+	dcs_optim::neos_job_manager::result_future fut2(mgr.submit(make_job_xml(2)));
+
+	// Waiting for a job only runs the manager until that job is done
+	DCS_TEST_CHECK_EQ(fut1.get(), dcs_optim::neos_mock_server::result_of(make_job_xml(1)));
+	DCS_TEST_CHECK(!fut2.is_ready());
+	DCS_TEST_CHECK_EQ(fut2.get(), dcs_optim::neos_mock_server::result_of(make_job_xml(2)));
+	DCS_TEST_CHECK_EQ(mgr.num_pending(), 0u);
+}
+
+DCS_TEST_DEF( test_job_manager_cache )
+{
+	DCS_TEST_CASE("Job manager with a results cache");
+
+	const std::size_t n(3);
+
+	char dir_templ[] = "/tmp/dcs_neos_cacheXXXXXX";
+	const std::string dir(::mkdtemp(dir_templ));
+
+	dcs_optim::neos_mock_server server(1);
+	const dcs_optim::neos_client neos(server.transport());
+
+	{
+		dcs_optim::neos_job_manager mgr(neos, dir);
+		mgr.poll_interval(boost::chrono::milliseconds(0), boost::chrono::milliseconds(0), 1);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			mgr.submit(make_job_xml(i));
+		}
+		mgr.run();
+		DCS_TEST_CHECK_EQ(mgr.num_neos_jobs(), n);
+	}
+
+	// A new manager finds the results of the previous one
+	dcs_optim::neos_job_manager mgr(neos, dir);
+	for (std::size_t i = 0; i <= n; ++i)
+	{
+		DCS_TEST_CHECK_EQ(mgr.submit(make_job_xml(i)).is_ready(), i < n);
+	}
+	DCS_TEST_CHECK_EQ(mgr.num_hits(), n);
+	DCS_TEST_CHECK_EQ(mgr.num_pending(), 1u);
+	DCS_TEST_CHECK_EQ(mgr.submit(make_job_xml(0)).get(), dcs_optim::neos_mock_server::result_of(make_job_xml(0)));
+	mgr.run();
+	DCS_TEST_CHECK_EQ(server.num_submitted_jobs(), n+1);
+
+	// Results are delivered even if they cannot be cached
+	{
+		dcs_optim::neos_job_manager bad_mgr(neos, dir+"/missing");
+		bad_mgr.poll_interval(boost::chrono::milliseconds(0), boost::chrono::milliseconds(0), 1);
+		boost::shared_future<std::string> fut(bad_mgr.submit(make_job_xml(0)));
+		bad_mgr.run();
+		DCS_TEST_CHECK_EQ(fut.get(), dcs_optim::neos_mock_server::result_of(make_job_xml(0)));
+	}
+
+	for (std::size_t i = 0; i <= n; ++i)
+	{
+		dcs::digest::md5_algorithm md5;
+		const std::vector<dcs::digest::byte_type> dig(md5.digest(make_job_xml(i)));
+		std::remove((dir+"/"+dcs::digest::hex_string(&dig[0], dig.size())+".neos").c_str());
+	}
+	std::remove(dir.c_str());
+}
+
+
+int main()
+{
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_blocking_calls );
+	DCS_TEST_DO( test_async_calls );
+	DCS_TEST_DO( test_async_errors );
+	DCS_TEST_DO( test_shared_connection );
+	DCS_TEST_DO( test_intermediate_results );
+	DCS_TEST_DO( test_results_tailer );
+	DCS_TEST_DO( test_results_tailer_back_pressure );
+	DCS_TEST_DO( test_results_tailer_errors );
+	DCS_TEST_DO( test_job_manager );
+	DCS_TEST_DO( test_job_manager_futures );
+	DCS_TEST_DO( test_job_manager_cache );
+
+	DCS_TEST_END();
+}
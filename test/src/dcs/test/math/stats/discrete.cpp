@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <dcs/debug.hpp>
 #include <dcs/functional/bind.hpp>
+#include <dcs/iterator/any_chunked_range.hpp>
 //#include <dcs/iterator/any_forward_iterator.hpp>
 #include <dcs/iterator/counting_iterator.hpp>
 //#include <dcs/iterator/iterator_range.hpp>
@@ -36,40 +37,44 @@ struct close_to: std::binary_function<T,T,bool>
 } // Namespace detail
 
 
-//DCS_TEST_DEF( test_discrete_get_probs_range )
-//{
-//	DCS_DEBUG_TRACE( "TEST discrete distribution -- probabilities getter" );
-//
-//	typedef double real_type;
-//	typedef dcs::math::stats::discrete_distribution<real_type> distribution_type;
-//
-//	std::vector<std::string> events;
-//	events.push_back("apple");
-//	events.push_back("pear");
-//	events.push_back("peach");
-//	events.push_back("banana");
-//
-//	std::vector<real_type> freqs;
-//	freqs.push_back(0.5);
-//	freqs.push_back(0.2);
-//	freqs.push_back(0.8);
-//	freqs.push_back(0.6);
-//
-//	distribution_type dist(freqs.begin(), freqs.end());
-//	real_type freqs_sum = dcs::math::sum<real_type>(freqs.begin(), freqs.end());
-//
-//	dcs::iterator::iterator_range< dcs::iterator::any_forward_iterator<real_type> > probs_range = dist.probabilities();
-//
-//	std::size_t i = 0;
-//	for (
-//		dcs::iterator::any_forward_iterator<real_type> it = probs_range.begin();
-//		it != probs_range.end();
-//		++it, ++i
-//	) {
-//		DCS_DEBUG_TRACE("P(X==" << events[i] << ")=" << *it << " ==> " << (freqs[i]/freqs_sum));
-//		DCS_TEST_CHECK_CLOSE(*it, freqs[i]/freqs_sum, tol);
-//	}
-//}
+DCS_TEST_DEF( test_discrete_get_probs_range )
+{
+	DCS_DEBUG_TRACE( "TEST discrete distribution -- probabilities range getter" );
+
+	typedef double real_type;
+	typedef dcs::math::stats::discrete_distribution<real_type> distribution_type;
+
+	std::vector<std::string> events;
+	events.push_back("apple");
+	events.push_back("pear");
+	events.push_back("peach");
+	events.push_back("banana");
+
+	std::vector<real_type> freqs;
+	freqs.push_back(0.5);
+	freqs.push_back(0.2);
+	freqs.push_back(0.8);
+	freqs.push_back(0.6);
+
+	distribution_type dist(freqs.begin(), freqs.end());
+	real_type freqs_sum = dcs::math::sum<real_type>(freqs.begin(), freqs.end());
+
+	dcs::iterator::any_chunked_range<real_type> probs_range = dist.probability_range();
+
+	DCS_TEST_CHECK_EQ(probs_range.size(), freqs.size());
+
+	std::size_t i = 0;
+	while (i < probs_range.size())
+	{
+		real_type const* probs = 0;
+		std::size_t n = probs_range.chunk(i, probs, 0, 0);
+		for (std::size_t k = 0; k < n; ++k, ++i)
+		{
+			DCS_DEBUG_TRACE("P(X==" << events[i] << ")=" << probs[k] << " ==> " << (freqs[i]/freqs_sum));
+			DCS_TEST_CHECK_CLOSE(probs[k], freqs[i]/freqs_sum, tol);
+		}
+	}
+}
 
 
 DCS_TEST_DEF( test_discrete_get_probs_vector )
@@ -372,7 +377,7 @@ int main()
 	DCS_TEST_BEGIN();
 
 	DCS_TEST_DO(test_discrete_get_probs_vector);
-	//DCS_TEST_DO(test_discrete_get_probs_range);
+	DCS_TEST_DO(test_discrete_get_probs_range);
 	DCS_TEST_DO(test_discrete_pdf);
 	DCS_TEST_DO(test_discrete_pdf_free);
 	DCS_TEST_DO(test_discrete_cdf);
@@ -0,0 +1,202 @@
+/**
+ * \file test/src/dcs/test/math/type/expression.cpp
+ *
+ * \brief Test suite for vector and matrix expressions.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <cmath>
+#include <cstddef>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/vector.hpp>
+#include <dcs/test.hpp>
+
+
+const double tol(1e-5); ///< Tolerance for floating-point equality comparison
+
+
+DCS_TEST_DEF( vector_arithmetic )
+{
+	DCS_TEST_CASE("Vector Expressions - Arithmetic");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const std::size_t n(11);
+
+	math::vector<value_type> a(n);
+	math::vector<value_type> b(n);
+	math::vector<value_type> c(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		a(i) = static_cast<value_type>(i);
+		b(i) = 2.0-static_cast<value_type>(i);
+		c(i) = 0.5*static_cast<value_type>(i % 3);
+	}
+
+	const math::vector<value_type> r(a + 2.0*element_prod(b, c) - abs(b)/4.0);
+	math::vector<value_type> s;
+	s = -a + b*3.0 - element_div(c, a+1.0*c+1.0*b);
+
+	DCS_TEST_CHECK_EQ( r.length(), n );
+	DCS_TEST_CHECK_EQ( s.length(), n );
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_CLOSE( r(i), a(i)+2.0*b(i)*c(i)-std::abs(b(i))/4.0, tol );
+		DCS_TEST_CHECK_CLOSE( s(i), -a(i)+b(i)*3.0-c(i)/(a(i)+c(i)+b(i)), tol );
+	}
+}
+
+DCS_TEST_DEF( vector_aliasing_and_update )
+{
+	DCS_TEST_CASE("Vector Expressions - Aliasing and Compound Assignment");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const std::size_t n(7);
+
+	math::vector<value_type> a(n, 1.0);
+	math::vector<value_type> b(n, 2.0);
+
+	value_type const* data(a.begin_data());
+
+	a = a + b;
+	a += 2.0*b;
+	a -= b;
+	a *= 3.0;
+	a /= 2.0;
+
+	// No reallocation when the vector is an operand
+	DCS_TEST_CHECK( a.begin_data() == data );
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_TEST_CHECK_CLOSE( a(i), 7.5, tol );
+	}
+}
+
+DCS_TEST_DEF( vector_cumsum_and_reductions )
+{
+	DCS_TEST_CASE("Vector Expressions - Cumulative Sum and Reductions");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const std::size_t n(6);
+
+	math::vector<value_type> a(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		a(i) = (i % 2) ? -static_cast<value_type>(i) : static_cast<value_type>(i);
+	}
+
+	const math::vector<value_type> s(cumsum(2.0*a));
+	value_type cs(0);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		cs += 2.0*a(i);
+		DCS_TEST_CHECK_CLOSE( s(i), cs, tol );
+	}
+	// Out-of-order access
+	DCS_TEST_CHECK_CLOSE( cumsum(a)(1), -1, tol );
+
+	DCS_TEST_CHECK_CLOSE( sum(a), -3, tol );
+	DCS_TEST_CHECK_CLOSE( norm_1(a), 15, tol );
+	DCS_TEST_CHECK_CLOSE( norm_2(a), std::sqrt(55.0), tol );
+	DCS_TEST_CHECK_CLOSE( norm_inf(a), 5, tol );
+	DCS_TEST_CHECK_CLOSE( max(a), 4, tol );
+	DCS_TEST_CHECK_CLOSE( min(a+a), -10, tol );
+}
+
+DCS_TEST_DEF( matrix_arithmetic )
+{
+	DCS_TEST_CASE("Matrix Expressions - Arithmetic and Storage Layouts");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+	typedef math::matrix< value_type, math::matrix_properties<math::row_major_storage_layout> > row_major_matrix_type;
+	typedef math::matrix< value_type, math::matrix_properties<math::column_major_storage_layout> > col_major_matrix_type;
+
+	const std::size_t nr(4);
+	const std::size_t nc(3);
+
+	row_major_matrix_type A(nr, nc);
+	col_major_matrix_type B(nr, nc);
+	for (std::size_t r = 0; r < nr; ++r)
+	{
+		for (std::size_t c = 0; c < nc; ++c)
+		{
+			A(r,c) = static_cast<value_type>(r*nc+c);
+			B(r,c) = static_cast<value_type>(r)-static_cast<value_type>(c);
+		}
+	}
+
+	// Same layout
+	const row_major_matrix_type C(2.0*A - A/2.0);
+	// Mixed layouts, to a row-major and to a column-major matrix
+	row_major_matrix_type D;
+	D = A + element_prod(B, B);
+	col_major_matrix_type E(abs(-B) - A);
+	E += B;
+
+	for (std::size_t r = 0; r < nr; ++r)
+	{
+		for (std::size_t c = 0; c < nc; ++c)
+		{
+			DCS_TEST_CHECK_CLOSE( C(r,c), 1.5*A(r,c), tol );
+			DCS_TEST_CHECK_CLOSE( D(r,c), A(r,c)+B(r,c)*B(r,c), tol );
+			DCS_TEST_CHECK_CLOSE( E(r,c), std::abs(B(r,c))-A(r,c)+B(r,c), tol );
+		}
+	}
+
+	DCS_TEST_CHECK_CLOSE( sum(A), 66, tol );
+	DCS_TEST_CHECK_CLOSE( sum(A+B), 72, tol );
+	DCS_TEST_CHECK_CLOSE( max(A-B), 10, tol );
+	DCS_TEST_CHECK_CLOSE( min(B), -2, tol );
+	DCS_TEST_CHECK_CLOSE( norm_frobenius(A), std::sqrt(506.0), tol );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE("Vector and Matrix Expressions Test Suite");
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( vector_arithmetic );
+		DCS_TEST_DO( vector_aliasing_and_update );
+		DCS_TEST_DO( vector_cumsum_and_reductions );
+		DCS_TEST_DO( matrix_arithmetic );
+	DCS_TEST_END();
+}
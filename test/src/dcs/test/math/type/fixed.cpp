@@ -0,0 +1,175 @@
+/**
+ * \file test/src/dcs/test/math/type/fixed.cpp
+ *
+ * \brief Test suite for fixed-size matrices and vectors.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2013       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+
+#include <cstddef>
+#include <dcs/math/la/fixed.hpp>
+#include <dcs/math/type/fixed_matrix.hpp>
+#include <dcs/math/type/fixed_vector.hpp>
+#include <dcs/math/type/matrix.hpp>
+#include <dcs/math/type/vector.hpp>
+#include <dcs/test.hpp>
+
+
+const double tol(1e-5); ///< Tolerance for floating-point equality comparison
+
+
+DCS_TEST_DEF( fixed_vector_ops )
+{
+	DCS_TEST_CASE("Fixed-Size Vector - Operations and Interoperability");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+	typedef math::fixed_vector<value_type,3> vector_type;
+
+	vector_type a;
+	const vector_type b(2.0);
+
+	DCS_TEST_CHECK_EQ( vector_type::static_size, 3u );
+	DCS_TEST_CHECK_EQ( a.length(), 3u );
+	DCS_TEST_CHECK_EQ( sizeof(vector_type) >= 3*sizeof(value_type), true );
+	DCS_TEST_CHECK_CLOSE( a(1), 0, tol );
+
+	a(0) = 1;
+	a(1) = -2;
+	a(2) = 3;
+
+	// Expressions mixing fixed-size and dynamic vectors
+	const math::vector<value_type> v(a + 2.0*b);
+	vector_type c(v - b);
+	c += a;
+	c *= 0.5;
+
+	DCS_TEST_CHECK_EQ( v.length(), 3u );
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		DCS_TEST_CHECK_CLOSE( v(i), a(i)+4.0, tol );
+		DCS_TEST_CHECK_CLOSE( c(i), a(i)+1.0, tol );
+	}
+	DCS_TEST_CHECK_CLOSE( sum(a), 2, tol );
+	DCS_TEST_CHECK_CLOSE( norm_inf(a), 3, tol );
+}
+
+DCS_TEST_DEF( fixed_matrix_ops )
+{
+	DCS_TEST_CASE("Fixed-Size Matrix - Operations and Interoperability");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+	typedef math::fixed_matrix<value_type,2,3> matrix_type;
+	typedef math::fixed_matrix<value_type,2,3,math::matrix_properties<math::column_major_storage_layout> > col_major_matrix_type;
+
+	matrix_type A;
+	col_major_matrix_type B;
+	for (std::size_t r = 0; r < 2; ++r)
+	{
+		for (std::size_t c = 0; c < 3; ++c)
+		{
+			A(r,c) = static_cast<value_type>(r*3+c);
+			B(r,c) = static_cast<value_type>(c);
+		}
+	}
+
+	DCS_TEST_CHECK_EQ( matrix_type::static_num_rows, 2u );
+	DCS_TEST_CHECK_EQ( matrix_type::static_num_columns, 3u );
+	DCS_TEST_CHECK_EQ( A.num_elements(), 6u );
+	DCS_TEST_CHECK_EQ( A.leading_dimension(), 3u );
+	DCS_TEST_CHECK_EQ( B.leading_dimension(), 2u );
+	DCS_TEST_CHECK_CLOSE( A.begin_data()[4], 4, tol );
+	DCS_TEST_CHECK_CLOSE( B.begin_data()[4], 2, tol );
+
+	// Conversion to and from dynamic matrices, with mixed layouts
+	const math::matrix<value_type> M(A - B);
+	col_major_matrix_type D(M);
+	D += B;
+	D /= 2.0;
+
+	for (std::size_t r = 0; r < 2; ++r)
+	{
+		for (std::size_t c = 0; c < 3; ++c)
+		{
+			DCS_TEST_CHECK_CLOSE( M(r,c), A(r,c)-B(r,c), tol );
+			DCS_TEST_CHECK_CLOSE( D(r,c), A(r,c)/2.0, tol );
+		}
+	}
+}
+
+DCS_TEST_DEF( fixed_prod )
+{
+	DCS_TEST_CASE("Fixed-Size Matrix - Products and Transposition");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	math::fixed_matrix<value_type,2,2> P;
+	P(0,0) = 0.9; P(0,1) = 0.1;
+	P(1,0) = 0.4; P(1,1) = 0.6;
+
+	const math::fixed_matrix<value_type,2,2> P2(math::la::prod(P, P));
+
+	DCS_TEST_CHECK_CLOSE( P2(0,0), 0.85, tol );
+	DCS_TEST_CHECK_CLOSE( P2(0,1), 0.15, tol );
+	DCS_TEST_CHECK_CLOSE( P2(1,0), 0.6, tol );
+	DCS_TEST_CHECK_CLOSE( P2(1,1), 0.4, tol );
+
+	math::fixed_vector<value_type,2> x;
+	x(0) = 1;
+	x(1) = 2;
+	const math::fixed_vector<value_type,2> y(math::la::prod(P, x));
+
+	DCS_TEST_CHECK_CLOSE( y(0), 1.1, tol );
+	DCS_TEST_CHECK_CLOSE( y(1), 1.6, tol );
+
+	math::fixed_matrix<value_type,2,3> A;
+	A(0,2) = 5;
+	const math::fixed_matrix<value_type,3,2> At(math::la::transpose(A));
+
+	DCS_TEST_CHECK_CLOSE( At(2,0), 5, tol );
+	DCS_TEST_CHECK_CLOSE( At(0,1), 0, tol );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE("Fixed-Size Matrix and Vector Test Suite");
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( fixed_vector_ops );
+		DCS_TEST_DO( fixed_matrix_ops );
+		DCS_TEST_DO( fixed_prod );
+	DCS_TEST_END();
+}
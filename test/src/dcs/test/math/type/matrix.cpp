@@ -1,5 +1,9 @@
+#include <boost/cstdint.hpp>
 #include <cstddef>
 #include <dcs/math/type/matrix.hpp>
+#if __cplusplus >= 201103L
+# include <utility>
+#endif // __cplusplus >= 201103L
 #include <dcs/test.hpp>
 
 
@@ -389,6 +393,104 @@ DCS_TEST_DEF( real_col_major_resize_to_empty )
 }
 
 
+DCS_TEST_DEF( real_uninitialized_create )
+{
+	DCS_TEST_CASE("Dense Matrix - Real Type - Uninitialized Matrix Creation");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const std::size_t nr(3);
+	const std::size_t nc(2);
+
+	math::matrix<value_type> A(nr, nc, math::uninitialized);
+
+	DCS_TEST_CHECK_EQ(    nr, A.num_rows() );
+	DCS_TEST_CHECK_EQ(    nc, A.num_columns() );
+	DCS_TEST_CHECK_EQ( nr*nc, A.num_elements() );
+	DCS_TEST_CHECK_EQ( nr*nc, A.capacity() );
+	DCS_TEST_CHECK_EQ( false, A.empty() );
+	DCS_TEST_CHECK_EQ(     0, reinterpret_cast< ::boost::uintptr_t >(A.begin_data()) % ::dcs::memory::default_alignment );
+}
+
+DCS_TEST_DEF( real_resize_reuse_storage )
+{
+	DCS_TEST_CASE("Dense Matrix - Real Type - Resize Reusing Storage");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const value_type zero(0);
+
+	math::matrix< value_type, math::matrix_properties<math::row_major_storage_layout> > A(3,2);
+	A(0,0) = 0; A(0,1) = 1;
+	A(1,0) = 2; A(1,1) = 3;
+	A(2,0) = 4; A(2,1) = 5;
+
+	value_type const* data = A.begin_data();
+
+	// Same leading dimension: data is preserved in place
+	A.resize(2,2);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 6, A.capacity() );
+	DCS_TEST_CHECK_CLOSE( 0, A(0,0), tol );
+	DCS_TEST_CHECK_CLOSE( 1, A(0,1), tol );
+	DCS_TEST_CHECK_CLOSE( 2, A(1,0), tol );
+	DCS_TEST_CHECK_CLOSE( 3, A(1,1), tol );
+
+	A.resize(3,2);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK_CLOSE(    2, A(1,0), tol );
+	DCS_TEST_CHECK_CLOSE( zero, A(2,0), tol );
+	DCS_TEST_CHECK_CLOSE( zero, A(2,1), tol );
+
+	A.resize(1,5, math::uninitialized);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 5, A.num_elements() );
+
+	A.resize(2,3, false);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK_CLOSE( zero, A(1,2), tol );
+}
+
+DCS_TEST_DEF( real_copy_and_swap )
+{
+	DCS_TEST_CASE("Dense Matrix - Real Type - Copy and Swap");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	math::matrix<value_type> A(2,2,1);
+	math::matrix<value_type> B(3,3,2);
+
+	value_type const* data = B.begin_data();
+
+	// Copy-assignment reuses the larger storage
+	B = A;
+	DCS_TEST_CHECK( B.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 2, B.num_rows() );
+	DCS_TEST_CHECK_EQ( 2, B.num_columns() );
+	DCS_TEST_CHECK_CLOSE( 1, B(1,1), tol );
+
+	value_type const* data_a = A.begin_data();
+	swap(A, B);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK( B.begin_data() == data_a );
+
+#if __cplusplus >= 201103L
+	math::matrix<value_type> C(std::move(A));
+	DCS_TEST_CHECK( C.begin_data() == data );
+	DCS_TEST_CHECK( A.empty() );
+	A = std::move(C);
+	DCS_TEST_CHECK( A.begin_data() == data );
+	DCS_TEST_CHECK_CLOSE( 1, A(1,1), tol );
+#endif // __cplusplus >= 201103L
+}
+
+
 int main()
 {
 	DCS_TEST_SUITE("Matrix Test Suite");
@@ -408,5 +510,8 @@ int main()
 		DCS_TEST_DO( real_col_major_resize );
 		DCS_TEST_DO( real_col_major_resize_from_empty );
 		DCS_TEST_DO( real_col_major_resize_to_empty );
+		DCS_TEST_DO( real_uninitialized_create );
+		DCS_TEST_DO( real_resize_reuse_storage );
+		DCS_TEST_DO( real_copy_and_swap );
 	DCS_TEST_END();
 }
@@ -1,5 +1,9 @@
+#include <boost/cstdint.hpp>
 #include <cstddef>
 #include <dcs/math/type/vector.hpp>
+#if __cplusplus >= 201103L
+# include <utility>
+#endif // __cplusplus >= 201103L
 #include <dcs/test.hpp>
 
 
@@ -163,6 +167,98 @@ DCS_TEST_DEF( real_resize_to_empty )
 }
 
 
+DCS_TEST_DEF( real_uninitialized_create )
+{
+	DCS_TEST_CASE("Dense Vector - Real Type - Uninitialized Vector Creation");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const std::size_t n(5);
+
+	math::vector<value_type> v(n, math::uninitialized);
+
+	DCS_TEST_CHECK_EQ(     n, v.length() );
+	DCS_TEST_CHECK_EQ(     n, v.capacity() );
+	DCS_TEST_CHECK_EQ( false, v.empty() );
+	DCS_TEST_CHECK_EQ(     0, reinterpret_cast< ::boost::uintptr_t >(v.begin_data()) % ::dcs::memory::default_alignment );
+}
+
+DCS_TEST_DEF( real_resize_reuse_storage )
+{
+	DCS_TEST_CASE("Dense Vector - Real Type - Resize Reusing Storage");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	const value_type zero(0);
+
+	math::vector<value_type> v(4);
+	v(0) = 0;
+	v(1) = 1;
+	v(2) = 2;
+	v(3) = 3;
+
+	value_type const* data = v.begin_data();
+
+	v.resize(2);
+	DCS_TEST_CHECK( v.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 2, v.length() );
+	DCS_TEST_CHECK_EQ( 4, v.capacity() );
+
+	v.resize(3);
+	DCS_TEST_CHECK( v.begin_data() == data );
+	DCS_TEST_CHECK_CLOSE(    0, v(0), tol );
+	DCS_TEST_CHECK_CLOSE(    1, v(1), tol );
+	DCS_TEST_CHECK_CLOSE( zero, v(2), tol );
+
+	v.resize(4, math::uninitialized);
+	DCS_TEST_CHECK( v.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 4, v.length() );
+
+	v.resize(8);
+	DCS_TEST_CHECK_EQ( 8, v.capacity() );
+	DCS_TEST_CHECK_CLOSE(    1, v(1), tol );
+	DCS_TEST_CHECK_CLOSE( zero, v(7), tol );
+}
+
+DCS_TEST_DEF( real_copy_and_swap )
+{
+	DCS_TEST_CASE("Dense Vector - Real Type - Copy and Swap");
+
+	namespace math = ::dcs::math;
+
+	typedef double value_type;
+
+	math::vector<value_type> u(2,1);
+	math::vector<value_type> v(5,2);
+
+	value_type const* data = v.begin_data();
+
+	// Copy-assignment reuses the larger storage
+	v = u;
+	DCS_TEST_CHECK( v.begin_data() == data );
+	DCS_TEST_CHECK_EQ( 2, v.length() );
+	DCS_TEST_CHECK_CLOSE( 1, v(1), tol );
+
+	value_type const* data_u = u.begin_data();
+	swap(u, v);
+	DCS_TEST_CHECK( u.begin_data() == data );
+	DCS_TEST_CHECK( v.begin_data() == data_u );
+
+#if __cplusplus >= 201103L
+	math::vector<value_type> w(std::move(u));
+	DCS_TEST_CHECK( w.begin_data() == data );
+	DCS_TEST_CHECK( u.empty() );
+	u = std::move(w);
+	DCS_TEST_CHECK( u.begin_data() == data );
+	DCS_TEST_CHECK_CLOSE( 1, u(1), tol );
+#endif // __cplusplus >= 201103L
+}
+
+
 int main()
 {
 	DCS_TEST_SUITE("Vector Test Suite");
@@ -175,5 +271,8 @@ int main()
 		DCS_TEST_DO( real_resize );
 		DCS_TEST_DO( real_resize_from_empty );
 		DCS_TEST_DO( real_resize_to_empty );
+		DCS_TEST_DO( real_uninitialized_create );
+		DCS_TEST_DO( real_resize_reuse_storage );
+		DCS_TEST_DO( real_copy_and_swap );
 	DCS_TEST_END();
 }
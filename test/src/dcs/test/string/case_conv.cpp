@@ -0,0 +1,63 @@
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+#include <dcs/string/algorithm/to_lower.hpp>
+#include <dcs/string/algorithm/to_upper.hpp>
+#include <dcs/test.hpp>
+#include <string>
+
+
+namespace dcs_string = dcs::string;
+
+
+DCS_TEST_DEF( ascii_case )
+{
+	DCS_DEBUG_TRACE("Test Case: ascii_case");
+
+	std::string s("Hello, WORLD! @[`{ caf\xc3\xa9 \xc3\x89T\xc3\x89");
+	dcs_string::ascii_to_lower(s);
+	DCS_TEST_CHECK_EQ( s, "hello, world! @[`{ caf\xc3\xa9 \xc3\x89t\xc3\x89" );
+	dcs_string::ascii_to_upper(s);
+	DCS_TEST_CHECK_EQ( s, "HELLO, WORLD! @[`{ CAF\xc3\xa9 \xc3\x89T\xc3\x89" );
+
+	std::string out;
+	dcs_string::ascii_to_lower_copy("GET", out);
+	DCS_TEST_CHECK_EQ( out, "get" );
+	dcs_string::ascii_to_upper_copy("post", out);
+	DCS_TEST_CHECK_EQ( out, "POST" );
+
+	std::string empty;
+	dcs_string::ascii_to_lower(empty);
+	DCS_TEST_CHECK( empty.empty() );
+
+	// All byte values, at all offsets of the vectorized loop
+	for (std::size_t n = 0; n < 300; n += 7)
+	{
+		std::string bytes(n, ' ');
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			bytes[i] = static_cast<char>(std::rand());
+		}
+		std::string lower(bytes);
+		std::string upper(bytes);
+		dcs_string::ascii_to_lower(lower);
+		dcs_string::ascii_to_upper(upper);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const int c(static_cast<unsigned char>(bytes[i]));
+			DCS_TEST_CHECK_EQ( static_cast<unsigned char>(lower[i]), (c >= 'A' && c <= 'Z') ? c+32 : c );
+			DCS_TEST_CHECK_EQ( static_cast<unsigned char>(upper[i]), (c >= 'a' && c <= 'z') ? c-32 : c );
+		}
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "String case conversion" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( ascii_case );
+	DCS_TEST_END();
+}
@@ -0,0 +1,154 @@
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/find_iterator.hpp>
+#include <boost/algorithm/string/finder.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+#include <dcs/string/algorithm/split.hpp>
+#include <dcs/test.hpp>
+#include <string>
+#include <vector>
+
+
+namespace dcs_string = dcs::string;
+
+
+namespace /*<unnamed>*/ {
+
+/// Returns a random string over a small alphabet, so that delimiters occur
+/// often and next to each other.
+std::string make_string(std::size_t n)
+{
+	static const char chars[] = "ab,; \t";
+
+	std::string s(n, ' ');
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		s[i] = chars[std::rand() % (sizeof(chars)-1)];
+	}
+	return s;
+}
+
+/// Splits with boost::algorithm::split_iterator, as a reference.
+template <typename FinderT>
+std::vector<std::string> reference_split(std::string const& s, FinderT finder)
+{
+	typedef boost::algorithm::split_iterator<std::string::const_iterator> iterator;
+
+	std::vector<std::string> tokens;
+	for (iterator it = boost::algorithm::make_split_iterator(s, finder); it != iterator(); ++it)
+	{
+		tokens.push_back(boost::copy_range<std::string>(*it));
+	}
+	return tokens;
+}
+
+template <typename DelimiterT>
+std::vector<std::string> view_split(std::string const& s, DelimiterT const& delim, dcs_string::token_compress_mode_type compress)
+{
+	typedef typename dcs_string::split_view<DelimiterT>::const_iterator iterator;
+
+	const dcs_string::split_view<DelimiterT> view(s, delim, compress);
+	std::vector<std::string> tokens;
+	for (iterator it = view.begin(); it != view.end(); ++it)
+	{
+		tokens.push_back(it->to_string());
+	}
+	return tokens;
+}
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( split_view )
+{
+	DCS_DEBUG_TRACE("Test Case: split_view");
+
+	const std::string s("GET /index.html HTTP/1.1");
+	const char* expect[] = { "GET", "/index.html", "HTTP/1.1" };
+
+	const dcs_string::split_view<dcs_string::char_delimiter> view(dcs_string::make_split_view(s, ' '));
+	std::size_t n(0);
+	for (dcs_string::split_view<dcs_string::char_delimiter>::const_iterator it = view.begin(); it != view.end(); ++it, ++n)
+	{
+		DCS_TEST_CHECK_EQ( *it, expect[n] );
+	}
+	DCS_TEST_CHECK_EQ( n, 3 );
+
+	// Tokens are views into the string
+	DCS_TEST_CHECK( view.begin()->data() == s.data() );
+
+	DCS_TEST_CHECK( dcs_string::make_split_view(boost::string_ref(), ',').begin()->empty() );
+	DCS_TEST_CHECK( ++dcs_string::make_split_view(boost::string_ref(), ',').begin() == dcs_string::split_view<dcs_string::char_delimiter>::const_iterator() );
+}
+
+DCS_TEST_DEF( delimiters )
+{
+	DCS_DEBUG_TRACE("Test Case: delimiters");
+
+	const dcs_string::char_delimiter comma(',');
+	const dcs_string::string_delimiter comma_space(", ");
+	const dcs_string::string_delimiter long_delim(",; \t,");
+	const dcs_string::char_class_delimiter blanks(" \t");
+	const dcs_string::char_class_delimiter many("0123456789 ;,\t!?+-*/=");
+
+	for (int k = 0; k < 2000; ++k)
+	{
+		const std::string s(make_string(std::rand() % 100));
+		const dcs_string::token_compress_mode_type compress((k % 2) ? dcs_string::token_compress_on : dcs_string::token_compress_off);
+
+		DCS_TEST_CHECK( view_split(s, comma, compress) == reference_split(s, boost::algorithm::token_finder(boost::algorithm::is_any_of(","), compress)) );
+		DCS_TEST_CHECK( view_split(s, blanks, compress) == reference_split(s, boost::algorithm::token_finder(boost::algorithm::is_any_of(" \t"), compress)) );
+		DCS_TEST_CHECK( view_split(s, many, compress) == reference_split(s, boost::algorithm::token_finder(boost::algorithm::is_any_of("0123456789 ;,\t!?+-*/="), compress)) );
+		if (compress == dcs_string::token_compress_off)
+		{
+			DCS_TEST_CHECK( view_split(s, comma_space, compress) == reference_split(s, boost::algorithm::first_finder(", ")) );
+			DCS_TEST_CHECK( view_split(s, long_delim, compress) == reference_split(s, boost::algorithm::first_finder(",; \t,")) );
+		}
+	}
+
+	const std::string s("a, b,, c, , d");
+	std::vector<std::string> tokens(view_split(s, comma_space, dcs_string::token_compress_on));
+	DCS_TEST_CHECK_EQ( tokens.size(), 4 );
+	DCS_TEST_CHECK_EQ( tokens[2], "c" );
+	DCS_TEST_CHECK_EQ( tokens[3], "d" );
+}
+
+DCS_TEST_DEF( split_into )
+{
+	DCS_DEBUG_TRACE("Test Case: split_into");
+
+	std::vector<boost::string_ref> refs;
+	const std::string line("10.0.0.1 - - [10/Oct/2014:13:55:36] \"GET / HTTP/1.0\" 200 2326");
+	DCS_TEST_CHECK_EQ( dcs_string::split_into(refs, line, ' '), 9 );
+	DCS_TEST_CHECK_EQ( refs[0], "10.0.0.1" );
+	DCS_TEST_CHECK_EQ( refs[8], "2326" );
+
+	// Strings are reused (as long as the container does not reallocate)
+	std::vector<std::string> tokens;
+	tokens.reserve(4);
+	tokens.push_back(std::string(64, 'x'));
+	const std::string::size_type cap(tokens[0].capacity());
+	DCS_TEST_CHECK_EQ( dcs_string::split_into(tokens, "a\tb  c", dcs_string::char_class_delimiter(" \t"), dcs_string::token_compress_on), 3 );
+	DCS_TEST_CHECK_EQ( tokens.size(), 3 );
+	DCS_TEST_CHECK_EQ( tokens[0], "a" );
+	DCS_TEST_CHECK_EQ( tokens[0].capacity(), cap );
+	DCS_TEST_CHECK_EQ( tokens[2], "c" );
+
+	DCS_TEST_CHECK_EQ( dcs_string::split_into(tokens, "x", ','), 1 );
+	DCS_TEST_CHECK_EQ( tokens.size(), 1 );
+	DCS_TEST_CHECK( tokens == dcs_string::split("x", ',') );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "String splitting" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( split_view );
+		DCS_TEST_DO( delimiters );
+		DCS_TEST_DO( split_into );
+	DCS_TEST_END();
+}
@@ -0,0 +1,189 @@
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/system/posix_process_pool.hpp>
+#include <dcs/system/process_status_category.hpp>
+#include <dcs/test.hpp>
+#include <signal.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+::std::vector< ::std::string > sh_args(::std::string const& script)
+{
+	::std::vector< ::std::string > args;
+	args.push_back("-c");
+	args.push_back(script);
+	return args;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+DCS_TEST_DEF( test_output )
+{
+	DCS_TEST_TRACE("Test Case: output");
+
+	const ::std::size_t n = 50;
+
+	dcs::system::posix_process_pool pool(4);
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::std::ostringstream oss;
+		oss << "echo out" << i << "; echo err" << i << " >&2; exit " << (i % 3);
+		const ::std::vector< ::std::string > args = detail::sh_args(oss.str());
+		pool.submit("sh", args.begin(), args.end());
+	}
+
+	DCS_TEST_CHECK_EQ( n, pool.size() );
+	DCS_TEST_CHECK_EQ( n, pool.num_pending() );
+
+	pool.wait_all();
+
+	DCS_TEST_CHECK_EQ( 0u, pool.num_running() );
+	DCS_TEST_CHECK_EQ( 0u, pool.num_pending() );
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		::std::ostringstream out;
+		out << "out" << i << "\n";
+		::std::ostringstream err;
+		err << "err" << i << "\n";
+
+		DCS_TEST_CHECK( pool.done(i) );
+		DCS_TEST_CHECK_EQ( out.str(), pool.output(i) );
+		DCS_TEST_CHECK_EQ( err.str(), pool.error(i) );
+		DCS_TEST_CHECK_EQ( static_cast<int>(i % 3), pool.exit_status(i) );
+		DCS_TEST_CHECK_EQ( (i % 3) == 0 ? dcs::system::terminated_process_status : dcs::system::failed_process_status, pool.status(i) );
+		DCS_TEST_CHECK_EQ( -1, pool.signal(i) );
+	}
+}
+
+DCS_TEST_DEF( test_input )
+{
+	DCS_TEST_TRACE("Test Case: input");
+
+	// Larger than a pipe buffer, so that writing and reading interleave
+	::std::string text;
+	for (::std::size_t i = 0; text.size() < (1u << 20); ++i)
+	{
+		::std::ostringstream oss;
+		oss << "line " << i << "\n";
+		text += oss.str();
+	}
+
+	dcs::system::posix_process_pool pool(2);
+
+	::std::vector< ::std::string > args;
+	const dcs::system::posix_process_pool::job_id_type id1 = pool.submit("cat", args.begin(), args.end(), text);
+	// Stops reading its input early
+	const ::std::vector< ::std::string > head_args = detail::sh_args("head -n 1");
+	const dcs::system::posix_process_pool::job_id_type id2 = pool.submit("sh", head_args.begin(), head_args.end(), text);
+	// Does not read its input
+	const dcs::system::posix_process_pool::job_id_type id3 = pool.submit("true", args.begin(), args.end(), text);
+	// Reads from /dev/null
+	const dcs::system::posix_process_pool::job_id_type id4 = pool.submit("cat");
+
+	pool.wait_all();
+
+	DCS_TEST_CHECK( text == pool.output(id1) );
+	DCS_TEST_CHECK_EQ( dcs::system::terminated_process_status, pool.status(id1) );
+	DCS_TEST_CHECK_EQ( ::std::string("line 0\n"), pool.output(id2) );
+	DCS_TEST_CHECK_EQ( dcs::system::terminated_process_status, pool.status(id2) );
+	DCS_TEST_CHECK_EQ( dcs::system::terminated_process_status, pool.status(id3) );
+	DCS_TEST_CHECK_EQ( ::std::string(), pool.output(id4) );
+	DCS_TEST_CHECK_EQ( dcs::system::terminated_process_status, pool.status(id4) );
+}
+
+DCS_TEST_DEF( test_limit )
+{
+	DCS_TEST_TRACE("Test Case: limit");
+
+	const ::std::size_t n = 20;
+	const ::std::size_t max_running = 3;
+
+	dcs::system::posix_process_pool pool(max_running);
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		const ::std::vector< ::std::string > args = detail::sh_args("sleep 0.05");
+		pool.submit("sh", args.begin(), args.end());
+	}
+
+	DCS_TEST_CHECK_EQ( max_running, pool.max_running() );
+
+	::std::size_t count = 0;
+	::std::size_t max_seen = 0;
+	dcs::system::posix_process_pool::job_id_type id;
+	while (pool.wait_any(id))
+	{
+		DCS_TEST_CHECK( pool.done(id) );
+		DCS_TEST_CHECK_EQ( dcs::system::terminated_process_status, pool.status(id) );
+		DCS_TEST_CHECK( pool.num_running() <= max_running );
+		if (pool.num_running() > max_seen)
+		{
+			max_seen = pool.num_running();
+		}
+		++count;
+	}
+
+	DCS_TEST_CHECK_EQ( n, count );
+	DCS_TEST_CHECK( max_seen > 0 );
+	DCS_TEST_CHECK( max_seen <= max_running );
+}
+
+DCS_TEST_DEF( test_failure )
+{
+	DCS_TEST_TRACE("Test Case: failure");
+
+	dcs::system::posix_process_pool pool;
+
+	const dcs::system::posix_process_pool::job_id_type id1 = pool.submit("such_command_does_not_exist");
+	const ::std::vector< ::std::string > args = detail::sh_args("kill -s TERM $$");
+	const dcs::system::posix_process_pool::job_id_type id2 = pool.submit("sh", args.begin(), args.end());
+
+	pool.wait_all();
+
+	DCS_TEST_CHECK_EQ( dcs::system::failed_process_status, pool.status(id1) );
+	DCS_TEST_CHECK_EQ( 127, pool.exit_status(id1) );
+	DCS_TEST_CHECK_EQ( dcs::system::aborted_process_status, pool.status(id2) );
+	DCS_TEST_CHECK_EQ( SIGTERM, pool.signal(id2) );
+}
+
+DCS_TEST_DEF( test_signal_all )
+{
+	DCS_TEST_TRACE("Test Case: signal all");
+
+	dcs::system::posix_process_pool pool(2);
+
+	const ::std::vector< ::std::string > args = detail::sh_args("exec sleep 60");
+	pool.submit("sh", args.begin(), args.end());
+	pool.submit("sh", args.begin(), args.end());
+
+	// Start the jobs
+	pool.poll(0);
+
+	DCS_TEST_CHECK_EQ( 2u, pool.num_running() );
+
+	pool.signal_all(SIGKILL);
+	pool.wait_all();
+
+	DCS_TEST_CHECK_EQ( dcs::system::aborted_process_status, pool.status(0) );
+	DCS_TEST_CHECK_EQ( SIGKILL, pool.signal(0) );
+	DCS_TEST_CHECK_EQ( dcs::system::aborted_process_status, pool.status(1) );
+	DCS_TEST_CHECK_EQ( SIGKILL, pool.signal(1) );
+}
+
+
+int main()
+{
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( test_output );
+		DCS_TEST_DO( test_input );
+		DCS_TEST_DO( test_limit );
+		DCS_TEST_DO( test_failure );
+		DCS_TEST_DO( test_signal_all );
+	DCS_TEST_END();
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+#include <dcs/test.hpp>
+#include <dcs/text/base64.hpp>
+#include <string>
+#include <vector>
+
+
+namespace dcs_text = dcs::text;
+
+
+namespace /*<unnamed>*/ {
+
+std::vector<boost::uint8_t> make_bytes(std::size_t n)
+{
+	std::vector<boost::uint8_t> bytes(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		bytes[i] = static_cast<boost::uint8_t>(std::rand());
+	}
+	return bytes;
+}
+
+std::string encode(std::string const& s, dcs_text::base64_alphabet_category alphabet = dcs_text::standard_base64_alphabet, bool padding = true)
+{
+	return dcs_text::base64_encode(reinterpret_cast<boost::uint8_t const*>(s.data()), s.size(), alphabet, padding);
+}
+
+std::vector<dcs_text::detail::base64_kernel_category> supported_kernels()
+{
+	std::vector<dcs_text::detail::base64_kernel_category> kernels;
+	kernels.push_back(dcs_text::detail::scalar_base64_kernel);
+#ifdef DCS_TEXT_DETAIL_BASE64_X86
+	if (dcs_text::detail::base64_x86_has_ssse3())
+	{
+		kernels.push_back(dcs_text::detail::ssse3_base64_kernel);
+	}
+	if (dcs_text::detail::base64_x86_has_avx2())
+	{
+		kernels.push_back(dcs_text::detail::avx2_base64_kernel);
+	}
+#endif // DCS_TEXT_DETAIL_BASE64_X86
+	return kernels;
+}
+
+} // Namespace <unnamed>
+
+
+DCS_TEST_DEF( test_rfc4648 )
+{
+	DCS_TEST_CASE("RFC 4648 test vectors");
+
+	DCS_TEST_CHECK_EQ(encode(""), std::string(""));
+	DCS_TEST_CHECK_EQ(encode("f"), std::string("Zg=="));
+	DCS_TEST_CHECK_EQ(encode("fo"), std::string("Zm8="));
+	DCS_TEST_CHECK_EQ(encode("foo"), std::string("Zm9v"));
+	DCS_TEST_CHECK_EQ(encode("foob"), std::string("Zm9vYg=="));
+	DCS_TEST_CHECK_EQ(encode("fooba"), std::string("Zm9vYmE="));
+	DCS_TEST_CHECK_EQ(encode("foobar"), std::string("Zm9vYmFy"));
+
+	DCS_TEST_CHECK_EQ(encode("fooba", dcs_text::standard_base64_alphabet, false), std::string("Zm9vYmE"));
+	DCS_TEST_CHECK_EQ(encode("foob", dcs_text::standard_base64_alphabet, false), std::string("Zm9vYg"));
+
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("Zm9vYmE="), std::string("fooba"));
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("Zm9vYg=="), std::string("foob"));
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("Zm9vYg"), std::string("foob"));
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("Zm9vYmFy"), std::string("foobar"));
+
+	// Decoding ends at the first character outside the alphabet
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("Zm9v*Zm9v"), std::string("foo"));
+}
+
+DCS_TEST_DEF( test_url_safe )
+{
+	DCS_TEST_CASE("URL-safe alphabet");
+
+	const std::string s("\xfb\xff\xbf");
+
+	DCS_TEST_CHECK_EQ(encode(s), std::string("+/+/"));
+	DCS_TEST_CHECK_EQ(encode(s, dcs_text::url_safe_base64_alphabet), std::string("-_-_"));
+	DCS_TEST_CHECK_EQ(dcs_text::base64_decode("-_-_", dcs_text::url_safe_base64_alphabet), s);
+	DCS_TEST_CHECK(dcs_text::base64_decode("-_-_").empty());
+}
+
+DCS_TEST_DEF( test_buffers )
+{
+	DCS_TEST_CASE("Caller-provided buffers");
+
+	for (std::size_t n = 0; n < 100; ++n)
+	{
+		const std::vector<boost::uint8_t> bytes(make_bytes(n));
+
+		for (int padding = 0; padding < 2; ++padding)
+		{
+			const std::size_t size(dcs_text::base64_encoded_size(n, padding));
+			std::vector<char> chars(size+1, '#');
+			DCS_TEST_CHECK_EQ(dcs_text::base64_encode(n ? &bytes[0] : 0, n, &chars[0], dcs_text::url_safe_base64_alphabet, padding), size);
+			DCS_TEST_CHECK_EQ(chars[size], '#');
+
+			DCS_TEST_CHECK_EQ(dcs_text::base64_decoded_size(&chars[0], size), n);
+			std::vector<boost::uint8_t> decoded(n+1, 0x5a);
+			DCS_TEST_CHECK_EQ(dcs_text::base64_decode(&chars[0], size, &decoded[0], dcs_text::url_safe_base64_alphabet), n);
+			DCS_TEST_CHECK_EQ(decoded[n], 0x5a);
+			DCS_TEST_CHECK(std::equal(bytes.begin(), bytes.end(), decoded.begin()));
+		}
+	}
+}
+
+DCS_TEST_DEF( test_kernels )
+{
+	DCS_TEST_CASE("Vectorized kernels");
+
+	const std::vector<dcs_text::detail::base64_kernel_category> kernels(supported_kernels());
+	DCS_DEBUG_TRACE("Number of kernels: " << kernels.size());
+
+	const std::size_t n(3*1000+2);
+	const std::vector<boost::uint8_t> bytes(make_bytes(n));
+
+	for (std::size_t k = 0; k < kernels.size(); ++k)
+	{
+		for (int a = 0; a < 2; ++a)
+		{
+			const dcs_text::base64_alphabet_category alphabet(a ? dcs_text::url_safe_base64_alphabet : dcs_text::standard_base64_alphabet);
+			const std::string ref(dcs_text::base64_encode(&bytes[0], n, alphabet));
+
+			// Try every alignment of the input and of its end
+			for (std::size_t off = 0; off < 32; ++off)
+			{
+				std::string out(ref.size(), '\0');
+				const std::size_t m(dcs_text::detail::base64_encode_bulk(&bytes[off], n-off, &out[0], alphabet, kernels[k]));
+				DCS_TEST_CHECK_EQ(m, (n-off)/3*3);
+				DCS_TEST_CHECK_EQ(out.substr(0, m/3*4), dcs_text::base64_encode(&bytes[off], m, alphabet));
+
+				const std::size_t nc(ref.size()-1-off);
+				std::vector<boost::uint8_t> decoded(nc/4*3);
+				const std::size_t mc(dcs_text::detail::base64_decode_bulk(ref.data(), nc, decoded.empty() ? 0 : &decoded[0], alphabet, kernels[k]));
+				DCS_TEST_CHECK_EQ(mc, nc/4*4);
+				DCS_TEST_CHECK(std::equal(decoded.begin(), decoded.begin()+mc/4*3, bytes.begin()));
+			}
+
+			// Invalid characters stop decoding within any block
+			for (std::size_t bad = 0; bad < 100; bad += 7)
+			{
+				std::string enc(ref);
+				enc[bad] = '.';
+				std::vector<boost::uint8_t> decoded(n);
+				const std::size_t mc(dcs_text::detail::base64_decode_bulk(enc.data(), enc.size(), &decoded[0], alphabet, kernels[k]));
+				DCS_TEST_CHECK_EQ(mc, bad/4*4);
+			}
+		}
+	}
+}
+
+DCS_TEST_DEF( test_streaming )
+{
+	DCS_TEST_CASE("Streaming encoder and decoder");
+
+	const std::size_t n(5000);
+	const std::vector<boost::uint8_t> bytes(make_bytes(n));
+	const std::string expect(dcs_text::base64_encode(&bytes[0], n));
+
+	dcs_text::base64_encoder enc;
+	std::string encoded;
+	for (std::size_t i = 0; i < n; )
+	{
+		const std::size_t len(std::min(n-i, static_cast<std::size_t>(std::rand() % 70)));
+		std::vector<char> buf(enc.encoded_size(len)+1);
+		const std::size_t w(enc.encode(&bytes[i], len, &buf[0]));
+		DCS_TEST_CHECK_EQ(w, buf.size()-1);
+		encoded.append(&buf[0], w);
+		i += len;
+	}
+	char tail[4];
+	encoded.append(tail, enc.finish(tail));
+	DCS_TEST_CHECK_EQ(encoded, expect);
+
+	dcs_text::base64_decoder dec;
+	std::vector<boost::uint8_t> decoded;
+	for (std::size_t i = 0; i < encoded.size(); )
+	{
+		const std::size_t len(std::min(encoded.size()-i, static_cast<std::size_t>(std::rand() % 90)));
+		std::vector<boost::uint8_t> buf(dec.max_decoded_size(len)+1);
+		const std::size_t w(dec.decode(encoded.data()+i, len, &buf[0]));
+		DCS_TEST_CHECK(w <= buf.size()-1);
+		decoded.insert(decoded.end(), buf.begin(), buf.begin()+w);
+		i += len;
+	}
+	DCS_TEST_CHECK(dec.done());
+	boost::uint8_t last[2];
+	const std::size_t w(dec.finish(last));
+	decoded.insert(decoded.end(), last, last+w);
+	DCS_TEST_CHECK_EQ(decoded.size(), n);
+	DCS_TEST_CHECK(decoded == bytes);
+}
+
+
+int main()
+{
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_rfc4648 );
+	DCS_TEST_DO( test_url_safe );
+	DCS_TEST_DO( test_buffers );
+	DCS_TEST_DO( test_kernels );
+	DCS_TEST_DO( test_streaming );
+
+	DCS_TEST_END();
+}
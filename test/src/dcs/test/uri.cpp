@@ -36,9 +36,11 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstddef>
 #include <dcs/debug.hpp>
 #include <dcs/test.hpp>
 #include <dcs/uri.hpp>
+#include <stdexcept>
 
 
 DCS_TEST_DEF( construction )
@@ -175,6 +177,38 @@ DCS_TEST_DEF( construction )
 	DCS_TEST_CHECK_EQ(u11.fragment(), "fragment");
 }
 
+DCS_TEST_DEF( encoding )
+{
+	DCS_DEBUG_TRACE("Test Case: encoding");
+
+	DCS_TEST_CHECK_EQ(dcs::uri::encode("/a b/c?d#e", "?#"), "/a%20b/c%3Fd%23e");
+	DCS_TEST_CHECK_EQ(dcs::uri::encode("100%<>\"\x7f\xc3\xa8", ""), "100%25%3C%3E%22%7F%C3%A8");
+	DCS_TEST_CHECK_EQ(dcs::uri::encode("a-b_c.d~e", "-_.~"), "a-b_c.d~e");
+	DCS_TEST_CHECK_EQ(dcs::uri::encode("", ""), "");
+
+	DCS_TEST_CHECK_EQ(dcs::uri::decode("/a%20b/c%3fd%23e+f"), "/a b/c?d#e+f");
+	DCS_TEST_CHECK_EQ(dcs::uri::decode("%C3%A8"), "\xc3\xa8");
+	DCS_TEST_CHECK_EQ(dcs::uri::decode(dcs::uri::encode("0123456789abcdef %%% 0123456789abcdef", "")), "0123456789abcdef %%% 0123456789abcdef");
+
+	const char* bad[] = { "%", "a%2", "%g0", "0123456789abcdef%0" };
+	for (std::size_t i = 0; i < sizeof(bad)/sizeof(bad[0]); ++i)
+	{
+		bool thrown(false);
+		try
+		{
+			dcs::uri::decode(bad[i]);
+		}
+		catch (std::logic_error const&)
+		{
+			thrown = true;
+		}
+		DCS_TEST_CHECK( thrown );
+	}
+
+	dcs::uri u("http://www.example.com/file%20with%20spaces.html?q=a%26b");
+	DCS_TEST_CHECK_EQ(u.str(), "http://www.example.com/file%20with%20spaces.html?q=a%26b");
+}
+
 
 int main()
 {
@@ -182,5 +216,6 @@ int main()
 
 	DCS_TEST_BEGIN();
 		DCS_TEST_DO( construction );
+		DCS_TEST_DO( encoding );
 	DCS_TEST_END();
 }
@@ -0,0 +1,141 @@
+/**
+ * \file dcs/test/uri_query.cpp
+ *
+ * \brief Test suite for the dcs::uri_query_view class.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/test.hpp>
+#include <dcs/uri.hpp>
+#include <dcs/uri_query.hpp>
+#include <dcs/uri_view.hpp>
+#include <string>
+
+
+DCS_TEST_DEF( iteration )
+{
+	DCS_DEBUG_TRACE("Test Case: iteration");
+
+	const std::string q("a=1&&b%20c=x+y%2Bz&flag&=v&e=&k=%zz&");
+	dcs::uri_query_view qv((dcs::uri_query_view::string_ref_type(q)));
+
+	const char* keys[] = { "a", "b c", "flag", "", "e", "k" };
+	const char* values[] = { "1", "x y+z", "", "v", "", "%zz" };
+	const bool has_values[] = { true, true, false, true, true, true };
+	const std::size_t n(sizeof(keys)/sizeof(keys[0]));
+
+	std::string kbuf;
+	std::string vbuf;
+	std::size_t i(0);
+	for (dcs::uri_query_view::const_iterator it = qv.begin(); it != qv.end(); ++it, ++i)
+	{
+		DCS_TEST_CHECK( i < n );
+		if (i >= n)
+		{
+			break;
+		}
+		DCS_TEST_CHECK_EQ( it->key(kbuf), keys[i] );
+		DCS_TEST_CHECK_EQ( it->value(vbuf), values[i] );
+		DCS_TEST_CHECK_EQ( it->has_value(), has_values[i] );
+	}
+	DCS_TEST_CHECK_EQ( i, n );
+
+	// Nothing to decode: the raw text is returned
+	dcs::uri_query_view::const_iterator it(qv.begin());
+	DCS_TEST_CHECK( it->value(vbuf).data() == q.data()+2 );
+	++it;
+	DCS_TEST_CHECK_EQ( it->raw_key(), "b%20c" );
+	DCS_TEST_CHECK_EQ( it->raw_value(), "x+y%2Bz" );
+	DCS_TEST_CHECK_EQ( it->key(), "b c" );
+	DCS_TEST_CHECK_EQ( it->value(), "x y+z" );
+
+	// "+" can be kept as it is
+	dcs::uri_query_view qv2(dcs::uri_query_view::string_ref_type(q), false);
+	DCS_TEST_CHECK_EQ( qv2.find("b c")->value(), "x+y+z" );
+
+	DCS_TEST_CHECK( dcs::uri_query_view().empty() );
+	DCS_TEST_CHECK( dcs::uri_query_view(dcs::uri_query_view::string_ref_type("&&")).empty() );
+}
+
+DCS_TEST_DEF( lookup )
+{
+	DCS_DEBUG_TRACE("Test Case: lookup");
+
+	const std::string q("id=42&name=J%C3%B6rg+M&tag=a&tag=b&%74ag=c&tags=d");
+	dcs::uri_query_view qv((dcs::uri_query_view::string_ref_type(q)));
+
+	std::string buf;
+	dcs::uri_query_view::string_ref_type v;
+
+	DCS_TEST_CHECK( qv.get("id", v, buf) );
+	DCS_TEST_CHECK_EQ( v, "42" );
+	DCS_TEST_CHECK( qv.get("name", v, buf) );
+	DCS_TEST_CHECK_EQ( v, "J\xc3\xb6rg M" );
+	DCS_TEST_CHECK( !qv.get("nam", v, buf) );
+	DCS_TEST_CHECK( !qv.get("ID", v, buf) );
+	DCS_TEST_CHECK_EQ( qv.count("tag"), 3 );
+	DCS_TEST_CHECK_EQ( qv.count("tags"), 1 );
+	DCS_TEST_CHECK( qv.find("missing") == qv.end() );
+}
+
+DCS_TEST_DEF( uri_integration )
+{
+	DCS_DEBUG_TRACE("Test Case: uri_integration");
+
+	dcs::uri u("http://www.example.com/search?q=uri+parsing&page=2#results");
+	DCS_TEST_CHECK_EQ( u.query_params().find("q")->value(), "uri parsing" );
+	DCS_TEST_CHECK_EQ( u.query_params().find("page")->value(), "2" );
+
+	dcs::uri_view uv("/search?q=a%26b&x");
+	std::string buf;
+	dcs::uri_query_view::string_ref_type v;
+	DCS_TEST_CHECK( uv.query_params().get("q", v, buf) );
+	DCS_TEST_CHECK_EQ( v, "a&b" );
+	DCS_TEST_CHECK_EQ( uv.query_params().count("x"), 1 );
+	DCS_TEST_CHECK( dcs::uri_view("/p").query_params().empty() );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "URI Query Test Suite" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( iteration );
+		DCS_TEST_DO( lookup );
+		DCS_TEST_DO( uri_integration );
+	DCS_TEST_END();
+}
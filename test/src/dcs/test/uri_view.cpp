@@ -0,0 +1,300 @@
+/**
+ * \file dcs/test/uri_view.cpp
+ *
+ * \brief Test suite for the dcs::uri_view class.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright (C) 2014       Marco Guazzone (marco.guazzone@gmail.com)
+ *                          [Distributed Computing System (DCS) Group,
+ *                           Computer Science Institute,
+ *                           Department of Science and Technological Innovation,
+ *                           University of Piemonte Orientale,
+ *                           Alessandria (Italy)]
+ *
+ * This file is part of dcsxx-commons (below referred to as "this program").
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <dcs/debug.hpp>
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/test.hpp>
+#include <dcs/uri_view.hpp>
+#include <string>
+#include <vector>
+
+
+namespace /*<unnamed>*/ { namespace detail {
+
+std::string normalized(std::string const& s)
+{
+	std::string out;
+	dcs::uri_view(s).normalize(out);
+	return out;
+}
+
+std::string resolved(std::string const& base, std::string const& ref)
+{
+	std::string out;
+	dcs::uri_view(base).resolve(dcs::uri_view(ref), out);
+	return out;
+}
+
+}} // Namespace <unnamed>::detail
+
+
+DCS_TEST_DEF( parts )
+{
+	DCS_DEBUG_TRACE("Test Case: parts");
+
+	const std::string s("http://user:pw@www.example.com:8080/a/b.html?x=1&y=%20#frag");
+	dcs::uri_view u(s);
+
+	DCS_TEST_CHECK( u.valid() );
+	DCS_TEST_CHECK( !u.relative() );
+	DCS_TEST_CHECK_EQ( u.str(), s );
+	DCS_TEST_CHECK_EQ( u.scheme(), "http" );
+	DCS_TEST_CHECK_EQ( u.authority(), "user:pw@www.example.com:8080" );
+	DCS_TEST_CHECK_EQ( u.user_info(), "user:pw" );
+	DCS_TEST_CHECK_EQ( u.host(), "www.example.com" );
+	DCS_TEST_CHECK_EQ( u.port(), 8080 );
+	DCS_TEST_CHECK_EQ( u.path(), "/a/b.html" );
+	DCS_TEST_CHECK_EQ( u.query(), "x=1&y=%20" );
+	DCS_TEST_CHECK_EQ( u.fragment(), "frag" );
+	// Parts are views into the parsed string
+	DCS_TEST_CHECK( u.host().data() == s.data()+15 );
+
+	dcs::uri_view u2("HTTPS://[::1]/");
+	DCS_TEST_CHECK_EQ( u2.scheme(), "HTTPS" );
+	DCS_TEST_CHECK_EQ( u2.host(), "[::1]" );
+	DCS_TEST_CHECK( !u2.has_port() );
+	DCS_TEST_CHECK_EQ( u2.port(), 443 );
+	DCS_TEST_CHECK( !u2.has_query() );
+	DCS_TEST_CHECK( !u2.has_fragment() );
+
+	dcs::uri_view u3("//[fe80::1]:21?#");
+	DCS_TEST_CHECK( u3.relative() );
+	DCS_TEST_CHECK_EQ( u3.host(), "[fe80::1]" );
+	DCS_TEST_CHECK_EQ( u3.port(), 21 );
+	DCS_TEST_CHECK( u3.path().empty() );
+	DCS_TEST_CHECK( u3.has_query() && u3.query().empty() );
+	DCS_TEST_CHECK( u3.has_fragment() && u3.fragment().empty() );
+
+	dcs::uri_view u4("mailto:John.Doe@example.com");
+	DCS_TEST_CHECK_EQ( u4.scheme(), "mailto" );
+	DCS_TEST_CHECK( !u4.has_authority() );
+	DCS_TEST_CHECK_EQ( u4.path(), "John.Doe@example.com" );
+
+	dcs::uri_view u5("../a:b/c");
+	DCS_TEST_CHECK( u5.relative() );
+	DCS_TEST_CHECK_EQ( u5.path(), "../a:b/c" );
+
+	dcs::uri_view u6;
+	DCS_TEST_CHECK( u6.valid() );
+	DCS_TEST_CHECK( u6.empty() );
+}
+
+DCS_TEST_DEF( invalid )
+{
+	DCS_DEBUG_TRACE("Test Case: invalid");
+
+	const char* bad[] = { "http://h/a%2", "http://h/a%zz", "http://h:80x/", "http://h:65536/", "http://[::1/", "http://[::1]x/", "/a?b%g0" };
+	const std::size_t n(sizeof(bad)/sizeof(bad[0]));
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_DEBUG_TRACE("URI: " << bad[i]);
+
+		dcs::uri_view u;
+		DCS_TEST_CHECK( !u.parse(bad[i], bad[i]+std::char_traits<char>::length(bad[i])) );
+		DCS_TEST_CHECK( !u.valid() );
+		DCS_TEST_CHECK( u.empty() );
+	}
+
+	bool thrown(false);
+	try
+	{
+		dcs::uri_view u(std::string("http://h:x/"));
+	}
+	catch (std::logic_error const&)
+	{
+		thrown = true;
+	}
+	DCS_TEST_CHECK( thrown );
+}
+
+DCS_TEST_DEF( normalization )
+{
+	DCS_DEBUG_TRACE("Test Case: normalization");
+
+	DCS_TEST_CHECK_EQ( detail::normalized("HTTP://www.Example.COM:80/a/./b/../c/%7euser?q#F"), "http://www.example.com/a/c/~user?q#F" );
+	DCS_TEST_CHECK_EQ( detail::normalized("http://example.com"), "http://example.com/" );
+	DCS_TEST_CHECK_EQ( detail::normalized("http://example.com:/"), "http://example.com/" );
+	DCS_TEST_CHECK_EQ( detail::normalized("http://example.com:08080/%3a%41"), "http://example.com:8080/%3AA" );
+	DCS_TEST_CHECK_EQ( detail::normalized("https://U%40s@EXAMPLE.com:443"), "https://U%40s@example.com/" );
+	DCS_TEST_CHECK_EQ( detail::normalized("ftp://h/../../a/.."), "ftp://h/" );
+	DCS_TEST_CHECK_EQ( detail::normalized("/a/b/./../c/."), "/a/c/" );
+	DCS_TEST_CHECK_EQ( detail::normalized("a/../b"), "a/../b" );
+	DCS_TEST_CHECK_EQ( detail::normalized("/.//a"), "/.//a" );
+	DCS_TEST_CHECK_EQ( detail::normalized("s:/a/..//b"), "s:/.//b" );
+
+	// The output buffer is reused
+	std::string out;
+	out.reserve(256);
+	const std::string::size_type cap(out.capacity());
+	char const* const buf(out.data());
+	dcs::uri_view(std::string("http://a/b/../c")).normalize(out);
+	DCS_TEST_CHECK_EQ( out, "http://a/c" );
+	dcs::uri_view(std::string("HTTP://B")).normalize(out);
+	DCS_TEST_CHECK_EQ( out, "http://b/" );
+	DCS_TEST_CHECK_EQ( out.capacity(), cap );
+	DCS_TEST_CHECK( out.data() == buf );
+}
+
+DCS_TEST_DEF( resolution )
+{
+	DCS_DEBUG_TRACE("Test Case: resolution");
+
+	// See RFC 3986, section 5.4
+	const std::string base("http://a/b/c/d;p?q");
+	const char* cases[][2] = {
+			// Normal examples
+			{ "g:h", "g:h" },
+			{ "g", "http://a/b/c/g" },
+			{ "./g", "http://a/b/c/g" },
+			{ "g/", "http://a/b/c/g/" },
+			{ "/g", "http://a/g" },
+			{ "//g", "http://g" },
+			{ "?y", "http://a/b/c/d;p?y" },
+			{ "g?y", "http://a/b/c/g?y" },
+			{ "#s", "http://a/b/c/d;p?q#s" },
+			{ "g#s", "http://a/b/c/g#s" },
+			{ "g?y#s", "http://a/b/c/g?y#s" },
+			{ ";x", "http://a/b/c/;x" },
+			{ "g;x", "http://a/b/c/g;x" },
+			{ "g;x?y#s", "http://a/b/c/g;x?y#s" },
+			{ "", "http://a/b/c/d;p?q" },
+			{ ".", "http://a/b/c/" },
+			{ "./", "http://a/b/c/" },
+			{ "..", "http://a/b/" },
+			{ "../", "http://a/b/" },
+			{ "../g", "http://a/b/g" },
+			{ "../..", "http://a/" },
+			{ "../../", "http://a/" },
+			{ "../../g", "http://a/g" },
+			// Abnormal examples
+			{ "../../../g", "http://a/g" },
+			{ "../../../../g", "http://a/g" },
+			{ "/./g", "http://a/g" },
+			{ "/../g", "http://a/g" },
+			{ "g.", "http://a/b/c/g." },
+			{ ".g", "http://a/b/c/.g" },
+			{ "g..", "http://a/b/c/g.." },
+			{ "..g", "http://a/b/c/..g" },
+			{ "./../g", "http://a/b/g" },
+			{ "./g/.", "http://a/b/c/g/" },
+			{ "g/./h", "http://a/b/c/g/h" },
+			{ "g/../h", "http://a/b/c/h" },
+			{ "g;x=1/./y", "http://a/b/c/g;x=1/y" },
+			{ "g;x=1/../y", "http://a/b/c/y" },
+			{ "g?y/./x", "http://a/b/c/g?y/./x" },
+			{ "g?y/../x", "http://a/b/c/g?y/../x" },
+			{ "g#s/./x", "http://a/b/c/g#s/./x" },
+			{ "g#s/../x", "http://a/b/c/g#s/../x" },
+			{ "http:g", "http:g" }
+		};
+	const std::size_t n(sizeof(cases)/sizeof(cases[0]));
+
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		DCS_DEBUG_TRACE("Reference: " << cases[i][0]);
+
+		DCS_TEST_CHECK_EQ( detail::resolved(base, cases[i][0]), cases[i][1] );
+	}
+
+	DCS_TEST_CHECK_EQ( detail::resolved("http://a", "g"), "http://a/g" );
+	DCS_TEST_CHECK_EQ( detail::resolved("http://a/b", "?"), "http://a/b?" );
+}
+
+DCS_TEST_DEF( batch )
+{
+	DCS_DEBUG_TRACE("Test Case: batch");
+
+	const std::string lines("http://a/b\r\n/c?d\nhttp://h:x/\n\n#f\n");
+	std::vector<dcs::uri_view> views;
+
+	DCS_TEST_CHECK_EQ( dcs::parse_uri_lines(lines.data(), lines.data()+lines.size(), views), 1 );
+	DCS_TEST_CHECK_EQ( views.size(), 5 );
+	DCS_TEST_CHECK_EQ( views[0].path(), "/b" );
+	DCS_TEST_CHECK_EQ( views[1].query(), "d" );
+	DCS_TEST_CHECK( !views[2].valid() );
+	DCS_TEST_CHECK( views[3].empty() );
+	DCS_TEST_CHECK_EQ( views[4].fragment(), "f" );
+
+	std::vector<std::string> column;
+	column.push_back("http://x/1");
+	column.push_back("http://y/2");
+	DCS_TEST_CHECK_EQ( dcs::parse_uri_views(column.begin(), column.end(), views), 0 );
+	DCS_TEST_CHECK_EQ( views.size(), 2 );
+	DCS_TEST_CHECK_EQ( views[1].host(), "y" );
+	DCS_TEST_CHECK( views[1].host().data() == column[1].data()+7 );
+}
+
+DCS_TEST_DEF( cache )
+{
+	DCS_DEBUG_TRACE("Test Case: cache");
+
+	dcs::uri_normalization_cache cache(10);
+	DCS_TEST_CHECK_EQ( cache.capacity(), 16 );
+
+	const std::string a("HTTP://A/./x");
+	const std::string b("http://b:80/");
+	for (int i = 0; i < 3; ++i)
+	{
+		DCS_TEST_CHECK_EQ( cache.normalize(a).str(), "http://a/x" );
+		DCS_TEST_CHECK_EQ( cache.normalize(b).host(), "b" );
+	}
+	DCS_TEST_CHECK( !cache.normalize(std::string("http://h:x/")).valid() );
+
+	// Slots may collide, thus at least the repeated lookups of one URI hit
+	DCS_TEST_CHECK( cache.num_hits() >= 2 );
+	DCS_TEST_CHECK_EQ( cache.num_hits()+cache.num_misses(), 7 );
+
+	cache.clear();
+	DCS_TEST_CHECK_EQ( cache.num_hits(), 0 );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "URI View Test Suite" );
+
+	DCS_TEST_BEGIN();
+		DCS_TEST_DO( parts );
+		DCS_TEST_DO( invalid );
+		DCS_TEST_DO( normalization );
+		DCS_TEST_DO( resolution );
+		DCS_TEST_DO( batch );
+		DCS_TEST_DO( cache );
+	DCS_TEST_END();
+}
@@ -0,0 +1,20 @@
+## DCS USER CONFIGURATIONS
+##
+
+
+### dcs general configurations
+
+# Set here you C/C++ preprocessor flags
+USR_CPPFLAGS=
+
+# Set here you C compiler flags
+USR_CFLAGS=
+
+# Set here you C++ compiler flags
+#USR_CXXFLAGS=
+USR_CXXFLAGS+=""
+
+# Set here you C/C++ linker flags
+USR_LDFLAGS=-llapack
+
+export USR_CPPFLAGS USR_CFLAGS USR_CXXFLAGS USR_LDFLAGS